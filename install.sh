@@ -1,4 +1,4 @@
 #!/usr/bin/bash
-gcc -O3 ./src/*.c -o ./kvelf
+gcc -O3 ./src/*.c -o ./kvelf -lpthread
 mv ./kvelf /usr/local/bin
 rm -rf ./kvelf
\ No newline at end of file
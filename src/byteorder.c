@@ -0,0 +1,224 @@
+#include "./types.h"
+#include "./elf.h"
+#include "./byteorder.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KVELF_BSWAP_SSSE3 1
+#endif
+
+
+#define BSWAP16(x) ((x) = __builtin_bswap16(x))
+#define BSWAP32(x) ((x) = __builtin_bswap32(x))
+#define BSWAP64(x) ((x) = __builtin_bswap64(x))
+
+
+
+/* Swap the fields of a 32-bit ELF header */
+void elf_swap_ehdr32(Elf32_Ehdr * ehdr){
+    BSWAP16(ehdr->e_type);
+    BSWAP16(ehdr->e_machine);
+    BSWAP32(ehdr->e_version);
+    BSWAP32(ehdr->e_entry);
+    BSWAP32(ehdr->e_phoff);
+    BSWAP32(ehdr->e_shoff);
+    BSWAP32(ehdr->e_flags);
+    BSWAP16(ehdr->e_ehsize);
+    BSWAP16(ehdr->e_phentsize);
+    BSWAP16(ehdr->e_phnum);
+    BSWAP16(ehdr->e_shentsize);
+    BSWAP16(ehdr->e_shnum);
+    BSWAP16(ehdr->e_shstrndx);
+}
+
+/* Swap the fields of a 64-bit ELF header */
+void elf_swap_ehdr64(Elf64_Ehdr * ehdr){
+    BSWAP16(ehdr->e_type);
+    BSWAP16(ehdr->e_machine);
+    BSWAP32(ehdr->e_version);
+    BSWAP64(ehdr->e_entry);
+    BSWAP64(ehdr->e_phoff);
+    BSWAP64(ehdr->e_shoff);
+    BSWAP32(ehdr->e_flags);
+    BSWAP16(ehdr->e_ehsize);
+    BSWAP16(ehdr->e_phentsize);
+    BSWAP16(ehdr->e_phnum);
+    BSWAP16(ehdr->e_shentsize);
+    BSWAP16(ehdr->e_shnum);
+    BSWAP16(ehdr->e_shstrndx);
+}
+
+/* Swap the fields of a 32-bit section header */
+void elf_swap_shdr32(Elf32_Shdr * shdr){
+    // All the fields are words
+    elf_swap_words32((u32 *)shdr, sizeof(Elf32_Shdr) / sizeof(u32));
+}
+
+/* Swap the fields of a 64-bit section header */
+void elf_swap_shdr64(Elf64_Shdr * shdr){
+    BSWAP32(shdr->sh_name);
+    BSWAP32(shdr->sh_type);
+    BSWAP64(shdr->sh_flags);
+    BSWAP64(shdr->sh_addr);
+    BSWAP64(shdr->sh_offset);
+    BSWAP64(shdr->sh_size);
+    BSWAP32(shdr->sh_link);
+    BSWAP32(shdr->sh_info);
+    BSWAP64(shdr->sh_addralign);
+    BSWAP64(shdr->sh_entsize);
+}
+
+/* Swap the fields of a 32-bit segment header */
+void elf_swap_phdr32(Elf32_Phdr * phdr){
+    // All the fields are words
+    elf_swap_words32((u32 *)phdr, sizeof(Elf32_Phdr) / sizeof(u32));
+}
+
+/* Swap the fields of a 64-bit segment header */
+void elf_swap_phdr64(Elf64_Phdr * phdr){
+    BSWAP32(phdr->p_type);
+    BSWAP32(phdr->p_flags);
+    BSWAP64(phdr->p_offset);
+    BSWAP64(phdr->p_vaddr);
+    BSWAP64(phdr->p_paddr);
+    BSWAP64(phdr->p_filesz);
+    BSWAP64(phdr->p_memsz);
+    BSWAP64(phdr->p_align);
+}
+
+
+
+#ifdef KVELF_BSWAP_SSSE3
+
+/*
+ * The SSSE3 kernels swap 16 bytes per shuffle, the masks give the source byte of
+ * every destination byte. They return the number of elements they have swapped and
+ * leave the remainder to the scalar loops.
+ */
+
+__attribute__((target("ssse3")))
+static u64 swap_words32_ssse3(u32 * words, u64 numOfWords){
+
+    const __m128i mask = _mm_setr_epi8(3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12);
+    u64 i=0;
+
+    for(;i+4<=numOfWords;i+=4){
+        __m128i v = _mm_loadu_si128((__m128i *)(words+i));
+        _mm_storeu_si128((__m128i *)(words+i), _mm_shuffle_epi8(v,mask));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+static u64 swap_words64_ssse3(u64 * words, u64 numOfWords){
+
+    const __m128i mask = _mm_setr_epi8(7,6,5,4,3,2,1,0, 15,14,13,12,11,10,9,8);
+    u64 i=0;
+
+    for(;i+2<=numOfWords;i+=2){
+        __m128i v = _mm_loadu_si128((__m128i *)(words+i));
+        _mm_storeu_si128((__m128i *)(words+i), _mm_shuffle_epi8(v,mask));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+static u64 swap_syms32_ssse3(Elf32_Sym * syms, u64 numOfSyms){
+
+    // name, value, size (words), info, other (bytes), shndx (half)
+    const __m128i mask = _mm_setr_epi8(3,2,1,0, 7,6,5,4, 11,10,9,8, 12, 13, 15,14);
+    u64 i=0;
+
+    for(;i<numOfSyms;i++){
+        __m128i v = _mm_loadu_si128((__m128i *)(syms+i));
+        _mm_storeu_si128((__m128i *)(syms+i), _mm_shuffle_epi8(v,mask));
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+static u64 swap_syms64_ssse3(Elf64_Sym * syms, u64 numOfSyms){
+
+    // Two 24-byte symbols are three vectors:
+    // [name info other shndx value] [size | name info other shndx] [value size]
+    const __m128i maskA = _mm_setr_epi8(3,2,1,0, 4, 5, 7,6, 15,14,13,12,11,10,9,8);
+    const __m128i maskB = _mm_setr_epi8(7,6,5,4,3,2,1,0, 11,10,9,8, 12, 13, 15,14);
+    const __m128i maskC = _mm_setr_epi8(7,6,5,4,3,2,1,0, 15,14,13,12,11,10,9,8);
+    u64 i=0;
+
+    for(;i+2<=numOfSyms;i+=2){
+        __m128i * v = (__m128i *)(syms+i);
+        _mm_storeu_si128(v, _mm_shuffle_epi8(_mm_loadu_si128(v),maskA));
+        _mm_storeu_si128(v+1, _mm_shuffle_epi8(_mm_loadu_si128(v+1),maskB));
+        _mm_storeu_si128(v+2, _mm_shuffle_epi8(_mm_loadu_si128(v+2),maskC));
+    }
+    return i;
+}
+
+#endif
+
+
+
+/* Swap the fields of a whole array of 32-bit symbols */
+void elf_swap_syms32(Elf32_Sym * syms, u64 numOfSyms){
+
+    u64 i=0;
+
+#ifdef KVELF_BSWAP_SSSE3
+    if(__builtin_cpu_supports("ssse3"))
+        i = swap_syms32_ssse3(syms,numOfSyms);
+#endif
+
+    for(;i<numOfSyms;i++){
+        BSWAP32(syms[i].st_name);
+        BSWAP32(syms[i].st_value);
+        BSWAP32(syms[i].st_size);
+        BSWAP16(syms[i].st_shndx);
+    }
+}
+
+/* Swap the fields of a whole array of 64-bit symbols */
+void elf_swap_syms64(Elf64_Sym * syms, u64 numOfSyms){
+
+    u64 i=0;
+
+#ifdef KVELF_BSWAP_SSSE3
+    if(__builtin_cpu_supports("ssse3"))
+        i = swap_syms64_ssse3(syms,numOfSyms);
+#endif
+
+    for(;i<numOfSyms;i++){
+        BSWAP32(syms[i].st_name);
+        BSWAP16(syms[i].st_shndx);
+        BSWAP64(syms[i].st_value);
+        BSWAP64(syms[i].st_size);
+    }
+}
+
+/* Swap a whole array of 32-bit words (Elf32_Rel and Elf32_Rela arrays are made of them) */
+void elf_swap_words32(u32 * words, u64 numOfWords){
+
+    u64 i=0;
+
+#ifdef KVELF_BSWAP_SSSE3
+    if(__builtin_cpu_supports("ssse3"))
+        i = swap_words32_ssse3(words,numOfWords);
+#endif
+
+    for(;i<numOfWords;i++)
+        BSWAP32(words[i]);
+}
+
+/* Swap a whole array of 64-bit words (Elf64_Rel and Elf64_Rela arrays are made of them) */
+void elf_swap_words64(u64 * words, u64 numOfWords){
+
+    u64 i=0;
+
+#ifdef KVELF_BSWAP_SSSE3
+    if(__builtin_cpu_supports("ssse3"))
+        i = swap_words64_ssse3(words,numOfWords);
+#endif
+
+    for(;i<numOfWords;i++)
+        BSWAP64(words[i]);
+}
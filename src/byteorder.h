@@ -0,0 +1,54 @@
+#ifndef BYTEORDER_H
+#define BYTEORDER_H
+
+#include "./types.h"
+#include "./elf.h"
+
+
+/* Data encoding of the ELF files whose fields are in the host's byte order */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define ELF_HOST_ENCODING ELFDATA2MSB
+#define ELF_FOREIGN_ENCODING ELFDATA2LSB
+#else
+#define ELF_HOST_ENCODING ELFDATA2LSB
+#define ELF_FOREIGN_ENCODING ELFDATA2MSB
+#endif
+
+
+/* Checks whether the fields of an ELF file with the given encoding have to be swapped */
+#define ELF_NEEDS_SWAP(elfEncoding) ((elfEncoding) == ELF_FOREIGN_ENCODING)
+
+
+
+/* Swap the fields of a 32-bit ELF header */
+void elf_swap_ehdr32(Elf32_Ehdr * ehdr);
+
+/* Swap the fields of a 64-bit ELF header */
+void elf_swap_ehdr64(Elf64_Ehdr * ehdr);
+
+/* Swap the fields of a 32-bit section header */
+void elf_swap_shdr32(Elf32_Shdr * shdr);
+
+/* Swap the fields of a 64-bit section header */
+void elf_swap_shdr64(Elf64_Shdr * shdr);
+
+/* Swap the fields of a 32-bit segment header */
+void elf_swap_phdr32(Elf32_Phdr * phdr);
+
+/* Swap the fields of a 64-bit segment header */
+void elf_swap_phdr64(Elf64_Phdr * phdr);
+
+/* Swap the fields of a whole array of 32-bit symbols */
+void elf_swap_syms32(Elf32_Sym * syms, u64 numOfSyms);
+
+/* Swap the fields of a whole array of 64-bit symbols */
+void elf_swap_syms64(Elf64_Sym * syms, u64 numOfSyms);
+
+/* Swap a whole array of 32-bit words (Elf32_Rel and Elf32_Rela arrays are made of them) */
+void elf_swap_words32(u32 * words, u64 numOfWords);
+
+/* Swap a whole array of 64-bit words (Elf64_Rel and Elf64_Rela arrays are made of them) */
+void elf_swap_words64(u64 * words, u64 numOfWords);
+
+
+#endif
@@ -7,7 +7,7 @@
 
 
 
-#define KVELF_CMD_COUNT 15
+#define KVELF_CMD_COUNT 33
 
 #define KVELF_CMD_REGEX_FILE_IDX 0
 #define KVELF_CMD_REGEX_FILE_CMD "\\s*file\\s*[a-zA-Z_]\\s*"
@@ -73,6 +73,47 @@
 #define KVELF_CMD_REGEX_HELP_IDX 18
 #define KVELF_CMD_REGEX_HELP_CMD "\\s*help\\|\\?\\s*"
 
+#define KVELF_CMD_REGEX_LIST_RELOCS_STATS_IDX 19
+#define KVELF_CMD_REGEX_LIST_RELOCS_STATS_CMD "^\\s*lr\\s*--stats\\s*$"
+
+#define KVELF_CMD_REGEX_ADDR2LINE_IDX 20
+#define KVELF_CMD_REGEX_ADDR2LINE_CMD "^\\s*addr2line\\(\\s.*\\)\\?$"
+
+#define KVELF_CMD_REGEX_FUNC_IDX 21
+#define KVELF_CMD_REGEX_FUNC_CMD "^\\s*func\\(\\s.*\\)\\?$"
+
+#define KVELF_CMD_REGEX_FDE_IDX 22
+#define KVELF_CMD_REGEX_FDE_CMD "^\\s*fde\\(\\s.*\\)\\?$"
+
+#define KVELF_CMD_REGEX_LIST_SYMBOLS_DEMANGLED_IDX 23
+#define KVELF_CMD_REGEX_LIST_SYMBOLS_DEMANGLED_CMD "^\\s*lsym\\s\\s*--demangle\\s*$"
+
+#define KVELF_CMD_REGEX_STRINGS_IDX 24
+#define KVELF_CMD_REGEX_STRINGS_CMD "^\\s*strings\\(\\s.*\\)\\?$"
+
+#define KVELF_CMD_REGEX_ENTROPY_IDX 25
+#define KVELF_CMD_REGEX_ENTROPY_CMD "^\\s*entropy\\(\\s.*\\)\\?$"
+
+#define KVELF_CMD_REGEX_HASH_IDX 26
+#define KVELF_CMD_REGEX_HASH_CMD "^\\s*hash\\(\\s.*\\)\\?$"
+#define KVELF_CMD_REGEX_DISASM_IDX 27
+#define KVELF_CMD_REGEX_DISASM_CMD "^\\s*dis\\(\\s.*\\)\\?$"
+
+#define KVELF_CMD_REGEX_PLT_IDX 28
+#define KVELF_CMD_REGEX_PLT_CMD "^\\s*plt\\s*$"
+
+#define KVELF_CMD_REGEX_GOT_IDX 29
+#define KVELF_CMD_REGEX_GOT_CMD "^\\s*got\\s*$"
+
+#define KVELF_CMD_REGEX_FORMAT_JSON_IDX 30
+#define KVELF_CMD_REGEX_FORMAT_JSON_CMD "^\\s*\\(header\\|h\\|ls\\|sections\\|lsg\\|segments\\|lsym\\|symbols\\|lr\\|relocs\\)\\s\\s*--format\\s\\s*json\\s*$"
+
+#define KVELF_CMD_REGEX_EXPORT_IDX 31
+#define KVELF_CMD_REGEX_EXPORT_CMD "^\\s*export\\(\\s.*\\)\\?$"
+
+#define KVELF_CMD_REGEX_PAGE_IDX 32
+#define KVELF_CMD_REGEX_PAGE_CMD "^\\s*\\(next\\|prev\\|goto\\s\\s*[0-9][0-9a-fA-Fx]*\\)\\s*$"
+
 
 // #define KVELF_CMD_REGEX_HELP_CMD "\\s*?\\s*"
 
@@ -104,7 +145,21 @@ regex_t * kvelf_compile_commandline(void){
              !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_PARSE_RAW_BYTES_IDX],KVELF_CMD_REGEX_PARSE_RAW_BYTES_CMD,0) &&
              !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_PARSE_IDX],KVELF_CMD_REGEX_PARSE_CMD,0) &&
              !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_PARSE_AT_IDX],KVELF_CMD_REGEX_PARSE_AT_CMD,0) &&
-             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_HELP_IDX],KVELF_CMD_REGEX_HELP_CMD,0)
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_HELP_IDX],KVELF_CMD_REGEX_HELP_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_LIST_RELOCS_STATS_IDX],KVELF_CMD_REGEX_LIST_RELOCS_STATS_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_ADDR2LINE_IDX],KVELF_CMD_REGEX_ADDR2LINE_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_FUNC_IDX],KVELF_CMD_REGEX_FUNC_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_FDE_IDX],KVELF_CMD_REGEX_FDE_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_LIST_SYMBOLS_DEMANGLED_IDX],KVELF_CMD_REGEX_LIST_SYMBOLS_DEMANGLED_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_STRINGS_IDX],KVELF_CMD_REGEX_STRINGS_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_ENTROPY_IDX],KVELF_CMD_REGEX_ENTROPY_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_HASH_IDX],KVELF_CMD_REGEX_HASH_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_DISASM_IDX],KVELF_CMD_REGEX_DISASM_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_PLT_IDX],KVELF_CMD_REGEX_PLT_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_GOT_IDX],KVELF_CMD_REGEX_GOT_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_FORMAT_JSON_IDX],KVELF_CMD_REGEX_FORMAT_JSON_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_EXPORT_IDX],KVELF_CMD_REGEX_EXPORT_CMD,0) &&
+             !regcomp(&kvelfCommandsRegexes[KVELF_CMD_REGEX_PAGE_IDX],KVELF_CMD_REGEX_PAGE_CMD,0)
 
              ){
 
@@ -119,11 +174,12 @@ regex_t * kvelf_compile_commandline(void){
 specified by the index */
 u8 * get_word_in_string_by_idx(u8 * givenString, s32 idx){
 
-    u8 * token = strtok(givenString," \t\n");
+    u8 * savePtr;
+    u8 * token = strtok_r(givenString," \t\n",(char **)&savePtr);
     idx--;
 
     while(idx>=0){
-        token=strtok(NULL," \t\n");
+        token=strtok_r(NULL," \t\n",(char **)&savePtr);
         if(!token)
             return NULL;
         idx--;
@@ -143,7 +199,27 @@ void print_cli_help(void){
     display("rb COUNT        Display raw COUNT bytes from the current address\n",DISPLAY_COLOR_CYAN);
     display("ls              List sections\n",DISPLAY_COLOR_CYAN);
     display("lsg             List segments\n",DISPLAY_COLOR_CYAN);
+    display("lsym            List symbols\n",DISPLAY_COLOR_CYAN);
+    display("lsym --demangle List symbols with their C++ names demangled\n",DISPLAY_COLOR_CYAN);
     display("lr              List relocations\n",DISPLAY_COLOR_CYAN);
+    display("lr --stats      Count relocations per relocation table\n",DISPLAY_COLOR_CYAN);
+    display("addr2line ADDR.. Resolve addresses to file:line from .debug_line\n",DISPLAY_COLOR_CYAN);
+    display("addr2line -     Resolve addresses read from stdin, one per line, until an empty line\n",DISPLAY_COLOR_CYAN);
+    display("func ADDR|NAME  Find a function by an address (0x...) or a name through the DWARF indices\n",DISPLAY_COLOR_CYAN);
+    display("fde ADDR        Display the FDE covering ADDR from .eh_frame\n",DISPLAY_COLOR_CYAN);
+    display("fde --ranges    List the function ranges of all the FDEs\n",DISPLAY_COLOR_CYAN);
+    display("strings [SECTION|START-END] [--min N] Printable strings of a section, a file range or the whole file\n",DISPLAY_COLOR_CYAN);
+    display("entropy         Entropy of the sections and the segments\n",DISPLAY_COLOR_CYAN);
+    display("entropy SECTION Byte histogram of a section\n",DISPLAY_COLOR_CYAN);
+    display("entropy SECTION --window N [--step M] Entropy of the windows of a section\n",DISPLAY_COLOR_CYAN);
+    display("hash [--algo xxh64|sha256] [--segments] Hash the sections (and the PT_LOAD segments) in parallel\n",DISPLAY_COLOR_CYAN);
+    display("dis [SYMBOL|ADDR [COUNT]] Disassemble the x86-64 code, a symbol or COUNT instructions at ADDR\n",DISPLAY_COLOR_CYAN);
+    display("plt             List the PLT stubs with the GOT slots and the symbols they call\n",DISPLAY_COLOR_CYAN);
+    display("got             List the GOT slots filled by JUMP_SLOT, GLOB_DAT and IRELATIVE relocations\n",DISPLAY_COLOR_CYAN);
+    display("header|ls|lsg|lsym|lr --format json Write the header or one JSON record per line of the listing\n",DISPLAY_COLOR_CYAN);
+    display("export --columnar DIR Write the sections, segments, symbols and relocations as column files\n",DISPLAY_COLOR_CYAN);
+    display("next/prev       Show the next or the previous page of the lsym or lr listing at a terminal\n",DISPLAY_COLOR_CYAN);
+    display("goto ROW        Show the page of the lsym or lr listing starting at ROW\n",DISPLAY_COLOR_CYAN);
     display("help/?          Display help\n",DISPLAY_COLOR_CYAN);
 
 
@@ -6,7 +6,7 @@
 
 
 
-#define KVELF_INPUT_CMD_MAX_LENGTH 70
+#define KVELF_INPUT_CMD_MAX_LENGTH 1024
 
 
 #define KVELF_CMD_REGEX_FILE_IDX 0
@@ -28,6 +28,20 @@
 #define KVELF_CMD_REGEX_PARSE_IDX 16
 #define KVELF_CMD_REGEX_PARSE_AT_IDX 17
 #define KVELF_CMD_REGEX_HELP_IDX 18
+#define KVELF_CMD_REGEX_LIST_RELOCS_STATS_IDX 19
+#define KVELF_CMD_REGEX_ADDR2LINE_IDX 20
+#define KVELF_CMD_REGEX_FUNC_IDX 21
+#define KVELF_CMD_REGEX_FDE_IDX 22
+#define KVELF_CMD_REGEX_LIST_SYMBOLS_DEMANGLED_IDX 23
+#define KVELF_CMD_REGEX_STRINGS_IDX 24
+#define KVELF_CMD_REGEX_ENTROPY_IDX 25
+#define KVELF_CMD_REGEX_HASH_IDX 26
+#define KVELF_CMD_REGEX_DISASM_IDX 27
+#define KVELF_CMD_REGEX_PLT_IDX 28
+#define KVELF_CMD_REGEX_GOT_IDX 29
+#define KVELF_CMD_REGEX_FORMAT_JSON_IDX 30
+#define KVELF_CMD_REGEX_EXPORT_IDX 31
+#define KVELF_CMD_REGEX_PAGE_IDX 32
 
 
 /* Compiling the regexes of the command line's commands */
@@ -45,5 +59,12 @@ u8 * get_word_in_string_by_idx(u8 * givenString,s32 idx);
 void print_cli_help(void);
 
 
+struct kvelf_basic_params;
+
+/* Run one command line of the prompt, the seek commands move the current offset. Returns 0 once
+the command ends the prompt */
+u8 run_command(struct kvelf_basic_params * kvelfp, regex_t * cliRegex, u8 * usercmd, u64 * fileOffset);
+
+
 #endif
 
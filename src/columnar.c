@@ -0,0 +1,578 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./columnar.h"
+
+
+
+/* Bytes buffered by every column before they are written */
+#define COLUMN_BUFFER_SIZE (32*1024)
+
+#define COLUMN_MAX_COLUMNS 12
+#define COLUMN_MAX_PATH 4096
+
+
+/* Buffered output to a region of a column file */
+typedef struct column_stream{
+    FILE * fp;
+    u32 used;
+    u8 buffer[COLUMN_BUFFER_SIZE];
+}column_stream_t;
+
+
+/* Name and type of a column */
+typedef struct column_spec{
+    const u8 * name;
+    u32 type;
+}column_spec_t;
+
+
+/* Column being written, a string column writes its offsets and its blob through two streams */
+typedef struct column_writer{
+    u32 type;
+    column_stream_t * values;
+    column_stream_t * blob;
+    u64 blobSize;
+}column_writer_t;
+
+
+/* Columns of a table, the values of a row are put in the order of the columns */
+typedef struct table_writer{
+    column_writer_t columns[COLUMN_MAX_COLUMNS];
+    u32 numOfColumns;
+    u32 nextColumn;
+    u64 numOfRows;
+}table_writer_t;
+
+
+
+static const column_spec_t sectionColumns[] = {
+    {"index",COLUMN_TYPE_U32}, {"name",COLUMN_TYPE_STRING}, {"type",COLUMN_TYPE_U32}, {"flags",COLUMN_TYPE_U64},
+    {"address",COLUMN_TYPE_U64}, {"offset",COLUMN_TYPE_U64}, {"size",COLUMN_TYPE_U64}, {"link",COLUMN_TYPE_U32},
+    {"info",COLUMN_TYPE_U32}, {"entrySize",COLUMN_TYPE_U64},
+};
+
+static const column_spec_t segmentColumns[] = {
+    {"index",COLUMN_TYPE_U32}, {"type",COLUMN_TYPE_U32}, {"flags",COLUMN_TYPE_U32}, {"offset",COLUMN_TYPE_U64},
+    {"address",COLUMN_TYPE_U64}, {"fileSize",COLUMN_TYPE_U64}, {"memSize",COLUMN_TYPE_U64},
+};
+
+/* "table" is the section index of the symbol table */
+static const column_spec_t symbolColumns[] = {
+    {"table",COLUMN_TYPE_U32}, {"index",COLUMN_TYPE_U32}, {"name",COLUMN_TYPE_STRING}, {"value",COLUMN_TYPE_U64},
+    {"size",COLUMN_TYPE_U64}, {"type",COLUMN_TYPE_U8}, {"binding",COLUMN_TYPE_U8}, {"visibility",COLUMN_TYPE_U8},
+    {"section",COLUMN_TYPE_U32},
+};
+
+/* "table" is the section index of the relocation table, the RELR relocations have no symbol and no addend */
+static const column_spec_t relocationColumns[] = {
+    {"table",COLUMN_TYPE_U32}, {"offset",COLUMN_TYPE_U64}, {"type",COLUMN_TYPE_U32}, {"symbolIndex",COLUMN_TYPE_U32},
+    {"symbol",COLUMN_TYPE_STRING}, {"addend",COLUMN_TYPE_S64},
+};
+
+#define COLUMN_COUNT(columns) (sizeof(columns)/sizeof(columns[0]))
+
+
+
+static void stream_flush(column_stream_t * stream){
+
+    if(stream->used)
+        fwrite(stream->buffer,1,stream->used,stream->fp);
+    stream->used = 0;
+}
+
+
+static void stream_write(column_stream_t * stream, const void * data, u64 size){
+
+    const u8 * bytes = data;
+    while(size){
+        if(stream->used==COLUMN_BUFFER_SIZE)
+            stream_flush(stream);
+
+        u64 chunk = COLUMN_BUFFER_SIZE-stream->used;
+        if(chunk>size)
+            chunk = size;
+        memcpy(stream->buffer+stream->used,bytes,chunk);
+        stream->used += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+}
+
+
+/* Open a stream on a column file at the given offset, returns NULL if the file cannot be opened */
+static column_stream_t * stream_open(u8 * path, u8 * mode, u64 offset){
+
+    column_stream_t * stream = malloc(sizeof(column_stream_t));
+    if(!stream){
+        debug("Cannot allocate the column buffers\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    if(!(stream->fp = fopen(path,mode)) || fseek(stream->fp,offset,SEEK_SET)){
+        if(stream->fp)
+            fclose(stream->fp);
+        free(stream);
+        return NULL;
+    }
+
+    stream->used = 0;
+    return stream;
+}
+
+
+/* Flush and close a stream, returns 0 if it could not be written */
+static u8 stream_close(column_stream_t * stream){
+
+    stream_flush(stream);
+    u8 written = !ferror(stream->fp);
+    written &= fclose(stream->fp)==0;
+    free(stream);
+    return written;
+}
+
+
+/* Create a directory unless it exists */
+static u8 make_directory(u8 * path){
+
+    if(mkdir(path,0755)==0 || errno==EEXIST)
+        return 1;
+
+    display_error("Cannot create the directory \"%s\"\n",path);
+    return 0;
+}
+
+
+/* Close the columns written so far, returns 0 if one of them could not be written */
+static u8 table_close(table_writer_t * table){
+
+    u8 written = 1;
+
+    for(u32 i=0;i<table->numOfColumns;i++){
+        column_writer_t * column = &table->columns[i];
+
+        // The blob's size is known once all its strings are written
+        if(column->blob){
+            written &= stream_close(column->blob);
+            stream_flush(column->values);
+            fseek(column->values->fp,offsetof(column_header_t,blobSize),SEEK_SET);
+            fwrite(&column->blobSize,sizeof(u64),1,column->values->fp);
+        }
+        written &= stream_close(column->values);
+    }
+
+    table->numOfColumns = 0;
+    return written;
+}
+
+
+/* Create DIR/TABLE and a file with its header per column, returns 0 if a file cannot be created */
+static u8 table_open(table_writer_t * table, u8 * directory, const u8 * tableName, const column_spec_t * columns, u32 numOfColumns, u64 numOfRows){
+
+    u8 path[COLUMN_MAX_PATH];
+    snprintf(path,sizeof(path),"%s/%s",directory,tableName);
+    if(!make_directory(path))
+        return 0;
+
+    table->numOfColumns = 0;
+    table->nextColumn = 0;
+    table->numOfRows = numOfRows;
+
+    for(u32 i=0;i<numOfColumns;i++){
+        column_writer_t * column = &table->columns[i];
+        snprintf(path,sizeof(path),"%s/%s/%s.col",directory,tableName,columns[i].name);
+
+        column->type = columns[i].type;
+        column->blob = NULL;
+        column->blobSize = 0;
+        if(!(column->values = stream_open(path,"wb",0))){
+            display_error("Cannot create \"%s\"\n",path);
+            table_close(table);
+            return 0;
+        }
+        table->numOfColumns++;
+
+        column_header_t header = {.version=COLUMN_VERSION, .type=column->type, .numOfRows=numOfRows};
+        memcpy(header.magic,COLUMN_MAGIC,sizeof(header.magic));
+        stream_write(column->values,&header,sizeof(header));
+
+        // The blob follows the offsets, whose count is known in advance
+        if(column->type==COLUMN_TYPE_STRING){
+            stream_write(column->values,&column->blobSize,sizeof(u64));
+            if(!(column->blob = stream_open(path,"r+b",sizeof(header)+(numOfRows+1)*sizeof(u64)))){
+                display_error("Cannot create \"%s\"\n",path);
+                table_close(table);
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+
+/* Put the value of the next column of the row */
+static void column_put(table_writer_t * table, u64 value){
+
+    column_writer_t * column = &table->columns[table->nextColumn++];
+
+    switch(column->type){
+        case COLUMN_TYPE_U8:{
+            u8 value8 = value;
+            stream_write(column->values,&value8,sizeof(value8));
+            break;
+        }
+        case COLUMN_TYPE_U16:{
+            u16 value16 = value;
+            stream_write(column->values,&value16,sizeof(value16));
+            break;
+        }
+        case COLUMN_TYPE_U32:{
+            u32 value32 = value;
+            stream_write(column->values,&value32,sizeof(value32));
+            break;
+        }
+        default:
+            stream_write(column->values,&value,sizeof(value));
+    }
+}
+
+
+/* Put the string of the next column of the row, the offsets hold where each string ends */
+static void column_put_string(table_writer_t * table, const u8 * value){
+
+    column_writer_t * column = &table->columns[table->nextColumn++];
+    u64 length = strlen(value);
+
+    stream_write(column->blob,value,length);
+    column->blobSize += length;
+    stream_write(column->values,&column->blobSize,sizeof(u64));
+}
+
+
+static void table_end_row(table_writer_t * table){
+    table->nextColumn = 0;
+}
+
+
+
+/* Number of relocations of a REL, RELA or RELR table */
+static u64 count_relocations(kvelf_basic_params_t * kvelfp, u32 tableIdx){
+
+    section_metadata_t * table = &kvelfp->elfSectionsMetadata[tableIdx];
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+
+    u64 entriesSize;
+    u8 * entries = get_section_contents(kvelfp,tableIdx,&entriesSize);
+    if(!entries)
+        return 0;
+
+    if(table->sType==SHT_REL)
+        return entriesSize/(2*wordSize);
+    if(table->sType==SHT_RELA)
+        return entriesSize/(3*wordSize);
+
+    relr_cursor_t cursor;
+    relr_cursor_init(&cursor,entries,entriesSize,wordSize,ELF_NEEDS_SWAP(kvelfp->elfEncoding),0);
+
+    u64 numOfRelocs = 0;
+    while(relr_cursor_next_entry(&cursor))
+        numOfRelocs += __builtin_popcountll(cursor.bitmap);
+    return numOfRelocs;
+}
+
+
+
+static u8 export_sections(kvelf_basic_params_t * kvelfp, u8 * directory){
+
+    table_writer_t * table = malloc(sizeof(table_writer_t));
+    if(!table){
+        debug("Cannot allocate the column buffers\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    if(!table_open(table,directory,"sections",sectionColumns,COLUMN_COUNT(sectionColumns),kvelfp->elfNumOfSections)){
+        free(table);
+        return 0;
+    }
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+        column_put(table,i);
+        column_put_string(table,get_section_name(kvelfp,i));
+        column_put(table,section->sType);
+        column_put(table,section->sFlags);
+        column_put(table,section->sVAddr);
+        column_put(table,section->sOffset);
+        column_put(table,section->sSize);
+        column_put(table,section->sLink);
+        column_put(table,section->sInfo);
+        column_put(table,section->sEntSize);
+        table_end_row(table);
+    }
+
+    u8 written = table_close(table);
+    free(table);
+    return written;
+}
+
+
+static u8 export_segments(kvelf_basic_params_t * kvelfp, u8 * directory){
+
+    table_writer_t * table = malloc(sizeof(table_writer_t));
+    if(!table){
+        debug("Cannot allocate the column buffers\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    if(!table_open(table,directory,"segments",segmentColumns,COLUMN_COUNT(segmentColumns),kvelfp->elfNumOfSegments)){
+        free(table);
+        return 0;
+    }
+
+    for(u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+        segment_metadata_t * segment = &kvelfp->elfSegmentsMetadata[i];
+        column_put(table,i);
+        column_put(table,segment->pType);
+        column_put(table,segment->pFlags);
+        column_put(table,segment->pOffset);
+        column_put(table,segment->pVAddr);
+        column_put(table,segment->pFileSize);
+        column_put(table,segment->pMemSize);
+        table_end_row(table);
+    }
+
+    u8 written = table_close(table);
+    free(table);
+    return written;
+}
+
+
+/* Export the symbols of .symtab and .dynsym, returns their number or -1 on failure */
+static s64 export_symbols(kvelf_basic_params_t * kvelfp, u8 * directory){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+
+    u64 numOfSymbols = 0, tableSize;
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++)
+        if((kvelfp->elfSectionsMetadata[i].sType==SHT_SYMTAB || kvelfp->elfSectionsMetadata[i].sType==SHT_DYNSYM) && get_section_contents(kvelfp,i,&tableSize))
+            numOfSymbols += tableSize/symbolSize;
+
+    table_writer_t * table = malloc(sizeof(table_writer_t));
+    if(!table){
+        debug("Cannot allocate the column buffers\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    if(!table_open(table,directory,"symbols",symbolColumns,COLUMN_COUNT(symbolColumns),numOfSymbols)){
+        free(table);
+        return -1;
+    }
+
+    for(u32 tableIdx=0;tableIdx<kvelfp->elfNumOfSections;tableIdx++){
+        section_metadata_t * symbolTable = &kvelfp->elfSectionsMetadata[tableIdx];
+        if(symbolTable->sType!=SHT_SYMTAB && symbolTable->sType!=SHT_DYNSYM)
+            continue;
+
+        u64 symbolsSize, stringsSize, shndxSize=0;
+        u8 * symbols = get_section_contents(kvelfp,tableIdx,&symbolsSize);
+        u8 * strings = get_section_contents(kvelfp,symbolTable->sLink,&stringsSize);
+        if(!symbols)
+            continue;
+
+        // Section indexes which do not fit in st_shndx are in the SYMTAB_SHNDX table linked to this one
+        u8 * shndx = NULL;
+        for(u32 i=0;i<kvelfp->elfNumOfSections && !shndx;i++)
+            if(kvelfp->elfSectionsMetadata[i].sType==SHT_SYMTAB_SHNDX && kvelfp->elfSectionsMetadata[i].sLink==tableIdx)
+                shndx = get_section_contents(kvelfp,i,&shndxSize);
+
+        data_reader_t reader, shndxReader;
+        reader_init(&reader,symbols,symbolsSize,needsSwap);
+
+        for(u64 symbolIdx=0;symbolIdx<symbolsSize/symbolSize;symbolIdx++){
+            u32 nameOffset = reader_u32(&reader);
+            u64 value, size;
+            u8 info, other;
+            u32 sectionIdx;
+
+            if(kvelfp->elfClass==ELFCLASS32){
+                value = reader_u32(&reader);
+                size = reader_u32(&reader);
+                info = reader_u8(&reader);
+                other = reader_u8(&reader);
+                sectionIdx = reader_u16(&reader);
+            }else{
+                info = reader_u8(&reader);
+                other = reader_u8(&reader);
+                sectionIdx = reader_u16(&reader);
+                value = reader_u64(&reader);
+                size = reader_u64(&reader);
+            }
+
+            if(sectionIdx==SHN_XINDEX && shndx && symbolIdx<shndxSize/sizeof(u32)){
+                reader_init(&shndxReader,shndx+symbolIdx*sizeof(u32),sizeof(u32),needsSwap);
+                sectionIdx = reader_u32(&shndxReader);
+            }
+
+            column_put(table,tableIdx);
+            column_put(table,symbolIdx);
+            column_put_string(table,string_at(strings,stringsSize,nameOffset));
+            column_put(table,value);
+            column_put(table,size);
+            column_put(table,ELF64_ST_TYPE(info));
+            column_put(table,ELF64_ST_BIND(info));
+            column_put(table,ELF64_ST_VISIBILITY(other));
+            column_put(table,sectionIdx);
+            table_end_row(table);
+        }
+    }
+
+    u8 written = table_close(table);
+    free(table);
+    return written ? (s64)numOfSymbols : -1;
+}
+
+
+/* Export the relocations of the REL, RELA and RELR tables, returns their number or -1 on failure */
+static s64 export_relocations(kvelf_basic_params_t * kvelfp, u8 * directory){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+    u32 relativeType = get_elf_relative_reloc_type(kvelfp->elfMachine);
+
+    u64 numOfRelocs = 0;
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        u32 type = kvelfp->elfSectionsMetadata[i].sType;
+        if(type==SHT_REL || type==SHT_RELA || type==SHT_RELR)
+            numOfRelocs += count_relocations(kvelfp,i);
+    }
+
+    table_writer_t * table = malloc(sizeof(table_writer_t));
+    if(!table){
+        debug("Cannot allocate the column buffers\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    if(!table_open(table,directory,"relocations",relocationColumns,COLUMN_COUNT(relocationColumns),numOfRelocs)){
+        free(table);
+        return -1;
+    }
+
+    for(u32 tableIdx=0;tableIdx<kvelfp->elfNumOfSections;tableIdx++){
+        section_metadata_t * relocTable = &kvelfp->elfSectionsMetadata[tableIdx];
+        if(relocTable->sType!=SHT_REL && relocTable->sType!=SHT_RELA && relocTable->sType!=SHT_RELR)
+            continue;
+
+        u64 entriesSize;
+        u8 * entries = get_section_contents(kvelfp,tableIdx,&entriesSize);
+        if(!entries)
+            continue;
+
+        if(relocTable->sType==SHT_RELR){
+            relr_cursor_t cursor;
+            relr_cursor_init(&cursor,entries,entriesSize,wordSize,needsSwap,0);
+
+            u64 address;
+            while(relr_cursor_next(&cursor,&address)){
+                column_put(table,tableIdx);
+                column_put(table,address);
+                column_put(table,relativeType);
+                column_put(table,0);
+                column_put_string(table,"");
+                column_put(table,0);
+                table_end_row(table);
+            }
+            continue;
+        }
+
+        data_reader_t reader;
+        reader_init(&reader,entries,entriesSize,needsSwap);
+
+        u8 hasAddend = relocTable->sType==SHT_RELA;
+        u64 symbolsSize=0, stringsSize=0;
+        u8 * symbols = NULL, * strings = NULL;
+        if(relocTable->sLink && relocTable->sLink<kvelfp->elfNumOfSections){
+            symbols = get_section_contents(kvelfp,relocTable->sLink,&symbolsSize);
+            strings = get_section_contents(kvelfp,kvelfp->elfSectionsMetadata[relocTable->sLink].sLink,&stringsSize);
+        }
+
+        data_reader_t symbolReader;
+        for(u64 entryIdx=0;entryIdx<entriesSize/(wordSize*(hasAddend ? 3 : 2));entryIdx++){
+            u64 offset = reader_uint(&reader,wordSize);
+            u64 info = reader_uint(&reader,wordSize);
+            s64 addend = 0;
+            if(hasAddend)
+                addend = kvelfp->elfClass==ELFCLASS32 ? (s32)reader_u32(&reader) : (s64)reader_u64(&reader);
+
+            u32 type = kvelfp->elfClass==ELFCLASS32 ? ELF32_R_TYPE(info) : ELF64_R_TYPE(info);
+            u64 symbolIdx = kvelfp->elfClass==ELFCLASS32 ? ELF32_R_SYM(info) : ELF64_R_SYM(info);
+
+            // The name is the first field of the symbols of both classes
+            u8 * symbolName = "";
+            if(symbolIdx && symbols && symbolIdx<symbolsSize/symbolSize){
+                reader_init(&symbolReader,symbols+symbolIdx*symbolSize,sizeof(u32),needsSwap);
+                symbolName = string_at(strings,stringsSize,reader_u32(&symbolReader));
+            }
+
+            column_put(table,tableIdx);
+            column_put(table,offset);
+            column_put(table,type);
+            column_put(table,symbolIdx);
+            column_put_string(table,symbolName);
+            column_put(table,addend);
+            table_end_row(table);
+        }
+    }
+
+    u8 written = table_close(table);
+    free(table);
+    return written ? (s64)numOfRelocs : -1;
+}
+
+
+
+/* Write the sections, the segments, the symbols and the relocations as column files,
+DIR/TABLE/COLUMN.col, for "export --columnar DIR" */
+void columnar_export(kvelf_basic_params_t * kvelfp, u8 * query){
+
+    u8 * directory = NULL;
+    u8 columnar = 0;
+
+    u8 * savePtr;
+    for(u8 * token=strtok_r(query," \t\n",(char **)&savePtr);token;token=strtok_r(NULL," \t\n",(char **)&savePtr)){
+        if(!strcmp(token,"--columnar"))
+            columnar = 1;
+        else
+            directory = token;
+    }
+
+    if(!columnar || !directory){
+        display_error("Usage: export --columnar DIR\n");
+        return;
+    }
+
+    if(!kvelfp->elfImage){
+        display_error("The file is not mapped, its tables cannot be exported\n");
+        return;
+    }
+
+    if(!make_directory(directory))
+        return;
+
+    s64 numOfSymbols = -1, numOfRelocs = -1;
+    if(!export_sections(kvelfp,directory) || !export_segments(kvelfp,directory) ||
+       (numOfSymbols = export_symbols(kvelfp,directory))<0 || (numOfRelocs = export_relocations(kvelfp,directory))<0){
+        display_error("Cannot write the columns to \"%s\"\n",directory);
+        return;
+    }
+
+    fprintf(display_output(),"Exported %u sections, %u segments, %lld symbols and %lld relocations to %s\n",
+           kvelfp->elfNumOfSections,kvelfp->elfNumOfSegments,numOfSymbols,numOfRelocs,directory);
+}
@@ -0,0 +1,39 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* "KVELFCOL" starting every column file */
+#define COLUMN_MAGIC "KVELFCOL"
+#define COLUMN_VERSION 1
+
+/* Types of the columns, the values are in the byte order of the host */
+#define COLUMN_TYPE_U8 1
+#define COLUMN_TYPE_U16 2
+#define COLUMN_TYPE_U32 3
+#define COLUMN_TYPE_U64 4
+#define COLUMN_TYPE_S64 5
+#define COLUMN_TYPE_STRING 6	/* numOfRows+1 u64 offsets into the blob which follows them, the strings are not terminated */
+
+
+/* Header of a column file, followed by the numOfRows values or by the offsets and the blob of a string column.
+It is 8 bytes aligned so the values can be used in place once the file is mapped */
+typedef struct column_header{
+	u8 magic[8];		/* COLUMN_MAGIC */
+	u32 version;		/* COLUMN_VERSION */
+	u32 type;			/* COLUMN_TYPE_* */
+	u64 numOfRows;
+	u64 blobSize;		/* Bytes of the strings of a string column, 0 for the other types */
+}column_header_t;
+
+
+
+/* Write the sections, the segments, the symbols and the relocations as column files,
+DIR/TABLE/COLUMN.col, for "export --columnar DIR" */
+void columnar_export(kvelf_basic_params_t * kvelfp, u8 * query);
+
+
+#endif
@@ -1,37 +1,113 @@
 #include <stdio.h>
+#include <stdarg.h>
 #include "./types.h"
 #include "./debug.h"
 
 
 
+/* Whether the informative messages are hidden */
+static u8 debugQuiet = 0;
+
+/* Whether the messages are wrapped in ANSI color sequences */
+static u8 displayColor = 1;
+
+/* Input and output of the commands run by the thread, NULL for stdin and stdout */
+static __thread FILE * displayInput = NULL;
+static __thread FILE * displayOutput = NULL;
+
+/* Color sequences indexed by the DISPLAY_COLOR_* values */
+static const char * displayColorSequences[] = {
+	[DISPLAY_COLOR_RED] = "\x1b[0;31m",
+	[DISPLAY_COLOR_GREEN_YELLOW] = "\x1b[0;32m",
+	[DISPLAY_COLOR_ORANGE] = "\x1b[0;33m",
+	[DISPLAY_COLOR_BLUE] = "\x1b[0;34m",
+	[DISPLAY_COLOR_PURPLE] = "\x1b[0;35m",
+	[DISPLAY_COLOR_CYAN] = "\x1b[0;36m",
+	[DISPLAY_COLOR_WHITE] = "\x1b[0;37m",
+	[DISPLAY_COLOR_BLACK] = "\x1b[0;38m",
+};
+
+
+/* Hide the informative messages, so that the output of a command is all that is printed */
+void debug_set_quiet(u8 quiet){
+	debugQuiet = quiet;
+}
+
+
+/* Point the commands of the calling thread at their input and output, NULL for stdin and stdout.
+The server answers every client on its own thread */
+void display_set_streams(FILE * input, FILE * output){
+	displayInput = input;
+	displayOutput = output;
+}
+
+
+/* Stream the commands of the calling thread print to */
+FILE * display_output(void){
+	return displayOutput ? displayOutput : stdout;
+}
+
+
+/* Stream the commands of the calling thread read their input from */
+FILE * display_input(void){
+	return displayInput ? displayInput : stdin;
+}
+
+
+/* Turn the ANSI colors on or off, the plain mode prints no escape sequence at all */
+void display_set_color(u8 color){
+	displayColor = color;
+}
+
+
+/* Whether the ANSI colors are on */
+u8 display_uses_color(void){
+	return displayColor;
+}
+
+
+/* Get the sequence starting a color, "" when the colors are off */
+const char * display_color_sequence(u8 color){
+	if(!displayColor || color>=sizeof(displayColorSequences)/sizeof(displayColorSequences[0]))
+		return "";
+	return displayColorSequences[color];
+}
+
+
+/* Get the sequence resetting the color, "" when the colors are off */
+const char * display_reset_sequence(void){
+	return displayColor ? DISPLAY_RESET_SEQUENCE : "";
+}
+
+
 /* Perform debugging costomized based on the given status */
 void debug(u8 * mess, u8 status){
+	if(status==DEBUG_STATUS_INF && debugQuiet)
+		return;
 	if(status==DEBUG_STATUS_INF)
-		printf("[0;35m[Info][0m %s",mess);
+		fprintf(display_output(),"%s[Info]%s %s",display_color_sequence(DISPLAY_COLOR_PURPLE),display_reset_sequence(),mess);
 	else if (status == DEBUG_STATUS_ERROR)
-		printf("[0;31m[Error][0m %s",mess);
+		fprintf(display_output(),"%s[Error]%s %s",display_color_sequence(DISPLAY_COLOR_RED),display_reset_sequence(),mess);
 	else if (status == DEBUG_STATUS_WARNING)
-		printf("[0;33m[WARN][0m %s",mess);
+		fprintf(display_output(),"%s[WARN]%s %s",display_color_sequence(DISPLAY_COLOR_ORANGE),display_reset_sequence(),mess);
+}
+
+
+/* Print an error message formatted as printf does, after the "[Error]" tag */
+void display_error(const char * format, ...){
+	fprintf(display_output(),"%s[Error]%s ",display_color_sequence(DISPLAY_COLOR_RED),display_reset_sequence());
+
+	va_list args;
+	va_start(args,format);
+	vfprintf(display_output(),format,args);
+	va_end(args);
 }
 
 
 /* Display a message with a given color */
 void display(u8 *mess,u8 color){
-	if(color==DISPLAY_COLOR_RED)
-		printf("[0;31m%s[0m",mess);
-	else if(color==DISPLAY_COLOR_GREEN_YELLOW)
-		printf("[0;32m%s[0m",mess);
-	else if(color==DISPLAY_COLOR_ORANGE)
-		printf("[0;33m%s[0m",mess);
-	else if(color==DISPLAY_COLOR_BLUE)
-		printf("[0;34m%s[0m",mess);
-	else if(color==DISPLAY_COLOR_PURPLE)
-		printf("[0;35m%s[0m",mess);
-	else if(color==DISPLAY_COLOR_CYAN)
-		printf("[0;36m%s[0m",mess);
-	else if(color==DISPLAY_COLOR_WHITE)
-		printf("[0;37m%s[0m",mess);
-	else if(color==DISPLAY_COLOR_BLACK)
-		printf("[0;38m%s[0m",mess);
+	if(!displayColor)
+		fputs(mess,display_output());
+	else if(color<sizeof(displayColorSequences)/sizeof(displayColorSequences[0]))
+		fprintf(display_output(),"%s%s" DISPLAY_RESET_SEQUENCE,displayColorSequences[color],mess);
 }
-
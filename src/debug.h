@@ -1,6 +1,8 @@
 #ifndef DEBUG_H
 #define DEBUG_H
 
+#include <stdio.h>
+
 
 /* Different status levels for debugging */
 #define DEBUG_STATUS_INF 1		/* Informative messaging */
@@ -18,15 +20,44 @@
 #define DISPLAY_COLOR_WHITE 6
 #define DISPLAY_COLOR_BLACK 7
 
+/* Sequence ending a colored message */
+#define DISPLAY_RESET_SEQUENCE "\x1b[0m"
+
 
 
 
 /* Perform debugging costomized based on the given status */
 void debug(u8 * mess, u8 status);
 
+/* Hide the informative messages, so that the output of a command is all that is printed */
+void debug_set_quiet(u8 quiet);
+
+/* Print an error message formatted as printf does, after the "[Error]" tag */
+void display_error(const char * format, ...);
+
+/* Point the commands of the calling thread at their input and output, NULL for stdin and stdout.
+The server answers every client on its own thread */
+void display_set_streams(FILE * input, FILE * output);
+
+/* Stream the commands of the calling thread print to */
+FILE * display_output(void);
+
+/* Stream the commands of the calling thread read their input from */
+FILE * display_input(void);
+
 /* Display a message with a given color */
 void display(u8 *mess,u8 color);
 
+/* Turn the ANSI colors on or off, the plain mode prints no escape sequence at all */
+void display_set_color(u8 color);
+
+/* Whether the ANSI colors are on */
+u8 display_uses_color(void);
+
+/* Get the sequences starting a color and resetting it, "" when the colors are off */
+const char * display_color_sequence(u8 color);
+const char * display_reset_sequence(void);
+
 
 
 
@@ -0,0 +1,2428 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./demangle.h"
+
+
+
+/* Kinds of the nodes of the parse trees */
+#define DM_NAME 1               // str
+#define DM_NESTED 2             // a::b
+#define DM_TEMPLATE 3           // a<list>
+#define DM_LOCAL 4              // a::b, a being the enclosing function
+#define DM_SPECIAL 5            // str a
+#define DM_CONSTRUCTION_VTABLE 6    // str a-in-b
+#define DM_CTOR_DTOR 7          // a, or ~a when ref is set
+#define DM_CONVERSION 8         // operator a
+#define DM_QUALIFIED 9          // a cv
+#define DM_VENDOR_QUALIFIED 10  // a str
+#define DM_POINTER 11           // a*
+#define DM_LVALUE_REF 12        // a&
+#define DM_RVALUE_REF 13        // a&&
+#define DM_FUNCTION_TYPE 14     // a (list) cv ref
+#define DM_ENCODING 15          // a b(list) cv ref, a being the return type or NULL
+#define DM_ARRAY 16             // a [b or str]
+#define DM_MEMBER_POINTER 17    // b a::*
+#define DM_PACK_EXPANSION 18    // a...
+#define DM_PACK 19              // list, [list] when str is set
+#define DM_LITERAL 20           // (a)str
+#define DM_ABI_TAG 21           // a[abi:str]
+#define DM_CLONE 22             // a [clone str]
+#define DM_CLOSURE 23           // {lambda(list)#str}
+#define DM_VECTOR 24            // a __vector(str or b)
+#define DM_UNARY 25             // str a, or str(a) for the keywords ending with a space
+#define DM_BINARY 26            // a str b
+#define DM_MEMBER_ACCESS 27     // a str b
+#define DM_CONDITIONAL 28       // list[0]?list[1]:list[2]
+#define DM_CALL 29              // a(list)
+#define DM_CAST 30              // (a)b
+#define DM_SIZEOF_PACK 31       // sizeof...(a)
+#define DM_PARAMETER_PACK 32    // list, list[i] when expanded
+#define DM_TEMPLATE_PARAM 33    // Substitution candidate of the template parameter numbered length, a where it was parsed
+
+/* Qualifiers of the qualified types and member functions */
+#define DM_CV_CONST 1
+#define DM_CV_VOLATILE 2
+#define DM_CV_RESTRICT 4
+#define DM_CV_NOEXCEPT 8
+
+/* Reference qualifiers of member functions */
+#define DM_REF_LVALUE 1
+#define DM_REF_RVALUE 2
+
+// Readings of the unresolved names starting with a source name, sr1A1x being A::x as GCC mangled it
+// before it followed the ABI's sr1AE1x
+#define DM_UNRESOLVED_ABI 0         // Read as the ABI mangles them
+#define DM_UNRESOLVED_ABI_READ 1    // Read as the ABI mangles them, and one was
+#define DM_UNRESOLVED_GCC 2         // Read as GCC mangled them, the name did not parse the ABI's way
+
+/* Longest demangled name, substitutions can make names grow exponentially */
+#define DEMANGLE_MAX_OUTPUT 65536
+
+/* Capacity of the memo table when it is created */
+#define DEMANGLE_CACHE_INITIAL_CAPACITY 1024
+
+
+
+/* Node of a parse tree, allocated from the demangler's arena */
+typedef struct dm_node{
+    u8 kind;
+    u8 cv;                  // Qualifiers of qualified types and functions
+    u8 ref;                 // Reference qualifier of functions, set for destructors
+    u32 length;             // Length of str, or number of items of list
+    u8 * str;
+    struct dm_node * a;
+    struct dm_node * b;
+    struct dm_node ** list;
+}dm_node_t;
+
+
+/* What the parsing of a function's name tells about the function */
+typedef struct dm_name_state{
+    u8 cv;                  // Qualifiers of a member function
+    u8 ref;                 // Reference qualifier of a member function
+    u8 ctorDtorConversion;  // Whether it is a constructor, destructor or conversion operator
+    u8 endsWithTemplateArgs;    // Whether the name ends with template arguments
+}dm_name_state_t;
+
+
+/* State of the parser and of the printer */
+typedef struct demangler{
+    u8 * pos;
+    u8 * end;
+    u32 depth;
+    u32 lambdaDepth;                // Nesting of the lambda signatures being parsed
+    s32 packIndex;                  // Element of the packs being printed by an expansion, -1 outside of them
+    u8 unresolvedNames;             // DM_UNRESOLVED_*
+    demangle_arena_t arena;         // Nodes of the name being demangled
+    dm_node_t ** subs;              // Substitution candidates
+    u32 numOfSubs, subsCapacity;
+    dm_node_t ** templateParams;    // Arguments of the innermost template
+    u32 numOfTemplateParams, templateParamsCapacity;
+    dm_node_t ** stack;             // Items of the lists being parsed
+    u32 stackSize, stackCapacity;
+    u8 * output;                    // Demangled name
+    u64 outputLength, outputCapacity;
+}demangler_t;
+
+
+/* Operator of the operator names and the expressions */
+typedef struct dm_operator{
+    char code[3];
+    char * name;
+    u8 arity;       // 0 for the operators which are not parsed in expressions
+}dm_operator_t;
+
+
+static const dm_operator_t dmOperators[] = {
+    {"aN","&=",2}, {"aS","=",2}, {"aa","&&",2}, {"ad","&",1}, {"an","&",2},
+    {"aw","co_await",1}, {"cc","const_cast",0}, {"cl","()",0}, {"cm",",",2},
+    {"co","~",1}, {"dV","/=",2}, {"da","delete[]",0}, {"de","*",1},
+    {"dl","delete",0}, {"dt",".",0}, {"dv","/",2}, {"eO","^=",2}, {"eo","^",2},
+    {"eq","==",2}, {"ge",">=",2}, {"gt",">",2}, {"ix","[]",2}, {"lS","<<=",2},
+    {"le","<=",2}, {"ls","<<",2}, {"lt","<",2}, {"mI","-=",2}, {"mL","*=",2},
+    {"mi","-",2}, {"ml","*",2}, {"mm","--",1}, {"na","new[]",0}, {"ne","!=",2},
+    {"ng","-",1}, {"nt","!",1}, {"nw","new",0}, {"oR","|=",2}, {"oo","||",2},
+    {"or","|",2}, {"pL","+=",2}, {"pl","+",2}, {"pm","->*",2}, {"pp","++",1},
+    {"ps","+",1}, {"pt","->",0}, {"qu","?",3}, {"rM","%=",2}, {"rS",">>=",2},
+    {"rm","%",2}, {"rs",">>",2}, {"ss","<=>",2}
+};
+
+
+/* Builtin types by their code, the ones after 'D' and then the plain ones */
+static const char * dmBuiltinTypes[] = {
+    ['a']="signed char", ['b']="bool", ['c']="char", ['d']="double",
+    ['e']="long double", ['f']="float", ['g']="__float128", ['h']="unsigned char",
+    ['i']="int", ['j']="unsigned int", ['l']="long", ['m']="unsigned long",
+    ['n']="__int128", ['o']="unsigned __int128", ['s']="short",
+    ['t']="unsigned short", ['v']="void", ['w']="wchar_t", ['x']="long long",
+    ['y']="unsigned long long", ['z']="...", ['z'+1]=NULL
+};
+
+static const char * dmBuiltinDTypes[] = {
+    ['a']="auto", ['c']="decltype(auto)", ['d']="decimal64", ['e']="decimal128",
+    ['f']="decimal32", ['h']="half", ['i']="char32_t", ['n']="decltype(nullptr)",
+    ['s']="char16_t", ['u']="char8_t", ['z'+1]=NULL
+};
+
+
+
+static dm_node_t * parse_encoding(demangler_t * d);
+static dm_node_t * parse_name(demangler_t * d, dm_name_state_t * state);
+static dm_node_t * parse_type(demangler_t * d);
+static dm_node_t * parse_expression(demangler_t * d);
+static dm_node_t * parse_template_args(demangler_t * d, u8 tagTemplates);
+static void print_node(demangler_t * d, dm_node_t * node);
+
+
+
+/* Allocate from an arena, the memory is zeroed */
+static void * arena_alloc(demangle_arena_t * arena, u64 size){
+
+    size = (size+7) & ~7ULL;
+
+    demangle_arena_block_t * block = arena->current;
+
+    // Move on to the blocks kept by the last reset before adding a new one
+    while(block!=NULL && block->used+size>block->size){
+        if(block->next==NULL)
+            break;
+        block = block->next;
+        block->used = 0;
+        arena->current = block;
+    }
+
+    if(block==NULL || block->used+size>block->size){
+        u64 blockSize = size>DEMANGLE_ARENA_BLOCK_SIZE ? size : DEMANGLE_ARENA_BLOCK_SIZE;
+        demangle_arena_block_t * newBlock = malloc(sizeof(demangle_arena_block_t)+blockSize);
+        if(newBlock==NULL){
+            debug("Could not allocate the demangler's memory\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+        newBlock->next = NULL;
+        newBlock->size = blockSize;
+        newBlock->used = 0;
+
+        // Big blocks are put right after the current one so the chain of the normal ones is kept
+        if(block==NULL)
+            arena->first = newBlock;
+        else{
+            newBlock->next = block->next;
+            block->next = newBlock;
+        }
+        arena->current = block = newBlock;
+    }
+
+    void * memory = block->data + block->used;
+    block->used += size;
+    memset(memory,0,size);
+
+    return memory;
+}
+
+
+/* Give all the memory of an arena back, its blocks are kept for the next names */
+static void arena_reset(demangle_arena_t * arena){
+
+    arena->current = arena->first;
+    if(arena->first!=NULL)
+        arena->first->used = 0;
+}
+
+
+/* Append a pointer to a growable array */
+static void push_pointer(dm_node_t *** array, u32 * count, u32 * capacity, dm_node_t * node){
+
+    if(*count==*capacity){
+        *capacity = *capacity==0 ? 64 : *capacity*2;
+        *array = realloc(*array,*capacity*sizeof(dm_node_t*));
+        if(*array==NULL){
+            debug("Could not allocate the demangler's memory\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+    }
+    (*array)[(*count)++] = node;
+}
+
+
+
+/* Character ahead of the parser, 0 past the end of the name */
+static u8 look(demangler_t * d, u32 ahead){
+    return d->pos+ahead<d->end ? d->pos[ahead] : 0;
+}
+
+
+/* Consume a character if it is next */
+static u8 consume(demangler_t * d, u8 c){
+
+    if(look(d,0)!=c)
+        return 0;
+    d->pos++;
+    return 1;
+}
+
+
+/* Consume a two character code if it is next */
+static u8 consume2(demangler_t * d, const char * code){
+
+    if(look(d,0)!=(u8)code[0] || look(d,1)!=(u8)code[1])
+        return 0;
+    d->pos+=2;
+    return 1;
+}
+
+
+/* Parse a decimal number, 'n' making it negative. Returns 0 if there are no digits */
+static u8 parse_number(demangler_t * d, u8 allowNegative, u8 ** text, u32 * length){
+
+    u8 * start = d->pos;
+    if(allowNegative)
+        consume(d,'n');
+    if(!isdigit(look(d,0)))
+        return 0;
+    while(isdigit(look(d,0)))
+        d->pos++;
+
+    *text = start;
+    *length = d->pos - start;
+    return 1;
+}
+
+
+/* Parse a decimal number into its value */
+static u8 parse_count(demangler_t * d, u64 * value){
+
+    if(!isdigit(look(d,0)))
+        return 0;
+
+    *value = 0;
+    while(isdigit(look(d,0))){
+        *value = *value*10 + (look(d,0)-'0');
+        if(*value>(u64)(d->end-d->pos))
+            return 0;
+        d->pos++;
+    }
+    return 1;
+}
+
+
+/* Skip a call offset of a thunk */
+static u8 parse_call_offset(demangler_t * d){
+
+    u8 * text;
+    u32 length;
+
+    if(consume(d,'h'))
+        return parse_number(d,1,&text,&length) && consume(d,'_');
+    if(consume(d,'v'))
+        return parse_number(d,1,&text,&length) && consume(d,'_') && parse_number(d,1,&text,&length) && consume(d,'_');
+    return 0;
+}
+
+
+/* Skip the discriminator of a local entity */
+static void parse_discriminator(demangler_t * d){
+
+    if(look(d,0)!='_')
+        return;
+
+    if(isdigit(look(d,1)))
+        d->pos+=2;
+    else if(look(d,1)=='_' && isdigit(look(d,2))){
+        u8 * start = d->pos;
+        d->pos+=2;
+        while(isdigit(look(d,0)))
+            d->pos++;
+        if(!consume(d,'_'))
+            d->pos = start;
+    }
+}
+
+
+/* Parse the const, volatile and restrict qualifiers */
+static u8 parse_cv_qualifiers(demangler_t * d){
+
+    u8 cv = 0;
+    if(consume(d,'r'))
+        cv |= DM_CV_RESTRICT;
+    if(consume(d,'V'))
+        cv |= DM_CV_VOLATILE;
+    if(consume(d,'K'))
+        cv |= DM_CV_CONST;
+    return cv;
+}
+
+
+
+/* Allocate a node of a parse tree */
+static dm_node_t * make_node(demangler_t * d, u8 kind, dm_node_t * a, dm_node_t * b){
+
+    dm_node_t * node = arena_alloc(&d->arena,sizeof(dm_node_t));
+    node->kind = kind;
+    node->a = a;
+    node->b = b;
+    return node;
+}
+
+
+/* Allocate a node holding a string */
+static dm_node_t * make_string(demangler_t * d, u8 kind, const char * str, u32 length, dm_node_t * a){
+
+    dm_node_t * node = make_node(d,kind,a,NULL);
+    node->str = (u8*)str;
+    node->length = length;
+    return node;
+}
+
+
+/* Allocate a name from a C string */
+static dm_node_t * make_name(demangler_t * d, const char * str){
+    return make_string(d,DM_NAME,str,strlen(str),NULL);
+}
+
+
+/* Copy a formatted string into the arena */
+static u8 * arena_format(demangler_t * d, u32 * length, const char * format, const char * a, u32 aLength, const char * b, u32 bLength){
+
+    u64 size = strlen(format)+aLength+bLength+1;
+    u8 * str = arena_alloc(&d->arena,size);
+    *length = snprintf((char*)str,size,format,(int)aLength,a,(int)bLength,b);
+    return str;
+}
+
+
+/* Move the items pushed on the stack since stackStart into the list of a node */
+static void pop_list(demangler_t * d, u32 stackStart, dm_node_t * node){
+
+    node->length = d->stackSize-stackStart;
+    node->list = arena_alloc(&d->arena,node->length*sizeof(dm_node_t*)+1);
+    if(node->length!=0)
+        memcpy(node->list,d->stack+stackStart,node->length*sizeof(dm_node_t*));
+    d->stackSize = stackStart;
+}
+
+
+
+/* <source-name> ::= <length> <identifier> */
+static dm_node_t * parse_source_name(demangler_t * d){
+
+    u64 length;
+    if(!parse_count(d,&length) || length==0)
+        return NULL;
+
+    u8 * name = d->pos;
+    d->pos += length;
+
+    if(length>=10 && memcmp(name,"_GLOBAL__N",10)==0)
+        return make_name(d,"(anonymous namespace)");
+
+    return make_string(d,DM_NAME,(char*)name,length,NULL);
+}
+
+
+/* <abi-tags> ::= B <source-name>+ */
+static dm_node_t * parse_abi_tags(demangler_t * d, dm_node_t * node){
+
+    while(node!=NULL && consume(d,'B')){
+        dm_node_t * tag = parse_source_name(d);
+        if(tag==NULL)
+            return NULL;
+        node = make_string(d,DM_ABI_TAG,(char*)tag->str,tag->length,node);
+    }
+    return node;
+}
+
+
+/* Find an operator by its two character code */
+static const dm_operator_t * find_operator(demangler_t * d){
+
+    for(u32 i=0;i<sizeof(dmOperators)/sizeof(dmOperators[0]);i++)
+        if(look(d,0)==(u8)dmOperators[i].code[0] && look(d,1)==(u8)dmOperators[i].code[1])
+            return &dmOperators[i];
+    return NULL;
+}
+
+
+/* <operator-name>, conversion operators, literal operators and vendor operators */
+static dm_node_t * parse_operator_name(demangler_t * d, dm_name_state_t * state){
+
+    u32 length;
+
+    if(consume2(d,"cv")){
+        dm_node_t * type = parse_type(d);
+        if(type==NULL)
+            return NULL;
+        if(state!=NULL)
+            state->ctorDtorConversion = 1;
+        return make_node(d,DM_CONVERSION,type,NULL);
+    }
+
+    if(consume2(d,"li")){
+        dm_node_t * suffix = parse_source_name(d);
+        if(suffix==NULL)
+            return NULL;
+        u8 * str = arena_format(d,&length,"operator\"\" %.*s%.*s",(char*)suffix->str,suffix->length,"",0);
+        return make_string(d,DM_NAME,(char*)str,length,NULL);
+    }
+
+    if(look(d,0)=='v' && isdigit(look(d,1))){
+        d->pos+=2;
+        dm_node_t * name = parse_source_name(d);
+        if(name==NULL)
+            return NULL;
+        u8 * str = arena_format(d,&length,"operator %.*s%.*s",(char*)name->str,name->length,"",0);
+        return make_string(d,DM_NAME,(char*)str,length,NULL);
+    }
+
+    const dm_operator_t * op = find_operator(d);
+    if(op==NULL)
+        return NULL;
+    d->pos+=2;
+
+    // Named operators are spelled with a space
+    u8 * str = arena_format(d,&length,isalpha((u8)op->name[0]) ? "operator %.*s%.*s" : "operator%.*s%.*s",op->name,strlen(op->name),"",0);
+    return make_string(d,DM_NAME,(char*)str,length,NULL);
+}
+
+
+/* <unnamed-type-name> ::= Ut [<number>] _ | Ul <lambda-sig> E [<number>] _ */
+static dm_node_t * parse_unnamed_type_name(demangler_t * d){
+
+    u8 * number = (u8*)"";
+    u32 numberLength = 0;
+    u64 count;
+    u32 length;
+    char countText[24];
+
+    if(consume2(d,"Ut")){
+        u8 hasCount = parse_count(d,&count);
+        if(!consume(d,'_'))
+            return NULL;
+        numberLength = snprintf(countText,sizeof(countText),"%llu",hasCount ? (unsigned long long)count+2 : 1ULL);
+        number = arena_format(d,&length,"{unnamed type#%.*s}%.*s",countText,numberLength,"",0);
+        return make_string(d,DM_NAME,(char*)number,length,NULL);
+    }
+
+    if(!consume2(d,"Ul"))
+        return NULL;
+
+    u32 stackStart = d->stackSize;
+    d->lambdaDepth++;
+    if(!consume(d,'v')){
+        while(look(d,0)!='E'){
+            dm_node_t * param = parse_type(d);
+            if(param==NULL)
+                return NULL;
+            push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,param);
+        }
+    }
+    d->lambdaDepth--;
+    if(!consume(d,'E'))
+        return NULL;
+
+    u8 hasCount = parse_count(d,&count);
+    if(!consume(d,'_'))
+        return NULL;
+    numberLength = snprintf(countText,sizeof(countText),"%llu",hasCount ? (unsigned long long)count+2 : 1ULL);
+
+    dm_node_t * closure = make_node(d,DM_CLOSURE,NULL,NULL);
+    pop_list(d,stackStart,closure);
+    closure->str = arena_format(d,&length,"%.*s%.*s",countText,numberLength,"",0);
+    closure->cv = length;
+    return closure;
+}
+
+
+/* <unqualified-name> ::= [L] <operator-name> | <source-name> | <unnamed-type-name> | DC <source-name>+ E */
+static dm_node_t * parse_unqualified_name(demangler_t * d, dm_name_state_t * state){
+
+    dm_node_t * name;
+
+    consume(d,'L');
+
+    if(isdigit(look(d,0)))
+        name = parse_source_name(d);
+    else if(look(d,0)=='U')
+        name = parse_unnamed_type_name(d);
+    else if(consume2(d,"DC")){
+        // Structured bindings are printed as their list of names
+        u32 stackStart = d->stackSize;
+        while(!consume(d,'E')){
+            dm_node_t * binding = parse_source_name(d);
+            if(binding==NULL)
+                return NULL;
+            push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,binding);
+        }
+        name = make_string(d,DM_PACK,"[",1,NULL);
+        pop_list(d,stackStart,name);
+    }
+    else
+        name = parse_operator_name(d,state);
+
+    return parse_abi_tags(d,name);
+}
+
+
+/* Name a constructor or destructor of a class is printed with */
+static dm_node_t * base_name(dm_node_t * node){
+
+    while(node!=NULL){
+        switch(node->kind){
+            case DM_NESTED:
+            case DM_LOCAL:
+                node = node->b;
+                break;
+            case DM_TEMPLATE:
+            case DM_ABI_TAG:
+                node = node->a;
+                break;
+            case DM_NAME:
+                // Standard substitutions keep the bare name of the class
+                return node->b!=NULL ? node->b : node;
+            default:
+                return node;
+        }
+    }
+    return NULL;
+}
+
+
+/* <ctor-dtor-name> ::= C[I] <digit> [<type>] | D <digit> */
+static dm_node_t * parse_ctor_dtor_name(demangler_t * d, dm_node_t * soFar, dm_name_state_t * state){
+
+    u8 isDtor = look(d,0)=='D';
+    if(isDtor){
+        if(look(d,1)<'0' || look(d,1)>'5')
+            return NULL;
+        d->pos+=2;
+    }
+    else{
+        d->pos++;
+        u8 inheriting = consume(d,'I');
+        if(look(d,0)<'1' || look(d,0)>'5')
+            return NULL;
+        d->pos++;
+        if(inheriting && parse_name(d,NULL)==NULL)
+            return NULL;
+    }
+
+    if(state!=NULL)
+        state->ctorDtorConversion = 1;
+
+    dm_node_t * node = make_node(d,DM_CTOR_DTOR,base_name(soFar),NULL);
+    node->ref = isDtor;
+    return node;
+}
+
+
+/* <substitution> ::= S_ | S <seq-id> _ | St | Sa | Sb | Ss | Si | So | Sd */
+static dm_node_t * parse_substitution(demangler_t * d){
+
+    static const char * standard[][3] = {
+        {"a","std::allocator","allocator"},
+        {"b","std::basic_string","basic_string"},
+        {"s","std::basic_string<char, std::char_traits<char>, std::allocator<char> >","basic_string"},
+        {"i","std::basic_istream<char, std::char_traits<char> >","basic_istream"},
+        {"o","std::basic_ostream<char, std::char_traits<char> >","basic_ostream"},
+        {"d","std::basic_iostream<char, std::char_traits<char> >","basic_iostream"}
+    };
+
+    if(!consume(d,'S'))
+        return NULL;
+
+    if(islower(look(d,0))){
+        for(u32 i=0;i<sizeof(standard)/sizeof(standard[0]);i++){
+            if(look(d,0)==(u8)standard[i][0][0]){
+                d->pos++;
+                dm_node_t * name = make_name(d,standard[i][1]);
+                name->b = make_name(d,standard[i][2]);
+                dm_node_t * tagged = parse_abi_tags(d,name);
+                if(tagged!=name)
+                    push_pointer(&d->subs,&d->numOfSubs,&d->subsCapacity,tagged);
+                return tagged;
+            }
+        }
+        return NULL;
+    }
+
+    u64 index = 0;
+    if(!consume(d,'_')){
+        while(look(d,0)!='_'){
+            u8 c = look(d,0);
+            if(isdigit(c))
+                index = index*36 + (c-'0');
+            else if(c>='A' && c<='Z')
+                index = index*36 + (c-'A'+10);
+            else
+                return NULL;
+            if(index>d->numOfSubs)
+                return NULL;
+            d->pos++;
+        }
+        d->pos++;
+        index++;
+    }
+
+    if(index>=d->numOfSubs)
+        return NULL;
+
+    // Template parameters refer to the arguments of the template where the substitution is used,
+    // as c++filt reads them, which differ from where they were parsed past the encoding of a local name
+    dm_node_t * sub = d->subs[index];
+    if(sub->kind==DM_TEMPLATE_PARAM)
+        return sub->length<d->numOfTemplateParams ? d->templateParams[sub->length] : sub->a;
+    return sub;
+}
+
+
+/* <template-param> ::= T_ | T <number> _, the number of the parameter */
+static u8 parse_template_param_index(demangler_t * d, u64 * index){
+
+    if(!consume(d,'T'))
+        return 0;
+
+    *index = 0;
+    if(!consume(d,'_')){
+        if(!parse_count(d,index) || !consume(d,'_'))
+            return 0;
+        (*index)++;
+    }
+    return 1;
+}
+
+
+/* What a template parameter refers to */
+static dm_node_t * resolve_template_param(demangler_t * d, u64 index){
+
+    // Parameters of generic lambdas are their invented template parameters, even inside a template
+    if(d->lambdaDepth==0){
+        if(index<d->numOfTemplateParams)
+            return d->templateParams[index];
+        return NULL;
+    }
+    char indexText[24];
+    u32 length;
+    u32 indexLength = snprintf(indexText,sizeof(indexText),"%llu",(unsigned long long)index+1);
+    u8 * str = arena_format(d,&length,"auto:%.*s%.*s",indexText,indexLength,"",0);
+    return make_string(d,DM_NAME,(char*)str,length,NULL);
+}
+
+
+/* <template-param> ::= T_ | T <number> _ */
+static dm_node_t * parse_template_param(demangler_t * d){
+
+    u64 index;
+    return parse_template_param_index(d,&index) ? resolve_template_param(d,index) : NULL;
+}
+
+
+/* <nested-name> ::= N [<CV-qualifiers>] [<ref-qualifier>] <prefix> <unqualified-name> E */
+static dm_node_t * parse_nested_name(demangler_t * d, dm_name_state_t * state){
+
+    if(!consume(d,'N'))
+        return NULL;
+
+    u8 cv = parse_cv_qualifiers(d);
+    u8 ref = 0;
+    if(consume(d,'O'))
+        ref = DM_REF_RVALUE;
+    else if(consume(d,'R'))
+        ref = DM_REF_LVALUE;
+    if(state!=NULL){
+        state->cv = cv;
+        state->ref = ref;
+    }
+
+    dm_node_t * soFar = NULL;
+    if(consume2(d,"St"))
+        soFar = make_name(d,"std");
+
+    while(!consume(d,'E')){
+        dm_node_t * component = NULL;
+
+        consume(d,'L');
+
+        if(consume(d,'M')){
+            if(soFar==NULL)
+                return NULL;
+            continue;
+        }
+
+        if(look(d,0)=='I'){
+            if(soFar==NULL)
+                return NULL;
+            dm_node_t * args = parse_template_args(d,state!=NULL);
+            if(args==NULL)
+                return NULL;
+            args->a = soFar;
+            soFar = args;
+            if(state!=NULL)
+                state->endsWithTemplateArgs = 1;
+            push_pointer(&d->subs,&d->numOfSubs,&d->subsCapacity,soFar);
+            continue;
+        }
+
+        if(look(d,0)=='T')
+            component = parse_template_param(d);
+        else if(look(d,0)=='S' && look(d,1)!='t'){
+            component = parse_substitution(d);
+            if(component==NULL)
+                return NULL;
+            if(soFar==NULL){
+                soFar = component;
+                continue;
+            }
+        }
+        else if(look(d,0)=='C' || (look(d,0)=='D' && look(d,1)!='C')){
+            if(soFar==NULL)
+                return NULL;
+            component = parse_abi_tags(d,parse_ctor_dtor_name(d,soFar,state));
+        }
+        else
+            component = parse_unqualified_name(d,state);
+
+        if(component==NULL)
+            return NULL;
+
+        soFar = soFar==NULL ? component : make_node(d,DM_NESTED,soFar,component);
+        if(state!=NULL)
+            state->endsWithTemplateArgs = 0;
+        push_pointer(&d->subs,&d->numOfSubs,&d->subsCapacity,soFar);
+    }
+
+    // The whole name is not a substitution candidate
+    if(soFar==NULL || d->numOfSubs==0)
+        return NULL;
+    if(d->subs[d->numOfSubs-1]==soFar)
+        d->numOfSubs--;
+
+    return soFar;
+}
+
+
+/* <local-name> ::= Z <encoding> E <name> [<discriminator>] | Z <encoding> E s [<discriminator>] */
+static dm_node_t * parse_local_name(demangler_t * d, dm_name_state_t * state){
+
+    if(!consume(d,'Z'))
+        return NULL;
+
+    dm_node_t * encoding = parse_encoding(d);
+    if(encoding==NULL || !consume(d,'E'))
+        return NULL;
+
+    if(consume(d,'s')){
+        parse_discriminator(d);
+        return make_node(d,DM_LOCAL,encoding,make_name(d,"string literal"));
+    }
+
+    // Entities of default arguments are numbered from the last parameter
+    if(consume(d,'d')){
+        u64 index;
+        char indexText[24];
+        u32 length;
+        u8 hasIndex = parse_count(d,&index);
+        if(!consume(d,'_'))
+            return NULL;
+        u32 indexLength = snprintf(indexText,sizeof(indexText),"%llu",hasIndex ? (unsigned long long)index+2 : 1ULL);
+        u8 * str = arena_format(d,&length,"{default arg#%.*s}%.*s",indexText,indexLength,"",0);
+        encoding = make_node(d,DM_LOCAL,encoding,make_string(d,DM_NAME,(char*)str,length,NULL));
+    }
+
+    dm_node_t * entity = parse_name(d,state);
+    if(entity==NULL)
+        return NULL;
+    parse_discriminator(d);
+
+    return make_node(d,DM_LOCAL,encoding,entity);
+}
+
+
+/* <name> ::= <nested-name> | <local-name> | <unscoped-template-name> <template-args> | <unscoped-name> */
+static dm_node_t * parse_name(demangler_t * d, dm_name_state_t * state){
+
+    if(look(d,0)=='N')
+        return parse_nested_name(d,state);
+    if(look(d,0)=='Z')
+        return parse_local_name(d,state);
+
+    dm_node_t * name;
+
+    if(look(d,0)=='S' && look(d,1)!='t'){
+        // A substitution has to be a template name here
+        name = parse_substitution(d);
+        if(name==NULL || look(d,0)!='I')
+            return NULL;
+    }
+    else{
+        u8 isStd = consume2(d,"St");
+        name = parse_unqualified_name(d,state);
+        if(name==NULL)
+            return NULL;
+        if(isStd)
+            name = make_node(d,DM_NESTED,make_name(d,"std"),name);
+        if(look(d,0)!='I')
+            return name;
+        push_pointer(&d->subs,&d->numOfSubs,&d->subsCapacity,name);
+    }
+
+    dm_node_t * args = parse_template_args(d,state!=NULL);
+    if(args==NULL)
+        return NULL;
+    args->a = name;
+    if(state!=NULL)
+        state->endsWithTemplateArgs = 1;
+
+    return args;
+}
+
+
+/* <expr-primary> ::= L <type> <value> E | L <mangled-name> E | L b 0|1 E */
+static dm_node_t * parse_expr_primary(demangler_t * d){
+
+    static const char * suffixes[] = {
+        ['i']="", ['j']="u", ['l']="l", ['m']="ul", ['x']="ll", ['y']="ull", ['z'+1]=NULL
+    };
+
+    if(!consume(d,'L'))
+        return NULL;
+
+    dm_node_t * node;
+    u8 * text;
+    u32 length;
+
+    if(consume2(d,"_Z"))
+        node = parse_encoding(d);
+    else if(consume2(d,"Dn")){
+        consume(d,'0');
+        node = make_name(d,"nullptr");
+    }
+    else if(look(d,0)=='b' && (look(d,1)=='0' || look(d,1)=='1')){
+        node = make_name(d,look(d,1)=='1' ? "true" : "false");
+        d->pos+=2;
+    }
+    else if(look(d,0)<='z' && suffixes[look(d,0)]!=NULL){
+        const char * suffix = suffixes[look(d,0)];
+        d->pos++;
+        if(!parse_number(d,1,&text,&length))
+            return NULL;
+        if(text[0]=='n')
+            text = arena_format(d,&length,"-%.*s%.*s",(char*)text+1,length-1,"",0);
+        text = arena_format(d,&length,"%.*s%.*s",(char*)text,length,suffix,strlen(suffix));
+        node = make_string(d,DM_LITERAL,(char*)text,length,NULL);
+    }
+    else{
+        // Other types print the value after a cast, floats keep their hexadecimal image
+        dm_node_t * type = parse_type(d);
+        if(type==NULL)
+            return NULL;
+        u8 * start = d->pos;
+        if(look(d,0)=='n')
+            d->pos++;
+        while(isdigit(look(d,0)) || (look(d,0)>='a' && look(d,0)<='f'))
+            d->pos++;
+        if(start[0]=='n')
+            text = arena_format(d,&length,"-%.*s%.*s",(char*)start+1,d->pos-start-1,"",0);
+        else
+            text = arena_format(d,&length,"%.*s%.*s",(char*)start,d->pos-start,"",0);
+        if(type->kind==DM_NAME && (strncmp((char*)type->str,"float",type->length)==0 || strncmp((char*)type->str,"double",type->length)==0))
+            text = arena_format(d,&length,"[%.*s]%.*s",(char*)text,length,"",0);
+        node = make_string(d,DM_LITERAL,(char*)text,length,type);
+    }
+
+    if(node==NULL || !consume(d,'E'))
+        return NULL;
+    return node;
+}
+
+
+/* <function-param> ::= fp <CV-qualifiers> [<number>] _ | fL <number> p <CV-qualifiers> [<number>] _ */
+static dm_node_t * parse_function_param(demangler_t * d){
+
+    u64 index = 0;
+    u32 length;
+    char indexText[24];
+
+    if(consume2(d,"fL")){
+        if(!parse_count(d,&index) || !consume(d,'p'))
+            return NULL;
+    }
+    else if(!consume2(d,"fp"))
+        return NULL;
+
+    parse_cv_qualifiers(d);
+    index = 0;
+    u8 hasIndex = parse_count(d,&index);
+    if(!consume(d,'_'))
+        return NULL;
+
+    u32 indexLength = snprintf(indexText,sizeof(indexText),"%llu",hasIndex ? (unsigned long long)index+2 : 1ULL);
+    u8 * str = arena_format(d,&length,"{parm#%.*s}%.*s",indexText,indexLength,"",0);
+    return make_string(d,DM_NAME,(char*)str,length,NULL);
+}
+
+
+/* <simple-id> ::= <source-name> [<template-args>], operators included */
+static dm_node_t * parse_simple_id(demangler_t * d){
+
+    dm_node_t * name = parse_unqualified_name(d,NULL);
+    if(name==NULL || look(d,0)!='I')
+        return name;
+
+    dm_node_t * args = parse_template_args(d,0);
+    if(args!=NULL)
+        args->a = name;
+    return args;
+}
+
+
+/* <base-unresolved-name> ::= <simple-id> | on <operator-name> [<template-args>] */
+static dm_node_t * parse_base_unresolved_name(demangler_t * d){
+
+    consume2(d,"on");
+    return parse_simple_id(d);
+}
+
+
+/* Parse the expressions of a call until E */
+static dm_node_t * parse_expression_list(demangler_t * d, u8 kind, dm_node_t * callee){
+
+    u32 stackStart = d->stackSize;
+    while(!consume(d,'E')){
+        dm_node_t * arg = parse_expression(d);
+        if(arg==NULL)
+            return NULL;
+        push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,arg);
+    }
+
+    dm_node_t * node = make_node(d,kind,callee,NULL);
+    pop_list(d,stackStart,node);
+    return node;
+}
+
+
+/* <expression>, the forms which show up in template arguments of real programs */
+static dm_node_t * parse_expression(demangler_t * d){
+
+    if(++d->depth>DEMANGLE_MAX_DEPTH)
+        return NULL;
+
+    dm_node_t * node = NULL;
+    dm_node_t * a;
+    dm_node_t * b;
+
+    if(look(d,0)=='L')
+        node = parse_expr_primary(d);
+    else if(look(d,0)=='T')
+        node = parse_template_param(d);
+    else if(look(d,0)=='f' && (look(d,1)=='p' || look(d,1)=='L'))
+        node = parse_function_param(d);
+    else if(consume2(d,"sp")){
+        a = parse_expression(d);
+        node = a!=NULL ? make_node(d,DM_PACK_EXPANSION,a,NULL) : NULL;
+    }
+    else if(consume2(d,"sZ")){
+        a = look(d,0)=='T' ? parse_template_param(d) : parse_function_param(d);
+        node = a!=NULL ? make_node(d,DM_SIZEOF_PACK,a,NULL) : NULL;
+    }
+    else if(consume2(d,"st") || consume2(d,"at")){
+        u8 isSizeof = d->pos[-2]=='s';
+        a = parse_type(d);
+        node = a!=NULL ? make_string(d,DM_UNARY,isSizeof ? "sizeof " : "alignof ",isSizeof ? 7 : 8,a) : NULL;
+    }
+    else if(consume2(d,"sz") || consume2(d,"az")){
+        u8 isSizeof = d->pos[-2]=='s';
+        a = parse_expression(d);
+        node = a!=NULL ? make_string(d,DM_UNARY,isSizeof ? "sizeof " : "alignof ",isSizeof ? 7 : 8,a) : NULL;
+    }
+    else if(consume2(d,"cv")){
+        a = parse_type(d);
+        if(a!=NULL && consume(d,'_')){
+            node = parse_expression_list(d,DM_CALL,a);
+        }
+        else if(a!=NULL){
+            b = parse_expression(d);
+            node = b!=NULL ? make_node(d,DM_CAST,a,b) : NULL;
+        }
+    }
+    else if(consume2(d,"cl")){
+        a = parse_expression(d);
+        node = a!=NULL ? parse_expression_list(d,DM_CALL,a) : NULL;
+    }
+    else if(consume2(d,"sr")){
+        // Dependent names are a type then the member's name as GCC mangles them,
+        // or a list of qualifiers ended by E then the member's name as the ABI does
+        u8 * start = d->pos;
+        u32 numOfSubs = d->numOfSubs;
+        u32 stackSize = d->stackSize;
+
+        // Qualifiers which are source names are read the ABI's way first, the names this reading
+        // does not parse are read again as GCC mangled them, without the E
+        if(isdigit(look(d,0)) && d->unresolvedNames!=DM_UNRESOLVED_GCC){
+            d->unresolvedNames = DM_UNRESOLVED_ABI_READ;
+            a = NULL;
+            while(isdigit(look(d,0))){
+                b = parse_simple_id(d);
+                if(b==NULL)
+                    return NULL;
+                a = a!=NULL ? make_node(d,DM_NESTED,a,b) : b;
+            }
+            consume(d,'E');
+        }
+        else
+            a = parse_type(d);
+        b = a!=NULL ? parse_base_unresolved_name(d) : NULL;
+
+        if(b==NULL && !isdigit(*start)){
+            d->pos = start;
+            d->numOfSubs = numOfSubs;
+            d->stackSize = stackSize;
+            if(!consume(d,'N'))
+                return NULL;
+            a = parse_type(d);
+            if(a!=NULL && look(d,0)=='I'){
+                dm_node_t * args = parse_template_args(d,0);
+                if(args!=NULL)
+                    args->a = a;
+                a = args;
+            }
+            if(a==NULL)
+                return NULL;
+            while(!consume(d,'E')){
+                b = parse_simple_id(d);
+                if(b==NULL)
+                    return NULL;
+                a = make_node(d,DM_NESTED,a,b);
+            }
+            b = parse_base_unresolved_name(d);
+        }
+
+        node = b!=NULL ? make_node(d,DM_NESTED,a,b) : NULL;
+    }
+    else if(consume2(d,"dt") || consume2(d,"pt")){
+        u8 isArrow = d->pos[-2]=='p';
+        a = parse_expression(d);
+        b = a!=NULL ? parse_simple_id(d) : NULL;
+        node = b!=NULL ? make_string(d,DM_MEMBER_ACCESS,isArrow ? "->" : ".",isArrow ? 2 : 1,a) : NULL;
+        if(node!=NULL)
+            node->b = b;
+    }
+    else if(isdigit(look(d,0)) || (look(d,0)=='o' && look(d,1)=='n')){
+        consume2(d,"on");
+        node = parse_simple_id(d);
+    }
+    else{
+        const dm_operator_t * op = find_operator(d);
+        if(op!=NULL && op->arity!=0){
+            d->pos+=2;
+            // Prefix and postfix increments differ by a leading _
+            if(op->arity==1 && (op->code[0]=='p' || op->code[0]=='m') && op->code[1]==op->code[0])
+                consume(d,'_');
+            a = parse_expression(d);
+            if(a!=NULL && op->arity==1)
+                node = make_string(d,DM_UNARY,op->name,strlen(op->name),a);
+            else if(a!=NULL && op->arity==2){
+                b = parse_expression(d);
+                node = b!=NULL ? make_string(d,DM_BINARY,op->name,strlen(op->name),a) : NULL;
+                if(node!=NULL)
+                    node->b = b;
+            }
+            else if(a!=NULL){
+                u32 stackStart = d->stackSize;
+                push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,a);
+                for(u8 i=0;i<2;i++){
+                    dm_node_t * operand = parse_expression(d);
+                    if(operand==NULL)
+                        return NULL;
+                    push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,operand);
+                }
+                node = make_node(d,DM_CONDITIONAL,NULL,NULL);
+                pop_list(d,stackStart,node);
+            }
+        }
+    }
+
+    d->depth--;
+    return node;
+}
+
+
+/* <template-arg> ::= <type> | X <expression> E | <expr-primary> | J <template-arg>* E */
+static dm_node_t * parse_template_arg(demangler_t * d){
+
+    dm_node_t * arg;
+
+    if(consume(d,'X')){
+        arg = parse_expression(d);
+        if(arg==NULL || !consume(d,'E'))
+            return NULL;
+        return arg;
+    }
+
+    if(consume(d,'J')){
+        u32 stackStart = d->stackSize;
+        while(!consume(d,'E')){
+            arg = parse_template_arg(d);
+            if(arg==NULL)
+                return NULL;
+            push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,arg);
+        }
+        arg = make_node(d,DM_PACK,NULL,NULL);
+        pop_list(d,stackStart,arg);
+        return arg;
+    }
+
+    if(look(d,0)=='L'){
+        // External names are encodings rather than literals
+        if(look(d,1)=='Z'){
+            d->pos+=2;
+            arg = parse_encoding(d);
+            if(arg==NULL || !consume(d,'E'))
+                return NULL;
+            return arg;
+        }
+        return parse_expr_primary(d);
+    }
+
+    return parse_type(d);
+}
+
+
+/* <template-args> ::= I <template-arg>+ E, returns a template node missing its name */
+static dm_node_t * parse_template_args(demangler_t * d, u8 tagTemplates){
+
+    if(!consume(d,'I'))
+        return NULL;
+
+    // The arguments of a function's name are what its signature's template parameters refer to
+    if(tagTemplates)
+        d->numOfTemplateParams = 0;
+
+    u32 stackStart = d->stackSize;
+    while(!consume(d,'E')){
+        dm_node_t * arg = parse_template_arg(d);
+        if(arg==NULL)
+            return NULL;
+        push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,arg);
+        // Packs referred to by the template parameters are the ones expansions expand
+        if(tagTemplates && arg->kind==DM_PACK){
+            dm_node_t * pack = make_node(d,DM_PARAMETER_PACK,NULL,NULL);
+            pack->list = arg->list;
+            pack->length = arg->length;
+            arg = pack;
+        }
+        if(tagTemplates)
+            push_pointer(&d->templateParams,&d->numOfTemplateParams,&d->templateParamsCapacity,arg);
+    }
+
+    dm_node_t * node = make_node(d,DM_TEMPLATE,NULL,NULL);
+    pop_list(d,stackStart,node);
+    return node;
+}
+
+
+/* <function-type> ::= [<CV-qualifiers>] [Dx] F [Y] <return type> <parameter types> [<ref-qualifier>] E */
+static dm_node_t * parse_function_type(demangler_t * d){
+
+    if(!consume(d,'F'))
+        return NULL;
+    consume(d,'Y');
+
+    dm_node_t * returnType = parse_type(d);
+    if(returnType==NULL)
+        return NULL;
+
+    dm_node_t * node = make_node(d,DM_FUNCTION_TYPE,returnType,NULL);
+    u32 stackStart = d->stackSize;
+
+    while(!consume(d,'E')){
+        if(consume(d,'v'))
+            continue;
+        if(consume2(d,"RE")){
+            node->ref = DM_REF_LVALUE;
+            break;
+        }
+        if(consume2(d,"OE")){
+            node->ref = DM_REF_RVALUE;
+            break;
+        }
+        dm_node_t * param = parse_type(d);
+        if(param==NULL)
+            return NULL;
+        push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,param);
+    }
+
+    pop_list(d,stackStart,node);
+    return node;
+}
+
+
+/* <array-type> ::= A <number> _ <type> | A [<expression>] _ <type> */
+static dm_node_t * parse_array_type(demangler_t * d){
+
+    if(!consume(d,'A'))
+        return NULL;
+
+    dm_node_t * node = make_node(d,DM_ARRAY,NULL,NULL);
+    u8 * text;
+    u32 length;
+
+    if(isdigit(look(d,0))){
+        parse_number(d,0,&text,&length);
+        node->str = text;
+        node->length = length;
+    }
+    else if(look(d,0)!='_'){
+        node->b = parse_expression(d);
+        if(node->b==NULL)
+            return NULL;
+    }
+
+    if(!consume(d,'_'))
+        return NULL;
+    node->a = parse_type(d);
+
+    return node->a!=NULL ? node : NULL;
+}
+
+
+/* <type> of the parameters, return types and template arguments */
+static dm_node_t * parse_type(demangler_t * d){
+
+    if(++d->depth>DEMANGLE_MAX_DEPTH)
+        return NULL;
+
+    dm_node_t * result = NULL;
+    u8 c = look(d,0);
+
+    switch(c){
+        case 'r':
+        case 'V':
+        case 'K':{
+            u8 cv = parse_cv_qualifiers(d);
+            // Qualified functions are member function types, a single candidate with the qualifiers after the parameters
+            u8 isFunction = look(d,0)=='F' || (look(d,0)=='D' && strchr("oOwx",look(d,1))!=NULL && look(d,1)!=0);
+            dm_node_t * child = parse_type(d);
+            if(child==NULL)
+                return NULL;
+            if(isFunction && child->kind==DM_FUNCTION_TYPE){
+                child->cv |= cv;
+                d->depth--;
+                return child;
+            }
+            result = make_node(d,DM_QUALIFIED,child,NULL);
+            result->cv = cv;
+            break;
+        }
+        case 'U':{
+            d->pos++;
+            dm_node_t * qualifier = parse_source_name(d);
+            if(qualifier==NULL)
+                return NULL;
+            if(look(d,0)=='I' && parse_template_args(d,0)==NULL)
+                return NULL;
+            dm_node_t * child = parse_type(d);
+            if(child==NULL)
+                return NULL;
+            result = make_string(d,DM_VENDOR_QUALIFIED,(char*)qualifier->str,qualifier->length,child);
+            break;
+        }
+        case 'u':
+            d->pos++;
+            result = parse_source_name(d);
+            break;
+        case 'D':
+            c = look(d,1);
+            if(c>='a' && c<='z' && dmBuiltinDTypes[c]!=NULL){
+                d->pos+=2;
+                d->depth--;
+                return make_name(d,dmBuiltinDTypes[c]);
+            }
+            if(c=='F'){
+                // _Float<N>
+                u8 * text;
+                u32 length;
+                d->pos+=2;
+                if(!parse_number(d,0,&text,&length) || !consume(d,'_'))
+                    return NULL;
+                text = arena_format(d,&length,"_Float%.*s%.*s",(char*)text,length,"",0);
+                d->depth--;
+                return make_string(d,DM_NAME,(char*)text,length,NULL);
+            }
+            if(c=='p'){
+                d->pos+=2;
+                dm_node_t * child = parse_type(d);
+                result = child!=NULL ? make_node(d,DM_PACK_EXPANSION,child,NULL) : NULL;
+                break;
+            }
+            if(c=='t' || c=='T'){
+                d->pos+=2;
+                dm_node_t * expression = parse_expression(d);
+                if(expression==NULL || !consume(d,'E'))
+                    return NULL;
+                result = make_string(d,DM_UNARY,"decltype ",9,expression);
+                break;
+            }
+            if(c=='v'){
+                d->pos+=2;
+                result = make_node(d,DM_VECTOR,NULL,NULL);
+                if(isdigit(look(d,0))){
+                    u8 * text;
+                    u32 length;
+                    parse_number(d,0,&text,&length);
+                    result->str = text;
+                    result->length = length;
+                }
+                else if(consume(d,'_')){
+                    result->b = parse_expression(d);
+                    if(result->b==NULL)
+                        return NULL;
+                }
+                if(!consume(d,'_'))
+                    return NULL;
+                result->a = parse_type(d);
+                if(result->a==NULL)
+                    return NULL;
+                break;
+            }
+            if(c=='o' || c=='O' || c=='w' || c=='x'){
+                // Only the plain noexcept of the exception specifications is printed
+                d->pos+=2;
+                if(c=='O' && (parse_expression(d)==NULL || !consume(d,'E')))
+                    return NULL;
+                if(c=='w'){
+                    while(!consume(d,'E'))
+                        if(parse_type(d)==NULL)
+                            return NULL;
+                }
+                result = parse_type(d);
+                if(result==NULL || result->kind!=DM_FUNCTION_TYPE)
+                    return NULL;
+                if(c=='o')
+                    result->cv |= DM_CV_NOEXCEPT;
+                d->depth--;
+                return result;
+            }
+            return NULL;
+        case 'F':
+            result = parse_function_type(d);
+            break;
+        case 'A':
+            result = parse_array_type(d);
+            break;
+        case 'M':{
+            d->pos++;
+            dm_node_t * class = parse_type(d);
+            dm_node_t * member = class!=NULL ? parse_type(d) : NULL;
+            result = member!=NULL ? make_node(d,DM_MEMBER_POINTER,class,member) : NULL;
+            break;
+        }
+        case 'T':{
+            if(look(d,1)=='s' || look(d,1)=='u' || look(d,1)=='e'){
+                d->pos+=2;
+                result = parse_name(d,NULL);
+                break;
+            }
+            u64 index;
+            if(!parse_template_param_index(d,&index) || (result = resolve_template_param(d,index))==NULL)
+                return NULL;
+            dm_node_t * param = make_node(d,DM_TEMPLATE_PARAM,result,NULL);
+            param->length = index;
+            push_pointer(&d->subs,&d->numOfSubs,&d->subsCapacity,param);
+            if(look(d,0)!='I'){
+                d->depth--;
+                return result;
+            }
+            dm_node_t * args = parse_template_args(d,0);
+            if(args==NULL)
+                return NULL;
+            args->a = result;
+            result = args;
+            break;
+        }
+        case 'P':
+        case 'R':
+        case 'O':
+        case 'C':
+        case 'G':{
+            d->pos++;
+            dm_node_t * child = parse_type(d);
+            if(child==NULL)
+                return NULL;
+            if(c=='P')
+                result = make_node(d,DM_POINTER,child,NULL);
+            else if(c=='R')
+                result = make_node(d,DM_LVALUE_REF,child,NULL);
+            else if(c=='O')
+                result = make_node(d,DM_RVALUE_REF,child,NULL);
+            else
+                result = make_string(d,DM_VENDOR_QUALIFIED,c=='C' ? "_Complex" : "_Imaginary",c=='C' ? 8 : 10,child);
+            break;
+        }
+        case 'S':
+            if(look(d,1)=='t'){
+                result = parse_name(d,NULL);
+                break;
+            }
+            result = parse_substitution(d);
+            if(result==NULL)
+                return NULL;
+            // A substitution alone is not a new candidate
+            if(look(d,0)!='I'){
+                d->depth--;
+                return result;
+            }
+            dm_node_t * args = parse_template_args(d,0);
+            if(args==NULL)
+                return NULL;
+            args->a = result;
+            result = args;
+            break;
+        default:
+            if(c>='a' && c<='z' && dmBuiltinTypes[c]!=NULL){
+                d->pos++;
+                d->depth--;
+                return make_name(d,dmBuiltinTypes[c]);
+            }
+            result = parse_name(d,NULL);
+            break;
+    }
+
+    if(result==NULL)
+        return NULL;
+
+    push_pointer(&d->subs,&d->numOfSubs,&d->subsCapacity,result);
+    d->depth--;
+    return result;
+}
+
+
+/* <special-name> of the virtual tables, type information, thunks and guard variables */
+static dm_node_t * parse_special_name(demangler_t * d){
+
+    static const char * typePrefixes[][2] = {
+        {"TV","vtable for "},
+        {"TT","VTT for "},
+        {"TI","typeinfo for "},
+        {"TS","typeinfo name for "}
+    };
+
+    for(u32 i=0;i<sizeof(typePrefixes)/sizeof(typePrefixes[0]);i++){
+        if(consume2(d,typePrefixes[i][0])){
+            dm_node_t * type = parse_type(d);
+            return type!=NULL ? make_string(d,DM_SPECIAL,typePrefixes[i][1],strlen(typePrefixes[i][1]),type) : NULL;
+        }
+    }
+
+    const char * prefix = NULL;
+    dm_node_t * child;
+
+    if(consume(d,'T')){
+        switch(look(d,0)){
+            case 'h':
+            case 'v':
+                prefix = look(d,0)=='h' ? "non-virtual thunk to " : "virtual thunk to ";
+                if(!parse_call_offset(d))
+                    return NULL;
+                child = parse_encoding(d);
+                break;
+            case 'c':
+                prefix = "covariant return thunk to ";
+                d->pos++;
+                if(!parse_call_offset(d) || !parse_call_offset(d))
+                    return NULL;
+                child = parse_encoding(d);
+                break;
+            case 'C':{
+                d->pos++;
+                dm_node_t * derived = parse_type(d);
+                u64 offset;
+                if(derived==NULL || !parse_count(d,&offset) || !consume(d,'_'))
+                    return NULL;
+                dm_node_t * base = parse_type(d);
+                if(base==NULL)
+                    return NULL;
+                dm_node_t * node = make_string(d,DM_CONSTRUCTION_VTABLE,"construction vtable for ",24,base);
+                node->b = derived;
+                return node;
+            }
+            case 'W':
+            case 'H':
+                prefix = look(d,0)=='W' ? "TLS wrapper function for " : "TLS init function for ";
+                d->pos++;
+                child = parse_name(d,NULL);
+                break;
+            case 'A':
+                prefix = "template parameter object for ";
+                d->pos++;
+                child = parse_template_arg(d);
+                break;
+            default:
+                return NULL;
+        }
+    }
+    else if(consume(d,'G')){
+        switch(look(d,0)){
+            case 'V':
+                prefix = "guard variable for ";
+                d->pos++;
+                child = parse_name(d,NULL);
+                break;
+            case 'R':
+                prefix = "reference temporary for ";
+                d->pos++;
+                child = parse_name(d,NULL);
+                // The sequence number of the temporary is not printed
+                while(isalnum(look(d,0)))
+                    d->pos++;
+                if(child!=NULL && !consume(d,'_') && d->pos!=d->end)
+                    return NULL;
+                break;
+            case 'T':
+                prefix = "transaction clone for ";
+                d->pos++;
+                if(!consume(d,'t') && !consume(d,'n'))
+                    return NULL;
+                child = parse_encoding(d);
+                break;
+            case 'A':
+                prefix = "hidden alias for ";
+                d->pos++;
+                child = parse_encoding(d);
+                break;
+            default:
+                return NULL;
+        }
+    }
+    else
+        return NULL;
+
+    return child!=NULL ? make_string(d,DM_SPECIAL,prefix,strlen(prefix),child) : NULL;
+}
+
+
+/* <encoding> ::= <name> <bare-function-type> | <name> | <special-name> */
+static dm_node_t * parse_encoding_unscoped(demangler_t * d){
+
+    if(++d->depth>DEMANGLE_MAX_DEPTH)
+        return NULL;
+
+    if(look(d,0)=='G' || look(d,0)=='T'){
+        dm_node_t * special = parse_special_name(d);
+        d->depth--;
+        return special;
+    }
+
+    dm_name_state_t state = {0};
+    dm_node_t * name = parse_name(d,&state);
+    if(name==NULL)
+        return NULL;
+
+    // Data objects have no signature
+    if(d->pos==d->end || look(d,0)=='E' || look(d,0)=='.'){
+        d->depth--;
+        return name;
+    }
+
+    dm_node_t * returnType = NULL;
+    if(state.endsWithTemplateArgs && !state.ctorDtorConversion){
+        returnType = parse_type(d);
+        if(returnType==NULL)
+            return NULL;
+    }
+
+    dm_node_t * node = make_node(d,DM_ENCODING,returnType,name);
+    node->cv = state.cv;
+    node->ref = state.ref;
+
+    u32 stackStart = d->stackSize;
+    if(!consume(d,'v')){
+        while(d->pos<d->end && look(d,0)!='E' && look(d,0)!='.'){
+            dm_node_t * param = parse_type(d);
+            if(param==NULL)
+                return NULL;
+            push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,param);
+        }
+        if(d->stackSize==stackStart)
+            return NULL;
+    }
+    pop_list(d,stackStart,node);
+
+    d->depth--;
+    return node;
+}
+
+
+/* Parse an encoding, the template parameters of the enclosing names are kept for after it */
+static dm_node_t * parse_encoding(demangler_t * d){
+
+    u32 numOfSaved = d->numOfTemplateParams;
+    dm_node_t ** saved = NULL;
+    if(numOfSaved!=0){
+        saved = arena_alloc(&d->arena,numOfSaved*sizeof(dm_node_t*));
+        memcpy(saved,d->templateParams,numOfSaved*sizeof(dm_node_t*));
+    }
+
+    dm_node_t * node = parse_encoding_unscoped(d);
+
+    d->numOfTemplateParams = 0;
+    for(u32 i=0;i<numOfSaved;i++)
+        push_pointer(&d->templateParams,&d->numOfTemplateParams,&d->templateParamsCapacity,saved[i]);
+
+    return node;
+}
+
+
+
+/* Append to the demangled name */
+static void out(demangler_t * d, const char * str, u64 length){
+
+    if(d->outputLength+length+1>d->outputCapacity){
+        while(d->outputLength+length+1>d->outputCapacity)
+            d->outputCapacity = d->outputCapacity==0 ? 256 : d->outputCapacity*2;
+        d->output = realloc(d->output,d->outputCapacity);
+        if(d->output==NULL){
+            debug("Could not allocate the demangler's memory\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+    }
+    if(length!=0)
+        memcpy(d->output+d->outputLength,str,length);
+    d->outputLength += length;
+}
+
+
+/* Append a C string to the demangled name */
+static void out_str(demangler_t * d, const char * str){
+    out(d,str,strlen(str));
+}
+
+
+/* Last character of the demangled name so far */
+static u8 out_last(demangler_t * d){
+    return d->outputLength!=0 ? d->output[d->outputLength-1] : 0;
+}
+
+
+/* Append the qualifiers of a type or a member function */
+static void print_qualifiers(demangler_t * d, u8 cv, u8 ref){
+
+    if(cv & DM_CV_CONST)
+        out_str(d," const");
+    if(cv & DM_CV_VOLATILE)
+        out_str(d," volatile");
+    if(cv & DM_CV_RESTRICT)
+        out_str(d," restrict");
+    if(ref==DM_REF_LVALUE)
+        out_str(d," &");
+    else if(ref==DM_REF_RVALUE)
+        out_str(d," &&");
+    if(cv & DM_CV_NOEXCEPT)
+        out_str(d," noexcept");
+}
+
+
+/* Append a list of nodes separated by commas, returns whether the last one printed nothing */
+static u8 print_list(demangler_t * d, dm_node_t ** list, u32 length){
+
+    u8 lastIsEmpty = 0;
+    for(u32 i=0;i<length;i++){
+        u64 before = d->outputLength;
+        if(i!=0)
+            out_str(d,", ");
+        u64 afterSeparator = d->outputLength;
+        print_node(d,list[i]);
+        // Empty packs take their separator with them
+        lastIsEmpty = d->outputLength==afterSeparator && i!=0;
+        if(d->outputLength==afterSeparator)
+            d->outputLength = before;
+    }
+    return lastIsEmpty;
+}
+
+
+/* Element of a pack printed by the expansion being printed, or the node itself */
+static dm_node_t * resolve_pack(demangler_t * d, dm_node_t * node){
+
+    while(node->kind==DM_PARAMETER_PACK && d->packIndex>=0 && (u32)d->packIndex<node->length)
+        node = node->list[d->packIndex];
+    return node;
+}
+
+
+/* First pack a pack expansion expands */
+static dm_node_t * find_pack(dm_node_t * node, u32 depth){
+
+    if(node==NULL || depth>DEMANGLE_MAX_DEPTH)
+        return NULL;
+    if(node->kind==DM_PARAMETER_PACK)
+        return node;
+    // Nested expansions expand their own packs
+    if(node->kind==DM_PACK_EXPANSION)
+        return NULL;
+
+    dm_node_t * pack = find_pack(node->a,depth+1);
+    if(pack==NULL)
+        pack = find_pack(node->b,depth+1);
+    for(u32 i=0;pack==NULL && node->list!=NULL && i<node->length;i++)
+        pack = find_pack(node->list[i],depth+1);
+    return pack;
+}
+
+
+/* Pointee of a pointer or a reference, references to references collapse to a single one */
+static dm_node_t * collapse_reference(demangler_t * d, dm_node_t * node, u8 * kind){
+
+    *kind = node->kind;
+    dm_node_t * pointee = resolve_pack(d,node->a);
+    if(*kind==DM_POINTER)
+        return pointee;
+
+    while(pointee->kind==DM_LVALUE_REF || pointee->kind==DM_RVALUE_REF){
+        if(pointee->kind==DM_LVALUE_REF)
+            *kind = DM_LVALUE_REF;
+        pointee = resolve_pack(d,pointee->a);
+    }
+    return pointee;
+}
+
+
+/* Whether a type is an array, seen through its qualifiers */
+static u8 has_array(demangler_t * d, dm_node_t * node){
+
+    node = resolve_pack(d,node);
+    while(node->kind==DM_QUALIFIED)
+        node = resolve_pack(d,node->a);
+    return node->kind==DM_ARRAY;
+}
+
+
+/* Whether a type is a function, seen through its qualifiers */
+static u8 has_function(demangler_t * d, dm_node_t * node){
+
+    node = resolve_pack(d,node);
+    while(node->kind==DM_QUALIFIED)
+        node = resolve_pack(d,node->a);
+    return node->kind==DM_FUNCTION_TYPE;
+}
+
+
+/* Whether a type prints something after its name, like parameters or dimensions */
+static u8 has_rhs(demangler_t * d, dm_node_t * node){
+
+    node = resolve_pack(d,node);
+    switch(node->kind){
+        case DM_ARRAY:
+        case DM_FUNCTION_TYPE:
+        case DM_ENCODING:
+            return 1;
+        case DM_POINTER:
+        case DM_LVALUE_REF:
+        case DM_RVALUE_REF:
+        case DM_QUALIFIED:
+        case DM_VENDOR_QUALIFIED:
+            return has_rhs(d,node->a);
+        case DM_MEMBER_POINTER:
+            return has_rhs(d,node->b);
+        default:
+            return 0;
+    }
+}
+
+
+/* Print an operand of an expression, parenthesized unless it is a name */
+static void print_operand(demangler_t * d, dm_node_t * node){
+
+    dm_node_t * operand = resolve_pack(d,node);
+    if(operand->kind==DM_NAME || operand->kind==DM_NESTED){
+        print_node(d,operand);
+        return;
+    }
+    out_str(d,"(");
+    print_node(d,operand);
+    out_str(d,")");
+}
+
+
+/* Print what comes before the declared name */
+static void print_left(demangler_t * d, dm_node_t * node){
+
+    node = resolve_pack(d,node);
+    switch(node->kind){
+        case DM_NAME:
+            out(d,(char*)node->str,node->length);
+            break;
+        case DM_NESTED:
+            print_node(d,node->a);
+            out_str(d,"::");
+            print_node(d,node->b);
+            break;
+        case DM_LOCAL:
+            // The enclosing function is printed without its return type
+            if(node->a->kind==DM_ENCODING && node->a->a!=NULL){
+                dm_node_t function = *node->a;
+                function.a = NULL;
+                print_node(d,&function);
+            }
+            else
+                print_node(d,node->a);
+            out_str(d,"::");
+            print_node(d,node->b);
+            break;
+        case DM_TEMPLATE:
+            print_node(d,node->a);
+            if(out_last(d)=='<')
+                out_str(d," ");
+            out_str(d,"<");
+            // Like c++filt, arguments ending with an empty pack do not get the space between the >
+            if(!print_list(d,node->list,node->length) && out_last(d)=='>')
+                out_str(d," ");
+            out_str(d,">");
+            break;
+        case DM_SPECIAL:
+            out(d,(char*)node->str,node->length);
+            print_node(d,node->a);
+            break;
+        case DM_CONSTRUCTION_VTABLE:
+            out(d,(char*)node->str,node->length);
+            print_node(d,node->a);
+            out_str(d,"-in-");
+            print_node(d,node->b);
+            break;
+        case DM_CTOR_DTOR:
+            if(node->ref)
+                out_str(d,"~");
+            print_node(d,node->a);
+            break;
+        case DM_CONVERSION:
+            out_str(d,"operator ");
+            print_node(d,node->a);
+            break;
+        case DM_QUALIFIED:{
+            // Qualifiers of substituted types merge, the ones of arrays go to their elements
+            u8 cv = node->cv;
+            dm_node_t * child = resolve_pack(d,node->a);
+            while(child->kind==DM_QUALIFIED){
+                cv |= child->cv;
+                child = resolve_pack(d,child->a);
+            }
+            if(child->kind==DM_ARRAY){
+                dm_node_t element = {.kind=DM_QUALIFIED, .cv=cv, .a=child->a};
+                dm_node_t array = *child;
+                array.a = &element;
+                print_left(d,&array);
+                break;
+            }
+            print_left(d,child);
+            print_qualifiers(d,cv,0);
+            break;
+        }
+        case DM_VENDOR_QUALIFIED:
+            print_left(d,node->a);
+            out_str(d," ");
+            out(d,(char*)node->str,node->length);
+            break;
+        case DM_POINTER:
+        case DM_LVALUE_REF:
+        case DM_RVALUE_REF:{
+            u8 kind;
+            dm_node_t * pointee = collapse_reference(d,node,&kind);
+            print_left(d,pointee);
+            if(has_array(d,pointee))
+                out_str(d," ");
+            if(has_array(d,pointee) || has_function(d,pointee))
+                out_str(d,"(");
+            out_str(d,kind==DM_POINTER ? "*" : kind==DM_LVALUE_REF ? "&" : "&&");
+            break;
+        }
+        case DM_FUNCTION_TYPE:
+            print_left(d,node->a);
+            out_str(d," ");
+            break;
+        case DM_ENCODING:
+            if(node->a!=NULL){
+                print_left(d,node->a);
+                if(!has_rhs(d,node->a))
+                    out_str(d," ");
+            }
+            print_node(d,node->b);
+            break;
+        case DM_ARRAY:
+            print_left(d,node->a);
+            break;
+        case DM_MEMBER_POINTER:
+            print_left(d,node->b);
+            if(has_array(d,node->b) || has_function(d,node->b))
+                out_str(d,"(");
+            else
+                out_str(d," ");
+            print_node(d,node->a);
+            out_str(d,"::*");
+            break;
+        case DM_PACK_EXPANSION:{
+            // Expansions of template parameter packs are printed once per element
+            dm_node_t * pack = find_pack(node->a,0);
+            if(pack==NULL){
+                print_node(d,node->a);
+                out_str(d,"...");
+                break;
+            }
+            s32 packIndex = d->packIndex;
+            for(u32 i=0;i<pack->length;i++){
+                u64 before = d->outputLength;
+                if(i!=0)
+                    out_str(d,", ");
+                u64 afterSeparator = d->outputLength;
+                d->packIndex = i;
+                print_node(d,node->a);
+                if(d->outputLength==afterSeparator)
+                    d->outputLength = before;
+            }
+            d->packIndex = packIndex;
+            break;
+        }
+        case DM_PACK:
+            if(node->str!=NULL)
+                out_str(d,"[");
+            print_list(d,node->list,node->length);
+            if(node->str!=NULL)
+                out_str(d,"]");
+            break;
+        case DM_PARAMETER_PACK:
+            // Elements past the end of the pack print nothing
+            if(d->packIndex<0)
+                print_list(d,node->list,node->length);
+            break;
+        case DM_LITERAL:
+            if(node->a!=NULL){
+                out_str(d,"(");
+                print_node(d,node->a);
+                out_str(d,")");
+            }
+            out(d,(char*)node->str,node->length);
+            break;
+        case DM_ABI_TAG:
+            print_node(d,node->a);
+            out_str(d,"[abi:");
+            out(d,(char*)node->str,node->length);
+            out_str(d,"]");
+            break;
+        case DM_CLONE:
+            print_node(d,node->a);
+            out_str(d," [clone ");
+            out(d,(char*)node->str,node->length);
+            out_str(d,"]");
+            break;
+        case DM_CLOSURE:
+            out_str(d,"{lambda(");
+            print_list(d,node->list,node->length);
+            out_str(d,")#");
+            out(d,(char*)node->str,node->cv);
+            out_str(d,"}");
+            break;
+        case DM_VECTOR:
+            print_node(d,node->a);
+            out_str(d," __vector(");
+            if(node->b!=NULL)
+                print_node(d,node->b);
+            else
+                out(d,(char*)node->str,node->length);
+            out_str(d,")");
+            break;
+        case DM_UNARY:
+            out(d,(char*)node->str,node->length);
+            if(node->str[node->length-1]==' '){
+                out_str(d,"(");
+                print_node(d,node->a);
+                out_str(d,")");
+            }
+            // Addresses of plain member functions are printed as pointers to members, without their signature
+            else if(node->a->kind==DM_ENCODING && node->a->a==NULL && node->a->b->kind==DM_NESTED && node->a->cv==0 && node->a->ref==0)
+                print_node(d,node->a->b);
+            else
+                print_operand(d,node->a);
+            break;
+        case DM_BINARY:
+            print_operand(d,node->a);
+            out(d,(char*)node->str,node->length);
+            print_operand(d,node->b);
+            break;
+        case DM_MEMBER_ACCESS:
+            print_operand(d,node->a);
+            out(d,(char*)node->str,node->length);
+            print_node(d,node->b);
+            break;
+        case DM_CONDITIONAL:
+            print_operand(d,node->list[0]);
+            out_str(d,"?");
+            print_operand(d,node->list[1]);
+            out_str(d,":");
+            print_operand(d,node->list[2]);
+            break;
+        case DM_CALL:
+            print_operand(d,node->a);
+            out_str(d,"(");
+            print_list(d,node->list,node->length);
+            out_str(d,")");
+            break;
+        case DM_CAST:
+            out_str(d,"(");
+            print_node(d,node->a);
+            out_str(d,")");
+            print_operand(d,node->b);
+            break;
+        case DM_SIZEOF_PACK:
+            // The size of a known pack is a constant
+            if(node->a->kind==DM_PARAMETER_PACK){
+                char count[24];
+                out(d,count,snprintf(count,sizeof(count),"%u",node->a->length));
+                break;
+            }
+            out_str(d,"sizeof...(");
+            print_node(d,node->a);
+            out_str(d,")");
+            break;
+    }
+}
+
+
+/* Print what comes after the declared name */
+static void print_right(demangler_t * d, dm_node_t * node){
+
+    node = resolve_pack(d,node);
+    switch(node->kind){
+        case DM_QUALIFIED:
+        case DM_VENDOR_QUALIFIED:
+            print_right(d,node->a);
+            break;
+        case DM_POINTER:
+        case DM_LVALUE_REF:
+        case DM_RVALUE_REF:{
+            u8 kind;
+            dm_node_t * pointee = collapse_reference(d,node,&kind);
+            if(has_array(d,pointee) || has_function(d,pointee))
+                out_str(d,")");
+            print_right(d,pointee);
+            break;
+        }
+        case DM_FUNCTION_TYPE:
+            out_str(d,"(");
+            print_list(d,node->list,node->length);
+            out_str(d,")");
+            print_right(d,node->a);
+            print_qualifiers(d,node->cv,node->ref);
+            break;
+        case DM_ENCODING:
+            out_str(d,"(");
+            print_list(d,node->list,node->length);
+            out_str(d,")");
+            if(node->a!=NULL)
+                print_right(d,node->a);
+            print_qualifiers(d,node->cv,node->ref);
+            break;
+        case DM_ARRAY:
+            if(out_last(d)!=']')
+                out_str(d," ");
+            out_str(d,"[");
+            if(node->b!=NULL)
+                print_node(d,node->b);
+            else
+                out(d,(char*)node->str,node->length);
+            out_str(d,"]");
+            print_right(d,node->a);
+            break;
+        case DM_MEMBER_POINTER:
+            if(has_array(d,node->b) || has_function(d,node->b))
+                out_str(d,")");
+            print_right(d,node->b);
+            break;
+    }
+}
+
+
+/* Print a node of a parse tree */
+static void print_node(demangler_t * d, dm_node_t * node){
+
+    if(d->depth>DEMANGLE_MAX_DEPTH || d->outputLength>DEMANGLE_MAX_OUTPUT)
+        return;
+
+    d->depth++;
+    print_left(d,node);
+    print_right(d,node);
+    d->depth--;
+}
+
+
+
+/* Print a Rust name of the legacy mangling, a nested name of escaped identifiers ending with a hash.
+Returns 0 if the name is not one */
+static u8 print_rust_legacy_name(demangler_t * d, dm_node_t * root){
+
+    static const char * escapes[][2] = {
+        {"SP","@"}, {"BP","*"}, {"RF","&"}, {"LT","<"}, {"GT",">"}, {"LP","("}, {"RP",")"}, {"C",","}
+    };
+
+    if(root->kind!=DM_NESTED)
+        return 0;
+
+    // The hash is an h and 16 hexadecimal digits
+    dm_node_t * hash = root->b;
+    if(hash->kind!=DM_NAME || hash->length!=17 || hash->str[0]!='h')
+        return 0;
+    for(u32 i=1;i<17;i++)
+        if(!isdigit(hash->str[i]) && (hash->str[i]<'a' || hash->str[i]>'f'))
+            return 0;
+
+    // Components are gathered from the innermost one
+    u32 stackStart = d->stackSize;
+    for(dm_node_t * node=root;;node=node->a){
+        dm_node_t * component = node->kind==DM_NESTED ? node->b : node;
+        if(component->kind!=DM_NAME || component->b!=NULL){
+            d->stackSize = stackStart;
+            return 0;
+        }
+        push_pointer(&d->stack,&d->stackSize,&d->stackCapacity,component);
+        if(node->kind!=DM_NESTED)
+            break;
+    }
+
+    d->outputLength = 0;
+    for(u32 i=d->stackSize;i>stackStart;i--){
+        dm_node_t * component = d->stack[i-1];
+        u8 * c = component->str;
+        u8 * end = c + component->length;
+
+        if(i!=d->stackSize)
+            out_str(d,"::");
+        if(end-c>=2 && c[0]=='_' && c[1]=='$')
+            c++;
+
+        while(c<end){
+            if(c[0]=='.' && c+1<end && c[1]=='.'){
+                out_str(d,"::");
+                c+=2;
+                continue;
+            }
+            if(c[0]!='$'){
+                out(d,(char*)c,1);
+                c++;
+                continue;
+            }
+
+            u8 * escapeEnd = memchr(c+1,'$',end-c-1);
+            if(escapeEnd==NULL)
+                break;
+            u32 escapeLength = escapeEnd-c-1;
+            u8 found = 0;
+            for(u32 j=0;j<sizeof(escapes)/sizeof(escapes[0]) && !found;j++){
+                if(escapeLength==strlen(escapes[j][0]) && memcmp(c+1,escapes[j][0],escapeLength)==0){
+                    out_str(d,escapes[j][1]);
+                    found = 1;
+                }
+            }
+            // $u<hex>$ is any other character
+            if(!found && escapeLength>=2 && escapeLength<=3 && c[1]=='u'){
+                char hex[3] = {0};
+                memcpy(hex,c+2,escapeLength-1);
+                char * hexEnd;
+                char character = (char)strtoul(hex,&hexEnd,16);
+                if(*hexEnd==0 && character>=0x20 && character<0x7f){
+                    out(d,&character,1);
+                    found = 1;
+                }
+            }
+            if(!found)
+                break;
+            c = escapeEnd+1;
+        }
+
+        // Names with escapes Rust does not make are C++ names
+        if(c<end){
+            d->stackSize = stackStart;
+            d->outputLength = 0;
+            return 0;
+        }
+    }
+
+    d->stackSize = stackStart;
+    return 1;
+}
+
+
+/* Create an empty cache of demangled names */
+demangle_cache_t * demangle_cache_create(void){
+
+    demangle_cache_t * cache = calloc(1,sizeof(demangle_cache_t));
+    demangler_t * demangler = calloc(1,sizeof(demangler_t));
+    if(cache==NULL || demangler==NULL){
+        debug("Could not allocate the demangler's memory\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    cache->demangler = demangler;
+    cache->capacity = DEMANGLE_CACHE_INITIAL_CAPACITY;
+    cache->keys = calloc(cache->capacity,sizeof(u64));
+    cache->values = calloc(cache->capacity,sizeof(u8*));
+    if(cache->keys==NULL || cache->values==NULL){
+        debug("Could not allocate the demangler's memory\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    return cache;
+}
+
+
+/* Free all the blocks of an arena */
+static void arena_free(demangle_arena_t * arena){
+
+    demangle_arena_block_t * block = arena->first;
+    while(block!=NULL){
+        demangle_arena_block_t * next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->first = arena->current = NULL;
+}
+
+
+/* Free a cache, its demangler and the names it memoized */
+void demangle_cache_free(demangle_cache_t * cache){
+
+    demangler_t * d = cache->demangler;
+    arena_free(&d->arena);
+    free(d->subs);
+    free(d->templateParams);
+    free(d->stack);
+    free(d->output);
+    free(d);
+
+    arena_free(&cache->names);
+    free(cache->keys);
+    free(cache->values);
+    free(cache);
+}
+
+
+/* Parse the encoding after _Z and the clones' suffixes until end, returns NULL if it is not all parsed */
+static dm_node_t * parse_mangled_name(demangler_t * d, u8 * start, u8 * end){
+
+    arena_reset(&d->arena);
+    d->pos = start;
+    d->end = end;
+    d->depth = 0;
+    d->lambdaDepth = 0;
+    d->numOfSubs = 0;
+    d->numOfTemplateParams = 0;
+    d->stackSize = 0;
+
+    dm_node_t * root = parse_encoding(d);
+    if(root==NULL)
+        return NULL;
+
+    // Clones made by the optimizer keep their suffix, like .cold or .isra.0
+    while(look(d,0)=='.' && (islower(look(d,1)) || look(d,1)=='_' || isdigit(look(d,1)))){
+        u8 * suffix = d->pos;
+        d->pos++;
+        while(islower(look(d,0)) || look(d,0)=='_')
+            d->pos++;
+        while(look(d,0)=='.' && isdigit(look(d,1))){
+            d->pos++;
+            while(isdigit(look(d,0)))
+                d->pos++;
+        }
+        root = make_string(d,DM_CLONE,(char*)suffix,d->pos-suffix,root);
+    }
+
+    return d->pos==d->end ? root : NULL;
+}
+
+
+/* Demangle an Itanium C++ name, returns NULL if it is not a mangled name the demangler understands.
+The result is valid until the next call with the same cache */
+u8 * demangle(demangle_cache_t * cache, u8 * mangledName){
+
+    demangler_t * d = cache->demangler;
+    u64 length = strlen((char*)mangledName);
+
+    // Names are mangled as _Z, and as __Z on the systems which prefix an underscore
+    u8 * start = mangledName;
+    if(length>=3 && start[0]=='_' && start[1]=='_' && start[2]=='Z')
+        start++;
+    if(length<3 || start[0]!='_' || start[1]!='Z')
+        return NULL;
+
+    // The names which fail with an unresolved name read the ABI's way are parsed again the old GCC way
+    d->unresolvedNames = DM_UNRESOLVED_ABI;
+    dm_node_t * root = parse_mangled_name(d,start+2,mangledName+length);
+    if(root==NULL && d->unresolvedNames==DM_UNRESOLVED_ABI_READ){
+        d->unresolvedNames = DM_UNRESOLVED_GCC;
+        root = parse_mangled_name(d,start+2,mangledName+length);
+    }
+    if(root==NULL)
+        return NULL;
+
+    d->outputLength = 0;
+    d->depth = 0;
+    d->packIndex = -1;
+    if(!print_rust_legacy_name(d,root))
+        print_node(d,root);
+    if(d->outputLength>DEMANGLE_MAX_OUTPUT)
+        return NULL;
+    out(d,"",0);
+    d->output[d->outputLength] = 0;
+
+    return d->output;
+}
+
+
+/* Slot of a name's offset in the memo table */
+static u64 cache_slot(demangle_cache_t * cache, u64 key){
+
+    u64 slot = (key*0x9e3779b97f4a7c15ULL) & (cache->capacity-1);
+    while(cache->keys[slot]!=0 && cache->keys[slot]!=key)
+        slot = (slot+1) & (cache->capacity-1);
+    return slot;
+}
+
+
+/* Double the memo table */
+static void cache_grow(demangle_cache_t * cache){
+
+    u64 * oldKeys = cache->keys;
+    u8 ** oldValues = cache->values;
+    u64 oldCapacity = cache->capacity;
+
+    cache->capacity *= 2;
+    cache->keys = calloc(cache->capacity,sizeof(u64));
+    cache->values = calloc(cache->capacity,sizeof(u8*));
+    if(cache->keys==NULL || cache->values==NULL){
+        debug("Could not allocate the demangler's memory\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    for(u64 i=0;i<oldCapacity;i++){
+        if(oldKeys[i]==0)
+            continue;
+        u64 slot = cache_slot(cache,oldKeys[i]);
+        cache->keys[slot] = oldKeys[i];
+        cache->values[slot] = oldValues[i];
+    }
+
+    free(oldKeys);
+    free(oldValues);
+}
+
+
+/* Demangle a symbol's name once per name offset, returns the name itself if it cannot be demangled */
+u8 * demangle_symbol_name(demangle_cache_t * cache, u64 nameOffset, u8 * mangledName){
+
+    // Most names of C programs are not even candidates
+    if(mangledName[0]!='_' || (mangledName[1]!='Z' && mangledName[1]!='_'))
+        return mangledName;
+
+    u64 key = nameOffset+1;
+    u64 slot = cache_slot(cache,key);
+    if(cache->keys[slot]==key)
+        return cache->values[slot]!=NULL ? cache->values[slot] : mangledName;
+
+    u8 * demangled = demangle(cache,mangledName);
+    u8 * value = NULL;
+    if(demangled!=NULL){
+        u64 size = cache->demangler->outputLength+1;
+        value = arena_alloc(&cache->names,size);
+        memcpy(value,demangled,size);
+    }
+
+    // Keep the table at most half full
+    if((cache->numOfEntries+1)*2>cache->capacity){
+        cache_grow(cache);
+        slot = cache_slot(cache,key);
+    }
+    cache->keys[slot] = key;
+    cache->values[slot] = value;
+    cache->numOfEntries++;
+
+    return value!=NULL ? value : mangledName;
+}
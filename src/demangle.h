@@ -0,0 +1,58 @@
+#ifndef DEMANGLE_H
+#define DEMANGLE_H
+
+#include "./types.h"
+
+
+
+/* Size of the blocks the arenas allocate from */
+#define DEMANGLE_ARENA_BLOCK_SIZE 16384
+
+/* Deepest nesting of the parse trees, deeper names are left mangled */
+#define DEMANGLE_MAX_DEPTH 256
+
+
+
+/* Block of an arena */
+typedef struct demangle_arena_block{
+	struct demangle_arena_block * next;	/* Next block, kept when the arena is reset */
+	u64 size;			/* Size of the data */
+	u64 used;			/* Bytes of the data given out */
+	u8 data[];
+}demangle_arena_block_t;
+
+
+/* Bump allocator, everything is freed at once by resetting it */
+typedef struct demangle_arena{
+	demangle_arena_block_t * first;		/* First block */
+	demangle_arena_block_t * current;	/* Block being allocated from */
+}demangle_arena_t;
+
+
+/* Demangled names memoized by the file offset of their mangled name */
+typedef struct demangle_cache{
+	struct demangler * demangler;	/* Parser state, reused by all the names */
+	demangle_arena_t names;		/* Storage of the memoized names */
+	u64 * keys;			/* File offsets of the mangled names plus one, 0 for the free slots */
+	u8 ** values;		/* Demangled names, NULL for the names which are not mangled */
+	u64 numOfEntries;	/* Number of memoized names */
+	u64 capacity;		/* Number of slots, a power of two */
+}demangle_cache_t;
+
+
+
+/* Create an empty cache of demangled names */
+demangle_cache_t * demangle_cache_create(void);
+
+/* Free a cache, the names it returned included */
+void demangle_cache_free(demangle_cache_t * cache);
+
+/* Demangle an Itanium C++ name, returns NULL if it is not a mangled name the demangler understands.
+The result is valid until the next call with the same cache */
+u8 * demangle(demangle_cache_t * cache, u8 * mangledName);
+
+/* Demangle a symbol's name once per name offset, returns the name itself if it cannot be demangled */
+u8 * demangle_symbol_name(demangle_cache_t * cache, u64 nameOffset, u8 * mangledName);
+
+
+#endif
@@ -0,0 +1,524 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./pool.h"
+#include "./hash.h"
+#include "./diff.h"
+
+
+/* Entries allocated by the first growth of a table */
+#define DIFF_TABLE_INITIAL_CAPACITY 64
+
+/* Number of version indexes, the high bit of a versym entry hides the version */
+#define DIFF_VERSION_INDEX_MASK 0x7fff
+#define DIFF_VERSION_HIDDEN 0x8000
+
+/* Kinds of entries, the way they are named in the report */
+#define DIFF_KIND_SECTIONS 0
+#define DIFF_KIND_SEGMENTS 1
+#define DIFF_KIND_SYMBOLS 2
+
+
+
+/* Names of the versions of a file by their index */
+typedef struct diff_versions{
+    u8 ** names;        /* NULL for the indexes no version uses */
+    u64 numOfNames;
+}diff_versions_t;
+
+
+/* Changes found in one kind of entries */
+typedef struct diff_counts{
+    u64 matched;
+    u64 added;
+    u64 removed;
+    u64 resized;
+    u64 changed;        /* Same size, different contents */
+}diff_counts_t;
+
+
+
+static void table_add(diff_table_t * table, u8 * name, u8 * version, u8 hiddenVersion, u64 keyNumber, u32 idx, u64 size, u8 * contents){
+
+    if(table->numOfEntries==table->capacity){
+        table->capacity = table->capacity ? table->capacity*2 : DIFF_TABLE_INITIAL_CAPACITY;
+        table->entries = realloc(table->entries,table->capacity*sizeof(diff_entry_t));
+        if(!table->entries){
+            debug("Cannot allocate the entries of the diff\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+    }
+
+    diff_entry_t * entry = &table->entries[table->numOfEntries++];
+    memset(entry,0,sizeof(diff_entry_t));
+    entry->name = name;
+    entry->version = version;
+    entry->hiddenVersion = hiddenVersion;
+    entry->keyNumber = keyNumber;
+    entry->idx = idx;
+    entry->size = size;
+    entry->contents = contents;
+    entry->match = -1;
+}
+
+
+static u8 same_key(diff_entry_t * a, diff_entry_t * b){
+
+    if(a->keyHash!=b->keyHash || a->keyNumber!=b->keyNumber || strcmp(a->name,b->name)!=0)
+        return 0;
+    if(!a->version || !b->version)
+        return a->version==b->version;
+    return strcmp(a->version,b->version)==0;
+}
+
+
+/* Find the first entry of the table with the key of the given entry, -1 if there is none */
+static s64 table_find(diff_table_t * table, diff_entry_t * key){
+
+    u64 mask = table->numOfSlots-1;
+
+    for(u64 slot=key->keyHash&mask;table->slots[slot]>=0;slot=(slot+1)&mask)
+        if(same_key(&table->entries[table->slots[slot]],key))
+            return table->slots[slot];
+
+    return -1;
+}
+
+
+/* Hash the keys and chain the entries sharing a key behind the first one, in their order */
+static void table_index(diff_table_t * table){
+
+    table->numOfSlots = 16;
+    while(table->numOfSlots<table->numOfEntries*2)
+        table->numOfSlots*=2;
+
+    table->slots = malloc(table->numOfSlots*sizeof(s64));
+    if(!table->slots){
+        debug("Cannot allocate the index of the diff\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    memset(table->slots,0xff,table->numOfSlots*sizeof(s64));
+
+    u64 mask = table->numOfSlots-1;
+
+    for(u64 i=0;i<table->numOfEntries;i++){
+        diff_entry_t * entry = &table->entries[i];
+
+        entry->keyHash = xxh64(entry->name,strlen(entry->name),entry->keyNumber);
+        if(entry->version)
+            entry->keyHash ^= xxh64(entry->version,strlen(entry->version),~entry->keyNumber);
+        entry->nextDuplicate = -1;
+        entry->lastDuplicate = i;
+
+        u64 slot = entry->keyHash&mask;
+        for(;table->slots[slot]>=0;slot=(slot+1)&mask)
+            if(same_key(&table->entries[table->slots[slot]],entry))
+                break;
+
+        if(table->slots[slot]<0){
+            table->slots[slot] = i;
+            continue;
+        }
+
+        diff_entry_t * first = &table->entries[table->slots[slot]];
+        diff_entry_t * last = &table->entries[first->lastDuplicate];
+        last->nextDuplicate = i;
+        entry->ordinal = last->ordinal+1;
+        first->lastDuplicate = i;
+    }
+}
+
+
+/* Hash join: the n-th entry with a key in a matches the n-th one with the same key in b */
+static void table_join(diff_table_t * a, diff_table_t * b){
+
+    for(u64 i=0;i<a->numOfEntries;i++){
+        diff_entry_t * entry = &a->entries[i];
+        if(entry->ordinal)
+            continue;
+
+        s64 other = table_find(b,entry);
+        for(s64 mine=i;mine>=0 && other>=0;mine=a->entries[mine].nextDuplicate,other=b->entries[other].nextDuplicate){
+            a->entries[mine].match = other;
+            b->entries[other].match = mine;
+        }
+    }
+}
+
+
+
+/* Contents of the string table a section links to */
+static u8 * linked_strings(kvelf_basic_params_t * kvelfp, u32 sectionIdx, u64 * stringsSize){
+
+    u32 link = kvelfp->elfSectionsMetadata[sectionIdx].sLink;
+    return get_section_contents(kvelfp,link,stringsSize);
+}
+
+
+static void set_version_name(diff_versions_t * versions, u64 versionIdx, u8 * name){
+
+    versionIdx &= DIFF_VERSION_INDEX_MASK;
+
+    if(versionIdx>=versions->numOfNames){
+        u64 numOfNames = versionIdx+1;
+        versions->names = realloc(versions->names,numOfNames*sizeof(u8 *));
+        if(!versions->names){
+            debug("Cannot allocate the symbol versions\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+        memset(versions->names+versions->numOfNames,0,(numOfNames-versions->numOfNames)*sizeof(u8 *));
+        versions->numOfNames = numOfNames;
+    }
+    versions->names[versionIdx] = name;
+}
+
+
+/* Name the version indexes from the version definitions and the needed versions */
+static void read_version_names(kvelf_basic_params_t * kvelfp, diff_versions_t * versions){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+
+    versions->names = NULL;
+    versions->numOfNames = 0;
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        u32 sectionType = kvelfp->elfSectionsMetadata[i].sType;
+        if(sectionType!=SHT_GNU_verdef && sectionType!=SHT_GNU_verneed)
+            continue;
+
+        u64 contentsSize, stringsSize;
+        u8 * contents = get_section_contents(kvelfp,i,&contentsSize);
+        u8 * strings = linked_strings(kvelfp,i,&stringsSize);
+        if(!contents || !strings)
+            continue;
+
+        // Both lists are chained by the offset of the next entry, at most sh_info entries
+        u64 offset=0;
+        for(u32 entryIdx=0;entryIdx<kvelfp->elfSectionsMetadata[i].sInfo && offset<contentsSize;entryIdx++){
+            data_reader_t reader;
+            reader_init(&reader,contents+offset,contentsSize-offset,needsSwap);
+
+            if(sectionType==SHT_GNU_verdef){
+                // Verdef: version, flags, index, count, hash, aux, next, the first aux names the version
+                reader_skip(&reader,4);
+                u16 versionIdx = reader_u16(&reader);
+                reader_skip(&reader,6);
+                u32 auxOffset = reader_u32(&reader);
+                u32 nextOffset = reader_u32(&reader);
+
+                data_reader_t auxReader;
+                if(!reader.error && auxOffset<contentsSize-offset){
+                    reader_init(&auxReader,contents+offset+auxOffset,contentsSize-offset-auxOffset,needsSwap);
+                    u32 nameOffset = reader_u32(&auxReader);
+                    u8 * name = string_at(strings,stringsSize,nameOffset);
+                    if(!auxReader.error && *name)
+                        set_version_name(versions,versionIdx,name);
+                }
+
+                if(reader.error || !nextOffset)
+                    break;
+                offset += nextOffset;
+            }else{
+                // Verneed: version, count, file, aux, next, every aux is one needed version
+                reader_skip(&reader,2);
+                u16 numOfAux = reader_u16(&reader);
+                reader_skip(&reader,4);
+                u32 auxOffset = reader_u32(&reader);
+                u32 nextOffset = reader_u32(&reader);
+
+                u64 auxPosition = offset+auxOffset;
+                for(u16 auxIdx=0;!reader.error && auxIdx<numOfAux && auxPosition<contentsSize;auxIdx++){
+                    // Vernaux: hash, flags, other (the version index), name, next
+                    data_reader_t auxReader;
+                    reader_init(&auxReader,contents+auxPosition,contentsSize-auxPosition,needsSwap);
+                    reader_skip(&auxReader,6);
+                    u16 versionIdx = reader_u16(&auxReader);
+                    u8 * name = string_at(strings,stringsSize,reader_u32(&auxReader));
+                    u32 auxNext = reader_u32(&auxReader);
+                    if(auxReader.error)
+                        break;
+                    if(*name)
+                        set_version_name(versions,versionIdx,name);
+                    if(!auxNext)
+                        break;
+                    auxPosition += auxNext;
+                }
+
+                if(reader.error || !nextOffset)
+                    break;
+                offset += nextOffset;
+            }
+        }
+    }
+}
+
+
+/* Versym table of a symbol table, NULL if its symbols have no versions */
+static u8 * find_versym(kvelf_basic_params_t * kvelfp, u32 symbolTableIdx, u64 * versymSize){
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++)
+        if(kvelfp->elfSectionsMetadata[i].sType==SHT_GNU_versym && kvelfp->elfSectionsMetadata[i].sLink==symbolTableIdx)
+            return get_section_contents(kvelfp,i,versymSize);
+
+    *versymSize=0;
+    return NULL;
+}
+
+
+
+static void collect_sections(kvelf_basic_params_t * kvelfp, diff_table_t * table){
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        if(kvelfp->elfSectionsMetadata[i].sType==SHT_NULL)
+            continue;
+
+        u64 contentsSize;
+        u8 * contents = get_section_contents(kvelfp,i,&contentsSize);
+        table_add(table,get_section_name(kvelfp,i),NULL,0,0,i,kvelfp->elfSectionsMetadata[i].sSize,contents);
+    }
+}
+
+
+static void collect_segments(kvelf_basic_params_t * kvelfp, diff_table_t * table){
+
+    for(u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+        segment_metadata_t * segment = &kvelfp->elfSegmentsMetadata[i];
+
+        u64 contentsSize;
+        u8 * contents = get_segment_contents(kvelfp,i,&contentsSize);
+        table_add(table,get_elf_segment_type(segment->pType),NULL,0,segment->pType,i,segment->pFileSize,contents);
+    }
+}
+
+
+/* Symbols of .symtab and .dynsym, keyed by their table's type, their name and their version */
+static void collect_symbols(kvelf_basic_params_t * kvelfp, diff_table_t * table){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+    diff_versions_t versions;
+
+    read_version_names(kvelfp,&versions);
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        u32 sectionType = kvelfp->elfSectionsMetadata[i].sType;
+        if(sectionType!=SHT_SYMTAB && sectionType!=SHT_DYNSYM)
+            continue;
+
+        u64 symbolsSize, stringsSize, versymSize;
+        u8 * symbols = get_section_contents(kvelfp,i,&symbolsSize);
+        u8 * strings = linked_strings(kvelfp,i,&stringsSize);
+        u8 * versym = find_versym(kvelfp,i,&versymSize);
+        if(!symbols || !strings)
+            continue;
+
+        data_reader_t reader;
+        reader_init(&reader,symbols,symbolsSize,needsSwap);
+
+        for(u64 symbolIdx=0;symbolIdx<symbolsSize/symbolSize;symbolIdx++){
+            u32 nameOffset;
+            u8 info;
+            u16 sectionIdx;
+            u64 size;
+
+            if(kvelfp->elfClass==ELFCLASS32){
+                nameOffset = reader_u32(&reader);
+                reader_skip(&reader,4);
+                size = reader_u32(&reader);
+                info = reader_u8(&reader);
+                reader_skip(&reader,1);
+                sectionIdx = reader_u16(&reader);
+            }else{
+                nameOffset = reader_u32(&reader);
+                info = reader_u8(&reader);
+                reader_skip(&reader,1);
+                sectionIdx = reader_u16(&reader);
+                reader_skip(&reader,8);
+                size = reader_u64(&reader);
+            }
+
+            u8 * name = string_at(strings,stringsSize,nameOffset);
+            if(reader.error || !*name || ELF64_ST_TYPE(info)==STT_SECTION)
+                continue;
+
+            u8 * version = NULL;
+            u8 hiddenVersion = 0;
+            if(versym && (symbolIdx+1)*2<=versymSize){
+                data_reader_t versymReader;
+                reader_init(&versymReader,versym+symbolIdx*2,2,needsSwap);
+                u16 versionIdx = reader_u16(&versymReader);
+
+                // 0 and 1 are the local and the global unversioned symbols
+                if((versionIdx&DIFF_VERSION_INDEX_MASK)>1 && (versionIdx&DIFF_VERSION_INDEX_MASK)<versions.numOfNames){
+                    version = versions.names[versionIdx&DIFF_VERSION_INDEX_MASK];
+                    hiddenVersion = (versionIdx&DIFF_VERSION_HIDDEN)!=0 || sectionIdx==SHN_UNDEF;
+                }
+            }
+
+            table_add(table,name,version,hiddenVersion,sectionType,symbolIdx,size,NULL);
+        }
+    }
+
+    free(versions.names);
+}
+
+
+
+static void hash_task(void * context, u64 taskIdx){
+
+    diff_entry_t * entry = ((diff_entry_t **)context)[taskIdx];
+    entry->contentsHash = xxh64(entry->contents,entry->size,0);
+}
+
+
+/* Hash the contents of the sections and the segments of both files on the pool */
+static void hash_contents_of_tables(thread_pool_t * pool, diff_table_t ** tables, u32 numOfTables){
+
+    u64 numOfTasks=0;
+    for(u32 i=0;i<numOfTables;i++)
+        numOfTasks += tables[i]->numOfEntries;
+
+    diff_entry_t ** tasks = malloc((numOfTasks+1)*sizeof(diff_entry_t *));
+    if(!tasks){
+        debug("Cannot allocate the hash tasks of the diff\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    numOfTasks=0;
+    for(u32 i=0;i<numOfTables;i++)
+        for(u64 j=0;j<tables[i]->numOfEntries;j++){
+            diff_entry_t * entry = &tables[i]->entries[j];
+            // A segment's contents in the file are its file size, a section's may be none
+            if(entry->contents)
+                tasks[numOfTasks++] = entry;
+        }
+
+    pool_parallel_for(pool,numOfTasks,hash_task,tasks);
+    free(tasks);
+}
+
+
+
+/* Print an entry's name with its version, and its ordinal for the segments and the repeated keys */
+static void print_entry_name(diff_entry_t * entry, u8 kind){
+
+    if(kind==DIFF_KIND_SYMBOLS)
+        fprintf(display_output(),"%s ",entry->keyNumber==SHT_DYNSYM ? "dynsym" : "symtab");
+    fprintf(display_output(),"%s",entry->name);
+    if(entry->version)
+        fprintf(display_output(),"%s%s",entry->hiddenVersion ? "@" : "@@",entry->version);
+    if(entry->ordinal || kind==DIFF_KIND_SEGMENTS)
+        fprintf(display_output(),"[%u]",entry->ordinal);
+}
+
+
+/* Print the changes of one kind of entries and count them, the symbols have no contents */
+static void report_table(diff_table_t * a, diff_table_t * b, u8 * title, u8 kind){
+
+    diff_counts_t counts;
+
+    memset(&counts,0,sizeof(counts));
+    display(title,DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"\n");
+
+    for(u64 i=0;i<a->numOfEntries;i++){
+        diff_entry_t * entry = &a->entries[i];
+
+        if(entry->match<0){
+            counts.removed++;
+            display("- ",DISPLAY_COLOR_RED);
+            print_entry_name(entry,kind);
+            fprintf(display_output(),"  %llu\n",entry->size);
+            continue;
+        }
+
+        counts.matched++;
+        diff_entry_t * other = &b->entries[entry->match];
+
+        if(entry->size!=other->size){
+            counts.resized++;
+            display("~ ",DISPLAY_COLOR_ORANGE);
+            print_entry_name(entry,kind);
+            fprintf(display_output(),"  %llu -> %llu (%+lld)\n",entry->size,other->size,(s64)(other->size-entry->size));
+        }else if(entry->contents && other->contents && entry->contentsHash!=other->contentsHash){
+            counts.changed++;
+            display("* ",DISPLAY_COLOR_PURPLE);
+            print_entry_name(entry,kind);
+            fprintf(display_output(),"  contents changed\n");
+        }
+    }
+
+    for(u64 i=0;i<b->numOfEntries;i++){
+        diff_entry_t * entry = &b->entries[i];
+        if(entry->match>=0)
+            continue;
+
+        counts.added++;
+        display("+ ",DISPLAY_COLOR_GREEN_YELLOW);
+        print_entry_name(entry,kind);
+        fprintf(display_output(),"  %llu\n",entry->size);
+    }
+
+    fprintf(display_output(),"%llu matched, %llu added, %llu removed, %llu resized",counts.matched,counts.added,counts.removed,counts.resized);
+    if(kind!=DIFF_KIND_SYMBOLS)
+        fprintf(display_output(),", %llu changed",counts.changed);
+    fprintf(display_output(),"\n\n");
+}
+
+
+
+/* Print the sections, segments and symbols added, removed, resized or changed from a to b */
+void elf_diff(kvelf_basic_params_t * a, kvelf_basic_params_t * b){
+
+    if(!a->elfImage || !b->elfImage){
+        debug("diff needs both files mapped in memory\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    diff_table_t sections[2], segments[2], symbols[2];
+    kvelf_basic_params_t * files[2] = {a,b};
+
+    memset(sections,0,sizeof(sections));
+    memset(segments,0,sizeof(segments));
+    memset(symbols,0,sizeof(symbols));
+
+    for(u32 i=0;i<2;i++){
+        collect_sections(files[i],&sections[i]);
+        collect_segments(files[i],&segments[i]);
+        collect_symbols(files[i],&symbols[i]);
+
+        table_index(&sections[i]);
+        table_index(&segments[i]);
+        table_index(&symbols[i]);
+    }
+
+    table_join(&sections[0],&sections[1]);
+    table_join(&segments[0],&segments[1]);
+    table_join(&symbols[0],&symbols[1]);
+
+    if(!a->threadPool)
+        a->threadPool = pool_create(0);
+
+    diff_table_t * hashedTables[4] = {&sections[0],&sections[1],&segments[0],&segments[1]};
+    hash_contents_of_tables(a->threadPool,hashedTables,4);
+
+    fprintf(display_output(),"\n--- %s\n+++ %s\n\n",a->filePath,b->filePath);
+    report_table(&sections[0],&sections[1],"Sections",DIFF_KIND_SECTIONS);
+    report_table(&segments[0],&segments[1],"Segments",DIFF_KIND_SEGMENTS);
+    report_table(&symbols[0],&symbols[1],"Symbols",DIFF_KIND_SYMBOLS);
+
+    for(u32 i=0;i<2;i++){
+        free(sections[i].entries);
+        free(sections[i].slots);
+        free(segments[i].entries);
+        free(segments[i].slots);
+        free(symbols[i].entries);
+        free(symbols[i].slots);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef DIFF_H
+#define DIFF_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Entry of a section, segment or symbol table matched between the two files */
+typedef struct diff_entry{
+	u8 * name;			/* Section's name, segment's type or symbol's name */
+	u8 * version;		/* Symbol's version, NULL if it has none */
+	u8 hiddenVersion;	/* Whether the version is not the symbol's default one, or is a needed one */
+	u64 keyNumber;		/* Segment's type or symbol table's type, the entries only match equal ones */
+	u64 keyHash;		/* Hash of the name, the version and the key number */
+	u32 idx;			/* Index of the entry in its table */
+	u32 ordinal;		/* Number of the entries with the same key before this one */
+	u64 size;			/* Size of the section, the segment in the file or the symbol */
+	u8 * contents;		/* Contents in the mapped file, NULL if there are none */
+	u64 contentsHash;	/* XXH64 of the contents */
+	s64 nextDuplicate;	/* Next entry with the same key, -1 for the last one */
+	s64 lastDuplicate;	/* Last entry with the same key, only kept by the first one */
+	s64 match;			/* Matching entry of the other file, -1 if there is none */
+}diff_entry_t;
+
+
+/* Entries of one kind of one file, indexed by their key */
+typedef struct diff_table{
+	diff_entry_t * entries;
+	u64 numOfEntries;
+	u64 capacity;		/* Number of entries allocated */
+	s64 * slots;		/* Open addressing table of the first entries of the keys, -1 for the free slots */
+	u64 numOfSlots;		/* A power of two */
+}diff_table_t;
+
+
+
+/* Print the sections, segments and symbols added, removed, resized or changed from a to b */
+void elf_diff(kvelf_basic_params_t * a, kvelf_basic_params_t * b);
+
+
+#endif
@@ -0,0 +1,2301 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./kvelf.h"
+#include "./symindex.h"
+#include "./disasm.h"
+
+
+
+/* Operand types of the opcode tables, the letters of the Intel opcode maps */
+#define OT_NONE 0
+#define OT_E 1		/* ModRM r/m: general register or memory */
+#define OT_G 2		/* ModRM reg: general register */
+#define OT_M 3		/* ModRM r/m: memory only */
+#define OT_R 4		/* ModRM r/m: general register, whatever the mod */
+#define OT_I 5		/* Immediate */
+#define OT_IS 6		/* Byte immediate sign-extended to the operand size */
+#define OT_ONE 7	/* 1 of the shifts */
+#define OT_J 8		/* Relative branch */
+#define OT_O 9		/* Absolute memory offset */
+#define OT_Z 10		/* General register of the opcode's low 3 bits */
+#define OT_A 11		/* Accumulator */
+#define OT_CL 12
+#define OT_DX 13	/* Port of in and out */
+#define OT_X 14		/* ds:[rsi] */
+#define OT_Y 15		/* es:[rdi] */
+#define OT_S 16		/* ModRM reg: segment register */
+#define OT_C 17		/* ModRM reg: control register */
+#define OT_D 18		/* ModRM reg: debug register */
+#define OT_V 19		/* ModRM reg: vector register */
+#define OT_H 20		/* VEX.vvvv: vector register */
+#define OT_W 21		/* ModRM r/m: vector register or memory */
+#define OT_U 22		/* ModRM r/m: vector register only */
+#define OT_L 23		/* High 4 bits of the immediate: vector register */
+#define OT_P 24		/* ModRM reg: MMX register */
+#define OT_Q 25		/* ModRM r/m: MMX register or memory */
+#define OT_N 26		/* ModRM r/m: MMX register only */
+#define OT_KG 27	/* ModRM reg: mask register */
+#define OT_KE 28	/* ModRM r/m: mask register or memory */
+#define OT_KH 29	/* VEX.vvvv: mask register */
+#define OT_B 30		/* VEX.vvvv: general register */
+#define OT_XMM0 31	/* Implicit xmm0 */
+#define OT_SEG 32	/* Fixed segment register, the size field holds which */
+#define OT_XLAT 33	/* ds:[rbx] */
+#define OT_VSIB 34	/* ModRM r/m: memory with a vector index, the size field is the index's */
+
+/* Operand sizes of the opcode tables */
+#define SZ_NONE 0	/* No size keyword */
+#define SZ_B 1
+#define SZ_W 2
+#define SZ_D 3
+#define SZ_Q 4
+#define SZ_T 5		/* x87 extended precision */
+#define SZ_O 6		/* 16 bytes printed OWORD */
+#define SZ_DQ 7		/* 16 bytes, xmm registers */
+#define SZ_QQ 8		/* 32 bytes, ymm registers */
+#define SZ_V 9		/* Operand size: 16, 32 or 64 bits */
+#define SZ_Y 10		/* 32 or 64 bits by REX.W */
+#define SZ_Z 11		/* 16 or 32 bits, the immediates sign-extend to the operand size */
+#define SZ_P 12		/* Far pointer */
+#define SZ_X 13		/* Vector length */
+#define SZ_XH 14	/* Half the vector length */
+#define SZ_XQ 15	/* Quarter of the vector length */
+#define SZ_XO 16	/* Eighth of the vector length */
+#define SZ_VW 17	/* Operand size in a register, a word in memory */
+#define SZ_DW 18	/* Dword in a register, a word in memory */
+#define SZ_DB 19	/* Dword in a register, a byte in memory */
+#define SZ_E 20		/* Vector element: dword or qword by W */
+#define SZ_QO 21	/* QWORD, OWORD with REX.W */
+#define SZ_XDUP 22	/* Vector length, a qword for 128 bits */
+#define SZ_V64 23	/* Operand size of push and pop: 64 bits, 16 with 66 */
+
+#define OP(type,size) ((u16)((type)|((size)<<8)))
+#define OP_TYPE(spec) ((spec)&0xff)
+#define OP_SIZE(spec) ((spec)>>8)
+
+#define Eb OP(OT_E,SZ_B)
+#define Ew OP(OT_E,SZ_W)
+#define Ed OP(OT_E,SZ_D)
+#define Eq OP(OT_E,SZ_Q)
+#define Ev OP(OT_E,SZ_V)
+#define Ey OP(OT_E,SZ_Y)
+#define Ev64 OP(OT_E,SZ_V64)
+#define Evw OP(OT_E,SZ_VW)
+#define Edw OP(OT_E,SZ_DW)
+#define Edb OP(OT_E,SZ_DB)
+#define Gb OP(OT_G,SZ_B)
+#define Gw OP(OT_G,SZ_W)
+#define Gd OP(OT_G,SZ_D)
+#define Gq OP(OT_G,SZ_Q)
+#define Gv OP(OT_G,SZ_V)
+#define Gy OP(OT_G,SZ_Y)
+#define M0 OP(OT_M,SZ_NONE)
+#define Mb OP(OT_M,SZ_B)
+#define Mw OP(OT_M,SZ_W)
+#define Md OP(OT_M,SZ_D)
+#define Mq OP(OT_M,SZ_Q)
+#define Mt OP(OT_M,SZ_T)
+#define Mp OP(OT_M,SZ_P)
+#define Mv OP(OT_M,SZ_V)
+#define My OP(OT_M,SZ_Y)
+#define Mdq OP(OT_M,SZ_DQ)
+#define Mqq OP(OT_M,SZ_QQ)
+#define Mx OP(OT_M,SZ_X)
+#define Mqo OP(OT_M,SZ_QO)
+#define Rv OP(OT_R,SZ_V)
+#define Ry OP(OT_R,SZ_Y)
+#define Rd OP(OT_R,SZ_D)
+#define Rq OP(OT_R,SZ_Q)
+#define Ib OP(OT_I,SZ_B)
+#define Iw OP(OT_I,SZ_W)
+#define Iz OP(OT_I,SZ_Z)
+#define Iv OP(OT_I,SZ_V)
+#define Ibs OP(OT_IS,SZ_V)
+#define I1 OP(OT_ONE,SZ_NONE)
+#define Jb OP(OT_J,SZ_B)
+#define Jz OP(OT_J,SZ_Z)
+#define Ob OP(OT_O,SZ_B)
+#define Ov OP(OT_O,SZ_V)
+#define Zb OP(OT_Z,SZ_B)
+#define Zv OP(OT_Z,SZ_V)
+#define Zy OP(OT_Z,SZ_Y)
+#define Z64 OP(OT_Z,SZ_V64)
+#define AL OP(OT_A,SZ_B)
+#define rAX OP(OT_A,SZ_V)
+#define eAX OP(OT_A,SZ_Z)
+#define CL OP(OT_CL,SZ_B)
+#define DX OP(OT_DX,SZ_W)
+#define Xb OP(OT_X,SZ_B)
+#define Xv OP(OT_X,SZ_V)
+#define Xz OP(OT_X,SZ_Z)
+#define Yb OP(OT_Y,SZ_B)
+#define Yv OP(OT_Y,SZ_V)
+#define Yz OP(OT_Y,SZ_Z)
+#define Sw OP(OT_S,SZ_W)
+#define Cq OP(OT_C,SZ_Q)
+#define Dq OP(OT_D,SZ_Q)
+#define FS OP(OT_SEG,X86_SEGMENT_FS)
+#define GS OP(OT_SEG,X86_SEGMENT_GS)
+#define XLAT OP(OT_XLAT,SZ_B)
+#define Vx OP(OT_V,SZ_X)
+#define Vxh OP(OT_V,SZ_XH)
+#define Vdq OP(OT_V,SZ_DQ)
+#define Vqq OP(OT_V,SZ_QQ)
+#define Vq OP(OT_V,SZ_Q)
+#define Vd OP(OT_V,SZ_D)
+#define Ve OP(OT_V,SZ_E)
+#define Hx OP(OT_H,SZ_X)
+#define Hxh OP(OT_H,SZ_XH)
+#define Wx OP(OT_W,SZ_X)
+#define Wxh OP(OT_W,SZ_XH)
+#define Wxq OP(OT_W,SZ_XQ)
+#define Wxo OP(OT_W,SZ_XO)
+#define Wxdup OP(OT_W,SZ_XDUP)
+#define Wdq OP(OT_W,SZ_DQ)
+#define Wqq OP(OT_W,SZ_QQ)
+#define Wq OP(OT_W,SZ_Q)
+#define Wd OP(OT_W,SZ_D)
+#define Ww OP(OT_W,SZ_W)
+#define Wb OP(OT_W,SZ_B)
+#define We OP(OT_W,SZ_E)
+#define Ux OP(OT_U,SZ_X)
+#define Udq OP(OT_U,SZ_DQ)
+#define Uq OP(OT_U,SZ_Q)
+#define Ud OP(OT_U,SZ_D)
+#define Lx OP(OT_L,SZ_X)
+#define Pq OP(OT_P,SZ_Q)
+#define Qq OP(OT_Q,SZ_Q)
+#define Qd OP(OT_Q,SZ_D)
+#define Nq OP(OT_N,SZ_Q)
+#define KG OP(OT_KG,SZ_NONE)
+#define KE OP(OT_KE,SZ_NONE)
+#define KH OP(OT_KH,SZ_NONE)
+#define By OP(OT_B,SZ_Y)
+#define XMM0 OP(OT_XMM0,SZ_DQ)
+#define VSIBx OP(OT_VSIB,SZ_X)
+#define VSIBxh OP(OT_VSIB,SZ_XH)
+
+/* Entry flags */
+#define F_MODRM 0x1			/* A ModRM byte follows the opcode */
+#define F_D64 0x2			/* 64-bit operand size by default */
+#define F_GROUP 0x4			/* The next table is indexed by ModRM reg */
+#define F_GROUPMOD 0x8		/* The next table is indexed by ModRM reg for memory, by 8 + ModRM reg for registers */
+#define F_RMGROUP 0x10		/* The next table is indexed by ModRM r/m */
+#define F_PREFIX 0x20		/* The next table is indexed by the mandatory prefix: none, 66, F3, F2 */
+#define F_MODSPLIT 0x40		/* The next table holds the memory form then the register form */
+#define F_WSPLIT 0x80		/* The next table holds the W0 form then the W1 form */
+#define F_VH 0x100			/* VEX adds the vvvv register after the first operand */
+#define F_VH0 0x200			/* VEX adds the vvvv register before the operands */
+#define F_NOVEX 0x400		/* Has no VEX form */
+#define F_VEX 0x800			/* Has only a VEX form, named as is */
+#define F_VEXOK 0x1000		/* Has a VEX form without vector registers */
+#define F_STRING 0x2000		/* F3 reads rep */
+#define F_REPZ 0x4000		/* F3 reads repz and F2 repnz on a string instruction */
+#define F_BRANCH 0x8000		/* F2 reads bnd */
+#define F_INDIRECT 0x10000	/* 3E reads notrack */
+#define F_X87 0x20000		/* x87 escape */
+#define F_CMP 0x40000		/* The immediate is a comparison predicate */
+#define F_CLMUL 0x80000		/* The immediate selects the multiplied quadwords */
+
+#define M F_MODRM
+#define TABLE_FLAGS (F_GROUP|F_GROUPMOD|F_RMGROUP|F_PREFIX|F_MODSPLIT|F_WSPLIT)
+
+
+/* Entry of an opcode table */
+typedef struct x86_opcode{
+    const char * mnemonic;		/* NULL for no instruction, "a|b" picks by W, "a/b/c" by the operand size */
+    u16 operands[4];
+    u32 flags;
+    const struct x86_opcode * table;	/* Next table to index, for the entries with table flags */
+}x86_opcode_t;
+
+#define BAD {NULL,{0},0,NULL}
+#define GROUP(table,flags,...) {NULL,{__VA_ARGS__},(flags)|M|F_GROUP,table}
+#define GROUPMOD(table,flags,...) {NULL,{__VA_ARGS__},(flags)|M|F_GROUPMOD,table}
+#define RMGROUP(table) {NULL,{0},F_RMGROUP,table}
+#define PREFIXED(table,flags) {NULL,{0},(flags)|F_PREFIX,table}
+#define MODSPLIT(table) {NULL,{0},F_MODSPLIT,table}
+#define WSPLIT(table,flags) {NULL,{0},(flags)|F_WSPLIT,table}
+
+/* Legacy MMX form without a prefix and SSE form with 66 */
+#define MMX_SSE(name,mmxOperand) {{name,{Pq,mmxOperand},M|F_NOVEX},{name,{Vx,Wx},M|F_VH},BAD,BAD}
+/* SSE form with 66 */
+#define SSE66(name,flags,...) {BAD,{name,{__VA_ARGS__},M|(flags)},BAD,BAD}
+/* Packed single, packed double, scalar single and scalar double forms */
+#define SSE_ARITH(name) {{name "ps",{Vx,Wx},M|F_VH},{name "pd",{Vx,Wx},M|F_VH},{name "ss",{Vd,Wd},M|F_VH},{name "sd",{Vq,Wq},M|F_VH}}
+
+
+
+/* Groups of the one byte opcodes */
+static const x86_opcode_t group1[8] = {{"add"},{"or"},{"adc"},{"sbb"},{"and"},{"sub"},{"xor"},{"cmp"}};
+static const x86_opcode_t group1a[8] = {{"pop",{Ev64},F_D64}};
+static const x86_opcode_t group2[8] = {{"rol"},{"ror"},{"rcl"},{"rcr"},{"shl"},{"shr"},{"shl"},{"sar"}};
+static const x86_opcode_t group3b[8] = {{"test",{Eb,Ib}},{"test",{Eb,Ib}},{"not",{Eb}},{"neg",{Eb}},{"mul",{Eb}},{"imul",{Eb}},{"div",{Eb}},{"idiv",{Eb}}};
+static const x86_opcode_t group3v[8] = {{"test",{Ev,Iz}},{"test",{Ev,Iz}},{"not",{Ev}},{"neg",{Ev}},{"mul",{Ev}},{"imul",{Ev}},{"div",{Ev}},{"idiv",{Ev}}};
+static const x86_opcode_t group4[8] = {{"inc",{Eb}},{"dec",{Eb}}};
+static const x86_opcode_t group5[8] = {{"inc",{Ev}},{"dec",{Ev}},{"call",{Eq},F_BRANCH|F_INDIRECT},{"call",{Mp}},
+                                       {"jmp",{Eq},F_BRANCH|F_INDIRECT},{"jmp",{Mp}},{"push",{Ev64},F_D64},BAD};
+static const x86_opcode_t group11b[16] = {{"mov",{Eb,Ib}},BAD,BAD,BAD,BAD,BAD,BAD,BAD,{"mov",{Eb,Ib}},BAD,BAD,BAD,BAD,BAD,BAD,{"xabort",{Ib}}};
+static const x86_opcode_t group11v[16] = {{"mov",{Ev,Iz}},BAD,BAD,BAD,BAD,BAD,BAD,BAD,{"mov",{Ev,Iz}},BAD,BAD,BAD,BAD,BAD,BAD,{"xbegin",{Jz}}};
+
+
+
+
+#define ALU(base,name) [base]={name,{Eb,Gb},M},[base+1]={name,{Ev,Gv},M},[base+2]={name,{Gb,Eb},M},\
+                       [base+3]={name,{Gv,Ev},M},[base+4]={name,{AL,Ib}},[base+5]={name,{rAX,Iz}}
+#define EIGHT(base,...) [base]={__VA_ARGS__},[base+1]={__VA_ARGS__},[base+2]={__VA_ARGS__},[base+3]={__VA_ARGS__},\
+                        [base+4]={__VA_ARGS__},[base+5]={__VA_ARGS__},[base+6]={__VA_ARGS__},[base+7]={__VA_ARGS__}
+
+static const x86_opcode_t oneByteMap[256] = {
+    ALU(0x00,"add"), ALU(0x08,"or"), ALU(0x10,"adc"), ALU(0x18,"sbb"),
+    ALU(0x20,"and"), ALU(0x28,"sub"), ALU(0x30,"xor"), ALU(0x38,"cmp"),
+    EIGHT(0x50,"push",{Z64},F_D64),
+    EIGHT(0x58,"pop",{Z64},F_D64),
+    [0x63]={"movsxd",{Gv,Ed},M},
+    [0x68]={"push",{Iz},F_D64}, [0x69]={"imul",{Gv,Ev,Iz},M}, [0x6a]={"push",{Ibs},F_D64}, [0x6b]={"imul",{Gv,Ev,Ibs},M},
+    [0x6c]={"ins",{Yb,DX},F_STRING}, [0x6d]={"ins",{Yz,DX},F_STRING}, [0x6e]={"outs",{DX,Xb},F_STRING}, [0x6f]={"outs",{DX,Xz},F_STRING},
+    [0x70]={"jo",{Jb},F_BRANCH}, [0x71]={"jno",{Jb},F_BRANCH}, [0x72]={"jb",{Jb},F_BRANCH}, [0x73]={"jae",{Jb},F_BRANCH},
+    [0x74]={"je",{Jb},F_BRANCH}, [0x75]={"jne",{Jb},F_BRANCH}, [0x76]={"jbe",{Jb},F_BRANCH}, [0x77]={"ja",{Jb},F_BRANCH},
+    [0x78]={"js",{Jb},F_BRANCH}, [0x79]={"jns",{Jb},F_BRANCH}, [0x7a]={"jp",{Jb},F_BRANCH}, [0x7b]={"jnp",{Jb},F_BRANCH},
+    [0x7c]={"jl",{Jb},F_BRANCH}, [0x7d]={"jge",{Jb},F_BRANCH}, [0x7e]={"jle",{Jb},F_BRANCH}, [0x7f]={"jg",{Jb},F_BRANCH},
+    [0x80]=GROUP(group1,0,Eb,Ib), [0x81]=GROUP(group1,0,Ev,Iz), [0x83]=GROUP(group1,0,Ev,Ibs),
+    [0x84]={"test",{Eb,Gb},M}, [0x85]={"test",{Ev,Gv},M}, [0x86]={"xchg",{Eb,Gb},M}, [0x87]={"xchg",{Ev,Gv},M},
+    [0x88]={"mov",{Eb,Gb},M}, [0x89]={"mov",{Ev,Gv},M}, [0x8a]={"mov",{Gb,Eb},M}, [0x8b]={"mov",{Gv,Ev},M},
+    [0x8c]={"mov",{Evw,Sw},M}, [0x8d]={"lea",{Gv,M0},M}, [0x8e]={"mov",{Sw,Evw},M}, [0x8f]=GROUP(group1a,0),
+    EIGHT(0x90,"xchg",{Zv,rAX}),
+    [0x98]={"cbw/cwde/cdqe"}, [0x99]={"cwd/cdq/cqo"}, [0x9b]={"fwait"}, [0x9c]={"pushfw/pushf/pushf",{0},F_D64}, [0x9d]={"popfw/popf/popf",{0},F_D64},
+    [0x9e]={"sahf"}, [0x9f]={"lahf"},
+    [0xa0]={"movabs",{AL,Ob}}, [0xa1]={"movabs",{rAX,Ov}}, [0xa2]={"movabs",{Ob,AL}}, [0xa3]={"movabs",{Ov,rAX}},
+    [0xa4]={"movs",{Yb,Xb},F_STRING}, [0xa5]={"movs",{Yv,Xv},F_STRING}, [0xa6]={"cmps",{Xb,Yb},F_STRING|F_REPZ}, [0xa7]={"cmps",{Xv,Yv},F_STRING|F_REPZ},
+    [0xa8]={"test",{AL,Ib}}, [0xa9]={"test",{rAX,Iz}},
+    [0xaa]={"stos",{Yb,AL},F_STRING}, [0xab]={"stos",{Yv,rAX},F_STRING}, [0xac]={"lods",{AL,Xb},F_STRING}, [0xad]={"lods",{rAX,Xv},F_STRING},
+    [0xae]={"scas",{AL,Yb},F_STRING|F_REPZ}, [0xaf]={"scas",{rAX,Yv},F_STRING|F_REPZ},
+    EIGHT(0xb0,"mov",{Zb,Ib}),
+    EIGHT(0xb8,"mov/mov/movabs",{Zv,Iv}),
+    [0xc0]=GROUP(group2,0,Eb,Ib), [0xc1]=GROUP(group2,0,Ev,Ib), [0xc2]={"retw/ret/ret",{Iw},F_BRANCH}, [0xc3]={"retw/ret/ret",{0},F_BRANCH},
+    [0xc6]=GROUPMOD(group11b,0), [0xc7]=GROUPMOD(group11v,0),
+    [0xc8]={"enter",{Iw,Ib}}, [0xc9]={"leave",{0},F_D64}, [0xca]={"retfw/retf/retfq",{Iw}}, [0xcb]={"retfw/retf/retfq"},
+    [0xcc]={"int3"}, [0xcd]={"int",{Ib}}, [0xcf]={"iretw/iret/iretq"},
+    [0xd0]=GROUP(group2,0,Eb,I1), [0xd1]=GROUP(group2,0,Ev,I1), [0xd2]=GROUP(group2,0,Eb,CL), [0xd3]=GROUP(group2,0,Ev,CL),
+    [0xd7]={"xlat",{XLAT}},
+    EIGHT(0xd8,NULL,{0},M|F_X87),
+    [0xe0]={"loopne",{Jb}}, [0xe1]={"loope",{Jb}}, [0xe2]={"loop",{Jb}}, [0xe3]={"jrcxz",{Jb}},
+    [0xe4]={"in",{AL,Ib}}, [0xe5]={"in",{eAX,Ib}}, [0xe6]={"out",{Ib,AL}}, [0xe7]={"out",{Ib,eAX}},
+    [0xe8]={"call",{Jz},F_BRANCH}, [0xe9]={"jmp",{Jz},F_BRANCH}, [0xeb]={"jmp",{Jb},F_BRANCH},
+    [0xec]={"in",{AL,DX}}, [0xed]={"in",{eAX,DX}}, [0xee]={"out",{DX,AL}}, [0xef]={"out",{DX,eAX}},
+    [0xf1]={"int1"}, [0xf4]={"hlt"}, [0xf5]={"cmc"}, [0xf6]=GROUP(group3b,0), [0xf7]=GROUP(group3v,0),
+    [0xf8]={"clc"}, [0xf9]={"stc"}, [0xfa]={"cli"}, [0xfb]={"sti"}, [0xfc]={"cld"}, [0xfd]={"std"},
+    [0xfe]=GROUP(group4,0), [0xff]=GROUP(group5,0),
+};
+
+
+
+/* Groups of the two byte opcodes */
+static const x86_opcode_t group6[8] = {{"sldt",{Evw}},{"str",{Evw}},{"lldt",{Ew}},{"ltr",{Ew}},{"verr",{Ew}},{"verw",{Ew}}};
+static const x86_opcode_t group7rm0[8] = {BAD,{"vmcall"},{"vmlaunch"},{"vmresume"},{"vmxoff"}};
+static const x86_opcode_t group7rm1[8] = {{"monitor"},{"mwait"},{"clac"},{"stac"},BAD,BAD,BAD,{"encls"}};
+static const x86_opcode_t group7rm2[8] = {{"xgetbv"},{"xsetbv"},BAD,BAD,{"vmfunc"},{"xend"},{"xtest"},{"enclu"}};
+static const x86_opcode_t group7rm5[8] = {BAD,BAD,BAD,BAD,BAD,BAD,{"rdpkru"},{"wrpkru"}};
+static const x86_opcode_t group7rm7[8] = {{"swapgs"},{"rdtscp"},{"monitorx"},{"mwaitx"},{"clzero"},{"rdpru"}};
+static const x86_opcode_t group7[16] = {{"sgdt",{M0}},{"sidt",{M0}},{"lgdt",{M0}},{"lidt",{M0}},{"smsw",{Evw}},BAD,{"lmsw",{Ew}},{"invlpg",{Mb}},
+                                        RMGROUP(group7rm0),RMGROUP(group7rm1),RMGROUP(group7rm2),BAD,{"smsw",{Evw}},RMGROUP(group7rm5),{"lmsw",{Ew}},RMGROUP(group7rm7)};
+static const x86_opcode_t group8[8] = {BAD,BAD,BAD,BAD,{"bt"},{"bts"},{"btr"},{"btc"}};
+static const x86_opcode_t group9reg7[4] = {{"rdseed",{Rv}},{"rdseed",{Rv}},{"rdpid",{Rq}},BAD};
+static const x86_opcode_t group9[16] = {BAD,{"cmpxchg8b|cmpxchg16b",{Mqo}},BAD,{"xrstors|xrstors64",{M0}},{"xsavec|xsavec64",{M0}},{"xsaves|xsaves64",{M0}},{"vmptrld",{Mq}},{"vmptrst",{Mq}},
+                                        BAD,BAD,BAD,BAD,BAD,BAD,{"rdrand",{Rv}},PREFIXED(group9reg7,0)};
+static const x86_opcode_t group12psrlw[4] = {{"psrlw",{Nq,Ib},F_NOVEX},{"psrlw",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group12psraw[4] = {{"psraw",{Nq,Ib},F_NOVEX},{"psraw",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group12psllw[4] = {{"psllw",{Nq,Ib},F_NOVEX},{"psllw",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group12[16] = {BAD,BAD,BAD,BAD,BAD,BAD,BAD,BAD,
+                                         BAD,BAD,PREFIXED(group12psrlw,0),BAD,PREFIXED(group12psraw,0),BAD,PREFIXED(group12psllw,0),BAD};
+static const x86_opcode_t group13psrld[4] = {{"psrld",{Nq,Ib},F_NOVEX},{"psrld",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group13psrad[4] = {{"psrad",{Nq,Ib},F_NOVEX},{"psrad",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group13pslld[4] = {{"pslld",{Nq,Ib},F_NOVEX},{"pslld",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group13[16] = {BAD,BAD,BAD,BAD,BAD,BAD,BAD,BAD,
+                                         BAD,BAD,PREFIXED(group13psrld,0),BAD,PREFIXED(group13psrad,0),BAD,PREFIXED(group13pslld,0),BAD};
+static const x86_opcode_t group14psrlq[4] = {{"psrlq",{Nq,Ib},F_NOVEX},{"psrlq",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group14psrldq[4] = {BAD,{"psrldq",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group14psllq[4] = {{"psllq",{Nq,Ib},F_NOVEX},{"psllq",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group14pslldq[4] = {BAD,{"pslldq",{Ux,Ib},F_VH0},BAD,BAD};
+static const x86_opcode_t group14[16] = {BAD,BAD,BAD,BAD,BAD,BAD,BAD,BAD,
+                                         BAD,BAD,PREFIXED(group14psrlq,0),PREFIXED(group14psrldq,0),BAD,BAD,PREFIXED(group14psllq,0),PREFIXED(group14pslldq,0)};
+static const x86_opcode_t group15none[16] = {{"fxsave|fxsave64",{M0},F_NOVEX},{"fxrstor|fxrstor64",{M0},F_NOVEX},{"ldmxcsr",{Md},F_VEXOK},{"stmxcsr",{Md},F_VEXOK},
+                                             {"xsave|xsave64",{M0},F_NOVEX},{"xrstor|xrstor64",{M0},F_NOVEX},{"xsaveopt|xsaveopt64",{M0},F_NOVEX},{"clflush",{Mb},F_NOVEX},
+                                             BAD,BAD,BAD,BAD,BAD,{"lfence"},{"mfence"},{"sfence"}};
+static const x86_opcode_t group15data16[16] = {BAD,BAD,BAD,BAD,BAD,BAD,{"clwb",{Mb}},{"clflushopt",{Mb}},
+                                               BAD,BAD,BAD,BAD,BAD,BAD,{"tpause",{Rd}},BAD};
+static const x86_opcode_t group15rep[16] = {BAD,BAD,BAD,BAD,{"ptwrite",{Ey}},BAD,BAD,BAD,
+                                            {"rdfsbase",{Ry}},{"rdgsbase",{Ry}},{"wrfsbase",{Ry}},{"wrgsbase",{Ry}},BAD,{"incsspd|incsspq",{Ry}},{"umonitor",{Rq}},BAD};
+static const x86_opcode_t group15[4] = {GROUPMOD(group15none,0),GROUPMOD(group15data16,0),GROUPMOD(group15rep,0),BAD};
+static const x86_opcode_t group16[16] = {{"prefetchnta",{Mb}},{"prefetcht0",{Mb}},{"prefetcht1",{Mb}},{"prefetcht2",{Mb}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},
+                                         {"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}}};
+static const x86_opcode_t groupPrefetch[8] = {{"prefetch",{Mb}},{"prefetchw",{Mb}},{"prefetchwt1",{Mb}},{"prefetch",{Mb}},{"prefetch",{Mb}},{"prefetch",{Mb}},{"prefetch",{Mb}},{"prefetch",{Mb}}};
+static const x86_opcode_t groupEndbr[8] = {{"nop",{Ev}},{"nop",{Ev}},{"endbr64"},{"endbr32"},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}}};
+static const x86_opcode_t groupRepHintNop[16] = {{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},
+                                                 {"nop",{Ev}},{"rdsspd|rdsspq",{Ry}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},{"nop",{Ev}},RMGROUP(groupEndbr)};
+
+
+/* Mandatory prefix tables of the two byte opcodes */
+static const x86_opcode_t splitMovss[2] = {{"movss",{Vd,Md}},{"movss",{Vd,Ud},F_VH}};
+static const x86_opcode_t splitMovsd[2] = {{"movsd",{Vq,Mq}},{"movsd",{Vq,Uq},F_VH}};
+static const x86_opcode_t splitMovssStore[2] = {{"movss",{Md,Vd}},{"movss",{Ud,Vd},F_VH}};
+static const x86_opcode_t splitMovsdStore[2] = {{"movsd",{Mq,Vq}},{"movsd",{Uq,Vq},F_VH}};
+static const x86_opcode_t splitMovlps[2] = {{"movlps",{Vq,Mq},F_VH},{"movhlps",{Vq,Uq},F_VH}};
+static const x86_opcode_t splitMovhps[2] = {{"movhps",{Vq,Mq},F_VH},{"movlhps",{Vq,Uq},F_VH}};
+static const x86_opcode_t p0f10[4] = {{"movups",{Vx,Wx}},{"movupd",{Vx,Wx}},MODSPLIT(splitMovss),MODSPLIT(splitMovsd)};
+static const x86_opcode_t p0f11[4] = {{"movups",{Wx,Vx}},{"movupd",{Wx,Vx}},MODSPLIT(splitMovssStore),MODSPLIT(splitMovsdStore)};
+static const x86_opcode_t p0f12[4] = {MODSPLIT(splitMovlps),{"movlpd",{Vq,Mq},F_VH},{"movsldup",{Vx,Wx}},{"movddup",{Vx,Wxdup}}};
+static const x86_opcode_t p0f13[4] = {{"movlps",{Mq,Vq}},{"movlpd",{Mq,Vq}},BAD,BAD};
+static const x86_opcode_t p0f14[4] = {{"unpcklps",{Vx,Wx},F_VH},{"unpcklpd",{Vx,Wx},F_VH},BAD,BAD};
+static const x86_opcode_t p0f15[4] = {{"unpckhps",{Vx,Wx},F_VH},{"unpckhpd",{Vx,Wx},F_VH},BAD,BAD};
+static const x86_opcode_t p0f16[4] = {MODSPLIT(splitMovhps),{"movhpd",{Vq,Mq},F_VH},{"movshdup",{Vx,Wx}},BAD};
+static const x86_opcode_t p0f17[4] = {{"movhps",{Mq,Vq}},{"movhpd",{Mq,Vq}},BAD,BAD};
+static const x86_opcode_t p0f1e[4] = {{"nop",{Ev}},{"nop",{Ev}},GROUPMOD(groupRepHintNop,0),{"nop",{Ev}}};
+static const x86_opcode_t p0f28[4] = {{"movaps",{Vx,Wx}},{"movapd",{Vx,Wx}},BAD,BAD};
+static const x86_opcode_t p0f29[4] = {{"movaps",{Wx,Vx}},{"movapd",{Wx,Vx}},BAD,BAD};
+static const x86_opcode_t p0f2a[4] = {{"cvtpi2ps",{Vdq,Qq},F_NOVEX},{"cvtpi2pd",{Vdq,Qq},F_NOVEX},{"cvtsi2ss",{Vd,Ey},F_VH},{"cvtsi2sd",{Vq,Ey},F_VH}};
+static const x86_opcode_t p0f2b[4] = {{"movntps",{Mx,Vx}},{"movntpd",{Mx,Vx}},BAD,BAD};
+static const x86_opcode_t p0f2c[4] = {{"cvttps2pi",{Pq,Wq},F_NOVEX},{"cvttpd2pi",{Pq,Wdq},F_NOVEX},{"cvttss2si",{Gy,Wd}},{"cvttsd2si",{Gy,Wq}}};
+static const x86_opcode_t p0f2d[4] = {{"cvtps2pi",{Pq,Wq},F_NOVEX},{"cvtpd2pi",{Pq,Wdq},F_NOVEX},{"cvtss2si",{Gy,Wd}},{"cvtsd2si",{Gy,Wq}}};
+static const x86_opcode_t p0f2e[4] = {{"ucomiss",{Vd,Wd}},{"ucomisd",{Vq,Wq}},BAD,BAD};
+static const x86_opcode_t p0f2f[4] = {{"comiss",{Vd,Wd}},{"comisd",{Vq,Wq}},BAD,BAD};
+static const x86_opcode_t p0f50[4] = {{"movmskps",{Gd,Ux}},{"movmskpd",{Gd,Ux}},BAD,BAD};
+static const x86_opcode_t p0f51[4] = {{"sqrtps",{Vx,Wx}},{"sqrtpd",{Vx,Wx}},{"sqrtss",{Vd,Wd},F_VH},{"sqrtsd",{Vq,Wq},F_VH}};
+static const x86_opcode_t p0f52[4] = {{"rsqrtps",{Vx,Wx}},BAD,{"rsqrtss",{Vd,Wd},F_VH},BAD};
+static const x86_opcode_t p0f53[4] = {{"rcpps",{Vx,Wx}},BAD,{"rcpss",{Vd,Wd},F_VH},BAD};
+static const x86_opcode_t p0f54[4] = {{"andps",{Vx,Wx},F_VH},{"andpd",{Vx,Wx},F_VH},BAD,BAD};
+static const x86_opcode_t p0f55[4] = {{"andnps",{Vx,Wx},F_VH},{"andnpd",{Vx,Wx},F_VH},BAD,BAD};
+static const x86_opcode_t p0f56[4] = {{"orps",{Vx,Wx},F_VH},{"orpd",{Vx,Wx},F_VH},BAD,BAD};
+static const x86_opcode_t p0f57[4] = {{"xorps",{Vx,Wx},F_VH},{"xorpd",{Vx,Wx},F_VH},BAD,BAD};
+static const x86_opcode_t p0f58[4] = SSE_ARITH("add");
+static const x86_opcode_t p0f59[4] = SSE_ARITH("mul");
+static const x86_opcode_t p0f5a[4] = {{"cvtps2pd",{Vx,Wxh}},{"cvtpd2ps",{Vxh,Wx}},{"cvtss2sd",{Vq,Wd},F_VH},{"cvtsd2ss",{Vd,Wq},F_VH}};
+static const x86_opcode_t p0f5b[4] = {{"cvtdq2ps",{Vx,Wx}},{"cvtps2dq",{Vx,Wx}},{"cvttps2dq",{Vx,Wx}},BAD};
+static const x86_opcode_t p0f5c[4] = SSE_ARITH("sub");
+static const x86_opcode_t p0f5d[4] = SSE_ARITH("min");
+static const x86_opcode_t p0f5e[4] = SSE_ARITH("div");
+static const x86_opcode_t p0f5f[4] = SSE_ARITH("max");
+static const x86_opcode_t p0f60[4] = MMX_SSE("punpcklbw",Qd);
+static const x86_opcode_t p0f61[4] = MMX_SSE("punpcklwd",Qd);
+static const x86_opcode_t p0f62[4] = MMX_SSE("punpckldq",Qd);
+static const x86_opcode_t p0f63[4] = MMX_SSE("packsswb",Qq);
+static const x86_opcode_t p0f64[4] = MMX_SSE("pcmpgtb",Qq);
+static const x86_opcode_t p0f65[4] = MMX_SSE("pcmpgtw",Qq);
+static const x86_opcode_t p0f66[4] = MMX_SSE("pcmpgtd",Qq);
+static const x86_opcode_t p0f67[4] = MMX_SSE("packuswb",Qq);
+static const x86_opcode_t p0f68[4] = MMX_SSE("punpckhbw",Qq);
+static const x86_opcode_t p0f69[4] = MMX_SSE("punpckhwd",Qq);
+static const x86_opcode_t p0f6a[4] = MMX_SSE("punpckhdq",Qq);
+static const x86_opcode_t p0f6b[4] = MMX_SSE("packssdw",Qq);
+static const x86_opcode_t p0f6c[4] = SSE66("punpcklqdq",F_VH,Vx,Wx);
+static const x86_opcode_t p0f6d[4] = SSE66("punpckhqdq",F_VH,Vx,Wx);
+static const x86_opcode_t p0f6e[4] = {{"movd|movq",{Pq,Ey},F_NOVEX},{"movd|movq",{Vdq,Ey}},BAD,BAD};
+static const x86_opcode_t p0f6f[4] = {{"movq",{Pq,Qq},F_NOVEX},{"movdqa",{Vx,Wx}},{"movdqu",{Vx,Wx}},BAD};
+static const x86_opcode_t p0f70[4] = {{"pshufw",{Pq,Qq,Ib},F_NOVEX},{"pshufd",{Vx,Wx,Ib}},{"pshufhw",{Vx,Wx,Ib}},{"pshuflw",{Vx,Wx,Ib}}};
+static const x86_opcode_t p0f74[4] = MMX_SSE("pcmpeqb",Qq);
+static const x86_opcode_t p0f75[4] = MMX_SSE("pcmpeqw",Qq);
+static const x86_opcode_t p0f76[4] = MMX_SSE("pcmpeqd",Qq);
+static const x86_opcode_t p0f78[4] = {{"vmread",{Eq,Gq},F_D64|F_NOVEX},BAD,BAD,BAD};
+static const x86_opcode_t p0f79[4] = {{"vmwrite",{Gq,Eq},F_D64|F_NOVEX},BAD,BAD,BAD};
+static const x86_opcode_t p0f7c[4] = {BAD,{"haddpd",{Vx,Wx},F_VH},BAD,{"haddps",{Vx,Wx},F_VH}};
+static const x86_opcode_t p0f7d[4] = {BAD,{"hsubpd",{Vx,Wx},F_VH},BAD,{"hsubps",{Vx,Wx},F_VH}};
+static const x86_opcode_t p0f7e[4] = {{"movd|movq",{Ey,Pq},F_NOVEX},{"movd|movq",{Ey,Vdq}},{"movq",{Vq,Wq}},BAD};
+static const x86_opcode_t p0f7f[4] = {{"movq",{Qq,Pq},F_NOVEX},{"movdqa",{Wx,Vx}},{"movdqu",{Wx,Vx}},BAD};
+static const x86_opcode_t p0fb8[4] = {BAD,BAD,{"popcnt",{Gv,Ev}},BAD};
+static const x86_opcode_t p0fbc[4] = {{"bsf",{Gv,Ev}},BAD,{"tzcnt",{Gv,Ev}},BAD};
+static const x86_opcode_t p0fbd[4] = {{"bsr",{Gv,Ev}},BAD,{"lzcnt",{Gv,Ev}},BAD};
+static const x86_opcode_t p0fc2[4] = {{"cmpps",{Vx,Wx,Ib},F_VH|F_CMP},{"cmppd",{Vx,Wx,Ib},F_VH|F_CMP},{"cmpss",{Vd,Wd,Ib},F_VH|F_CMP},{"cmpsd",{Vq,Wq,Ib},F_VH|F_CMP}};
+static const x86_opcode_t p0fc3[4] = {{"movnti",{My,Gy}},BAD,BAD,BAD};
+static const x86_opcode_t p0fc4[4] = {{"pinsrw",{Pq,Edw,Ib},F_NOVEX},{"pinsrw",{Vdq,Edw,Ib},F_VH},BAD,BAD};
+static const x86_opcode_t p0fc5[4] = {{"pextrw",{Gd,Nq,Ib},F_NOVEX},{"pextrw",{Gd,Udq,Ib}},BAD,BAD};
+static const x86_opcode_t p0fc6[4] = {{"shufps",{Vx,Wx,Ib},F_VH},{"shufpd",{Vx,Wx,Ib},F_VH},BAD,BAD};
+static const x86_opcode_t p0fd0[4] = {BAD,{"addsubpd",{Vx,Wx},F_VH},BAD,{"addsubps",{Vx,Wx},F_VH}};
+static const x86_opcode_t p0fd1[4] = {{"psrlw",{Pq,Qq},F_NOVEX},{"psrlw",{Vx,Wdq},F_VH},BAD,BAD};
+static const x86_opcode_t p0fd2[4] = {{"psrld",{Pq,Qq},F_NOVEX},{"psrld",{Vx,Wdq},F_VH},BAD,BAD};
+static const x86_opcode_t p0fd3[4] = {{"psrlq",{Pq,Qq},F_NOVEX},{"psrlq",{Vx,Wdq},F_VH},BAD,BAD};
+static const x86_opcode_t p0fd4[4] = MMX_SSE("paddq",Qq);
+static const x86_opcode_t p0fd5[4] = MMX_SSE("pmullw",Qq);
+static const x86_opcode_t p0fd6[4] = {BAD,{"movq",{Wq,Vq}},{"movq2dq",{Vdq,Nq},F_NOVEX},{"movdq2q",{Pq,Uq},F_NOVEX}};
+static const x86_opcode_t p0fd7[4] = {{"pmovmskb",{Gd,Nq},F_NOVEX},{"pmovmskb",{Gd,Ux}},BAD,BAD};
+static const x86_opcode_t p0fd8[4] = MMX_SSE("psubusb",Qq);
+static const x86_opcode_t p0fd9[4] = MMX_SSE("psubusw",Qq);
+static const x86_opcode_t p0fda[4] = MMX_SSE("pminub",Qq);
+static const x86_opcode_t p0fdb[4] = MMX_SSE("pand",Qq);
+static const x86_opcode_t p0fdc[4] = MMX_SSE("paddusb",Qq);
+static const x86_opcode_t p0fdd[4] = MMX_SSE("paddusw",Qq);
+static const x86_opcode_t p0fde[4] = MMX_SSE("pmaxub",Qq);
+static const x86_opcode_t p0fdf[4] = MMX_SSE("pandn",Qq);
+static const x86_opcode_t p0fe0[4] = MMX_SSE("pavgb",Qq);
+static const x86_opcode_t p0fe1[4] = {{"psraw",{Pq,Qq},F_NOVEX},{"psraw",{Vx,Wdq},F_VH},BAD,BAD};
+static const x86_opcode_t p0fe2[4] = {{"psrad",{Pq,Qq},F_NOVEX},{"psrad",{Vx,Wdq},F_VH},BAD,BAD};
+static const x86_opcode_t p0fe3[4] = MMX_SSE("pavgw",Qq);
+static const x86_opcode_t p0fe4[4] = MMX_SSE("pmulhuw",Qq);
+static const x86_opcode_t p0fe5[4] = MMX_SSE("pmulhw",Qq);
+static const x86_opcode_t p0fe6[4] = {BAD,{"cvttpd2dq",{Vxh,Wx}},{"cvtdq2pd",{Vx,Wxh}},{"cvtpd2dq",{Vxh,Wx}}};
+static const x86_opcode_t p0fe7[4] = {{"movntq",{Mq,Pq},F_NOVEX},{"movntdq",{Mx,Vx}},BAD,BAD};
+static const x86_opcode_t p0fe8[4] = MMX_SSE("psubsb",Qq);
+static const x86_opcode_t p0fe9[4] = MMX_SSE("psubsw",Qq);
+static const x86_opcode_t p0fea[4] = MMX_SSE("pminsw",Qq);
+static const x86_opcode_t p0feb[4] = MMX_SSE("por",Qq);
+static const x86_opcode_t p0fec[4] = MMX_SSE("paddsb",Qq);
+static const x86_opcode_t p0fed[4] = MMX_SSE("paddsw",Qq);
+static const x86_opcode_t p0fee[4] = MMX_SSE("pmaxsw",Qq);
+static const x86_opcode_t p0fef[4] = MMX_SSE("pxor",Qq);
+static const x86_opcode_t p0ff0[4] = {BAD,BAD,BAD,{"lddqu",{Vx,Mx}}};
+static const x86_opcode_t p0ff1[4] = {{"psllw",{Pq,Qq},F_NOVEX},{"psllw",{Vx,Wdq},F_VH},BAD,BAD};
+static const x86_opcode_t p0ff2[4] = {{"pslld",{Pq,Qq},F_NOVEX},{"pslld",{Vx,Wdq},F_VH},BAD,BAD};
+static const x86_opcode_t p0ff3[4] = {{"psllq",{Pq,Qq},F_NOVEX},{"psllq",{Vx,Wdq},F_VH},BAD,BAD};
+static const x86_opcode_t p0ff4[4] = MMX_SSE("pmuludq",Qq);
+static const x86_opcode_t p0ff5[4] = MMX_SSE("pmaddwd",Qq);
+static const x86_opcode_t p0ff6[4] = MMX_SSE("psadbw",Qq);
+static const x86_opcode_t p0ff7[4] = {{"maskmovq",{Pq,Nq},F_NOVEX},{"maskmovdqu",{Vdq,Udq}},BAD,BAD};
+static const x86_opcode_t p0ff8[4] = MMX_SSE("psubb",Qq);
+static const x86_opcode_t p0ff9[4] = MMX_SSE("psubw",Qq);
+static const x86_opcode_t p0ffa[4] = MMX_SSE("psubd",Qq);
+static const x86_opcode_t p0ffb[4] = MMX_SSE("psubq",Qq);
+static const x86_opcode_t p0ffc[4] = MMX_SSE("paddb",Qq);
+static const x86_opcode_t p0ffd[4] = MMX_SSE("paddw",Qq);
+static const x86_opcode_t p0ffe[4] = MMX_SSE("paddd",Qq);
+
+
+#define P(table) PREFIXED(table,M)
+#define CONDITIONS(base,prefix,flags,...) \
+    [base+0x0]={prefix "o",{__VA_ARGS__},flags},[base+0x1]={prefix "no",{__VA_ARGS__},flags},[base+0x2]={prefix "b",{__VA_ARGS__},flags},[base+0x3]={prefix "ae",{__VA_ARGS__},flags},\
+    [base+0x4]={prefix "e",{__VA_ARGS__},flags},[base+0x5]={prefix "ne",{__VA_ARGS__},flags},[base+0x6]={prefix "be",{__VA_ARGS__},flags},[base+0x7]={prefix "a",{__VA_ARGS__},flags},\
+    [base+0x8]={prefix "s",{__VA_ARGS__},flags},[base+0x9]={prefix "ns",{__VA_ARGS__},flags},[base+0xa]={prefix "p",{__VA_ARGS__},flags},[base+0xb]={prefix "np",{__VA_ARGS__},flags},\
+    [base+0xc]={prefix "l",{__VA_ARGS__},flags},[base+0xd]={prefix "ge",{__VA_ARGS__},flags},[base+0xe]={prefix "le",{__VA_ARGS__},flags},[base+0xf]={prefix "g",{__VA_ARGS__},flags}
+
+static const x86_opcode_t twoByteMap[256] = {
+    [0x00]=GROUP(group6,0), [0x01]=GROUPMOD(group7,0), [0x02]={"lar",{Gv,Ew},M}, [0x03]={"lsl",{Gv,Ew},M},
+    [0x05]={"syscall"}, [0x06]={"clts"}, [0x07]={"sysret"}, [0x08]={"invd"}, [0x09]={"wbinvd"}, [0x0b]={"ud2"},
+    [0x0d]=GROUP(groupPrefetch,0),
+    [0x10]=P(p0f10), [0x11]=P(p0f11), [0x12]=P(p0f12), [0x13]=P(p0f13), [0x14]=P(p0f14), [0x15]=P(p0f15), [0x16]=P(p0f16), [0x17]=P(p0f17),
+    [0x18]=GROUPMOD(group16,0), [0x19]={"nop",{Ev},M}, [0x1a]={"nop",{Ev},M}, [0x1b]={"nop",{Ev},M},
+    [0x1c]={"nop",{Ev},M}, [0x1d]={"nop",{Ev},M}, [0x1e]=P(p0f1e), [0x1f]={"nop",{Ev},M},
+    [0x20]={"mov",{Rq,Cq},M}, [0x21]={"mov",{Rq,Dq},M}, [0x22]={"mov",{Cq,Rq},M}, [0x23]={"mov",{Dq,Rq},M},
+    [0x28]=P(p0f28), [0x29]=P(p0f29), [0x2a]=P(p0f2a), [0x2b]=P(p0f2b), [0x2c]=P(p0f2c), [0x2d]=P(p0f2d), [0x2e]=P(p0f2e), [0x2f]=P(p0f2f),
+    [0x30]={"wrmsr"}, [0x31]={"rdtsc"}, [0x32]={"rdmsr"}, [0x33]={"rdpmc"}, [0x34]={"sysenter"}, [0x35]={"sysexit"}, [0x37]={"getsec"},
+    CONDITIONS(0x40,"cmov",M,Gv,Ev),
+    [0x50]=P(p0f50), [0x51]=P(p0f51), [0x52]=P(p0f52), [0x53]=P(p0f53), [0x54]=P(p0f54), [0x55]=P(p0f55), [0x56]=P(p0f56), [0x57]=P(p0f57),
+    [0x58]=P(p0f58), [0x59]=P(p0f59), [0x5a]=P(p0f5a), [0x5b]=P(p0f5b), [0x5c]=P(p0f5c), [0x5d]=P(p0f5d), [0x5e]=P(p0f5e), [0x5f]=P(p0f5f),
+    [0x60]=P(p0f60), [0x61]=P(p0f61), [0x62]=P(p0f62), [0x63]=P(p0f63), [0x64]=P(p0f64), [0x65]=P(p0f65), [0x66]=P(p0f66), [0x67]=P(p0f67),
+    [0x68]=P(p0f68), [0x69]=P(p0f69), [0x6a]=P(p0f6a), [0x6b]=P(p0f6b), [0x6c]=P(p0f6c), [0x6d]=P(p0f6d), [0x6e]=P(p0f6e), [0x6f]=P(p0f6f),
+    [0x70]=P(p0f70), [0x71]=GROUPMOD(group12,0), [0x72]=GROUPMOD(group13,0), [0x73]=GROUPMOD(group14,0),
+    [0x74]=P(p0f74), [0x75]=P(p0f75), [0x76]=P(p0f76), [0x77]={"emms"},
+    [0x78]=P(p0f78), [0x79]=P(p0f79), [0x7c]=P(p0f7c), [0x7d]=P(p0f7d), [0x7e]=P(p0f7e), [0x7f]=P(p0f7f),
+    CONDITIONS(0x80,"j",F_BRANCH|F_D64,Jz),
+    CONDITIONS(0x90,"set",M,Eb),
+    [0xa0]={"push",{FS},F_D64}, [0xa1]={"pop",{FS},F_D64}, [0xa2]={"cpuid"}, [0xa3]={"bt",{Ev,Gv},M},
+    [0xa4]={"shld",{Ev,Gv,Ib},M}, [0xa5]={"shld",{Ev,Gv,CL},M},
+    [0xa8]={"push",{GS},F_D64}, [0xa9]={"pop",{GS},F_D64}, [0xaa]={"rsm"}, [0xab]={"bts",{Ev,Gv},M},
+    [0xac]={"shrd",{Ev,Gv,Ib},M}, [0xad]={"shrd",{Ev,Gv,CL},M}, [0xae]=P(group15), [0xaf]={"imul",{Gv,Ev},M},
+    [0xb0]={"cmpxchg",{Eb,Gb},M}, [0xb1]={"cmpxchg",{Ev,Gv},M}, [0xb2]={"lss",{Gv,Mp},M}, [0xb3]={"btr",{Ev,Gv},M},
+    [0xb4]={"lfs",{Gv,Mp},M}, [0xb5]={"lgs",{Gv,Mp},M}, [0xb6]={"movzx",{Gv,Eb},M}, [0xb7]={"movzx",{Gv,Ew},M},
+    [0xb8]=P(p0fb8), [0xb9]={"ud1",{Gv,Ev},M}, [0xba]=GROUP(group8,0,Ev,Ib), [0xbb]={"btc",{Ev,Gv},M},
+    [0xbc]=P(p0fbc), [0xbd]=P(p0fbd), [0xbe]={"movsx",{Gv,Eb},M}, [0xbf]={"movsx",{Gv,Ew},M},
+    [0xc0]={"xadd",{Eb,Gb},M}, [0xc1]={"xadd",{Ev,Gv},M}, [0xc2]=P(p0fc2), [0xc3]=P(p0fc3),
+    [0xc4]=P(p0fc4), [0xc5]=P(p0fc5), [0xc6]=P(p0fc6), [0xc7]=GROUPMOD(group9,0),
+    EIGHT(0xc8,"bswap",{Zy}),
+    [0xd0]=P(p0fd0), [0xd1]=P(p0fd1), [0xd2]=P(p0fd2), [0xd3]=P(p0fd3), [0xd4]=P(p0fd4), [0xd5]=P(p0fd5), [0xd6]=P(p0fd6), [0xd7]=P(p0fd7),
+    [0xd8]=P(p0fd8), [0xd9]=P(p0fd9), [0xda]=P(p0fda), [0xdb]=P(p0fdb), [0xdc]=P(p0fdc), [0xdd]=P(p0fdd), [0xde]=P(p0fde), [0xdf]=P(p0fdf),
+    [0xe0]=P(p0fe0), [0xe1]=P(p0fe1), [0xe2]=P(p0fe2), [0xe3]=P(p0fe3), [0xe4]=P(p0fe4), [0xe5]=P(p0fe5), [0xe6]=P(p0fe6), [0xe7]=P(p0fe7),
+    [0xe8]=P(p0fe8), [0xe9]=P(p0fe9), [0xea]=P(p0fea), [0xeb]=P(p0feb), [0xec]=P(p0fec), [0xed]=P(p0fed), [0xee]=P(p0fee), [0xef]=P(p0fef),
+    [0xf0]=P(p0ff0), [0xf1]=P(p0ff1), [0xf2]=P(p0ff2), [0xf3]=P(p0ff3), [0xf4]=P(p0ff4), [0xf5]=P(p0ff5), [0xf6]=P(p0ff6), [0xf7]=P(p0ff7),
+    [0xf8]=P(p0ff8), [0xf9]=P(p0ff9), [0xfa]=P(p0ffa), [0xfb]=P(p0ffb), [0xfc]=P(p0ffc), [0xfd]=P(p0ffd), [0xfe]=P(p0ffe), [0xff]={"ud0",{Gv,Ev},M},
+};
+
+
+
+/* Three byte opcodes, indexed by the mandatory prefix (none, 66, F3, F2) then by the opcode */
+#define MMX_SSSE3(opcode,name) [0][opcode]={name,{Pq,Qq},M|F_NOVEX},[1][opcode]={name,{Vx,Wx},M|F_VH}
+#define MMX_SSSE3_UNARY(opcode,name) [0][opcode]={name,{Pq,Qq},M|F_NOVEX},[1][opcode]={name,{Vx,Wx},M}
+#define FMA(base,order) \
+    [1][base]={"vfmaddsub" order "ps|vfmaddsub" order "pd",{Vx,Wx},M|F_VEX|F_VH},\
+    [1][base+1]={"vfmsubadd" order "ps|vfmsubadd" order "pd",{Vx,Wx},M|F_VEX|F_VH},\
+    [1][base+2]={"vfmadd" order "ps|vfmadd" order "pd",{Vx,Wx},M|F_VEX|F_VH},\
+    [1][base+3]={"vfmadd" order "ss|vfmadd" order "sd",{Ve,We},M|F_VEX|F_VH},\
+    [1][base+4]={"vfmsub" order "ps|vfmsub" order "pd",{Vx,Wx},M|F_VEX|F_VH},\
+    [1][base+5]={"vfmsub" order "ss|vfmsub" order "sd",{Ve,We},M|F_VEX|F_VH},\
+    [1][base+6]={"vfnmadd" order "ps|vfnmadd" order "pd",{Vx,Wx},M|F_VEX|F_VH},\
+    [1][base+7]={"vfnmadd" order "ss|vfnmadd" order "sd",{Ve,We},M|F_VEX|F_VH},\
+    [1][base+8]={"vfnmsub" order "ps|vfnmsub" order "pd",{Vx,Wx},M|F_VEX|F_VH},\
+    [1][base+9]={"vfnmsub" order "ss|vfnmsub" order "sd",{Ve,We},M|F_VEX|F_VH}
+
+static const x86_opcode_t group17[8] = {BAD,{"blsr",{By,Ey},F_VEX},{"blsmsk",{By,Ey},F_VEX},{"blsi",{By,Ey},F_VEX}};
+static const x86_opcode_t gatherDword[2] = {{"vpgatherdd",{Vx,VSIBx,Hx},F_VEX},{"vpgatherdq",{Vx,VSIBxh,Hx},F_VEX}};
+static const x86_opcode_t gatherQword[2] = {{"vpgatherqd",{Vxh,VSIBx,Hxh},F_VEX},{"vpgatherqq",{Vx,VSIBx,Hx},F_VEX}};
+static const x86_opcode_t gatherDwordFloat[2] = {{"vgatherdps",{Vx,VSIBx,Hx},F_VEX},{"vgatherdpd",{Vx,VSIBxh,Hx},F_VEX}};
+static const x86_opcode_t gatherQwordFloat[2] = {{"vgatherqps",{Vxh,VSIBx,Hxh},F_VEX},{"vgatherqpd",{Vx,VSIBx,Hx},F_VEX}};
+
+static const x86_opcode_t map0f38[4][256] = {
+    MMX_SSSE3(0x00,"pshufb"), MMX_SSSE3(0x01,"phaddw"), MMX_SSSE3(0x02,"phaddd"), MMX_SSSE3(0x03,"phaddsw"),
+    MMX_SSSE3(0x04,"pmaddubsw"), MMX_SSSE3(0x05,"phsubw"), MMX_SSSE3(0x06,"phsubd"), MMX_SSSE3(0x07,"phsubsw"),
+    MMX_SSSE3(0x08,"psignb"), MMX_SSSE3(0x09,"psignw"), MMX_SSSE3(0x0a,"psignd"), MMX_SSSE3(0x0b,"pmulhrsw"),
+    [1][0x0c]={"vpermilps",{Vx,Wx},M|F_VEX|F_VH}, [1][0x0d]={"vpermilpd",{Vx,Wx},M|F_VEX|F_VH},
+    [1][0x0e]={"vtestps",{Vx,Wx},M|F_VEX}, [1][0x0f]={"vtestpd",{Vx,Wx},M|F_VEX},
+    [1][0x10]={"pblendvb",{Vdq,Wdq,XMM0},M|F_NOVEX}, [1][0x13]={"vcvtph2ps",{Vx,Wxh},M|F_VEX},
+    [1][0x14]={"blendvps",{Vdq,Wdq,XMM0},M|F_NOVEX}, [1][0x15]={"blendvpd",{Vdq,Wdq,XMM0},M|F_NOVEX},
+    [1][0x16]={"vpermps",{Vx,Wx},M|F_VEX|F_VH}, [1][0x17]={"ptest",{Vx,Wx},M},
+    [1][0x18]={"vbroadcastss",{Vx,Wd},M|F_VEX}, [1][0x19]={"vbroadcastsd",{Vx,Wq},M|F_VEX}, [1][0x1a]={"vbroadcastf128",{Vx,Mdq},M|F_VEX},
+    MMX_SSSE3_UNARY(0x1c,"pabsb"), MMX_SSSE3_UNARY(0x1d,"pabsw"), MMX_SSSE3_UNARY(0x1e,"pabsd"),
+    [1][0x20]={"pmovsxbw",{Vx,Wxh},M}, [1][0x21]={"pmovsxbd",{Vx,Wxq},M}, [1][0x22]={"pmovsxbq",{Vx,Wxo},M},
+    [1][0x23]={"pmovsxwd",{Vx,Wxh},M}, [1][0x24]={"pmovsxwq",{Vx,Wxq},M}, [1][0x25]={"pmovsxdq",{Vx,Wxh},M},
+    [1][0x28]={"pmuldq",{Vx,Wx},M|F_VH}, [1][0x29]={"pcmpeqq",{Vx,Wx},M|F_VH}, [1][0x2a]={"movntdqa",{Vx,Mx},M}, [1][0x2b]={"packusdw",{Vx,Wx},M|F_VH},
+    [1][0x2c]={"vmaskmovps",{Vx,Mx},M|F_VEX|F_VH}, [1][0x2d]={"vmaskmovpd",{Vx,Mx},M|F_VEX|F_VH},
+    [1][0x2e]={"vmaskmovps",{Mx,Vx},M|F_VEX|F_VH}, [1][0x2f]={"vmaskmovpd",{Mx,Vx},M|F_VEX|F_VH},
+    [1][0x30]={"pmovzxbw",{Vx,Wxh},M}, [1][0x31]={"pmovzxbd",{Vx,Wxq},M}, [1][0x32]={"pmovzxbq",{Vx,Wxo},M},
+    [1][0x33]={"pmovzxwd",{Vx,Wxh},M}, [1][0x34]={"pmovzxwq",{Vx,Wxq},M}, [1][0x35]={"pmovzxdq",{Vx,Wxh},M},
+    [1][0x36]={"vpermd",{Vx,Wx},M|F_VEX|F_VH}, [1][0x37]={"pcmpgtq",{Vx,Wx},M|F_VH},
+    [1][0x38]={"pminsb",{Vx,Wx},M|F_VH}, [1][0x39]={"pminsd",{Vx,Wx},M|F_VH}, [1][0x3a]={"pminuw",{Vx,Wx},M|F_VH}, [1][0x3b]={"pminud",{Vx,Wx},M|F_VH},
+    [1][0x3c]={"pmaxsb",{Vx,Wx},M|F_VH}, [1][0x3d]={"pmaxsd",{Vx,Wx},M|F_VH}, [1][0x3e]={"pmaxuw",{Vx,Wx},M|F_VH}, [1][0x3f]={"pmaxud",{Vx,Wx},M|F_VH},
+    [1][0x40]={"pmulld",{Vx,Wx},M|F_VH}, [1][0x41]={"phminposuw",{Vdq,Wdq},M},
+    [1][0x45]={"vpsrlvd|vpsrlvq",{Vx,Wx},M|F_VEX|F_VH}, [1][0x46]={"vpsravd",{Vx,Wx},M|F_VEX|F_VH}, [1][0x47]={"vpsllvd|vpsllvq",{Vx,Wx},M|F_VEX|F_VH},
+    [1][0x58]={"vpbroadcastd",{Vx,Wd},M|F_VEX}, [1][0x59]={"vpbroadcastq",{Vx,Wq},M|F_VEX}, [1][0x5a]={"vbroadcasti128",{Vx,Mdq},M|F_VEX},
+    [1][0x78]={"vpbroadcastb",{Vx,Wb},M|F_VEX}, [1][0x79]={"vpbroadcastw",{Vx,Ww},M|F_VEX},
+    [1][0x8c]={"vpmaskmovd|vpmaskmovq",{Vx,Mx},M|F_VEX|F_VH}, [1][0x8e]={"vpmaskmovd|vpmaskmovq",{Mx,Vx},M|F_VEX|F_VH},
+    [1][0x90]=WSPLIT(gatherDword,M), [1][0x91]=WSPLIT(gatherQword,M), [1][0x92]=WSPLIT(gatherDwordFloat,M), [1][0x93]=WSPLIT(gatherQwordFloat,M),
+    FMA(0x96,"132"), FMA(0xa6,"213"), FMA(0xb6,"231"),
+    [0][0xc8]={"sha1nexte",{Vdq,Wdq},M|F_NOVEX}, [0][0xc9]={"sha1msg1",{Vdq,Wdq},M|F_NOVEX}, [0][0xca]={"sha1msg2",{Vdq,Wdq},M|F_NOVEX},
+    [0][0xcb]={"sha256rnds2",{Vdq,Wdq,XMM0},M|F_NOVEX}, [0][0xcc]={"sha256msg1",{Vdq,Wdq},M|F_NOVEX}, [0][0xcd]={"sha256msg2",{Vdq,Wdq},M|F_NOVEX},
+    [1][0xcf]={"gf2p8mulb",{Vx,Wx},M|F_VH},
+    [1][0xdb]={"aesimc",{Vdq,Wdq},M}, [1][0xdc]={"aesenc",{Vx,Wx},M|F_VH}, [1][0xdd]={"aesenclast",{Vx,Wx},M|F_VH},
+    [1][0xde]={"aesdec",{Vx,Wx},M|F_VH}, [1][0xdf]={"aesdeclast",{Vx,Wx},M|F_VH},
+    [0][0xf0]={"movbe",{Gv,Mv},M}, [0][0xf1]={"movbe",{Mv,Gv},M}, [0][0xf2]={"andn",{Gy,By,Ey},M|F_VEX},
+    [0][0xf3]=GROUP(group17,F_VEX), [0][0xf5]={"bzhi",{Gy,Ey,By},M|F_VEX}, [0][0xf7]={"bextr",{Gy,Ey,By},M|F_VEX},
+    [1][0xf6]={"adcx",{Gy,Ey},M|F_NOVEX}, [1][0xf7]={"shlx",{Gy,Ey,By},M|F_VEX},
+    [2][0xf5]={"pext",{Gy,By,Ey},M|F_VEX}, [2][0xf6]={"adox",{Gy,Ey},M|F_NOVEX}, [2][0xf7]={"sarx",{Gy,Ey,By},M|F_VEX},
+    [3][0xf0]={"crc32",{Gy,Eb},M|F_NOVEX}, [3][0xf1]={"crc32",{Gy,Ev},M|F_NOVEX},
+    [3][0xf5]={"pdep",{Gy,By,Ey},M|F_VEX}, [3][0xf6]={"mulx",{Gy,By,Ey},M|F_VEX}, [3][0xf7]={"shrx",{Gy,Ey,By},M|F_VEX},
+};
+
+static const x86_opcode_t map0f3a[4][256] = {
+    [1][0x00]={"vpermq",{Vx,Wx,Ib},M|F_VEX}, [1][0x01]={"vpermpd",{Vx,Wx,Ib},M|F_VEX}, [1][0x02]={"vpblendd",{Vx,Wx,Ib},M|F_VEX|F_VH},
+    [1][0x04]={"vpermilps",{Vx,Wx,Ib},M|F_VEX}, [1][0x05]={"vpermilpd",{Vx,Wx,Ib},M|F_VEX}, [1][0x06]={"vperm2f128",{Vx,Wx,Ib},M|F_VEX|F_VH},
+    [1][0x08]={"roundps",{Vx,Wx,Ib},M}, [1][0x09]={"roundpd",{Vx,Wx,Ib},M},
+    [1][0x0a]={"roundss",{Vd,Wd,Ib},M|F_VH}, [1][0x0b]={"roundsd",{Vq,Wq,Ib},M|F_VH},
+    [1][0x0c]={"blendps",{Vx,Wx,Ib},M|F_VH}, [1][0x0d]={"blendpd",{Vx,Wx,Ib},M|F_VH}, [1][0x0e]={"pblendw",{Vx,Wx,Ib},M|F_VH},
+    [0][0x0f]={"palignr",{Pq,Qq,Ib},M|F_NOVEX}, [1][0x0f]={"palignr",{Vx,Wx,Ib},M|F_VH},
+    [1][0x14]={"pextrb",{Edb,Vdq,Ib},M}, [1][0x15]={"pextrw",{Edw,Vdq,Ib},M}, [1][0x16]={"pextrd|pextrq",{Ey,Vdq,Ib},M}, [1][0x17]={"extractps",{Ed,Vdq,Ib},M},
+    [1][0x18]={"vinsertf128",{Vx,Wdq,Ib},M|F_VEX|F_VH}, [1][0x19]={"vextractf128",{Wdq,Vx,Ib},M|F_VEX}, [1][0x1d]={"vcvtps2ph",{Wxh,Vx,Ib},M|F_VEX},
+    [1][0x20]={"pinsrb",{Vdq,Edb,Ib},M|F_VH}, [1][0x21]={"insertps",{Vdq,Wd,Ib},M|F_VH}, [1][0x22]={"pinsrd|pinsrq",{Vdq,Ey,Ib},M|F_VH},
+    [1][0x30]={"kshiftrb|kshiftrw",{KG,KE,Ib},M|F_VEX}, [1][0x31]={"kshiftrd|kshiftrq",{KG,KE,Ib},M|F_VEX},
+    [1][0x32]={"kshiftlb|kshiftlw",{KG,KE,Ib},M|F_VEX}, [1][0x33]={"kshiftld|kshiftlq",{KG,KE,Ib},M|F_VEX},
+    [1][0x38]={"vinserti128",{Vx,Wdq,Ib},M|F_VEX|F_VH}, [1][0x39]={"vextracti128",{Wdq,Vx,Ib},M|F_VEX},
+    [1][0x40]={"dpps",{Vx,Wx,Ib},M|F_VH}, [1][0x41]={"dppd",{Vdq,Wdq,Ib},M|F_VH}, [1][0x42]={"mpsadbw",{Vx,Wx,Ib},M|F_VH},
+    [1][0x44]={"pclmulqdq",{Vx,Wx,Ib},M|F_VH|F_CLMUL}, [1][0x46]={"vperm2i128",{Vx,Wx,Ib},M|F_VEX|F_VH},
+    [1][0x4a]={"vblendvps",{Vx,Hx,Wx,Lx},M|F_VEX}, [1][0x4b]={"vblendvpd",{Vx,Hx,Wx,Lx},M|F_VEX}, [1][0x4c]={"vpblendvb",{Vx,Hx,Wx,Lx},M|F_VEX},
+    [1][0x60]={"pcmpestrm",{Vdq,Wdq,Ib},M}, [1][0x61]={"pcmpestri",{Vdq,Wdq,Ib},M},
+    [1][0x62]={"pcmpistrm",{Vdq,Wdq,Ib},M}, [1][0x63]={"pcmpistri",{Vdq,Wdq,Ib},M},
+    [0][0xcc]={"sha1rnds4",{Vdq,Wdq,Ib},M|F_NOVEX},
+    [1][0xce]={"gf2p8affineqb",{Vx,Wx,Ib},M|F_VH}, [1][0xcf]={"gf2p8affineinvqb",{Vx,Wx,Ib},M|F_VH},
+    [1][0xdf]={"aeskeygenassist",{Vdq,Wdq,Ib},M},
+    [3][0xf0]={"rorx",{Gy,Ey,Ib},M|F_VEX},
+};
+
+
+
+/* EVEX encodings whose mnemonic or operands differ from the VEX ones */
+typedef struct evex_opcode{
+    u8 map;			/* 1 for 0F, 2 for 0F38, 3 for 0F3A */
+    u8 opcode;
+    u8 prefix;		/* Mandatory prefix: none, 66, F3, F2 */
+    x86_opcode_t entry;
+}evex_opcode_t;
+
+static const x86_opcode_t evexGroup13[8] = {{"vprord|vprorq",{Hx,Wx,Ib},F_VEX},{"vprold|vprolq",{Hx,Wx,Ib},F_VEX},{"vpsrld",{Hx,Wx,Ib},F_VEX},BAD,
+                                            {"vpsrad|vpsraq",{Hx,Wx,Ib},F_VEX},BAD,{"vpslld",{Hx,Wx,Ib},F_VEX},BAD};
+
+static const evex_opcode_t evexOpcodes[] = {
+    {1,0x6f,1,{"vmovdqa32|vmovdqa64",{Vx,Wx},M|F_VEX}}, {1,0x6f,2,{"vmovdqu32|vmovdqu64",{Vx,Wx},M|F_VEX}}, {1,0x6f,3,{"vmovdqu8|vmovdqu16",{Vx,Wx},M|F_VEX}},
+    {1,0x7f,1,{"vmovdqa32|vmovdqa64",{Wx,Vx},M|F_VEX}}, {1,0x7f,2,{"vmovdqu32|vmovdqu64",{Wx,Vx},M|F_VEX}}, {1,0x7f,3,{"vmovdqu8|vmovdqu16",{Wx,Vx},M|F_VEX}},
+    {1,0xdb,1,{"vpandd|vpandq",{Vx,Hx,Wx},M|F_VEX}}, {1,0xdf,1,{"vpandnd|vpandnq",{Vx,Hx,Wx},M|F_VEX}},
+    {1,0xeb,1,{"vpord|vporq",{Vx,Hx,Wx},M|F_VEX}}, {1,0xef,1,{"vpxord|vpxorq",{Vx,Hx,Wx},M|F_VEX}},
+    {1,0x64,1,{"vpcmpgtb",{KG,Hx,Wx},M|F_VEX}}, {1,0x65,1,{"vpcmpgtw",{KG,Hx,Wx},M|F_VEX}}, {1,0x66,1,{"vpcmpgtd",{KG,Hx,Wx},M|F_VEX}},
+    {1,0x74,1,{"vpcmpeqb",{KG,Hx,Wx},M|F_VEX}}, {1,0x75,1,{"vpcmpeqw",{KG,Hx,Wx},M|F_VEX}}, {1,0x76,1,{"vpcmpeqd",{KG,Hx,Wx},M|F_VEX}},
+    {1,0x72,1,{NULL,{0},M|F_GROUP,evexGroup13}},
+    {1,0xe2,1,{"vpsrad|vpsraq",{Vx,Hx,Wdq},M|F_VEX}},
+    {1,0xc2,0,{"vcmpps",{KG,Hx,Wx,Ib},M|F_VEX|F_CMP}}, {1,0xc2,1,{"vcmppd",{KG,Hx,Wx,Ib},M|F_VEX|F_CMP}},
+    {1,0xc2,2,{"vcmpss",{KG,Hx,Wd,Ib},M|F_VEX|F_CMP}}, {1,0xc2,3,{"vcmpsd",{KG,Hx,Wq,Ib},M|F_VEX|F_CMP}},
+    {2,0x16,1,{"vpermps|vpermpd",{Vx,Hx,Wx},M|F_VEX}}, {2,0x36,1,{"vpermd|vpermq",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x19,1,{"vbroadcastf32x2|vbroadcastsd",{Vx,Wq},M|F_VEX}},
+    {2,0x1a,1,{"vbroadcastf32x4|vbroadcastf64x2",{Vx,Mdq},M|F_VEX}}, {2,0x1b,1,{"vbroadcastf32x8|vbroadcastf64x4",{Vx,Mqq},M|F_VEX}},
+    {2,0x1f,1,{"vpabsq",{Vx,Wx},M|F_VEX}},
+    {2,0x26,1,{"vptestmb|vptestmw",{KG,Hx,Wx},M|F_VEX}}, {2,0x26,2,{"vptestnmb|vptestnmw",{KG,Hx,Wx},M|F_VEX}},
+    {2,0x27,1,{"vptestmd|vptestmq",{KG,Hx,Wx},M|F_VEX}}, {2,0x27,2,{"vptestnmd|vptestnmq",{KG,Hx,Wx},M|F_VEX}},
+    {2,0x28,2,{"vpmovm2b|vpmovm2w",{Vx,KE},M|F_VEX}}, {2,0x38,2,{"vpmovm2d|vpmovm2q",{Vx,KE},M|F_VEX}},
+    {2,0x29,1,{"vpcmpeqq",{KG,Hx,Wx},M|F_VEX}}, {2,0x37,1,{"vpcmpgtq",{KG,Hx,Wx},M|F_VEX}},
+    {2,0x29,2,{"vpmovb2m|vpmovw2m",{KG,Ux},M|F_VEX}}, {2,0x39,2,{"vpmovd2m|vpmovq2m",{KG,Ux},M|F_VEX}},
+    {2,0x39,1,{"vpminsd|vpminsq",{Vx,Hx,Wx},M|F_VEX}}, {2,0x3b,1,{"vpminud|vpminuq",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x3d,1,{"vpmaxsd|vpmaxsq",{Vx,Hx,Wx},M|F_VEX}}, {2,0x3f,1,{"vpmaxud|vpmaxuq",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x40,1,{"vpmulld|vpmullq",{Vx,Hx,Wx},M|F_VEX}}, {2,0x46,1,{"vpsravd|vpsravq",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x44,1,{"vplzcntd|vplzcntq",{Vx,Wx},M|F_VEX}}, {2,0xc4,1,{"vpconflictd|vpconflictq",{Vx,Wx},M|F_VEX}},
+    {2,0x4c,1,{"vrcp14ps|vrcp14pd",{Vx,Wx},M|F_VEX}}, {2,0x4e,1,{"vrsqrt14ps|vrsqrt14pd",{Vx,Wx},M|F_VEX}},
+    {2,0x50,1,{"vpdpbusd",{Vx,Hx,Wx},M|F_VEX}}, {2,0x51,1,{"vpdpbusds",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x52,1,{"vpdpwssd",{Vx,Hx,Wx},M|F_VEX}}, {2,0x53,1,{"vpdpwssds",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x54,1,{"vpopcntb|vpopcntw",{Vx,Wx},M|F_VEX}}, {2,0x55,1,{"vpopcntd|vpopcntq",{Vx,Wx},M|F_VEX}},
+    {2,0x59,1,{"vbroadcasti32x2|vpbroadcastq",{Vx,Wq},M|F_VEX}},
+    {2,0x5a,1,{"vbroadcasti32x4|vbroadcasti64x2",{Vx,Mdq},M|F_VEX}}, {2,0x5b,1,{"vbroadcasti32x8|vbroadcasti64x4",{Vx,Mqq},M|F_VEX}},
+    {2,0x62,1,{"vpexpandb|vpexpandw",{Vx,Wx},M|F_VEX}}, {2,0x63,1,{"vpcompressb|vpcompressw",{Wx,Vx},M|F_VEX}},
+    {2,0x64,1,{"vpblendmd|vpblendmq",{Vx,Hx,Wx},M|F_VEX}}, {2,0x65,1,{"vblendmps|vblendmpd",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x66,1,{"vpblendmb|vpblendmw",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x75,1,{"vpermi2b|vpermi2w",{Vx,Hx,Wx},M|F_VEX}}, {2,0x76,1,{"vpermi2d|vpermi2q",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x77,1,{"vpermi2ps|vpermi2pd",{Vx,Hx,Wx},M|F_VEX}}, {2,0x7d,1,{"vpermt2b|vpermt2w",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x7e,1,{"vpermt2d|vpermt2q",{Vx,Hx,Wx},M|F_VEX}}, {2,0x7f,1,{"vpermt2ps|vpermt2pd",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0x7a,1,{"vpbroadcastb",{Vx,Rd},M|F_VEX}}, {2,0x7b,1,{"vpbroadcastw",{Vx,Rd},M|F_VEX}}, {2,0x7c,1,{"vpbroadcastd|vpbroadcastq",{Vx,Ry},M|F_VEX}},
+    {2,0x88,1,{"vexpandps|vexpandpd",{Vx,Wx},M|F_VEX}}, {2,0x89,1,{"vpexpandd|vpexpandq",{Vx,Wx},M|F_VEX}},
+    {2,0x8a,1,{"vcompressps|vcompresspd",{Wx,Vx},M|F_VEX}}, {2,0x8b,1,{"vpcompressd|vpcompressq",{Wx,Vx},M|F_VEX}},
+    {2,0x8d,1,{"vpermb|vpermw",{Vx,Hx,Wx},M|F_VEX}},
+    {2,0xb4,1,{"vpmadd52luq",{Vx,Hx,Wx},M|F_VEX}}, {2,0xb5,1,{"vpmadd52huq",{Vx,Hx,Wx},M|F_VEX}},
+    {3,0x03,1,{"valignd|valignq",{Vx,Hx,Wx,Ib},M|F_VEX}},
+    {3,0x08,1,{"vrndscaleps",{Vx,Wx,Ib},M|F_VEX}}, {3,0x09,1,{"vrndscalepd",{Vx,Wx,Ib},M|F_VEX}},
+    {3,0x0a,1,{"vrndscaless",{Vd,Hx,Wd,Ib},M|F_VEX}}, {3,0x0b,1,{"vrndscalesd",{Vq,Hx,Wq,Ib},M|F_VEX}},
+    {3,0x18,1,{"vinsertf32x4|vinsertf64x2",{Vx,Hx,Wdq,Ib},M|F_VEX}}, {3,0x19,1,{"vextractf32x4|vextractf64x2",{Wdq,Vx,Ib},M|F_VEX}},
+    {3,0x1a,1,{"vinsertf32x8|vinsertf64x4",{Vx,Hx,Wqq,Ib},M|F_VEX}}, {3,0x1b,1,{"vextractf32x8|vextractf64x4",{Wqq,Vx,Ib},M|F_VEX}},
+    {3,0x38,1,{"vinserti32x4|vinserti64x2",{Vx,Hx,Wdq,Ib},M|F_VEX}}, {3,0x39,1,{"vextracti32x4|vextracti64x2",{Wdq,Vx,Ib},M|F_VEX}},
+    {3,0x3a,1,{"vinserti32x8|vinserti64x4",{Vx,Hx,Wqq,Ib},M|F_VEX}}, {3,0x3b,1,{"vextracti32x8|vextracti64x4",{Wqq,Vx,Ib},M|F_VEX}},
+    {3,0x1e,1,{"vpcmpud|vpcmpuq",{KG,Hx,Wx,Ib},M|F_VEX|F_CMP}}, {3,0x1f,1,{"vpcmpd|vpcmpq",{KG,Hx,Wx,Ib},M|F_VEX|F_CMP}},
+    {3,0x3e,1,{"vpcmpub|vpcmpuw",{KG,Hx,Wx,Ib},M|F_VEX|F_CMP}}, {3,0x3f,1,{"vpcmpb|vpcmpw",{KG,Hx,Wx,Ib},M|F_VEX|F_CMP}},
+    {3,0x23,1,{"vshuff32x4|vshuff64x2",{Vx,Hx,Wx,Ib},M|F_VEX}}, {3,0x43,1,{"vshufi32x4|vshufi64x2",{Vx,Hx,Wx,Ib},M|F_VEX}},
+    {3,0x25,1,{"vpternlogd|vpternlogq",{Vx,Hx,Wx,Ib},M|F_VEX}}, {3,0x42,1,{"vdbpsadbw",{Vx,Hx,Wx,Ib},M|F_VEX}},
+};
+
+#define NUM_OF_EVEX_OPCODES (sizeof(evexOpcodes)/sizeof(evexOpcodes[0]))
+
+
+
+/* x87 memory forms, indexed by the opcode's low 3 bits then ModRM reg */
+typedef struct x87_opcode{
+    const char * mnemonic;
+    u8 form;		/* Size of the memory operand, or X87_FORM_* of the register forms */
+}x87_opcode_t;
+
+/* Operands of the x87 register forms */
+#define X87_FORM_NONE 0
+#define X87_FORM_ST_STI 1	/* st,st(i) */
+#define X87_FORM_STI_ST 2	/* st(i),st */
+#define X87_FORM_STI 3		/* st(i) */
+#define X87_FORM_AX 4		/* ax */
+#define X87_FORM_SPECIAL 5	/* The ModRM byte selects an instruction without operands */
+
+static const x87_opcode_t x87MemoryForms[8][8] = {
+    {{"fadd",SZ_D},{"fmul",SZ_D},{"fcom",SZ_D},{"fcomp",SZ_D},{"fsub",SZ_D},{"fsubr",SZ_D},{"fdiv",SZ_D},{"fdivr",SZ_D}},
+    {{"fld",SZ_D},{NULL},{"fst",SZ_D},{"fstp",SZ_D},{"fldenv",SZ_NONE},{"fldcw",SZ_W},{"fnstenv",SZ_NONE},{"fnstcw",SZ_W}},
+    {{"fiadd",SZ_D},{"fimul",SZ_D},{"ficom",SZ_D},{"ficomp",SZ_D},{"fisub",SZ_D},{"fisubr",SZ_D},{"fidiv",SZ_D},{"fidivr",SZ_D}},
+    {{"fild",SZ_D},{"fisttp",SZ_D},{"fist",SZ_D},{"fistp",SZ_D},{NULL},{"fld",SZ_T},{NULL},{"fstp",SZ_T}},
+    {{"fadd",SZ_Q},{"fmul",SZ_Q},{"fcom",SZ_Q},{"fcomp",SZ_Q},{"fsub",SZ_Q},{"fsubr",SZ_Q},{"fdiv",SZ_Q},{"fdivr",SZ_Q}},
+    {{"fld",SZ_Q},{"fisttp",SZ_Q},{"fst",SZ_Q},{"fstp",SZ_Q},{"frstor",SZ_NONE},{NULL},{"fnsave",SZ_NONE},{"fnstsw",SZ_W}},
+    {{"fiadd",SZ_W},{"fimul",SZ_W},{"ficom",SZ_W},{"ficomp",SZ_W},{"fisub",SZ_W},{"fisubr",SZ_W},{"fidiv",SZ_W},{"fidivr",SZ_W}},
+    {{"fild",SZ_W},{"fisttp",SZ_W},{"fist",SZ_W},{"fistp",SZ_W},{"fbld",SZ_T},{"fild",SZ_Q},{"fbstp",SZ_T},{"fistp",SZ_Q}},
+};
+
+static const x87_opcode_t x87RegisterForms[8][8] = {
+    {{"fadd",X87_FORM_ST_STI},{"fmul",X87_FORM_ST_STI},{"fcom",X87_FORM_STI},{"fcomp",X87_FORM_STI},
+     {"fsub",X87_FORM_ST_STI},{"fsubr",X87_FORM_ST_STI},{"fdiv",X87_FORM_ST_STI},{"fdivr",X87_FORM_ST_STI}},
+    {{"fld",X87_FORM_STI},{"fxch",X87_FORM_STI},{NULL,X87_FORM_SPECIAL},{NULL},
+     {NULL,X87_FORM_SPECIAL},{NULL,X87_FORM_SPECIAL},{NULL,X87_FORM_SPECIAL},{NULL,X87_FORM_SPECIAL}},
+    {{"fcmovb",X87_FORM_ST_STI},{"fcmove",X87_FORM_ST_STI},{"fcmovbe",X87_FORM_ST_STI},{"fcmovu",X87_FORM_ST_STI},
+     {NULL},{NULL,X87_FORM_SPECIAL},{NULL},{NULL}},
+    {{"fcmovnb",X87_FORM_ST_STI},{"fcmovne",X87_FORM_ST_STI},{"fcmovnbe",X87_FORM_ST_STI},{"fcmovnu",X87_FORM_ST_STI},
+     {NULL,X87_FORM_SPECIAL},{"fucomi",X87_FORM_ST_STI},{"fcomi",X87_FORM_ST_STI},{NULL}},
+    {{"fadd",X87_FORM_STI_ST},{"fmul",X87_FORM_STI_ST},{"fcom2",X87_FORM_STI},{"fcomp3",X87_FORM_STI},
+     {"fsubr",X87_FORM_STI_ST},{"fsub",X87_FORM_STI_ST},{"fdivr",X87_FORM_STI_ST},{"fdiv",X87_FORM_STI_ST}},
+    {{"ffree",X87_FORM_STI},{"fxch4",X87_FORM_STI},{"fst",X87_FORM_STI},{"fstp",X87_FORM_STI},
+     {"fucom",X87_FORM_STI},{"fucomp",X87_FORM_STI},{NULL},{NULL}},
+    {{"faddp",X87_FORM_STI_ST},{"fmulp",X87_FORM_STI_ST},{"fcomp5",X87_FORM_STI},{NULL,X87_FORM_SPECIAL},
+     {"fsubrp",X87_FORM_STI_ST},{"fsubp",X87_FORM_STI_ST},{"fdivrp",X87_FORM_STI_ST},{"fdivp",X87_FORM_STI_ST}},
+    {{"ffreep",X87_FORM_STI},{"fxch7",X87_FORM_STI},{"fstp8",X87_FORM_STI},{"fstp9",X87_FORM_STI},
+     {NULL,X87_FORM_SPECIAL},{"fucomip",X87_FORM_ST_STI},{"fcomip",X87_FORM_ST_STI},{NULL}},
+};
+
+/* Register forms selected by the whole ModRM byte, from 0xe0 of D9 */
+static const char * x87D9Forms[32] = {
+    "fchs","fabs",NULL,NULL,"ftst","fxam",NULL,NULL,"fld1","fldl2t","fldl2e","fldpi","fldlg2","fldln2","fldz",NULL,
+    "f2xm1","fyl2x","fptan","fpatan","fxtract","fprem1","fdecstp","fincstp","fprem","fyl2xp1","fsqrt","fsincos","frndint","fscale","fsin","fcos"
+};
+
+
+
+/* Encodings of the opcode */
+#define ENCODING_LEGACY 0
+#define ENCODING_VEX 1
+#define ENCODING_EVEX 2
+
+/* Size keywords of the memory operands */
+#define PTR_NONE 0
+#define PTR_BYTE 1
+#define PTR_WORD 2
+#define PTR_DWORD 3
+#define PTR_FWORD 4
+#define PTR_QWORD 5
+#define PTR_TBYTE 6
+#define PTR_OWORD 7
+#define PTR_XMMWORD 8
+#define PTR_YMMWORD 9
+#define PTR_ZMMWORD 10
+
+/* Pseudo general registers of the memory operands */
+#define REG_RIZ 16
+#define REG_RIP 17
+
+/* REX bits, and the use of a bare REX switching spl..dil in for ah..bh */
+#define REX_B 0x1
+#define REX_X 0x2
+#define REX_R 0x4
+#define REX_W 0x8
+#define REX_BYTE_REGS 0x40
+
+
+/* State of the instruction being decoded */
+typedef struct x86_decoder{
+    const u8 * code;
+    u64 size;           /* Bytes available at code */
+    u8 pos;             /* Bytes consumed */
+    u8 truncated;       /* The instruction goes past size or past the longest length */
+
+    // Legacy prefixes in their order, and where the effective ones are
+    u8 prefixBytes[X86_MAX_INSTRUCTION_LENGTH];
+    u8 numOfPrefixBytes;
+    s8 data16, addr32, repeat, segment;     /* Positions in prefixBytes, -1 for none */
+
+    u8 encoding;        /* ENCODING_* */
+    u8 rex;             /* REX byte, or the REX bits of VEX and EVEX */
+    u8 rexUsed;         /* REX_* bits the operands used */
+    u8 evexR, evexV;    /* High bits of the EVEX registers */
+    u8 map;             /* 0 for one byte opcodes, 1 for 0F, 2 for 0F38, 3 for 0F3A */
+    u8 opcode;
+    u8 prefix;          /* Mandatory prefix of VEX and EVEX: none, 66, F3, F2 */
+    u8 vectorLength;    /* 0 for 128 bits, 1 for 256, 2 for 512 */
+    u8 vvvv;
+    u8 evexMask, evexZeroing, evexB;
+
+    u8 modrm, mod, reg, rm;
+    u8 sibIndex;        /* Raw SIB index of the vector indexes */
+    u8 disp8;           /* The displacement is a byte, scaled by EVEX */
+    x86_operand_t memory;   /* ModRM memory operand, without its size */
+
+    u8 operandSize;     /* 2, 4 or 8 bytes */
+    u32 flags;          /* Flags of the instruction's entries */
+    u8 usedData16, usedAddr32, usedRepeat, usedSegment;
+}x86_decoder_t;
+
+
+static inline u8 next_byte(x86_decoder_t * d){
+
+    if(d->pos>=d->size || d->pos>=X86_MAX_INSTRUCTION_LENGTH){
+        d->truncated = 1;
+        return 0;
+    }
+    return d->code[d->pos++];
+}
+
+
+/* Read a little endian value of 1, 2, 4 or 8 bytes */
+static u64 next_value(x86_decoder_t * d, u8 bytes){
+
+    u64 value=0;
+    for(u8 i=0;i<bytes;i++)
+        value |= (u64)next_byte(d)<<(i*8);
+    return value;
+}
+
+
+static inline s64 sign_extend(u64 value, u8 bytes){
+
+    return bytes>=8 ? (s64)value : (s64)(value<<(64-bytes*8))>>(64-bytes*8);
+}
+
+
+static inline u64 mask_to_size(u64 value, u8 bytes){
+
+    return bytes>=8 ? value : value & ((1ULL<<(bytes*8))-1);
+}
+
+
+/* Read the ModRM byte with the SIB byte and the displacement of a memory operand */
+static void read_modrm(x86_decoder_t * d, u8 registerOnly){
+
+    d->modrm = next_byte(d);
+    d->mod = d->modrm>>6;
+    d->reg = (d->modrm>>3)&7;
+    d->rm = d->modrm&7;
+    if(registerOnly)
+        d->mod = 3;
+    if(d->mod==3)
+        return;
+
+    x86_operand_t * memory = &d->memory;
+    memory->kind = X86_OPERAND_MEMORY;
+    memory->regFile = d->addr32>=0 ? X86_REGS_GPR32 : X86_REGS_GPR64;
+    memory->indexFile = memory->regFile;
+    memory->base = X86_NO_REGISTER;
+    memory->index = X86_NO_REGISTER;
+    memory->scale = 1;
+    memory->segment = X86_SEGMENT_NONE;
+    memory->displacement = 0;
+    memory->hasDisplacement = 0;
+    memory->broadcast = 0;
+    d->usedAddr32 = 1;
+
+    u8 dispSize = d->mod==1 ? 1 : (d->mod==2 ? 4 : 0);
+    if(d->rm==4){
+        u8 sib = next_byte(d);
+        u8 base = sib&7;
+        memory->scale = 1<<(sib>>6);
+        d->sibIndex = (sib>>3)&7;
+
+        u8 index = d->sibIndex | ((d->rex&REX_X) ? 8 : 0);
+        d->rexUsed |= REX_X;
+        if(index!=4)
+            memory->index = index;
+        else if(memory->scale!=1 || (base!=4 && !(base==5 && d->mod==0)))
+            memory->index = REG_RIZ;
+
+        if(base==5 && d->mod==0)
+            dispSize = 4;
+        else{
+            memory->base = base | ((d->rex&REX_B) ? 8 : 0);
+            d->rexUsed |= REX_B;
+        }
+    }else if(d->rm==5 && d->mod==0){
+        memory->base = REG_RIP;
+        dispSize = 4;
+    }else{
+        memory->base = d->rm | ((d->rex&REX_B) ? 8 : 0);
+        d->rexUsed |= REX_B;
+    }
+
+    if(dispSize){
+        memory->hasDisplacement = 1;
+        memory->displacement = sign_extend(next_value(d,dispSize),dispSize);
+    }
+    d->disp8 = dispSize==1;
+}
+
+
+/* Size in bytes of an operand in memory */
+static u16 memory_bytes(x86_decoder_t * d, u8 size){
+
+    u16 length = 16<<d->vectorLength;
+    u8 wide = (d->rex&REX_W)!=0;
+
+    switch(size){
+        case SZ_B: case SZ_DB: return 1;
+        case SZ_W: case SZ_VW: case SZ_DW: return 2;
+        case SZ_D: return 4;
+        case SZ_Q: return 8;
+        case SZ_T: return 10;
+        case SZ_O: case SZ_DQ: return 16;
+        case SZ_QQ: return 32;
+        case SZ_V: return d->operandSize;
+        case SZ_Y: case SZ_E: return wide ? 8 : 4;
+        case SZ_Z: return d->operandSize==2 ? 2 : 4;
+        case SZ_P: return d->operandSize==2 ? 4 : 6;
+        case SZ_X: return length;
+        case SZ_XH: return length/2;
+        case SZ_XQ: return length/4;
+        case SZ_XO: return length/8;
+        case SZ_QO: return wide ? 16 : 8;
+        case SZ_XDUP: return length==16 ? 8 : length;
+        case SZ_V64: return d->operandSize==2 ? 2 : 8;
+        default: return 0;
+    }
+}
+
+
+/* Size in bytes of a general register operand */
+static u16 register_bytes(x86_decoder_t * d, u8 size){
+
+    if(size==SZ_VW)
+        return d->operandSize;
+    if(size==SZ_DW || size==SZ_DB)
+        return 4;
+    return memory_bytes(d,size);
+}
+
+
+/* Width in bytes of a vector register operand */
+static u16 vector_bytes(x86_decoder_t * d, u8 size){
+
+    u16 length = 16<<d->vectorLength;
+
+    switch(size){
+        case SZ_X: case SZ_XDUP: return length;
+        case SZ_XH: return length>16 ? length/2 : 16;
+        case SZ_QQ: return 32;
+        default: return 16;
+    }
+}
+
+
+static u8 ptr_of_size(u8 size, u16 bytes){
+
+    if(size==SZ_NONE)
+        return PTR_NONE;
+    if(size==SZ_O || (size==SZ_QO && bytes==16))
+        return PTR_OWORD;
+
+    switch(bytes){
+        case 1: return PTR_BYTE;
+        case 2: return PTR_WORD;
+        case 4: return PTR_DWORD;
+        case 6: return PTR_FWORD;
+        case 8: return PTR_QWORD;
+        case 10: return PTR_TBYTE;
+        case 16: return PTR_XMMWORD;
+        case 32: return PTR_YMMWORD;
+        case 64: return PTR_ZMMWORD;
+        default: return PTR_NONE;
+    }
+}
+
+
+static void set_register(x86_operand_t * operand, u8 regFile, u8 reg, u16 size){
+
+    operand->kind = X86_OPERAND_REGISTER;
+    operand->regFile = regFile;
+    operand->reg = reg;
+    operand->size = size;
+}
+
+
+/* General register of 1, 2, 4 or 8 bytes */
+static void set_gpr(x86_decoder_t * d, x86_operand_t * operand, u8 reg, u16 size){
+
+    u8 regFile = X86_REGS_GPR64;
+    if(size==1){
+        // A REX prefix, even without bits, turns ah..bh into spl..dil
+        regFile = (d->rex || d->encoding!=ENCODING_LEGACY) ? X86_REGS_GPR8 : X86_REGS_GPR8_LEGACY;
+        if(reg>=4 && reg<8)
+            d->rexUsed |= REX_BYTE_REGS;
+    }else if(size==2)
+        regFile = X86_REGS_GPR16;
+    else if(size==4)
+        regFile = X86_REGS_GPR32;
+
+    set_register(operand,regFile,reg,size);
+}
+
+
+static void set_vector(x86_operand_t * operand, u8 reg, u16 bytes){
+
+    set_register(operand,bytes==64 ? X86_REGS_ZMM : (bytes==32 ? X86_REGS_YMM : X86_REGS_XMM),reg,bytes);
+}
+
+
+/* The ModRM memory operand with its size, and the EVEX broadcast and compressed displacement */
+static void set_memory(x86_decoder_t * d, x86_operand_t * operand, u8 size, u8 broadcastable){
+
+    *operand = d->memory;
+    operand->size = memory_bytes(d,size);
+    operand->ptr = ptr_of_size(size,operand->size);
+
+    u16 scale = operand->size;
+    if(d->encoding==ENCODING_EVEX && d->evexB && broadcastable){
+        u16 element = (d->rex&REX_W) ? 8 : 4;
+        operand->broadcast = operand->size/element;
+        operand->size = element;
+        operand->ptr = ptr_of_size(SZ_Q,element);
+        scale = element;
+    }
+    if(d->encoding==ENCODING_EVEX && d->disp8)
+        operand->displacement *= scale;
+
+    // fs and gs are the only segment overrides left in 64-bit mode
+    if(d->segment>=0 && (d->prefixBytes[d->segment]==0x64 || d->prefixBytes[d->segment]==0x65)){
+        operand->segment = d->prefixBytes[d->segment]==0x64 ? X86_SEGMENT_FS : X86_SEGMENT_GS;
+        d->usedSegment = 1;
+    }
+}
+
+
+/* Implicit memory operand of the string instructions and xlat */
+static void set_string_memory(x86_decoder_t * d, x86_operand_t * operand, u8 base, u8 segment, u8 size){
+
+    operand->kind = X86_OPERAND_MEMORY;
+    operand->regFile = d->addr32>=0 ? X86_REGS_GPR32 : X86_REGS_GPR64;
+    operand->indexFile = operand->regFile;
+    operand->base = base;
+    operand->index = X86_NO_REGISTER;
+    operand->scale = 1;
+    operand->hasDisplacement = 0;
+    operand->displacement = 0;
+    operand->broadcast = 0;
+    operand->size = memory_bytes(d,size);
+    operand->ptr = ptr_of_size(size,operand->size);
+    d->usedAddr32 = 1;
+
+    // Only es:[rdi] cannot be overridden
+    operand->segment = segment;
+    if(segment!=X86_SEGMENT_ES && d->segment>=0){
+        u8 prefix = d->prefixBytes[d->segment];
+        operand->segment = prefix==0x64 ? X86_SEGMENT_FS : (prefix==0x65 ? X86_SEGMENT_GS : segment);
+        d->usedSegment = 1;
+    }
+}
+
+
+/* Decode an operand of the opcode tables, returns 0 if the encoding does not fit it */
+static u8 decode_operand(x86_decoder_t * d, u16 spec, x86_operand_t * operand){
+
+    u8 type = OP_TYPE(spec);
+    u8 size = OP_SIZE(spec);
+    u8 rexR = (d->rex&REX_R) ? 8 : 0;
+    u8 rexB = (d->rex&REX_B) ? 8 : 0;
+
+    operand->ptr = PTR_NONE;
+    operand->broadcast = 0;
+
+    switch(type){
+        case OT_E:
+            if(d->mod!=3){
+                set_memory(d,operand,size,0);
+                return 1;
+            }
+            // Fall through
+        case OT_R:
+            d->rexUsed |= REX_B;
+            set_gpr(d,operand,d->rm|rexB,register_bytes(d,size));
+            return 1;
+
+        case OT_M:
+            if(d->mod==3)
+                return 0;
+            set_memory(d,operand,size,0);
+            return 1;
+
+        case OT_G:
+            d->rexUsed |= REX_R;
+            set_gpr(d,operand,d->reg|rexR,register_bytes(d,size));
+            return 1;
+
+        case OT_Z:
+            d->rexUsed |= REX_B;
+            set_gpr(d,operand,(d->opcode&7)|rexB,register_bytes(d,size));
+            return 1;
+
+        case OT_A:
+            set_gpr(d,operand,0,register_bytes(d,size));
+            return 1;
+
+        case OT_CL:
+            set_gpr(d,operand,1,1);
+            return 1;
+
+        case OT_DX:
+            set_gpr(d,operand,2,2);
+            return 1;
+
+        case OT_I:
+        case OT_IS:{
+            u8 bytes = type==OT_IS ? 1 : (size==SZ_Z ? (d->operandSize==2 ? 2 : 4) : (u8)memory_bytes(d,size));
+            u8 displayed = (type==OT_IS || size==SZ_Z) ? d->operandSize : bytes;
+            u64 value = next_value(d,bytes);
+            operand->kind = X86_OPERAND_IMMEDIATE;
+            operand->size = displayed;
+            operand->value = mask_to_size(sign_extend(value,bytes),displayed);
+            return 1;
+        }
+
+        case OT_ONE:
+            operand->kind = X86_OPERAND_IMMEDIATE;
+            operand->size = 0;
+            operand->value = 1;
+            return 1;
+
+        case OT_J:{
+            u8 bytes = size==SZ_B ? 1 : 4;
+            operand->kind = X86_OPERAND_TARGET;
+            operand->size = 8;
+            operand->displacement = sign_extend(next_value(d,bytes),bytes);
+            return 1;
+        }
+
+        case OT_O:{
+            // The absolute address is 8 bytes, 4 with 67 where it is no longer movabs
+            u8 bytes = d->addr32>=0 ? 4 : 8;
+            operand->kind = X86_OPERAND_MEMORY;
+            operand->regFile = X86_REGS_GPR64;
+            operand->indexFile = X86_REGS_GPR64;
+            operand->base = X86_NO_REGISTER;
+            operand->index = X86_NO_REGISTER;
+            operand->scale = 1;
+            operand->hasDisplacement = 1;
+            operand->displacement = next_value(d,bytes);
+            operand->size = memory_bytes(d,size);
+            operand->segment = X86_SEGMENT_NONE;
+            if(d->segment>=0 && (d->prefixBytes[d->segment]==0x64 || d->prefixBytes[d->segment]==0x65)){
+                operand->segment = d->prefixBytes[d->segment]==0x64 ? X86_SEGMENT_FS : X86_SEGMENT_GS;
+                d->usedSegment = 1;
+            }
+            return 1;
+        }
+
+        case OT_X:
+            set_string_memory(d,operand,6,X86_SEGMENT_DS,size);
+            return 1;
+
+        case OT_Y:
+            set_string_memory(d,operand,7,X86_SEGMENT_ES,size);
+            return 1;
+
+        case OT_XLAT:
+            set_string_memory(d,operand,3,X86_SEGMENT_DS,size);
+            return 1;
+
+        case OT_S:
+            if(d->reg>5)
+                return 0;
+            set_register(operand,X86_REGS_SEGMENT,d->reg,2);
+            return 1;
+
+        case OT_SEG:
+            set_register(operand,X86_REGS_SEGMENT,size,2);
+            return 1;
+
+        case OT_C:
+        case OT_D:
+            d->rexUsed |= REX_R;
+            set_register(operand,type==OT_C ? X86_REGS_CONTROL : X86_REGS_DEBUG,d->reg|rexR,8);
+            return 1;
+
+        case OT_V:
+            d->rexUsed |= REX_R;
+            set_vector(operand,d->reg|rexR|d->evexR,vector_bytes(d,size));
+            return 1;
+
+        case OT_H:
+            set_vector(operand,d->vvvv,vector_bytes(d,size));
+            return 1;
+
+        case OT_W:
+            if(d->mod!=3){
+                set_memory(d,operand,size,size==SZ_X || size==SZ_XH);
+                return 1;
+            }
+            // Fall through
+        case OT_U:
+            if(d->mod!=3)
+                return 0;
+            d->rexUsed |= REX_B|REX_X;
+            set_vector(operand,d->rm|rexB|(d->encoding==ENCODING_EVEX && (d->rex&REX_X) ? 16 : 0),vector_bytes(d,size));
+            return 1;
+
+        case OT_L:
+            set_vector(operand,next_byte(d)>>4,vector_bytes(d,size));
+            return 1;
+
+        case OT_P:
+            set_register(operand,X86_REGS_MMX,d->reg,8);
+            return 1;
+
+        case OT_Q:
+            if(d->mod!=3){
+                set_memory(d,operand,size,0);
+                return 1;
+            }
+            // Fall through
+        case OT_N:
+            if(d->mod!=3)
+                return 0;
+            set_register(operand,X86_REGS_MMX,d->rm,8);
+            return 1;
+
+        case OT_KG:
+            set_register(operand,X86_REGS_MASK,d->reg,8);
+            return 1;
+
+        case OT_KE:
+            if(d->mod!=3)
+                return 0;
+            set_register(operand,X86_REGS_MASK,d->rm,8);
+            return 1;
+
+        case OT_KH:
+            set_register(operand,X86_REGS_MASK,d->vvvv&7,8);
+            return 1;
+
+        case OT_B:
+            set_gpr(d,operand,d->vvvv&15,register_bytes(d,size));
+            return 1;
+
+        case OT_XMM0:
+            set_vector(operand,0,16);
+            return 1;
+
+        case OT_VSIB:{
+            if(d->mod==3 || d->rm!=4)
+                return 0;
+            set_memory(d,operand,SZ_E,0);
+            u8 index = d->sibIndex | ((d->rex&REX_X) ? 8 : 0) | (d->encoding==ENCODING_EVEX ? d->evexV&16 : 0);
+            u16 width = vector_bytes(d,size);
+            operand->index = index;
+            operand->indexFile = width==64 ? X86_REGS_ZMM : (width==32 ? X86_REGS_YMM : X86_REGS_XMM);
+            return 1;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+
+
+/* Names of the comparison predicates of cmpps and vcmpps */
+static const char * comparePredicates[32] = {
+    "eq","lt","le","unord","neq","nlt","nle","ord","eq_uq","nge","ngt","false","neq_oq","ge","gt","true",
+    "eq_os","lt_oq","le_oq","unord_s","neq_us","nlt_uq","nle_uq","ord_s","eq_us","nge_uq","ngt_uq","false_os","neq_os","ge_oq","gt_oq","true_us"
+};
+
+/* Names of the integer comparison predicates of vpcmp, the others keep their immediate */
+static const char * integerPredicates[8] = {"eq","lt","le",NULL,"neq","nlt","nle",NULL};
+
+/* Quadwords multiplied by pclmulqdq */
+static const char * clmulSelectors[4] = {"lql","hql","lqh","hqh"};
+
+
+/* Copy the mnemonic, choosing the "a|b" alternative by W and the "a/b/c" one by the operand size */
+static void select_mnemonic(x86_decoder_t * d, x86_instruction_t * insn, const char * mnemonic, u8 vexPrefix){
+
+    u8 choice=0;
+    if(strchr(mnemonic,'|')){
+        choice = (d->rex&REX_W)!=0;
+        d->rexUsed |= REX_W;
+    }else if(strchr(mnemonic,'/')){
+        choice = d->operandSize==2 ? 0 : (d->operandSize==4 ? 1 : 2);
+        if(!(d->flags&F_D64))
+            d->rexUsed |= REX_W;
+        d->usedData16 = 1;
+    }
+
+    // Skip to the chosen alternative
+    for(u8 i=0;i<choice;i++){
+        const char * next = strpbrk(mnemonic,"|/");
+        if(!next)
+            break;
+        mnemonic = next+1;
+    }
+
+    u8 length=0;
+    if(vexPrefix)
+        insn->mnemonicBuffer[length++] = 'v';
+    while(*mnemonic && *mnemonic!='|' && *mnemonic!='/' && length<sizeof(insn->mnemonicBuffer)-1)
+        insn->mnemonicBuffer[length++] = *mnemonic++;
+    insn->mnemonicBuffer[length] = 0;
+    insn->mnemonic = (const char *)insn->mnemonicBuffer;
+}
+
+
+/* Insert text into the mnemonic after its first occurrence of anchor */
+static void insert_in_mnemonic(x86_instruction_t * insn, const char * anchor, const char * text){
+
+    char * position = strstr((char *)insn->mnemonicBuffer,anchor);
+    if(!position)
+        return;
+    position += strlen(anchor);
+
+    u64 textLength = strlen(text);
+    u64 tailLength = strlen(position);
+    if(position-(char *)insn->mnemonicBuffer+textLength+tailLength>=sizeof(insn->mnemonicBuffer))
+        return;
+    memmove(position+textLength,position,tailLength+1);
+    memcpy(position,text,textLength);
+}
+
+
+/* Name the predicate or the selector held by the immediate in the mnemonic, dropping the immediate */
+static void name_immediate(x86_decoder_t * d, x86_instruction_t * insn, u32 flags){
+
+    if(!insn->numOfOperands || insn->operands[insn->numOfOperands-1].kind!=X86_OPERAND_IMMEDIATE)
+        return;
+    u64 value = insn->operands[insn->numOfOperands-1].value;
+
+    const char * name = NULL;
+    const char * anchor = "cmp";
+    if(flags&F_CLMUL){
+        if(!(value&~0x11ULL))
+            name = clmulSelectors[(value&1)|((value>>3)&2)];
+        anchor = "pclmul";
+        if(name){
+            // pclmulqdq becomes pclmul<selector>qdq
+            insert_in_mnemonic(insn,anchor,name);
+            insn->numOfOperands--;
+        }
+        return;
+    }
+
+    if(!strncmp(insn->mnemonic,"vpcmp",5))
+        name = value<8 ? integerPredicates[value] : NULL;
+    else if(value<(d->encoding==ENCODING_LEGACY ? 8 : 32))
+        name = comparePredicates[value];
+
+    if(name){
+        insert_in_mnemonic(insn,anchor,name);
+        insn->numOfOperands--;
+    }
+}
+
+
+/* The x87 escapes D8..DF */
+static u8 decode_x87(x86_decoder_t * d, x86_instruction_t * insn){
+
+    u8 low = d->opcode&7;
+
+    if(d->mod!=3){
+        const x87_opcode_t * form = &x87MemoryForms[low][d->reg];
+        if(!form->mnemonic)
+            return 0;
+        insn->mnemonic = form->mnemonic;
+        set_memory(d,&insn->operands[0],form->form,0);
+        insn->numOfOperands = 1;
+        return 1;
+    }
+
+    const x87_opcode_t * form = &x87RegisterForms[low][d->reg];
+    if(form->form==X87_FORM_SPECIAL){
+        // The instructions without operands selected by the whole ModRM byte
+        const char * mnemonic = NULL;
+        if(low==1 && d->reg==2)
+            mnemonic = d->rm==0 ? "fnop" : NULL;
+        else if(low==1)
+            mnemonic = x87D9Forms[d->modrm-0xe0];
+        else if(low==2 && d->rm==1)
+            mnemonic = "fucompp";
+        else if(low==3)
+            mnemonic = d->rm==2 ? "fnclex" : (d->rm==3 ? "fninit" : NULL);
+        else if(low==6 && d->rm==1)
+            mnemonic = "fcompp";
+        else if(low==7 && d->rm==0){
+            set_gpr(d,&insn->operands[0],0,2);
+            insn->numOfOperands = 1;
+            mnemonic = "fnstsw";
+        }
+        insn->mnemonic = mnemonic;
+        return mnemonic!=NULL;
+    }
+    if(!form->mnemonic)
+        return 0;
+
+    insn->mnemonic = form->mnemonic;
+    x86_operand_t * operands = insn->operands;
+    switch(form->form){
+        case X87_FORM_ST_STI:
+            set_register(&operands[0],X86_REGS_X87_TOP,0,10);
+            set_register(&operands[1],X86_REGS_X87,d->rm,10);
+            insn->numOfOperands = 2;
+            break;
+        case X87_FORM_STI_ST:
+            set_register(&operands[0],X86_REGS_X87,d->rm,10);
+            set_register(&operands[1],X86_REGS_X87_TOP,0,10);
+            insn->numOfOperands = 2;
+            break;
+        case X87_FORM_STI:
+            set_register(&operands[0],X86_REGS_X87,d->rm,10);
+            insn->numOfOperands = 1;
+            break;
+    }
+    return 1;
+}
+
+
+/* VEX encoded opmask instructions of the 0F map */
+static u8 decode_mask_instruction(x86_decoder_t * d, x86_instruction_t * insn){
+
+    u8 wide = (d->rex&REX_W)!=0;
+    const char * suffix = d->prefix==0 ? (wide ? "q" : "w") : (d->prefix==1 ? (wide ? "d" : "b") : NULL);
+    const char * name = NULL;
+    u8 form=0;  // 0: k,k  1: k,k,k  2: kmov
+
+    switch(d->opcode){
+        case 0x41: name = "kand"; form = 1; break;
+        case 0x42: name = "kandn"; form = 1; break;
+        case 0x44: name = "knot"; break;
+        case 0x45: name = "kor"; form = 1; break;
+        case 0x46: name = "kxnor"; form = 1; break;
+        case 0x47: name = "kxor"; form = 1; break;
+        case 0x4a: name = "kadd"; form = 1; break;
+        case 0x4b:
+            name = "kunpck";
+            form = 1;
+            suffix = d->prefix==1 && !wide ? "bw" : (d->prefix==0 ? (wide ? "dq" : "wd") : NULL);
+            break;
+        case 0x90: case 0x91: case 0x92: case 0x93:
+            name = "kmov";
+            form = 2;
+            if(d->opcode>=0x92 && d->prefix==3)
+                suffix = wide ? "q" : "d";
+            else if(d->opcode>=0x92 && wide)
+                suffix = NULL;
+            break;
+        case 0x98: name = "kortest"; break;
+        case 0x99: name = "ktest"; break;
+        default: return 0;
+    }
+    if(!suffix)
+        return 0;
+
+    snprintf((char *)insn->mnemonicBuffer,sizeof(insn->mnemonicBuffer),"%s%s",name,suffix);
+    insn->mnemonic = (const char *)insn->mnemonicBuffer;
+
+    x86_operand_t * operands = insn->operands;
+    u16 bytes = suffix[0]=='b' ? 1 : (suffix[0]=='w' ? 2 : (suffix[0]=='d' ? 4 : 8));
+    insn->numOfOperands = 2;
+
+    if(form==1){
+        if(d->mod!=3)
+            return 0;
+        set_register(&operands[0],X86_REGS_MASK,d->reg,8);
+        set_register(&operands[1],X86_REGS_MASK,d->vvvv&7,8);
+        set_register(&operands[2],X86_REGS_MASK,d->rm,8);
+        insn->numOfOperands = 3;
+        return 1;
+    }
+    if(form==0 || d->opcode==0x90){
+        if(d->mod!=3 && form==0)
+            return 0;
+        set_register(&operands[0],X86_REGS_MASK,d->reg,8);
+        if(d->mod==3)
+            set_register(&operands[1],X86_REGS_MASK,d->rm,8);
+        else{
+            set_memory(d,&operands[1],SZ_NONE,0);
+            operands[1].size = bytes;
+            operands[1].ptr = ptr_of_size(SZ_Q,bytes);
+        }
+        return 1;
+    }
+
+    switch(d->opcode){
+        case 0x91:
+            if(d->mod==3)
+                return 0;
+            set_memory(d,&operands[0],SZ_NONE,0);
+            operands[0].size = bytes;
+            operands[0].ptr = ptr_of_size(SZ_Q,bytes);
+            set_register(&operands[1],X86_REGS_MASK,d->reg,8);
+            return 1;
+        case 0x92:
+            if(d->mod!=3)
+                return 0;
+            set_register(&operands[0],X86_REGS_MASK,d->reg,8);
+            set_gpr(d,&operands[1],d->rm|((d->rex&REX_B) ? 8 : 0),bytes==8 ? 8 : 4);
+            return 1;
+        default:
+            if(d->mod!=3)
+                return 0;
+            set_gpr(d,&operands[0],d->reg|((d->rex&REX_R) ? 8 : 0),bytes==8 ? 8 : 4);
+            set_register(&operands[1],X86_REGS_MASK,d->rm,8);
+            return 1;
+    }
+}
+
+
+/* Find the EVEX specific entry of an opcode */
+static const x86_opcode_t * find_evex_opcode(x86_decoder_t * d){
+
+    for(u32 i=0;i<NUM_OF_EVEX_OPCODES;i++)
+        if(evexOpcodes[i].opcode==d->opcode && evexOpcodes[i].map==d->map && evexOpcodes[i].prefix==d->prefix)
+            return &evexOpcodes[i].entry;
+    return NULL;
+}
+
+
+/* Read the legacy prefixes, the REX prefix and the VEX or EVEX prefix, then the opcode */
+static u8 decode_prefixes(x86_decoder_t * d){
+
+    for(;;){
+        u8 byte = next_byte(d);
+        if(d->truncated)
+            return 0;
+
+        s8 * effective = NULL;
+        switch(byte){
+            case 0x66: effective = &d->data16; break;
+            case 0x67: effective = &d->addr32; break;
+            case 0xf2: case 0xf3: effective = &d->repeat; break;
+            case 0x26: case 0x2e: case 0x36: case 0x3e: case 0x64: case 0x65: effective = &d->segment; break;
+            case 0xf0: break;
+            default:
+                if((byte&0xf0)==0x40){
+                    d->rex = byte;
+                    continue;
+                }
+                d->opcode = byte;
+                return 1;
+        }
+
+        // A REX prefix followed by another prefix ends an instruction of prefixes only
+        if(d->rex){
+            d->pos--;
+            return 2;
+        }
+        if(effective)
+            *effective = d->numOfPrefixBytes;
+        d->prefixBytes[d->numOfPrefixBytes++] = byte;
+    }
+}
+
+
+/* Read the VEX or EVEX prefix, whose first byte is the opcode read so far */
+static u8 decode_vex(x86_decoder_t * d){
+
+    // VEX and EVEX exclude REX, 66, F2, F3 and lock
+    if(d->rex || d->data16>=0 || d->repeat>=0)
+        return 0;
+    for(u8 i=0;i<d->numOfPrefixBytes;i++)
+        if(d->prefixBytes[i]==0xf0)
+            return 0;
+
+    u8 first = d->opcode;
+    u8 p0 = next_byte(d);
+    d->rex = ((p0&0x80) ? 0 : REX_R);
+
+    if(first==0xc5){
+        d->encoding = ENCODING_VEX;
+        d->map = 1;
+        d->vvvv = (~p0>>3)&15;
+        d->vectorLength = (p0>>2)&1;
+        d->prefix = p0&3;
+    }else{
+        d->rex |= ((p0&0x40) ? 0 : REX_X) | ((p0&0x20) ? 0 : REX_B);
+        u8 p1 = next_byte(d);
+        if(p1&0x80)
+            d->rex |= REX_W;
+        d->vvvv = (~p1>>3)&15;
+        d->prefix = p1&3;
+
+        if(first==0xc4){
+            d->encoding = ENCODING_VEX;
+            d->map = p0&0x1f;
+            d->vectorLength = (p1>>2)&1;
+        }else{
+            u8 p2 = next_byte(d);
+            d->encoding = ENCODING_EVEX;
+            d->map = p0&7;
+            d->evexR = (p0&0x10) ? 0 : 16;
+            d->evexV = (p2&0x08) ? 0 : 16;
+            d->vvvv |= d->evexV;
+            d->evexZeroing = p2>>7;
+            d->vectorLength = (p2>>5)&3;
+            d->evexB = (p2>>4)&1;
+            d->evexMask = p2&7;
+            if(!(p1&0x04))
+                return 0;
+        }
+    }
+    if(d->map<1 || d->map>3)
+        return 0;
+
+    d->opcode = next_byte(d);
+    return !d->truncated;
+}
+
+
+/* List the prefixes the instruction did not use, in their order */
+static void list_unused_prefixes(x86_decoder_t * d, x86_instruction_t * insn){
+
+    u32 flags = d->flags;
+    for(u8 i=0;i<d->numOfPrefixBytes;i++){
+        u8 byte = d->prefixBytes[i];
+        u8 shown=0;
+
+        switch(byte){
+            case 0xf0:
+                shown = X86_PREFIX_LOCK;
+                break;
+            case 0x66:
+                if(i!=d->data16 || !d->usedData16)
+                    shown = X86_PREFIX_DATA16;
+                break;
+            case 0x67:
+                if(i!=d->addr32 || !d->usedAddr32)
+                    shown = X86_PREFIX_ADDR32;
+                break;
+            case 0xf2:
+            case 0xf3:
+                if(i==d->repeat && d->usedRepeat)
+                    break;
+                if(i==d->repeat && (flags&F_STRING))
+                    shown = byte==0xf2 ? X86_PREFIX_REPNZ : ((flags&F_REPZ) ? X86_PREFIX_REPZ : X86_PREFIX_REP);
+                else if(i==d->repeat && (flags&F_BRANCH) && byte==0xf2)
+                    shown = X86_PREFIX_BND;
+                else
+                    shown = byte==0xf2 ? X86_PREFIX_REPNZ : X86_PREFIX_REPZ;
+                break;
+            default:
+                if(i==d->segment && d->usedSegment)
+                    break;
+                if(i==d->segment && byte==0x3e && (flags&F_INDIRECT))
+                    shown = X86_PREFIX_NOTRACK;
+                else
+                    shown = byte==0x26 ? X86_PREFIX_ES : byte==0x2e ? X86_PREFIX_CS : byte==0x36 ? X86_PREFIX_SS :
+                            byte==0x3e ? X86_PREFIX_DS : byte==0x64 ? X86_PREFIX_FS : X86_PREFIX_GS;
+                break;
+        }
+        if(shown)
+            insn->prefixes[insn->numOfPrefixes++] = shown;
+    }
+
+    // A REX prefix is shown whole when one of its bits went unused
+    u8 rexBits = d->rex&0xf;
+    if(d->encoding==ENCODING_LEGACY && d->rex &&
+       ((rexBits & ~d->rexUsed) || (!rexBits && !(d->rexUsed&REX_BYTE_REGS)))){
+        insn->prefixes[insn->numOfPrefixes++] = X86_PREFIX_REX;
+        insn->rex = d->rex;
+    }
+}
+
+
+/* Decode an instruction into insn, returns 0 for the invalid encodings */
+static u8 decode_instruction(x86_decoder_t * d, x86_instruction_t * insn){
+
+    u8 prefixesEnd = decode_prefixes(d);
+    if(!prefixesEnd)
+        return 0;
+    if(prefixesEnd==2){
+        insn->mnemonic = "";
+        return 1;
+    }
+
+    const x86_opcode_t * entry = NULL;
+    u8 repeatByte = d->repeat>=0 ? d->prefixBytes[d->repeat] : 0;
+
+    // The escapes to the other maps
+    if(d->opcode==0xc4 || d->opcode==0xc5 || d->opcode==0x62){
+        if(!decode_vex(d))
+            return 0;
+    }else if(d->opcode==0x0f){
+        d->map = 1;
+        d->opcode = next_byte(d);
+        if(d->opcode==0x38 || d->opcode==0x3a){
+            d->map = d->opcode==0x38 ? 2 : 3;
+            d->opcode = next_byte(d);
+        }
+        // The mandatory prefix of the tables: F3 or F2, else 66
+        d->prefix = repeatByte==0xf3 ? 2 : (repeatByte==0xf2 ? 3 : (d->data16>=0 ? 1 : 0));
+    }
+    if(d->truncated)
+        return 0;
+
+    // VEX opmask instructions and vzeroupper are decoded aside
+    if(d->encoding==ENCODING_VEX && d->map==1){
+        if(d->opcode==0x77){
+            insn->mnemonic = d->vectorLength ? "vzeroall" : "vzeroupper";
+            return 1;
+        }
+        if((d->opcode>=0x41 && d->opcode<=0x4b) || (d->opcode>=0x90 && d->opcode<=0x93) || d->opcode==0x98 || d->opcode==0x99){
+            read_modrm(d,0);
+            return !d->truncated && decode_mask_instruction(d,insn);
+        }
+    }
+
+    u8 prefixFallback=0;
+    if(d->encoding==ENCODING_EVEX)
+        entry = find_evex_opcode(d);
+    if(!entry){
+        switch(d->map){
+            case 0: entry = &oneByteMap[d->opcode]; break;
+            case 1: entry = &twoByteMap[d->opcode]; break;
+            case 2: entry = &map0f38[d->prefix][d->opcode]; break;
+            default: entry = &map0f3a[d->prefix][d->opcode]; break;
+        }
+        // Legacy three byte opcodes without a form for their prefix ignore it
+        if(d->map>=2 && d->encoding==ENCODING_LEGACY && !entry->mnemonic && !entry->flags && d->prefix){
+            entry = d->map==2 ? &map0f38[0][d->opcode] : &map0f3a[0][d->opcode];
+            prefixFallback = 1;
+        }
+    }
+
+    u32 flags = d->flags = entry->flags;
+    if(flags&F_MODRM){
+        read_modrm(d,d->map==1 && (d->opcode&0xfc)==0x20);
+        if(d->truncated)
+            return 0;
+    }
+
+    if(flags&F_X87)
+        return decode_x87(d,insn);
+
+    // Walk down the group and prefix tables
+    const u16 * specs = entry->operands;
+    while(entry->flags&TABLE_FLAGS){
+        const x86_opcode_t * table = entry->table;
+        u32 tableFlags = entry->flags;
+
+        if(tableFlags&F_PREFIX){
+            u8 index = d->prefix;
+            if(d->encoding==ENCODING_LEGACY && index && !table[index].mnemonic && !table[index].flags){
+                // The prefix is not mandatory for this opcode, 66 falls back to the operand size
+                index = (index!=1 && d->data16>=0 && (table[1].mnemonic || table[1].flags)) ? 1 : 0;
+            }
+            entry = &table[index];
+            if(d->encoding==ENCODING_LEGACY && index==1)
+                d->usedData16 = 2;
+            else if(d->encoding==ENCODING_LEGACY && index>=2)
+                d->usedRepeat = 1;
+        }else if(tableFlags&F_GROUP)
+            entry = &table[d->reg];
+        else if(tableFlags&F_GROUPMOD)
+            entry = &table[d->mod==3 ? 8+d->reg : d->reg];
+        else if(tableFlags&F_RMGROUP)
+            entry = &table[d->rm];
+        else if(tableFlags&F_MODSPLIT)
+            entry = &table[d->mod==3];
+        else{
+            entry = &table[(d->rex&REX_W)!=0];
+            d->rexUsed |= REX_W;
+        }
+
+        flags |= entry->flags;
+        d->flags = flags;
+        if(entry->operands[0])
+            specs = entry->operands;
+    }
+    if(!entry->mnemonic)
+        return 0;
+
+    // Legacy three byte opcodes reached through their prefix consume it
+    if(d->map>=2 && d->encoding==ENCODING_LEGACY && !prefixFallback && d->prefix){
+        if(d->prefix==1)
+            d->usedData16 = 2;
+        else
+            d->usedRepeat = 1;
+    }
+
+    // Gather the operand specifications, VEX adding its vvvv register
+    u16 allSpecs[X86_MAX_OPERANDS];
+    u8 numOfSpecs=0, hasVector=0;
+    for(u8 i=0;i<4 && specs[i];i++){
+        u8 type = OP_TYPE(specs[i]);
+        hasVector |= type==OT_V || type==OT_W || type==OT_U || type==OT_H || type==OT_L || type==OT_VSIB;
+        allSpecs[numOfSpecs++] = specs[i];
+    }
+    u8 vexPrefix=0;
+    if(d->encoding!=ENCODING_LEGACY){
+        if(!(flags&F_VEX)){
+            if((flags&F_NOVEX) || !(hasVector || (flags&F_VEXOK)))
+                return 0;
+            vexPrefix = 1;
+        }
+        if((flags&(F_VH|F_VH0)) && numOfSpecs && numOfSpecs<X86_MAX_OPERANDS){
+            u8 at = (flags&F_VH0) ? 0 : 1;
+            memmove(&allSpecs[at+1],&allSpecs[at],(numOfSpecs-at)*sizeof(u16));
+            allSpecs[at] = OP(OT_H,OP_SIZE(allSpecs[at==0 ? 1 : 0]));
+            numOfSpecs++;
+        }
+        // Static rounding of the register forms works on whole zmm registers
+        if(d->encoding==ENCODING_EVEX){
+            if(d->evexB && d->mod==3){
+                insn->rounding = d->vectorLength+1;
+                d->vectorLength = 2;
+            }else if(d->vectorLength==3)
+                return 0;
+            insn->mask = d->evexMask;
+            insn->zeroing = d->evexZeroing;
+        }
+    }else if(flags&F_VEX)
+        return 0;
+
+    // Operand size: REX.W, then an unconsumed 66, pushes and pops default to 64 bits
+    if(d->rex&REX_W)
+        d->operandSize = 8;
+    else if(d->data16>=0 && d->usedData16!=2)
+        d->operandSize = 2;
+    else
+        d->operandSize = (flags&F_D64) ? 8 : 4;
+
+    // Opcodes whose name depends on more than the tables
+    const char * mnemonic = entry->mnemonic;
+    if(d->map==0 && d->opcode==0x90 && !(d->rex&REX_B)){
+        if(repeatByte==0xf3){
+            d->usedRepeat = 1;
+            mnemonic = "pause";
+            numOfSpecs = 0;
+        }else if(d->data16<0){
+            mnemonic = "nop";
+            numOfSpecs = 0;
+        }
+    }else if(d->map==0 && d->opcode==0xe3 && d->addr32>=0){
+        mnemonic = "jecxz";
+        d->usedAddr32 = 1;
+    }else if(d->map==0 && d->opcode>=0xa0 && d->opcode<=0xa3 && d->addr32>=0)
+        mnemonic = "mov";
+    select_mnemonic(d,insn,mnemonic,vexPrefix);
+
+    for(u8 i=0;i<numOfSpecs;i++){
+        u8 type = OP_TYPE(allSpecs[i]);
+        u8 size = OP_SIZE(allSpecs[i]);
+        // REX.W changes neither the branches nor the 64-bit pushes and pops
+        if(type==OT_J)
+            ;
+        else if(size==SZ_V || size==SZ_Z || size==SZ_VW || size==SZ_V64 || type==OT_IS){
+            if(!(flags&F_D64))
+                d->rexUsed |= REX_W;
+            if(d->operandSize==2)
+                d->usedData16 = 1;
+        }else if(size==SZ_Y || size==SZ_E || size==SZ_QO)
+            d->rexUsed |= REX_W;
+
+        if(!decode_operand(d,allSpecs[i],&insn->operands[insn->numOfOperands++]))
+            return 0;
+    }
+    if(d->truncated)
+        return 0;
+
+    if(flags&(F_CMP|F_CLMUL))
+        name_immediate(d,insn,flags);
+
+    return 1;
+}
+
+
+
+/* Decode the x86-64 instruction at code, located at address, with at most size bytes available.
+Returns the instruction's length, undecodable bytes are one byte long invalid instructions */
+u8 x86_decode(const u8 * code, u64 size, u64 address, x86_instruction_t * insn){
+
+    x86_decoder_t d;
+    d.code = code;
+    d.size = size;
+    d.pos = 0;
+    d.truncated = 0;
+    d.numOfPrefixBytes = 0;
+    d.data16 = d.addr32 = d.repeat = d.segment = -1;
+    d.encoding = ENCODING_LEGACY;
+    d.rex = d.rexUsed = 0;
+    d.evexR = d.evexV = 0;
+    d.map = d.prefix = d.vectorLength = d.vvvv = 0;
+    d.evexMask = d.evexZeroing = d.evexB = 0;
+    d.mod = 3;
+    d.disp8 = 0;
+    d.operandSize = 4;
+    d.flags = 0;
+    d.usedData16 = d.usedAddr32 = d.usedRepeat = d.usedSegment = 0;
+
+    insn->address = address;
+    insn->invalid = 0;
+    insn->mnemonic = NULL;
+    insn->numOfPrefixes = 0;
+    insn->numOfOperands = 0;
+    insn->mask = insn->zeroing = insn->rounding = 0;
+    insn->hasRipTarget = 0;
+
+    if(!decode_instruction(&d,insn) || d.truncated){
+        insn->invalid = 1;
+        insn->length = 1;
+        insn->mnemonic = "(bad)";
+        insn->numOfPrefixes = 0;
+        insn->numOfOperands = 0;
+        insn->mask = insn->zeroing = insn->rounding = 0;
+        return 1;
+    }
+    insn->length = d.pos;
+    list_unused_prefixes(&d,insn);
+
+    // The relative addresses count from the next instruction
+    for(u8 i=0;i<insn->numOfOperands;i++){
+        x86_operand_t * operand = &insn->operands[i];
+        if(operand->kind==X86_OPERAND_TARGET)
+            operand->value = address+insn->length+operand->displacement;
+        else if(operand->kind==X86_OPERAND_MEMORY && operand->base==REG_RIP){
+            insn->hasRipTarget = 1;
+            insn->ripTarget = address+insn->length+operand->displacement;
+        }
+    }
+
+    return insn->length;
+}
+
+
+
+/* Register names of the files which are not numbered */
+static const char * gpr64Names[18] = {"rax","rcx","rdx","rbx","rsp","rbp","rsi","rdi","r8","r9","r10","r11","r12","r13","r14","r15","riz","rip"};
+static const char * gpr32Names[18] = {"eax","ecx","edx","ebx","esp","ebp","esi","edi","r8d","r9d","r10d","r11d","r12d","r13d","r14d","r15d","eiz","eip"};
+static const char * gpr16Names[16] = {"ax","cx","dx","bx","sp","bp","si","di","r8w","r9w","r10w","r11w","r12w","r13w","r14w","r15w"};
+static const char * gpr8Names[16] = {"al","cl","dl","bl","spl","bpl","sil","dil","r8b","r9b","r10b","r11b","r12b","r13b","r14b","r15b"};
+static const char * gpr8LegacyNames[8] = {"al","cl","dl","bl","ah","ch","dh","bh"};
+static const char * segmentNames[6] = {"es","cs","ss","ds","fs","gs"};
+
+static const char * ptrNames[11] = {"","BYTE PTR ","WORD PTR ","DWORD PTR ","FWORD PTR ","QWORD PTR ","TBYTE PTR ","OWORD PTR ","XMMWORD PTR ","YMMWORD PTR ","ZMMWORD PTR "};
+
+static const char * prefixNames[16] = {"","lock","rep","repz","repnz","bnd","notrack","data16","addr32","es","cs","ss","ds","fs","gs","rex"};
+
+static const char * roundingNames[6] = {"","{rn-sae}","{rd-sae}","{ru-sae}","{rz-sae}","{sae}"};
+
+
+/* Text written within a bounded buffer */
+typedef struct text_builder{
+    u8 * text;
+    u32 size;
+    u32 length;
+}text_builder_t;
+
+
+static inline void append_char(text_builder_t * builder, u8 c){
+
+    if(builder->length+1<builder->size)
+        builder->text[builder->length++] = c;
+}
+
+
+static inline void append_string(text_builder_t * builder, const char * string){
+
+    while(*string && builder->length+1<builder->size)
+        builder->text[builder->length++] = *string++;
+}
+
+
+static void append_hex(text_builder_t * builder, u64 value){
+
+    u8 digits[16];
+    u8 numOfDigits=0;
+    do{
+        digits[numOfDigits++] = "0123456789abcdef"[value&0xf];
+        value >>= 4;
+    }while(value);
+
+    append_string(builder,"0x");
+    while(numOfDigits)
+        append_char(builder,digits[--numOfDigits]);
+}
+
+
+static void append_decimal(text_builder_t * builder, u64 value){
+
+    u8 digits[20];
+    u8 numOfDigits=0;
+    do{
+        digits[numOfDigits++] = '0'+value%10;
+        value /= 10;
+    }while(value);
+
+    while(numOfDigits)
+        append_char(builder,digits[--numOfDigits]);
+}
+
+
+/* " <symbol+0xoffset>" of the symbol containing an address, the address stays bare past the symbol's end */
+static void append_symbol(text_builder_t * builder, struct symbol_index * symbols, u64 address){
+
+    if(!symbols)
+        return;
+    s64 symbolIdx = symbol_index_lookup(symbols,address);
+    if(symbolIdx<0)
+        return;
+
+    // Symbols of unknown size cover the addresses up to the next one
+    symbol_index_entry_t * symbol = &symbols->entries[symbolIdx];
+    if(symbol->size && address-symbol->address>=symbol->size)
+        return;
+    append_string(builder," <");
+    append_string(builder,(const char *)symbol->name);
+    if(address!=symbol->address){
+        append_char(builder,'+');
+        append_hex(builder,address-symbol->address);
+    }
+    append_char(builder,'>');
+}
+
+
+static void append_register(text_builder_t * builder, u8 regFile, u8 reg){
+
+    switch(regFile){
+        case X86_REGS_GPR8: append_string(builder,gpr8Names[reg&15]); return;
+        case X86_REGS_GPR8_LEGACY: append_string(builder,gpr8LegacyNames[reg&7]); return;
+        case X86_REGS_GPR16: append_string(builder,gpr16Names[reg&15]); return;
+        case X86_REGS_GPR32: append_string(builder,gpr32Names[reg<18 ? reg : 0]); return;
+        case X86_REGS_GPR64: append_string(builder,gpr64Names[reg<18 ? reg : 0]); return;
+        case X86_REGS_SEGMENT: append_string(builder,segmentNames[reg<6 ? reg : 0]); return;
+        case X86_REGS_X87_TOP: append_string(builder,"st"); return;
+        case X86_REGS_X87:
+            append_string(builder,"st(");
+            append_decimal(builder,reg);
+            append_char(builder,')');
+            return;
+        default:
+            break;
+    }
+
+    // The numbered files
+    const char * prefix = regFile==X86_REGS_CONTROL ? "cr" : regFile==X86_REGS_DEBUG ? "dr" : regFile==X86_REGS_MMX ? "mm" :
+                          regFile==X86_REGS_XMM ? "xmm" : regFile==X86_REGS_YMM ? "ymm" : regFile==X86_REGS_ZMM ? "zmm" : "k";
+    append_string(builder,prefix);
+    append_decimal(builder,reg);
+}
+
+
+static void append_memory(text_builder_t * builder, x86_operand_t * operand){
+
+    append_string(builder,ptrNames[operand->ptr]);
+    if(operand->segment!=X86_SEGMENT_NONE){
+        append_string(builder,segmentNames[operand->segment]);
+        append_char(builder,':');
+    }
+
+    // An absolute address
+    if(operand->base==X86_NO_REGISTER && operand->index==X86_NO_REGISTER){
+        if(operand->segment==X86_SEGMENT_NONE)
+            append_string(builder,"ds:");
+        u64 address = operand->displacement;
+        append_hex(builder,operand->regFile==X86_REGS_GPR32 ? (u32)address : address);
+        return;
+    }
+
+    append_char(builder,'[');
+    if(operand->base!=X86_NO_REGISTER)
+        append_register(builder,operand->regFile,operand->base);
+    if(operand->index!=X86_NO_REGISTER){
+        if(operand->base!=X86_NO_REGISTER)
+            append_char(builder,'+');
+        append_register(builder,operand->indexFile,operand->index);
+        append_char(builder,'*');
+        append_decimal(builder,operand->scale);
+    }
+    if(operand->hasDisplacement){
+        // RIP relative displacements print unsigned
+        if(operand->displacement<0 && operand->base!=REG_RIP){
+            append_char(builder,'-');
+            append_hex(builder,-(u64)operand->displacement);
+        }else{
+            append_char(builder,'+');
+            append_hex(builder,operand->base==REG_RIP || operand->regFile!=X86_REGS_GPR32 ? (u64)operand->displacement : (u32)operand->displacement);
+        }
+    }
+    append_char(builder,']');
+
+    if(operand->broadcast){
+        append_string(builder,"{1to");
+        append_decimal(builder,operand->broadcast);
+        append_char(builder,'}');
+    }
+}
+
+
+
+/* Write the Intel syntax of a decoded instruction to text, symbols names the addresses when not NULL.
+Returns the text's length */
+u32 x86_format(x86_instruction_t * insn, struct symbol_index * symbols, u8 * text, u32 textSize){
+
+    text_builder_t builder = {text,textSize,0};
+    if(!textSize)
+        return 0;
+
+    for(u8 i=0;i<insn->numOfPrefixes;i++){
+        append_string(&builder,prefixNames[insn->prefixes[i]]);
+        if(insn->prefixes[i]==X86_PREFIX_REX && (insn->rex&0xf)){
+            append_char(&builder,'.');
+            for(u8 bit=0;bit<4;bit++)
+                if(insn->rex&(8>>bit))
+                    append_char(&builder,"WRXB"[bit]);
+        }
+        append_char(&builder,' ');
+    }
+    append_string(&builder,insn->mnemonic);
+    if(builder.length && builder.text[builder.length-1]==' ')
+        builder.length--;
+
+    if(insn->numOfOperands){
+        // The mnemonic is padded to 6 characters
+        while(builder.length<6)
+            append_char(&builder,' ');
+        append_char(&builder,' ');
+    }
+
+    // The static rounding follows the last register operand
+    s8 roundingIdx = -1;
+    for(u8 i=0;i<insn->numOfOperands;i++)
+        if(insn->operands[i].kind!=X86_OPERAND_IMMEDIATE)
+            roundingIdx = i;
+
+    for(u8 i=0;i<insn->numOfOperands;i++){
+        x86_operand_t * operand = &insn->operands[i];
+        if(i)
+            append_char(&builder,',');
+
+        switch(operand->kind){
+            case X86_OPERAND_REGISTER:
+                append_register(&builder,operand->regFile,operand->reg);
+                break;
+            case X86_OPERAND_MEMORY:
+                append_memory(&builder,operand);
+                break;
+            case X86_OPERAND_IMMEDIATE:
+                if(operand->size)
+                    append_hex(&builder,operand->value);
+                else
+                    append_decimal(&builder,operand->value);
+                break;
+            case X86_OPERAND_TARGET:
+                append_hex(&builder,operand->value);
+                append_symbol(&builder,symbols,operand->value);
+                break;
+        }
+
+        if(i==0 && insn->mask){
+            append_string(&builder,"{k");
+            append_decimal(&builder,insn->mask);
+            append_char(&builder,'}');
+        }
+        if(i==0 && insn->zeroing)
+            append_string(&builder,"{z}");
+        if(i==roundingIdx && insn->rounding)
+            append_string(&builder,roundingNames[insn->rounding]);
+    }
+
+    if(insn->hasRipTarget){
+        append_string(&builder,"        # ");
+        append_hex(&builder,insn->ripTarget);
+        append_symbol(&builder,symbols,insn->ripTarget);
+    }
+
+    builder.text[builder.length] = 0;
+    return builder.length;
+}
+
+
+
+/* Bytes of an instruction shown on its line, the others go to a continuation line */
+#define DISASM_BYTES_PER_LINE 7
+
+static void print_bytes(u8 * line, const u8 * code, u8 count){
+
+    u8 * end = line;
+    for(u8 i=0;i<count;i++){
+        *end++ = "0123456789abcdef"[code[i]>>4];
+        *end++ = "0123456789abcdef"[code[i]&0xf];
+        *end++ = ' ';
+    }
+    *end = 0;
+}
+
+
+/* Disassemble code located at address, up to maxInstructions instructions when it is not 0.
+The symbols starting at an instruction label it */
+static void disassemble_code(symbol_index_t * symbols, const u8 * code, u64 size, u64 address, u64 maxInstructions){
+
+    x86_instruction_t insn;
+    u8 text[256];
+    u8 bytes[DISASM_BYTES_PER_LINE*3+1];
+
+    // The first symbol at or after the start labels the code
+    s64 symbolIdx = symbol_index_lookup(symbols,address);
+    u64 nextSymbol = symbolIdx<0 ? 0 : (u64)symbolIdx;
+    if(symbolIdx>=0 && symbols->entries[symbolIdx].address<address)
+        nextSymbol++;
+
+    u64 offset=0, numOfInstructions=0;
+    while(offset<size && (!maxInstructions || numOfInstructions<maxInstructions)){
+        u64 pc = address+offset;
+
+        while(nextSymbol<symbols->numOfEntries && symbols->entries[nextSymbol].address<pc)
+            nextSymbol++;
+        if(nextSymbol<symbols->numOfEntries && symbols->entries[nextSymbol].address==pc)
+            fprintf(display_output(),"\n0x%016llx <%s>:\n",pc,symbols->entries[nextSymbol].name);
+
+        u8 length = x86_decode(code+offset,size-offset,pc,&insn);
+        x86_format(&insn,symbols,text,sizeof(text));
+
+        print_bytes(bytes,code+offset,length<DISASM_BYTES_PER_LINE ? length : DISASM_BYTES_PER_LINE);
+        fprintf(display_output(),"0x%016llx  %-*s %s\n",pc,DISASM_BYTES_PER_LINE*3,bytes,text);
+        if(length>DISASM_BYTES_PER_LINE){
+            print_bytes(bytes,code+offset+DISASM_BYTES_PER_LINE,length-DISASM_BYTES_PER_LINE);
+            fprintf(display_output(),"0x%016llx  %s\n",pc+DISASM_BYTES_PER_LINE,bytes);
+        }
+
+        offset += length;
+        numOfInstructions++;
+    }
+}
+
+
+/* Find the executable section holding a virtual address, returns -1 if there is none */
+static s64 find_code_section(kvelf_basic_params_t * kvelfp, u64 address){
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+        if((section->sFlags&SHF_EXECINSTR) && section->sType!=SHT_NOBITS &&
+           address>=section->sVAddr && address-section->sVAddr<section->sSize)
+            return i;
+    }
+    return -1;
+}
+
+
+
+/* Disassemble the executable sections, a symbol ("dis SYMBOL [COUNT]") or COUNT instructions
+at an address ("dis ADDR [COUNT]") */
+void disassemble(kvelf_basic_params_t * kvelfp, u8 * query){
+
+    if(!kvelfp->elfImage){
+        debug("dis needs the file mapped in memory\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+    if(kvelfp->elfMachine!=EM_X86_64){
+        debug("dis decodes x86-64 code only\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    u8 * savePtr;
+    u8 * target = strtok_r(query," \t\n",(char **)&savePtr);
+    u8 * countStr = target ? strtok_r(NULL," \t\n",(char **)&savePtr) : NULL;
+    u64 count=0;
+    if(countStr){
+        u8 * countEnd;
+        count = strtoull(countStr,(char **)&countEnd,0);
+        if(!count || *countEnd || strtok_r(NULL," \t\n",(char **)&savePtr)){
+            debug("Usage: dis [SYMBOL|ADDR [COUNT]], COUNT > 0\n",DEBUG_STATUS_ERROR);
+            return;
+        }
+    }
+
+    symbol_index_t * symbols = symbol_get_index(kvelfp);
+
+    // The whole code
+    if(!target){
+        for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+            section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+            u64 contentsSize;
+            u8 * contents;
+            if(!(section->sFlags&SHF_EXECINSTR) || !(contents=get_section_contents(kvelfp,i,&contentsSize)) || !contentsSize)
+                continue;
+
+            fprintf(display_output(),"\nDisassembly of section %s:\n",get_section_name(kvelfp,i));
+            disassemble_code(symbols,contents,contentsSize,section->sVAddr,0);
+        }
+        return;
+    }
+
+    // A symbol's bytes, or instructions from an address
+    u64 address, size=0;
+    u8 * addressEnd;
+    s64 symbolIdx = symbol_index_find_name(symbols,target);
+    if(symbolIdx>=0){
+        address = symbols->entries[symbolIdx].address;
+        size = symbols->entries[symbolIdx].size;
+    }else{
+        address = strtoull(target,(char **)&addressEnd,0);
+        if(*addressEnd){
+            display_error("No symbol \"%s\"\n",target);
+            return;
+        }
+    }
+
+    s64 sectionIdx = find_code_section(kvelfp,address);
+    u64 contentsSize;
+    u8 * contents = sectionIdx<0 ? NULL : get_section_contents(kvelfp,sectionIdx,&contentsSize);
+    if(!contents){
+        display_error("No executable section holds 0x%llx\n",address);
+        return;
+    }
+
+    u64 offset = address-kvelfp->elfSectionsMetadata[sectionIdx].sVAddr;
+    u64 available = contentsSize>offset ? contentsSize-offset : 0;
+    if(!count && size)
+        available = size<available ? size : available;
+    else if(!count)
+        count = DISASM_DEFAULT_COUNT;
+
+    disassemble_code(symbols,contents+offset,available,address,count);
+}
@@ -0,0 +1,126 @@
+#ifndef DISASM_H
+#define DISASM_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Longest valid x86 instruction */
+#define X86_MAX_INSTRUCTION_LENGTH 15
+
+#define X86_MAX_OPERANDS 5
+
+/* Instructions listed by "dis ADDR" without a count */
+#define DISASM_DEFAULT_COUNT 32
+
+/* Kinds of operands */
+#define X86_OPERAND_NONE 0
+#define X86_OPERAND_REGISTER 1
+#define X86_OPERAND_MEMORY 2
+#define X86_OPERAND_IMMEDIATE 3
+#define X86_OPERAND_TARGET 4		/* Absolute address of a relative branch */
+
+/* Register files */
+#define X86_REGS_GPR8 0		/* al..r15b, spl..dil with a REX prefix */
+#define X86_REGS_GPR8_LEGACY 1	/* al..bh, ah..bh without a REX prefix */
+#define X86_REGS_GPR16 2
+#define X86_REGS_GPR32 3
+#define X86_REGS_GPR64 4
+#define X86_REGS_SEGMENT 5
+#define X86_REGS_CONTROL 6
+#define X86_REGS_DEBUG 7
+#define X86_REGS_MMX 8
+#define X86_REGS_XMM 9
+#define X86_REGS_YMM 10
+#define X86_REGS_ZMM 11
+#define X86_REGS_MASK 12
+#define X86_REGS_X87 13		/* st(i) */
+#define X86_REGS_X87_TOP 14	/* st */
+#define X86_REGS_RIP 15
+#define X86_REGS_BOUND 16
+
+/* No base or index register of a memory operand */
+#define X86_NO_REGISTER 0xff
+
+/* Segment registers, in the order of their encoding */
+#define X86_SEGMENT_ES 0
+#define X86_SEGMENT_CS 1
+#define X86_SEGMENT_SS 2
+#define X86_SEGMENT_DS 3
+#define X86_SEGMENT_FS 4
+#define X86_SEGMENT_GS 5
+#define X86_SEGMENT_NONE 0xff
+
+
+/* Operand of a decoded instruction */
+typedef struct x86_operand{
+	u8 kind;			/* X86_OPERAND_* */
+	u8 regFile;			/* X86_REGS_* of a register operand, of the base and the index of a memory operand */
+	u8 reg;				/* Register number */
+	u8 ptr;				/* Size keyword of a memory operand, 0 for none */
+	u16 size;			/* Size in bytes of the operand */
+	u8 segment;			/* Segment of a memory operand, X86_SEGMENT_NONE for the default one */
+	u8 base;			/* Base register of a memory operand, X86_NO_REGISTER for none */
+	u8 index;			/* Index register of a memory operand, X86_NO_REGISTER for none */
+	u8 indexFile;		/* X86_REGS_* of the index, vector registers for the gathers */
+	u8 scale;			/* 1, 2, 4 or 8 */
+	u8 hasDisplacement;
+	u8 broadcast;		/* EVEX {1toN} of a memory operand, 0 for none */
+	s64 displacement;
+	u64 value;			/* Immediate value or branch target */
+}x86_operand_t;
+
+
+/* Decoded instruction */
+typedef struct x86_instruction{
+	u64 address;		/* Virtual address of the instruction */
+	u8 length;			/* Number of bytes, at least 1 even for the undecodable bytes */
+	u8 invalid;			/* Whether the bytes are no instruction */
+	const char * mnemonic;
+	u8 mnemonicBuffer[24];	/* Storage of the mnemonics composed at decoding time */
+	u8 prefixes[X86_MAX_INSTRUCTION_LENGTH];	/* X86_PREFIX_* printed before the mnemonic, in their order */
+	u8 numOfPrefixes;
+	u8 rex;			/* REX byte, printed when X86_PREFIX_REX is listed */
+	u8 numOfOperands;
+	x86_operand_t operands[X86_MAX_OPERANDS];
+	u8 mask;			/* EVEX opmask register of the destination, 0 for none */
+	u8 zeroing;			/* EVEX {z} */
+	u8 rounding;		/* EVEX static rounding: 0 for none, 1 + the mode, or 5 for {sae} */
+	u8 hasRipTarget;	/* Whether an operand is RIP relative */
+	u64 ripTarget;		/* Address of the RIP relative operand */
+}x86_instruction_t;
+
+/* Prefixes printed before the mnemonic, those the instruction did not use */
+#define X86_PREFIX_LOCK 1
+#define X86_PREFIX_REP 2
+#define X86_PREFIX_REPZ 3
+#define X86_PREFIX_REPNZ 4
+#define X86_PREFIX_BND 5		/* F2 of a branch */
+#define X86_PREFIX_NOTRACK 6	/* 3E of an indirect branch */
+#define X86_PREFIX_DATA16 7
+#define X86_PREFIX_ADDR32 8
+#define X86_PREFIX_ES 9
+#define X86_PREFIX_CS 10
+#define X86_PREFIX_SS 11
+#define X86_PREFIX_DS 12
+#define X86_PREFIX_FS 13
+#define X86_PREFIX_GS 14
+#define X86_PREFIX_REX 15
+
+
+
+/* Decode the x86-64 instruction at code, located at address, with at most size bytes available.
+Returns the instruction's length, undecodable bytes are one byte long invalid instructions */
+u8 x86_decode(const u8 * code, u64 size, u64 address, x86_instruction_t * insn);
+
+/* Write the Intel syntax of a decoded instruction to text, symbols names the addresses when not NULL.
+Returns the text's length */
+u32 x86_format(x86_instruction_t * insn, struct symbol_index * symbols, u8 * text, u32 textSize);
+
+/* Disassemble the executable sections, a symbol ("dis SYMBOL [COUNT]") or COUNT instructions
+at an address ("dis ADDR [COUNT]") */
+void disassemble(kvelf_basic_params_t * kvelfp, u8 * query);
+
+
+#endif
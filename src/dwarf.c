@@ -0,0 +1,639 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./dwarf.h"
+
+
+/* Longest line accepted by the batch mode of addr2line */
+#define DWARF_ADDR2LINE_LINE_MAX_LENGTH 256
+
+/* Most entry formats a DWARF 5 directory or file name table can describe */
+#define DWARF_LINE_MAX_ENTRY_FORMATS 256
+
+
+
+/* A row while the table is being built, split into columns once it is sorted */
+typedef struct dwarf_line_row{
+    u64 address;
+    u32 file;
+    u32 line;
+}dwarf_line_row_t;
+
+
+/* State shared by the decoding of all the units */
+typedef struct dwarf_line_builder{
+    dwarf_line_row_t * rows;    /* Rows emitted so far */
+    u64 numOfRows;
+    u64 rowsCapacity;
+    u8 ** fileNames;            /* Paths of the files of all the units */
+    u32 numOfFiles;
+    u32 filesCapacity;
+    dwarf_strings_t * strings;  /* String sections referenced by the headers */
+}dwarf_line_builder_t;
+
+
+
+/* Get the contents of a DWARF section by its name, returns NULL if it is missing or cannot be read */
+u8 * dwarf_get_section(kvelf_basic_params_t * kvelfp, u8 * sectionName, u64 * contentsSize){
+
+    s64 sectionIdx = find_section_by_name(kvelfp,sectionName);
+
+    *contentsSize=0;
+    if(sectionIdx<0)
+        return NULL;
+
+    if(kvelfp->elfSectionsMetadata[sectionIdx].sFlags & SHF_COMPRESSED){
+        fprintf(display_output(),"%s[WARN]%s %s is compressed, compressed sections are not supported\n",display_color_sequence(DISPLAY_COLOR_ORANGE),display_reset_sequence(),sectionName);
+        return NULL;
+    }
+
+    return get_section_contents(kvelfp,sectionIdx,contentsSize);
+}
+
+
+/* Get a string at the given offset of a string section, NULL if it is not terminated inside the section */
+static u8 * dwarf_string_at(u8 * section, u64 sectionSize, u64 offset){
+
+    if(!section || offset>=sectionSize || !memchr(section+offset,0,sectionSize-offset))
+        return NULL;
+
+    return section+offset;
+}
+
+
+/* Add a file path to the table, returns its index */
+static u32 add_line_file(dwarf_line_builder_t * builder, u8 * directory, u8 * fileName){
+
+    if(builder->numOfFiles==builder->filesCapacity){
+        builder->filesCapacity = builder->filesCapacity ? builder->filesCapacity*2 : 256;
+        builder->fileNames = realloc(builder->fileNames,builder->filesCapacity*sizeof(u8 *));
+    }
+
+    // The table owns its paths, relative names are joined with their directory
+    u8 * path;
+    if(!fileName)
+        path = strdup("??");
+    else if(!directory || !directory[0] || fileName[0]=='/')
+        path = strdup(fileName);
+    else{
+        u64 directoryLength = strlen(directory);
+        u64 fileNameLength = strlen(fileName);
+        path = malloc(directoryLength+fileNameLength+2);
+        memcpy(path,directory,directoryLength);
+        path[directoryLength]='/';
+        memcpy(path+directoryLength+1,fileName,fileNameLength+1);
+    }
+
+    builder->fileNames[builder->numOfFiles]=path;
+    return builder->numOfFiles++;
+}
+
+
+/* Emit a row of the line number matrix */
+static void emit_line_row(dwarf_line_builder_t * builder, u64 sequenceStart, u64 address, u32 file, u32 line){
+
+    // A row at the same address as the previous row of its sequence replaces it
+    if(builder->numOfRows>sequenceStart && builder->rows[builder->numOfRows-1].address==address){
+        builder->rows[builder->numOfRows-1].file=file;
+        builder->rows[builder->numOfRows-1].line=line;
+        return;
+    }
+
+    if(builder->numOfRows==builder->rowsCapacity){
+        builder->rowsCapacity*=2;
+        builder->rows = realloc(builder->rows,builder->rowsCapacity*sizeof(dwarf_line_row_t));
+    }
+
+    builder->rows[builder->numOfRows].address=address;
+    builder->rows[builder->numOfRows].file=file;
+    builder->rows[builder->numOfRows].line=line;
+    builder->numOfRows++;
+}
+
+
+/* Read a value of a DWARF 5 entry format, returns 0 for the forms a line table header cannot use */
+static u8 read_line_entry_value(data_reader_t * unit, u64 form, u8 is64, dwarf_strings_t * strings, u64 * value, u8 ** string){
+
+    *value=0;
+    *string=NULL;
+
+    switch(form){
+        case DW_FORM_string:
+            *string = reader_string(unit);
+            return 1;
+        case DW_FORM_line_strp:
+            *string = dwarf_string_at(strings->debugLineStr,strings->debugLineStrSize,reader_uint(unit,is64 ? 8 : 4));
+            return 1;
+        case DW_FORM_strp:
+            *string = dwarf_string_at(strings->debugStr,strings->debugStrSize,reader_uint(unit,is64 ? 8 : 4));
+            return 1;
+        case DW_FORM_udata:
+            *value = reader_uleb128(unit);
+            return 1;
+        case DW_FORM_data1:
+            *value = reader_u8(unit);
+            return 1;
+        case DW_FORM_data2:
+            *value = reader_u16(unit);
+            return 1;
+        case DW_FORM_data4:
+            *value = reader_u32(unit);
+            return 1;
+        case DW_FORM_data8:
+            *value = reader_u64(unit);
+            return 1;
+        case DW_FORM_data16:
+            reader_skip(unit,16);
+            return 1;
+        case DW_FORM_block:
+            reader_skip(unit,reader_uleb128(unit));
+            return 1;
+        // Indexed strings need the unit's .debug_str_offsets base, which the line table does not know
+        case DW_FORM_strx:
+            reader_uleb128(unit);
+            return 1;
+        case DW_FORM_strx1:
+            reader_skip(unit,1);
+            return 1;
+        case DW_FORM_strx2:
+            reader_skip(unit,2);
+            return 1;
+        case DW_FORM_strx3:
+            reader_skip(unit,3);
+            return 1;
+        case DW_FORM_strx4:
+            reader_skip(unit,4);
+            return 1;
+    }
+
+    return 0;
+}
+
+
+/* Read a DWARF 5 directory or file name table, returns the number of entries or -1 on error */
+static s64 read_line_entries(data_reader_t * unit, u8 is64, dwarf_strings_t * strings, u8 *** paths, u64 ** directoryIdxs){
+
+    u64 contentTypes[DWARF_LINE_MAX_ENTRY_FORMATS];
+    u64 forms[DWARF_LINE_MAX_ENTRY_FORMATS];
+
+    *paths=NULL;
+    *directoryIdxs=NULL;
+
+    u8 numOfFormats = reader_u8(unit);
+    for(u32 i=0;i<numOfFormats;i++){
+        contentTypes[i]=reader_uleb128(unit);
+        forms[i]=reader_uleb128(unit);
+    }
+
+    u64 numOfEntries = reader_uleb128(unit);
+
+    // Every entry takes at least a byte, a larger count is corrupted
+    if(unit->error || numOfEntries>reader_left(unit)+1)
+        return -1;
+
+    *paths = calloc(numOfEntries+1,sizeof(u8 *));
+    *directoryIdxs = calloc(numOfEntries+1,sizeof(u64));
+
+    for(u64 i=0;i<numOfEntries;i++){
+        for(u32 j=0;j<numOfFormats;j++){
+            u64 value;
+            u8 * string;
+
+            if(!read_line_entry_value(unit,forms[j],is64,strings,&value,&string))
+                return -1;
+
+            if(contentTypes[j]==DW_LNCT_path)
+                (*paths)[i]=string;
+            else if(contentTypes[j]==DW_LNCT_directory_index)
+                (*directoryIdxs)[i]=value;
+        }
+    }
+
+    return unit->error ? -1 : (s64)numOfEntries;
+}
+
+
+/* Decode one unit of .debug_line, runs its line number program and emits its rows */
+static void decode_line_unit(dwarf_line_builder_t * builder, data_reader_t * unit, u8 is64){
+
+    u16 version = reader_u16(unit);
+    if(version<2 || version>5)
+        return;
+
+    // Address and segment selector sizes, set_address gives the size of its operand anyway
+    if(version>=5)
+        reader_skip(unit,2);
+
+    u64 headerLength = reader_uint(unit,is64 ? 8 : 4);
+    if(headerLength>reader_left(unit))
+        return;
+    u8 * programStart = unit->pos + headerLength;
+
+    u8 minInstLength = reader_u8(unit);
+    if(version>=4)
+        reader_u8(unit);
+    reader_u8(unit);
+    s8 lineBase = (s8)reader_u8(unit);
+    u8 lineRange = reader_u8(unit);
+    u8 opcodeBase = reader_u8(unit);
+    u8 * standardOpcodeLengths = unit->pos;
+
+    if(lineRange==0 || opcodeBase==0)
+        return;
+    reader_skip(unit,opcodeBase-1);
+
+    // Unit's file numbers mapped to the indices of the table's file names
+    u32 * unitFiles = NULL;
+    u64 numOfUnitFiles = 0;
+    u8 firstFileNumber;
+
+    if(version>=5){
+
+        u8 ** directories;
+        u64 * unused;
+        s64 numOfDirectories = read_line_entries(unit,is64,builder->strings,&directories,&unused);
+        free(unused);
+        if(numOfDirectories<0){
+            free(directories);
+            return;
+        }
+
+        u8 ** fileNames;
+        u64 * directoryIdxs;
+        s64 numOfFileNames = read_line_entries(unit,is64,builder->strings,&fileNames,&directoryIdxs);
+        if(numOfFileNames<0){
+            free(directories);
+            free(fileNames);
+            free(directoryIdxs);
+            return;
+        }
+
+        unitFiles = malloc((numOfFileNames+1)*sizeof(u32));
+        for(s64 i=0;i<numOfFileNames;i++)
+            unitFiles[i]=add_line_file(builder,directoryIdxs[i]<(u64)numOfDirectories ? directories[directoryIdxs[i]] : NULL,fileNames[i]);
+        numOfUnitFiles=numOfFileNames;
+
+        free(directories);
+        free(fileNames);
+        free(directoryIdxs);
+
+        // DWARF 5 numbers the files from 0
+        firstFileNumber=0;
+    }else{
+
+        // Directory 0 is the compilation directory, which the line table does not name
+        u64 directoriesCapacity=16;
+        u64 numOfDirectories=1;
+        u8 ** directories = malloc(directoriesCapacity*sizeof(u8 *));
+        directories[0]=NULL;
+
+        u8 * directory;
+        while((directory=reader_string(unit)) && directory[0]){
+            if(numOfDirectories==directoriesCapacity){
+                directoriesCapacity*=2;
+                directories = realloc(directories,directoriesCapacity*sizeof(u8 *));
+            }
+            directories[numOfDirectories++]=directory;
+        }
+
+        u64 filesCapacity=16;
+        unitFiles = malloc(filesCapacity*sizeof(u32));
+
+        u8 * fileName;
+        while((fileName=reader_string(unit)) && fileName[0]){
+            u64 directoryIdx = reader_uleb128(unit);
+            // Modification time and length
+            reader_uleb128(unit);
+            reader_uleb128(unit);
+
+            if(numOfUnitFiles==filesCapacity){
+                filesCapacity*=2;
+                unitFiles = realloc(unitFiles,filesCapacity*sizeof(u32));
+            }
+            unitFiles[numOfUnitFiles++]=add_line_file(builder,directoryIdx<numOfDirectories ? directories[directoryIdx] : NULL,fileName);
+        }
+
+        free(directories);
+
+        // Earlier versions number the files from 1
+        firstFileNumber=1;
+    }
+
+    // The program starts where the header says, whatever the header held in between
+    if(programStart>unit->end){
+        free(unitFiles);
+        return;
+    }
+    unit->pos=programStart;
+
+    /* Running the line number program */
+
+    u64 address=0;
+    u64 fileNumber=1;
+    s64 line=1;
+    u64 sequenceStart=builder->numOfRows;
+
+    // Files outside the unit's table resolve to the unknown file
+    #define UNIT_FILE(number) ((number)-firstFileNumber<numOfUnitFiles ? unitFiles[(number)-firstFileNumber] : 0)
+
+    while(unit->pos<unit->end && !unit->error){
+
+        u8 opcode = reader_u8(unit);
+
+        if(opcode>=opcodeBase){
+            // Special opcodes advance both the address and the line, then append a row
+            u8 adjustedOpcode = opcode-opcodeBase;
+            address += (u64)(adjustedOpcode/lineRange)*minInstLength;
+            line += lineBase + adjustedOpcode%lineRange;
+            emit_line_row(builder,sequenceStart,address,UNIT_FILE(fileNumber),(u32)line);
+            continue;
+        }
+
+        switch(opcode){
+            case 0:{
+                // Extended opcodes carry their own length
+                u64 length = reader_uleb128(unit);
+                if(length==0 || length>reader_left(unit)){
+                    unit->error=1;
+                    break;
+                }
+                u8 * next = unit->pos+length;
+                u8 extendedOpcode = reader_u8(unit);
+
+                if(extendedOpcode==DW_LNE_end_sequence){
+                    emit_line_row(builder,sequenceStart,address,DWARF_LINE_END_SEQUENCE,0);
+                    sequenceStart=builder->numOfRows;
+                    address=0;
+                    fileNumber=1;
+                    line=1;
+                }else if(extendedOpcode==DW_LNE_set_address)
+                    address = reader_uint(unit,length-1);
+
+                unit->pos=next;
+                break;
+            }
+            case DW_LNS_copy:
+                emit_line_row(builder,sequenceStart,address,UNIT_FILE(fileNumber),(u32)line);
+                break;
+            case DW_LNS_advance_pc:
+                address += reader_uleb128(unit)*minInstLength;
+                break;
+            case DW_LNS_advance_line:
+                line += reader_sleb128(unit);
+                break;
+            case DW_LNS_set_file:
+                fileNumber = reader_uleb128(unit);
+                break;
+            case DW_LNS_const_add_pc:
+                address += (u64)((255-opcodeBase)/lineRange)*minInstLength;
+                break;
+            case DW_LNS_fixed_advance_pc:
+                address += reader_u16(unit);
+                break;
+            case DW_LNS_negate_stmt:
+            case DW_LNS_set_basic_block:
+            case DW_LNS_set_prologue_end:
+            case DW_LNS_set_epilogue_begin:
+                break;
+            default:
+                // Column, ISA and the opcodes this decoder does not know take ULEB128 operands
+                for(u8 i=0;i<standardOpcodeLengths[opcode-1];i++)
+                    reader_uleb128(unit);
+                break;
+        }
+    }
+
+    #undef UNIT_FILE
+
+    free(unitFiles);
+}
+
+
+/* Whether a row has to come before another one, the end of a sequence goes before a row starting at the same address */
+static u8 line_row_before(dwarf_line_row_t * a, dwarf_line_row_t * b){
+    return a->address<b->address || (a->address==b->address && a->file==DWARF_LINE_END_SEQUENCE && b->file!=DWARF_LINE_END_SEQUENCE);
+}
+
+
+/* Sort the rows, the sequences are already sorted so they are merged as natural runs */
+static dwarf_line_row_t * sort_line_rows(dwarf_line_row_t * rows, u64 numOfRows){
+
+    dwarf_line_row_t * merged = malloc(numOfRows*sizeof(dwarf_line_row_t));
+    u64 numOfRuns;
+
+    do{
+        numOfRuns=0;
+        u64 i=0;
+
+        while(i<numOfRows){
+
+            // Two adjacent runs are merged into the other buffer
+            u64 middle=i+1;
+            while(middle<numOfRows && !line_row_before(&rows[middle],&rows[middle-1]))
+                middle++;
+            u64 end=middle;
+            if(middle<numOfRows){
+                end++;
+                while(end<numOfRows && !line_row_before(&rows[end],&rows[end-1]))
+                    end++;
+            }
+
+            u64 left=i, right=middle, out=i;
+            while(left<middle && right<end)
+                merged[out++] = line_row_before(&rows[right],&rows[left]) ? rows[right++] : rows[left++];
+            memcpy(merged+out,rows+left,(middle-left)*sizeof(dwarf_line_row_t));
+            out+=middle-left;
+            memcpy(merged+out,rows+right,(end-right)*sizeof(dwarf_line_row_t));
+
+            i=end;
+            numOfRuns++;
+        }
+
+        dwarf_line_row_t * swap=rows;
+        rows=merged;
+        merged=swap;
+
+    }while(numOfRuns>1);
+
+    free(merged);
+    return rows;
+}
+
+
+/* Decode the whole .debug_line section into a sorted line table */
+dwarf_line_table_t * dwarf_decode_line_table(u8 * debugLine, u64 debugLineSize, dwarf_strings_t * strings, u8 needsSwap){
+
+    dwarf_line_builder_t builder;
+    builder.rowsCapacity = debugLineSize/4+16;
+    builder.rows = malloc(builder.rowsCapacity*sizeof(dwarf_line_row_t));
+    builder.numOfRows = 0;
+    builder.fileNames = NULL;
+    builder.numOfFiles = 0;
+    builder.filesCapacity = 0;
+    builder.strings = strings;
+
+    // The rows of unknown files point at the first file
+    add_line_file(&builder,NULL,NULL);
+
+    data_reader_t section;
+    reader_init(&section,debugLine,debugLineSize,needsSwap);
+
+    while(reader_left(&section)>0 && !section.error){
+
+        u8 is64=0;
+        u64 unitLength = reader_u32(&section);
+        if(unitLength==0xffffffff){
+            unitLength = reader_u64(&section);
+            is64=1;
+        }
+        if(section.error || unitLength>reader_left(&section)){
+            debug("Truncated .debug_line unit\n",DEBUG_STATUS_WARNING);
+            break;
+        }
+
+        data_reader_t unit;
+        reader_init(&unit,section.pos,unitLength,needsSwap);
+        decode_line_unit(&builder,&unit,is64);
+
+        reader_skip(&section,unitLength);
+    }
+
+    dwarf_line_table_t * lineTable = malloc(sizeof(dwarf_line_table_t));
+    lineTable->numOfRows = builder.numOfRows;
+    lineTable->numOfFiles = builder.numOfFiles;
+    lineTable->fileNames = builder.fileNames;
+
+    // Splitting the sorted rows into columns, lookups only touch the addresses
+    lineTable->addresses = malloc((builder.numOfRows+1)*sizeof(u64));
+    lineTable->files = malloc((builder.numOfRows+1)*sizeof(u32));
+    lineTable->lines = malloc((builder.numOfRows+1)*sizeof(u32));
+
+    if(builder.numOfRows)
+        builder.rows = sort_line_rows(builder.rows,builder.numOfRows);
+
+    for(u64 i=0;i<builder.numOfRows;i++){
+        lineTable->addresses[i]=builder.rows[i].address;
+        lineTable->files[i]=builder.rows[i].file;
+        lineTable->lines[i]=builder.rows[i].line;
+    }
+    free(builder.rows);
+
+    return lineTable;
+}
+
+
+/* Find the row covering the given address, returns -1 if no line covers it */
+s64 dwarf_lookup_line(dwarf_line_table_t * lineTable, u64 address){
+
+    if(!lineTable->numOfRows || address<lineTable->addresses[0])
+        return -1;
+
+    // Branchless search for the last row at or below the address
+    u64 * addresses = lineTable->addresses;
+    u64 base=0, count=lineTable->numOfRows;
+    while(count>1){
+        u64 half=count/2;
+        base = (addresses[base+half]<=address) ? base+half : base;
+        count-=half;
+    }
+
+    if(lineTable->files[base]==DWARF_LINE_END_SEQUENCE)
+        return -1;
+
+    return base;
+}
+
+
+/* Get the line table of the file, decoding it on the first call */
+dwarf_line_table_t * dwarf_get_line_table(kvelf_basic_params_t * kvelfp){
+
+    if(kvelfp->lineTable)
+        return kvelfp->lineTable;
+
+    u64 debugLineSize;
+    u8 * debugLine = dwarf_get_section(kvelfp,".debug_line",&debugLineSize);
+    if(!debugLine){
+        debug("No .debug_line section to resolve the addresses with\n",DEBUG_STATUS_ERROR);
+        return NULL;
+    }
+
+    dwarf_strings_t strings;
+    strings.debugStr = dwarf_get_section(kvelfp,".debug_str",&strings.debugStrSize);
+    strings.debugLineStr = dwarf_get_section(kvelfp,".debug_line_str",&strings.debugLineStrSize);
+
+    kvelfp->lineTable = dwarf_decode_line_table(debugLine,debugLineSize,&strings,ELF_NEEDS_SWAP(kvelfp->elfEncoding));
+
+    return kvelfp->lineTable;
+}
+
+
+/* Free a line table and the paths of its files */
+void dwarf_line_table_free(dwarf_line_table_t * lineTable){
+
+    if(!lineTable)
+        return;
+
+    for(u32 i=0;i<lineTable->numOfFiles;i++)
+        free(lineTable->fileNames[i]);
+    free(lineTable->fileNames);
+    free(lineTable->addresses);
+    free(lineTable->files);
+    free(lineTable->lines);
+    free(lineTable);
+}
+
+
+/* Print the file:line of an address */
+static void print_address_line(dwarf_line_table_t * lineTable, u8 * addressStr){
+
+    u8 * end;
+    u64 address = strtoull(addressStr,(char **)&end,16);
+
+    if(end==addressStr || *end){
+        display_error("Invalid address \"%s\"\n",addressStr);
+        return;
+    }
+
+    s64 row = dwarf_lookup_line(lineTable,address);
+    if(row<0)
+        fprintf(display_output(),"0x%016llx ??:0\n",address);
+    else
+        fprintf(display_output(),"0x%016llx %s:%u\n",address,lineTable->fileNames[lineTable->files[row]],lineTable->lines[row]);
+}
+
+
+/* Resolve the given addresses to file:line, "-" reads the addresses from stdin until an empty line */
+void dwarf_addr2line(kvelf_basic_params_t * kvelfp, u8 * addresses){
+
+    u8 * savePtr;
+    u8 * addressStr = strtok_r(addresses," \t\n",(char **)&savePtr);
+    if(!addressStr){
+        debug("Usage: addr2line ADDR... | addr2line -\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    dwarf_line_table_t * lineTable = dwarf_get_line_table(kvelfp);
+    if(!lineTable)
+        return;
+
+    if(strcmp(addressStr,"-")==0){
+
+        u8 line[DWARF_ADDR2LINE_LINE_MAX_LENGTH];
+        while(fgets(line,DWARF_ADDR2LINE_LINE_MAX_LENGTH,display_input())){
+            u8 * lineAddressStr = strtok_r(line," \t\n",(char **)&savePtr);
+            if(!lineAddressStr)
+                break;
+            print_address_line(lineTable,lineAddressStr);
+        }
+        return;
+    }
+
+    for(;addressStr;addressStr=strtok_r(NULL," \t\n",(char **)&savePtr))
+        print_address_line(lineTable,addressStr);
+}
@@ -0,0 +1,269 @@
+#ifndef DWARF_H
+#define DWARF_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Standard opcodes of the line number program */
+#define DW_LNS_copy 0x01
+#define DW_LNS_advance_pc 0x02
+#define DW_LNS_advance_line 0x03
+#define DW_LNS_set_file 0x04
+#define DW_LNS_set_column 0x05
+#define DW_LNS_negate_stmt 0x06
+#define DW_LNS_set_basic_block 0x07
+#define DW_LNS_const_add_pc 0x08
+#define DW_LNS_fixed_advance_pc 0x09
+#define DW_LNS_set_prologue_end 0x0a
+#define DW_LNS_set_epilogue_begin 0x0b
+#define DW_LNS_set_isa 0x0c
+
+/* Extended opcodes of the line number program */
+#define DW_LNE_end_sequence 0x01
+#define DW_LNE_set_address 0x02
+#define DW_LNE_define_file 0x03
+#define DW_LNE_set_discriminator 0x04
+
+/* Content types of the DWARF 5 directory and file name entries */
+#define DW_LNCT_path 0x1
+#define DW_LNCT_directory_index 0x2
+#define DW_LNCT_timestamp 0x3
+#define DW_LNCT_size 0x4
+#define DW_LNCT_MD5 0x5
+
+/* Attribute forms */
+#define DW_FORM_addr 0x01
+#define DW_FORM_block2 0x03
+#define DW_FORM_block4 0x04
+#define DW_FORM_data2 0x05
+#define DW_FORM_data4 0x06
+#define DW_FORM_data8 0x07
+#define DW_FORM_string 0x08
+#define DW_FORM_block 0x09
+#define DW_FORM_block1 0x0a
+#define DW_FORM_data1 0x0b
+#define DW_FORM_flag 0x0c
+#define DW_FORM_sdata 0x0d
+#define DW_FORM_strp 0x0e
+#define DW_FORM_udata 0x0f
+#define DW_FORM_ref_addr 0x10
+#define DW_FORM_ref1 0x11
+#define DW_FORM_ref2 0x12
+#define DW_FORM_ref4 0x13
+#define DW_FORM_ref8 0x14
+#define DW_FORM_ref_udata 0x15
+#define DW_FORM_indirect 0x16
+#define DW_FORM_sec_offset 0x17
+#define DW_FORM_exprloc 0x18
+#define DW_FORM_flag_present 0x19
+#define DW_FORM_strx 0x1a
+#define DW_FORM_addrx 0x1b
+#define DW_FORM_ref_sup4 0x1c
+#define DW_FORM_strp_sup 0x1d
+#define DW_FORM_data16 0x1e
+#define DW_FORM_line_strp 0x1f
+#define DW_FORM_ref_sig8 0x20
+#define DW_FORM_implicit_const 0x21
+#define DW_FORM_loclistx 0x22
+#define DW_FORM_rnglistx 0x23
+#define DW_FORM_ref_sup8 0x24
+#define DW_FORM_strx1 0x25
+#define DW_FORM_strx2 0x26
+#define DW_FORM_strx3 0x27
+#define DW_FORM_strx4 0x28
+#define DW_FORM_addrx1 0x29
+#define DW_FORM_addrx2 0x2a
+#define DW_FORM_addrx3 0x2b
+#define DW_FORM_addrx4 0x2c
+
+/* GNU extension forms of the split DWARF and dwz files */
+#define DW_FORM_GNU_addr_index 0x1f01
+#define DW_FORM_GNU_str_index 0x1f02
+#define DW_FORM_GNU_ref_alt 0x1f20
+#define DW_FORM_GNU_strp_alt 0x1f21
+
+/* Unit types of the DWARF 5 unit headers */
+#define DW_UT_compile 0x01
+#define DW_UT_type 0x02
+#define DW_UT_partial 0x03
+#define DW_UT_skeleton 0x04
+#define DW_UT_split_compile 0x05
+#define DW_UT_split_type 0x06
+
+/* Tags of the entries the index looks at */
+#define DW_TAG_compile_unit 0x11
+#define DW_TAG_subprogram 0x2e
+#define DW_TAG_partial_unit 0x3c
+#define DW_TAG_skeleton_unit 0x4a
+
+/* Attributes of the entries the index looks at */
+#define DW_AT_name 0x03
+#define DW_AT_low_pc 0x11
+#define DW_AT_high_pc 0x12
+#define DW_AT_abstract_origin 0x31
+#define DW_AT_decl_file 0x3a
+#define DW_AT_decl_line 0x3b
+#define DW_AT_declaration 0x3c
+#define DW_AT_specification 0x47
+#define DW_AT_linkage_name 0x6e
+#define DW_AT_str_offsets_base 0x72
+#define DW_AT_addr_base 0x73
+#define DW_AT_MIPS_linkage_name 0x2007
+
+/* Index attributes of the .debug_names entries */
+#define DW_IDX_compile_unit 1
+#define DW_IDX_type_unit 2
+#define DW_IDX_die_offset 3
+#define DW_IDX_parent 4
+#define DW_IDX_type_hash 5
+
+
+/* Number of decoded compilation units kept by the index */
+#define DWARF_CU_CACHE_SIZE 16
+
+
+/* File index of the rows ending a sequence, no address from them on belongs to a line */
+#define DWARF_LINE_END_SEQUENCE 0xffffffff
+
+
+
+/* String sections referenced by the DWARF forms */
+typedef struct dwarf_strings{
+	u8 * debugStr;		/* Contents of .debug_str */
+	u64 debugStrSize;	/* Size of .debug_str */
+	u8 * debugLineStr;	/* Contents of .debug_line_str */
+	u64 debugLineStrSize;	/* Size of .debug_line_str */
+}dwarf_strings_t;
+
+
+/* Rows of all the line number programs, sorted by address and stored column by column */
+typedef struct dwarf_line_table{
+	u64 numOfRows;		/* Number of rows */
+	u64 * addresses;	/* Address of every row, the binary searched column */
+	u32 * files;		/* Index of every row's file in fileNames, or DWARF_LINE_END_SEQUENCE */
+	u32 * lines;		/* Source line of every row */
+	u32 numOfFiles;		/* Number of file names */
+	u8 ** fileNames;	/* Paths of the files of all the units, the first one is the unknown file */
+}dwarf_line_table_t;
+
+
+/* Address range covered by a compilation unit */
+typedef struct dwarf_cu_range{
+	u64 low;		/* First address of the range */
+	u64 high;		/* Address following the range */
+	u64 cuOffset;	/* Offset of the unit in .debug_info */
+}dwarf_cu_range_t;
+
+
+/* A function defined by a compilation unit */
+typedef struct dwarf_function{
+	u64 low;		/* Entry address */
+	u64 high;		/* Address following the function */
+	u8 * name;		/* Name, or the linkage name when it has no plain one */
+	u64 dieOffset;	/* Offset of its entry in .debug_info */
+	u32 declLine;	/* Line of its declaration */
+}dwarf_function_t;
+
+
+/* A decoded compilation unit, only its functions are kept */
+typedef struct dwarf_cu{
+	u64 offset;		/* Offset of the unit in .debug_info */
+	u8 * name;		/* Name of the unit's source file */
+	u64 numOfFunctions;		/* Number of functions */
+	dwarf_function_t * functions;	/* Functions sorted by their entry address */
+	u64 lastUse;	/* Clock of the last query which used the unit */
+}dwarf_cu_t;
+
+
+/* Parsed header of a .debug_names name index */
+typedef struct dwarf_names_table{
+	u8 is64;			/* Whether the offsets are 64-bit */
+	u32 numOfCus;		/* Number of compilation units */
+	u32 numOfBuckets;	/* Number of hash buckets */
+	u32 numOfNames;		/* Number of names */
+	u8 * cuOffsets;		/* Offsets of the units */
+	u8 * buckets;		/* First name of every bucket */
+	u8 * hashes;		/* Hash of every name */
+	u8 * stringOffsets;	/* .debug_str offset of every name */
+	u8 * entryOffsets;	/* Entry pool offset of every name */
+	u8 * abbrevs;		/* Abbreviations of the entries */
+	u8 * entryPool;		/* Entries of the names */
+	u8 * end;			/* End of the name index */
+}dwarf_names_table_t;
+
+
+/* Index from addresses and function names to compilation units, units are decoded only when a query needs them */
+typedef struct dwarf_cu_index{
+	u8 needsSwap;		/* Whether the sections are in the foreign byte order */
+	u8 * debugInfo;		/* Contents of .debug_info */
+	u64 debugInfoSize;
+	u8 * debugAbbrev;	/* Contents of .debug_abbrev */
+	u64 debugAbbrevSize;
+	u8 * debugStrOffsets;	/* Contents of .debug_str_offsets */
+	u64 debugStrOffsetsSize;
+	u8 * debugAddr;		/* Contents of .debug_addr */
+	u64 debugAddrSize;
+	dwarf_strings_t strings;	/* String sections */
+
+	u64 numOfRanges;	/* Number of address ranges */
+	dwarf_cu_range_t * ranges;	/* Address ranges of the units sorted by their first address */
+
+	u32 numOfNamesTables;	/* Number of .debug_names name indices */
+	dwarf_names_table_t * namesTables;	/* Name indices of .debug_names */
+
+	u8 * gdbIndex;		/* Contents of .gdb_index, NULL if there is none or it is not usable */
+	u64 gdbIndexSize;
+	u8 * gdbCuList;		/* Offsets and lengths of the units */
+	u32 numOfGdbCus;	/* Number of units */
+	u8 * gdbSymbolTable;	/* Hash table of the names */
+	u64 numOfGdbSlots;	/* Number of slots of the hash table */
+	u8 * gdbConstantPool;	/* Names and unit vectors of the hash table */
+
+	u32 numOfCachedCus;		/* Number of decoded units */
+	dwarf_cu_t cachedCus[DWARF_CU_CACHE_SIZE];	/* Decoded units, the least recently used one is replaced */
+	u64 useClock;		/* Clock of the queries */
+}dwarf_cu_index_t;
+
+
+
+/* Get the contents of a DWARF section by its name, returns NULL if it is missing or cannot be read */
+u8 * dwarf_get_section(kvelf_basic_params_t * kvelfp, u8 * sectionName, u64 * contentsSize);
+
+/* Decode the whole .debug_line section into a sorted line table */
+dwarf_line_table_t * dwarf_decode_line_table(u8 * debugLine, u64 debugLineSize, dwarf_strings_t * strings, u8 needsSwap);
+
+/* Find the row covering the given address, returns -1 if no line covers it */
+s64 dwarf_lookup_line(dwarf_line_table_t * lineTable, u64 address);
+
+/* Get the line table of the file, decoding it on the first call */
+dwarf_line_table_t * dwarf_get_line_table(kvelf_basic_params_t * kvelfp);
+
+/* Free a line table and the paths of its files */
+void dwarf_line_table_free(dwarf_line_table_t * lineTable);
+
+/* Resolve the given addresses to file:line, "-" reads the addresses from stdin until an empty line */
+void dwarf_addr2line(kvelf_basic_params_t * kvelfp, u8 * addresses);
+
+
+/* Get the compilation unit index of the file, building it on the first call */
+dwarf_cu_index_t * dwarf_get_cu_index(kvelf_basic_params_t * kvelfp);
+
+/* Free a compilation unit index and the units decoded in its cache */
+void dwarf_cu_index_free(dwarf_cu_index_t * cuIndex);
+
+/* Find the offset of the compilation unit covering an address, returns -1 if no unit covers it */
+s64 dwarf_find_cu_by_address(dwarf_cu_index_t * cuIndex, u64 address);
+
+/* Get a decoded compilation unit from the cache, decoding it if it is not there */
+dwarf_cu_t * dwarf_get_cu(dwarf_cu_index_t * cuIndex, u64 cuOffset);
+
+/* Find the function containing an address in a decoded compilation unit */
+dwarf_function_t * dwarf_find_function_by_address(dwarf_cu_t * cu, u64 address);
+
+/* Look a function up by an address or a name and print where it is */
+void dwarf_lookup_function(kvelf_basic_params_t * kvelfp, u8 * query);
+
+
+#endif
@@ -0,0 +1,1251 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./dwarf.h"
+#include "./symindex.h"
+
+
+/* Most units a name can be found in by a single query */
+#define DWARF_MAX_NAME_MATCHES 64
+
+/* Most references followed to find the name of a function */
+#define DWARF_MAX_NAME_REFERENCES 4
+
+/* Most functions checked backward from the search position, for functions nested in others */
+#define DWARF_MAX_NESTED_FUNCTIONS 16
+
+
+
+/* Header of a unit of .debug_info */
+typedef struct dwarf_unit{
+    u64 offset;         /* Offset of the unit in .debug_info */
+    u8 * firstDie;      /* First entry of the unit */
+    u8 * end;           /* End of the unit */
+    u16 version;        /* DWARF version */
+    u8 is64;            /* Whether the offsets are 64-bit */
+    u8 addressSize;     /* Size of the addresses */
+    u64 abbrevOffset;   /* Offset of the unit's abbreviations in .debug_abbrev */
+    u64 strOffsetsBase; /* Base of the unit's string offsets in .debug_str_offsets */
+    u64 addrBase;       /* Base of the unit's addresses in .debug_addr */
+}dwarf_unit_t;
+
+
+/* Attribute specification of an abbreviation */
+typedef struct dwarf_abbrev_attr{
+    u64 name;
+    u64 form;
+    s64 implicitConst;  /* Value of the DW_FORM_implicit_const attributes */
+}dwarf_abbrev_attr_t;
+
+
+/* Abbreviation of the entries of a unit */
+typedef struct dwarf_abbrev{
+    u64 code;
+    u64 tag;
+    u32 firstAttr;      /* Index of the first attribute in the table's attributes */
+    u32 numOfAttrs;
+}dwarf_abbrev_t;
+
+
+/* Abbreviations of a unit */
+typedef struct dwarf_abbrev_table{
+    dwarf_abbrev_t * abbrevs;
+    u64 numOfAbbrevs;
+    dwarf_abbrev_attr_t * attrs;
+    u64 numOfAttrs;
+    u8 dense;           /* Whether the abbreviation with code N is the Nth one */
+}dwarf_abbrev_table_t;
+
+
+/* Value of an attribute as it is in its form */
+typedef struct dwarf_form_value{
+    u64 form;
+    u64 value;
+    u8 * string;        /* Inline strings of DW_FORM_string */
+}dwarf_form_value_t;
+
+
+/* Unit and entry found for a name */
+typedef struct dwarf_name_match{
+    u64 cuOffset;
+    u64 dieOffset;      /* Offset of the entry in .debug_info, 0 if only the unit is known */
+}dwarf_name_match_t;
+
+
+
+/* Read an unsigned value at the given position */
+static u64 read_uint_at(u8 * position, u8 size, u8 needsSwap){
+
+    data_reader_t reader;
+    reader_init(&reader,position,size,needsSwap);
+
+    return reader_uint(&reader,size);
+}
+
+
+/* Read the header of the unit at the given offset of .debug_info, returns 0 if it is not a valid unit */
+static u8 read_unit_header(dwarf_cu_index_t * cuIndex, u64 offset, dwarf_unit_t * unit){
+
+    if(offset>=cuIndex->debugInfoSize)
+        return 0;
+
+    data_reader_t reader;
+    reader_init(&reader,cuIndex->debugInfo+offset,cuIndex->debugInfoSize-offset,cuIndex->needsSwap);
+
+    unit->offset=offset;
+    unit->is64=0;
+    u64 unitLength = reader_u32(&reader);
+    if(unitLength==0xffffffff){
+        unitLength = reader_u64(&reader);
+        unit->is64=1;
+    }
+    if(reader.error || unitLength>reader_left(&reader))
+        return 0;
+    unit->end = reader.pos+unitLength;
+
+    unit->version = reader_u16(&reader);
+    if(unit->version<2 || unit->version>5)
+        return 0;
+
+    if(unit->version>=5){
+        u8 unitType = reader_u8(&reader);
+        unit->addressSize = reader_u8(&reader);
+        unit->abbrevOffset = reader_uint(&reader,unit->is64 ? 8 : 4);
+
+        // Skeleton and split units carry their DWO id, type units their signature and type offset
+        if(unitType==DW_UT_skeleton || unitType==DW_UT_split_compile)
+            reader_skip(&reader,8);
+        else if(unitType==DW_UT_type || unitType==DW_UT_split_type)
+            reader_skip(&reader,8+(unit->is64 ? 8 : 4));
+    }else{
+        unit->abbrevOffset = reader_uint(&reader,unit->is64 ? 8 : 4);
+        unit->addressSize = reader_u8(&reader);
+    }
+
+    // Bases given by the unit entry, these are the defaults of the units without them
+    unit->strOffsetsBase = unit->is64 ? 16 : 8;
+    unit->addrBase = 8;
+
+    unit->firstDie = reader.pos;
+
+    return !reader.error && unit->addressSize<=8 && unit->firstDie<=unit->end;
+}
+
+
+/* Read the abbreviations of a unit */
+static void read_abbrev_table(dwarf_cu_index_t * cuIndex, u64 offset, dwarf_abbrev_table_t * table){
+
+    u64 abbrevsCapacity=64, attrsCapacity=256;
+
+    table->abbrevs = malloc(abbrevsCapacity*sizeof(dwarf_abbrev_t));
+    table->attrs = malloc(attrsCapacity*sizeof(dwarf_abbrev_attr_t));
+    table->numOfAbbrevs=0;
+    table->numOfAttrs=0;
+    table->dense=1;
+
+    if(offset>=cuIndex->debugAbbrevSize)
+        return;
+
+    data_reader_t reader;
+    reader_init(&reader,cuIndex->debugAbbrev+offset,cuIndex->debugAbbrevSize-offset,cuIndex->needsSwap);
+
+    while(!reader.error){
+
+        u64 code = reader_uleb128(&reader);
+        if(code==0)
+            break;
+
+        if(table->numOfAbbrevs==abbrevsCapacity){
+            abbrevsCapacity*=2;
+            table->abbrevs = realloc(table->abbrevs,abbrevsCapacity*sizeof(dwarf_abbrev_t));
+        }
+
+        dwarf_abbrev_t * abbrev = &table->abbrevs[table->numOfAbbrevs++];
+        abbrev->code = code;
+        abbrev->tag = reader_uleb128(&reader);
+        abbrev->firstAttr = table->numOfAttrs;
+        abbrev->numOfAttrs = 0;
+        table->dense &= code==table->numOfAbbrevs;
+
+        // Children flag
+        reader_u8(&reader);
+
+        while(!reader.error){
+            u64 name = reader_uleb128(&reader);
+            u64 form = reader_uleb128(&reader);
+            if(name==0 && form==0)
+                break;
+
+            if(table->numOfAttrs==attrsCapacity){
+                attrsCapacity*=2;
+                table->attrs = realloc(table->attrs,attrsCapacity*sizeof(dwarf_abbrev_attr_t));
+            }
+
+            dwarf_abbrev_attr_t * attr = &table->attrs[table->numOfAttrs++];
+            attr->name = name;
+            attr->form = form;
+            attr->implicitConst = form==DW_FORM_implicit_const ? reader_sleb128(&reader) : 0;
+            abbrev->numOfAttrs++;
+        }
+    }
+}
+
+
+/* Find an abbreviation by its code */
+static dwarf_abbrev_t * find_abbrev(dwarf_abbrev_table_t * table, u64 code){
+
+    // Producers number the abbreviations from 1, so the code is usually the index
+    if(table->dense)
+        return (code && code<=table->numOfAbbrevs) ? &table->abbrevs[code-1] : NULL;
+
+    for(u64 i=0;i<table->numOfAbbrevs;i++)
+        if(table->abbrevs[i].code==code)
+            return &table->abbrevs[i];
+
+    return NULL;
+}
+
+
+/* Read an attribute value, returns 0 for the forms it does not know the size of */
+static u8 read_form(data_reader_t * reader, dwarf_unit_t * unit, u64 form, s64 implicitConst, dwarf_form_value_t * formValue){
+
+    u8 offsetSize = unit->is64 ? 8 : 4;
+
+    formValue->form=form;
+    formValue->value=0;
+    formValue->string=NULL;
+
+    switch(form){
+        case DW_FORM_addr:
+            formValue->value = reader_uint(reader,unit->addressSize);
+            break;
+        case DW_FORM_data1:
+        case DW_FORM_ref1:
+        case DW_FORM_flag:
+        case DW_FORM_strx1:
+        case DW_FORM_addrx1:
+            formValue->value = reader_u8(reader);
+            break;
+        case DW_FORM_data2:
+        case DW_FORM_ref2:
+        case DW_FORM_strx2:
+        case DW_FORM_addrx2:
+            formValue->value = reader_u16(reader);
+            break;
+        case DW_FORM_strx3:
+        case DW_FORM_addrx3:
+            formValue->value = reader_uint(reader,3);
+            break;
+        case DW_FORM_data4:
+        case DW_FORM_ref4:
+        case DW_FORM_ref_sup4:
+        case DW_FORM_strx4:
+        case DW_FORM_addrx4:
+            formValue->value = reader_u32(reader);
+            break;
+        case DW_FORM_data8:
+        case DW_FORM_ref8:
+        case DW_FORM_ref_sig8:
+        case DW_FORM_ref_sup8:
+            formValue->value = reader_u64(reader);
+            break;
+        case DW_FORM_data16:
+            reader_skip(reader,16);
+            break;
+        case DW_FORM_sdata:
+            formValue->value = (u64)reader_sleb128(reader);
+            break;
+        case DW_FORM_udata:
+        case DW_FORM_ref_udata:
+        case DW_FORM_strx:
+        case DW_FORM_addrx:
+        case DW_FORM_loclistx:
+        case DW_FORM_rnglistx:
+        case DW_FORM_GNU_addr_index:
+        case DW_FORM_GNU_str_index:
+            formValue->value = reader_uleb128(reader);
+            break;
+        case DW_FORM_strp:
+        case DW_FORM_line_strp:
+        case DW_FORM_sec_offset:
+        case DW_FORM_strp_sup:
+        case DW_FORM_GNU_ref_alt:
+        case DW_FORM_GNU_strp_alt:
+            formValue->value = reader_uint(reader,offsetSize);
+            break;
+        case DW_FORM_ref_addr:
+            // DWARF 2 sized the references to other units as addresses
+            formValue->value = reader_uint(reader,unit->version<=2 ? unit->addressSize : offsetSize);
+            break;
+        case DW_FORM_string:
+            formValue->string = reader_string(reader);
+            break;
+        case DW_FORM_block1:
+            reader_skip(reader,reader_u8(reader));
+            break;
+        case DW_FORM_block2:
+            reader_skip(reader,reader_u16(reader));
+            break;
+        case DW_FORM_block4:
+            reader_skip(reader,reader_u32(reader));
+            break;
+        case DW_FORM_block:
+        case DW_FORM_exprloc:
+            reader_skip(reader,reader_uleb128(reader));
+            break;
+        case DW_FORM_flag_present:
+            formValue->value = 1;
+            break;
+        case DW_FORM_implicit_const:
+            formValue->value = (u64)implicitConst;
+            break;
+        case DW_FORM_indirect:
+            return read_form(reader,unit,reader_uleb128(reader),implicitConst,formValue);
+        default:
+            return 0;
+    }
+
+    return !reader->error;
+}
+
+
+/* Get the string an attribute refers to, NULL if it has none */
+static u8 * resolve_form_string(dwarf_cu_index_t * cuIndex, dwarf_unit_t * unit, dwarf_form_value_t * formValue){
+
+    u8 offsetSize = unit->is64 ? 8 : 4;
+    u64 strOffset;
+
+    switch(formValue->form){
+        case DW_FORM_string:
+            return formValue->string;
+        case DW_FORM_strp:
+            strOffset = formValue->value;
+            break;
+        case DW_FORM_line_strp:
+            if(formValue->value>=cuIndex->strings.debugLineStrSize || !memchr(cuIndex->strings.debugLineStr+formValue->value,0,cuIndex->strings.debugLineStrSize-formValue->value))
+                return NULL;
+            return cuIndex->strings.debugLineStr+formValue->value;
+        case DW_FORM_strx:
+        case DW_FORM_strx1:
+        case DW_FORM_strx2:
+        case DW_FORM_strx3:
+        case DW_FORM_strx4:{
+            // Indexed strings go through the unit's contribution to .debug_str_offsets
+            u64 entryOffset = unit->strOffsetsBase + formValue->value*offsetSize;
+            if(!cuIndex->debugStrOffsets || entryOffset+offsetSize>cuIndex->debugStrOffsetsSize)
+                return NULL;
+            strOffset = read_uint_at(cuIndex->debugStrOffsets+entryOffset,offsetSize,cuIndex->needsSwap);
+            break;
+        }
+        default:
+            return NULL;
+    }
+
+    if(strOffset>=cuIndex->strings.debugStrSize || !memchr(cuIndex->strings.debugStr+strOffset,0,cuIndex->strings.debugStrSize-strOffset))
+        return NULL;
+
+    return cuIndex->strings.debugStr+strOffset;
+}
+
+
+/* Whether an attribute value is an address rather than a constant */
+static u8 form_is_address(u64 form){
+    return form==DW_FORM_addr || form==DW_FORM_addrx || form==DW_FORM_addrx1 || form==DW_FORM_addrx2 ||
+           form==DW_FORM_addrx3 || form==DW_FORM_addrx4 || form==DW_FORM_GNU_addr_index;
+}
+
+
+/* Get the address an attribute holds */
+static u64 resolve_form_address(dwarf_cu_index_t * cuIndex, dwarf_unit_t * unit, dwarf_form_value_t * formValue){
+
+    if(formValue->form==DW_FORM_addr || !form_is_address(formValue->form))
+        return formValue->value;
+
+    // Indexed addresses go through the unit's contribution to .debug_addr
+    u64 entryOffset = unit->addrBase + formValue->value*unit->addressSize;
+    if(!cuIndex->debugAddr || entryOffset+unit->addressSize>cuIndex->debugAddrSize)
+        return 0;
+
+    return read_uint_at(cuIndex->debugAddr+entryOffset,unit->addressSize,cuIndex->needsSwap);
+}
+
+
+/* Get the offset in .debug_info an attribute refers to, returns 0 for the references this decoder cannot follow */
+static u64 resolve_form_reference(dwarf_unit_t * unit, dwarf_form_value_t * formValue){
+
+    switch(formValue->form){
+        case DW_FORM_ref1:
+        case DW_FORM_ref2:
+        case DW_FORM_ref4:
+        case DW_FORM_ref8:
+        case DW_FORM_ref_udata:
+            return unit->offset + formValue->value;
+        case DW_FORM_ref_addr:
+            return formValue->value;
+    }
+
+    return 0;
+}
+
+
+/* Get the name of the entry at the given offset, following its specification or abstract origin */
+static u8 * read_die_name_at(dwarf_cu_index_t * cuIndex, dwarf_unit_t * unit, dwarf_abbrev_table_t * table, u64 dieOffset, u32 depth){
+
+    // The entry has to be in the unit, the abbreviations of other units are not at hand
+    u8 * die = cuIndex->debugInfo + dieOffset;
+    if(depth>DWARF_MAX_NAME_REFERENCES || die<unit->firstDie || die>=unit->end)
+        return NULL;
+
+    data_reader_t reader;
+    reader_init(&reader,die,unit->end-die,cuIndex->needsSwap);
+
+    dwarf_abbrev_t * abbrev = find_abbrev(table,reader_uleb128(&reader));
+    if(!abbrev)
+        return NULL;
+
+    dwarf_form_value_t name = {0}, linkageName = {0}, reference = {0};
+
+    for(u32 i=0;i<abbrev->numOfAttrs;i++){
+        dwarf_abbrev_attr_t * attr = &table->attrs[abbrev->firstAttr+i];
+        dwarf_form_value_t formValue;
+
+        if(!read_form(&reader,unit,attr->form,attr->implicitConst,&formValue))
+            return NULL;
+
+        if(attr->name==DW_AT_name)
+            name=formValue;
+        else if(attr->name==DW_AT_linkage_name || attr->name==DW_AT_MIPS_linkage_name)
+            linkageName=formValue;
+        else if(attr->name==DW_AT_specification || attr->name==DW_AT_abstract_origin)
+            reference=formValue;
+    }
+
+    u8 * resolvedName = NULL;
+    if(name.form)
+        resolvedName = resolve_form_string(cuIndex,unit,&name);
+    if(!resolvedName && linkageName.form)
+        resolvedName = resolve_form_string(cuIndex,unit,&linkageName);
+    if(!resolvedName && reference.form)
+        resolvedName = read_die_name_at(cuIndex,unit,table,resolve_form_reference(unit,&reference),depth+1);
+
+    return resolvedName;
+}
+
+
+/* Compare functions by their entry address */
+static s32 compare_functions(const void * a, const void * b){
+
+    u64 lowA = ((dwarf_function_t *)a)->low;
+    u64 lowB = ((dwarf_function_t *)b)->low;
+
+    return (lowA>lowB) - (lowA<lowB);
+}
+
+
+/* Decode the functions of the unit at the given offset of .debug_info */
+static void decode_cu(dwarf_cu_index_t * cuIndex, u64 cuOffset, dwarf_cu_t * cu){
+
+    cu->offset = cuOffset;
+    cu->name = "??";
+    cu->numOfFunctions = 0;
+    cu->functions = NULL;
+
+    dwarf_unit_t unit;
+    if(!read_unit_header(cuIndex,cuOffset,&unit)){
+        debug("Invalid compilation unit header\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    dwarf_abbrev_table_t table;
+    read_abbrev_table(cuIndex,unit.abbrevOffset,&table);
+
+    u64 functionsCapacity=64;
+    cu->functions = malloc(functionsCapacity*sizeof(dwarf_function_t));
+
+    data_reader_t reader;
+    reader_init(&reader,unit.firstDie,unit.end-unit.firstDie,cuIndex->needsSwap);
+
+    u8 isUnitDie=1;
+
+    while(reader_left(&reader) && !reader.error){
+
+        u64 dieOffset = reader.pos - cuIndex->debugInfo;
+        u64 code = reader_uleb128(&reader);
+
+        // Null entries close the lists of children
+        if(code==0)
+            continue;
+
+        dwarf_abbrev_t * abbrev = find_abbrev(&table,code);
+        if(!abbrev){
+            debug("Unknown abbreviation in a compilation unit\n",DEBUG_STATUS_ERROR);
+            break;
+        }
+
+        u8 isFunction = abbrev->tag==DW_TAG_subprogram;
+        dwarf_form_value_t name = {0}, linkageName = {0}, low = {0}, high = {0}, reference = {0};
+        u32 declLine=0;
+        u8 formsKnown=1;
+
+        for(u32 i=0;i<abbrev->numOfAttrs;i++){
+            dwarf_abbrev_attr_t * attr = &table.attrs[abbrev->firstAttr+i];
+            dwarf_form_value_t formValue;
+
+            if(!read_form(&reader,&unit,attr->form,attr->implicitConst,&formValue)){
+                formsKnown=0;
+                break;
+            }
+
+            // Only the unit entry and the functions have attributes worth keeping
+            if(!isFunction && !isUnitDie)
+                continue;
+
+            switch(attr->name){
+                case DW_AT_name:
+                    name=formValue;
+                    break;
+                case DW_AT_linkage_name:
+                case DW_AT_MIPS_linkage_name:
+                    linkageName=formValue;
+                    break;
+                case DW_AT_low_pc:
+                    low=formValue;
+                    break;
+                case DW_AT_high_pc:
+                    high=formValue;
+                    break;
+                case DW_AT_specification:
+                case DW_AT_abstract_origin:
+                    reference=formValue;
+                    break;
+                case DW_AT_decl_line:
+                    declLine=formValue.value;
+                    break;
+                case DW_AT_str_offsets_base:
+                    unit.strOffsetsBase=formValue.value;
+                    break;
+                case DW_AT_addr_base:
+                    unit.addrBase=formValue.value;
+                    break;
+            }
+        }
+
+        if(!formsKnown){
+            debug("Unknown attribute form in a compilation unit\n",DEBUG_STATUS_ERROR);
+            break;
+        }
+
+        if(isUnitDie){
+            // The bases are known once the whole unit entry is read
+            u8 * unitName = name.form ? resolve_form_string(cuIndex,&unit,&name) : NULL;
+            if(unitName)
+                cu->name=unitName;
+            isUnitDie=0;
+            continue;
+        }
+
+        // Declarations and the functions split into ranges have no low and high addresses
+        if(!isFunction || !low.form || !high.form)
+            continue;
+
+        if(cu->numOfFunctions==functionsCapacity){
+            functionsCapacity*=2;
+            cu->functions = realloc(cu->functions,functionsCapacity*sizeof(dwarf_function_t));
+        }
+
+        dwarf_function_t * function = &cu->functions[cu->numOfFunctions++];
+        function->low = resolve_form_address(cuIndex,&unit,&low);
+        function->high = form_is_address(high.form) ? resolve_form_address(cuIndex,&unit,&high) : function->low + high.value;
+        function->dieOffset = dieOffset;
+        function->declLine = declLine;
+
+        function->name = NULL;
+        if(name.form)
+            function->name = resolve_form_string(cuIndex,&unit,&name);
+        if(!function->name && linkageName.form)
+            function->name = resolve_form_string(cuIndex,&unit,&linkageName);
+        if(!function->name && reference.form)
+            function->name = read_die_name_at(cuIndex,&unit,&table,resolve_form_reference(&unit,&reference),1);
+        if(!function->name)
+            function->name = "??";
+    }
+
+    free(table.abbrevs);
+    free(table.attrs);
+
+    qsort(cu->functions,cu->numOfFunctions,sizeof(dwarf_function_t),compare_functions);
+}
+
+
+/* Add an address range of a unit to the index */
+static void add_cu_range(dwarf_cu_index_t * cuIndex, u64 * rangesCapacity, u64 low, u64 high, u64 cuOffset){
+
+    if(cuIndex->numOfRanges==*rangesCapacity){
+        *rangesCapacity = *rangesCapacity ? *rangesCapacity*2 : 256;
+        cuIndex->ranges = realloc(cuIndex->ranges,*rangesCapacity*sizeof(dwarf_cu_range_t));
+    }
+
+    cuIndex->ranges[cuIndex->numOfRanges].low=low;
+    cuIndex->ranges[cuIndex->numOfRanges].high=high;
+    cuIndex->ranges[cuIndex->numOfRanges].cuOffset=cuOffset;
+    cuIndex->numOfRanges++;
+}
+
+
+/* Read the address ranges of the units from .debug_aranges */
+static void read_aranges(dwarf_cu_index_t * cuIndex, u8 * debugAranges, u64 debugArangesSize, u64 * rangesCapacity){
+
+    data_reader_t section;
+    reader_init(&section,debugAranges,debugArangesSize,cuIndex->needsSwap);
+
+    while(reader_left(&section) && !section.error){
+
+        u8 * setStart = section.pos;
+        u8 is64=0;
+        u64 setLength = reader_u32(&section);
+        if(setLength==0xffffffff){
+            setLength = reader_u64(&section);
+            is64=1;
+        }
+        if(section.error || setLength>reader_left(&section))
+            break;
+
+        data_reader_t set;
+        reader_init(&set,section.pos,setLength,cuIndex->needsSwap);
+        reader_skip(&section,setLength);
+
+        // Version
+        reader_u16(&set);
+        u64 cuOffset = reader_uint(&set,is64 ? 8 : 4);
+        u8 addressSize = reader_u8(&set);
+        u8 segmentSize = reader_u8(&set);
+        if(set.error || addressSize==0 || addressSize>8)
+            continue;
+
+        // The tuples are aligned to their size from the start of the set
+        u64 tupleSize = 2*addressSize;
+        u64 headerSize = set.pos - setStart;
+        reader_skip(&set,(tupleSize - headerSize%tupleSize)%tupleSize);
+
+        while(reader_left(&set)>=segmentSize+tupleSize){
+            reader_skip(&set,segmentSize);
+            u64 address = reader_uint(&set,addressSize);
+            u64 length = reader_uint(&set,addressSize);
+            if(address==0 && length==0)
+                break;
+            if(length)
+                add_cu_range(cuIndex,rangesCapacity,address,address+length,cuOffset);
+        }
+    }
+}
+
+
+/* Read the address area of .gdb_index, returns 0 if the index is not usable */
+static u8 read_gdb_index(dwarf_cu_index_t * cuIndex, u64 * rangesCapacity, u8 readRanges){
+
+    // .gdb_index is little endian whatever the file's encoding is
+    data_reader_t reader;
+    reader_init(&reader,cuIndex->gdbIndex,cuIndex->gdbIndexSize,ELF_HOST_ENCODING!=ELFDATA2LSB);
+
+    u32 version = reader_u32(&reader);
+    if(version<7 || version>9)
+        return 0;
+
+    u32 cuListOffset = reader_u32(&reader);
+    u32 typesListOffset = reader_u32(&reader);
+    u32 addressAreaOffset = reader_u32(&reader);
+    u32 symbolTableOffset = reader_u32(&reader);
+    if(version>=9)
+        reader_u32(&reader);
+    u32 constantPoolOffset = reader_u32(&reader);
+
+    if(reader.error || cuListOffset>typesListOffset || addressAreaOffset>symbolTableOffset ||
+       symbolTableOffset>constantPoolOffset || constantPoolOffset>cuIndex->gdbIndexSize)
+        return 0;
+
+    cuIndex->gdbCuList = cuIndex->gdbIndex + cuListOffset;
+    cuIndex->numOfGdbCus = (typesListOffset-cuListOffset)/16;
+    cuIndex->gdbSymbolTable = cuIndex->gdbIndex + symbolTableOffset;
+    cuIndex->numOfGdbSlots = (constantPoolOffset-symbolTableOffset)/8;
+    cuIndex->gdbConstantPool = cuIndex->gdbIndex + constantPoolOffset;
+
+    if(!readRanges)
+        return 1;
+
+    // Address area entries are a low and a high address followed by a unit number
+    reader_init(&reader,cuIndex->gdbIndex+addressAreaOffset,symbolTableOffset-addressAreaOffset,ELF_HOST_ENCODING!=ELFDATA2LSB);
+    while(reader_left(&reader)>=20){
+        u64 low = reader_u64(&reader);
+        u64 high = reader_u64(&reader);
+        u32 cuNumber = reader_u32(&reader);
+        if(cuNumber<cuIndex->numOfGdbCus && high>low)
+            add_cu_range(cuIndex,rangesCapacity,low,high,read_uint_at(cuIndex->gdbCuList+cuNumber*16,8,ELF_HOST_ENCODING!=ELFDATA2LSB));
+    }
+
+    return 1;
+}
+
+
+/* Read the headers of the name indices of .debug_names */
+static void read_names_tables(dwarf_cu_index_t * cuIndex, u8 * debugNames, u64 debugNamesSize){
+
+    u32 tablesCapacity=0;
+
+    data_reader_t section;
+    reader_init(&section,debugNames,debugNamesSize,cuIndex->needsSwap);
+
+    while(reader_left(&section) && !section.error){
+
+        u8 is64=0;
+        u64 tableLength = reader_u32(&section);
+        if(tableLength==0xffffffff){
+            tableLength = reader_u64(&section);
+            is64=1;
+        }
+        if(section.error || tableLength>reader_left(&section))
+            break;
+
+        data_reader_t reader;
+        reader_init(&reader,section.pos,tableLength,cuIndex->needsSwap);
+        reader_skip(&section,tableLength);
+
+        u8 offsetSize = is64 ? 8 : 4;
+        u16 version = reader_u16(&reader);
+        // Padding
+        reader_u16(&reader);
+
+        dwarf_names_table_t table;
+        table.is64 = is64;
+        table.numOfCus = reader_u32(&reader);
+        u32 numOfLocalTus = reader_u32(&reader);
+        u32 numOfForeignTus = reader_u32(&reader);
+        table.numOfBuckets = reader_u32(&reader);
+        table.numOfNames = reader_u32(&reader);
+        u32 abbrevsSize = reader_u32(&reader);
+        u32 augmentationSize = reader_u32(&reader);
+        reader_skip(&reader,augmentationSize);
+
+        table.cuOffsets = reader.pos;
+        reader_skip(&reader,(u64)table.numOfCus*offsetSize);
+        reader_skip(&reader,(u64)numOfLocalTus*offsetSize);
+        reader_skip(&reader,(u64)numOfForeignTus*8);
+        table.buckets = reader.pos;
+        reader_skip(&reader,(u64)table.numOfBuckets*4);
+        table.hashes = reader.pos;
+        if(table.numOfBuckets)
+            reader_skip(&reader,(u64)table.numOfNames*4);
+        table.stringOffsets = reader.pos;
+        reader_skip(&reader,(u64)table.numOfNames*offsetSize);
+        table.entryOffsets = reader.pos;
+        reader_skip(&reader,(u64)table.numOfNames*offsetSize);
+        table.abbrevs = reader.pos;
+        reader_skip(&reader,abbrevsSize);
+        table.entryPool = reader.pos;
+        table.end = reader.end;
+
+        if(version!=5 || reader.error)
+            continue;
+
+        if(cuIndex->numOfNamesTables==tablesCapacity){
+            tablesCapacity = tablesCapacity ? tablesCapacity*2 : 4;
+            cuIndex->namesTables = realloc(cuIndex->namesTables,tablesCapacity*sizeof(dwarf_names_table_t));
+        }
+        cuIndex->namesTables[cuIndex->numOfNamesTables++]=table;
+    }
+}
+
+
+/* Hash of the names of .debug_names, the DJB hash of the case folded name */
+static u32 names_hash(u8 * name){
+
+    u32 hash=5381;
+    for(;*name;name++)
+        hash = hash*33 + tolower(*name);
+
+    return hash;
+}
+
+
+/* Find the abbreviation of a .debug_names entry, returns the position of its tag */
+static u8 * find_names_abbrev(dwarf_names_table_t * table, u64 code, u8 needsSwap){
+
+    data_reader_t reader;
+    reader_init(&reader,table->abbrevs,table->entryPool-table->abbrevs,needsSwap);
+
+    while(!reader.error){
+        u64 abbrevCode = reader_uleb128(&reader);
+        if(abbrevCode==0)
+            return NULL;
+        if(abbrevCode==code)
+            return reader.pos;
+
+        // Tag, then the index attributes up to the terminating pair
+        reader_uleb128(&reader);
+        while(!reader.error && (reader_uleb128(&reader) | reader_uleb128(&reader)));
+    }
+
+    return NULL;
+}
+
+
+/* Add the functions of the entries of a name to the matches */
+static u32 read_names_entries(dwarf_cu_index_t * cuIndex, dwarf_names_table_t * table, u32 nameIdx, dwarf_name_match_t * matches, u32 numOfMatches){
+
+    u8 offsetSize = table->is64 ? 8 : 4;
+    u64 entryOffset = read_uint_at(table->entryOffsets+(u64)nameIdx*offsetSize,offsetSize,cuIndex->needsSwap);
+    if(entryOffset>=(u64)(table->end-table->entryPool))
+        return numOfMatches;
+
+    // The entries are read with the forms of a unit of the table's offset size
+    dwarf_unit_t unit = {0};
+    unit.is64 = table->is64;
+    unit.version = 5;
+    unit.addressSize = 8;
+
+    data_reader_t reader;
+    reader_init(&reader,table->entryPool+entryOffset,table->end-table->entryPool-entryOffset,cuIndex->needsSwap);
+
+    while(!reader.error && numOfMatches<DWARF_MAX_NAME_MATCHES){
+
+        u64 code = reader_uleb128(&reader);
+        if(code==0)
+            break;
+
+        u8 * abbrevPosition = find_names_abbrev(table,code,cuIndex->needsSwap);
+        if(!abbrevPosition)
+            break;
+
+        data_reader_t abbrev;
+        reader_init(&abbrev,abbrevPosition,table->entryPool-abbrevPosition,cuIndex->needsSwap);
+        u64 tag = reader_uleb128(&abbrev);
+
+        // Units are numbered only when the table indexes more than one
+        u64 cuNumber=0;
+        u64 dieOffset=0;
+        u8 hasDieOffset=0;
+
+        while(!abbrev.error){
+            u64 indexAttr = reader_uleb128(&abbrev);
+            u64 form = reader_uleb128(&abbrev);
+            if(indexAttr==0 && form==0)
+                break;
+
+            dwarf_form_value_t formValue;
+            s64 implicitConst = form==DW_FORM_implicit_const ? reader_sleb128(&abbrev) : 0;
+            if(!read_form(&reader,&unit,form,implicitConst,&formValue))
+                return numOfMatches;
+
+            if(indexAttr==DW_IDX_compile_unit)
+                cuNumber=formValue.value;
+            else if(indexAttr==DW_IDX_die_offset){
+                dieOffset=formValue.value;
+                hasDieOffset=1;
+            }
+        }
+
+        if(tag!=DW_TAG_subprogram || !hasDieOffset || cuNumber>=table->numOfCus)
+            continue;
+
+        u64 cuOffset = read_uint_at(table->cuOffsets+cuNumber*offsetSize,offsetSize,cuIndex->needsSwap);
+        matches[numOfMatches].cuOffset=cuOffset;
+        matches[numOfMatches].dieOffset=cuOffset+dieOffset;
+        numOfMatches++;
+    }
+
+    return numOfMatches;
+}
+
+
+/* Find the functions of a name in .debug_names */
+static u32 lookup_names_tables(dwarf_cu_index_t * cuIndex, u8 * name, dwarf_name_match_t * matches){
+
+    u32 numOfMatches=0;
+    u32 hash = names_hash(name);
+
+    for(u32 t=0;t<cuIndex->numOfNamesTables;t++){
+
+        dwarf_names_table_t * table = &cuIndex->namesTables[t];
+        u8 offsetSize = table->is64 ? 8 : 4;
+        u32 first=0, last=table->numOfNames;
+
+        // The names of a bucket are consecutive, starting at the one the bucket gives
+        if(table->numOfBuckets){
+            u32 bucket = hash % table->numOfBuckets;
+            u32 firstName = read_uint_at(table->buckets+bucket*4,4,cuIndex->needsSwap);
+            if(firstName==0 || firstName>table->numOfNames)
+                continue;
+            first=firstName-1;
+        }
+
+        for(u32 i=first;i<last;i++){
+
+            if(table->numOfBuckets){
+                u32 nameHash = read_uint_at(table->hashes+(u64)i*4,4,cuIndex->needsSwap);
+                if(nameHash % table->numOfBuckets != hash % table->numOfBuckets)
+                    break;
+                if(nameHash!=hash)
+                    continue;
+            }
+
+            u64 strOffset = read_uint_at(table->stringOffsets+(u64)i*offsetSize,offsetSize,cuIndex->needsSwap);
+            if(strOffset>=cuIndex->strings.debugStrSize || strcmp(cuIndex->strings.debugStr+strOffset,name)!=0)
+                continue;
+
+            numOfMatches = read_names_entries(cuIndex,table,i,matches,numOfMatches);
+        }
+    }
+
+    return numOfMatches;
+}
+
+
+/* Hash of the names of .gdb_index */
+static u32 gdb_index_hash(u8 * name){
+
+    u32 hash=0;
+    for(;*name;name++)
+        hash = hash*67 + tolower(*name) - 113;
+
+    return hash;
+}
+
+
+/* Find the units defining a name in .gdb_index */
+static u32 lookup_gdb_index(dwarf_cu_index_t * cuIndex, u8 * name, dwarf_name_match_t * matches){
+
+    u8 needsSwap = ELF_HOST_ENCODING!=ELFDATA2LSB;
+    u64 numOfSlots = cuIndex->numOfGdbSlots;
+    u64 constantPoolSize = cuIndex->gdbIndex + cuIndex->gdbIndexSize - cuIndex->gdbConstantPool;
+
+    // The table is open addressed with a power of two slots
+    if(!numOfSlots || (numOfSlots & (numOfSlots-1)))
+        return 0;
+
+    u32 hash = gdb_index_hash(name);
+    u64 slot = hash & (numOfSlots-1);
+    u64 step = ((hash*17) & (numOfSlots-1)) | 1;
+
+    for(u64 probes=0;probes<numOfSlots;probes++,slot=(slot+step)&(numOfSlots-1)){
+
+        u32 nameOffset = read_uint_at(cuIndex->gdbSymbolTable+slot*8,4,needsSwap);
+        u32 vectorOffset = read_uint_at(cuIndex->gdbSymbolTable+slot*8+4,4,needsSwap);
+        if(nameOffset==0 && vectorOffset==0)
+            return 0;
+
+        if(nameOffset>=constantPoolSize || !memchr(cuIndex->gdbConstantPool+nameOffset,0,constantPoolSize-nameOffset) ||
+           strcmp(cuIndex->gdbConstantPool+nameOffset,name)!=0)
+            continue;
+
+        if((u64)vectorOffset+4>constantPoolSize)
+            return 0;
+
+        // The unit vector is a count followed by the unit numbers, with the symbol kind in their top bits
+        u32 numOfEntries = read_uint_at(cuIndex->gdbConstantPool+vectorOffset,4,needsSwap);
+        u32 numOfMatches=0;
+        for(u32 i=0;i<numOfEntries && numOfMatches<DWARF_MAX_NAME_MATCHES;i++){
+            if((u64)vectorOffset+8+i*4>constantPoolSize)
+                break;
+            u32 cuNumber = read_uint_at(cuIndex->gdbConstantPool+vectorOffset+4+i*4,4,needsSwap) & 0xffffff;
+            if(cuNumber>=cuIndex->numOfGdbCus)
+                continue;
+            matches[numOfMatches].cuOffset=read_uint_at(cuIndex->gdbCuList+cuNumber*16,8,needsSwap);
+            matches[numOfMatches].dieOffset=0;
+            numOfMatches++;
+        }
+        return numOfMatches;
+    }
+
+    return 0;
+}
+
+
+/* Compare the address ranges by their first address */
+static s32 compare_cu_ranges(const void * a, const void * b){
+
+    u64 lowA = ((dwarf_cu_range_t *)a)->low;
+    u64 lowB = ((dwarf_cu_range_t *)b)->low;
+
+    return (lowA>lowB) - (lowA<lowB);
+}
+
+
+/* Get the compilation unit index of the file, building it on the first call */
+dwarf_cu_index_t * dwarf_get_cu_index(kvelf_basic_params_t * kvelfp){
+
+    if(kvelfp->cuIndex)
+        return kvelfp->cuIndex;
+
+    dwarf_cu_index_t * cuIndex = calloc(1,sizeof(dwarf_cu_index_t));
+    cuIndex->needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+
+    cuIndex->debugInfo = dwarf_get_section(kvelfp,".debug_info",&cuIndex->debugInfoSize);
+    cuIndex->debugAbbrev = dwarf_get_section(kvelfp,".debug_abbrev",&cuIndex->debugAbbrevSize);
+    if(!cuIndex->debugInfo || !cuIndex->debugAbbrev){
+        debug("No .debug_info and .debug_abbrev sections to look functions up in\n",DEBUG_STATUS_ERROR);
+        free(cuIndex);
+        return NULL;
+    }
+
+    cuIndex->debugStrOffsets = dwarf_get_section(kvelfp,".debug_str_offsets",&cuIndex->debugStrOffsetsSize);
+    cuIndex->debugAddr = dwarf_get_section(kvelfp,".debug_addr",&cuIndex->debugAddrSize);
+    cuIndex->strings.debugStr = dwarf_get_section(kvelfp,".debug_str",&cuIndex->strings.debugStrSize);
+    cuIndex->strings.debugLineStr = dwarf_get_section(kvelfp,".debug_line_str",&cuIndex->strings.debugLineStrSize);
+
+    u64 rangesCapacity=0;
+
+    // Address ranges come from .debug_aranges, or from .gdb_index when there are none
+    u64 debugArangesSize;
+    u8 * debugAranges = dwarf_get_section(kvelfp,".debug_aranges",&debugArangesSize);
+    if(debugAranges)
+        read_aranges(cuIndex,debugAranges,debugArangesSize,&rangesCapacity);
+
+    cuIndex->gdbIndex = dwarf_get_section(kvelfp,".gdb_index",&cuIndex->gdbIndexSize);
+    if(cuIndex->gdbIndex && !read_gdb_index(cuIndex,&rangesCapacity,cuIndex->numOfRanges==0))
+        cuIndex->gdbIndex=NULL;
+
+    qsort(cuIndex->ranges,cuIndex->numOfRanges,sizeof(dwarf_cu_range_t),compare_cu_ranges);
+
+    u64 debugNamesSize;
+    u8 * debugNames = dwarf_get_section(kvelfp,".debug_names",&debugNamesSize);
+    if(debugNames)
+        read_names_tables(cuIndex,debugNames,debugNamesSize);
+
+    kvelfp->cuIndex = cuIndex;
+
+    return cuIndex;
+}
+
+
+/* Free a compilation unit index and the units decoded in its cache */
+void dwarf_cu_index_free(dwarf_cu_index_t * cuIndex){
+
+    if(!cuIndex)
+        return;
+
+    for(u32 i=0;i<cuIndex->numOfCachedCus;i++)
+        free(cuIndex->cachedCus[i].functions);
+    free(cuIndex->ranges);
+    free(cuIndex->namesTables);
+    free(cuIndex);
+}
+
+
+/* Find the offset of the compilation unit covering an address, returns -1 if no unit covers it */
+s64 dwarf_find_cu_by_address(dwarf_cu_index_t * cuIndex, u64 address){
+
+    dwarf_cu_range_t * ranges = cuIndex->ranges;
+
+    if(!cuIndex->numOfRanges || address<ranges[0].low)
+        return -1;
+
+    // Last range starting at or below the address
+    u64 base=0, count=cuIndex->numOfRanges;
+    while(count>1){
+        u64 half=count/2;
+        base = (ranges[base+half].low<=address) ? base+half : base;
+        count-=half;
+    }
+
+    return address<ranges[base].high ? (s64)ranges[base].cuOffset : -1;
+}
+
+
+/* Get a decoded compilation unit from the cache, decoding it if it is not there */
+dwarf_cu_t * dwarf_get_cu(dwarf_cu_index_t * cuIndex, u64 cuOffset){
+
+    cuIndex->useClock++;
+
+    for(u32 i=0;i<cuIndex->numOfCachedCus;i++){
+        if(cuIndex->cachedCus[i].offset==cuOffset){
+            cuIndex->cachedCus[i].lastUse=cuIndex->useClock;
+            return &cuIndex->cachedCus[i];
+        }
+    }
+
+    // A full cache gives up its least recently used unit
+    dwarf_cu_t * cu;
+    if(cuIndex->numOfCachedCus<DWARF_CU_CACHE_SIZE)
+        cu = &cuIndex->cachedCus[cuIndex->numOfCachedCus++];
+    else{
+        cu = &cuIndex->cachedCus[0];
+        for(u32 i=1;i<DWARF_CU_CACHE_SIZE;i++)
+            if(cuIndex->cachedCus[i].lastUse<cu->lastUse)
+                cu = &cuIndex->cachedCus[i];
+        free(cu->functions);
+    }
+
+    decode_cu(cuIndex,cuOffset,cu);
+    cu->lastUse=cuIndex->useClock;
+
+    return cu;
+}
+
+
+/* Find the function containing an address in a decoded compilation unit */
+dwarf_function_t * dwarf_find_function_by_address(dwarf_cu_t * cu, u64 address){
+
+    if(!cu->numOfFunctions || address<cu->functions[0].low)
+        return NULL;
+
+    u64 base=0, count=cu->numOfFunctions;
+    while(count>1){
+        u64 half=count/2;
+        base = (cu->functions[base+half].low<=address) ? base+half : base;
+        count-=half;
+    }
+
+    // A nested function may start after the one containing the address
+    for(u64 i=0;i<DWARF_MAX_NESTED_FUNCTIONS && i<=base;i++)
+        if(address<cu->functions[base-i].high)
+            return &cu->functions[base-i];
+
+    return NULL;
+}
+
+
+/* Print a function and its unit */
+static void print_function(dwarf_cu_t * cu, dwarf_function_t * function){
+
+    display("Function: ",DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"%s\n",function->name);
+
+    display("Range: ",DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"0x%016llx-0x%016llx\n",function->low,function->high);
+
+    display("Unit: ",DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"%s (0x%llx)\n",cu->name,cu->offset);
+
+    if(function->declLine){
+        display("Line: ",DISPLAY_COLOR_ORANGE);
+        fprintf(display_output(),"%u\n",function->declLine);
+    }
+
+    fprintf(display_output(),"\n");
+}
+
+
+/* Print the functions at the addresses of the symbols named like the query, for the files without
+a name index. Returns how many were printed */
+static u32 print_symbols_functions(kvelf_basic_params_t * kvelfp, dwarf_cu_index_t * cuIndex, u8 * name){
+
+    if(!cuIndex->numOfRanges)
+        return 0;
+
+    symbol_index_t * symbols = symbol_get_index(kvelfp);
+    u32 numOfFound=0;
+
+    for(u64 i=0;i<symbols->numOfEntries;i++){
+        symbol_index_entry_t * symbol = &symbols->entries[i];
+        if(strcmp((char *)symbol->name,(char *)name))
+            continue;
+
+        s64 cuOffset = dwarf_find_cu_by_address(cuIndex,symbol->address);
+        dwarf_cu_t * cu = cuOffset<0 ? NULL : dwarf_get_cu(cuIndex,cuOffset);
+        dwarf_function_t * function = cu ? dwarf_find_function_by_address(cu,symbol->address) : NULL;
+        if(function){
+            print_function(cu,function);
+            numOfFound++;
+        }
+    }
+
+    return numOfFound;
+}
+
+
+/* Print the functions of a unit matching an entry, or named like the query when the entry is 0 */
+static u32 print_matching_functions(dwarf_cu_t * cu, u64 dieOffset, u8 * name){
+
+    u32 numOfFound=0;
+
+    for(u64 j=0;j<cu->numOfFunctions;j++){
+        dwarf_function_t * function = &cu->functions[j];
+        if(dieOffset ? function->dieOffset==dieOffset : strcmp(function->name,name)==0){
+            print_function(cu,function);
+            numOfFound++;
+        }
+    }
+
+    return numOfFound;
+}
+
+
+/* Look a function up by an address or a name and print where it is */
+void dwarf_lookup_function(kvelf_basic_params_t * kvelfp, u8 * query){
+
+    u8 * savePtr;
+    u8 * token = strtok_r(query," \t\n",(char **)&savePtr);
+    if(!token){
+        debug("Usage: func ADDR|NAME\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    dwarf_cu_index_t * cuIndex = dwarf_get_cu_index(kvelfp);
+    if(!cuIndex)
+        return;
+
+    // Addresses start with a digit, names cannot
+    if(isdigit(token[0])){
+
+        u8 * end;
+        u64 address = strtoull(token,(char **)&end,16);
+        if(*end){
+            display_error("Invalid address \"%s\"\n",token);
+            return;
+        }
+
+        if(!cuIndex->numOfRanges){
+            debug("No .debug_aranges or .gdb_index to find the units by address\n",DEBUG_STATUS_ERROR);
+            return;
+        }
+
+        s64 cuOffset = dwarf_find_cu_by_address(cuIndex,address);
+        dwarf_cu_t * cu = cuOffset<0 ? NULL : dwarf_get_cu(cuIndex,cuOffset);
+        dwarf_function_t * function = cu ? dwarf_find_function_by_address(cu,address) : NULL;
+
+        if(!function)
+            fprintf(display_output(),"No function contains 0x%llx\n",address);
+        else
+            print_function(cu,function);
+        return;
+    }
+
+    // Without a name index, the symbols lead to the functions by their addresses, and the names no symbol
+    // leads to, like the unqualified ones of C++ functions, are looked for in every unit
+    if(!cuIndex->numOfNamesTables && !cuIndex->gdbIndex){
+        u32 numOfFound = print_symbols_functions(kvelfp,cuIndex,token);
+        if(!numOfFound){
+            dwarf_unit_t unit;
+            for(u64 offset=0;read_unit_header(cuIndex,offset,&unit);offset=unit.end-cuIndex->debugInfo)
+                numOfFound += print_matching_functions(dwarf_get_cu(cuIndex,offset),0,token);
+        }
+        if(!numOfFound)
+            fprintf(display_output(),"No function named %s\n",token);
+        return;
+    }
+
+    dwarf_name_match_t matches[DWARF_MAX_NAME_MATCHES];
+    u32 numOfMatches = cuIndex->numOfNamesTables ? lookup_names_tables(cuIndex,token,matches) : lookup_gdb_index(cuIndex,token,matches);
+
+    u32 numOfFound=0;
+    for(u32 i=0;i<numOfMatches;i++){
+
+        // A unit listed twice would print its functions twice
+        u8 seen=0;
+        for(u32 j=0;j<i;j++)
+            seen |= matches[j].cuOffset==matches[i].cuOffset && matches[j].dieOffset==matches[i].dieOffset;
+        if(seen)
+            continue;
+
+        numOfFound += print_matching_functions(dwarf_get_cu(cuIndex,matches[i].cuOffset),matches[i].dieOffset,token);
+    }
+
+    if(!numOfFound)
+        fprintf(display_output(),"No function named %s\n",token);
+}
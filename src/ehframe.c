@@ -0,0 +1,663 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./layout.h"
+#include "./ehframe.h"
+
+
+
+/* Read a pointer in the given encoding, the reader has to cover the whole section at sectionVAddr */
+static u64 read_encoded_pointer(data_reader_t * reader, u8 encoding, u64 sectionVAddr, u64 dataRelBase, u8 addressSize){
+
+    if(encoding==DW_EH_PE_omit)
+        return 0;
+
+    u64 fieldVAddr = sectionVAddr + (reader->pos - reader->start);
+    u64 value;
+
+    switch(encoding & 0x0f){
+        case DW_EH_PE_absptr:
+            value = reader_uint(reader,addressSize);
+            break;
+        case DW_EH_PE_uleb128:
+            value = reader_uleb128(reader);
+            break;
+        case DW_EH_PE_udata2:
+            value = reader_u16(reader);
+            break;
+        case DW_EH_PE_udata4:
+            value = reader_u32(reader);
+            break;
+        case DW_EH_PE_udata8:
+            value = reader_u64(reader);
+            break;
+        case DW_EH_PE_sleb128:
+            value = (u64)reader_sleb128(reader);
+            break;
+        case DW_EH_PE_sdata2:
+            value = (u64)(s64)(s16)reader_u16(reader);
+            break;
+        case DW_EH_PE_sdata4:
+            value = (u64)(s64)(s32)reader_u32(reader);
+            break;
+        case DW_EH_PE_sdata8:
+            value = reader_u64(reader);
+            break;
+        default:
+            reader->error=1;
+            return 0;
+    }
+
+    // Text and function relative pointers need bases the file does not give
+    if((encoding & 0x70)==DW_EH_PE_pcrel)
+        value += fieldVAddr;
+    else if((encoding & 0x70)==DW_EH_PE_datarel)
+        value += dataRelBase;
+
+    if(addressSize==4)
+        value &= 0xffffffff;
+
+    return value;
+}
+
+
+/* Size of the fixed-size pointer formats, 0 for the variable and unknown ones */
+static u8 encoded_pointer_size(u8 encoding, u8 addressSize){
+
+    switch(encoding & 0x0f){
+        case DW_EH_PE_absptr:
+            return addressSize;
+        case DW_EH_PE_udata2:
+        case DW_EH_PE_sdata2:
+            return 2;
+        case DW_EH_PE_udata4:
+        case DW_EH_PE_sdata4:
+            return 4;
+        case DW_EH_PE_udata8:
+        case DW_EH_PE_sdata8:
+            return 8;
+    }
+
+    return 0;
+}
+
+
+/* Read the length of an entry, returns 0 for the terminator and the entries which do not fit */
+static u64 read_entry_length(data_reader_t * reader, u8 * is64){
+
+    *is64=0;
+    u64 length = reader_u32(reader);
+    if(length==0xffffffff){
+        length = reader_u64(reader);
+        *is64=1;
+    }
+
+    if(reader->error || length>reader_left(reader))
+        return 0;
+
+    return length;
+}
+
+
+/* Decode the CIE at the given offset of .eh_frame, returns 0 if it is not a valid CIE */
+u8 eh_frame_decode_cie(eh_frame_index_t * ehIndex, u64 cieOffset, eh_frame_cie_t * cie){
+
+    if(cieOffset>=ehIndex->ehFrameSize)
+        return 0;
+
+    data_reader_t reader;
+    reader_init(&reader,ehIndex->ehFrame,ehIndex->ehFrameSize,ehIndex->needsSwap);
+    reader.pos+=cieOffset;
+
+    u8 is64;
+    u64 length = read_entry_length(&reader,&is64);
+    if(!length)
+        return 0;
+    u8 * end = reader.pos+length;
+
+    // The id of the CIEs is 0 in .eh_frame
+    if(reader_uint(&reader,is64 ? 8 : 4)!=0)
+        return 0;
+
+    cie->offset = cieOffset;
+    cie->version = reader_u8(&reader);
+    cie->augmentation = reader_string(&reader);
+    if(!cie->augmentation)
+        return 0;
+
+    // The old "eh" augmentation carries a pointer
+    if(strstr(cie->augmentation,"eh"))
+        reader_skip(&reader,ehIndex->addressSize);
+
+    // Address and segment selector sizes
+    if(cie->version>=4)
+        reader_skip(&reader,2);
+
+    cie->codeAlign = reader_uleb128(&reader);
+    cie->dataAlign = reader_sleb128(&reader);
+    cie->returnRegister = cie->version==1 ? reader_u8(&reader) : reader_uleb128(&reader);
+    cie->fdeEncoding = DW_EH_PE_absptr;
+    cie->lsdaEncoding = DW_EH_PE_omit;
+    cie->personality = 0;
+
+    // The "z" augmentations give the size of their data, the letters tell what it holds
+    if(cie->augmentation[0]=='z'){
+        u64 augmentationSize = reader_uleb128(&reader);
+        if(augmentationSize>reader_left(&reader))
+            return 0;
+        u8 * augmentationEnd = reader.pos+augmentationSize;
+
+        for(u8 * letter=cie->augmentation+1;*letter && !reader.error;letter++){
+            if(*letter=='L')
+                cie->lsdaEncoding = reader_u8(&reader);
+            else if(*letter=='R')
+                cie->fdeEncoding = reader_u8(&reader);
+            else if(*letter=='P'){
+                u8 personalityEncoding = reader_u8(&reader);
+                cie->personality = read_encoded_pointer(&reader,personalityEncoding & ~DW_EH_PE_indirect,ehIndex->ehFrameVAddr,ehIndex->ehFrameHdrVAddr,ehIndex->addressSize);
+            }else if(*letter!='S' && *letter!='B' && *letter!='G')
+                break;
+        }
+        reader.pos=augmentationEnd;
+    }
+
+    if(reader.error || reader.pos>end)
+        return 0;
+
+    cie->instructions = reader.pos;
+    cie->instructionsSize = end-reader.pos;
+
+    return 1;
+}
+
+
+/* Decode the FDE at the given offset of .eh_frame with its CIE, returns 0 if it is not a valid FDE */
+u8 eh_frame_decode_fde(eh_frame_index_t * ehIndex, u64 fdeOffset, eh_frame_fde_t * fde, eh_frame_cie_t * cie){
+
+    if(fdeOffset>=ehIndex->ehFrameSize)
+        return 0;
+
+    data_reader_t reader;
+    reader_init(&reader,ehIndex->ehFrame,ehIndex->ehFrameSize,ehIndex->needsSwap);
+    reader.pos+=fdeOffset;
+
+    u8 is64;
+    u64 length = read_entry_length(&reader,&is64);
+    if(!length)
+        return 0;
+    u8 * end = reader.pos+length;
+
+    // The FDEs point back to their CIE from their CIE pointer field
+    u64 ciePointerOffset = reader.pos-reader.start;
+    u64 ciePointer = reader_uint(&reader,is64 ? 8 : 4);
+    if(ciePointer==0 || ciePointer>ciePointerOffset)
+        return 0;
+
+    fde->offset = fdeOffset;
+    fde->cieOffset = ciePointerOffset-ciePointer;
+    if(cie->offset!=fde->cieOffset && !eh_frame_decode_cie(ehIndex,fde->cieOffset,cie))
+        return 0;
+
+    fde->pcBegin = read_encoded_pointer(&reader,cie->fdeEncoding,ehIndex->ehFrameVAddr,ehIndex->ehFrameHdrVAddr,ehIndex->addressSize);
+    // The range is a size, only the format of the encoding applies
+    fde->pcRange = read_encoded_pointer(&reader,cie->fdeEncoding & 0x0f,ehIndex->ehFrameVAddr,0,ehIndex->addressSize);
+    fde->lsda = 0;
+
+    if(cie->augmentation[0]=='z'){
+        u64 augmentationSize = reader_uleb128(&reader);
+        if(augmentationSize>reader_left(&reader))
+            return 0;
+        u8 * augmentationEnd = reader.pos+augmentationSize;
+
+        if(augmentationSize && cie->lsdaEncoding!=DW_EH_PE_omit)
+            fde->lsda = read_encoded_pointer(&reader,cie->lsdaEncoding & ~DW_EH_PE_indirect,ehIndex->ehFrameVAddr,ehIndex->ehFrameHdrVAddr,ehIndex->addressSize);
+        reader.pos=augmentationEnd;
+    }
+
+    if(reader.error || reader.pos>end)
+        return 0;
+
+    fde->instructions = reader.pos;
+    fde->instructionsSize = end-reader.pos;
+
+    return 1;
+}
+
+
+/* Compare the FDEs by their first address */
+static s32 compare_eh_frame_entries(const void * a, const void * b){
+
+    u64 pcA = ((eh_frame_entry_t *)a)->pcBegin;
+    u64 pcB = ((eh_frame_entry_t *)b)->pcBegin;
+
+    return (pcA>pcB) - (pcA<pcB);
+}
+
+
+/* Walk the whole .eh_frame once and sort its FDEs by address */
+void eh_frame_build_entries(eh_frame_index_t * ehIndex){
+
+    u64 entriesCapacity=256;
+    ehIndex->entries = malloc(entriesCapacity*sizeof(eh_frame_entry_t));
+    ehIndex->numOfEntries = 0;
+
+    // The CIE of the last FDE, consecutive FDEs mostly share it
+    eh_frame_cie_t cie;
+    cie.offset = (u64)-1;
+
+    data_reader_t reader;
+    reader_init(&reader,ehIndex->ehFrame,ehIndex->ehFrameSize,ehIndex->needsSwap);
+
+    while(reader_left(&reader)>=4){
+
+        u64 entryOffset = reader.pos-reader.start;
+        u8 is64;
+        u64 length = read_entry_length(&reader,&is64);
+        if(!length)
+            break;
+
+        u64 id = reader_uint(&reader,is64 ? 8 : 4);
+        reader.pos = reader.start+entryOffset+(is64 ? 12 : 4)+length;
+
+        eh_frame_fde_t fde;
+        if(id==0 || !eh_frame_decode_fde(ehIndex,entryOffset,&fde,&cie))
+            continue;
+
+        if(ehIndex->numOfEntries==entriesCapacity){
+            entriesCapacity*=2;
+            ehIndex->entries = realloc(ehIndex->entries,entriesCapacity*sizeof(eh_frame_entry_t));
+        }
+
+        ehIndex->entries[ehIndex->numOfEntries].pcBegin = fde.pcBegin;
+        ehIndex->entries[ehIndex->numOfEntries].pcRange = fde.pcRange;
+        ehIndex->entries[ehIndex->numOfEntries].fdeOffset = entryOffset;
+        ehIndex->numOfEntries++;
+    }
+
+    qsort(ehIndex->entries,ehIndex->numOfEntries,sizeof(eh_frame_entry_t),compare_eh_frame_entries);
+}
+
+
+/* Read the header of .eh_frame_hdr and locate its search table */
+static void read_eh_frame_hdr(eh_frame_index_t * ehIndex){
+
+    data_reader_t reader;
+    reader_init(&reader,ehIndex->ehFrameHdr,ehIndex->ehFrameHdrSize,ehIndex->needsSwap);
+
+    u8 version = reader_u8(&reader);
+    u8 ehFramePointerEncoding = reader_u8(&reader);
+    u8 fdeCountEncoding = reader_u8(&reader);
+    ehIndex->tableEncoding = reader_u8(&reader);
+    if(version!=1)
+        return;
+
+    u64 ehFrameVAddr = read_encoded_pointer(&reader,ehFramePointerEncoding,ehIndex->ehFrameHdrVAddr,ehIndex->ehFrameHdrVAddr,ehIndex->addressSize);
+    u64 numOfTableEntries = read_encoded_pointer(&reader,fdeCountEncoding,ehIndex->ehFrameHdrVAddr,ehIndex->ehFrameHdrVAddr,ehIndex->addressSize);
+
+    // Without a section header for .eh_frame, the header tells where it is
+    if(!ehIndex->ehFrameVAddr)
+        ehIndex->ehFrameVAddr = ehFrameVAddr;
+
+    // Binary search needs fixed-size entries
+    u8 valueSize = encoded_pointer_size(ehIndex->tableEncoding,ehIndex->addressSize);
+    u8 application = ehIndex->tableEncoding & 0x70;
+    if(reader.error || fdeCountEncoding==DW_EH_PE_omit || ehIndex->tableEncoding==DW_EH_PE_omit || !valueSize ||
+       (application!=DW_EH_PE_absptr && application!=DW_EH_PE_datarel) || numOfTableEntries>reader_left(&reader)/(2*valueSize))
+        return;
+
+    ehIndex->table = reader.pos;
+    ehIndex->numOfTableEntries = numOfTableEntries;
+}
+
+
+/* Read a value of the search table of .eh_frame_hdr */
+static u64 read_table_value(eh_frame_index_t * ehIndex, u64 entryIdx, u8 second){
+
+    u8 valueSize = encoded_pointer_size(ehIndex->tableEncoding,ehIndex->addressSize);
+
+    data_reader_t reader;
+    reader_init(&reader,ehIndex->ehFrameHdr,ehIndex->ehFrameHdrSize,ehIndex->needsSwap);
+    reader.pos = ehIndex->table + (entryIdx*2+second)*valueSize;
+
+    return read_encoded_pointer(&reader,ehIndex->tableEncoding,ehIndex->ehFrameHdrVAddr,ehIndex->ehFrameHdrVAddr,ehIndex->addressSize);
+}
+
+
+/* Get the .eh_frame index of the file, locating the sections on the first call */
+eh_frame_index_t * eh_frame_get_index(kvelf_basic_params_t * kvelfp){
+
+    if(kvelfp->ehFrameIndex)
+        return kvelfp->ehFrameIndex;
+
+    eh_frame_index_t * ehIndex = calloc(1,sizeof(eh_frame_index_t));
+    ehIndex->needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    ehIndex->addressSize = kvelfp->elfClass==ELFCLASS32 ? 4 : 8;
+
+    // The sections are found by name, or through PT_GNU_EH_FRAME in the files without section headers
+    s64 hdrIdx = find_section_by_name(kvelfp,".eh_frame_hdr");
+    if(hdrIdx>=0){
+        ehIndex->ehFrameHdr = get_section_contents(kvelfp,hdrIdx,&ehIndex->ehFrameHdrSize);
+        ehIndex->ehFrameHdrVAddr = kvelfp->elfSectionsMetadata[hdrIdx].sVAddr;
+    }else if((hdrIdx=find_segment_by_type(kvelfp,PT_GNU_EH_FRAME))>=0){
+        ehIndex->ehFrameHdr = get_segment_contents(kvelfp,hdrIdx,&ehIndex->ehFrameHdrSize);
+        ehIndex->ehFrameHdrVAddr = kvelfp->elfSegmentsMetadata[hdrIdx].pVAddr;
+    }
+
+    s64 ehFrameIdx = find_section_by_name(kvelfp,".eh_frame");
+    if(ehFrameIdx>=0){
+        ehIndex->ehFrame = get_section_contents(kvelfp,ehFrameIdx,&ehIndex->ehFrameSize);
+        ehIndex->ehFrameVAddr = kvelfp->elfSectionsMetadata[ehFrameIdx].sVAddr;
+    }
+
+    if(ehIndex->ehFrameHdr)
+        read_eh_frame_hdr(ehIndex);
+
+    // .eh_frame runs up to its terminator, the end of its segment bounds it
+    if(!ehIndex->ehFrame && ehIndex->ehFrameVAddr)
+        ehIndex->ehFrame = get_vaddr_contents(kvelfp,ehIndex->ehFrameVAddr,&ehIndex->ehFrameSize);
+
+    if(!ehIndex->ehFrame){
+        debug("No .eh_frame section or PT_GNU_EH_FRAME segment\n",DEBUG_STATUS_ERROR);
+        free(ehIndex);
+        return NULL;
+    }
+
+    kvelfp->ehFrameIndex = ehIndex;
+
+    return ehIndex;
+}
+
+
+/* Free an .eh_frame index and its sorted FDEs */
+void eh_frame_index_free(eh_frame_index_t * ehIndex){
+
+    if(!ehIndex)
+        return;
+
+    free(ehIndex->entries);
+    free(ehIndex);
+}
+
+
+/* Find the offset of the FDE covering an address, returns -1 if no FDE covers it */
+s64 eh_frame_find_fde(eh_frame_index_t * ehIndex, u64 address){
+
+    u64 fdeOffset;
+
+    if(ehIndex->numOfTableEntries){
+
+        // The search table of .eh_frame_hdr is already sorted
+        if(address<read_table_value(ehIndex,0,0))
+            return -1;
+
+        u64 base=0, count=ehIndex->numOfTableEntries;
+        while(count>1){
+            u64 half=count/2;
+            base = (read_table_value(ehIndex,base+half,0)<=address) ? base+half : base;
+            count-=half;
+        }
+        fdeOffset = read_table_value(ehIndex,base,1)-ehIndex->ehFrameVAddr;
+
+    }else{
+
+        if(!ehIndex->entries)
+            eh_frame_build_entries(ehIndex);
+
+        if(!ehIndex->numOfEntries || address<ehIndex->entries[0].pcBegin)
+            return -1;
+
+        u64 base=0, count=ehIndex->numOfEntries;
+        while(count>1){
+            u64 half=count/2;
+            base = (ehIndex->entries[base+half].pcBegin<=address) ? base+half : base;
+            count-=half;
+        }
+        fdeOffset = ehIndex->entries[base].fdeOffset;
+    }
+
+    // The FDE starting below the address may end before it
+    eh_frame_cie_t cie;
+    eh_frame_fde_t fde;
+    cie.offset = (u64)-1;
+    if(!eh_frame_decode_fde(ehIndex,fdeOffset,&fde,&cie) || address-fde.pcBegin>=fde.pcRange)
+        return -1;
+
+    return fdeOffset;
+}
+
+
+/* Print call frame instructions, the location starts at the function's first address */
+static void print_cfa_instructions(eh_frame_index_t * ehIndex, eh_frame_cie_t * cie, u8 * instructions, u64 instructionsSize, u64 location){
+
+    data_reader_t reader;
+    reader_init(&reader,instructions,instructionsSize,ehIndex->needsSwap);
+
+    while(reader_left(&reader) && !reader.error){
+
+        u8 opcode = reader_u8(&reader);
+        u8 operand = opcode & 0x3f;
+
+        fprintf(display_output(),"    ");
+
+        switch(opcode & 0xc0){
+            case DW_CFA_advance_loc:
+                location += operand*cie->codeAlign;
+                fprintf(display_output(),"DW_CFA_advance_loc: %u to 0x%llx\n",operand*(u32)cie->codeAlign,location);
+                continue;
+            case DW_CFA_offset:
+                fprintf(display_output(),"DW_CFA_offset: r%u at cfa%+lld\n",operand,(s64)reader_uleb128(&reader)*cie->dataAlign);
+                continue;
+            case DW_CFA_restore:
+                fprintf(display_output(),"DW_CFA_restore: r%u\n",operand);
+                continue;
+        }
+
+        switch(opcode){
+            case DW_CFA_nop:
+                fprintf(display_output(),"DW_CFA_nop\n");
+                break;
+            case DW_CFA_set_loc:
+                location = read_encoded_pointer(&reader,cie->fdeEncoding & 0x0f,0,0,ehIndex->addressSize);
+                fprintf(display_output(),"DW_CFA_set_loc: 0x%llx\n",location);
+                break;
+            case DW_CFA_advance_loc1:
+            case DW_CFA_advance_loc2:
+            case DW_CFA_advance_loc4:{
+                u64 delta = reader_uint(&reader,opcode==DW_CFA_advance_loc1 ? 1 : opcode==DW_CFA_advance_loc2 ? 2 : 4)*cie->codeAlign;
+                location += delta;
+                fprintf(display_output(),"DW_CFA_advance_loc%u: %llu to 0x%llx\n",opcode==DW_CFA_advance_loc4 ? 4 : opcode-1,delta,location);
+                break;
+            }
+            case DW_CFA_offset_extended:{
+                u64 reg = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_offset_extended: r%llu at cfa%+lld\n",reg,(s64)reader_uleb128(&reader)*cie->dataAlign);
+                break;
+            }
+            case DW_CFA_restore_extended:
+                fprintf(display_output(),"DW_CFA_restore_extended: r%llu\n",reader_uleb128(&reader));
+                break;
+            case DW_CFA_undefined:
+                fprintf(display_output(),"DW_CFA_undefined: r%llu\n",reader_uleb128(&reader));
+                break;
+            case DW_CFA_same_value:
+                fprintf(display_output(),"DW_CFA_same_value: r%llu\n",reader_uleb128(&reader));
+                break;
+            case DW_CFA_register:{
+                u64 reg = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_register: r%llu in r%llu\n",reg,reader_uleb128(&reader));
+                break;
+            }
+            case DW_CFA_remember_state:
+                fprintf(display_output(),"DW_CFA_remember_state\n");
+                break;
+            case DW_CFA_restore_state:
+                fprintf(display_output(),"DW_CFA_restore_state\n");
+                break;
+            case DW_CFA_def_cfa:{
+                u64 reg = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_def_cfa: r%llu ofs %llu\n",reg,reader_uleb128(&reader));
+                break;
+            }
+            case DW_CFA_def_cfa_register:
+                fprintf(display_output(),"DW_CFA_def_cfa_register: r%llu\n",reader_uleb128(&reader));
+                break;
+            case DW_CFA_def_cfa_offset:
+                fprintf(display_output(),"DW_CFA_def_cfa_offset: %llu\n",reader_uleb128(&reader));
+                break;
+            case DW_CFA_def_cfa_expression:{
+                u64 expressionSize = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_def_cfa_expression (%llu bytes)\n",expressionSize);
+                reader_skip(&reader,expressionSize);
+                break;
+            }
+            case DW_CFA_expression:
+            case DW_CFA_val_expression:{
+                u64 reg = reader_uleb128(&reader);
+                u64 expressionSize = reader_uleb128(&reader);
+                fprintf(display_output(),"%s: r%llu (%llu bytes)\n",opcode==DW_CFA_expression ? "DW_CFA_expression" : "DW_CFA_val_expression",reg,expressionSize);
+                reader_skip(&reader,expressionSize);
+                break;
+            }
+            case DW_CFA_offset_extended_sf:{
+                u64 reg = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_offset_extended_sf: r%llu at cfa%+lld\n",reg,reader_sleb128(&reader)*cie->dataAlign);
+                break;
+            }
+            case DW_CFA_def_cfa_sf:{
+                u64 reg = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_def_cfa_sf: r%llu ofs %lld\n",reg,reader_sleb128(&reader)*cie->dataAlign);
+                break;
+            }
+            case DW_CFA_def_cfa_offset_sf:
+                fprintf(display_output(),"DW_CFA_def_cfa_offset_sf: %lld\n",reader_sleb128(&reader)*cie->dataAlign);
+                break;
+            case DW_CFA_val_offset:{
+                u64 reg = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_val_offset: r%llu is cfa%+lld\n",reg,(s64)reader_uleb128(&reader)*cie->dataAlign);
+                break;
+            }
+            case DW_CFA_val_offset_sf:{
+                u64 reg = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_val_offset_sf: r%llu is cfa%+lld\n",reg,reader_sleb128(&reader)*cie->dataAlign);
+                break;
+            }
+            case DW_CFA_GNU_window_save:
+                fprintf(display_output(),"DW_CFA_GNU_window_save\n");
+                break;
+            case DW_CFA_GNU_args_size:
+                fprintf(display_output(),"DW_CFA_GNU_args_size: %llu\n",reader_uleb128(&reader));
+                break;
+            case DW_CFA_GNU_negative_offset_extended:{
+                u64 reg = reader_uleb128(&reader);
+                fprintf(display_output(),"DW_CFA_GNU_negative_offset_extended: r%llu at cfa%+lld\n",reg,-(s64)reader_uleb128(&reader)*cie->dataAlign);
+                break;
+            }
+            default:
+                // The operands of unknown instructions cannot be skipped
+                fprintf(display_output(),"DW_CFA_??? (0x%x)\n",opcode);
+                return;
+        }
+    }
+}
+
+
+/* Print an FDE with its CIE and instructions */
+static void print_fde(eh_frame_index_t * ehIndex, eh_frame_fde_t * fde, eh_frame_cie_t * cie){
+
+    display("FDE: ",DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"0x%llx (CIE 0x%llx)\n",fde->offset,fde->cieOffset);
+
+    display("Range: ",DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"0x%016llx-0x%016llx\n",fde->pcBegin,fde->pcBegin+fde->pcRange);
+
+    display("Augmentation: ",DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"\"%s\"\n",cie->augmentation);
+
+    display("Alignment: ",DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"code %llu, data %lld\n",cie->codeAlign,cie->dataAlign);
+
+    display("Return address: ",DISPLAY_COLOR_ORANGE);
+    fprintf(display_output(),"r%llu\n",cie->returnRegister);
+
+    if(cie->personality){
+        display("Personality: ",DISPLAY_COLOR_ORANGE);
+        fprintf(display_output(),"0x%llx\n",cie->personality);
+    }
+
+    if(fde->lsda){
+        display("LSDA: ",DISPLAY_COLOR_ORANGE);
+        fprintf(display_output(),"0x%llx\n",fde->lsda);
+    }
+
+    display("Instructions:\n",DISPLAY_COLOR_ORANGE);
+    print_cfa_instructions(ehIndex,cie,cie->instructions,cie->instructionsSize,fde->pcBegin);
+    print_cfa_instructions(ehIndex,cie,fde->instructions,fde->instructionsSize,fde->pcBegin);
+
+    fprintf(display_output(),"\n");
+}
+
+
+/* Columns of the "--ranges" listing */
+static const layout_column_t fdeRangesLayout[] = {
+    {"Start",LAYOUT_HEX,20,16}, {"End",LAYOUT_HEX,20,16}, {"Size",LAYOUT_DEC,12}, {"FDE",LAYOUT_HEX},
+};
+
+
+/* Print the FDE covering an address, or the function ranges of all the FDEs for "--ranges" */
+void eh_frame_query(kvelf_basic_params_t * kvelfp, u8 * query){
+
+    u8 * savePtr;
+    u8 * token = strtok_r(query," \t\n",(char **)&savePtr);
+    if(!token){
+        debug("Usage: fde ADDR | fde --ranges\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    eh_frame_index_t * ehIndex = eh_frame_get_index(kvelfp);
+    if(!ehIndex)
+        return;
+
+    if(strcmp(token,"--ranges")==0){
+
+        // The ranges come from the whole .eh_frame, the search table has no sizes
+        if(!ehIndex->entries)
+            eh_frame_build_entries(ehIndex);
+
+        table_layout_t layout;
+        layout_compile(&layout,fdeRangesLayout,LAYOUT_COUNT(fdeRangesLayout));
+        layout_print_header(&layout);
+
+        for(u64 i=0;i<ehIndex->numOfEntries;i++){
+            eh_frame_entry_t * entry = &ehIndex->entries[i];
+            layout_field_t fields[] = {{entry->pcBegin}, {entry->pcBegin+entry->pcRange}, {entry->pcRange}, {entry->fdeOffset}};
+            layout_print_row(&layout,fields);
+        }
+        return;
+    }
+
+    u8 * end;
+    u64 address = strtoull(token,(char **)&end,16);
+    if(end==token || *end){
+        display_error("Invalid address \"%s\"\n",token);
+        return;
+    }
+
+    s64 fdeOffset = eh_frame_find_fde(ehIndex,address);
+    if(fdeOffset<0){
+        fprintf(display_output(),"No FDE covers 0x%llx\n",address);
+        return;
+    }
+
+    eh_frame_cie_t cie;
+    eh_frame_fde_t fde;
+    cie.offset = (u64)-1;
+    eh_frame_decode_fde(ehIndex,fdeOffset,&fde,&cie);
+    print_fde(ehIndex,&fde,&cie);
+}
@@ -0,0 +1,139 @@
+#ifndef EHFRAME_H
+#define EHFRAME_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Pointer encodings of .eh_frame and .eh_frame_hdr, the low nibble is the format */
+#define DW_EH_PE_absptr 0x00
+#define DW_EH_PE_uleb128 0x01
+#define DW_EH_PE_udata2 0x02
+#define DW_EH_PE_udata4 0x03
+#define DW_EH_PE_udata8 0x04
+#define DW_EH_PE_sleb128 0x09
+#define DW_EH_PE_sdata2 0x0a
+#define DW_EH_PE_sdata4 0x0b
+#define DW_EH_PE_sdata8 0x0c
+
+/* Pointer encodings, the high nibble is what the value is relative to */
+#define DW_EH_PE_pcrel 0x10
+#define DW_EH_PE_textrel 0x20
+#define DW_EH_PE_datarel 0x30
+#define DW_EH_PE_funcrel 0x40
+#define DW_EH_PE_aligned 0x50
+#define DW_EH_PE_indirect 0x80
+#define DW_EH_PE_omit 0xff
+
+/* Call frame instructions, the first three keep their operand in the low 6 bits */
+#define DW_CFA_advance_loc 0x40
+#define DW_CFA_offset 0x80
+#define DW_CFA_restore 0xc0
+#define DW_CFA_nop 0x00
+#define DW_CFA_set_loc 0x01
+#define DW_CFA_advance_loc1 0x02
+#define DW_CFA_advance_loc2 0x03
+#define DW_CFA_advance_loc4 0x04
+#define DW_CFA_offset_extended 0x05
+#define DW_CFA_restore_extended 0x06
+#define DW_CFA_undefined 0x07
+#define DW_CFA_same_value 0x08
+#define DW_CFA_register 0x09
+#define DW_CFA_remember_state 0x0a
+#define DW_CFA_restore_state 0x0b
+#define DW_CFA_def_cfa 0x0c
+#define DW_CFA_def_cfa_register 0x0d
+#define DW_CFA_def_cfa_offset 0x0e
+#define DW_CFA_def_cfa_expression 0x0f
+#define DW_CFA_expression 0x10
+#define DW_CFA_offset_extended_sf 0x11
+#define DW_CFA_def_cfa_sf 0x12
+#define DW_CFA_def_cfa_offset_sf 0x13
+#define DW_CFA_val_offset 0x14
+#define DW_CFA_val_offset_sf 0x15
+#define DW_CFA_val_expression 0x16
+#define DW_CFA_GNU_window_save 0x2d
+#define DW_CFA_GNU_args_size 0x2e
+#define DW_CFA_GNU_negative_offset_extended 0x2f
+
+
+
+/* Common information entry */
+typedef struct eh_frame_cie{
+	u64 offset;			/* Offset of the entry in .eh_frame */
+	u8 version;			/* Version of the entry */
+	u8 * augmentation;	/* Augmentation string */
+	u64 codeAlign;		/* Code alignment factor */
+	s64 dataAlign;		/* Data alignment factor */
+	u64 returnRegister;	/* Column of the return address */
+	u8 fdeEncoding;		/* Encoding of the FDEs' addresses */
+	u8 lsdaEncoding;	/* Encoding of the FDEs' LSDA pointers */
+	u64 personality;	/* Personality routine, 0 if there is none */
+	u8 * instructions;	/* Initial instructions */
+	u64 instructionsSize;
+}eh_frame_cie_t;
+
+
+/* Frame description entry */
+typedef struct eh_frame_fde{
+	u64 offset;			/* Offset of the entry in .eh_frame */
+	u64 cieOffset;		/* Offset of its CIE in .eh_frame */
+	u64 pcBegin;		/* First address of the function */
+	u64 pcRange;		/* Size of the function */
+	u64 lsda;			/* Language specific data area, 0 if there is none */
+	u8 * instructions;	/* Call frame instructions */
+	u64 instructionsSize;
+}eh_frame_fde_t;
+
+
+/* Function range of an FDE */
+typedef struct eh_frame_entry{
+	u64 pcBegin;		/* First address of the function */
+	u64 pcRange;		/* Size of the function */
+	u64 fdeOffset;		/* Offset of the FDE in .eh_frame */
+}eh_frame_entry_t;
+
+
+/* Where the FDEs are and how to find them by address */
+typedef struct eh_frame_index{
+	u8 needsSwap;		/* Whether the entries are in the foreign byte order */
+	u8 addressSize;		/* Size of the absolute pointers */
+	u8 * ehFrame;		/* Contents of .eh_frame */
+	u64 ehFrameSize;
+	u64 ehFrameVAddr;	/* Virtual address of .eh_frame */
+	u8 * ehFrameHdr;	/* Contents of .eh_frame_hdr, NULL if there is none */
+	u64 ehFrameHdrSize;
+	u64 ehFrameHdrVAddr;	/* Virtual address of .eh_frame_hdr */
+	u8 tableEncoding;	/* Encoding of the search table of .eh_frame_hdr */
+	u64 numOfTableEntries;	/* Number of entries of the search table, 0 if it cannot be searched */
+	u8 * table;			/* Search table of .eh_frame_hdr, sorted by address */
+	u64 numOfEntries;	/* Number of FDEs decoded by the index */
+	eh_frame_entry_t * entries;	/* FDEs sorted by address, NULL until they are needed */
+}eh_frame_index_t;
+
+
+
+/* Get the .eh_frame index of the file, locating the sections on the first call */
+eh_frame_index_t * eh_frame_get_index(kvelf_basic_params_t * kvelfp);
+
+/* Walk the whole .eh_frame once and sort its FDEs by address */
+void eh_frame_build_entries(eh_frame_index_t * ehIndex);
+
+/* Free an .eh_frame index and its sorted FDEs */
+void eh_frame_index_free(eh_frame_index_t * ehIndex);
+
+/* Decode the CIE at the given offset of .eh_frame, returns 0 if it is not a valid CIE */
+u8 eh_frame_decode_cie(eh_frame_index_t * ehIndex, u64 cieOffset, eh_frame_cie_t * cie);
+
+/* Decode the FDE at the given offset of .eh_frame with its CIE, returns 0 if it is not a valid FDE */
+u8 eh_frame_decode_fde(eh_frame_index_t * ehIndex, u64 fdeOffset, eh_frame_fde_t * fde, eh_frame_cie_t * cie);
+
+/* Find the offset of the FDE covering an address, returns -1 if no FDE covers it */
+s64 eh_frame_find_fde(eh_frame_index_t * ehIndex, u64 address);
+
+/* Print the FDE covering an address, or the function ranges of all the FDEs for "--ranges" */
+void eh_frame_query(kvelf_basic_params_t * kvelfp, u8 * query);
+
+
+#endif
@@ -1,45 +1,71 @@
-
+#include <stddef.h>
 #include "./types.h"
 #include "./elf.h"
 
 
-/* Get string representation of the ELF ABI */
-u8 * get_elf_abi_string(u8 elfAbi){
+/* Number of entries of a compile-time names table */
+#define ELF_NAMES_COUNT(table) (sizeof(table) / sizeof((table)[0]))
 
-     if (elfAbi==ELFOSABI_NONE || elfAbi==ELFOSABI_SYSV)
-        return "System V";
-    else if (elfAbi==ELFOSABI_HPUX)
-        return "HP-UX";
-    else if (elfAbi==ELFOSABI_NETBSD)
-        return "NetBSD";
-    else if (elfAbi==ELFOSABI_GNU || elfAbi==ELFOSABI_LINUX)
-        return "GNU";
-    else if (elfAbi==ELFOSABI_SOLARIS)
-        return "Solaris";
-    else if (elfAbi==ELFOSABI_AIX)
-        return "AIX";
-    else if (elfAbi==ELFOSABI_IRIX)
-        return "IRIX";
-    else if (elfAbi==ELFOSABI_FREEBSD)
-        return "FreeBSD";
-    else if (elfAbi==ELFOSABI_TRU64)
-        return "TRU64";
-    else if (elfAbi==ELFOSABI_MODESTO)
-        return "Modesto";
-    else if (elfAbi==ELFOSABI_OPENBSD)
-        return "OpenBSD";
-    else if (elfAbi==ELFOSABI_ARM_AEABI)
-        return "ARB_EABI";
-    else if (elfAbi==ELFOSABI_ARM)
-        return "ARM";
-    else if (elfAbi==ELFOSABI_STANDALONE)
-        return "Standalone";
-    return "N/A";
 
+/* A dense table of names covering a window of consecutive values */
+typedef struct elf_names_window{
+    u32 base;       /* First value covered by the window */
+    u32 count;      /* Number of values covered by the window */
+    u8 ** names;    /* Names indexed by (value - base), NULL for undefined values */
+}elf_names_window_t;
+
+
+/* A bucket giving a single name to a whole range of values */
+typedef struct elf_names_range{
+    u32 low;        /* First value of the range */
+    u32 high;       /* Last value of the range */
+    u8 * name;      /* Name of every value of the range */
+}elf_names_range_t;
+
+
+/* Look up a value in the dense windows first and then in the range buckets */
+static u8 * lookup_elf_name(const elf_names_window_t * windows, u32 numOfWindows, const elf_names_range_t * ranges, u32 numOfRanges, u32 value, u8 * unknownName){
+
+    for(u32 i=0;i<numOfWindows;i++){
+        // Values below the base wrap around and fail the bound check
+        u32 idx = value - windows[i].base;
+        if(idx < windows[i].count && windows[i].names[idx])
+            return windows[i].names[idx];
+    }
+
+    for(u32 i=0;i<numOfRanges;i++)
+        if(value >= ranges[i].low && value <= ranges[i].high)
+            return ranges[i].name;
+
+    return unknownName;
 }
 
 
+/* Names of the ELF ABIs, indexed by EI_OSABI */
+static u8 * elfAbiNames[256] = {
+    [ELFOSABI_SYSV] = "System V",
+    [ELFOSABI_HPUX] = "HP-UX",
+    [ELFOSABI_NETBSD] = "NetBSD",
+    [ELFOSABI_GNU] = "GNU",
+    [ELFOSABI_SOLARIS] = "Solaris",
+    [ELFOSABI_AIX] = "AIX",
+    [ELFOSABI_IRIX] = "IRIX",
+    [ELFOSABI_FREEBSD] = "FreeBSD",
+    [ELFOSABI_TRU64] = "TRU64",
+    [ELFOSABI_MODESTO] = "Modesto",
+    [ELFOSABI_OPENBSD] = "OpenBSD",
+    [ELFOSABI_ARM_AEABI] = "ARM_EABI",
+    [ELFOSABI_ARM] = "ARM",
+    [ELFOSABI_STANDALONE] = "Standalone",
+};
 
+/* Get string representation of the ELF ABI */
+u8 * get_elf_abi_string(u8 elfAbi){
+
+    if(elfAbiNames[elfAbi])
+        return elfAbiNames[elfAbi];
+    return "N/A";
+}
 
 /* Get string representation of the ELF class */
 u8 * get_elf_class_string(u8 elfClass){
@@ -85,102 +111,265 @@ u8 * get_elf_object_file_type(u16 type){
 
 }
 
+/* Names of the ELF machines, indexed by e_machine */
+static u8 * elfMachineNames[EM_NUM] = {
+    [EM_NONE] = "No machine",
+    [EM_M32] = "AT&T WE 32100",
+    [EM_SPARC] = "SUN SPARC",
+    [EM_386] = "Intel 80386",
+    [EM_68K] = "Motorola m68k family",
+    [EM_88K] = "Motorola m88k family",
+    [EM_IAMCU] = "Intel MCU",
+    [EM_860] = "Intel 80860",
+    [EM_MIPS] = "MIPS R3000 big-endian",
+    [EM_S370] = "IBM System/370",
+    [EM_MIPS_RS3_LE] = "MIPS R3000 little-endian",
+    [EM_PARISC] = "HPPA",
+    [EM_VPP500] = "Fujitsu VPP500",
+    [EM_SPARC32PLUS] = "Sun's \"v8plus\"",
+    [EM_960] = "Intel 80960",
+    [EM_PPC] = "PowerPC",
+    [EM_PPC64] = "PowerPC 64-bit",
+    [EM_S390] = "IBM S390",
+    [EM_SPU] = "IBM SPU/SPC",
+    [EM_V800] = "NEC V800 series",
+    [EM_FR20] = "Fujitsu FR20",
+    [EM_RH32] = "TRW RH-32",
+    [EM_RCE] = "Motorola RCE",
+    [EM_ARM] = "ARM",
+    [EM_FAKE_ALPHA] = "Digital Alpha",
+    [EM_SH] = "Hitachi SH",
+    [EM_SPARCV9] = "SPARC v9 64-bit",
+    [EM_TRICORE] = "Siemens Tricore",
+    [EM_ARC] = "Argonaut RISC Core",
+    [EM_H8_300] = "Hitachi H8/300",
+    [EM_H8_300H] = "Hitachi H8/300H",
+    [EM_H8S] = "Hitachi H8S",
+    [EM_H8_500] = "Hitachi H8/500",
+    [EM_IA_64] = "Intel Merced",
+    [EM_MIPS_X] = "Stanford MIPS-X",
+    [EM_COLDFIRE] = "Motorola Coldfire",
+    [EM_68HC12] = "Motorola M68HC12",
+    [EM_MMA] = "Fujitsu MMA Multimedia Accelerator",
+    [EM_PCP] = "Siemens PCP",
+    [EM_NCPU] = "Sony nCPU embeeded RISC",
+    [EM_NDR1] = "Denso NDR1 microprocessor",
+    [EM_STARCORE] = "Motorola Start*Core processor",
+    [EM_ME16] = "Toyota ME16 processor",
+    [EM_ST100] = "STMicroelectronic ST100 processor",
+    [EM_TINYJ] = "Advanced Logic Corp. Tinyj emb.fam",
+    [EM_X86_64] = "x86-64",
+    [EM_PDSP] = "Sony DSP Processor",
+    [EM_PDP10] = "Digital PDP-10",
+    [EM_PDP11] = "Digital PDP-11",
+    [EM_FX66] = "Siemens FX66 microcontroller",
+    [EM_ST9PLUS] = "STMicroelectronics ST9+ 8/16 mc",
+    [EM_ST7] = "STmicroelectronics ST7 8 bit mc",
+    [EM_68HC16] = "Motorola MC68HC16 microcontroller",
+    [EM_68HC11] = "Motorola MC68HC11 microcontroller",
+    [EM_68HC08] = "Motorola MC68HC08 microcontroller",
+    [EM_68HC05] = "Motorola MC68HC05 microcontroller",
+    [EM_SVX] = "Silicon Graphics SVx",
+    [EM_ST19] = "STMicroelectronics ST19 8 bit mc",
+    [EM_VAX] = "Digital VAX",
+    [EM_CRIS] = "Axis Communications 32-bit emb.proc",
+    [EM_JAVELIN] = "Infineon Technologies 32-bit emb.proc",
+    [EM_FIREPATH] = "Element 14 64-bit DSP Processor",
+    [EM_ZSP] = "LSI Logic 16-bit DSP Processor",
+    [EM_MMIX] = "Donald Knuth's educational 64-bit proc",
+    [EM_HUANY] = "Harvard University machine-independent object files",
+    [EM_PRISM] = "SiTera Prism",
+    [EM_AVR] = "Atmel AVR 8-bit microcontroller",
+    [EM_FR30] = "Fujitsu FR30",
+    [EM_D10V] = "Mitsubishi D10V",
+    [EM_D30V] = "Mitsubishi D30V",
+    [EM_V850] = "NEC v850",
+    [EM_M32R] = "Mitsubishi M32R",
+    [EM_MN10300] = "Matsushita MN10300",
+    [EM_MN10200] = "Matsushita MN10200",
+    [EM_PJ] = "picoJava",
+    [EM_OPENRISC] = "OpenRISC 32-bit embedded processor",
+    [EM_ARC_COMPACT] = "ARC International ARCompact",
+    [EM_XTENSA] = "Tensilica Xtensa Architecture",
+    [EM_VIDEOCORE] = "Alphamosaic VideoCore",
+    [EM_TMM_GPP] = "Thompson Multimedia General Purpose Proc",
+    [EM_NS32K] = "National Semi. 32000",
+    [EM_TPC] = "Tenor Network TPC",
+    [EM_SNP1K] = "Trebia SNP 1000",
+    [EM_ST200] = "STMicroelectronics ST200",
+    [EM_IP2K] = "Ubicom IP2xxx",
+    [EM_MAX] = "MAX processor",
+    [EM_CR] = "National Semi. CompactRISC",
+    [EM_F2MC16] = "Fujitsu F2MC16",
+    [EM_MSP430] = "Texas Instruments msp430",
+    [EM_BLACKFIN] = "Analog Devices Blackfin DSP",
+    [EM_SE_C33] = "Seiko Epson S1C33 family",
+    [EM_SEP] = "Sharp embedded microprocessor",
+    [EM_ARCA] = "Arca RISC",
+    [EM_UNICORE] = "PKU-Unity & MPRC Peking Uni. mc series",
+    [EM_EXCESS] = "eXcess configurable cpu",
+    [EM_DXP] = "Icera Semi. Deep Execution Processor",
+    [EM_ALTERA_NIOS2] = "Altera Nios II",
+    [EM_CRX] = "National Semi. CompactRISC CRX",
+    [EM_XGATE] = "Motorola XGATE",
+    [EM_C166] = "Infineon C16x/XC16x",
+    [EM_M16C] = "Renesas M16C",
+    [EM_DSPIC30F] = "Microchip Technology dsPIC30F",
+    [EM_CE] = "Freescale Communication Engine RISC",
+    [EM_M32C] = "Renesas M32C",
+    [EM_TSK3000] = "Altium TSK3000",
+    [EM_RS08] = "Freescale RS08",
+    [EM_SHARC] = "Analog Devices SHARC family",
+    [EM_ECOG2] = "Cyan Technology eCOG2",
+    [EM_SCORE7] = "Sunplus S+core7 RISC",
+    [EM_DSP24] = "New Japan Radio (NJR) 24-bit DSP",
+    [EM_VIDEOCORE3] = "Broadcom VideoCore III",
+    [EM_LATTICEMICO32] = "RISC for Lattice FPGA",
+    [EM_SE_C17] = "Seiko Epson C17",
+    [EM_TI_C6000] = "Texas Instruments TMS320C6000 DSP",
+    [EM_TI_C2000] = "Texas Instruments TMS320C2000 DSP",
+    [EM_TI_C5500] = "Texas Instruments TMS320C55x DSP",
+    [EM_TI_ARP32] = "Texas Instruments App. Specific RISC",
+    [EM_TI_PRU] = "Texas Instruments Prog. Realtime Unit",
+    [EM_MMDSP_PLUS] = "STMicroelectronics 64bit VLIW DSP",
+    [EM_CYPRESS_M8C] = "Cypress M8C",
+    [EM_R32C] = "Renesas R32C",
+    [EM_TRIMEDIA] = "NXP Semi. TriMedia",
+    [EM_QDSP6] = "QUALCOMM DSP6",
+    [EM_8051] = "Intel 8051 and variants",
+    [EM_STXP7X] = "STMicroelectronics STxP7x",
+    [EM_NDS32] = "Andes Tech. compact code emb. RISC",
+    [EM_ECOG1X] = "Cyan Technology eCOG1X",
+    [EM_MAXQ30] = "Dallas Semi. MAXQ30 mc",
+    [EM_XIMO16] = "New Japan Radio (NJR) 16-bit DSP",
+    [EM_MANIK] = "M2000 Reconfigurable RISC",
+    [EM_CRAYNV2] = "Cray NV2 vector architecture",
+    [EM_RX] = "Renesas RX",
+    [EM_METAG] = "Imagination Tech. META",
+    [EM_MCST_ELBRUS] = "MCST Elbrus",
+    [EM_ECOG16] = "Cyan Technology eCOG16",
+    [EM_CR16] = "National Semi. CompactRISC CR16",
+    [EM_ETPU] = "Freescale Extended Time Processing Unit",
+    [EM_SLE9X] = "Infineon Tech. SLE9X",
+    [EM_L10M] = "Intel L10M",
+    [EM_K10M] = "Intel K10M",
+    [EM_AARCH64] = "AArch64",
+    [EM_AVR32] = "Amtel 32-bit microprocessor",
+    [EM_STM8] = "STMicroelectronics STM8",
+    [EM_TILE64] = "Tileta TILE64",
+    [EM_TILEPRO] = "Tilera TILEPro",
+    [EM_MICROBLAZE] = "Xilinx MicroBlaze",
+    [EM_CUDA] = "NVIDIA CUDA",
+    [EM_TILEGX] = "Tilera TILE-Gx",
+    [EM_CLOUDSHIELD] = "CloudShield",
+    [EM_COREA_1ST] = "KIPO-KAIST Core-A 1st gen.",
+    [EM_COREA_2ND] = "KIPO-KAIST Core-A 2nd gen.",
+    [EM_ARC_COMPACT2] = "Synopsys ARCompact V2",
+    [EM_OPEN8] = "Open8 RISC",
+    [EM_RL78] = "Renesas RL78",
+    [EM_VIDEOCORE5] = "Broadcom VideoCore V",
+    [EM_78KOR] = "Renesas 78KOR",
+    [EM_56800EX] = "Freescale 56800EX DSC",
+    [EM_BA1] = "Beyond BA1",
+    [EM_BA2] = "Beyond BA2",
+    [EM_XCORE] = "XMOS xCORE",
+    [EM_MCHP_PIC] = "Microchip 8-bit PIC(r)",
+    [EM_KM32] = "KM211 KM32",
+    [EM_KMX32] = "KM211 KMX32",
+    [EM_EMX16] = "KM211 KMX16",
+    [EM_EMX8] = "KM211 KMX8",
+    [EM_KVARC] = "KM211 KVARC",
+    [EM_CDP] = "Paneve CDP",
+    [EM_COGE] = "Cognitive Smart Memory Processor",
+    [EM_COOL] = "Bluechip CoolEngine",
+    [EM_NORC] = "Nanoradio Optimized RISC",
+    [EM_CSR_KALIMBA] = "CSR Kalimba",
+    [EM_Z80] = "Zilog Z80",
+    [EM_VISIUM] = "Controls and Data Services VISIUMcore",
+    [EM_FT32] = "FTDI Chip FT32",
+    [EM_MOXIE] = "Moxie processor",
+    [EM_AMDGPU] = "AMD GPU",
+    [EM_RISCV] = "RISC-V",
+    [EM_BPF] = "Linux BPF -- in-kernel virtual machine",
+    [EM_CSKY] = "C-SKY",
+};
+
+/* Names of the unofficial ELF machines out of the official numbering */
+static u8 * elfMachineAlphaNames[] = {
+    [EM_ALPHA - EM_ALPHA] = "Digital Alpha",
+};
+
+static const elf_names_window_t elfMachineWindows[] = {
+    { 0, ELF_NAMES_COUNT(elfMachineNames), elfMachineNames },
+    { EM_ALPHA, ELF_NAMES_COUNT(elfMachineAlphaNames), elfMachineAlphaNames },
+};
+
 /* Get string representation of the ELF machine */
 u8 * get_elf_machine(u16 machine){
 
-	if(machine==EM_386)
-		return "Intel 80386";
-	if(machine==EM_860)
-		return "Intel 80860";
-	if(machine==EM_IAMCU)
-		return "Intel MCU";
-	if(machine==EM_SPARC)
-		return "UN SPARC";
-	if(machine==EM_X86_64)
-		return "x86-64";
-    if(machine==EM_ARM)
-        return "ARM";
-	return "N/A";
+    return lookup_elf_name(elfMachineWindows, ELF_NAMES_COUNT(elfMachineWindows), NULL, 0, machine, "N/A");
 }
 
 
+/* Names of the generic ELF section types */
+static u8 * elfSectionTypeNames[SHT_NUM] = {
+    [SHT_NULL] = "NULL",
+    [SHT_PROGBITS] = "PROGBITS",
+    [SHT_SYMTAB] = "SYMTAB",
+    [SHT_STRTAB] = "STRTAB",
+    [SHT_RELA] = "RELA",
+    [SHT_HASH] = "HASH",
+    [SHT_DYNAMIC] = "DYNAMIC",
+    [SHT_NOTE] = "NOTE",
+    [SHT_NOBITS] = "NO-BITS",
+    [SHT_REL] = "REL",
+    [SHT_SHLIB] = "SHLIB",
+    [SHT_DYNSYM] = "DYNSYM",
+    [SHT_INIT_ARRAY] = "INIT_ARRAY",
+    [SHT_FINI_ARRAY] = "FINI_ARRAY",
+    [SHT_PREINIT_ARRAY] = "PREINIT_ARRAY",
+    [SHT_GROUP] = "GROUP",
+    [SHT_SYMTAB_SHNDX] = "SYMTAB_SHNDX",
+    [SHT_RELR] = "RELR",
+};
+
+/* Names of the GNU and Sun section types at the top of the OS-specific range */
+static u8 * elfSectionTypeGnuNames[] = {
+    [SHT_GNU_ATTRIBUTES - SHT_GNU_ATTRIBUTES] = "GNU_ATTR",
+    [SHT_GNU_HASH - SHT_GNU_ATTRIBUTES] = "GNU_HASH",
+    [SHT_GNU_LIBLIST - SHT_GNU_ATTRIBUTES] = "GNU_LIBLIST",
+    [SHT_CHECKSUM - SHT_GNU_ATTRIBUTES] = "CHECKSUM",
+    [SHT_SUNW_move - SHT_GNU_ATTRIBUTES] = "SUN_MOVE",
+    [SHT_SUNW_COMDAT - SHT_GNU_ATTRIBUTES] = "SUN_COMDAT",
+    [SHT_SUNW_syminfo - SHT_GNU_ATTRIBUTES] = "SUN_SYMINFO",
+    [SHT_GNU_verdef - SHT_GNU_ATTRIBUTES] = "GNU_VERDEF",
+    [SHT_GNU_verneed - SHT_GNU_ATTRIBUTES] = "GNU_VERNEED",
+    [SHT_GNU_versym - SHT_GNU_ATTRIBUTES] = "GNU_VERSYM",
+};
+
+static const elf_names_window_t elfSectionTypeWindows[] = {
+    { 0, ELF_NAMES_COUNT(elfSectionTypeNames), elfSectionTypeNames },
+    { SHT_GNU_ATTRIBUTES, ELF_NAMES_COUNT(elfSectionTypeGnuNames), elfSectionTypeGnuNames },
+};
+
+static const elf_names_range_t elfSectionTypeRanges[] = {
+    { SHT_LOOS, SHT_HIOS, "OS_SPEC" },
+    { SHT_LOPROC, SHT_HIPROC, "PROC_SPEC" },
+    { SHT_LOUSER, SHT_HIUSER, "APP_SPEC" },
+};
+
 /* Get string representation of the ELF section type */
 u8 * get_elf_section_type(u32 sectionType){
 
-    if (sectionType==SHT_NULL)
-        return "NULL";
-    if (sectionType==SHT_PROGBITS)
-        return "PROGBITS";
-    if (sectionType==SHT_SYMTAB)
-        return "SYMTAB";
-    if (sectionType==SHT_STRTAB)
-        return "STRTAB";
-    if (sectionType==SHT_REL)
-        return "RELA";
-    if (sectionType==SHT_HASH)
-        return "HASH";
-    if (sectionType==SHT_DYNAMIC)
-        return "DYNAMIC";
-    if (sectionType==SHT_NOTE)
-        return "NOTE";
-    if (sectionType==SHT_NOBITS)
-        return "NO-BITS";
-    if (sectionType==SHT_SHLIB)
-        return "SHLIB";
-    if (sectionType==SHT_DYNSYM)
-        return "DYNSYM";
-    if (sectionType==SHT_INIT_ARRAY)
-        return "INIT_ARRAY";
-    if (sectionType==SHT_FINI_ARRAY)
-        return "FINI_ARRAY";
-    if (sectionType==SHT_PREINIT_ARRAY)
-        return "PREINIT_ARRAY";
-    if (sectionType==SHT_GROUP)
-        return "GROUP";
-    if (sectionType==SHT_SYMTAB_SHNDX)
-        return "SYMTAB_SHNDX";
-    if (sectionType==SHT_NUM)
-        return "NUM";
-    if (sectionType==SHT_LOOS)
-        return "LOOS";
-    if (sectionType==SHT_GNU_ATTRIBUTES)
-        return "GNU_ATTR";
-    if (sectionType==SHT_GNU_HASH)
-        return "GNU_HASH";
-    if (sectionType==SHT_GNU_LIBLIST)
-        return "GNU_LIBLIST";
-    if (sectionType==SHT_CHECKSUM)
-        return "CHECKSUM";
-    if (sectionType==SHT_SUNW_move)
-        return "SUN_MOVE";
-    if (sectionType==SHT_SUNW_COMDAT)
-        return "SUM_COMDAT";
-    if (sectionType==SHT_SUNW_syminfo)
-        return "SUN_SYMINFO";
-    if (sectionType==SHT_GNU_verdef)
-        return "GNU_VERDEF";
-    if (sectionType==SHT_GNU_verneed)
-        return "GNU_VERNEED";
-    if (sectionType==SHT_GNU_versym)
-        return "GNU_VERSYM";
-    if (sectionType<= SHT_HIOS)
-        return "OS_SPEC";
-    if ((sectionType >= SHT_LOPROC) && (sectionType <= SHT_HIPROC) )
-        return "PROC_SPEC";
-    if ((sectionType >= SHT_LOUSER) && (sectionType <= 0x8fffffff) )
-        return "APP_SPEC";
-    
-    return "UNKNOWN";
-
+    return lookup_elf_name(elfSectionTypeWindows, ELF_NAMES_COUNT(elfSectionTypeWindows), elfSectionTypeRanges, ELF_NAMES_COUNT(elfSectionTypeRanges), sectionType, "UNKNOWN");
 }
 
-
 /* Get string representation of the ELF section flag */
 void get_elf_section_flag(u32 sectionFlag, u8 * sectionFlags, u8 sectionFlagsBuffSize){
 
     // Zeroing out the buffer
     for(u8 i=0;i<sectionFlagsBuffSize;i++)
-        sectionFlags[i]==0;
+        sectionFlags[i]=0;
 
     u8 flagIndex=0;
 
@@ -219,37 +408,48 @@ void get_elf_section_flag(u32 sectionFlag, u8 * sectionFlags, u8 sectionFlagsBuf
 
 }
 
-/* Get string representation of the ELF segment type */
-u8 * get_elf_segment_type(u32 segmentType){
+/* Names of the generic ELF segment types */
+static u8 * elfSegmentTypeNames[] = {
+    [PT_NULL] = "NULL",
+    [PT_LOAD] = "LOAD",
+    [PT_DYNAMIC] = "DYN",
+    [PT_INTERP] = "INTERP",
+    [PT_NOTE] = "NOTE",
+    [PT_SHLIB] = "SHLIB",
+    [PT_PHDR] = "PHDR",
+    [PT_TLS] = "TLS",
+};
 
+/* Names of the GNU segment types */
+static u8 * elfSegmentTypeGnuNames[] = {
+    [PT_GNU_EH_FRAME - PT_GNU_EH_FRAME] = "GNU-FRAME",
+    [PT_GNU_STACK - PT_GNU_EH_FRAME] = "GNU-STACK",
+    [PT_GNU_RELRO - PT_GNU_EH_FRAME] = "GNU-RELRO",
+    [PT_GNU_PROPERTY - PT_GNU_EH_FRAME] = "GNU-PROP",
+};
 
-    if (segmentType== PT_NULL)
-        return"NULL";
-    else  if (segmentType== PT_LOAD)
-        return"LOAD";
-    else  if (segmentType== PT_DYNAMIC)
-        return"DYN";
-    else  if (segmentType== PT_INTERP)
-        return"INTERP";
-    else  if (segmentType== PT_NOTE)
-        return"NOTE";
-    else  if (segmentType== PT_SHLIB)
-        return"SHLIB";
-    else  if (segmentType== PT_PHDR)
-        return"PHDR";
-    else if (segmentType== PT_GNU_EH_FRAME)
-        return"GNU-FRAME";
-    else if (segmentType== PT_GNU_STACK)
-        return"GNU-STACK";
-    else if (segmentType== PT_GNU_RELRO)
-        return"GNU-RELRO";
-    else if (segmentType>= 0x70000000 && segmentType <=0x7fffffff)
-        return"OS-SPEC";
-    return "N/A";
+/* Names of the Sun segment types */
+static u8 * elfSegmentTypeSunNames[] = {
+    [PT_SUNWBSS - PT_SUNWBSS] = "SUN-BSS",
+    [PT_SUNWSTACK - PT_SUNWBSS] = "SUN-STACK",
+};
 
-}
+static const elf_names_window_t elfSegmentTypeWindows[] = {
+    { 0, ELF_NAMES_COUNT(elfSegmentTypeNames), elfSegmentTypeNames },
+    { PT_GNU_EH_FRAME, ELF_NAMES_COUNT(elfSegmentTypeGnuNames), elfSegmentTypeGnuNames },
+    { PT_SUNWBSS, ELF_NAMES_COUNT(elfSegmentTypeSunNames), elfSegmentTypeSunNames },
+};
 
+static const elf_names_range_t elfSegmentTypeRanges[] = {
+    { PT_LOOS, PT_HIOS, "OS-SPEC" },
+    { PT_LOPROC, PT_HIPROC, "PROC-SPEC" },
+};
 
+/* Get string representation of the ELF segment type */
+u8 * get_elf_segment_type(u32 segmentType){
+
+    return lookup_elf_name(elfSegmentTypeWindows, ELF_NAMES_COUNT(elfSegmentTypeWindows), elfSegmentTypeRanges, ELF_NAMES_COUNT(elfSegmentTypeRanges), segmentType, "N/A");
+}
 
 /* Get string representation of the ELF segment flag */
 void get_elf_segment_flag(u32 segmentFlag , u8 * segmentFlags , u8 segmentFlagsBuffSize){
@@ -271,82 +471,746 @@ void get_elf_segment_flag(u32 segmentFlag , u8 * segmentFlags , u8 segmentFlagsB
 }
 
 
+/* Names of the ELF symbol types, indexed by ELF_ST_TYPE */
+static u8 * elfSymbolTypeNames[16] = {
+    [STT_NOTYPE] = "None",
+    [STT_OBJECT] = "Object",
+    [STT_FUNC] = "Function",
+    [STT_SECTION] = "Section",
+    [STT_FILE] = "File",
+    [STT_COMMON] = "Common",
+    [STT_TLS] = "TLS",
+    [STT_GNU_IFUNC] = "IFunc",
+    [11] = "OS",
+    [STT_HIOS] = "OS",
+    [STT_LOPROC] = "LOP",
+    [14] = "PROC",
+    [STT_HIPROC] = "HIP",
+};
+
 /* Get string representation of the ELF symbol type */
 u8 * get_elf_symbol_type(u8 type){
-    if(type==STT_NOTYPE)
-        return "None";
-    if(type==STT_OBJECT)
-        return "Object";
-    if(type==STT_FUNC)
-        return "Function";
-    if(type==STT_SECTION)
-        return "Section";
-    if(type==STT_FILE)
-        return "File";
-    if(type==STT_COMMON)
-        return "Common";
-    if(type==STT_LOPROC)
-        return "LOP";
-    if(type==STT_HIPROC)
-        return "HIP";
+
+    if(type < ELF_NAMES_COUNT(elfSymbolTypeNames) && elfSymbolTypeNames[type])
+        return elfSymbolTypeNames[type];
     return "N/A";
 }
 
+
+/* Names of the ELF symbol bindings, indexed by ELF_ST_BIND */
+static u8 * elfSymbolBindingNames[16] = {
+    [STB_LOCAL] = "Local",
+    [STB_GLOBAL] = "Global",
+    [STB_WEAK] = "Weak",
+    [STB_GNU_UNIQUE] = "Unique",
+    [11] = "OS",
+    [STB_HIOS] = "OS",
+    [STB_LOPROC] = "LOP",
+    [14] = "PROC",
+    [STB_HIPROC] = "HIP",
+};
+
 /* Get string representation of the ELF symbol binding */
 u8 * get_elf_symbol_binding(u8 binding){
-    if(binding==STB_LOCAL)
-        return "Local";
-    if(binding==STB_GLOBAL)
-        return "Global";
-    if(binding==STB_WEAK)
-        return "Weak";
-    if(binding==STB_LOPROC)
-        return "LOP";
-    if(binding==STB_HIPROC)
-        return "HIP";
+
+    if(binding < ELF_NAMES_COUNT(elfSymbolBindingNames) && elfSymbolBindingNames[binding])
+        return elfSymbolBindingNames[binding];
     return "N/A";
 }
 
+
+/* Names of the ELF symbol visibilities, indexed by ELF_ST_VISIBILITY */
+static u8 * elfSymbolVisibilityNames[4] = {
+    [STV_DEFAULT] = "Default",
+    [STV_INTERNAL] = "Internal",
+    [STV_HIDDEN] = "Hidden",
+    [STV_PROTECTED] = "Protected",
+};
+
 /* Get string representation of the ELF symbol visibility */
 u8 * get_elf_symbol_visibility(u8 vis){
-    if(vis==STV_DEFAULT)
-        return "Default";
-    if(vis==STV_INTERNAL)
-        return "Internal";
-    if(vis==STV_HIDDEN)
-        return "Hidden";
-    if(vis==STV_PROTECTED)
-        return "Protected";
-    return "N/A";
 
+    // The visibility is held by the low bits of st_other
+    return elfSymbolVisibilityNames[ELF64_ST_VISIBILITY(vis)];
 }
 
 
-/* Get string representation of the ELF relocation type */
-u8 * get_elf_reloc_type(u32 type){
-    if(type==R_386_NONE)
-        return "None";
-    if(type==R_386_32)
-        return "R_386_32";
-    if(type==R_386_PC32)
-        return "R_386_PC32";
-    if(type==R_386_GOT32)
-        return "R_386_GOT32";
-    if(type==R_386_PLT32)
-        return "R_386_PLT32";
-    if(type==R_386_COPY)
-        return "R_386_COPY";
-    if(type==R_386_GLOB_DAT)
-        return "R_386_GLOB_DAT";
-    if(type==R_386_JMP_SLOT)
-        return "R_386_JMP_SLOT";
-    if(type==R_386_RELATIVE)
-        return "R_386_RELATIVE";
+/* Names of the relocation types of each machine, indexed by the relocation type */
 
-    return "N/A";
+/* x86-64 relocation types */
+static u8 * elfRelocNamesX86_64[] = {
+    [R_X86_64_NONE] = "R_X86_64_NONE",
+    [R_X86_64_64] = "R_X86_64_64",
+    [R_X86_64_PC32] = "R_X86_64_PC32",
+    [R_X86_64_GOT32] = "R_X86_64_GOT32",
+    [R_X86_64_PLT32] = "R_X86_64_PLT32",
+    [R_X86_64_COPY] = "R_X86_64_COPY",
+    [R_X86_64_GLOB_DAT] = "R_X86_64_GLOB_DAT",
+    [R_X86_64_JUMP_SLOT] = "R_X86_64_JUMP_SLOT",
+    [R_X86_64_RELATIVE] = "R_X86_64_RELATIVE",
+    [R_X86_64_GOTPCREL] = "R_X86_64_GOTPCREL",
+    [R_X86_64_32] = "R_X86_64_32",
+    [R_X86_64_32S] = "R_X86_64_32S",
+    [R_X86_64_16] = "R_X86_64_16",
+    [R_X86_64_PC16] = "R_X86_64_PC16",
+    [R_X86_64_8] = "R_X86_64_8",
+    [R_X86_64_PC8] = "R_X86_64_PC8",
+    [R_X86_64_DTPMOD64] = "R_X86_64_DTPMOD64",
+    [R_X86_64_DTPOFF64] = "R_X86_64_DTPOFF64",
+    [R_X86_64_TPOFF64] = "R_X86_64_TPOFF64",
+    [R_X86_64_TLSGD] = "R_X86_64_TLSGD",
+    [R_X86_64_TLSLD] = "R_X86_64_TLSLD",
+    [R_X86_64_DTPOFF32] = "R_X86_64_DTPOFF32",
+    [R_X86_64_GOTTPOFF] = "R_X86_64_GOTTPOFF",
+    [R_X86_64_TPOFF32] = "R_X86_64_TPOFF32",
+    [R_X86_64_PC64] = "R_X86_64_PC64",
+    [R_X86_64_GOTOFF64] = "R_X86_64_GOTOFF64",
+    [R_X86_64_GOTPC32] = "R_X86_64_GOTPC32",
+    [R_X86_64_GOT64] = "R_X86_64_GOT64",
+    [R_X86_64_GOTPCREL64] = "R_X86_64_GOTPCREL64",
+    [R_X86_64_GOTPC64] = "R_X86_64_GOTPC64",
+    [R_X86_64_GOTPLT64] = "R_X86_64_GOTPLT64",
+    [R_X86_64_PLTOFF64] = "R_X86_64_PLTOFF64",
+    [R_X86_64_SIZE32] = "R_X86_64_SIZE32",
+    [R_X86_64_SIZE64] = "R_X86_64_SIZE64",
+    [R_X86_64_GOTPC32_TLSDESC] = "R_X86_64_GOTPC32_TLSDESC",
+    [R_X86_64_TLSDESC_CALL] = "R_X86_64_TLSDESC_CALL",
+    [R_X86_64_TLSDESC] = "R_X86_64_TLSDESC",
+    [R_X86_64_IRELATIVE] = "R_X86_64_IRELATIVE",
+    [R_X86_64_RELATIVE64] = "R_X86_64_RELATIVE64",
+    [R_X86_64_GOTPCRELX] = "R_X86_64_GOTPCRELX",
+    [R_X86_64_REX_GOTPCRELX] = "R_X86_64_REX_GOTPCRELX",
+};
+
+/* Intel 80386 relocation types */
+static u8 * elfRelocNames386[] = {
+    [R_386_NONE] = "R_386_NONE",
+    [R_386_32] = "R_386_32",
+    [R_386_PC32] = "R_386_PC32",
+    [R_386_GOT32] = "R_386_GOT32",
+    [R_386_PLT32] = "R_386_PLT32",
+    [R_386_COPY] = "R_386_COPY",
+    [R_386_GLOB_DAT] = "R_386_GLOB_DAT",
+    [R_386_JMP_SLOT] = "R_386_JMP_SLOT",
+    [R_386_RELATIVE] = "R_386_RELATIVE",
+    [R_386_GOTOFF] = "R_386_GOTOFF",
+    [R_386_GOTPC] = "R_386_GOTPC",
+    [R_386_32PLT] = "R_386_32PLT",
+    [R_386_TLS_TPOFF] = "R_386_TLS_TPOFF",
+    [R_386_TLS_IE] = "R_386_TLS_IE",
+    [R_386_TLS_GOTIE] = "R_386_TLS_GOTIE",
+    [R_386_TLS_LE] = "R_386_TLS_LE",
+    [R_386_TLS_GD] = "R_386_TLS_GD",
+    [R_386_TLS_LDM] = "R_386_TLS_LDM",
+    [R_386_16] = "R_386_16",
+    [R_386_PC16] = "R_386_PC16",
+    [R_386_8] = "R_386_8",
+    [R_386_PC8] = "R_386_PC8",
+    [R_386_TLS_GD_32] = "R_386_TLS_GD_32",
+    [R_386_TLS_GD_PUSH] = "R_386_TLS_GD_PUSH",
+    [R_386_TLS_GD_CALL] = "R_386_TLS_GD_CALL",
+    [R_386_TLS_GD_POP] = "R_386_TLS_GD_POP",
+    [R_386_TLS_LDM_32] = "R_386_TLS_LDM_32",
+    [R_386_TLS_LDM_PUSH] = "R_386_TLS_LDM_PUSH",
+    [R_386_TLS_LDM_CALL] = "R_386_TLS_LDM_CALL",
+    [R_386_TLS_LDM_POP] = "R_386_TLS_LDM_POP",
+    [R_386_TLS_LDO_32] = "R_386_TLS_LDO_32",
+    [R_386_TLS_IE_32] = "R_386_TLS_IE_32",
+    [R_386_TLS_LE_32] = "R_386_TLS_LE_32",
+    [R_386_TLS_DTPMOD32] = "R_386_TLS_DTPMOD32",
+    [R_386_TLS_DTPOFF32] = "R_386_TLS_DTPOFF32",
+    [R_386_TLS_TPOFF32] = "R_386_TLS_TPOFF32",
+    [R_386_SIZE32] = "R_386_SIZE32",
+    [R_386_TLS_GOTDESC] = "R_386_TLS_GOTDESC",
+    [R_386_TLS_DESC_CALL] = "R_386_TLS_DESC_CALL",
+    [R_386_TLS_DESC] = "R_386_TLS_DESC",
+    [R_386_IRELATIVE] = "R_386_IRELATIVE",
+    [R_386_GOT32X] = "R_386_GOT32X",
+};
+
+/* AArch64 relocation types */
+static u8 * elfRelocNamesAArch64[] = {
+    [R_AARCH64_NONE] = "R_AARCH64_NONE",
+    [R_AARCH64_P32_ABS32] = "R_AARCH64_P32_ABS32",
+    [R_AARCH64_P32_COPY] = "R_AARCH64_P32_COPY",
+    [R_AARCH64_P32_GLOB_DAT] = "R_AARCH64_P32_GLOB_DAT",
+    [R_AARCH64_P32_JUMP_SLOT] = "R_AARCH64_P32_JUMP_SLOT",
+    [R_AARCH64_P32_RELATIVE] = "R_AARCH64_P32_RELATIVE",
+    [R_AARCH64_P32_TLS_DTPMOD] = "R_AARCH64_P32_TLS_DTPMOD",
+    [R_AARCH64_P32_TLS_DTPREL] = "R_AARCH64_P32_TLS_DTPREL",
+    [R_AARCH64_P32_TLS_TPREL] = "R_AARCH64_P32_TLS_TPREL",
+    [R_AARCH64_P32_TLSDESC] = "R_AARCH64_P32_TLSDESC",
+    [R_AARCH64_P32_IRELATIVE] = "R_AARCH64_P32_IRELATIVE",
+    [R_AARCH64_ABS64] = "R_AARCH64_ABS64",
+    [R_AARCH64_ABS32] = "R_AARCH64_ABS32",
+    [R_AARCH64_ABS16] = "R_AARCH64_ABS16",
+    [R_AARCH64_PREL64] = "R_AARCH64_PREL64",
+    [R_AARCH64_PREL32] = "R_AARCH64_PREL32",
+    [R_AARCH64_PREL16] = "R_AARCH64_PREL16",
+    [R_AARCH64_MOVW_UABS_G0] = "R_AARCH64_MOVW_UABS_G0",
+    [R_AARCH64_MOVW_UABS_G0_NC] = "R_AARCH64_MOVW_UABS_G0_NC",
+    [R_AARCH64_MOVW_UABS_G1] = "R_AARCH64_MOVW_UABS_G1",
+    [R_AARCH64_MOVW_UABS_G1_NC] = "R_AARCH64_MOVW_UABS_G1_NC",
+    [R_AARCH64_MOVW_UABS_G2] = "R_AARCH64_MOVW_UABS_G2",
+    [R_AARCH64_MOVW_UABS_G2_NC] = "R_AARCH64_MOVW_UABS_G2_NC",
+    [R_AARCH64_MOVW_UABS_G3] = "R_AARCH64_MOVW_UABS_G3",
+    [R_AARCH64_MOVW_SABS_G0] = "R_AARCH64_MOVW_SABS_G0",
+    [R_AARCH64_MOVW_SABS_G1] = "R_AARCH64_MOVW_SABS_G1",
+    [R_AARCH64_MOVW_SABS_G2] = "R_AARCH64_MOVW_SABS_G2",
+    [R_AARCH64_LD_PREL_LO19] = "R_AARCH64_LD_PREL_LO19",
+    [R_AARCH64_ADR_PREL_LO21] = "R_AARCH64_ADR_PREL_LO21",
+    [R_AARCH64_ADR_PREL_PG_HI21] = "R_AARCH64_ADR_PREL_PG_HI21",
+    [R_AARCH64_ADR_PREL_PG_HI21_NC] = "R_AARCH64_ADR_PREL_PG_HI21_NC",
+    [R_AARCH64_ADD_ABS_LO12_NC] = "R_AARCH64_ADD_ABS_LO12_NC",
+    [R_AARCH64_LDST8_ABS_LO12_NC] = "R_AARCH64_LDST8_ABS_LO12_NC",
+    [R_AARCH64_TSTBR14] = "R_AARCH64_TSTBR14",
+    [R_AARCH64_CONDBR19] = "R_AARCH64_CONDBR19",
+    [R_AARCH64_JUMP26] = "R_AARCH64_JUMP26",
+    [R_AARCH64_CALL26] = "R_AARCH64_CALL26",
+    [R_AARCH64_LDST16_ABS_LO12_NC] = "R_AARCH64_LDST16_ABS_LO12_NC",
+    [R_AARCH64_LDST32_ABS_LO12_NC] = "R_AARCH64_LDST32_ABS_LO12_NC",
+    [R_AARCH64_LDST64_ABS_LO12_NC] = "R_AARCH64_LDST64_ABS_LO12_NC",
+    [R_AARCH64_MOVW_PREL_G0] = "R_AARCH64_MOVW_PREL_G0",
+    [R_AARCH64_MOVW_PREL_G0_NC] = "R_AARCH64_MOVW_PREL_G0_NC",
+    [R_AARCH64_MOVW_PREL_G1] = "R_AARCH64_MOVW_PREL_G1",
+    [R_AARCH64_MOVW_PREL_G1_NC] = "R_AARCH64_MOVW_PREL_G1_NC",
+    [R_AARCH64_MOVW_PREL_G2] = "R_AARCH64_MOVW_PREL_G2",
+    [R_AARCH64_MOVW_PREL_G2_NC] = "R_AARCH64_MOVW_PREL_G2_NC",
+    [R_AARCH64_MOVW_PREL_G3] = "R_AARCH64_MOVW_PREL_G3",
+    [R_AARCH64_LDST128_ABS_LO12_NC] = "R_AARCH64_LDST128_ABS_LO12_NC",
+    [R_AARCH64_MOVW_GOTOFF_G0] = "R_AARCH64_MOVW_GOTOFF_G0",
+    [R_AARCH64_MOVW_GOTOFF_G0_NC] = "R_AARCH64_MOVW_GOTOFF_G0_NC",
+    [R_AARCH64_MOVW_GOTOFF_G1] = "R_AARCH64_MOVW_GOTOFF_G1",
+    [R_AARCH64_MOVW_GOTOFF_G1_NC] = "R_AARCH64_MOVW_GOTOFF_G1_NC",
+    [R_AARCH64_MOVW_GOTOFF_G2] = "R_AARCH64_MOVW_GOTOFF_G2",
+    [R_AARCH64_MOVW_GOTOFF_G2_NC] = "R_AARCH64_MOVW_GOTOFF_G2_NC",
+    [R_AARCH64_MOVW_GOTOFF_G3] = "R_AARCH64_MOVW_GOTOFF_G3",
+    [R_AARCH64_GOTREL64] = "R_AARCH64_GOTREL64",
+    [R_AARCH64_GOTREL32] = "R_AARCH64_GOTREL32",
+    [R_AARCH64_GOT_LD_PREL19] = "R_AARCH64_GOT_LD_PREL19",
+    [R_AARCH64_LD64_GOTOFF_LO15] = "R_AARCH64_LD64_GOTOFF_LO15",
+    [R_AARCH64_ADR_GOT_PAGE] = "R_AARCH64_ADR_GOT_PAGE",
+    [R_AARCH64_LD64_GOT_LO12_NC] = "R_AARCH64_LD64_GOT_LO12_NC",
+    [R_AARCH64_LD64_GOTPAGE_LO15] = "R_AARCH64_LD64_GOTPAGE_LO15",
+    [R_AARCH64_TLSGD_ADR_PREL21] = "R_AARCH64_TLSGD_ADR_PREL21",
+    [R_AARCH64_TLSGD_ADR_PAGE21] = "R_AARCH64_TLSGD_ADR_PAGE21",
+    [R_AARCH64_TLSGD_ADD_LO12_NC] = "R_AARCH64_TLSGD_ADD_LO12_NC",
+    [R_AARCH64_TLSGD_MOVW_G1] = "R_AARCH64_TLSGD_MOVW_G1",
+    [R_AARCH64_TLSGD_MOVW_G0_NC] = "R_AARCH64_TLSGD_MOVW_G0_NC",
+    [R_AARCH64_TLSLD_ADR_PREL21] = "R_AARCH64_TLSLD_ADR_PREL21",
+    [R_AARCH64_TLSLD_ADR_PAGE21] = "R_AARCH64_TLSLD_ADR_PAGE21",
+    [R_AARCH64_TLSLD_ADD_LO12_NC] = "R_AARCH64_TLSLD_ADD_LO12_NC",
+    [R_AARCH64_TLSLD_MOVW_G1] = "R_AARCH64_TLSLD_MOVW_G1",
+    [R_AARCH64_TLSLD_MOVW_G0_NC] = "R_AARCH64_TLSLD_MOVW_G0_NC",
+    [R_AARCH64_TLSLD_LD_PREL19] = "R_AARCH64_TLSLD_LD_PREL19",
+    [R_AARCH64_TLSLD_MOVW_DTPREL_G2] = "R_AARCH64_TLSLD_MOVW_DTPREL_G2",
+    [R_AARCH64_TLSLD_MOVW_DTPREL_G1] = "R_AARCH64_TLSLD_MOVW_DTPREL_G1",
+    [R_AARCH64_TLSLD_MOVW_DTPREL_G1_NC] = "R_AARCH64_TLSLD_MOVW_DTPREL_G1_NC",
+    [R_AARCH64_TLSLD_MOVW_DTPREL_G0] = "R_AARCH64_TLSLD_MOVW_DTPREL_G0",
+    [R_AARCH64_TLSLD_MOVW_DTPREL_G0_NC] = "R_AARCH64_TLSLD_MOVW_DTPREL_G0_NC",
+    [R_AARCH64_TLSLD_ADD_DTPREL_HI12] = "R_AARCH64_TLSLD_ADD_DTPREL_HI12",
+    [R_AARCH64_TLSLD_ADD_DTPREL_LO12] = "R_AARCH64_TLSLD_ADD_DTPREL_LO12",
+    [R_AARCH64_TLSLD_ADD_DTPREL_LO12_NC] = "R_AARCH64_TLSLD_ADD_DTPREL_LO12_NC",
+    [R_AARCH64_TLSLD_LDST8_DTPREL_LO12] = "R_AARCH64_TLSLD_LDST8_DTPREL_LO12",
+    [R_AARCH64_TLSLD_LDST8_DTPREL_LO12_NC] = "R_AARCH64_TLSLD_LDST8_DTPREL_LO12_NC",
+    [R_AARCH64_TLSLD_LDST16_DTPREL_LO12] = "R_AARCH64_TLSLD_LDST16_DTPREL_LO12",
+    [R_AARCH64_TLSLD_LDST16_DTPREL_LO12_NC] = "R_AARCH64_TLSLD_LDST16_DTPREL_LO12_NC",
+    [R_AARCH64_TLSLD_LDST32_DTPREL_LO12] = "R_AARCH64_TLSLD_LDST32_DTPREL_LO12",
+    [R_AARCH64_TLSLD_LDST32_DTPREL_LO12_NC] = "R_AARCH64_TLSLD_LDST32_DTPREL_LO12_NC",
+    [R_AARCH64_TLSLD_LDST64_DTPREL_LO12] = "R_AARCH64_TLSLD_LDST64_DTPREL_LO12",
+    [R_AARCH64_TLSLD_LDST64_DTPREL_LO12_NC] = "R_AARCH64_TLSLD_LDST64_DTPREL_LO12_NC",
+    [R_AARCH64_TLSIE_MOVW_GOTTPREL_G1] = "R_AARCH64_TLSIE_MOVW_GOTTPREL_G1",
+    [R_AARCH64_TLSIE_MOVW_GOTTPREL_G0_NC] = "R_AARCH64_TLSIE_MOVW_GOTTPREL_G0_NC",
+    [R_AARCH64_TLSIE_ADR_GOTTPREL_PAGE21] = "R_AARCH64_TLSIE_ADR_GOTTPREL_PAGE21",
+    [R_AARCH64_TLSIE_LD64_GOTTPREL_LO12_NC] = "R_AARCH64_TLSIE_LD64_GOTTPREL_LO12_NC",
+    [R_AARCH64_TLSIE_LD_GOTTPREL_PREL19] = "R_AARCH64_TLSIE_LD_GOTTPREL_PREL19",
+    [R_AARCH64_TLSLE_MOVW_TPREL_G2] = "R_AARCH64_TLSLE_MOVW_TPREL_G2",
+    [R_AARCH64_TLSLE_MOVW_TPREL_G1] = "R_AARCH64_TLSLE_MOVW_TPREL_G1",
+    [R_AARCH64_TLSLE_MOVW_TPREL_G1_NC] = "R_AARCH64_TLSLE_MOVW_TPREL_G1_NC",
+    [R_AARCH64_TLSLE_MOVW_TPREL_G0] = "R_AARCH64_TLSLE_MOVW_TPREL_G0",
+    [R_AARCH64_TLSLE_MOVW_TPREL_G0_NC] = "R_AARCH64_TLSLE_MOVW_TPREL_G0_NC",
+    [R_AARCH64_TLSLE_ADD_TPREL_HI12] = "R_AARCH64_TLSLE_ADD_TPREL_HI12",
+    [R_AARCH64_TLSLE_ADD_TPREL_LO12] = "R_AARCH64_TLSLE_ADD_TPREL_LO12",
+    [R_AARCH64_TLSLE_ADD_TPREL_LO12_NC] = "R_AARCH64_TLSLE_ADD_TPREL_LO12_NC",
+    [R_AARCH64_TLSLE_LDST8_TPREL_LO12] = "R_AARCH64_TLSLE_LDST8_TPREL_LO12",
+    [R_AARCH64_TLSLE_LDST8_TPREL_LO12_NC] = "R_AARCH64_TLSLE_LDST8_TPREL_LO12_NC",
+    [R_AARCH64_TLSLE_LDST16_TPREL_LO12] = "R_AARCH64_TLSLE_LDST16_TPREL_LO12",
+    [R_AARCH64_TLSLE_LDST16_TPREL_LO12_NC] = "R_AARCH64_TLSLE_LDST16_TPREL_LO12_NC",
+    [R_AARCH64_TLSLE_LDST32_TPREL_LO12] = "R_AARCH64_TLSLE_LDST32_TPREL_LO12",
+    [R_AARCH64_TLSLE_LDST32_TPREL_LO12_NC] = "R_AARCH64_TLSLE_LDST32_TPREL_LO12_NC",
+    [R_AARCH64_TLSLE_LDST64_TPREL_LO12] = "R_AARCH64_TLSLE_LDST64_TPREL_LO12",
+    [R_AARCH64_TLSLE_LDST64_TPREL_LO12_NC] = "R_AARCH64_TLSLE_LDST64_TPREL_LO12_NC",
+    [R_AARCH64_TLSDESC_LD_PREL19] = "R_AARCH64_TLSDESC_LD_PREL19",
+    [R_AARCH64_TLSDESC_ADR_PREL21] = "R_AARCH64_TLSDESC_ADR_PREL21",
+    [R_AARCH64_TLSDESC_ADR_PAGE21] = "R_AARCH64_TLSDESC_ADR_PAGE21",
+    [R_AARCH64_TLSDESC_LD64_LO12] = "R_AARCH64_TLSDESC_LD64_LO12",
+    [R_AARCH64_TLSDESC_ADD_LO12] = "R_AARCH64_TLSDESC_ADD_LO12",
+    [R_AARCH64_TLSDESC_OFF_G1] = "R_AARCH64_TLSDESC_OFF_G1",
+    [R_AARCH64_TLSDESC_OFF_G0_NC] = "R_AARCH64_TLSDESC_OFF_G0_NC",
+    [R_AARCH64_TLSDESC_LDR] = "R_AARCH64_TLSDESC_LDR",
+    [R_AARCH64_TLSDESC_ADD] = "R_AARCH64_TLSDESC_ADD",
+    [R_AARCH64_TLSDESC_CALL] = "R_AARCH64_TLSDESC_CALL",
+    [R_AARCH64_TLSLE_LDST128_TPREL_LO12] = "R_AARCH64_TLSLE_LDST128_TPREL_LO12",
+    [R_AARCH64_TLSLE_LDST128_TPREL_LO12_NC] = "R_AARCH64_TLSLE_LDST128_TPREL_LO12_NC",
+    [R_AARCH64_TLSLD_LDST128_DTPREL_LO12] = "R_AARCH64_TLSLD_LDST128_DTPREL_LO12",
+    [R_AARCH64_TLSLD_LDST128_DTPREL_LO12_NC] = "R_AARCH64_TLSLD_LDST128_DTPREL_LO12_NC",
+    [R_AARCH64_COPY] = "R_AARCH64_COPY",
+    [R_AARCH64_GLOB_DAT] = "R_AARCH64_GLOB_DAT",
+    [R_AARCH64_JUMP_SLOT] = "R_AARCH64_JUMP_SLOT",
+    [R_AARCH64_RELATIVE] = "R_AARCH64_RELATIVE",
+    [R_AARCH64_TLS_DTPMOD] = "R_AARCH64_TLS_DTPMOD",
+    [R_AARCH64_TLS_DTPREL] = "R_AARCH64_TLS_DTPREL",
+    [R_AARCH64_TLS_TPREL] = "R_AARCH64_TLS_TPREL",
+    [R_AARCH64_TLSDESC] = "R_AARCH64_TLSDESC",
+    [R_AARCH64_IRELATIVE] = "R_AARCH64_IRELATIVE",
+};
+
+/* ARM relocation types */
+static u8 * elfRelocNamesARM[] = {
+    [R_ARM_NONE] = "R_ARM_NONE",
+    [R_ARM_PC24] = "R_ARM_PC24",
+    [R_ARM_ABS32] = "R_ARM_ABS32",
+    [R_ARM_REL32] = "R_ARM_REL32",
+    [R_ARM_PC13] = "R_ARM_PC13",
+    [R_ARM_ABS16] = "R_ARM_ABS16",
+    [R_ARM_ABS12] = "R_ARM_ABS12",
+    [R_ARM_THM_ABS5] = "R_ARM_THM_ABS5",
+    [R_ARM_ABS8] = "R_ARM_ABS8",
+    [R_ARM_SBREL32] = "R_ARM_SBREL32",
+    [R_ARM_THM_PC22] = "R_ARM_THM_PC22",
+    [R_ARM_THM_PC8] = "R_ARM_THM_PC8",
+    [R_ARM_AMP_VCALL9] = "R_ARM_AMP_VCALL9",
+    [R_ARM_SWI24] = "R_ARM_SWI24",
+    [R_ARM_THM_SWI8] = "R_ARM_THM_SWI8",
+    [R_ARM_XPC25] = "R_ARM_XPC25",
+    [R_ARM_THM_XPC22] = "R_ARM_THM_XPC22",
+    [R_ARM_TLS_DTPMOD32] = "R_ARM_TLS_DTPMOD32",
+    [R_ARM_TLS_DTPOFF32] = "R_ARM_TLS_DTPOFF32",
+    [R_ARM_TLS_TPOFF32] = "R_ARM_TLS_TPOFF32",
+    [R_ARM_COPY] = "R_ARM_COPY",
+    [R_ARM_GLOB_DAT] = "R_ARM_GLOB_DAT",
+    [R_ARM_JUMP_SLOT] = "R_ARM_JUMP_SLOT",
+    [R_ARM_RELATIVE] = "R_ARM_RELATIVE",
+    [R_ARM_GOTOFF] = "R_ARM_GOTOFF",
+    [R_ARM_GOTPC] = "R_ARM_GOTPC",
+    [R_ARM_GOT32] = "R_ARM_GOT32",
+    [R_ARM_PLT32] = "R_ARM_PLT32",
+    [R_ARM_CALL] = "R_ARM_CALL",
+    [R_ARM_JUMP24] = "R_ARM_JUMP24",
+    [R_ARM_THM_JUMP24] = "R_ARM_THM_JUMP24",
+    [R_ARM_BASE_ABS] = "R_ARM_BASE_ABS",
+    [R_ARM_ALU_PCREL_7_0] = "R_ARM_ALU_PCREL_7_0",
+    [R_ARM_ALU_PCREL_15_8] = "R_ARM_ALU_PCREL_15_8",
+    [R_ARM_ALU_PCREL_23_15] = "R_ARM_ALU_PCREL_23_15",
+    [R_ARM_LDR_SBREL_11_0] = "R_ARM_LDR_SBREL_11_0",
+    [R_ARM_ALU_SBREL_19_12] = "R_ARM_ALU_SBREL_19_12",
+    [R_ARM_ALU_SBREL_27_20] = "R_ARM_ALU_SBREL_27_20",
+    [R_ARM_TARGET1] = "R_ARM_TARGET1",
+    [R_ARM_SBREL31] = "R_ARM_SBREL31",
+    [R_ARM_V4BX] = "R_ARM_V4BX",
+    [R_ARM_TARGET2] = "R_ARM_TARGET2",
+    [R_ARM_PREL31] = "R_ARM_PREL31",
+    [R_ARM_MOVW_ABS_NC] = "R_ARM_MOVW_ABS_NC",
+    [R_ARM_MOVT_ABS] = "R_ARM_MOVT_ABS",
+    [R_ARM_MOVW_PREL_NC] = "R_ARM_MOVW_PREL_NC",
+    [R_ARM_MOVT_PREL] = "R_ARM_MOVT_PREL",
+    [R_ARM_THM_MOVW_ABS_NC] = "R_ARM_THM_MOVW_ABS_NC",
+    [R_ARM_THM_MOVT_ABS] = "R_ARM_THM_MOVT_ABS",
+    [R_ARM_THM_MOVW_PREL_NC] = "R_ARM_THM_MOVW_PREL_NC",
+    [R_ARM_THM_MOVT_PREL] = "R_ARM_THM_MOVT_PREL",
+    [R_ARM_THM_JUMP19] = "R_ARM_THM_JUMP19",
+    [R_ARM_THM_JUMP6] = "R_ARM_THM_JUMP6",
+    [R_ARM_THM_ALU_PREL_11_0] = "R_ARM_THM_ALU_PREL_11_0",
+    [R_ARM_THM_PC12] = "R_ARM_THM_PC12",
+    [R_ARM_ABS32_NOI] = "R_ARM_ABS32_NOI",
+    [R_ARM_REL32_NOI] = "R_ARM_REL32_NOI",
+    [R_ARM_ALU_PC_G0_NC] = "R_ARM_ALU_PC_G0_NC",
+    [R_ARM_ALU_PC_G0] = "R_ARM_ALU_PC_G0",
+    [R_ARM_ALU_PC_G1_NC] = "R_ARM_ALU_PC_G1_NC",
+    [R_ARM_ALU_PC_G1] = "R_ARM_ALU_PC_G1",
+    [R_ARM_ALU_PC_G2] = "R_ARM_ALU_PC_G2",
+    [R_ARM_LDR_PC_G1] = "R_ARM_LDR_PC_G1",
+    [R_ARM_LDR_PC_G2] = "R_ARM_LDR_PC_G2",
+    [R_ARM_LDRS_PC_G0] = "R_ARM_LDRS_PC_G0",
+    [R_ARM_LDRS_PC_G1] = "R_ARM_LDRS_PC_G1",
+    [R_ARM_LDRS_PC_G2] = "R_ARM_LDRS_PC_G2",
+    [R_ARM_LDC_PC_G0] = "R_ARM_LDC_PC_G0",
+    [R_ARM_LDC_PC_G1] = "R_ARM_LDC_PC_G1",
+    [R_ARM_LDC_PC_G2] = "R_ARM_LDC_PC_G2",
+    [R_ARM_ALU_SB_G0_NC] = "R_ARM_ALU_SB_G0_NC",
+    [R_ARM_ALU_SB_G0] = "R_ARM_ALU_SB_G0",
+    [R_ARM_ALU_SB_G1_NC] = "R_ARM_ALU_SB_G1_NC",
+    [R_ARM_ALU_SB_G1] = "R_ARM_ALU_SB_G1",
+    [R_ARM_ALU_SB_G2] = "R_ARM_ALU_SB_G2",
+    [R_ARM_LDR_SB_G0] = "R_ARM_LDR_SB_G0",
+    [R_ARM_LDR_SB_G1] = "R_ARM_LDR_SB_G1",
+    [R_ARM_LDR_SB_G2] = "R_ARM_LDR_SB_G2",
+    [R_ARM_LDRS_SB_G0] = "R_ARM_LDRS_SB_G0",
+    [R_ARM_LDRS_SB_G1] = "R_ARM_LDRS_SB_G1",
+    [R_ARM_LDRS_SB_G2] = "R_ARM_LDRS_SB_G2",
+    [R_ARM_LDC_SB_G0] = "R_ARM_LDC_SB_G0",
+    [R_ARM_LDC_SB_G1] = "R_ARM_LDC_SB_G1",
+    [R_ARM_LDC_SB_G2] = "R_ARM_LDC_SB_G2",
+    [R_ARM_MOVW_BREL_NC] = "R_ARM_MOVW_BREL_NC",
+    [R_ARM_MOVT_BREL] = "R_ARM_MOVT_BREL",
+    [R_ARM_MOVW_BREL] = "R_ARM_MOVW_BREL",
+    [R_ARM_THM_MOVW_BREL_NC] = "R_ARM_THM_MOVW_BREL_NC",
+    [R_ARM_THM_MOVT_BREL] = "R_ARM_THM_MOVT_BREL",
+    [R_ARM_THM_MOVW_BREL] = "R_ARM_THM_MOVW_BREL",
+    [R_ARM_TLS_GOTDESC] = "R_ARM_TLS_GOTDESC",
+    [R_ARM_TLS_CALL] = "R_ARM_TLS_CALL",
+    [R_ARM_TLS_DESCSEQ] = "R_ARM_TLS_DESCSEQ",
+    [R_ARM_THM_TLS_CALL] = "R_ARM_THM_TLS_CALL",
+    [R_ARM_PLT32_ABS] = "R_ARM_PLT32_ABS",
+    [R_ARM_GOT_ABS] = "R_ARM_GOT_ABS",
+    [R_ARM_GOT_PREL] = "R_ARM_GOT_PREL",
+    [R_ARM_GOT_BREL12] = "R_ARM_GOT_BREL12",
+    [R_ARM_GOTOFF12] = "R_ARM_GOTOFF12",
+    [R_ARM_GOTRELAX] = "R_ARM_GOTRELAX",
+    [R_ARM_GNU_VTENTRY] = "R_ARM_GNU_VTENTRY",
+    [R_ARM_GNU_VTINHERIT] = "R_ARM_GNU_VTINHERIT",
+    [R_ARM_THM_PC11] = "R_ARM_THM_PC11",
+    [R_ARM_THM_PC9] = "R_ARM_THM_PC9",
+    [R_ARM_TLS_GD32] = "R_ARM_TLS_GD32",
+    [R_ARM_TLS_LDM32] = "R_ARM_TLS_LDM32",
+    [R_ARM_TLS_LDO32] = "R_ARM_TLS_LDO32",
+    [R_ARM_TLS_IE32] = "R_ARM_TLS_IE32",
+    [R_ARM_TLS_LE32] = "R_ARM_TLS_LE32",
+    [R_ARM_TLS_LDO12] = "R_ARM_TLS_LDO12",
+    [R_ARM_TLS_LE12] = "R_ARM_TLS_LE12",
+    [R_ARM_TLS_IE12GP] = "R_ARM_TLS_IE12GP",
+    [R_ARM_ME_TOO] = "R_ARM_ME_TOO",
+    [R_ARM_THM_TLS_DESCSEQ] = "R_ARM_THM_TLS_DESCSEQ",
+    [R_ARM_THM_TLS_DESCSEQ32] = "R_ARM_THM_TLS_DESCSEQ32",
+    [R_ARM_THM_GOT_BREL12] = "R_ARM_THM_GOT_BREL12",
+    [R_ARM_IRELATIVE] = "R_ARM_IRELATIVE",
+    [R_ARM_RXPC25] = "R_ARM_RXPC25",
+    [R_ARM_RSBREL32] = "R_ARM_RSBREL32",
+    [R_ARM_THM_RPC22] = "R_ARM_THM_RPC22",
+    [R_ARM_RREL32] = "R_ARM_RREL32",
+    [R_ARM_RABS22] = "R_ARM_RABS22",
+    [R_ARM_RPC24] = "R_ARM_RPC24",
+    [R_ARM_RBASE] = "R_ARM_RBASE",
+};
+
+/* RISC-V relocation types */
+static u8 * elfRelocNamesRISCV[] = {
+    [R_RISCV_NONE] = "R_RISCV_NONE",
+    [R_RISCV_32] = "R_RISCV_32",
+    [R_RISCV_64] = "R_RISCV_64",
+    [R_RISCV_RELATIVE] = "R_RISCV_RELATIVE",
+    [R_RISCV_COPY] = "R_RISCV_COPY",
+    [R_RISCV_JUMP_SLOT] = "R_RISCV_JUMP_SLOT",
+    [R_RISCV_TLS_DTPMOD32] = "R_RISCV_TLS_DTPMOD32",
+    [R_RISCV_TLS_DTPMOD64] = "R_RISCV_TLS_DTPMOD64",
+    [R_RISCV_TLS_DTPREL32] = "R_RISCV_TLS_DTPREL32",
+    [R_RISCV_TLS_DTPREL64] = "R_RISCV_TLS_DTPREL64",
+    [R_RISCV_TLS_TPREL32] = "R_RISCV_TLS_TPREL32",
+    [R_RISCV_TLS_TPREL64] = "R_RISCV_TLS_TPREL64",
+    [R_RISCV_BRANCH] = "R_RISCV_BRANCH",
+    [R_RISCV_JAL] = "R_RISCV_JAL",
+    [R_RISCV_CALL] = "R_RISCV_CALL",
+    [R_RISCV_CALL_PLT] = "R_RISCV_CALL_PLT",
+    [R_RISCV_GOT_HI20] = "R_RISCV_GOT_HI20",
+    [R_RISCV_TLS_GOT_HI20] = "R_RISCV_TLS_GOT_HI20",
+    [R_RISCV_TLS_GD_HI20] = "R_RISCV_TLS_GD_HI20",
+    [R_RISCV_PCREL_HI20] = "R_RISCV_PCREL_HI20",
+    [R_RISCV_PCREL_LO12_I] = "R_RISCV_PCREL_LO12_I",
+    [R_RISCV_PCREL_LO12_S] = "R_RISCV_PCREL_LO12_S",
+    [R_RISCV_HI20] = "R_RISCV_HI20",
+    [R_RISCV_LO12_I] = "R_RISCV_LO12_I",
+    [R_RISCV_LO12_S] = "R_RISCV_LO12_S",
+    [R_RISCV_TPREL_HI20] = "R_RISCV_TPREL_HI20",
+    [R_RISCV_TPREL_LO12_I] = "R_RISCV_TPREL_LO12_I",
+    [R_RISCV_TPREL_LO12_S] = "R_RISCV_TPREL_LO12_S",
+    [R_RISCV_TPREL_ADD] = "R_RISCV_TPREL_ADD",
+    [R_RISCV_ADD8] = "R_RISCV_ADD8",
+    [R_RISCV_ADD16] = "R_RISCV_ADD16",
+    [R_RISCV_ADD32] = "R_RISCV_ADD32",
+    [R_RISCV_ADD64] = "R_RISCV_ADD64",
+    [R_RISCV_SUB8] = "R_RISCV_SUB8",
+    [R_RISCV_SUB16] = "R_RISCV_SUB16",
+    [R_RISCV_SUB32] = "R_RISCV_SUB32",
+    [R_RISCV_SUB64] = "R_RISCV_SUB64",
+    [R_RISCV_GNU_VTINHERIT] = "R_RISCV_GNU_VTINHERIT",
+    [R_RISCV_GNU_VTENTRY] = "R_RISCV_GNU_VTENTRY",
+    [R_RISCV_ALIGN] = "R_RISCV_ALIGN",
+    [R_RISCV_RVC_BRANCH] = "R_RISCV_RVC_BRANCH",
+    [R_RISCV_RVC_JUMP] = "R_RISCV_RVC_JUMP",
+    [R_RISCV_RVC_LUI] = "R_RISCV_RVC_LUI",
+    [R_RISCV_GPREL_I] = "R_RISCV_GPREL_I",
+    [R_RISCV_GPREL_S] = "R_RISCV_GPREL_S",
+    [R_RISCV_TPREL_I] = "R_RISCV_TPREL_I",
+    [R_RISCV_TPREL_S] = "R_RISCV_TPREL_S",
+    [R_RISCV_RELAX] = "R_RISCV_RELAX",
+    [R_RISCV_SUB6] = "R_RISCV_SUB6",
+    [R_RISCV_SET6] = "R_RISCV_SET6",
+    [R_RISCV_SET8] = "R_RISCV_SET8",
+    [R_RISCV_SET16] = "R_RISCV_SET16",
+    [R_RISCV_SET32] = "R_RISCV_SET32",
+    [R_RISCV_32_PCREL] = "R_RISCV_32_PCREL",
+};
+
+/* PowerPC64 relocation types */
+static u8 * elfRelocNamesPPC64[] = {
+    [R_PPC64_NONE] = "R_PPC64_NONE",
+    [R_PPC64_ADDR32] = "R_PPC64_ADDR32",
+    [R_PPC64_ADDR24] = "R_PPC64_ADDR24",
+    [R_PPC64_ADDR16] = "R_PPC64_ADDR16",
+    [R_PPC64_ADDR16_LO] = "R_PPC64_ADDR16_LO",
+    [R_PPC64_ADDR16_HI] = "R_PPC64_ADDR16_HI",
+    [R_PPC64_ADDR16_HA] = "R_PPC64_ADDR16_HA",
+    [R_PPC64_ADDR14] = "R_PPC64_ADDR14",
+    [R_PPC64_ADDR14_BRTAKEN] = "R_PPC64_ADDR14_BRTAKEN",
+    [R_PPC64_ADDR14_BRNTAKEN] = "R_PPC64_ADDR14_BRNTAKEN",
+    [R_PPC64_REL24] = "R_PPC64_REL24",
+    [R_PPC64_REL14] = "R_PPC64_REL14",
+    [R_PPC64_REL14_BRTAKEN] = "R_PPC64_REL14_BRTAKEN",
+    [R_PPC64_REL14_BRNTAKEN] = "R_PPC64_REL14_BRNTAKEN",
+    [R_PPC64_GOT16] = "R_PPC64_GOT16",
+    [R_PPC64_GOT16_LO] = "R_PPC64_GOT16_LO",
+    [R_PPC64_GOT16_HI] = "R_PPC64_GOT16_HI",
+    [R_PPC64_GOT16_HA] = "R_PPC64_GOT16_HA",
+    [R_PPC64_COPY] = "R_PPC64_COPY",
+    [R_PPC64_GLOB_DAT] = "R_PPC64_GLOB_DAT",
+    [R_PPC64_JMP_SLOT] = "R_PPC64_JMP_SLOT",
+    [R_PPC64_RELATIVE] = "R_PPC64_RELATIVE",
+    [R_PPC64_UADDR32] = "R_PPC64_UADDR32",
+    [R_PPC64_UADDR16] = "R_PPC64_UADDR16",
+    [R_PPC64_REL32] = "R_PPC64_REL32",
+    [R_PPC64_PLT32] = "R_PPC64_PLT32",
+    [R_PPC64_PLTREL32] = "R_PPC64_PLTREL32",
+    [R_PPC64_PLT16_LO] = "R_PPC64_PLT16_LO",
+    [R_PPC64_PLT16_HI] = "R_PPC64_PLT16_HI",
+    [R_PPC64_PLT16_HA] = "R_PPC64_PLT16_HA",
+    [R_PPC64_SECTOFF] = "R_PPC64_SECTOFF",
+    [R_PPC64_SECTOFF_LO] = "R_PPC64_SECTOFF_LO",
+    [R_PPC64_SECTOFF_HI] = "R_PPC64_SECTOFF_HI",
+    [R_PPC64_SECTOFF_HA] = "R_PPC64_SECTOFF_HA",
+    [R_PPC64_ADDR30] = "R_PPC64_ADDR30",
+    [R_PPC64_ADDR64] = "R_PPC64_ADDR64",
+    [R_PPC64_ADDR16_HIGHER] = "R_PPC64_ADDR16_HIGHER",
+    [R_PPC64_ADDR16_HIGHERA] = "R_PPC64_ADDR16_HIGHERA",
+    [R_PPC64_ADDR16_HIGHEST] = "R_PPC64_ADDR16_HIGHEST",
+    [R_PPC64_ADDR16_HIGHESTA] = "R_PPC64_ADDR16_HIGHESTA",
+    [R_PPC64_UADDR64] = "R_PPC64_UADDR64",
+    [R_PPC64_REL64] = "R_PPC64_REL64",
+    [R_PPC64_PLT64] = "R_PPC64_PLT64",
+    [R_PPC64_PLTREL64] = "R_PPC64_PLTREL64",
+    [R_PPC64_TOC16] = "R_PPC64_TOC16",
+    [R_PPC64_TOC16_LO] = "R_PPC64_TOC16_LO",
+    [R_PPC64_TOC16_HI] = "R_PPC64_TOC16_HI",
+    [R_PPC64_TOC16_HA] = "R_PPC64_TOC16_HA",
+    [R_PPC64_TOC] = "R_PPC64_TOC",
+    [R_PPC64_PLTGOT16] = "R_PPC64_PLTGOT16",
+    [R_PPC64_PLTGOT16_LO] = "R_PPC64_PLTGOT16_LO",
+    [R_PPC64_PLTGOT16_HI] = "R_PPC64_PLTGOT16_HI",
+    [R_PPC64_PLTGOT16_HA] = "R_PPC64_PLTGOT16_HA",
+    [R_PPC64_ADDR16_DS] = "R_PPC64_ADDR16_DS",
+    [R_PPC64_ADDR16_LO_DS] = "R_PPC64_ADDR16_LO_DS",
+    [R_PPC64_GOT16_DS] = "R_PPC64_GOT16_DS",
+    [R_PPC64_GOT16_LO_DS] = "R_PPC64_GOT16_LO_DS",
+    [R_PPC64_PLT16_LO_DS] = "R_PPC64_PLT16_LO_DS",
+    [R_PPC64_SECTOFF_DS] = "R_PPC64_SECTOFF_DS",
+    [R_PPC64_SECTOFF_LO_DS] = "R_PPC64_SECTOFF_LO_DS",
+    [R_PPC64_TOC16_DS] = "R_PPC64_TOC16_DS",
+    [R_PPC64_TOC16_LO_DS] = "R_PPC64_TOC16_LO_DS",
+    [R_PPC64_PLTGOT16_DS] = "R_PPC64_PLTGOT16_DS",
+    [R_PPC64_PLTGOT16_LO_DS] = "R_PPC64_PLTGOT16_LO_DS",
+    [R_PPC64_TLS] = "R_PPC64_TLS",
+    [R_PPC64_DTPMOD64] = "R_PPC64_DTPMOD64",
+    [R_PPC64_TPREL16] = "R_PPC64_TPREL16",
+    [R_PPC64_TPREL16_LO] = "R_PPC64_TPREL16_LO",
+    [R_PPC64_TPREL16_HI] = "R_PPC64_TPREL16_HI",
+    [R_PPC64_TPREL16_HA] = "R_PPC64_TPREL16_HA",
+    [R_PPC64_TPREL64] = "R_PPC64_TPREL64",
+    [R_PPC64_DTPREL16] = "R_PPC64_DTPREL16",
+    [R_PPC64_DTPREL16_LO] = "R_PPC64_DTPREL16_LO",
+    [R_PPC64_DTPREL16_HI] = "R_PPC64_DTPREL16_HI",
+    [R_PPC64_DTPREL16_HA] = "R_PPC64_DTPREL16_HA",
+    [R_PPC64_DTPREL64] = "R_PPC64_DTPREL64",
+    [R_PPC64_GOT_TLSGD16] = "R_PPC64_GOT_TLSGD16",
+    [R_PPC64_GOT_TLSGD16_LO] = "R_PPC64_GOT_TLSGD16_LO",
+    [R_PPC64_GOT_TLSGD16_HI] = "R_PPC64_GOT_TLSGD16_HI",
+    [R_PPC64_GOT_TLSGD16_HA] = "R_PPC64_GOT_TLSGD16_HA",
+    [R_PPC64_GOT_TLSLD16] = "R_PPC64_GOT_TLSLD16",
+    [R_PPC64_GOT_TLSLD16_LO] = "R_PPC64_GOT_TLSLD16_LO",
+    [R_PPC64_GOT_TLSLD16_HI] = "R_PPC64_GOT_TLSLD16_HI",
+    [R_PPC64_GOT_TLSLD16_HA] = "R_PPC64_GOT_TLSLD16_HA",
+    [R_PPC64_GOT_TPREL16_DS] = "R_PPC64_GOT_TPREL16_DS",
+    [R_PPC64_GOT_TPREL16_LO_DS] = "R_PPC64_GOT_TPREL16_LO_DS",
+    [R_PPC64_GOT_TPREL16_HI] = "R_PPC64_GOT_TPREL16_HI",
+    [R_PPC64_GOT_TPREL16_HA] = "R_PPC64_GOT_TPREL16_HA",
+    [R_PPC64_GOT_DTPREL16_DS] = "R_PPC64_GOT_DTPREL16_DS",
+    [R_PPC64_GOT_DTPREL16_LO_DS] = "R_PPC64_GOT_DTPREL16_LO_DS",
+    [R_PPC64_GOT_DTPREL16_HI] = "R_PPC64_GOT_DTPREL16_HI",
+    [R_PPC64_GOT_DTPREL16_HA] = "R_PPC64_GOT_DTPREL16_HA",
+    [R_PPC64_TPREL16_DS] = "R_PPC64_TPREL16_DS",
+    [R_PPC64_TPREL16_LO_DS] = "R_PPC64_TPREL16_LO_DS",
+    [R_PPC64_TPREL16_HIGHER] = "R_PPC64_TPREL16_HIGHER",
+    [R_PPC64_TPREL16_HIGHERA] = "R_PPC64_TPREL16_HIGHERA",
+    [R_PPC64_TPREL16_HIGHEST] = "R_PPC64_TPREL16_HIGHEST",
+    [R_PPC64_TPREL16_HIGHESTA] = "R_PPC64_TPREL16_HIGHESTA",
+    [R_PPC64_DTPREL16_DS] = "R_PPC64_DTPREL16_DS",
+    [R_PPC64_DTPREL16_LO_DS] = "R_PPC64_DTPREL16_LO_DS",
+    [R_PPC64_DTPREL16_HIGHER] = "R_PPC64_DTPREL16_HIGHER",
+    [R_PPC64_DTPREL16_HIGHERA] = "R_PPC64_DTPREL16_HIGHERA",
+    [R_PPC64_DTPREL16_HIGHEST] = "R_PPC64_DTPREL16_HIGHEST",
+    [R_PPC64_DTPREL16_HIGHESTA] = "R_PPC64_DTPREL16_HIGHESTA",
+    [R_PPC64_TLSGD] = "R_PPC64_TLSGD",
+    [R_PPC64_TLSLD] = "R_PPC64_TLSLD",
+    [R_PPC64_TOCSAVE] = "R_PPC64_TOCSAVE",
+    [R_PPC64_ADDR16_HIGH] = "R_PPC64_ADDR16_HIGH",
+    [R_PPC64_ADDR16_HIGHA] = "R_PPC64_ADDR16_HIGHA",
+    [R_PPC64_TPREL16_HIGH] = "R_PPC64_TPREL16_HIGH",
+    [R_PPC64_TPREL16_HIGHA] = "R_PPC64_TPREL16_HIGHA",
+    [R_PPC64_DTPREL16_HIGH] = "R_PPC64_DTPREL16_HIGH",
+    [R_PPC64_DTPREL16_HIGHA] = "R_PPC64_DTPREL16_HIGHA",
+    [R_PPC64_JMP_IREL] = "R_PPC64_JMP_IREL",
+    [R_PPC64_IRELATIVE] = "R_PPC64_IRELATIVE",
+    [R_PPC64_REL16] = "R_PPC64_REL16",
+    [R_PPC64_REL16_LO] = "R_PPC64_REL16_LO",
+    [R_PPC64_REL16_HI] = "R_PPC64_REL16_HI",
+    [R_PPC64_REL16_HA] = "R_PPC64_REL16_HA",
+};
+
+/* Get the table of relocation types' names of the ELF machine */
+u8 ** get_elf_reloc_table(u16 machine, u32 * tableSize){
+
+    u8 ** relocTable;
+
+    switch(machine){
+        case EM_X86_64:
+            relocTable = elfRelocNamesX86_64;
+            *tableSize = ELF_NAMES_COUNT(elfRelocNamesX86_64);
+            break;
+        case EM_386:
+        case EM_IAMCU:
+            relocTable = elfRelocNames386;
+            *tableSize = ELF_NAMES_COUNT(elfRelocNames386);
+            break;
+        case EM_AARCH64:
+            relocTable = elfRelocNamesAArch64;
+            *tableSize = ELF_NAMES_COUNT(elfRelocNamesAArch64);
+            break;
+        case EM_ARM:
+            relocTable = elfRelocNamesARM;
+            *tableSize = ELF_NAMES_COUNT(elfRelocNamesARM);
+            break;
+        case EM_RISCV:
+            relocTable = elfRelocNamesRISCV;
+            *tableSize = ELF_NAMES_COUNT(elfRelocNamesRISCV);
+            break;
+        case EM_PPC64:
+            relocTable = elfRelocNamesPPC64;
+            *tableSize = ELF_NAMES_COUNT(elfRelocNamesPPC64);
+            break;
+        default:
+            // Unknown machine, every relocation type will be reported as N/A
+            relocTable = NULL;
+            *tableSize = 0;
+    }
+
+    return relocTable;
+}
+
+
+/* Get the relative relocation type of the ELF machine (the type implied by SHT_RELR entries) */
+u32 get_elf_relative_reloc_type(u16 machine){
+
+    switch(machine){
+        case EM_X86_64:
+            return R_X86_64_RELATIVE;
+        case EM_386:
+        case EM_IAMCU:
+            return R_386_RELATIVE;
+        case EM_AARCH64:
+            return R_AARCH64_RELATIVE;
+        case EM_ARM:
+            return R_ARM_RELATIVE;
+        case EM_RISCV:
+            return R_RISCV_RELATIVE;
+        case EM_PPC64:
+            return R_PPC64_RELATIVE;
+    }
+
+    // Out of every table, so it is reported as N/A
+    return (u32)-1;
+}
+
+
+/* Get the relocation type of the ELF machine that fills a PLT's GOT slot */
+u32 get_elf_jump_slot_reloc_type(u16 machine){
+
+    switch(machine){
+        case EM_X86_64:
+            return R_X86_64_JUMP_SLOT;
+        case EM_386:
+        case EM_IAMCU:
+            return R_386_JMP_SLOT;
+        case EM_AARCH64:
+            return R_AARCH64_JUMP_SLOT;
+        case EM_ARM:
+            return R_ARM_JUMP_SLOT;
+        case EM_RISCV:
+            return R_RISCV_JUMP_SLOT;
+        case EM_PPC64:
+            return R_PPC64_JMP_SLOT;
+    }
+
+    return (u32)-1;
+}
+
+
+/* Get the relocation type of the ELF machine that fills a GOT slot with a symbol's address */
+u32 get_elf_glob_dat_reloc_type(u16 machine){
+
+    // RISC-V fills its GOT with plain word relocations, which cannot be told apart from data
+    switch(machine){
+        case EM_X86_64:
+            return R_X86_64_GLOB_DAT;
+        case EM_386:
+        case EM_IAMCU:
+            return R_386_GLOB_DAT;
+        case EM_AARCH64:
+            return R_AARCH64_GLOB_DAT;
+        case EM_ARM:
+            return R_ARM_GLOB_DAT;
+        case EM_PPC64:
+            return R_PPC64_GLOB_DAT;
+    }
+
+    return (u32)-1;
+}
+
+
+/* Get the relocation type of the ELF machine that fills a GOT slot with the result of an ifunc resolver */
+u32 get_elf_irelative_reloc_type(u16 machine){
 
+    switch(machine){
+        case EM_X86_64:
+            return R_X86_64_IRELATIVE;
+        case EM_386:
+        case EM_IAMCU:
+            return R_386_IRELATIVE;
+        case EM_AARCH64:
+            return R_AARCH64_IRELATIVE;
+        case EM_ARM:
+            return R_ARM_IRELATIVE;
+        case EM_PPC64:
+            return R_PPC64_IRELATIVE;
+    }
+
+    return (u32)-1;
 }
 
 
+/* Get string representation of the ELF relocation type */
+u8 * get_elf_reloc_type(u8 ** relocTable, u32 tableSize, u32 type){
 
+    // Holes in the tables are the types which are not defined for the machine
+    if(type < tableSize && relocTable[type])
+        return relocTable[type];
 
+    return "N/A";
+}
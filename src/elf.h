@@ -446,7 +446,8 @@ typedef struct
 #define SHT_PREINIT_ARRAY 16		/* Array of pre-constructors */
 #define SHT_GROUP	  17		/* Section group */
 #define SHT_SYMTAB_SHNDX  18		/* Extended section indeces */
-#define	SHT_NUM		  19		/* Number of defined types.  */
+#define SHT_RELR	  19		/* RELR relative relocations */
+#define	SHT_NUM		  20		/* Number of defined types.  */
 #define SHT_LOOS	  0x60000000	/* Start OS-specific.  */
 #define SHT_GNU_ATTRIBUTES 0x6ffffff5	/* Object attributes.  */
 #define SHT_GNU_HASH	  0x6ffffff6	/* GNU-style hash table.  */
@@ -721,6 +722,7 @@ typedef struct
 #define PT_GNU_EH_FRAME	0x6474e550	/* GCC .eh_frame_hdr segment */
 #define PT_GNU_STACK	0x6474e551	/* Indicates stack executability */
 #define PT_GNU_RELRO	0x6474e552	/* Read-only after relocation */
+#define PT_GNU_PROPERTY	0x6474e553	/* GNU property notes for linker and run-time loaders */
 #define PT_LOSUNW	0x6ffffffa
 #define PT_SUNWBSS	0x6ffffffa	/* Sun Specific segment */
 #define PT_SUNWSTACK	0x6ffffffb	/* Stack segment */
@@ -884,7 +886,10 @@ typedef struct
 #define DT_PREINIT_ARRAY 32		/* Array with addresses of preinit fct*/
 #define DT_PREINIT_ARRAYSZ 33		/* size in bytes of DT_PREINIT_ARRAY */
 #define DT_SYMTAB_SHNDX	34		/* Address of SYMTAB_SHNDX section */
-#define	DT_NUM		35		/* Number used */
+#define DT_RELRSZ	35		/* Total size of RELR relative relocations */
+#define DT_RELR		36		/* Address of RELR relative relocations */
+#define DT_RELRENT	37		/* Size of one RELR relative relocaction */
+#define	DT_NUM		38		/* Number used */
 #define DT_LOOS		0x6000000d	/* Start of OS-specific */
 #define DT_HIOS		0x6ffff000	/* End of OS-specific */
 #define DT_LOPROC	0x70000000	/* Start of processor-specific */
@@ -3994,7 +3999,22 @@ u8 * get_elf_symbol_binding(u8 binding);
 /* Get string representation of the ELF symbol visibility */
 u8 * get_elf_symbol_visibility(u8 vis);
 
+/* Get the table of relocation types' names of the ELF machine */
+u8 ** get_elf_reloc_table(u16 machine, u32 * tableSize);
+
+/* Get the relative relocation type of the ELF machine (the type implied by SHT_RELR entries) */
+u32 get_elf_relative_reloc_type(u16 machine);
+
+/* Get the relocation type of the ELF machine that fills a PLT's GOT slot */
+u32 get_elf_jump_slot_reloc_type(u16 machine);
+
+/* Get the relocation type of the ELF machine that fills a GOT slot with a symbol's address */
+u32 get_elf_glob_dat_reloc_type(u16 machine);
+
+/* Get the relocation type of the ELF machine that fills a GOT slot with the result of an ifunc resolver */
+u32 get_elf_irelative_reloc_type(u16 machine);
+
 /* Get string representation of the ELF relocation type */
-u8 * get_elf_reloc_type(u32 type);
+u8 * get_elf_reloc_type(u8 ** relocTable, u32 tableSize, u32 type);
 
 #endif	/* elf.h */
@@ -0,0 +1,339 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./kvelf.h"
+#include "./entropy.h"
+
+
+/* Number of histogram banks, consecutive bytes go to different banks */
+#define ENTROPY_NUM_OF_BANKS 4
+
+/* Width of the bar of a window at 8 bits per byte */
+#define ENTROPY_BAR_WIDTH 40
+
+
+
+/* Base 2 logarithm of a positive number, libm is not linked:
+log2(m*2^e) = e + ln(m)/ln(2) with m in [sqrt(2)/2,sqrt(2)), ln(m) = 2*atanh((m-1)/(m+1)) */
+static double log2_positive(double x){
+
+    union{
+        double d;
+        u64 u;
+    }bits = {x};
+
+    s64 exponent = (s64)((bits.u>>52) & 0x7ff) - 1023;
+    bits.u = (bits.u & ((1ULL<<52)-1)) | (1023ULL<<52);
+
+    double m = bits.d;
+    if(m>1.4142135623730951){
+        m /= 2;
+        exponent++;
+    }
+
+    double t = (m-1)/(m+1);
+    double t2 = t*t;
+    double ln = 2*t*(1 + t2*(1.0/3 + t2*(1.0/5 + t2*(1.0/7 + t2*(1.0/9 + t2*(1.0/11 + t2/13))))));
+
+    return exponent + ln*1.4426950408889634;
+}
+
+
+
+/* Count the occurrences of every byte value of the data */
+void byte_histogram(const u8 * data, u64 size, u64 histogram[256]){
+
+    // Incrementing one counter for runs of the same byte makes every increment wait for the
+    // previous store, the banks spread the increments of consecutive bytes over 4 counters
+    u32 banks[ENTROPY_NUM_OF_BANKS][256];
+
+    memset(histogram,0,256*sizeof(u64));
+
+    while(size){
+        u64 blockSize = size<ENTROPY_BANK_FLUSH_SIZE ? size : ENTROPY_BANK_FLUSH_SIZE;
+        u64 i=0;
+
+        memset(banks,0,sizeof(banks));
+
+        // Two words per step, their bytes are taken by shifting instead of 16 loads
+        for(;i+16<=blockSize;i+=16){
+            u64 low;
+            u64 high;
+            memcpy(&low,data+i,8);
+            memcpy(&high,data+i+8,8);
+
+            banks[0][(u8)low]++;
+            banks[1][(u8)(low>>8)]++;
+            banks[2][(u8)(low>>16)]++;
+            banks[3][(u8)(low>>24)]++;
+            banks[0][(u8)(low>>32)]++;
+            banks[1][(u8)(low>>40)]++;
+            banks[2][(u8)(low>>48)]++;
+            banks[3][(u8)(low>>56)]++;
+            banks[0][(u8)high]++;
+            banks[1][(u8)(high>>8)]++;
+            banks[2][(u8)(high>>16)]++;
+            banks[3][(u8)(high>>24)]++;
+            banks[0][(u8)(high>>32)]++;
+            banks[1][(u8)(high>>40)]++;
+            banks[2][(u8)(high>>48)]++;
+            banks[3][(u8)(high>>56)]++;
+        }
+        for(;i<blockSize;i++)
+            banks[i%ENTROPY_NUM_OF_BANKS][data[i]]++;
+
+        for(u32 value=0;value<256;value++)
+            histogram[value] += (u64)banks[0][value]+banks[1][value]+banks[2][value]+banks[3][value];
+
+        data += blockSize;
+        size -= blockSize;
+    }
+}
+
+
+/* Shannon entropy in bits per byte of a histogram of size bytes, 0 for no bytes */
+double histogram_entropy(const u64 histogram[256], u64 size){
+
+    if(!size)
+        return 0;
+
+    // H = log2(N) - sum(c*log2(c))/N
+    double sum = 0;
+    for(u32 value=0;value<256;value++)
+        if(histogram[value]>1)
+            sum += histogram[value]*log2_positive(histogram[value]);
+
+    double entropy = log2_positive(size) - sum/size;
+    return entropy<0 ? 0 : entropy;
+}
+
+
+
+/* Number of byte values present and the most frequent one */
+static u32 histogram_summary(const u64 histogram[256], u8 * topValue){
+
+    u32 distinct=0;
+    *topValue=0;
+
+    for(u32 value=0;value<256;value++){
+        if(histogram[value])
+            distinct++;
+        if(histogram[value]>histogram[*topValue])
+            *topValue=value;
+    }
+    return distinct;
+}
+
+
+/* Print one row of the report, in red if the region looks packed or encrypted */
+static void print_entropy_row(u8 * row, double entropy){
+
+    if(entropy>=ENTROPY_HIGH_THRESHOLD)
+        display(row,DISPLAY_COLOR_RED);
+    else
+        fprintf(display_output(),"%s",row);
+}
+
+
+/* Entropy of every section and segment with contents in the file, and of the whole file */
+static void print_entropy_table(kvelf_basic_params_t * kvelfp){
+
+    u64 histogram[256];
+    u8 rowBuffer[160];
+    u8 topValue;
+
+    sprintf(rowBuffer,"%-6s%-24s%-20s%-14s%-10s%-10s%s\n","Idx","Section","Offset","Size","Entropy","Distinct","Top");
+    display(rowBuffer,DISPLAY_COLOR_ORANGE);
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        u64 contentsSize;
+        u8 * contents = get_section_contents(kvelfp,i,&contentsSize);
+        if(!contents || !contentsSize)
+            continue;
+
+        byte_histogram(contents,contentsSize,histogram);
+        double entropy = histogram_entropy(histogram,contentsSize);
+        u32 distinct = histogram_summary(histogram,&topValue);
+
+        sprintf(rowBuffer,"%-6u%-24.23s0x%016llx  %-14llu%-10.3f%-10u0x%02x\n",i,get_section_name(kvelfp,i),kvelfp->elfSectionsMetadata[i].sOffset,contentsSize,entropy,distinct,topValue);
+        print_entropy_row(rowBuffer,entropy);
+    }
+
+    fprintf(display_output(),"\n");
+    sprintf(rowBuffer,"%-6s%-24s%-20s%-14s%-10s%-10s%s\n","Idx","Segment","Offset","Size","Entropy","Distinct","Top");
+    display(rowBuffer,DISPLAY_COLOR_ORANGE);
+
+    for(u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+        u64 contentsSize;
+        u8 * contents = get_segment_contents(kvelfp,i,&contentsSize);
+        if(!contents || !contentsSize)
+            continue;
+
+        byte_histogram(contents,contentsSize,histogram);
+        double entropy = histogram_entropy(histogram,contentsSize);
+        u32 distinct = histogram_summary(histogram,&topValue);
+
+        sprintf(rowBuffer,"%-6u%-24s0x%016llx  %-14llu%-10.3f%-10u0x%02x\n",i,get_elf_segment_type(kvelfp->elfSegmentsMetadata[i].pType),kvelfp->elfSegmentsMetadata[i].pOffset,contentsSize,entropy,distinct,topValue);
+        print_entropy_row(rowBuffer,entropy);
+    }
+
+    byte_histogram(kvelfp->elfImage,kvelfp->elfImageSize,histogram);
+    fprintf(display_output(),"\nWhole file: %llu bytes, %.3f bits/byte\n",kvelfp->elfImageSize,histogram_entropy(histogram,kvelfp->elfImageSize));
+}
+
+
+/* Entropy and the 16x16 histogram of one section */
+static void print_section_histogram(u8 * sectionName, u8 * contents, u64 contentsSize){
+
+    u64 histogram[256];
+    u8 rowBuffer[32];
+    u8 topValue;
+
+    byte_histogram(contents,contentsSize,histogram);
+    u32 distinct = histogram_summary(histogram,&topValue);
+
+    fprintf(display_output(),"%s: %llu bytes, %.3f bits/byte, %u distinct bytes, most frequent 0x%02x (%llu)\n\n",sectionName,contentsSize,histogram_entropy(histogram,contentsSize),distinct,topValue,histogram[topValue]);
+
+    display("      ",DISPLAY_COLOR_ORANGE);
+    for(u32 column=0;column<16;column++){
+        sprintf(rowBuffer,"%8x",column);
+        display(rowBuffer,DISPLAY_COLOR_ORANGE);
+    }
+    fprintf(display_output(),"\n");
+
+    for(u32 row=0;row<16;row++){
+        sprintf(rowBuffer,"0x%02x  ",row*16);
+        display(rowBuffer,DISPLAY_COLOR_ORANGE);
+        for(u32 column=0;column<16;column++)
+            fprintf(display_output(),"%8llu",histogram[row*16+column]);
+        fprintf(display_output(),"\n");
+    }
+}
+
+
+/* Entropy of the windows of a section, the window's histogram is updated as it slides */
+static void print_section_windows(u8 * contents, u64 contentsSize, u64 sectionOffset, u64 windowSize, u64 stepSize){
+
+    u64 histogram[256];
+    u8 rowBuffer[ENTROPY_BAR_WIDTH+64];
+    u64 numOfWindows=0;
+    u64 numOfHighWindows=0;
+
+    sprintf(rowBuffer,"%-20s%-10s%s\n","Offset","Entropy","");
+    display(rowBuffer,DISPLAY_COLOR_ORANGE);
+
+    byte_histogram(contents,windowSize,histogram);
+
+    for(u64 start=0;;){
+        double entropy = histogram_entropy(histogram,windowSize);
+
+        u32 barLength = entropy*ENTROPY_BAR_WIDTH/8;
+        u32 length = sprintf(rowBuffer,"0x%016llx  %-10.3f",sectionOffset+start,entropy);
+        memset(rowBuffer+length,'#',barLength);
+        strcpy(rowBuffer+length+barLength,"\n");
+        print_entropy_row(rowBuffer,entropy);
+
+        numOfWindows++;
+        if(entropy>=ENTROPY_HIGH_THRESHOLD)
+            numOfHighWindows++;
+
+        if(contentsSize-start-windowSize<stepSize)
+            break;
+
+        // Only the bytes leaving and entering the window are counted again
+        if(stepSize<windowSize){
+            for(u64 i=start;i<start+stepSize;i++)
+                histogram[contents[i]]--;
+            for(u64 i=start+windowSize;i<start+windowSize+stepSize;i++)
+                histogram[contents[i]]++;
+        }else
+            byte_histogram(contents+start+stepSize,windowSize,histogram);
+
+        start += stepSize;
+    }
+
+    fprintf(display_output(),"\n%llu windows of %llu bytes, %llu at or above %.1f bits/byte\n",numOfWindows,windowSize,numOfHighWindows,ENTROPY_HIGH_THRESHOLD);
+}
+
+
+
+/* Print the entropy of the sections and the segments, the histogram of one section,
+or the entropy of the windows of one section with "SECTION --window N [--step M]" */
+void entropy_report(kvelf_basic_params_t * kvelfp, u8 * query){
+
+    if(!kvelfp->elfImage){
+        debug("entropy needs the file mapped in memory\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    u8 * sectionName = NULL;
+    u64 windowSize = 0;
+    u64 stepSize = 0;
+
+    u8 * savePtr;
+    for(u8 * token=strtok_r(query," \t\n",(char **)&savePtr);token;token=strtok_r(NULL," \t\n",(char **)&savePtr)){
+
+        if(strcmp(token,"--window")==0 || strcmp(token,"--step")==0){
+            u8 * sizeStr = strtok_r(NULL," \t\n",(char **)&savePtr);
+            u8 * sizeEnd;
+            u64 size = sizeStr ? strtoull(sizeStr,(char **)&sizeEnd,0) : 0;
+            if(!size || *sizeEnd){
+                debug("Usage: entropy [SECTION [--window N [--step M]]], N and M > 0\n",DEBUG_STATUS_ERROR);
+                return;
+            }
+            if(token[2]=='w')
+                windowSize=size;
+            else
+                stepSize=size;
+            continue;
+        }
+
+        if(sectionName){
+            debug("Usage: entropy [SECTION [--window N [--step M]]]\n",DEBUG_STATUS_ERROR);
+            return;
+        }
+        sectionName=token;
+    }
+
+    if(!sectionName){
+        if(windowSize || stepSize){
+            debug("Usage: entropy [SECTION [--window N [--step M]]]\n",DEBUG_STATUS_ERROR);
+            return;
+        }
+        print_entropy_table(kvelfp);
+        return;
+    }
+
+    s64 sectionIdx = find_section_by_name(kvelfp,sectionName);
+    if(sectionIdx<0){
+        display_error("No section \"%s\"\n",sectionName);
+        return;
+    }
+
+    u64 contentsSize;
+    u8 * contents = get_section_contents(kvelfp,sectionIdx,&contentsSize);
+    if(!contents || !contentsSize){
+        display_error("Section \"%s\" has no contents in the file\n",sectionName);
+        return;
+    }
+
+    if(!windowSize){
+        if(stepSize){
+            debug("Usage: entropy SECTION --window N [--step M]\n",DEBUG_STATUS_ERROR);
+            return;
+        }
+        print_section_histogram(sectionName,contents,contentsSize);
+        return;
+    }
+
+    // The windows overlap by half unless a step is given
+    if(windowSize>contentsSize)
+        windowSize=contentsSize;
+    if(!stepSize)
+        stepSize = windowSize>1 ? windowSize/2 : 1;
+
+    print_section_windows(contents,contentsSize,contents-kvelfp->elfImage,windowSize,stepSize);
+}
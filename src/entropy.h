@@ -0,0 +1,28 @@
+#ifndef ENTROPY_H
+#define ENTROPY_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Entropy (bits per byte) from which a region is reported as packed or encrypted */
+#define ENTROPY_HIGH_THRESHOLD 7.2
+
+/* Bytes counted by the banks of a histogram before they are added to the totals */
+#define ENTROPY_BANK_FLUSH_SIZE (1ULL<<30)
+
+
+
+/* Count the occurrences of every byte value of the data */
+void byte_histogram(const u8 * data, u64 size, u64 histogram[256]);
+
+/* Shannon entropy in bits per byte of a histogram of size bytes, 0 for no bytes */
+double histogram_entropy(const u64 histogram[256], u64 size);
+
+/* Print the entropy of the sections and the segments, the histogram of one section,
+or the entropy of the windows of one section with "SECTION --window N [--step M]" */
+void entropy_report(kvelf_basic_params_t * kvelfp, u8 * query);
+
+
+#endif
@@ -0,0 +1,439 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./kvelf.h"
+#include "./pool.h"
+#include "./hash.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#include <cpuid.h>
+#define KVELF_HASH_SHA_NI 1
+#endif
+
+
+
+/* Contents hashed by one task */
+typedef struct hash_job{
+    u8 * name;          /* Section's name or segment's type */
+    u32 idx;            /* Index of the section or the segment */
+    u64 offset;         /* File offset of the contents */
+    u8 * contents;      /* Contents in the mapped file, NULL if there are none */
+    u64 size;
+    u8 digest[HASH_MAX_DIGEST_SIZE];
+}hash_job_t;
+
+
+/* Context of the parallel loop */
+typedef struct hash_jobs{
+    u8 algo;
+    hash_job_t ** order; /* Jobs from the largest to the smallest, the long ones start first */
+}hash_jobs_t;
+
+
+
+/* Read little-endian words whatever the host's byte order */
+static inline u64 read_le64(const u8 * data){
+    u64 value;
+    memcpy(&value,data,8);
+#if __BYTE_ORDER__==__ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+static inline u32 read_le32(const u8 * data){
+    u32 value;
+    memcpy(&value,data,4);
+#if __BYTE_ORDER__==__ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+static inline u64 rotl64(u64 value, u32 bits){
+    return value<<bits | value>>(64-bits);
+}
+
+static inline u32 rotr32(u32 value, u32 bits){
+    return value>>bits | value<<(32-bits);
+}
+
+
+
+#define XXH64_PRIME1 0x9e3779b185ebca87ULL
+#define XXH64_PRIME2 0xc2b2ae3d27d4eb4fULL
+#define XXH64_PRIME3 0x165667b19e3779f9ULL
+#define XXH64_PRIME4 0x85ebca77c2b2ae63ULL
+#define XXH64_PRIME5 0x27d4eb2f165667c5ULL
+
+static inline u64 xxh64_round(u64 acc, u64 input){
+    acc += input*XXH64_PRIME2;
+    acc = rotl64(acc,31);
+    return acc*XXH64_PRIME1;
+}
+
+static inline u64 xxh64_merge_round(u64 acc, u64 value){
+    acc ^= xxh64_round(0,value);
+    return acc*XXH64_PRIME1 + XXH64_PRIME4;
+}
+
+
+/* XXH64 of the data with the given seed */
+u64 xxh64(const u8 * data, u64 size, u64 seed){
+
+    const u8 * end = data+size;
+    u64 hash;
+
+    // Four lanes over 32-byte stripes
+    if(size>=32){
+        u64 v1 = seed+XXH64_PRIME1+XXH64_PRIME2;
+        u64 v2 = seed+XXH64_PRIME2;
+        u64 v3 = seed;
+        u64 v4 = seed-XXH64_PRIME1;
+
+        for(;end-data>=32;data+=32){
+            v1 = xxh64_round(v1,read_le64(data));
+            v2 = xxh64_round(v2,read_le64(data+8));
+            v3 = xxh64_round(v3,read_le64(data+16));
+            v4 = xxh64_round(v4,read_le64(data+24));
+        }
+
+        hash = rotl64(v1,1) + rotl64(v2,7) + rotl64(v3,12) + rotl64(v4,18);
+        hash = xxh64_merge_round(hash,v1);
+        hash = xxh64_merge_round(hash,v2);
+        hash = xxh64_merge_round(hash,v3);
+        hash = xxh64_merge_round(hash,v4);
+    }else
+        hash = seed+XXH64_PRIME5;
+
+    hash += size;
+
+    for(;end-data>=8;data+=8){
+        hash ^= xxh64_round(0,read_le64(data));
+        hash = rotl64(hash,27)*XXH64_PRIME1 + XXH64_PRIME4;
+    }
+    if(end-data>=4){
+        hash ^= read_le32(data)*XXH64_PRIME1;
+        hash = rotl64(hash,23)*XXH64_PRIME2 + XXH64_PRIME3;
+        data += 4;
+    }
+    for(;data<end;data++){
+        hash ^= *data*XXH64_PRIME5;
+        hash = rotl64(hash,11)*XXH64_PRIME1;
+    }
+
+    hash ^= hash>>33;
+    hash *= XXH64_PRIME2;
+    hash ^= hash>>29;
+    hash *= XXH64_PRIME3;
+    hash ^= hash>>32;
+    return hash;
+}
+
+
+
+static const u32 sha256RoundConstants[64] = {
+    0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+    0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+    0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+    0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+    0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+    0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+    0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+    0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2,
+};
+
+
+/* Process whole 64-byte blocks */
+typedef void (*sha256_blocks_fn)(u32 state[8], const u8 * data, u64 numOfBlocks);
+
+
+static void sha256_blocks_scalar(u32 state[8], const u8 * data, u64 numOfBlocks){
+
+    for(;numOfBlocks;numOfBlocks--,data+=64){
+        u32 w[64];
+
+        for(u32 i=0;i<16;i++)
+            w[i] = (u32)data[i*4]<<24 | (u32)data[i*4+1]<<16 | (u32)data[i*4+2]<<8 | data[i*4+3];
+        for(u32 i=16;i<64;i++){
+            u32 s0 = rotr32(w[i-15],7) ^ rotr32(w[i-15],18) ^ w[i-15]>>3;
+            u32 s1 = rotr32(w[i-2],17) ^ rotr32(w[i-2],19) ^ w[i-2]>>10;
+            w[i] = w[i-16] + s0 + w[i-7] + s1;
+        }
+
+        u32 a=state[0], b=state[1], c=state[2], d=state[3];
+        u32 e=state[4], f=state[5], g=state[6], h=state[7];
+
+        for(u32 i=0;i<64;i++){
+            u32 t1 = h + (rotr32(e,6) ^ rotr32(e,11) ^ rotr32(e,25)) + ((e&f) ^ (~e&g)) + sha256RoundConstants[i] + w[i];
+            u32 t2 = (rotr32(a,2) ^ rotr32(a,13) ^ rotr32(a,22)) + ((a&b) ^ (a&c) ^ (b&c));
+            h=g; g=f; f=e; e=d+t1;
+            d=c; c=b; b=a; a=t1+t2;
+        }
+
+        state[0]+=a; state[1]+=b; state[2]+=c; state[3]+=d;
+        state[4]+=e; state[5]+=f; state[6]+=g; state[7]+=h;
+    }
+}
+
+
+
+#ifdef KVELF_HASH_SHA_NI
+
+/*
+ * The SHA extensions run two rounds per sha256rnds2 on the state split in ABEF and CDGH.
+ * Every group of four rounds adds the round constants to four message words, the message
+ * schedule of the following groups is computed by sha256msg1/sha256msg2 on the way.
+ */
+
+__attribute__((target("sha,sse4.1")))
+static void sha256_blocks_sha_ni(u32 state[8], const u8 * data, u64 numOfBlocks){
+
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,0x0405060700010203ULL);
+
+    __m128i dcba = _mm_loadu_si128((const __m128i *)state);
+    __m128i hgfe = _mm_loadu_si128((const __m128i *)(state+4));
+    __m128i cdab = _mm_shuffle_epi32(dcba,0xb1);
+    __m128i efgh = _mm_shuffle_epi32(hgfe,0x1b);
+    __m128i abef = _mm_alignr_epi8(cdab,efgh,8);
+    __m128i cdgh = _mm_blend_epi16(efgh,cdab,0xf0);
+
+    for(;numOfBlocks;numOfBlocks--,data+=64){
+        __m128i savedAbef = abef;
+        __m128i savedCdgh = cdgh;
+        __m128i message[4];
+
+        #pragma GCC unroll 16
+        for(u32 group=0;group<16;group++){
+            if(group<4)
+                message[group] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data+group*16)),byteSwap);
+
+            __m128i words = _mm_add_epi32(message[group%4],_mm_loadu_si128((const __m128i *)(sha256RoundConstants+group*4)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh,abef,words);
+
+            // Words 16 to 63, four groups ahead
+            if(group>=3 && group<15){
+                __m128i next = _mm_add_epi32(message[(group+1)%4],_mm_alignr_epi8(message[group%4],message[(group+3)%4],4));
+                message[(group+1)%4] = _mm_sha256msg2_epu32(next,message[group%4]);
+            }
+
+            abef = _mm_sha256rnds2_epu32(abef,cdgh,_mm_shuffle_epi32(words,0x0e));
+
+            if(group>=1 && group<13)
+                message[(group+3)%4] = _mm_sha256msg1_epu32(message[(group+3)%4],message[group%4]);
+        }
+
+        abef = _mm_add_epi32(abef,savedAbef);
+        cdgh = _mm_add_epi32(cdgh,savedCdgh);
+    }
+
+    __m128i feba = _mm_shuffle_epi32(abef,0x1b);
+    __m128i dchg = _mm_shuffle_epi32(cdgh,0xb1);
+    _mm_storeu_si128((__m128i *)state,_mm_blend_epi16(feba,dchg,0xf0));
+    _mm_storeu_si128((__m128i *)(state+4),_mm_alignr_epi8(dchg,feba,8));
+}
+
+
+/* __builtin_cpu_supports does not know the SHA extensions on every compiler */
+static u8 cpu_has_sha_ni(void){
+
+    u32 eax, ebx, ecx, edx;
+
+    if(!__get_cpuid(1,&eax,&ebx,&ecx,&edx) || !(ecx & bit_SSE4_1))
+        return 0;
+    if(!__get_cpuid_count(7,0,&eax,&ebx,&ecx,&edx))
+        return 0;
+    return (ebx>>29) & 1;
+}
+
+#endif
+
+
+
+/* SHA-256 of the data */
+void sha256(const u8 * data, u64 size, u8 digest[32]){
+
+    u32 state[8] = {
+        0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19,
+    };
+    sha256_blocks_fn sha256_blocks = sha256_blocks_scalar;
+
+#ifdef KVELF_HASH_SHA_NI
+    if(cpu_has_sha_ni())
+        sha256_blocks = sha256_blocks_sha_ni;
+#endif
+
+    u64 numOfBlocks = size/64;
+    sha256_blocks(state,data,numOfBlocks);
+
+    // The remaining bytes, the 0x80 byte and the size in bits fill one or two more blocks
+    u8 lastBlocks[128];
+    u64 remaining = size-numOfBlocks*64;
+    u64 lastSize = remaining<56 ? 64 : 128;
+
+    memset(lastBlocks,0,sizeof(lastBlocks));
+    if(remaining)
+        memcpy(lastBlocks,data+numOfBlocks*64,remaining);
+    lastBlocks[remaining] = 0x80;
+    for(u32 i=0;i<8;i++)
+        lastBlocks[lastSize-1-i] = (size*8)>>(i*8);
+    sha256_blocks(state,lastBlocks,lastSize/64);
+
+    for(u32 i=0;i<8;i++){
+        digest[i*4] = state[i]>>24;
+        digest[i*4+1] = state[i]>>16;
+        digest[i*4+2] = state[i]>>8;
+        digest[i*4+3] = state[i];
+    }
+}
+
+
+
+static void hash_task(void * context, u64 taskIdx){
+
+    hash_jobs_t * jobs = context;
+    hash_job_t * job = jobs->order[taskIdx];
+
+    if(jobs->algo==HASH_ALGO_SHA256)
+        sha256(job->contents,job->size,job->digest);
+    else{
+        u64 hash = xxh64(job->contents,job->size,0);
+        for(u32 i=0;i<8;i++)
+            job->digest[i] = hash>>(56-i*8);
+    }
+}
+
+
+static int compare_jobs_by_size(const void * a, const void * b){
+
+    const hash_job_t * jobA = *(const hash_job_t **)a;
+    const hash_job_t * jobB = *(const hash_job_t **)b;
+
+    if(jobA->size!=jobB->size)
+        return jobA->size>jobB->size ? -1 : 1;
+    return 0;
+}
+
+
+/* Print the hashes of the jobs with contents, in the order of the file's tables */
+static void print_hashes(hash_job_t * jobs, u64 numOfJobs, u8 * kind, u32 digestSize){
+
+    u8 rowBuffer[120];
+
+    sprintf(rowBuffer,"%-6s%-24s%-20s%-14s%s\n","Idx",kind,"Offset","Size","Hash");
+    display(rowBuffer,DISPLAY_COLOR_ORANGE);
+
+    for(u64 i=0;i<numOfJobs;i++){
+        hash_job_t * job = &jobs[i];
+        if(!job->contents)
+            continue;
+
+        fprintf(display_output(),"%-6u%-24.23s0x%016llx  %-14llu",job->idx,job->name,job->offset,job->size);
+        for(u32 j=0;j<digestSize;j++)
+            fprintf(display_output(),"%02x",job->digest[j]);
+        fprintf(display_output(),"\n");
+    }
+}
+
+
+
+/* Hash the file contents of every section, and of every PT_LOAD segment with "--segments",
+on the threads of the file's pool. "--algo xxh64|sha256" picks the hash, xxh64 by default */
+void hash_contents(kvelf_basic_params_t * kvelfp, u8 * query){
+
+    if(!kvelfp->elfImage){
+        debug("hash needs the file mapped in memory\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    u8 algo = HASH_ALGO_XXH64;
+    u8 withSegments = 0;
+
+    u8 * savePtr;
+    for(u8 * token=strtok_r(query," \t\n",(char **)&savePtr);token;token=strtok_r(NULL," \t\n",(char **)&savePtr)){
+
+        if(strcmp(token,"--segments")==0){
+            withSegments=1;
+            continue;
+        }
+
+        if(strcmp(token,"--algo")==0){
+            u8 * algoName = strtok_r(NULL," \t\n",(char **)&savePtr);
+            if(algoName && strcmp(algoName,"xxh64")==0)
+                algo = HASH_ALGO_XXH64;
+            else if(algoName && strcmp(algoName,"sha256")==0)
+                algo = HASH_ALGO_SHA256;
+            else{
+                debug("Usage: hash [--algo xxh64|sha256] [--segments]\n",DEBUG_STATUS_ERROR);
+                return;
+            }
+            continue;
+        }
+
+        debug("Usage: hash [--algo xxh64|sha256] [--segments]\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    u64 numOfJobs = kvelfp->elfNumOfSections + (withSegments ? kvelfp->elfNumOfSegments : 0);
+    hash_job_t * allJobs = calloc(numOfJobs+1,sizeof(hash_job_t));
+    hash_job_t ** order = calloc(numOfJobs+1,sizeof(hash_job_t *));
+    if(!allJobs || !order){
+        debug("Cannot allocate the hash jobs\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    hash_job_t * sectionJobs = allJobs;
+    hash_job_t * segmentJobs = allJobs+kvelfp->elfNumOfSections;
+    u64 numOfTasks=0;
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        hash_job_t * job = &sectionJobs[i];
+        job->idx = i;
+        job->name = get_section_name(kvelfp,i);
+        if(kvelfp->elfSectionsMetadata[i].sType==SHT_NULL)
+            continue;
+        job->contents = get_section_contents(kvelfp,i,&job->size);
+        if(job->contents){
+            job->offset = job->contents-kvelfp->elfImage;
+            order[numOfTasks++] = job;
+        }
+    }
+
+    if(withSegments){
+        for(u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+            hash_job_t * job = &segmentJobs[i];
+            job->idx = i;
+            job->name = get_elf_segment_type(kvelfp->elfSegmentsMetadata[i].pType);
+            if(kvelfp->elfSegmentsMetadata[i].pType!=PT_LOAD)
+                continue;
+            job->contents = get_segment_contents(kvelfp,i,&job->size);
+            if(job->contents){
+                job->offset = job->contents-kvelfp->elfImage;
+                order[numOfTasks++] = job;
+            }
+        }
+    }
+
+    // The largest contents are hashed first so that no thread is left with a big one at the end
+    qsort(order,numOfTasks,sizeof(hash_job_t *),compare_jobs_by_size);
+
+    if(!kvelfp->threadPool)
+        kvelfp->threadPool = pool_create(0);
+
+    hash_jobs_t jobs = {algo,order};
+    pool_parallel_for(kvelfp->threadPool,numOfTasks,hash_task,&jobs);
+
+    u32 digestSize = algo==HASH_ALGO_SHA256 ? 32 : 8;
+    print_hashes(sectionJobs,kvelfp->elfNumOfSections,"Section",digestSize);
+    if(withSegments){
+        fprintf(display_output(),"\n");
+        print_hashes(segmentJobs,kvelfp->elfNumOfSegments,"Segment",digestSize);
+    }
+
+    free(order);
+    free(allJobs);
+}
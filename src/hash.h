@@ -0,0 +1,28 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+#define HASH_ALGO_XXH64 0
+#define HASH_ALGO_SHA256 1
+
+/* Size of the largest digest */
+#define HASH_MAX_DIGEST_SIZE 32
+
+
+
+/* XXH64 of the data with the given seed */
+u64 xxh64(const u8 * data, u64 size, u64 seed);
+
+/* SHA-256 of the data */
+void sha256(const u8 * data, u64 size, u8 digest[32]);
+
+/* Hash the file contents of every section, and of every PT_LOAD segment with "--segments",
+on the threads of the file's pool. "--algo xxh64|sha256" picks the hash, xxh64 by default */
+void hash_contents(kvelf_basic_params_t * kvelfp, u8 * query);
+
+
+#endif
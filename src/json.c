@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <string.h>
+#include "./types.h"
+#include "./json.h"
+
+
+
+/* Escapes of the bytes which cannot appear as they are in a string, 'u' for the \u00XX ones */
+static const u8 jsonEscapes[256] = {
+    ['\b']='b', ['\t']='t', ['\n']='n', ['\f']='f', ['\r']='r', ['"']='"', ['\\']='\\',
+    [0x00]='u', [0x01]='u', [0x02]='u', [0x03]='u', [0x04]='u', [0x05]='u', [0x06]='u', [0x07]='u',
+    [0x0b]='u', [0x0e]='u', [0x0f]='u', [0x10]='u', [0x11]='u', [0x12]='u', [0x13]='u', [0x14]='u',
+    [0x15]='u', [0x16]='u', [0x17]='u', [0x18]='u', [0x19]='u', [0x1a]='u', [0x1b]='u', [0x1c]='u',
+    [0x1d]='u', [0x1e]='u', [0x1f]='u',
+};
+
+static const u8 hexDigits[16] = "0123456789abcdef";
+
+/* Pairs of decimal digits, so numbers are converted two digits at a time */
+static const u8 decimalPairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+/* Make room for count bytes in the buffer, count must not exceed its size */
+static inline void json_reserve(json_writer_t * writer, u32 count){
+
+    if(writer->used+count>JSON_BUFFER_SIZE)
+        json_flush(writer);
+}
+
+
+static inline void json_put(json_writer_t * writer, u8 byte){
+
+    json_reserve(writer,1);
+    writer->buffer[writer->used++] = byte;
+}
+
+
+/* Separate a value from the previous one of its container */
+static inline void json_begin_value(json_writer_t * writer){
+
+    if(writer->afterKey){
+        writer->afterKey = 0;
+        return;
+    }
+
+    // Records of the top level are separated by json_end_record()
+    if(writer->depth && writer->hasValues[writer->depth])
+        json_put(writer,',');
+    writer->hasValues[writer->depth] = 1;
+}
+
+
+static void json_open(json_writer_t * writer, u8 bracket){
+
+    json_begin_value(writer);
+    json_put(writer,bracket);
+
+    if(writer->depth+1<JSON_MAX_DEPTH)
+        writer->depth++;
+    writer->hasValues[writer->depth] = 0;
+}
+
+
+static void json_close(json_writer_t * writer, u8 bracket){
+
+    json_put(writer,bracket);
+    if(writer->depth)
+        writer->depth--;
+}
+
+
+
+/* Start writing JSON to a stream */
+void json_writer_init(json_writer_t * writer, FILE * out){
+
+    writer->out = out;
+    writer->used = 0;
+    writer->depth = 0;
+    writer->afterKey = 0;
+    writer->hasValues[0] = 0;
+}
+
+
+/* Write out the formatted bytes */
+void json_flush(json_writer_t * writer){
+
+    if(writer->used)
+        fwrite(writer->buffer,1,writer->used,writer->out);
+    writer->used = 0;
+}
+
+
+/* Open and close objects and arrays */
+void json_begin_object(json_writer_t * writer){
+    json_open(writer,'{');
+}
+
+void json_end_object(json_writer_t * writer){
+    json_close(writer,'}');
+}
+
+void json_begin_array(json_writer_t * writer){
+    json_open(writer,'[');
+}
+
+void json_end_array(json_writer_t * writer){
+    json_close(writer,']');
+}
+
+
+/* Length of the UTF-8 sequence starting with a byte of 0x80 or above, 0 if it is not valid */
+static u8 utf8_sequence_length(const u8 * bytes){
+
+    u8 length;
+    u32 codePoint;
+    if(bytes[0]>=0xc2 && bytes[0]<=0xdf){
+        length = 2;
+        codePoint = bytes[0] & 0x1f;
+    }else if((bytes[0] & 0xf0)==0xe0){
+        length = 3;
+        codePoint = bytes[0] & 0x0f;
+    }else if(bytes[0]>=0xf0 && bytes[0]<=0xf4){
+        length = 4;
+        codePoint = bytes[0] & 0x07;
+    }else
+        return 0;
+
+    // The terminator is not a continuation byte, so a truncated sequence stops here
+    for(u8 i=1;i<length;i++){
+        if((bytes[i] & 0xc0)!=0x80)
+            return 0;
+        codePoint = codePoint<<6 | (bytes[i] & 0x3f);
+    }
+
+    // Overlong forms, surrogates and code points past U+10FFFF are not valid either
+    if(length==3 && (codePoint<0x800 || (codePoint>=0xd800 && codePoint<=0xdfff)))
+        return 0;
+    if(length==4 && (codePoint<0x10000 || codePoint>0x10ffff))
+        return 0;
+    return length;
+}
+
+
+/* Copy a string between quotes, the runs of bytes needing no escape are copied at once. The
+bytes which are not valid UTF-8 are written as \u00XX, so that the output stays valid JSON */
+static void json_quote(json_writer_t * writer, const u8 * value){
+
+    json_put(writer,'"');
+
+    while(*value){
+        const u8 * run = value;
+        while(*value && !jsonEscapes[*value]){
+            if(*value<0x80)
+                value++;
+            else{
+                u8 length = utf8_sequence_length(value);
+                if(!length)
+                    break;
+                value += length;
+            }
+        }
+
+        // Long runs are split at the buffer's size
+        for(u64 runLength=value-run;runLength;){
+            u32 chunk = runLength<JSON_BUFFER_SIZE ? runLength : JSON_BUFFER_SIZE;
+            json_reserve(writer,chunk);
+            memcpy(writer->buffer+writer->used,run,chunk);
+            writer->used += chunk;
+            run += chunk;
+            runLength -= chunk;
+        }
+
+        if(*value){
+            u8 escape = jsonEscapes[*value] ? jsonEscapes[*value] : 'u';
+            json_reserve(writer,6);
+            writer->buffer[writer->used++] = '\\';
+            writer->buffer[writer->used++] = escape;
+            if(escape=='u'){
+                writer->buffer[writer->used++] = '0';
+                writer->buffer[writer->used++] = '0';
+                writer->buffer[writer->used++] = hexDigits[*value>>4];
+                writer->buffer[writer->used++] = hexDigits[*value & 0xf];
+            }
+            value++;
+        }
+    }
+
+    json_put(writer,'"');
+}
+
+
+/* Name the next value of the open object */
+void json_key(json_writer_t * writer, const u8 * key){
+
+    json_begin_value(writer);
+    json_quote(writer,key);
+    json_put(writer,':');
+    writer->afterKey = 1;
+}
+
+
+/* Write a value, strings are escaped and their other bytes are copied as they are */
+void json_string(json_writer_t * writer, const u8 * value){
+
+    json_begin_value(writer);
+    json_quote(writer,value);
+}
+
+
+/* Digits of a number, written backwards from the end of a 20 bytes buffer. Returns the first digit */
+static u8 * format_decimal(u64 value, u8 * end){
+
+    while(value>=100){
+        u32 pair = (value%100)*2;
+        value /= 100;
+        *--end = decimalPairs[pair+1];
+        *--end = decimalPairs[pair];
+    }
+
+    if(value>=10){
+        *--end = decimalPairs[value*2+1];
+        *--end = decimalPairs[value*2];
+    }else
+        *--end = '0'+value;
+
+    return end;
+}
+
+
+void json_uint(json_writer_t * writer, u64 value){
+
+    json_begin_value(writer);
+
+    u8 digits[20];
+    u8 * first = format_decimal(value,digits+sizeof(digits));
+    u32 length = digits+sizeof(digits)-first;
+
+    json_reserve(writer,length);
+    memcpy(writer->buffer+writer->used,first,length);
+    writer->used += length;
+}
+
+
+void json_int(json_writer_t * writer, s64 value){
+
+    if(value>=0){
+        json_uint(writer,value);
+        return;
+    }
+
+    json_begin_value(writer);
+    json_put(writer,'-');
+
+    // The magnitude of the most negative value only fits unsigned
+    u8 digits[20];
+    u8 * first = format_decimal(-(u64)value,digits+sizeof(digits));
+    u32 length = digits+sizeof(digits)-first;
+
+    json_reserve(writer,length);
+    memcpy(writer->buffer+writer->used,first,length);
+    writer->used += length;
+}
+
+
+void json_bool(json_writer_t * writer, u8 value){
+
+    json_begin_value(writer);
+    json_reserve(writer,5);
+    memcpy(writer->buffer+writer->used,value ? "true" : "false",value ? 4 : 5);
+    writer->used += value ? 4 : 5;
+}
+
+
+/* Write a key and its value */
+void json_field_string(json_writer_t * writer, const u8 * key, const u8 * value){
+
+    json_key(writer,key);
+    json_string(writer,value);
+}
+
+void json_field_uint(json_writer_t * writer, const u8 * key, u64 value){
+
+    json_key(writer,key);
+    json_uint(writer,value);
+}
+
+void json_field_int(json_writer_t * writer, const u8 * key, s64 value){
+
+    json_key(writer,key);
+    json_int(writer,value);
+}
+
+
+/* End a top level record with a newline, the records of a listing form NDJSON */
+void json_end_record(json_writer_t * writer){
+
+    json_put(writer,'\n');
+    writer->hasValues[0] = 0;
+}
@@ -0,0 +1,65 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <stdio.h>
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Bytes formatted before they are written out */
+#define JSON_BUFFER_SIZE (64*1024)
+
+/* Deepest nesting of objects and arrays */
+#define JSON_MAX_DEPTH 32
+
+
+/* Writer formatting JSON values straight into its output buffer, no document is ever built */
+typedef struct json_writer{
+	FILE * out;			/* Where the buffer is flushed */
+	u32 used;			/* Bytes of the buffer holding output */
+	u32 depth;			/* Number of open objects and arrays */
+	u8 afterKey;		/* Whether the next value is the one of a key */
+	u8 hasValues[JSON_MAX_DEPTH];	/* Whether each open container already has a value, the top level has records */
+	u8 buffer[JSON_BUFFER_SIZE];
+}json_writer_t;
+
+
+
+/* Start writing JSON to a stream */
+void json_writer_init(json_writer_t * writer, FILE * out);
+
+/* Write out the formatted bytes */
+void json_flush(json_writer_t * writer);
+
+/* Open and close objects and arrays */
+void json_begin_object(json_writer_t * writer);
+void json_end_object(json_writer_t * writer);
+void json_begin_array(json_writer_t * writer);
+void json_end_array(json_writer_t * writer);
+
+/* Name the next value of the open object */
+void json_key(json_writer_t * writer, const u8 * key);
+
+/* Write a value, strings are escaped and their other bytes are copied as they are */
+void json_string(json_writer_t * writer, const u8 * value);
+void json_uint(json_writer_t * writer, u64 value);
+void json_int(json_writer_t * writer, s64 value);
+void json_bool(json_writer_t * writer, u8 value);
+
+/* Write a key and its value */
+void json_field_string(json_writer_t * writer, const u8 * key, const u8 * value);
+void json_field_uint(json_writer_t * writer, const u8 * key, u64 value);
+void json_field_int(json_writer_t * writer, const u8 * key, s64 value);
+
+/* End a top level record with a newline, the records of a listing form NDJSON */
+void json_end_record(json_writer_t * writer);
+
+
+
+/* Write the header ("header"), or one record per section ("ls"), segment ("lsg"), symbol ("lsym")
+or relocation ("lr") as JSON, the command is the first word of the query */
+void json_report(kvelf_basic_params_t * kvelfp, u8 * query);
+
+
+#endif
@@ -0,0 +1,316 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./json.h"
+
+
+
+/* Write the ELF header as one object */
+static void json_header(kvelf_basic_params_t * kvelfp, json_writer_t * writer){
+
+    u8 * ident = kvelfp->elfImage;
+
+    data_reader_t reader;
+    reader_init(&reader,kvelfp->elfImage+EI_NIDENT,kvelfp->elfImageSize-EI_NIDENT,ELF_NEEDS_SWAP(kvelfp->elfEncoding));
+
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+    u16 type = reader_u16(&reader);
+    u16 machine = reader_u16(&reader);
+    u32 version = reader_u32(&reader);
+    u64 entry = reader_uint(&reader,wordSize);
+    u64 segmentsOffset = reader_uint(&reader,wordSize);
+    u64 sectionsOffset = reader_uint(&reader,wordSize);
+    u32 flags = reader_u32(&reader);
+    u16 headerSize = reader_u16(&reader);
+    u16 segmentEntrySize = reader_u16(&reader);
+    reader_skip(&reader,sizeof(u16));
+    u16 sectionEntrySize = reader_u16(&reader);
+
+    json_begin_object(writer);
+    json_field_string(writer,"class",get_elf_class_string(ident[EI_CLASS]));
+    json_field_string(writer,"encoding",get_elf_dataencoding_string(ident[EI_DATA]));
+    json_field_string(writer,"abi",get_elf_abi_string(ident[EI_OSABI]));
+    json_field_uint(writer,"abiVersion",ident[EI_ABIVERSION]);
+    json_field_string(writer,"type",get_elf_object_file_type(type));
+    json_field_string(writer,"machine",get_elf_machine(machine));
+    json_field_uint(writer,"version",version);
+    json_field_uint(writer,"entry",entry);
+    json_field_uint(writer,"segmentsOffset",segmentsOffset);
+    json_field_uint(writer,"sectionsOffset",sectionsOffset);
+    json_field_uint(writer,"flags",flags);
+    json_field_uint(writer,"headerSize",headerSize);
+    json_field_uint(writer,"segmentEntrySize",segmentEntrySize);
+    json_field_uint(writer,"numOfSegments",kvelfp->elfNumOfSegments);
+    json_field_uint(writer,"sectionEntrySize",sectionEntrySize);
+    json_field_uint(writer,"numOfSections",kvelfp->elfNumOfSections);
+    json_field_uint(writer,"sectionNamesIdx",kvelfp->elfSectionsNameIdx);
+    json_end_object(writer);
+    json_end_record(writer);
+}
+
+
+/* Write a record per section */
+static void json_sections(kvelf_basic_params_t * kvelfp, json_writer_t * writer){
+
+    u8 flags[20];
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+        get_elf_section_flag(section->sFlags,flags,sizeof(flags));
+
+        json_begin_object(writer);
+        json_field_uint(writer,"index",i);
+        json_field_string(writer,"name",get_section_name(kvelfp,i));
+        json_field_string(writer,"type",get_elf_section_type(section->sType));
+        json_field_string(writer,"flags",flags);
+        json_field_uint(writer,"address",section->sVAddr);
+        json_field_uint(writer,"offset",section->sOffset);
+        json_field_uint(writer,"size",section->sSize);
+        json_field_uint(writer,"link",section->sLink);
+        json_field_uint(writer,"info",section->sInfo);
+        json_field_uint(writer,"entrySize",section->sEntSize);
+        json_end_object(writer);
+        json_end_record(writer);
+    }
+}
+
+
+/* Write a record per segment */
+static void json_segments(kvelf_basic_params_t * kvelfp, json_writer_t * writer){
+
+    u8 flags[4];
+
+    for(u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+        segment_metadata_t * segment = &kvelfp->elfSegmentsMetadata[i];
+        get_elf_segment_flag(segment->pFlags,flags,sizeof(flags));
+
+        json_begin_object(writer);
+        json_field_uint(writer,"index",i);
+        json_field_string(writer,"type",get_elf_segment_type(segment->pType));
+        json_field_string(writer,"flags",flags);
+        json_field_uint(writer,"offset",segment->pOffset);
+        json_field_uint(writer,"address",segment->pVAddr);
+        json_field_uint(writer,"fileSize",segment->pFileSize);
+        json_field_uint(writer,"memSize",segment->pMemSize);
+        json_end_object(writer);
+        json_end_record(writer);
+    }
+}
+
+
+/* Write a record per symbol of .symtab and .dynsym, read straight from the mapped tables */
+static void json_symbols(kvelf_basic_params_t * kvelfp, json_writer_t * writer){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+
+    for(u32 tableIdx=0;tableIdx<kvelfp->elfNumOfSections;tableIdx++){
+        section_metadata_t * table = &kvelfp->elfSectionsMetadata[tableIdx];
+        if(table->sType!=SHT_SYMTAB && table->sType!=SHT_DYNSYM)
+            continue;
+
+        u64 symbolsSize, stringsSize, shndxSize=0;
+        u8 * symbols = get_section_contents(kvelfp,tableIdx,&symbolsSize);
+        u8 * strings = get_section_contents(kvelfp,table->sLink,&stringsSize);
+        if(!symbols)
+            continue;
+
+        // Section indexes which do not fit in st_shndx are in the SYMTAB_SHNDX table linked to this one
+        u8 * shndx = NULL;
+        for(u32 i=0;i<kvelfp->elfNumOfSections && !shndx;i++)
+            if(kvelfp->elfSectionsMetadata[i].sType==SHT_SYMTAB_SHNDX && kvelfp->elfSectionsMetadata[i].sLink==tableIdx)
+                shndx = get_section_contents(kvelfp,i,&shndxSize);
+
+        u8 * tableName = get_section_name(kvelfp,tableIdx);
+        data_reader_t reader;
+        reader_init(&reader,symbols,symbolsSize,needsSwap);
+
+        for(u64 symbolIdx=0;symbolIdx<symbolsSize/symbolSize;symbolIdx++){
+            u32 nameOffset = reader_u32(&reader);
+            u64 value, size;
+            u8 info, other;
+            u32 sectionIdx;
+
+            if(kvelfp->elfClass==ELFCLASS32){
+                value = reader_u32(&reader);
+                size = reader_u32(&reader);
+                info = reader_u8(&reader);
+                other = reader_u8(&reader);
+                sectionIdx = reader_u16(&reader);
+            }else{
+                info = reader_u8(&reader);
+                other = reader_u8(&reader);
+                sectionIdx = reader_u16(&reader);
+                value = reader_u64(&reader);
+                size = reader_u64(&reader);
+            }
+
+            if(sectionIdx==SHN_XINDEX && shndx && symbolIdx<shndxSize/sizeof(u32)){
+                data_reader_t shndxReader;
+                reader_init(&shndxReader,shndx+symbolIdx*sizeof(u32),sizeof(u32),needsSwap);
+                sectionIdx = reader_u32(&shndxReader);
+            }
+
+            json_begin_object(writer);
+            json_field_string(writer,"table",tableName);
+            json_field_uint(writer,"index",symbolIdx);
+            json_field_string(writer,"name",string_at(strings,stringsSize,nameOffset));
+            json_field_uint(writer,"value",value);
+            json_field_uint(writer,"size",size);
+            json_field_string(writer,"type",get_elf_symbol_type(ELF64_ST_TYPE(info)));
+            json_field_string(writer,"binding",get_elf_symbol_binding(ELF64_ST_BIND(info)));
+            json_field_string(writer,"visibility",get_elf_symbol_visibility(other));
+            json_field_uint(writer,"section",sectionIdx);
+            json_end_object(writer);
+            json_end_record(writer);
+        }
+    }
+}
+
+
+/* Write the relocation applied at an address */
+static void json_relocation(json_writer_t * writer, u8 * tableName, u64 offset, u8 * type){
+
+    json_begin_object(writer);
+    json_field_string(writer,"table",tableName);
+    json_field_uint(writer,"offset",offset);
+    json_field_string(writer,"type",type);
+}
+
+
+/* Write a record per relocation of a REL or RELA table, the symbols are looked up by their index */
+static void json_relocation_table(kvelf_basic_params_t * kvelfp, json_writer_t * writer, u32 tableIdx, u8 ** relocTable, u32 relocTableSize){
+
+    section_metadata_t * table = &kvelfp->elfSectionsMetadata[tableIdx];
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u8 hasAddend = table->sType==SHT_RELA;
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+    u64 entrySize = wordSize*(hasAddend ? 3 : 2);
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+
+    u64 entriesSize, symbolsSize=0, stringsSize=0;
+    u8 * entries = get_section_contents(kvelfp,tableIdx,&entriesSize);
+    u8 * symbols = NULL, * strings = NULL;
+    if(!entries)
+        return;
+    if(table->sLink && table->sLink<kvelfp->elfNumOfSections){
+        symbols = get_section_contents(kvelfp,table->sLink,&symbolsSize);
+        strings = get_section_contents(kvelfp,kvelfp->elfSectionsMetadata[table->sLink].sLink,&stringsSize);
+    }
+
+    u8 * tableName = get_section_name(kvelfp,tableIdx);
+    data_reader_t reader, symbolReader;
+    reader_init(&reader,entries,entriesSize,needsSwap);
+
+    for(u64 entryIdx=0;entryIdx<entriesSize/entrySize;entryIdx++){
+        u64 offset = reader_uint(&reader,wordSize);
+        u64 info = reader_uint(&reader,wordSize);
+        u32 type = kvelfp->elfClass==ELFCLASS32 ? ELF32_R_TYPE(info) : ELF64_R_TYPE(info);
+        u64 symbolIdx = kvelfp->elfClass==ELFCLASS32 ? ELF32_R_SYM(info) : ELF64_R_SYM(info);
+
+        json_relocation(writer,tableName,offset,get_elf_reloc_type(relocTable,relocTableSize,type));
+        json_field_uint(writer,"symbolIndex",symbolIdx);
+
+        // The name is the first field of the symbols of both classes
+        if(symbolIdx && symbols && symbolIdx<symbolsSize/symbolSize){
+            reader_init(&symbolReader,symbols+symbolIdx*symbolSize,sizeof(u32),needsSwap);
+            json_field_string(writer,"symbol",string_at(strings,stringsSize,reader_u32(&symbolReader)));
+        }
+
+        if(hasAddend)
+            json_field_int(writer,"addend",kvelfp->elfClass==ELFCLASS32 ? (s32)reader_u32(&reader) : (s64)reader_u64(&reader));
+
+        json_end_object(writer);
+        json_end_record(writer);
+    }
+}
+
+
+/* Write a record per relocation packed in a RELR table */
+static void json_relr_table(kvelf_basic_params_t * kvelfp, json_writer_t * writer, u32 tableIdx, u8 * relativeType){
+
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+
+    u64 entriesSize;
+    u8 * entries = get_section_contents(kvelfp,tableIdx,&entriesSize);
+    if(!entries)
+        return;
+
+    u8 * tableName = get_section_name(kvelfp,tableIdx);
+    relr_cursor_t cursor;
+    relr_cursor_init(&cursor,entries,entriesSize,wordSize,ELF_NEEDS_SWAP(kvelfp->elfEncoding),0);
+
+    u64 address;
+    while(relr_cursor_next(&cursor,&address)){
+        json_relocation(writer,tableName,address,relativeType);
+        json_end_object(writer);
+        json_end_record(writer);
+    }
+}
+
+
+/* Write a record per relocation of the REL, RELA and RELR tables */
+static void json_relocations(kvelf_basic_params_t * kvelfp, json_writer_t * writer){
+
+    u32 relocTableSize;
+    u8 ** relocTable = get_elf_reloc_table(kvelfp->elfMachine,&relocTableSize);
+    u8 * relativeType = get_elf_reloc_type(relocTable,relocTableSize,get_elf_relative_reloc_type(kvelfp->elfMachine));
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        u32 type = kvelfp->elfSectionsMetadata[i].sType;
+
+        if(type==SHT_REL || type==SHT_RELA)
+            json_relocation_table(kvelfp,writer,i,relocTable,relocTableSize);
+        else if(type==SHT_RELR)
+            json_relr_table(kvelfp,writer,i,relativeType);
+    }
+}
+
+
+
+/* Write the header ("header"), or one record per section ("ls"), segment ("lsg"), symbol ("lsym")
+or relocation ("lr") as JSON, the command is the first word of the query */
+void json_report(kvelf_basic_params_t * kvelfp, u8 * query){
+
+    if(!kvelfp->elfImage){
+        display_error("The file is not mapped, it cannot be written as JSON\n");
+        return;
+    }
+
+    u8 * savePtr;
+    u8 * command = strtok_r(query," \t\n",(char **)&savePtr);
+    if(!command)
+        return;
+
+    // The writer holds its whole output buffer, every call has its own as the server runs many at once
+    json_writer_t * writer = malloc(sizeof(json_writer_t));
+    if(!writer){
+        debug("Cannot allocate the JSON writer\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    fflush(display_output());
+    json_writer_init(writer,display_output());
+
+    if(!strcmp(command,"header") || !strcmp(command,"h"))
+        json_header(kvelfp,writer);
+    else if(!strcmp(command,"ls") || !strcmp(command,"sections"))
+        json_sections(kvelfp,writer);
+    else if(!strcmp(command,"lsg") || !strcmp(command,"segments"))
+        json_segments(kvelfp,writer);
+    else if(!strcmp(command,"lsym") || !strcmp(command,"symbols"))
+        json_symbols(kvelfp,writer);
+    else if(!strcmp(command,"lr") || !strcmp(command,"relocs"))
+        json_relocations(kvelfp,writer);
+    else
+        display_error("\"%s\" has no JSON output, try header, ls, lsg, lsym or lr\n",command);
+
+    json_flush(writer);
+    free(writer);
+    fflush(display_output());
+}
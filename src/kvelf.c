@@ -1,49 +1,33 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "./types.h"
 #include "./debug.h"
 #include "./cli.h"
 #include "./elf.h"
 #include "./parse.h"
 #include "./error.h"
+#include "./byteorder.h"
+#include "./kvelf.h"
+#include "./dwarf.h"
+#include "./ehframe.h"
+#include "./strscan.h"
+#include "./entropy.h"
+#include "./hash.h"
+#include "./diff.h"
+#include "./disasm.h"
+#include "./plt.h"
+#include "./json.h"
+#include "./columnar.h"
+#include "./pager.h"
+#include "./visualize.h"
+#include "./serve.h"
+#include "./preparse.h"
+#include "./scan.h"
 
-typedef struct elf_offsets{
-	u32 elfHeaderOffset;	/* Offset of the ELF header */
-	u32 elfSectionHeaderOffset;	/* Offset of the ELF section headers */
-	u32 elfSegmentHeaderOffset;	/* Offset of the ELF segment headers */
-
-}elf_offsets_t;
-
-
-typedef struct section_metadata{
-	u32 sName;	/* Name of the section */
-	u64 sVAddr;	/* Section virtual address */
-	u64	sOffset;	/* Offset of the section */
-	u64 sSize;		/* Size of the section */
-}section_metadata_t;
-
-
-typedef struct kvelf_basic_params{
-	u8 * filePath;	/* File's path */
-	FILE * fp;		/* FILE hander */
-	
-	elf_offsets_t elfOffsets; /* Offsets of the ELF file */
-
-	u8 elfHeaderSize;	/* Size of the ELF header */
-	u8 elfClass; 	/* Class of the ELF (32/64 bits) */
-	u8 elfEncoding;	/* Data encoding of the ELF */
-	u16 elfFiletype;	/* Type of the ELF file */
-	u16 elfMachine;		/* Machine of the ELF file */
-	u32 elfFileVersion;	/* Version of the ELF file */
-	u64	elfEntrypoint;	/* Entry point of the ELF file */
-	u32 elfNumOfSections;	/* Number of sections */
-	u32 elfNumOfSegments;	/* Number of segments */
-	u32 elfSectionsNameIdx;	/* Section number of the section containing the section's names */
-	u32 sectionsNameOffset;	/* Starting address of the sections' names table */
-	section_metadata_t * elfSectionsMetadata;	/* Metadata sections */
-
-}kvelf_basic_params_t;
 
 
 
@@ -52,10 +36,36 @@ void basic_analysis(kvelf_basic_params_t * kvelfp){
 
 	if(!(kvelfp->fp = fopen(kvelfp->filePath,"rb"))){
 		// TODO
-		printf("[0;31m[Error][0m Cannot open the file \"%s\" (Busy/Permissions/Does not exist...)\n",kvelfp->filePath);
+		display_error("Cannot open the file \"%s\" (Busy/Permissions/Does not exist...)\n",kvelfp->filePath);
 		exit(ERROR_CANNOT_OPEN_FILE);
 	}
 
+	// Mapping the whole file, the commands which walk sections' contents read them from the image
+	struct stat fileStat;
+	kvelfp->elfImage=NULL;
+	kvelfp->elfImageSize=0;
+	if(fstat(fileno(kvelfp->fp),&fileStat)==0 && fileStat.st_size>0){
+		void * image = mmap(NULL,fileStat.st_size,PROT_READ,MAP_PRIVATE,fileno(kvelfp->fp),0);
+		if(image!=MAP_FAILED){
+			kvelfp->elfImage=image;
+			kvelfp->elfImageSize=fileStat.st_size;
+		}
+	}
+	if(!kvelfp->elfImage)
+		debug("Cannot map the file, sections' contents are not available\n",DEBUG_STATUS_WARNING);
+
+	// Tables decoded from the file are built on their first use
+	kvelfp->lineTable=NULL;
+	kvelfp->cuIndex=NULL;
+	kvelfp->ehFrameIndex=NULL;
+	kvelfp->demangleCache=NULL;
+	kvelfp->threadPool=NULL;
+	kvelfp->symbolIndex=NULL;
+	kvelfp->gotIndex=NULL;
+	kvelfp->pager=NULL;
+	kvelfp->preparser=NULL;
+	kvelfp->pagedListings=0;
+
 	debug("Analyzing file's ELF header...\n",DEBUG_STATUS_INF);
 
 	// Setting its offsets
@@ -93,6 +103,10 @@ void basic_analysis(kvelf_basic_params_t * kvelfp){
 			exit(ERROR_CANNOT_READ_FILE);
 		}
 
+		// Fields of the files in the foreign byte order are swapped right after reading
+		if(ELF_NEEDS_SWAP(kvelfp->elfEncoding))
+			elf_swap_ehdr32(&elf32Header);
+
 		// Setting ELF data enconding
 		kvelfp->elfFiletype=elf32Header.e_type;
 
@@ -132,6 +146,10 @@ void basic_analysis(kvelf_basic_params_t * kvelfp){
 			exit(ERROR_CANNOT_READ_FILE);
 		}
 
+		// Fields of the files in the foreign byte order are swapped right after reading
+		if(ELF_NEEDS_SWAP(kvelfp->elfEncoding))
+			elf_swap_ehdr64(&elf64Header);
+
 		// Setting ELF data enconding
 		kvelfp->elfFiletype=elf64Header.e_type;
 
@@ -163,52 +181,103 @@ void basic_analysis(kvelf_basic_params_t * kvelfp){
 		kvelfp->elfSectionsNameIdx=elf64Header.e_shstrndx;
 	}
 
-	debug("Analyzing file's ELF sections\n",DEBUG_STATUS_INF);
+	// Counts which do not fit in the ELF header are held by the first section header
+	resolve_elf_extended_numbering(kvelfp->fp,kvelfp->elfClass,ELF_NEEDS_SWAP(kvelfp->elfEncoding),kvelfp->elfOffsets.elfSectionHeaderOffset,&kvelfp->elfNumOfSections,&kvelfp->elfSectionsNameIdx,&kvelfp->elfNumOfSegments);
 
-	// Seeking to the start of the section header table for analyzing all the sections
-    fseek(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,SEEK_SET);
+	debug("Analyzing file's ELF sections\n",DEBUG_STATUS_INF);
 
     // Allocating the sections' metadata
-    kvelfp->elfSectionsMetadata=malloc(kvelfp->elfNumOfSections * sizeof(section_metadata_t));
+    kvelfp->elfSectionsMetadata=calloc(kvelfp->elfNumOfSections,sizeof(section_metadata_t));
 
 
-	if (kvelfp->elfClass == ELFCLASS32){
+	// The whole section header table is read at once
+	if (kvelfp->elfClass == ELFCLASS32 && kvelfp->elfNumOfSections){
 
-	    Elf32_Shdr elf32Shr;
+	    Elf32_Shdr * elf32Shrs = read_elf_section_headers32(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,kvelfp->elfNumOfSections,ELF_NEEDS_SWAP(kvelfp->elfEncoding));
 
-	    for (u32 i=0;i<kvelfp->elfNumOfSections;i++){
-
-	        if(fread(&elf32Shr,1,sizeof(Elf32_Shdr),kvelfp->fp)!=sizeof(Elf32_Shdr))
-	            debug("Cannot read section ---\n",DEBUG_STATUS_ERROR);
-	        else{
+	    if(!elf32Shrs)
+	        debug("Cannot read sections ---\n",DEBUG_STATUS_ERROR);
+	    else{
+	        for (u32 i=0;i<kvelfp->elfNumOfSections;i++){
 	        	// Reading the sections' name offset from the desired section entry
 	        	if(i==kvelfp->elfSectionsNameIdx)
-	        		kvelfp->sectionsNameOffset=elf32Shr.sh_offset;
-	        	kvelfp->elfSectionsMetadata[i].sName=elf32Shr.sh_name;
-	        	kvelfp->elfSectionsMetadata[i].sVAddr=elf32Shr.sh_addr;
-	        	kvelfp->elfSectionsMetadata[i].sOffset=elf32Shr.sh_offset;
-	        	kvelfp->elfSectionsMetadata[i].sSize=elf32Shr.sh_size;
-
+	        		kvelfp->sectionsNameOffset=elf32Shrs[i].sh_offset;
+	        	kvelfp->elfSectionsMetadata[i].sName=elf32Shrs[i].sh_name;
+	        	kvelfp->elfSectionsMetadata[i].sVAddr=elf32Shrs[i].sh_addr;
+	        	kvelfp->elfSectionsMetadata[i].sOffset=elf32Shrs[i].sh_offset;
+	        	kvelfp->elfSectionsMetadata[i].sSize=elf32Shrs[i].sh_size;
+	        	kvelfp->elfSectionsMetadata[i].sType=elf32Shrs[i].sh_type;
+	        	kvelfp->elfSectionsMetadata[i].sFlags=elf32Shrs[i].sh_flags;
+	        	kvelfp->elfSectionsMetadata[i].sLink=elf32Shrs[i].sh_link;
+	        	kvelfp->elfSectionsMetadata[i].sInfo=elf32Shrs[i].sh_info;
+	        	kvelfp->elfSectionsMetadata[i].sEntSize=elf32Shrs[i].sh_entsize;
 	        }
+	        free(elf32Shrs);
 	    }
-	}else if (kvelfp->elfClass == ELFCLASS64){
+	}else if (kvelfp->elfClass == ELFCLASS64 && kvelfp->elfNumOfSections){
 
-	    Elf64_Shdr elf64Shr;
+	    Elf64_Shdr * elf64Shrs = read_elf_section_headers64(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,kvelfp->elfNumOfSections,ELF_NEEDS_SWAP(kvelfp->elfEncoding));
 
-	    for (u32 i=0;i<kvelfp->elfNumOfSections;i++){
-
-	        if(fread(&elf64Shr,1,sizeof(Elf64_Shdr),kvelfp->fp)!=sizeof(Elf64_Shdr))
-	            debug("Cannot read section ---\n",DEBUG_STATUS_ERROR);
-	        else{
+	    if(!elf64Shrs)
+	        debug("Cannot read sections ---\n",DEBUG_STATUS_ERROR);
+	    else{
+	        for (u32 i=0;i<kvelfp->elfNumOfSections;i++){
 	        	// Reading the sections' name offset from the desired section entry
 	        	if(i==kvelfp->elfSectionsNameIdx)
-	        		kvelfp->sectionsNameOffset=elf64Shr.sh_offset;
-	        	kvelfp->elfSectionsMetadata[i].sName=elf64Shr.sh_name;
-	        	kvelfp->elfSectionsMetadata[i].sVAddr=elf64Shr.sh_addr;
-	        	kvelfp->elfSectionsMetadata[i].sOffset=elf64Shr.sh_offset;
-	        	kvelfp->elfSectionsMetadata[i].sSize=elf64Shr.sh_size;
+	        		kvelfp->sectionsNameOffset=elf64Shrs[i].sh_offset;
+	        	kvelfp->elfSectionsMetadata[i].sName=elf64Shrs[i].sh_name;
+	        	kvelfp->elfSectionsMetadata[i].sVAddr=elf64Shrs[i].sh_addr;
+	        	kvelfp->elfSectionsMetadata[i].sOffset=elf64Shrs[i].sh_offset;
+	        	kvelfp->elfSectionsMetadata[i].sSize=elf64Shrs[i].sh_size;
+	        	kvelfp->elfSectionsMetadata[i].sType=elf64Shrs[i].sh_type;
+	        	kvelfp->elfSectionsMetadata[i].sFlags=elf64Shrs[i].sh_flags;
+	        	kvelfp->elfSectionsMetadata[i].sLink=elf64Shrs[i].sh_link;
+	        	kvelfp->elfSectionsMetadata[i].sInfo=elf64Shrs[i].sh_info;
+	        	kvelfp->elfSectionsMetadata[i].sEntSize=elf64Shrs[i].sh_entsize;
+	        }
+	        free(elf64Shrs);
+	    }
+	}
+
+	debug("Analyzing file's ELF segments\n",DEBUG_STATUS_INF);
 
+	// Allocating the segments' metadata
+	kvelfp->elfSegmentsMetadata=calloc(kvelfp->elfNumOfSegments,sizeof(segment_metadata_t));
+
+	// The whole segment header table is read at once
+	if (kvelfp->elfClass == ELFCLASS32 && kvelfp->elfNumOfSegments){
+
+	    Elf32_Phdr * elf32Phdrs = read_elf_segment_headers32(kvelfp->fp,kvelfp->elfOffsets.elfSegmentHeaderOffset,kvelfp->elfNumOfSegments,ELF_NEEDS_SWAP(kvelfp->elfEncoding));
+
+	    if(!elf32Phdrs)
+	        debug("Cannot read segments ---\n",DEBUG_STATUS_ERROR);
+	    else{
+	        for (u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+	        	kvelfp->elfSegmentsMetadata[i].pType=elf32Phdrs[i].p_type;
+	        	kvelfp->elfSegmentsMetadata[i].pFlags=elf32Phdrs[i].p_flags;
+	        	kvelfp->elfSegmentsMetadata[i].pOffset=elf32Phdrs[i].p_offset;
+	        	kvelfp->elfSegmentsMetadata[i].pVAddr=elf32Phdrs[i].p_vaddr;
+	        	kvelfp->elfSegmentsMetadata[i].pFileSize=elf32Phdrs[i].p_filesz;
+	        	kvelfp->elfSegmentsMetadata[i].pMemSize=elf32Phdrs[i].p_memsz;
 	        }
+	        free(elf32Phdrs);
+	    }
+	}else if (kvelfp->elfClass == ELFCLASS64 && kvelfp->elfNumOfSegments){
+
+	    Elf64_Phdr * elf64Phdrs = read_elf_segment_headers64(kvelfp->fp,kvelfp->elfOffsets.elfSegmentHeaderOffset,kvelfp->elfNumOfSegments,ELF_NEEDS_SWAP(kvelfp->elfEncoding));
+
+	    if(!elf64Phdrs)
+	        debug("Cannot read segments ---\n",DEBUG_STATUS_ERROR);
+	    else{
+	        for (u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+	        	kvelfp->elfSegmentsMetadata[i].pType=elf64Phdrs[i].p_type;
+	        	kvelfp->elfSegmentsMetadata[i].pFlags=elf64Phdrs[i].p_flags;
+	        	kvelfp->elfSegmentsMetadata[i].pOffset=elf64Phdrs[i].p_offset;
+	        	kvelfp->elfSegmentsMetadata[i].pVAddr=elf64Phdrs[i].p_vaddr;
+	        	kvelfp->elfSegmentsMetadata[i].pFileSize=elf64Phdrs[i].p_filesz;
+	        	kvelfp->elfSegmentsMetadata[i].pMemSize=elf64Phdrs[i].p_memsz;
+	        }
+	        free(elf64Phdrs);
 	    }
 	}
 
@@ -217,125 +286,134 @@ void basic_analysis(kvelf_basic_params_t * kvelfp){
 
 
 
-/* Graphical representaion of the ELF file's various parts */
-void visualize_elf_file(kvelf_basic_params_t * kvelfp){
+/* Get the name of a section from the mapped sections' names table */
+u8 * get_section_name(kvelf_basic_params_t * kvelfp, u32 sectionIdx){
 
+	if(!kvelfp->elfImage || sectionIdx>=kvelfp->elfNumOfSections || kvelfp->elfSectionsNameIdx>=kvelfp->elfNumOfSections)
+		return "";
 
-	// Temporary buffer for concatinating multiple values
-	u8 tempBuff[100];
+	u64 namesSize;
+	u8 * names = get_section_contents(kvelfp,kvelfp->elfSectionsNameIdx,&namesSize);
+	u32 nameOffset = kvelfp->elfSectionsMetadata[sectionIdx].sName;
 
-	//TODO size relative algorithm
+	// The name has to be terminated inside the table
+	if(!names || nameOffset>=namesSize || !memchr(names+nameOffset,0,namesSize-nameOffset))
+		return "";
 
+	return names+nameOffset;
+}
 
 
-	//TODO size is in the header
-	display("\t\t\t\t------------------------------------------\n",DISPLAY_COLOR_RED);
-	display("\t\t\t\t|",DISPLAY_COLOR_RED);
-	printf("0x%016x(%dB)",kvelfp->elfOffsets.elfHeaderOffset,kvelfp->elfHeaderSize);
-	display("                 |\n",DISPLAY_COLOR_RED);
-	display("\t\t\t\t|                ELF Header              |\n",DISPLAY_COLOR_RED);
-	display("\t\t\t\t|                                        |\n",DISPLAY_COLOR_RED);
+/* Find the index of a section by its name, returns -1 if there is no such section */
+s64 find_section_by_name(kvelf_basic_params_t * kvelfp, u8 * sectionName){
 
-	if(kvelfp->elfOffsets.elfSegmentHeaderOffset){
-		display("\t\t\t\t------------------------------------------\n",DISPLAY_COLOR_ORANGE);
-		display("\t\t\t\t|",DISPLAY_COLOR_ORANGE);
-		printf("0x%016x",kvelfp->elfOffsets.elfSegmentHeaderOffset);
-		display("                      |\n",DISPLAY_COLOR_ORANGE);
-		display("\t\t\t\t|                                        |\n",DISPLAY_COLOR_ORANGE);
-		display("\t\t\t\t|            Segment Headers             |\n",DISPLAY_COLOR_ORANGE);
-		display("\t\t\t\t|                                        |\n",DISPLAY_COLOR_ORANGE);
-	}
+	for(u32 i=0;i<kvelfp->elfNumOfSections;i++)
+		if(strcmp(get_section_name(kvelfp,i),sectionName)==0)
+			return i;
 
-	if(kvelfp->elfOffsets.elfSectionHeaderOffset){
+	return -1;
+}
 
-		display("\t\t\t\t------------------------------------------\n",DISPLAY_COLOR_CYAN);
-		display("\t\t\t\t|",DISPLAY_COLOR_CYAN);
-		printf("0x%016x",kvelfp->elfOffsets.elfSectionHeaderOffset);
-		display("                      |\n",DISPLAY_COLOR_CYAN);
-		display("\t\t\t\t|                                        |\n",DISPLAY_COLOR_CYAN);
-		display("\t\t\t\t|             Section Headers            |\n",DISPLAY_COLOR_CYAN);
-		display("\t\t\t\t|                                        |\n",DISPLAY_COLOR_CYAN);
-		display("\t\t\t\t------------------------------------------\n",DISPLAY_COLOR_CYAN);		
-	}
-	
 
-	printf("\n\n");
-	
-	if(kvelfp->elfOffsets.elfSectionHeaderOffset){
-
-		// Seeking to the start of the sections' names
-		fseek(kvelfp->fp,kvelfp->sectionsNameOffset,SEEK_SET);
-		//TODO
-		u8 sectionNameBuff[50];
-		u32 idx=0;
-
-
-		for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
-
-			// Zeroing out the buffer
-			for(u32 i=0;i<50;i++)
-				sectionNameBuff[i]=0;
-			idx=0;
-
-			// Seeking to the section's name offset
-			fseek(kvelfp->fp,kvelfp->sectionsNameOffset + kvelfp->elfSectionsMetadata[i].sName,SEEK_SET);
-
-			// Reading section's name
-			//TODO
-			while(fread(sectionNameBuff+idx,1,1,kvelfp->fp)==1){
-				if(sectionNameBuff[idx]==0)
-					break;
-				idx++;
-			}
-
-			if(i==0){
-				printf("    Sections ---->");
-				display("\t\t------------------------------------------\n",DISPLAY_COLOR_GREEN_YELLOW);
-
-			}else
-				display("\t\t\t\t------------------------------------------\n",DISPLAY_COLOR_GREEN_YELLOW);
-			
-			sprintf(tempBuff,"\t\t\t\t|0x%016llx(%09lldB)          |\n",kvelfp->elfSectionsMetadata[i].sOffset,kvelfp->elfSectionsMetadata[i].sSize);
-			display(tempBuff,DISPLAY_COLOR_WHITE);
-			display("\t\t\t\t|                                        |\n",DISPLAY_COLOR_WHITE);
-			if(i==0){
-        		sprintf(tempBuff,"\t\t\t\t|%*s%*s|\n",22,"NULL",18,"");
-			}else
-        		sprintf(tempBuff,"\t\t\t\t|%*s%*s|\n",20+strlen(sectionNameBuff)/2,sectionNameBuff,20-strlen(sectionNameBuff)/2,"");
-
-			display(tempBuff,DISPLAY_COLOR_WHITE);
-			display("\t\t\t\t|                                        |\n",DISPLAY_COLOR_WHITE);
-		}
+/* Get the contents of a section in the mapped file, returns NULL if the section has none */
+u8 * get_section_contents(kvelf_basic_params_t * kvelfp, u32 sectionIdx, u64 * contentsSize){
 
-	}
+	*contentsSize=0;
+
+	if(!kvelfp->elfImage || sectionIdx>=kvelfp->elfNumOfSections)
+		return NULL;
+
+	section_metadata_t * section = &kvelfp->elfSectionsMetadata[sectionIdx];
+
+	// NOBITS sections and the ones lying outside the file have nothing to read
+	if(section->sType==SHT_NOBITS || section->sOffset>kvelfp->elfImageSize || section->sSize>kvelfp->elfImageSize-section->sOffset)
+		return NULL;
+
+	*contentsSize=section->sSize;
+	return kvelfp->elfImage+section->sOffset;
+}
+
+
+
+/* Find the index of the first segment of the given type, returns -1 if there is no such segment */
+s64 find_segment_by_type(kvelf_basic_params_t * kvelfp, u32 segmentType){
 
+	for(u32 i=0;i<kvelfp->elfNumOfSegments;i++)
+		if(kvelfp->elfSegmentsMetadata[i].pType==segmentType)
+			return i;
 
+	return -1;
 }
 
+
+/* Get the contents of a segment in the mapped file, returns NULL if the segment has none */
+u8 * get_segment_contents(kvelf_basic_params_t * kvelfp, u32 segmentIdx, u64 * contentsSize){
+
+	*contentsSize=0;
+
+	if(!kvelfp->elfImage || segmentIdx>=kvelfp->elfNumOfSegments)
+		return NULL;
+
+	segment_metadata_t * segment = &kvelfp->elfSegmentsMetadata[segmentIdx];
+
+	if(segment->pOffset>kvelfp->elfImageSize || segment->pFileSize>kvelfp->elfImageSize-segment->pOffset)
+		return NULL;
+
+	*contentsSize=segment->pFileSize;
+	return kvelfp->elfImage+segment->pOffset;
+}
+
+
+
+/* Get the file contents at a virtual address, returns NULL if no loadable segment maps it from the file */
+u8 * get_vaddr_contents(kvelf_basic_params_t * kvelfp, u64 vaddr, u64 * contentsSize){
+
+	*contentsSize=0;
+
+	for(u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+		segment_metadata_t * segment = &kvelfp->elfSegmentsMetadata[i];
+
+		if(segment->pType!=PT_LOAD || vaddr<segment->pVAddr || vaddr-segment->pVAddr>=segment->pFileSize)
+			continue;
+
+		u64 segmentSize;
+		u8 * segmentContents = get_segment_contents(kvelfp,i,&segmentSize);
+		if(!segmentContents)
+			return NULL;
+
+		*contentsSize=segmentSize-(vaddr-segment->pVAddr);
+		return segmentContents+(vaddr-segment->pVAddr);
+	}
+
+	return NULL;
+}
+
+
+
 /* Display the abstract of the ELF file */
 void display_elf_abstract(kvelf_basic_params_t * kvelfp){
 
-	printf("\n");
+	fprintf(display_output(),"\n");
 
     display("Entry: ",DISPLAY_COLOR_ORANGE);
-	printf("0x%016llx\n",kvelfp->elfEntrypoint);
+	fprintf(display_output(),"0x%016llx\n",kvelfp->elfEntrypoint);
 
 	display("Class: ",DISPLAY_COLOR_ORANGE);
-	printf("%s\n",get_elf_class_string(kvelfp->elfClass));
+	fprintf(display_output(),"%s\n",get_elf_class_string(kvelfp->elfClass));
     
     display("Encoding: ",DISPLAY_COLOR_ORANGE);	
-	printf("%s\n",get_elf_dataencoding_string(kvelfp->elfEncoding));
+	fprintf(display_output(),"%s\n",get_elf_dataencoding_string(kvelfp->elfEncoding));
     
     display("Type: ",DISPLAY_COLOR_ORANGE);
-	printf("%s\n",get_elf_object_file_type(kvelfp->elfFiletype));
+	fprintf(display_output(),"%s\n",get_elf_object_file_type(kvelfp->elfFiletype));
 
     display("Machine: ",DISPLAY_COLOR_ORANGE);
-	printf("%s\n",get_elf_machine(kvelfp->elfMachine));
+	fprintf(display_output(),"%s\n",get_elf_machine(kvelfp->elfMachine));
 	
     display("File Version: ",DISPLAY_COLOR_ORANGE);
-	printf("%d\n",kvelfp->elfFileVersion);
+	fprintf(display_output(),"%d\n",kvelfp->elfFileVersion);
 	
-	printf("\n");
+	fprintf(display_output(),"\n");
 }
 
 
@@ -363,11 +441,11 @@ void parse_at(kvelf_basic_params_t * kvelfp, u64 offset){
 	if(offset==kvelfp->elfOffsets.elfHeaderOffset)
 		parse_elf_header(kvelfp->fp,kvelfp->elfOffsets.elfHeaderOffset);
 	else if(offset==kvelfp->elfOffsets.elfSectionHeaderOffset)
-		parse_elf_sections(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,kvelfp->elfNumOfSections,kvelfp->elfSectionsNameIdx,kvelfp->elfClass);
+		parse_elf_sections(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,kvelfp->elfNumOfSections,kvelfp->elfSectionsNameIdx,kvelfp->elfClass,kvelfp->elfEncoding);
 	else if(offset==kvelfp->elfOffsets.elfSegmentHeaderOffset)
-		parse_elf_segments(kvelfp->fp,kvelfp->elfOffsets.elfSegmentHeaderOffset,kvelfp->elfNumOfSegments,kvelfp->elfClass);
+		parse_elf_segments(kvelfp->fp,kvelfp->elfOffsets.elfSegmentHeaderOffset,kvelfp->elfNumOfSegments,kvelfp->elfClass,kvelfp->elfEncoding);
 	else if((sectionIdx=offset_is_section_metadata(kvelfp->elfOffsets.elfSectionHeaderOffset,kvelfp->elfNumOfSections,kvelfp->elfClass,offset))!=-1){
-		parse_elf_section(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,sectionIdx,kvelfp->elfClass);
+		parse_elf_section(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,sectionIdx,kvelfp->elfClass,kvelfp->elfEncoding);
 	}else
 		debug("Nothing to be parsed at this address\n",DEBUG_STATUS_INF);
 	
@@ -378,6 +456,100 @@ void parse_at(kvelf_basic_params_t * kvelfp, u64 offset){
 
 
 
+/* Pool formatting the rows of the long listings, started by the first one */
+static thread_pool_t * listing_pool(kvelf_basic_params_t * kvelfp){
+
+	if(!kvelfp->threadPool)
+		kvelfp->threadPool = pool_create(0);
+	return kvelfp->threadPool;
+}
+
+
+/* Run one command line of the prompt, the seek commands move the current offset. Returns 0 once
+the command ends the prompt */
+u8 run_command(kvelf_basic_params_t * kvelfp, regex_t * cliRegex, u8 * usercmd, u64 * fileOffset){
+
+	// Commands taking arguments are anchored and checked before the looser patterns
+	if(regexec(&cliRegex[KVELF_CMD_REGEX_FORMAT_JSON_IDX], usercmd, 0, NULL, 0)==0)
+		json_report(kvelfp,usercmd);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_ADDR2LINE_IDX], usercmd, 0, NULL, 0)==0)
+		dwarf_addr2line(kvelfp,strstr(usercmd,"addr2line")+strlen("addr2line"));
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_FUNC_IDX], usercmd, 0, NULL, 0)==0)
+		dwarf_lookup_function(kvelfp,strstr(usercmd,"func")+strlen("func"));
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_FDE_IDX], usercmd, 0, NULL, 0)==0)
+		eh_frame_query(kvelfp,strstr(usercmd,"fde")+strlen("fde"));
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_PAGE_IDX], usercmd, 0, NULL, 0)==0)
+		pager_command(kvelfp,usercmd);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_SYMBOLS_DEMANGLED_IDX], usercmd, 0, NULL, 0)==0){
+		if(!kvelfp->demangleCache)
+			kvelfp->demangleCache=demangle_cache_create();
+		if(!kvelfp->pagedListings || !pager_open(kvelfp,PAGER_LISTING_SYMBOLS,1))
+			parse_elf_symbols(kvelfp->fp,get_listing_tables(kvelfp),kvelfp->elfClass,kvelfp->demangleCache,listing_pool(kvelfp));
+	}
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_STRINGS_IDX], usercmd, 0, NULL, 0)==0)
+		strings_scan(kvelfp,strstr(usercmd,"strings")+strlen("strings"));
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_ENTROPY_IDX], usercmd, 0, NULL, 0)==0)
+		entropy_report(kvelfp,strstr(usercmd,"entropy")+strlen("entropy"));
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_HASH_IDX], usercmd, 0, NULL, 0)==0)
+		hash_contents(kvelfp,strstr(usercmd,"hash")+strlen("hash"));
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_DISASM_IDX], usercmd, 0, NULL, 0)==0)
+		disassemble(kvelfp,strstr(usercmd,"dis")+strlen("dis"));
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_PLT_IDX], usercmd, 0, NULL, 0)==0)
+		plt_list_stubs(kvelfp);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_GOT_IDX], usercmd, 0, NULL, 0)==0)
+		got_list_slots(kvelfp);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_EXPORT_IDX], usercmd, 0, NULL, 0)==0)
+		columnar_export(kvelfp,strstr(usercmd,"export")+strlen("export"));
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_EXIT_IDX], usercmd, 0, NULL, 0)==0){
+		fprintf(display_output(),"Bye:)!\n");
+		return 0;
+	}
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_ABST_IDX], usercmd, 0, NULL, 0)==0)
+		display_elf_abstract(kvelfp);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_VISUALIZE_IDX], usercmd, 0, NULL, 0)==0)
+		visualize_elf_file(kvelfp);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_SYMBOLS_IDX], usercmd, 0, NULL, 0)==0){
+		if(!kvelfp->pagedListings || !pager_open(kvelfp,PAGER_LISTING_SYMBOLS,0))
+			parse_elf_symbols(kvelfp->fp,get_listing_tables(kvelfp),kvelfp->elfClass,NULL,listing_pool(kvelfp));
+	}
+	
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_SEGMENTS_IDX], usercmd, 0, NULL, 0)==0)
+		parse_elf_segments(kvelfp->fp,kvelfp->elfOffsets.elfSegmentHeaderOffset,kvelfp->elfNumOfSegments,kvelfp->elfClass,kvelfp->elfEncoding);
+	
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_SECTIONS_IDX], usercmd, 0, NULL, 0)==0)
+		parse_elf_sections(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,kvelfp->elfNumOfSections,kvelfp->elfSectionsNameIdx,kvelfp->elfClass,kvelfp->elfEncoding);
+
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_HEADER_IDX], usercmd, 0, NULL, 0)==0)
+		parse_elf_header(kvelfp->fp,kvelfp->elfOffsets.elfHeaderOffset);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_RELOCS_STATS_IDX], usercmd, 0, NULL, 0)==0)
+		parse_elf_relocs(kvelfp->fp,get_listing_tables(kvelfp),kvelfp->elfClass,1,NULL);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_RELOCS_IDX], usercmd, 0, NULL, 0)==0){
+		if(!kvelfp->pagedListings || !pager_open(kvelfp,PAGER_LISTING_RELOCATIONS,0))
+			parse_elf_relocs(kvelfp->fp,get_listing_tables(kvelfp),kvelfp->elfClass,0,listing_pool(kvelfp));
+	}
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_SEEK_IDX], usercmd, 0, NULL, 0)==0){
+		u8 * givenNumber =  get_word_in_string_by_idx(usercmd,1);
+		*fileOffset = strtoull(givenNumber, NULL, 0);		
+	}
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_PARSE_RAW_BYTES_IDX], usercmd, 0, NULL, 0)==0){
+		u8 * givenBytesCount =  get_word_in_string_by_idx(usercmd,1);
+		u64 givenBytes = strtoull(givenBytesCount, NULL, 0);
+		pe_parse_raw_bytes(kvelfp->fp,*fileOffset,givenBytes);
+	}
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_PARSE_AT_IDX], usercmd, 0, NULL, 0)==0){
+		u8 * givenOffsetStr =  get_word_in_string_by_idx(usercmd,1);
+		u64 givenOffset =(unsigned long long) strtoll(givenOffsetStr, NULL, 0);
+		parse_at(kvelfp,givenOffset);
+	}
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_PARSE_IDX], usercmd, 0, NULL, 0)==0)
+		parse_at(kvelfp,*fileOffset);
+	else if(regexec(&cliRegex[KVELF_CMD_REGEX_HELP_IDX], usercmd, 0, NULL, 0)==0)
+		print_cli_help();
+
+	return 1;
+}
+
+
 /* Prompts the cmd line for the user */
 void prompt(kvelf_basic_params_t * kvelfp){
 
@@ -395,52 +567,21 @@ void prompt(kvelf_basic_params_t * kvelfp){
 	//TODO not covering whole range
 	u64 fileOffset=0;
 
+	// Long listings are shown a page at a time to someone at a terminal, piped commands get all the rows
+	kvelfp->pagedListings = isatty(STDIN_FILENO) && isatty(STDOUT_FILENO);
+
 
 	/* Matching priority is important since the match finding is the case not the whole !!*/
 
 	while(1){
-		printf("0x%016llx> ",fileOffset);
-		fgets(usercmd, KVELF_INPUT_CMD_MAX_LENGTH, stdin);
-	
-		if(regexec(&cliRegex[KVELF_CMD_REGEX_EXIT_IDX], usercmd, 0, NULL, 0)==0){
-			printf("Bye:)!\n");
+		fprintf(display_output(),"0x%016llx> ",fileOffset);
+		if(!fgets(usercmd, KVELF_INPUT_CMD_MAX_LENGTH, stdin)){
+			fprintf(display_output(),"Bye:)!\n");
 			exit(0);
 		}
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_ABST_IDX], usercmd, 0, NULL, 0)==0)
-			display_elf_abstract(kvelfp);
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_VISUALIZE_IDX], usercmd, 0, NULL, 0)==0)
-			visualize_elf_file(kvelfp);
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_SYMBOLS_IDX], usercmd, 0, NULL, 0)==0)
-			parse_elf_symbols(kvelfp->fp,0,kvelfp->elfClass);
-		
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_SEGMENTS_IDX], usercmd, 0, NULL, 0)==0)
-			parse_elf_segments(kvelfp->fp,kvelfp->elfOffsets.elfSegmentHeaderOffset,kvelfp->elfNumOfSegments,kvelfp->elfClass);
-		
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_SECTIONS_IDX], usercmd, 0, NULL, 0)==0)
-			parse_elf_sections(kvelfp->fp,kvelfp->elfOffsets.elfSectionHeaderOffset,kvelfp->elfNumOfSections,kvelfp->elfSectionsNameIdx,kvelfp->elfClass);
-
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_HEADER_IDX], usercmd, 0, NULL, 0)==0)
-			parse_elf_header(kvelfp->fp,kvelfp->elfOffsets.elfHeaderOffset);
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_RELOCS_IDX], usercmd, 0, NULL, 0)==0)
-			parse_elf_relocs(kvelfp->fp,kvelfp->elfClass);
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_SEEK_IDX], usercmd, 0, NULL, 0)==0){
-			u8 * givenNumber =  get_word_in_string_by_idx(usercmd,1);
-			fileOffset = strtoull(givenNumber, NULL, 0);		
-		}
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_PARSE_RAW_BYTES_IDX], usercmd, 0, NULL, 0)==0){
-			u8 * givenBytesCount =  get_word_in_string_by_idx(usercmd,1);
-			u32 givenBytes = strtol(givenBytesCount, NULL, 0);
-			pe_parse_raw_bytes(kvelfp->fp,fileOffset,givenBytes);
-		}
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_PARSE_AT_IDX], usercmd, 0, NULL, 0)==0){
-			u8 * givenOffsetStr =  get_word_in_string_by_idx(usercmd,1);
-			u64 givenOffset =(unsigned long long) strtoll(givenOffsetStr, NULL, 0);
-			parse_at(kvelfp,givenOffset);
-		}
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_PARSE_IDX], usercmd, 0, NULL, 0)==0)
-			parse_at(kvelfp,fileOffset);
-		else if(regexec(&cliRegex[KVELF_CMD_REGEX_HELP_IDX], usercmd, 0, NULL, 0)==0)
-			print_cli_help();
+
+		if(!run_command(kvelfp,cliRegex,usercmd,&fileOffset))
+			exit(0);
 	}
 }
 
@@ -449,6 +590,14 @@ void prompt(kvelf_basic_params_t * kvelfp){
 
 
 u32 main(u32 argc , u8 ** argv){
+
+	// Colors are on for a terminal unless NO_COLOR is set, "--color" and "--no-color" force them
+	display_set_color(isatty(STDOUT_FILENO) && !getenv("NO_COLOR"));
+	while(argc>1 && (strcmp(argv[1],"--color")==0 || strcmp(argv[1],"--no-color")==0)){
+		display_set_color(strcmp(argv[1],"--color")==0);
+		argv++;
+		argc--;
+	}
 	
 	if(argc==1){
 		
@@ -456,14 +605,80 @@ u32 main(u32 argc , u8 ** argv){
 		exit(ERROR_NO_FILE_PROVIDED);
 	}
 
+	// "kvelf serve --socket PATH [FILE..]" answers the commands of many clients on the files it keeps analyzed
+	if(strcmp(argv[1],"serve")==0){
+		if(argc<4 || strcmp(argv[2],"--socket")!=0){
+			debug("Usage: kvelf serve --socket PATH [FILE..]\n",DEBUG_STATUS_ERROR);
+			exit(ERROR_NO_FILE_PROVIDED);
+		}
+
+		// The output goes to the clients, never to a terminal
+		display_set_color(0);
+		serve(argv[3],argv+4,argc-4);
+		exit(0);
+	}
+
+	// "kvelf scan [--pread] PATH.." lists the ELF files among many files and directories
+	if(strcmp(argv[1],"scan")==0){
+		if(argc<3 || (argc==3 && strcmp(argv[2],"--pread")==0)){
+			debug("Usage: kvelf scan [--pread] PATH..\n",DEBUG_STATUS_ERROR);
+			exit(ERROR_NO_FILE_PROVIDED);
+		}
+
+		scan_paths(argv+2,argc-2);
+		exit(0);
+	}
+
+	// "kvelf diff A B" compares two files instead of prompting
+	if(strcmp(argv[1],"diff")==0){
+		if(argc!=4){
+			debug("Usage: kvelf diff FILE_A FILE_B\n",DEBUG_STATUS_ERROR);
+			exit(ERROR_NO_FILE_PROVIDED);
+		}
+
+		kvelf_basic_params_t kvelfpA, kvelfpB;
+		kvelfpA.filePath = argv[2];
+		kvelfpB.filePath = argv[3];
+		debug_set_quiet(1);
+		basic_analysis(&kvelfpA);
+		basic_analysis(&kvelfpB);
+
+		elf_diff(&kvelfpA,&kvelfpB);
+		exit(0);
+	}
+
 	/* Holding global parameters of the program during analysis */
 	kvelf_basic_params_t kvelfp;
 
 	kvelfp.filePath = argv[1];
 
+	// "kvelf FILE COMMAND.." runs one command without prompting, so its output can be piped
+	if(argc>2){
+		u8 usercmd[KVELF_INPUT_CMD_MAX_LENGTH];
+		u32 cmdLength=0;
+		for(u32 i=2;i<argc && cmdLength<sizeof(usercmd);i++)
+			cmdLength+=snprintf(usercmd+cmdLength,sizeof(usercmd)-cmdLength,i==2 ? "%s" : " %s",argv[i]);
+
+		regex_t * cliRegex = kvelf_compile_commandline();
+		if(!cliRegex){
+			debug("Cannot compile CLI commands",DEBUG_STATUS_ERROR);
+			exit(ERROR_CANNOT_SETUP_CMD);
+		}
+
+		debug_set_quiet(1);
+		basic_analysis(&kvelfp);
+
+		u64 fileOffset=0;
+		run_command(&kvelfp,cliRegex,usercmd,&fileOffset);
+		exit(0);
+	}
+
 	// Performing basic analysis
 	basic_analysis(&kvelfp);
 
+	// The indexes are built while the prompt waits for the first command
+	preparse_start(&kvelfp);
+
 	// Starting the prompt
 	prompt(&kvelfp);
 	
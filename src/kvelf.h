@@ -0,0 +1,99 @@
+#ifndef KVELF_H
+#define KVELF_H
+
+#include <stdio.h>
+#include "./types.h"
+
+
+typedef struct elf_offsets{
+	u32 elfHeaderOffset;	/* Offset of the ELF header */
+	u32 elfSectionHeaderOffset;	/* Offset of the ELF section headers */
+	u32 elfSegmentHeaderOffset;	/* Offset of the ELF segment headers */
+
+}elf_offsets_t;
+
+
+typedef struct section_metadata{
+	u32 sName;	/* Name of the section */
+	u32 sType;	/* Type of the section */
+	u64 sFlags;	/* Flags of the section */
+	u64 sVAddr;	/* Section virtual address */
+	u64	sOffset;	/* Offset of the section */
+	u64 sSize;		/* Size of the section */
+	u32 sLink;	/* Link to another section */
+	u32 sInfo;	/* Additional section information */
+	u64 sEntSize;	/* Size of the section's entries */
+}section_metadata_t;
+
+
+typedef struct segment_metadata{
+	u32 pType;	/* Type of the segment */
+	u32 pFlags;	/* Flags of the segment */
+	u64 pOffset;	/* Offset of the segment */
+	u64 pVAddr;	/* Segment virtual address */
+	u64 pFileSize;	/* Size of the segment in the file */
+	u64 pMemSize;	/* Size of the segment in memory */
+}segment_metadata_t;
+
+
+typedef struct kvelf_basic_params{
+	u8 * filePath;	/* File's path */
+	FILE * fp;		/* FILE hander */
+	u8 * elfImage;	/* The whole file mapped in memory, NULL if it cannot be mapped */
+	u64 elfImageSize;	/* Size of the mapped file */
+	
+	elf_offsets_t elfOffsets; /* Offsets of the ELF file */
+
+	u8 elfHeaderSize;	/* Size of the ELF header */
+	u8 elfClass; 	/* Class of the ELF (32/64 bits) */
+	u8 elfEncoding;	/* Data encoding of the ELF */
+	u16 elfFiletype;	/* Type of the ELF file */
+	u16 elfMachine;		/* Machine of the ELF file */
+	u32 elfFileVersion;	/* Version of the ELF file */
+	u64	elfEntrypoint;	/* Entry point of the ELF file */
+	u32 elfNumOfSections;	/* Number of sections */
+	u32 elfNumOfSegments;	/* Number of segments */
+	u32 elfSectionsNameIdx;	/* Section number of the section containing the section's names */
+	u32 sectionsNameOffset;	/* Starting address of the sections' names table */
+	section_metadata_t * elfSectionsMetadata;	/* Metadata sections */
+	segment_metadata_t * elfSegmentsMetadata;	/* Metadata segments */
+
+	struct dwarf_line_table * lineTable;	/* Decoded .debug_line, built on its first use */
+	struct dwarf_cu_index * cuIndex;	/* Compilation units index, built on its first use */
+	struct eh_frame_index * ehFrameIndex;	/* Sorted FDEs of .eh_frame, built on its first use */
+	struct demangle_cache * demangleCache;	/* Demangled symbol names, built on their first use */
+	struct thread_pool * threadPool;	/* Worker threads, started on their first use */
+	struct symbol_index * symbolIndex;	/* Symbols sorted by address, built on their first use */
+	struct got_index * gotIndex;	/* Relocated GOT slots sorted by address, built on their first use */
+	struct pager * pager;	/* Listing shown a page at a time, created by the first paged listing */
+	struct listing_tables * listingTables;	/* Symbol, string and relocation tables in the host's order, built on their first use */
+	struct preparser * preparser;	/* Background worker building the indexes, started for the prompt */
+	u8 pagedListings;	/* Whether lsym and lr are paged, set by the prompt on a terminal */
+
+}kvelf_basic_params_t;
+
+
+
+/* This function perfroms the basic analysis of the ELF file */
+void basic_analysis(kvelf_basic_params_t * kvelfp);
+
+/* Get the name of a section from the mapped sections' names table */
+u8 * get_section_name(kvelf_basic_params_t * kvelfp, u32 sectionIdx);
+
+/* Find the index of a section by its name, returns -1 if there is no such section */
+s64 find_section_by_name(kvelf_basic_params_t * kvelfp, u8 * sectionName);
+
+/* Get the contents of a section in the mapped file, returns NULL if the section has none */
+u8 * get_section_contents(kvelf_basic_params_t * kvelfp, u32 sectionIdx, u64 * contentsSize);
+
+/* Find the index of the first segment of the given type, returns -1 if there is no such segment */
+s64 find_segment_by_type(kvelf_basic_params_t * kvelfp, u32 segmentType);
+
+/* Get the contents of a segment in the mapped file, returns NULL if the segment has none */
+u8 * get_segment_contents(kvelf_basic_params_t * kvelfp, u32 segmentIdx, u64 * contentsSize);
+
+/* Get the file contents at a virtual address, returns NULL if no loadable segment maps it from the file */
+u8 * get_vaddr_contents(kvelf_basic_params_t * kvelfp, u64 vaddr, u64 * contentsSize);
+
+
+#endif
@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./pool.h"
+#include "./layout.h"
+
+
+
+static const u8 layoutHexDigits[16] = "0123456789abcdef";
+
+
+/* Row being rendered, written out whenever it fills up */
+typedef struct row_buffer{
+    layout_buffer_t * target;   /* Buffer the row is written to, NULL for the output */
+    u32 used;
+    u8 bytes[LAYOUT_ROW_BUFFER_SIZE];
+}row_buffer_t;
+
+
+/* Chunks of a table formatted by the tasks of a round */
+typedef struct entries_round{
+    layout_entries_fn formatEntries;
+    void * context;
+    u64 firstEntry;         /* First entry of the round */
+    u64 numOfEntries;       /* Entries of the whole table */
+    layout_buffer_t * buffers;  /* Rows of every chunk of the round */
+}entries_round_t;
+
+
+static void buffer_append(layout_buffer_t * buffer, const u8 * data, u64 size){
+
+    if(buffer->used+size>buffer->capacity){
+        u64 capacity = buffer->capacity ? buffer->capacity : LAYOUT_ROW_BUFFER_SIZE;
+        while(capacity<buffer->used+size)
+            capacity *= 2;
+        buffer->bytes = realloc(buffer->bytes,capacity);
+        if(!buffer->bytes){
+            debug("Cannot allocate memory for the rows of the table\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->bytes+buffer->used,data,size);
+    buffer->used += size;
+}
+
+
+static void row_write(row_buffer_t * row, const u8 * data, u64 size){
+
+    if(row->target)
+        buffer_append(row->target,data,size);
+    else
+        fwrite(data,1,size,display_output());
+}
+
+
+static void row_flush(row_buffer_t * row){
+
+    row_write(row,row->bytes,row->used);
+    row->used = 0;
+}
+
+
+static void row_append(row_buffer_t * row, const u8 * data, u64 size){
+
+    // Data larger than the buffer, like the longest demangled names, is written as it is
+    if(row->used+size>LAYOUT_ROW_BUFFER_SIZE){
+        row_flush(row);
+        if(size>LAYOUT_ROW_BUFFER_SIZE){
+            row_write(row,data,size);
+            return;
+        }
+    }
+
+    memcpy(row->bytes+row->used,data,size);
+    row->used += size;
+}
+
+
+static void row_pad(row_buffer_t * row, u64 written, u8 width){
+
+    static const u8 spaces[256] = {[0 ... 255] = ' '};
+
+    if(written<width)
+        row_append(row,spaces,width-written);
+}
+
+
+/* Render a value into digits, returns the number of characters */
+static u32 render_number(u8 * text, const layout_column_t * column, layout_field_t field){
+
+    u8 digits[24];
+    u32 length = 0;
+
+    if(column->kind==LAYOUT_HEX){
+        u64 value = field.number;
+        do{
+            digits[length++] = layoutHexDigits[value & 0xf];
+            value >>= 4;
+        }while(value);
+        while(length<column->digits && length<16)
+            digits[length++] = '0';
+        digits[length++] = 'x';
+        digits[length++] = '0';
+    }else{
+        u8 negative = column->kind==LAYOUT_INT && field.integer<0;
+        u64 value = negative ? -(u64)field.integer : field.number;
+        do{
+            digits[length++] = '0'+value%10;
+            value /= 10;
+        }while(value);
+        if(negative)
+            digits[length++] = '-';
+    }
+
+    for(u32 i=0;i<length;i++)
+        text[i] = digits[length-1-i];
+    return length;
+}
+
+
+
+/* Compile the layout of a table, the colors are decided by the display mode at this time */
+void layout_compile(table_layout_t * layout, const layout_column_t * columns, u32 numOfColumns){
+
+    layout->columns = columns;
+    layout->numOfColumns = numOfColumns;
+
+    const char * color = display_color_sequence(DISPLAY_COLOR_ORANGE);
+    const char * reset = display_reset_sequence();
+    u32 length = snprintf(layout->header,sizeof(layout->header),"%s",color);
+
+    // Titles are padded to their columns' widths, a title as wide as its column is still separated
+    for(u32 i=0;i<numOfColumns && length<sizeof(layout->header);i++){
+        u32 titleLength = strlen(columns[i].title);
+        u32 width = titleLength<columns[i].width ? columns[i].width : titleLength+(i+1<numOfColumns);
+        length += snprintf(layout->header+length,sizeof(layout->header)-length,"%-*s",width,columns[i].title);
+    }
+    if(length<sizeof(layout->header))
+        length += snprintf(layout->header+length,sizeof(layout->header)-length,"%s\n",reset);
+
+    layout->headerLength = length<sizeof(layout->header) ? length : sizeof(layout->header)-1;
+}
+
+
+/* Print the header of a table */
+void layout_print_header(table_layout_t * layout){
+    fwrite(layout->header,1,layout->headerLength,display_output());
+}
+
+
+/* Render the columns of a row, the row's target is set by the caller */
+static void render_row(table_layout_t * layout, const layout_field_t * fields, row_buffer_t * row){
+
+    row->used = 0;
+
+    for(u32 i=0;i<layout->numOfColumns;i++){
+        const layout_column_t * column = &layout->columns[i];
+        u64 written;
+
+        if(column->kind==LAYOUT_STRING){
+            written = strlen(fields[i].string);
+            row_append(row,fields[i].string,written);
+        }else{
+            u8 text[24];
+            written = render_number(text,column,fields[i]);
+            row_append(row,text,written);
+        }
+
+        // The last column is not padded
+        if(i+1<layout->numOfColumns)
+            row_pad(row,written,column->width);
+    }
+
+    row_append(row,"\n",1);
+    row_flush(row);
+}
+
+
+/* Format the chunk of a round, every task has its own buffer */
+static void format_chunk(void * context, u64 chunkIdx){
+
+    entries_round_t * round = context;
+    u64 firstEntry = round->firstEntry+chunkIdx*LAYOUT_CHUNK_ENTRIES;
+    u64 endEntry = firstEntry+LAYOUT_CHUNK_ENTRIES<round->numOfEntries ? firstEntry+LAYOUT_CHUNK_ENTRIES : round->numOfEntries;
+
+    round->buffers[chunkIdx].used = 0;
+    round->formatEntries(round->context,firstEntry,endEntry,&round->buffers[chunkIdx]);
+}
+
+
+
+/* Render a row from the raw values of its columns and print it */
+void layout_print_row(table_layout_t * layout, const layout_field_t * fields){
+
+    row_buffer_t row;
+    row.target = NULL;
+    render_row(layout,fields,&row);
+}
+
+
+/* Render a row from the raw values of its columns into a buffer */
+void layout_render_row(table_layout_t * layout, const layout_field_t * fields, layout_buffer_t * buffer){
+
+    row_buffer_t row;
+    row.target = buffer;
+    render_row(layout,fields,&row);
+}
+
+
+/* Print the rows of a table's entries, formatted in chunks on the pool's threads and printed in
+the entries' order. The output is the same as formatting them in order, NULL for no pool */
+void layout_print_entries(struct thread_pool * pool, u64 numOfEntries, layout_entries_fn formatEntries, void * context){
+
+    // A round is as many chunks as keep every thread busy, so the buffers stay bounded
+    // whatever the size of the table
+    u64 chunksPerRound = pool ? (u64)(pool->numOfWorkers+1)*LAYOUT_CHUNKS_PER_THREAD : 1;
+
+    entries_round_t round;
+    round.formatEntries = formatEntries;
+    round.context = context;
+    round.numOfEntries = numOfEntries;
+    round.buffers = calloc(chunksPerRound,sizeof(layout_buffer_t));
+    if(!round.buffers){
+        debug("Cannot allocate memory for the rows of the table\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    for(round.firstEntry=0;round.firstEntry<numOfEntries;round.firstEntry+=chunksPerRound*LAYOUT_CHUNK_ENTRIES){
+        u64 numOfChunks = (numOfEntries-round.firstEntry+LAYOUT_CHUNK_ENTRIES-1)/LAYOUT_CHUNK_ENTRIES;
+        if(numOfChunks>chunksPerRound)
+            numOfChunks = chunksPerRound;
+
+        // A table of a single chunk is formatted by the caller alone
+        if(numOfChunks>1)
+            pool_parallel_for(pool,numOfChunks,format_chunk,&round);
+        else
+            format_chunk(&round,0);
+
+        for(u64 i=0;i<numOfChunks;i++)
+            fwrite(round.buffers[i].bytes,1,round.buffers[i].used,display_output());
+    }
+
+    for(u64 i=0;i<chunksPerRound;i++)
+        free(round.buffers[i].bytes);
+    free(round.buffers);
+}
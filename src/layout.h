@@ -0,0 +1,85 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "./types.h"
+
+
+
+/* Kinds of the columns of a table */
+#define LAYOUT_HEX 0		/* "0x" and the hexadecimal digits, zero padded to the column's digits */
+#define LAYOUT_DEC 1		/* Unsigned decimal */
+#define LAYOUT_INT 2		/* Signed decimal */
+#define LAYOUT_STRING 3
+
+/* Longest header, and the bytes of a row rendered before they are written */
+#define LAYOUT_MAX_HEADER 256
+#define LAYOUT_ROW_BUFFER_SIZE 512
+
+#define LAYOUT_COUNT(columns) (sizeof(columns)/sizeof(columns[0]))
+
+/* Entries of a table formatted by one task, and the tasks of a round per thread of the pool.
+The buffers of a round are printed in order before the next round is formatted */
+#define LAYOUT_CHUNK_ENTRIES 4096
+#define LAYOUT_CHUNKS_PER_THREAD 2
+
+struct thread_pool;
+
+
+/* Column of a table */
+typedef struct layout_column{
+	const u8 * title;
+	u8 kind;		/* LAYOUT_* */
+	u8 width;		/* Width the column is padded to with spaces, 0 for none */
+	u8 digits;		/* Digits the hexadecimal numbers are zero padded to */
+}layout_column_t;
+
+
+/* Raw value of a column */
+typedef union layout_field{
+	u64 number;
+	s64 integer;
+	const u8 * string;
+}layout_field_t;
+
+
+/* Table layout compiled once, with its header rendered in or without color */
+typedef struct table_layout{
+	const layout_column_t * columns;
+	u32 numOfColumns;
+	u32 headerLength;
+	u8 header[LAYOUT_MAX_HEADER];
+}table_layout_t;
+
+
+/* Rows rendered in memory, growing as they are appended */
+typedef struct layout_buffer{
+	u8 * bytes;
+	u64 used;
+	u64 capacity;
+}layout_buffer_t;
+
+
+/* Render the rows of the entries [firstEntry,endEntry) of a table into a buffer, an entry can
+have any number of rows */
+typedef void (*layout_entries_fn)(void * context, u64 firstEntry, u64 endEntry, layout_buffer_t * buffer);
+
+
+
+/* Compile the layout of a table, the colors are decided by the display mode at this time */
+void layout_compile(table_layout_t * layout, const layout_column_t * columns, u32 numOfColumns);
+
+/* Print the header of a table */
+void layout_print_header(table_layout_t * layout);
+
+/* Render a row from the raw values of its columns and print it */
+void layout_print_row(table_layout_t * layout, const layout_field_t * fields);
+
+/* Render a row from the raw values of its columns into a buffer */
+void layout_render_row(table_layout_t * layout, const layout_field_t * fields, layout_buffer_t * buffer);
+
+/* Print the rows of a table's entries, formatted in chunks on the pool's threads and printed in
+the entries' order. The output is the same as formatting them in order, NULL for no pool */
+void layout_print_entries(struct thread_pool * pool, u64 numOfEntries, layout_entries_fn formatEntries, void * context);
+
+
+#endif
@@ -0,0 +1,392 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./layout.h"
+#include "./parse.h"
+#include "./demangle.h"
+#include "./pager.h"
+
+
+
+/* Rows of a page fitting in the terminal */
+static u64 terminal_page_rows(void){
+
+    struct winsize window;
+    if(ioctl(STDOUT_FILENO,TIOCGWINSZ,&window)<0 || window.ws_row<=PAGER_RESERVED_LINES*2)
+        return PAGER_DEFAULT_PAGE_ROWS;
+    return window.ws_row-PAGER_RESERVED_LINES;
+}
+
+
+/* Index where the relocations of every entry of a RELR table start, returns the number of relocations */
+static u64 index_relr_table(kvelf_basic_params_t * kvelfp, pager_table_t * table){
+
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+
+    u64 entriesSize;
+    u8 * entries = get_section_contents(kvelfp,table->sectionIdx,&entriesSize);
+    if(!entries || !(table->numOfRelrEntries=entriesSize/wordSize))
+        return 0;
+
+    table->relrEntries = malloc(table->numOfRelrEntries*sizeof(pager_relr_entry_t));
+    if(!table->relrEntries){
+        debug("Cannot allocate memory for the RELR entries\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    relr_cursor_t cursor;
+    relr_cursor_init(&cursor,entries,entriesSize,wordSize,ELF_NEEDS_SWAP(kvelfp->elfEncoding),0);
+
+    u64 numOfRows = 0;
+    for(u64 i=0;relr_cursor_next_entry(&cursor);i++){
+        table->relrEntries[i].firstRow = numOfRows;
+        table->relrEntries[i].where = cursor.base;
+        numOfRows += __builtin_popcountll(cursor.bitmap);
+    }
+
+    return numOfRows;
+}
+
+
+/* Free the tables of the previous listing */
+static void pager_reset(pager_t * pager){
+
+    for(u32 i=0;i<pager->numOfTables;i++)
+        free(pager->tables[i].relrEntries);
+    free(pager->tables);
+    pager->tables = NULL;
+    pager->numOfTables = 0;
+    pager->numOfRows = 0;
+    pager->firstRow = 0;
+}
+
+
+/* Find the table holding a row of the listing */
+static u32 find_table(pager_t * pager, u64 row){
+
+    u32 low = 0, high = pager->numOfTables;
+    while(high-low>1){
+        u32 middle = low+(high-low)/2;
+        if(pager->tables[middle].firstRow<=row)
+            low = middle;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+
+/* Print a symbol, decoded from its table in the mapped file */
+static void print_symbol_row(kvelf_basic_params_t * kvelfp, pager_t * pager, table_layout_t * layout, pager_table_t * table, u64 symbolIdx){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+
+    u64 symbolsSize, stringsSize, shndxSize=0;
+    u8 * symbols = get_section_contents(kvelfp,table->sectionIdx,&symbolsSize);
+    u32 stringsIdx = kvelfp->elfSectionsMetadata[table->sectionIdx].sLink;
+    u8 * strings = get_section_contents(kvelfp,stringsIdx,&stringsSize);
+
+    data_reader_t reader;
+    reader_init(&reader,symbols+symbolIdx*symbolSize,symbolSize,needsSwap);
+
+    u32 nameOffset = reader_u32(&reader);
+    u64 value, size;
+    u8 info, other;
+    u32 sectionIdx;
+
+    if(kvelfp->elfClass==ELFCLASS32){
+        value = reader_u32(&reader);
+        size = reader_u32(&reader);
+        info = reader_u8(&reader);
+        other = reader_u8(&reader);
+        sectionIdx = reader_u16(&reader);
+    }else{
+        info = reader_u8(&reader);
+        other = reader_u8(&reader);
+        sectionIdx = reader_u16(&reader);
+        value = reader_u64(&reader);
+        size = reader_u64(&reader);
+    }
+
+    // Section indexes which do not fit in st_shndx are in the SYMTAB_SHNDX table
+    u8 * shndx = table->shndxIdx ? get_section_contents(kvelfp,table->shndxIdx,&shndxSize) : NULL;
+    if(sectionIdx==SHN_XINDEX && shndx && symbolIdx<shndxSize/sizeof(u32)){
+        data_reader_t shndxReader;
+        reader_init(&shndxReader,shndx+symbolIdx*sizeof(u32),sizeof(u32),needsSwap);
+        sectionIdx = reader_u32(&shndxReader);
+    }
+
+    u8 * name = string_at(strings,stringsSize,nameOffset);
+    if(pager->demangle && *name)
+        name = demangle_symbol_name(kvelfp->demangleCache,kvelfp->elfSectionsMetadata[stringsIdx].sOffset+nameOffset,name);
+
+    layout_field_t fields[] = {{value}, {size}, {.string=get_elf_symbol_type(info&0xf)}, {.string=get_elf_symbol_binding(info >> 4)},
+                               {sectionIdx}, {.string=get_elf_symbol_visibility(other)}, {.string=name}};
+    layout_print_row(layout,fields);
+}
+
+
+/* Print a relocation of a REL or RELA table, decoded from the mapped file */
+static void print_relocation_row(kvelf_basic_params_t * kvelfp, table_layout_t * layout, pager_table_t * table, u64 entryIdx, u8 ** relocTable, u32 relocTableSize){
+
+    section_metadata_t * section = &kvelfp->elfSectionsMetadata[table->sectionIdx];
+    u8 hasAddend = table->type==SHT_RELA;
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+    u64 entrySize = wordSize*(hasAddend ? 3 : 2);
+
+    u64 entriesSize;
+    u8 * entries = get_section_contents(kvelfp,table->sectionIdx,&entriesSize);
+
+    data_reader_t reader;
+    reader_init(&reader,entries+entryIdx*entrySize,entrySize,ELF_NEEDS_SWAP(kvelfp->elfEncoding));
+
+    u64 offset = reader_uint(&reader,wordSize);
+    u64 info = reader_uint(&reader,wordSize);
+    u32 type = kvelfp->elfClass==ELFCLASS32 ? ELF32_R_TYPE(info) : ELF64_R_TYPE(info);
+    u64 symbolIdx = kvelfp->elfClass==ELFCLASS32 ? ELF32_R_SYM(info) : ELF64_R_SYM(info);
+
+    // The 32-bit addends are shown in 32 bits, as the full listing does
+    layout_field_t fields[] = {{offset}, {info}, {.string=get_elf_reloc_type(relocTable,relocTableSize,type)}, {symbolIdx},
+                               {section->sLink}, {section->sInfo}, {hasAddend ? reader_uint(&reader,wordSize) : 0}};
+    layout_print_row(layout,fields);
+}
+
+
+/* Print a relocation packed in a RELR table, its entry is found through the index of the table */
+static void print_relr_row(kvelf_basic_params_t * kvelfp, table_layout_t * layout, pager_table_t * table, u64 row, u8 * relativeType){
+
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+
+    // The last entry starting at or before the row, the entries without relocations are skipped over
+    u64 low = 0, high = table->numOfRelrEntries;
+    while(high-low>1){
+        u64 middle = low+(high-low)/2;
+        if(table->relrEntries[middle].firstRow<=row)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    u64 entriesSize;
+    u8 * entries = get_section_contents(kvelfp,table->sectionIdx,&entriesSize);
+    data_reader_t reader;
+    reader_init(&reader,entries+low*wordSize,wordSize,ELF_NEEDS_SWAP(kvelfp->elfEncoding));
+    u64 entry = reader_uint(&reader,wordSize);
+
+    u64 address = table->relrEntries[low].where;
+    if(entry & 1){
+        u64 bitmap = entry>>1;
+        for(u64 skipped=row-table->relrEntries[low].firstRow;skipped;skipped--)
+            bitmap &= bitmap-1;
+        address += __builtin_ctzll(bitmap)*wordSize;
+    }
+
+    layout_field_t fields[] = {{address}, {.string=relativeType}};
+    layout_print_row(layout,fields);
+}
+
+
+/* Print the title and the header of a table, compiling the layout of its rows */
+static void print_table_header(kvelf_basic_params_t * kvelfp, pager_table_t * table, table_layout_t * layout){
+
+    u8 * tableName = get_section_name(kvelfp,table->sectionIdx);
+
+    if(table->type==SHT_SYMTAB || table->type==SHT_DYNSYM){
+        fprintf(display_output(),"\nSymbols of section '%s' are: \n",tableName);
+        fprintf(display_output(),"-------------------------------\n");
+        if(kvelfp->elfClass==ELFCLASS32)
+            layout_compile(layout,symbols32Layout,LAYOUT_COUNT(symbols32Layout));
+        else
+            layout_compile(layout,symbols64Layout,LAYOUT_COUNT(symbols64Layout));
+    }else{
+        fprintf(display_output(),"\nRelocations of type '%s' in '%s': \n",get_elf_section_type(table->type),tableName);
+        if(table->type==SHT_REL)
+            layout_compile(layout,relocationsLayout,LAYOUT_COUNT(relocationsLayout));
+        else if(table->type==SHT_RELA)
+            layout_compile(layout,relocationsAddendLayout,LAYOUT_COUNT(relocationsAddendLayout));
+        else
+            layout_compile(layout,relrLayout,LAYOUT_COUNT(relrLayout));
+    }
+
+    layout_print_header(layout);
+}
+
+
+/* Show the page starting at the current row, only its rows are decoded */
+static void pager_show(kvelf_basic_params_t * kvelfp){
+
+    pager_t * pager = kvelfp->pager;
+
+    u32 relocTableSize;
+    u8 ** relocTable = get_elf_reloc_table(kvelfp->elfMachine,&relocTableSize);
+    u8 * relativeType = get_elf_reloc_type(relocTable,relocTableSize,get_elf_relative_reloc_type(kvelfp->elfMachine));
+
+    u64 lastRow = pager->firstRow+pager->pageRows;
+    if(lastRow>pager->numOfRows)
+        lastRow = pager->numOfRows;
+
+    table_layout_t layout;
+    u32 tableIdx = find_table(pager,pager->firstRow);
+    pager_table_t * table = &pager->tables[tableIdx];
+    print_table_header(kvelfp,table,&layout);
+
+    for(u64 row=pager->firstRow;row<lastRow;row++){
+
+        // Moving to the next table with rows, which gets its own header
+        while(row>=table->firstRow+table->numOfRows){
+            table = &pager->tables[++tableIdx];
+            if(table->numOfRows)
+                print_table_header(kvelfp,table,&layout);
+        }
+
+        u64 tableRow = row-table->firstRow;
+        if(table->type==SHT_SYMTAB || table->type==SHT_DYNSYM)
+            print_symbol_row(kvelfp,pager,&layout,table,tableRow);
+        else if(table->type==SHT_RELR)
+            print_relr_row(kvelfp,&layout,table,tableRow,relativeType);
+        else
+            print_relocation_row(kvelfp,&layout,table,tableRow,relocTable,relocTableSize);
+    }
+
+    u8 footer[128];
+    snprintf(footer,sizeof(footer),"\nRows %llu-%llu of %llu, next/prev/goto ROW\n",pager->firstRow,lastRow-1,pager->numOfRows);
+    display(footer,DISPLAY_COLOR_CYAN);
+}
+
+
+/* Add a table to the listing */
+static pager_table_t * add_table(pager_t * pager, u32 sectionIdx, u32 type){
+
+    pager_table_t * tables = realloc(pager->tables,(pager->numOfTables+1)*sizeof(pager_table_t));
+    if(!tables){
+        debug("Cannot allocate memory for the paged tables\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    pager->tables = tables;
+
+    pager_table_t * table = &tables[pager->numOfTables++];
+    memset(table,0,sizeof(pager_table_t));
+    table->sectionIdx = sectionIdx;
+    table->type = type;
+    table->firstRow = pager->numOfRows;
+    return table;
+}
+
+
+
+/* Start paging a listing and show its first page, returns 0 if the file cannot be paged */
+u8 pager_open(kvelf_basic_params_t * kvelfp, u8 listing, u8 demangle){
+
+    // Rows are decoded from the mapped file
+    if(!kvelfp->elfImage)
+        return 0;
+
+    if(!kvelfp->pager){
+        kvelfp->pager = calloc(1,sizeof(pager_t));
+        if(!kvelfp->pager){
+            debug("Cannot allocate memory for the pager\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+    }
+
+    pager_t * pager = kvelfp->pager;
+    pager_reset(pager);
+    pager->listing = listing;
+    pager->demangle = demangle;
+    pager->pageRows = terminal_page_rows();
+
+    if(demangle && !kvelfp->demangleCache)
+        kvelfp->demangleCache = demangle_cache_create();
+
+    // The number of rows of a table comes from its size, only the RELR tables are walked once
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+        u64 contentsSize;
+
+        if(!get_section_contents(kvelfp,i,&contentsSize))
+            continue;
+
+        if(listing==PAGER_LISTING_SYMBOLS && (section->sType==SHT_SYMTAB || section->sType==SHT_DYNSYM)){
+            if(section->sLink>=kvelfp->elfNumOfSections)
+                continue;
+            pager_table_t * table = add_table(pager,i,section->sType);
+            table->numOfRows = contentsSize/symbolSize;
+            for(u32 j=0;j<kvelfp->elfNumOfSections && !table->shndxIdx;j++)
+                if(kvelfp->elfSectionsMetadata[j].sType==SHT_SYMTAB_SHNDX && kvelfp->elfSectionsMetadata[j].sLink==i)
+                    table->shndxIdx = j;
+        }
+        else if(listing==PAGER_LISTING_RELOCATIONS && (section->sType==SHT_REL || section->sType==SHT_RELA)){
+            pager_table_t * table = add_table(pager,i,section->sType);
+            table->numOfRows = contentsSize/(wordSize*(section->sType==SHT_RELA ? 3 : 2));
+        }
+        else if(listing==PAGER_LISTING_RELOCATIONS && section->sType==SHT_RELR){
+            pager_table_t * table = add_table(pager,i,section->sType);
+            table->numOfRows = index_relr_table(kvelfp,table);
+        }
+        else
+            continue;
+
+        pager->numOfRows += pager->tables[pager->numOfTables-1].numOfRows;
+    }
+
+    if(!pager->numOfRows){
+        debug(listing==PAGER_LISTING_SYMBOLS ? "No symbols in this file\n" : "No relocations in this file\n",DEBUG_STATUS_INF);
+        return 1;
+    }
+
+    pager_show(kvelfp);
+    return 1;
+}
+
+
+/* Move through the listing being paged with "next", "prev" or "goto ROW" */
+void pager_command(kvelf_basic_params_t * kvelfp, u8 * command){
+
+    pager_t * pager = kvelfp->pager;
+    if(!pager || !pager->numOfRows){
+        debug("No listing is being paged, run lsym or lr first\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    u8 * savePtr;
+    u8 * word = strtok_r(command," \t\n",(char **)&savePtr);
+
+    if(strcmp(word,"next")==0){
+        if(pager->firstRow+pager->pageRows>=pager->numOfRows){
+            debug("Already at the last page\n",DEBUG_STATUS_INF);
+            return;
+        }
+        pager->firstRow += pager->pageRows;
+    }
+    else if(strcmp(word,"prev")==0){
+        if(!pager->firstRow){
+            debug("Already at the first page\n",DEBUG_STATUS_INF);
+            return;
+        }
+        pager->firstRow = pager->firstRow>pager->pageRows ? pager->firstRow-pager->pageRows : 0;
+    }
+    else{
+        u8 * rowString = strtok_r(NULL," \t\n",(char **)&savePtr);
+        u8 * end;
+        u64 row = rowString ? strtoull(rowString,(char **)&end,0) : 0;
+        if(!rowString || *end || row>=pager->numOfRows){
+            display_error("The row has to be below %llu\n",pager->numOfRows);
+            return;
+        }
+        pager->firstRow = row;
+    }
+
+    pager_show(kvelfp);
+}
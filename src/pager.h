@@ -0,0 +1,60 @@
+#ifndef PAGER_H
+#define PAGER_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Listings which can be paged */
+#define PAGER_LISTING_SYMBOLS 0
+#define PAGER_LISTING_RELOCATIONS 1
+
+/* Rows of a page when the height of the terminal is unknown */
+#define PAGER_DEFAULT_PAGE_ROWS 40
+
+/* Lines of a page taken by the titles, the headers, the footer and the prompt */
+#define PAGER_RESERVED_LINES 6
+
+
+
+/* RELR entry, its relocations follow the ones of the entries before it */
+typedef struct pager_relr_entry{
+	u64 firstRow;		/* Row of its first relocation in the table */
+	u64 where;			/* Address of the entry, or the address its bitmap starts at */
+}pager_relr_entry_t;
+
+
+/* Table of a listing, its rows follow the rows of the tables before it */
+typedef struct pager_table{
+	u32 sectionIdx;		/* Section of the table */
+	u32 type;			/* SHT_SYMTAB, SHT_DYNSYM, SHT_REL, SHT_RELA or SHT_RELR */
+	u32 shndxIdx;		/* SYMTAB_SHNDX section of a symbol table, 0 if it has none */
+	u64 firstRow;		/* Row of its first entry in the listing */
+	u64 numOfRows;
+	pager_relr_entry_t * relrEntries;	/* Entries of a RELR table, NULL for the other tables */
+	u64 numOfRelrEntries;
+}pager_table_t;
+
+
+/* Listing shown a page at a time, the rows are decoded only when they are shown */
+typedef struct pager{
+	u8 listing;				/* PAGER_LISTING_* */
+	u8 demangle;			/* Whether the symbols' names are demangled */
+	pager_table_t * tables;
+	u32 numOfTables;
+	u64 numOfRows;
+	u64 firstRow;			/* First row of the page shown */
+	u64 pageRows;			/* Rows of a page */
+}pager_t;
+
+
+
+/* Start paging a listing and show its first page, returns 0 if the file cannot be paged */
+u8 pager_open(kvelf_basic_params_t * kvelfp, u8 listing, u8 demangle);
+
+/* Move through the listing being paged with "next", "prev" or "goto ROW" */
+void pager_command(kvelf_basic_params_t * kvelfp, u8 * command);
+
+
+#endif
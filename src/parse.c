@@ -1,9 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
 #include "types.h"
 #include "./debug.h"
 #include "./elf.h"
 #include "./error.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./parse.h"
+#include "./layout.h"
+#include "./pool.h"
+#include "./kvelf.h"
+#include "./preparse.h"
 
 /* Parse ELF header */
 void parse_elf_header(FILE *fp, u32 elfHeaderOffset){
@@ -17,18 +26,18 @@ void parse_elf_header(FILE *fp, u32 elfHeaderOffset){
 		exit(ERROR_CANNOT_READ_FILE);
 	}
 
-    printf("\n");
+    fprintf(display_output(),"\n");
     display("Class: ",DISPLAY_COLOR_ORANGE);
-    printf("%s\n",get_elf_class_string(elfHeaderFirst16Bytes[EI_CLASS]));
+    fprintf(display_output(),"%s\n",get_elf_class_string(elfHeaderFirst16Bytes[EI_CLASS]));
     
     display("Encoding: ",DISPLAY_COLOR_ORANGE);
-    printf("%s\n",get_elf_dataencoding_string(elfHeaderFirst16Bytes[EI_DATA]));
+    fprintf(display_output(),"%s\n",get_elf_dataencoding_string(elfHeaderFirst16Bytes[EI_DATA]));
     
     display("ABI: ",DISPLAY_COLOR_ORANGE);
-    printf("%s\n",get_elf_abi_string(elfHeaderFirst16Bytes[EI_OSABI]));
+    fprintf(display_output(),"%s\n",get_elf_abi_string(elfHeaderFirst16Bytes[EI_OSABI]));
     
     display("ABI Ver: ",DISPLAY_COLOR_ORANGE);
-    printf("%d\n",elfHeaderFirst16Bytes[EI_ABIVERSION]);
+    fprintf(display_output(),"%d\n",elfHeaderFirst16Bytes[EI_ABIVERSION]);
 
 
     fseek(fp,elfHeaderOffset,SEEK_SET);
@@ -45,40 +54,47 @@ void parse_elf_header(FILE *fp, u32 elfHeaderOffset){
 
         else{
 
+            if(ELF_NEEDS_SWAP(elfHeaderFirst16Bytes[EI_DATA]))
+                elf_swap_ehdr32(&fileElf32H);
+
+            // Counts which do not fit in the header are held by the first section header
+            u32 numOfSections = fileElf32H.e_shnum, sectionNamesIdx = fileElf32H.e_shstrndx, numOfSegments = fileElf32H.e_phnum;
+            resolve_elf_extended_numbering(fp,ELFCLASS32,ELF_NEEDS_SWAP(elfHeaderFirst16Bytes[EI_DATA]),fileElf32H.e_shoff,&numOfSections,&sectionNamesIdx,&numOfSegments);
+
             display("Type: ",DISPLAY_COLOR_ORANGE);
-            printf("%s\n",get_elf_object_file_type(fileElf32H.e_type));
+            fprintf(display_output(),"%s\n",get_elf_object_file_type(fileElf32H.e_type));
             
             display("Machine: ",DISPLAY_COLOR_ORANGE);
-            printf("%s\n",get_elf_machine(fileElf32H.e_machine));
+            fprintf(display_output(),"%s\n",get_elf_machine(fileElf32H.e_machine));
            
             display("Entry: ",DISPLAY_COLOR_ORANGE);
-            printf("0x%016x\n",fileElf32H.e_entry);
+            fprintf(display_output(),"0x%016x\n",fileElf32H.e_entry);
 
             // Processing the sections
-            if (fileElf32H.e_shnum) {
+            if (numOfSections) {
                 display("Sections Table Address: ",DISPLAY_COLOR_ORANGE);
-                printf("0x%016x\n", fileElf32H.e_shoff);
+                fprintf(display_output(),"0x%016x\n", fileElf32H.e_shoff);
                 
                 display("Sections: ",DISPLAY_COLOR_ORANGE);
-                printf("%d of %d bytes\n", fileElf32H.e_shnum, fileElf32H.e_shentsize);
+                fprintf(display_output(),"%u of %d bytes\n", numOfSections, fileElf32H.e_shentsize);
                 
                 display("Sections' names table entry index: ",DISPLAY_COLOR_ORANGE);
-                printf("%d\n",fileElf32H.e_shstrndx);
+                fprintf(display_output(),"%u\n",sectionNamesIdx);
             } else{
                 display("Sections: ",DISPLAY_COLOR_ORANGE);
-                printf("0\n");
+                fprintf(display_output(),"0\n");
             }
             
             // Processing the segments
-            if (fileElf32H.e_phnum) {
+            if (numOfSegments) {
                 display("Segments Table Address: ",DISPLAY_COLOR_ORANGE);
-                printf("0x%016x\n", fileElf32H.e_phoff);
+                fprintf(display_output(),"0x%016x\n", fileElf32H.e_phoff);
 
                 display("Segments: ",DISPLAY_COLOR_ORANGE);
-                printf("%d of %d bytes \n", fileElf32H.e_phnum, fileElf32H.e_phentsize);
+                fprintf(display_output(),"%u of %d bytes \n", numOfSegments, fileElf32H.e_phentsize);
             } else{
                 display("Segments: ",DISPLAY_COLOR_ORANGE);
-                printf("0\n");
+                fprintf(display_output(),"0\n");
             }
         }
     }   else if (elfHeaderFirst16Bytes[EI_CLASS] == ELFCLASS64) {
@@ -89,61 +105,71 @@ void parse_elf_header(FILE *fp, u32 elfHeaderOffset){
             debug("Cannot read the ELF header from the file\n",DEBUG_STATUS_ERROR);
         else{
 
+            if(ELF_NEEDS_SWAP(elfHeaderFirst16Bytes[EI_DATA]))
+                elf_swap_ehdr64(&fileElf64H);
+
+            // Counts which do not fit in the header are held by the first section header
+            u32 numOfSections = fileElf64H.e_shnum, sectionNamesIdx = fileElf64H.e_shstrndx, numOfSegments = fileElf64H.e_phnum;
+            resolve_elf_extended_numbering(fp,ELFCLASS64,ELF_NEEDS_SWAP(elfHeaderFirst16Bytes[EI_DATA]),fileElf64H.e_shoff,&numOfSections,&sectionNamesIdx,&numOfSegments);
+
             display("Type: ",DISPLAY_COLOR_ORANGE);
-            printf("%s\n",get_elf_object_file_type(fileElf64H.e_type));
+            fprintf(display_output(),"%s\n",get_elf_object_file_type(fileElf64H.e_type));
            
             display("Machine: ",DISPLAY_COLOR_ORANGE);     
-            printf("%s\n",get_elf_machine(fileElf64H.e_machine));
+            fprintf(display_output(),"%s\n",get_elf_machine(fileElf64H.e_machine));
            
             display("Entry: ",DISPLAY_COLOR_ORANGE);
-            printf("0x%016lx\n",fileElf64H.e_entry);
+            fprintf(display_output(),"0x%016lx\n",fileElf64H.e_entry);
 
             // Processing the sections
-            if (fileElf64H.e_shnum) {
+            if (numOfSections) {
                 display("Sections Table Address: ",DISPLAY_COLOR_ORANGE);
-                printf("0x%016lx\n", fileElf64H.e_shoff);
+                fprintf(display_output(),"0x%016lx\n", fileElf64H.e_shoff);
                 
                 display("Sections: ",DISPLAY_COLOR_ORANGE);
-                printf("%d of %d bytes\n", fileElf64H.e_shnum, fileElf64H.e_shentsize);
+                fprintf(display_output(),"%u of %d bytes\n", numOfSections, fileElf64H.e_shentsize);
                           
                 display("Sections' names table entry index: ",DISPLAY_COLOR_ORANGE);
-                printf("%d\n",fileElf64H.e_shstrndx);
+                fprintf(display_output(),"%u\n",sectionNamesIdx);
            
             } else{
                 display("Sections: ",DISPLAY_COLOR_ORANGE);  
-                printf("0\n");
+                fprintf(display_output(),"0\n");
             }
 
             // Processing the segments
-            if (fileElf64H.e_phnum) {
+            if (numOfSegments) {
                 display("Segments Table Address: ",DISPLAY_COLOR_ORANGE);
-                printf("0x%016lx\n", fileElf64H.e_phoff);
+                fprintf(display_output(),"0x%016lx\n", fileElf64H.e_phoff);
                 
                 display("Segments: ",DISPLAY_COLOR_ORANGE);
-                printf("%d of %d bytes \n", fileElf64H.e_phnum, fileElf64H.e_phentsize);
+                fprintf(display_output(),"%u of %d bytes \n", numOfSegments, fileElf64H.e_phentsize);
             } else{
                 display("Segments: ",DISPLAY_COLOR_ORANGE);
 
-                printf("0\n");
+                fprintf(display_output(),"0\n");
             }
         }
     }
 
     display("File Version: ",DISPLAY_COLOR_ORANGE);
-    printf("%d\n",elfHeaderFirst16Bytes[EI_VERSION]);
-    printf("\n");
+    fprintf(display_output(),"%d\n",elfHeaderFirst16Bytes[EI_VERSION]);
+    fprintf(display_output(),"\n");
 
 }
 
 /* Parse ELF sections */
-void parse_elf_sections(FILE * fp ,u32 sectionsOffset, u32 numOfSections, u8 sectionNamesIdx, u8 elfClass){
+void parse_elf_sections(FILE * fp ,u32 sectionsOffset, u32 numOfSections, u32 sectionNamesIdx, u8 elfClass, u8 elfEncoding){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(elfEncoding);
 
-    printf("Flags: \n");
-    printf("(A)[Alloc] (W)[Write] (X)[Exec] (M)[Merge] (S)[Strings]\n");
-    printf("(I)[Info Link] (L)[Link Order] (N)[OS-Nonconforming] (G)[Group] (T)[TLS]\n");
-    printf("(C)[Compressed] (E)[Excluded] (R)[Required Special Ordering]\n");
-    printf("(O)[OS-MASK] (P)[Processor-MASK]\n");
-    printf("-------------------------------------------------------------\n");
+
+    fprintf(display_output(),"Flags: \n");
+    fprintf(display_output(),"(A)[Alloc] (W)[Write] (X)[Exec] (M)[Merge] (S)[Strings]\n");
+    fprintf(display_output(),"(I)[Info Link] (L)[Link Order] (N)[OS-Nonconforming] (G)[Group] (T)[TLS]\n");
+    fprintf(display_output(),"(C)[Compressed] (E)[Excluded] (R)[Required Special Ordering]\n");
+    fprintf(display_output(),"(O)[OS-MASK] (P)[Processor-MASK]\n");
+    fprintf(display_output(),"-------------------------------------------------------------\n");
 
     if(!sectionsOffset)
     	debug("No sections in this file\n",DEBUG_STATUS_INF);
@@ -155,11 +181,13 @@ void parse_elf_sections(FILE * fp ,u32 sectionsOffset, u32 numOfSections, u8 sec
 	    if (elfClass == ELFCLASS32){
 
             // Seeking to the section containing sections' names
-            fseek(fp,sectionsOffset + sectionNamesIdx * sizeof(Elf32_Shdr),SEEK_SET);
+            fseek(fp,sectionsOffset + (u64)sectionNamesIdx * sizeof(Elf32_Shdr),SEEK_SET);
             
             // Reading the section header string table entry
             Elf32_Shdr elf32Shdr;
             fread(&elf32Shdr,1,sizeof(Elf32_Shdr),fp);
+            if(needsSwap)
+                elf_swap_shdr32(&elf32Shdr);
             u8 * shStrings = malloc(elf32Shdr.sh_size);
 
             if (!shStrings)
@@ -183,35 +211,38 @@ void parse_elf_sections(FILE * fp ,u32 sectionsOffset, u32 numOfSections, u8 sec
                     if(fread(&elf32Shdr,1,sizeof(Elf32_Shdr),fp)!=sizeof(Elf32_Shdr))
                         debug("Cannot read section ---\n",DEBUG_STATUS_ERROR);
                     else{
-                        printf("(%d)-------%s--------\n",i,shStrings + elf32Shdr.sh_name);
+                        if(needsSwap)
+                            elf_swap_shdr32(&elf32Shdr);
+
+                        fprintf(display_output(),"(%d)-------%s--------\n",i,shStrings + elf32Shdr.sh_name);
                         display("    Type:  ",DISPLAY_COLOR_ORANGE);  
-                        printf("%s\n",get_elf_section_type(elf32Shdr.sh_type));
+                        fprintf(display_output(),"%s\n",get_elf_section_type(elf32Shdr.sh_type));
 
                         get_elf_section_flag(elf32Shdr.sh_flags,sectionFlags,16);
                         
                         display("    Flags:  ",DISPLAY_COLOR_ORANGE);
-                        printf("%s\n",sectionFlags);
+                        fprintf(display_output(),"%s\n",sectionFlags);
                         
                         display("    Address:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%016x\n",elf32Shdr.sh_addr);
+                        fprintf(display_output(),"0x%016x\n",elf32Shdr.sh_addr);
                         
                         display("    Offset:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%08x\n",elf32Shdr.sh_offset);
+                        fprintf(display_output(),"0x%08x\n",elf32Shdr.sh_offset);
 
                         display("    Size:  ",DISPLAY_COLOR_ORANGE);
-                        printf("%d(B)\n",elf32Shdr.sh_size);
+                        fprintf(display_output(),"%d(B)\n",elf32Shdr.sh_size);
                         
                         display("    Align:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%08x\n",elf32Shdr.sh_addralign);
+                        fprintf(display_output(),"0x%08x\n",elf32Shdr.sh_addralign);
                         
                         display("    Link:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%08x\n",elf32Shdr.sh_link);
+                        fprintf(display_output(),"0x%08x\n",elf32Shdr.sh_link);
                         
                         display("    Info:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%08x\n",elf32Shdr.sh_info);
+                        fprintf(display_output(),"0x%08x\n",elf32Shdr.sh_info);
                         
                         display("    EntSize:  ",DISPLAY_COLOR_ORANGE);
-                        printf("%d(B)\n",elf32Shdr.sh_entsize);
+                        fprintf(display_output(),"%d(B)\n",elf32Shdr.sh_entsize);
                     }
                 }
                 // Freeing the allocated memory for the section's names
@@ -222,11 +253,13 @@ void parse_elf_sections(FILE * fp ,u32 sectionsOffset, u32 numOfSections, u8 sec
 	    else if (elfClass == ELFCLASS64){
 
             // Seeking to the section containing sections' names
-            fseek(fp, sectionsOffset + sectionNamesIdx * sizeof(Elf64_Shdr),SEEK_SET);
+            fseek(fp, sectionsOffset + (u64)sectionNamesIdx * sizeof(Elf64_Shdr),SEEK_SET);
             
             // Reading the section header string table entry
             Elf64_Shdr elf64Shdr;
             fread(&elf64Shdr,1,sizeof(elf64Shdr),fp);
+            if(needsSwap)
+                elf_swap_shdr64(&elf64Shdr);
             u8 * shStrings = malloc(elf64Shdr.sh_size);
 
             if (!shStrings)
@@ -251,35 +284,38 @@ void parse_elf_sections(FILE * fp ,u32 sectionsOffset, u32 numOfSections, u8 sec
                     if(fread(&elf64Shdr,1,sizeof(Elf64_Shdr),fp)!=sizeof(Elf64_Shdr))
                         debug("Cannot read section ---\n",DEBUG_STATUS_ERROR);
                     else{
-                        printf("(%d)-------%s--------\n",i,shStrings + elf64Shdr.sh_name);
+                        if(needsSwap)
+                            elf_swap_shdr64(&elf64Shdr);
+
+                        fprintf(display_output(),"(%d)-------%s--------\n",i,shStrings + elf64Shdr.sh_name);
                         display("    Type:  ",DISPLAY_COLOR_ORANGE);  
-                        printf("%s\n",get_elf_section_type(elf64Shdr.sh_type));
+                        fprintf(display_output(),"%s\n",get_elf_section_type(elf64Shdr.sh_type));
 
                         get_elf_section_flag(elf64Shdr.sh_flags,sectionFlags,16);
                         
                         display("    Flags:  ",DISPLAY_COLOR_ORANGE);
-                        printf("%s\n",sectionFlags);
+                        fprintf(display_output(),"%s\n",sectionFlags);
                         
                         display("    Address:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%016lx\n",elf64Shdr.sh_addr);
+                        fprintf(display_output(),"0x%016lx\n",elf64Shdr.sh_addr);
                         
                         display("    Offset:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%08lx\n",elf64Shdr.sh_offset);
+                        fprintf(display_output(),"0x%08lx\n",elf64Shdr.sh_offset);
 
                         display("    Size:  ",DISPLAY_COLOR_ORANGE);
-                        printf("%ld(B)\n",elf64Shdr.sh_size);
+                        fprintf(display_output(),"%ld(B)\n",elf64Shdr.sh_size);
                         
                         display("    Align:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%08lx\n",elf64Shdr.sh_addralign);
+                        fprintf(display_output(),"0x%08lx\n",elf64Shdr.sh_addralign);
                         
                         display("    Link:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%08x\n",elf64Shdr.sh_link);
+                        fprintf(display_output(),"0x%08x\n",elf64Shdr.sh_link);
                         
                         display("    Info:  ",DISPLAY_COLOR_ORANGE);
-                        printf("0x%08x\n",elf64Shdr.sh_info);
+                        fprintf(display_output(),"0x%08x\n",elf64Shdr.sh_info);
                         
                         display("    EntSize:  ",DISPLAY_COLOR_ORANGE);
-                        printf("%ld(B)\n",elf64Shdr.sh_entsize);
+                        fprintf(display_output(),"%ld(B)\n",elf64Shdr.sh_entsize);
 
                     }
                 }
@@ -293,7 +329,7 @@ void parse_elf_sections(FILE * fp ,u32 sectionsOffset, u32 numOfSections, u8 sec
 
 
 /* Parse an ELF section */
-void parse_elf_section(FILE *fp, u32 sectionsOffset, u32 sectionIdx, u8 elfClass){
+void parse_elf_section(FILE *fp, u32 sectionsOffset, u32 sectionIdx, u8 elfClass, u8 elfEncoding){
 
     //TODO section name
 
@@ -303,67 +339,109 @@ void parse_elf_section(FILE *fp, u32 sectionsOffset, u32 sectionIdx, u8 elfClass
     if(elfClass==ELFCLASS32){
 
         // Seeking to the section metadata
-        fseek(fp,sectionsOffset+sectionIdx*sizeof(Elf32_Shdr),SEEK_SET);
+        fseek(fp,sectionsOffset+(u64)sectionIdx*sizeof(Elf32_Shdr),SEEK_SET);
 
         Elf32_Shdr elf32Shdr;
 
         if(fread(&elf32Shdr,1,sizeof(Elf32_Shdr),fp)!=sizeof(Elf32_Shdr))
             debug("Cannot read section ---\n",DEBUG_STATUS_ERROR);
         else{
-            printf("-------%d--------\n",elf32Shdr.sh_name);
-            printf("    Type:  %s\n",get_elf_section_type(elf32Shdr.sh_type));
+            if(ELF_NEEDS_SWAP(elfEncoding))
+                elf_swap_shdr32(&elf32Shdr);
+
+            fprintf(display_output(),"-------%d--------\n",elf32Shdr.sh_name);
+            fprintf(display_output(),"    Type:  %s\n",get_elf_section_type(elf32Shdr.sh_type));
 
             get_elf_section_flag(elf32Shdr.sh_flags,sectionFlags,16);
-            printf("    Flags:  %s\n",sectionFlags);
-            printf("    Address:  0x%016x\n",elf32Shdr.sh_addr);
-            printf("    Offset:  0x%08x\n",elf32Shdr.sh_offset);
-            printf("    Size:  %d(B)\n",elf32Shdr.sh_size);
-            printf("    Align:  0x%08x\n",elf32Shdr.sh_addralign);
-            printf("    Link:  0x%08x\n",elf32Shdr.sh_link);
-            printf("    Info:  0x%08x\n",elf32Shdr.sh_info);
-            printf("    EntSize: %d(B)\n",elf32Shdr.sh_entsize);
+            fprintf(display_output(),"    Flags:  %s\n",sectionFlags);
+            fprintf(display_output(),"    Address:  0x%016x\n",elf32Shdr.sh_addr);
+            fprintf(display_output(),"    Offset:  0x%08x\n",elf32Shdr.sh_offset);
+            fprintf(display_output(),"    Size:  %d(B)\n",elf32Shdr.sh_size);
+            fprintf(display_output(),"    Align:  0x%08x\n",elf32Shdr.sh_addralign);
+            fprintf(display_output(),"    Link:  0x%08x\n",elf32Shdr.sh_link);
+            fprintf(display_output(),"    Info:  0x%08x\n",elf32Shdr.sh_info);
+            fprintf(display_output(),"    EntSize: %d(B)\n",elf32Shdr.sh_entsize);
         }
 
     }else if(elfClass==ELFCLASS64){
 
         // Seeking to the section metadata
-        fseek(fp,sectionsOffset+sectionIdx*sizeof(Elf64_Shdr),SEEK_SET);
+        fseek(fp,sectionsOffset+(u64)sectionIdx*sizeof(Elf64_Shdr),SEEK_SET);
 
         Elf64_Shdr elf64Shdr;
 
         if(fread(&elf64Shdr,1,sizeof(Elf64_Shdr),fp)!=sizeof(Elf64_Shdr))
             debug("Cannot read section ---\n",DEBUG_STATUS_ERROR);
         else{
-            printf("-------%d--------\n",elf64Shdr.sh_name);
-            printf("    Type:  %s\n",get_elf_section_type(elf64Shdr.sh_type));
+            if(ELF_NEEDS_SWAP(elfEncoding))
+                elf_swap_shdr64(&elf64Shdr);
+
+            fprintf(display_output(),"-------%d--------\n",elf64Shdr.sh_name);
+            fprintf(display_output(),"    Type:  %s\n",get_elf_section_type(elf64Shdr.sh_type));
 
             get_elf_section_flag(elf64Shdr.sh_flags,sectionFlags,16);
-            printf("    Flags:  %s\n",sectionFlags);
-            printf("    Address:  0x%016lx\n",elf64Shdr.sh_addr);
-            printf("    Offset:  0x%08lx\n",elf64Shdr.sh_offset);
-            printf("    Size:  %ld(B)\n",elf64Shdr.sh_size);
-            printf("    Align:  0x%08lx\n",elf64Shdr.sh_addralign);
-            printf("    Link:  0x%08x\n",elf64Shdr.sh_link);
-            printf("    Info:  0x%08x\n",elf64Shdr.sh_info);
-            printf("    EntSize: %ld(B)\n",elf64Shdr.sh_entsize);
+            fprintf(display_output(),"    Flags:  %s\n",sectionFlags);
+            fprintf(display_output(),"    Address:  0x%016lx\n",elf64Shdr.sh_addr);
+            fprintf(display_output(),"    Offset:  0x%08lx\n",elf64Shdr.sh_offset);
+            fprintf(display_output(),"    Size:  %ld(B)\n",elf64Shdr.sh_size);
+            fprintf(display_output(),"    Align:  0x%08lx\n",elf64Shdr.sh_addralign);
+            fprintf(display_output(),"    Link:  0x%08x\n",elf64Shdr.sh_link);
+            fprintf(display_output(),"    Info:  0x%08x\n",elf64Shdr.sh_info);
+            fprintf(display_output(),"    EntSize: %ld(B)\n",elf64Shdr.sh_entsize);
         }
     }else
         debug("Invalid ELF class, cannot parse sections%x\n",DEBUG_STATUS_ERROR);
 }
 
 
+/* Columns of the segments' listing */
+static const layout_column_t segmentsLayout[] = {
+    {"Type",LAYOUT_STRING,16}, {"Offset",LAYOUT_HEX,20,16}, {"VirAddr",LAYOUT_HEX,20,16}, {"PhyAddr",LAYOUT_HEX,20,16},
+    {"fSize",LAYOUT_DEC,10}, {"mSize",LAYOUT_DEC,10}, {"Flags",LAYOUT_STRING,6}, {"Align",LAYOUT_HEX},
+};
+
+
+/* Columns of the symbols' listing, the values are as wide as the addresses of the class.
+The symbols' and the relocations' columns are shared with the pager */
+const layout_column_t symbols32Layout[] = {
+    {"Value",LAYOUT_HEX,12,8}, {"Size",LAYOUT_HEX,10}, {"Type",LAYOUT_STRING,12}, {"Binding",LAYOUT_STRING,10},
+    {"Index",LAYOUT_DEC,8}, {"Vis",LAYOUT_STRING,10}, {"Name",LAYOUT_STRING},
+};
+const layout_column_t symbols64Layout[] = {
+    {"Value",LAYOUT_HEX,20,16}, {"Size",LAYOUT_HEX,10}, {"Type",LAYOUT_STRING,12}, {"Binding",LAYOUT_STRING,10},
+    {"Index",LAYOUT_DEC,8}, {"Vis",LAYOUT_STRING,10}, {"Name",LAYOUT_STRING},
+};
+
+/* Columns of the relocations' listings */
+const layout_column_t relocationsLayout[] = {
+    {"Offset",LAYOUT_HEX,20,16}, {"Info",LAYOUT_HEX,20,16}, {"Type",LAYOUT_STRING,27}, {"SymIdx",LAYOUT_DEC,8},
+    {"SymTab",LAYOUT_DEC,15}, {"Target Section",LAYOUT_DEC,15},
+};
+const layout_column_t relocationsAddendLayout[] = {
+    {"Offset",LAYOUT_HEX,20,16}, {"Info",LAYOUT_HEX,20,16}, {"Type",LAYOUT_STRING,27}, {"SymIdx",LAYOUT_DEC,8},
+    {"SymTab",LAYOUT_DEC,15}, {"Target Section",LAYOUT_DEC,16}, {"Addend",LAYOUT_HEX},
+};
+const layout_column_t relrLayout[] = {
+    {"Offset",LAYOUT_HEX,20,16}, {"Type",LAYOUT_STRING},
+};
+static const layout_column_t relocationStatsLayout[] = {
+    {"Section",LAYOUT_DEC,10}, {"Type",LAYOUT_STRING,10}, {"Entries",LAYOUT_DEC,15}, {"Relocations",LAYOUT_DEC},
+};
+
+
 /* Parse ELF segments */
-void parse_elf_segments(FILE * fp ,u32 segmentOffset, u32 numOfSegments, u8 elfClass){
+void parse_elf_segments(FILE * fp ,u32 segmentOffset, u32 numOfSegments, u8 elfClass, u8 elfEncoding){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(elfEncoding);
 
 
 	if(!segmentOffset)
     	debug("No segments\n",DEBUG_STATUS_INF);
     else{
 
-        // Buffer for the headers
-        u8 headerBuffers[110];
-        sprintf(headerBuffers,"%-18s%-20s%-20s%-15s%-8s%-8s%-6s%-1s\n","Type", "Offset","VirAddr","PhyAddr","fSize","mSize","Flags","Align");
-        display(headerBuffers,DISPLAY_COLOR_ORANGE);
+        table_layout_t layout;
+        layout_compile(&layout,segmentsLayout,LAYOUT_COUNT(segmentsLayout));
+        layout_print_header(&layout);
 
         if (elfClass == ELFCLASS32) {
             // Seeking to the segments table
@@ -377,8 +455,12 @@ void parse_elf_segments(FILE * fp ,u32 segmentOffset, u32 numOfSegments, u8 elfC
 
             for ( u32 i=0 ; i<numOfSegments;i++ ){
                 fread(&elf32Phdr,1,sizeof(Elf32_Phdr),fp);
+                if(needsSwap)
+                    elf_swap_phdr32(&elf32Phdr);
                 get_elf_segment_flag(elf32Phdr.p_flags , segmentFlag , 10);
-                printf("%-12s0x%-18.016x0x%-18.016x0x%-20.016x%-8d%-8d%-6s0x%x\n",get_elf_segment_type(elf32Phdr.p_type),elf32Phdr.p_offset,elf32Phdr.p_vaddr,elf32Phdr.p_paddr,elf32Phdr.p_filesz,elf32Phdr.p_memsz,segmentFlag,elf32Phdr.p_align);
+                layout_field_t fields[] = {{.string=get_elf_segment_type(elf32Phdr.p_type)}, {elf32Phdr.p_offset}, {elf32Phdr.p_vaddr}, {elf32Phdr.p_paddr},
+                                           {elf32Phdr.p_filesz}, {elf32Phdr.p_memsz}, {.string=segmentFlag}, {elf32Phdr.p_align}};
+                layout_print_row(&layout,fields);
 
             }
         }
@@ -395,8 +477,12 @@ void parse_elf_segments(FILE * fp ,u32 segmentOffset, u32 numOfSegments, u8 elfC
 
             for ( u32 i=0 ; i<numOfSegments;i++ ){
                 fread(&elf64Phdr,1,sizeof(Elf64_Phdr),fp);
+                if(needsSwap)
+                    elf_swap_phdr64(&elf64Phdr);
                 get_elf_segment_flag(elf64Phdr.p_flags , segmentFlag , 10);
-                printf("%-12s0x%-18.016lx0x%-18.016lx0x%-20.016lx%-8ld%-8ld%-6s0x%lx\n", get_elf_segment_type(elf64Phdr.p_type),elf64Phdr.p_offset,elf64Phdr.p_vaddr,elf64Phdr.p_paddr,elf64Phdr.p_filesz,elf64Phdr.p_memsz,segmentFlag,elf64Phdr.p_align);
+                layout_field_t fields[] = {{.string=get_elf_segment_type(elf64Phdr.p_type)}, {elf64Phdr.p_offset}, {elf64Phdr.p_vaddr}, {elf64Phdr.p_paddr},
+                                           {elf64Phdr.p_filesz}, {elf64Phdr.p_memsz}, {.string=segmentFlag}, {elf64Phdr.p_align}};
+                layout_print_row(&layout,fields);
             }
         }
         else
@@ -405,109 +491,430 @@ void parse_elf_segments(FILE * fp ,u32 segmentOffset, u32 numOfSegments, u8 elfC
 }
 
 
-/* Parse ELF symbols */
-void parse_elf_symbols(FILE * fp , u32 symbolTableOffset , u8 elfClass){
+/* Read a table of the given size at the given offset of the file */
+u8 * read_elf_table(FILE * fp, u64 tableOffset, u64 tableSize){
 
+    u8 * table = malloc(tableSize ? tableSize : 1);
+
+    if (!table){
+        debug("Cannot allocate memory for the table\n",DEBUG_STATUS_ERROR);
+        return NULL;
+    }
+
+    fseek(fp,tableOffset,SEEK_SET);
+
+    if (fread(table,1,tableSize,fp) != tableSize){
+        debug("Cannot read the table from the file\n",DEBUG_STATUS_ERROR);
+        free(table);
+        return NULL;
+    }
+
+    return table;
+}
+
+
+/* Read the whole 32-bit section headers' table at once */
+Elf32_Shdr * read_elf_section_headers32(FILE * fp, u64 sectionsOffset, u32 numOfSections, u8 needsSwap){
+
+    Elf32_Shdr * elf32Shdrs = (Elf32_Shdr *)read_elf_table(fp,sectionsOffset,(u64)numOfSections * sizeof(Elf32_Shdr));
+
+    // Section headers are made of words only
+    if (elf32Shdrs && needsSwap)
+        elf_swap_words32((u32 *)elf32Shdrs,(u64)numOfSections * sizeof(Elf32_Shdr) / sizeof(u32));
+
+    return elf32Shdrs;
+}
+
+
+/* Read the whole 64-bit section headers' table at once */
+Elf64_Shdr * read_elf_section_headers64(FILE * fp, u64 sectionsOffset, u32 numOfSections, u8 needsSwap){
+
+    Elf64_Shdr * elf64Shdrs = (Elf64_Shdr *)read_elf_table(fp,sectionsOffset,(u64)numOfSections * sizeof(Elf64_Shdr));
+
+    if (elf64Shdrs && needsSwap)
+        for (u32 i=0; i<numOfSections; i++)
+            elf_swap_shdr64(&elf64Shdrs[i]);
+
+    return elf64Shdrs;
+}
 
-    // Setting the file pointer pointing to the first of the file
-    fseek(fp,0,SEEK_SET);
+
+/* Read the whole 32-bit segment headers' table at once */
+Elf32_Phdr * read_elf_segment_headers32(FILE * fp, u64 segmentsOffset, u32 numOfSegments, u8 needsSwap){
+
+    Elf32_Phdr * elf32Phdrs = (Elf32_Phdr *)read_elf_table(fp,segmentsOffset,(u64)numOfSegments * sizeof(Elf32_Phdr));
+
+    // Segment headers are made of words only
+    if (elf32Phdrs && needsSwap)
+        elf_swap_words32((u32 *)elf32Phdrs,(u64)numOfSegments * sizeof(Elf32_Phdr) / sizeof(u32));
+
+    return elf32Phdrs;
+}
+
+
+/* Read the whole 64-bit segment headers' table at once */
+Elf64_Phdr * read_elf_segment_headers64(FILE * fp, u64 segmentsOffset, u32 numOfSegments, u8 needsSwap){
+
+    Elf64_Phdr * elf64Phdrs = (Elf64_Phdr *)read_elf_table(fp,segmentsOffset,(u64)numOfSegments * sizeof(Elf64_Phdr));
+
+    if (elf64Phdrs && needsSwap)
+        for (u32 i=0; i<numOfSegments; i++)
+            elf_swap_phdr64(&elf64Phdrs[i]);
+
+    return elf64Phdrs;
+}
+
+
+/* Resolve the extended section numbering. When the real values do not fit in the ELF header,
+e_shnum is 0, e_shstrndx is SHN_XINDEX and e_phnum is PN_XNUM, and the values are held by
+sh_size, sh_link and sh_info of the first section header. */
+void resolve_elf_extended_numbering(FILE * fp, u8 elfClass, u8 needsSwap, u64 sectionsOffset, u32 * numOfSections, u32 * sectionNamesIdx, u32 * numOfSegments){
+
+    if (!sectionsOffset)
+        return;
+
+    if (*numOfSections && *sectionNamesIdx != SHN_XINDEX && *numOfSegments != PN_XNUM)
+        return;
+
+    u64 currOff = ftell(fp);
+    u64 firstSectionSize = 0;
+    u32 firstSectionLink = 0, firstSectionInfo = 0;
+
+    fseek(fp,sectionsOffset,SEEK_SET);
 
     if (elfClass == ELFCLASS32){
 
-        // Reading ELF header
-        Elf32_Ehdr elf32Ehdr;
-        fread(&elf32Ehdr,1,sizeof(Elf32_Ehdr),fp);
+        Elf32_Shdr elf32Shdr;
+        if (fread(&elf32Shdr,1,sizeof(Elf32_Shdr),fp) == sizeof(Elf32_Shdr)){
+            if (needsSwap)
+                elf_swap_shdr32(&elf32Shdr);
+            firstSectionSize = elf32Shdr.sh_size;
+            firstSectionLink = elf32Shdr.sh_link;
+            firstSectionInfo = elf32Shdr.sh_info;
+        }
+    }else if (elfClass == ELFCLASS64){
 
-        // Check if section headers table exist
-        if (! elf32Ehdr.e_shnum)
-            printf("[INFO] No sections exist in this file\n");
-        else {
+        Elf64_Shdr elf64Shdr;
+        if (fread(&elf64Shdr,1,sizeof(Elf64_Shdr),fp) == sizeof(Elf64_Shdr)){
+            if (needsSwap)
+                elf_swap_shdr64(&elf64Shdr);
+            firstSectionSize = elf64Shdr.sh_size;
+            firstSectionLink = elf64Shdr.sh_link;
+            firstSectionInfo = elf64Shdr.sh_info;
+        }
+    }
 
-            /*
-            * Seeking to the start of the section names.
-            */
-            fseek(fp, elf32Ehdr.e_shoff + elf32Ehdr.e_shentsize * elf32Ehdr.e_shstrndx, SEEK_SET);
+    if (!*numOfSections)
+        *numOfSections = firstSectionSize;
+    if (*sectionNamesIdx == SHN_XINDEX)
+        *sectionNamesIdx = firstSectionLink;
+    if (*numOfSegments == PN_XNUM)
+        *numOfSegments = firstSectionInfo;
 
+    fseek(fp,currOff,SEEK_SET);
+}
 
-            // Reading the section header string table entry
-            Elf32_Shdr elf32Shdr;
-            fread(&elf32Shdr, 1, sizeof(Elf32_Shdr), fp);
 
-            /*
-             * Allocating dynamic memory for the section header strings table
-             * based on the total size of the section
-             */
-            u8 *shStrings = malloc(elf32Shdr.sh_size);
+/* Get the tables lsym and lr list in the host's order, building them on the first call. Returns NULL
+if the file is not mapped, the listings then read their tables from the file */
+listing_tables_t * get_listing_tables(kvelf_basic_params_t * kvelfp){
 
-            if (!shStrings)
-                printf("[ERR] Cannot allocate memory for header names\n");
-            else {
+    preparse_wait(kvelfp,PREPARSE_LISTING_TABLES);
+    if (kvelfp->listingTables || !kvelfp->elfImage)
+        return kvelfp->listingTables;
 
-                // Seek to the section header strings by using the offset of the entry
-                fseek(fp, elf32Shdr.sh_offset, SEEK_SET);
+    listing_tables_t * listingTables = calloc(1,sizeof(listing_tables_t));
+    u8 ** tables = calloc(kvelfp->elfNumOfSections ? kvelfp->elfNumOfSections : 1,sizeof(u8 *));
+    u8 * owned = calloc(kvelfp->elfNumOfSections ? kvelfp->elfNumOfSections : 1,sizeof(u8));
+    if (!listingTables || !tables || !owned){
+        debug("Cannot allocate the tables of the listings\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
 
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u64 wordSize = kvelfp->elfClass == ELFCLASS32 ? sizeof(u32) : sizeof(u64);
 
-                // Reading the strings into the buffer allocated for the names
-                fread(shStrings, 1, elf32Shdr.sh_size, fp);
+    for (u32 i = 0; i < kvelfp->elfNumOfSections; i++){
+        u32 type = kvelfp->elfSectionsMetadata[i].sType;
+        if (type != SHT_SYMTAB && type != SHT_DYNSYM && type != SHT_SYMTAB_SHNDX && type != SHT_STRTAB &&
+            type != SHT_REL && type != SHT_RELA && type != SHT_RELR)
+            continue;
 
+        u64 contentsSize;
+        u8 * contents = get_section_contents(kvelfp,i,&contentsSize);
+        if (!contents)
+            continue;
 
-                // Looking for sections that are type of symbol table
+        // Strings and aligned tables in the host's order are listed right from the mapped file
+        if (type == SHT_STRTAB || (!needsSwap && (u64)contents % wordSize == 0)){
+            tables[i] = contents;
+            continue;
+        }
 
-                // Seeking to the start of the sections table
-                fseek(fp, elf32Ehdr.e_shoff, SEEK_SET);
+        u8 * table = malloc(contentsSize ? contentsSize : 1);
+        if (!table){
+            debug("Cannot allocate the tables of the listings\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+        memcpy(table,contents,contentsSize);
+
+        if (needsSwap){
+            if (type == SHT_SYMTAB_SHNDX)
+                elf_swap_words32((u32 *)table,contentsSize / sizeof(u32));
+            else if (type == SHT_SYMTAB || type == SHT_DYNSYM){
+                if (kvelfp->elfClass == ELFCLASS32)
+                    elf_swap_syms32((Elf32_Sym *)table,contentsSize / sizeof(Elf32_Sym));
+                else
+                    elf_swap_syms64((Elf64_Sym *)table,contentsSize / sizeof(Elf64_Sym));
+            }
+            else if (kvelfp->elfClass == ELFCLASS32)
+                elf_swap_words32((u32 *)table,contentsSize / sizeof(u32));
+            else
+                elf_swap_words64((u64 *)table,contentsSize / sizeof(u64));
+        }
 
+        tables[i] = table;
+        owned[i] = 1;
+    }
+
+    listingTables->tables = tables;
+    listingTables->owned = owned;
+    listingTables->numOfSections = kvelfp->elfNumOfSections;
+    kvelfp->listingTables = listingTables;
 
-                for (u32 i = 0; i < elf32Ehdr.e_shnum; i++) {
+    return listingTables;
+}
 
-                    fread(&elf32Shdr, 1, sizeof(Elf32_Shdr), fp);
 
-                    if (elf32Shdr.sh_type == SHT_SYMTAB || elf32Shdr.sh_type==SHT_DYNSYM) {
+/* Free the tables of the listings, the ones pointing into the mapped file are left to it */
+void listing_tables_free(listing_tables_t * listingTables){
 
-                        printf("\nSymbols of section '%s' are: \n",shStrings+elf32Shdr.sh_name);
-                        printf("-------------------------------\n");
+    if (!listingTables)
+        return;
 
+    for (u32 i = 0; i < listingTables->numOfSections; i++)
+        if (listingTables->owned[i])
+            free(listingTables->tables[i]);
+    free(listingTables->tables);
+    free(listingTables->owned);
+    free(listingTables);
+}
 
-                        /* Names of symbols are in string table section */
 
-                        // First reading strtab section
-                        Elf32_Shdr strtabSecHeader;
+/* Prebuilt table of a section, NULL if there is none and the listing reads it from the file */
+static u8 * prebuilt_table(listing_tables_t * tables, u32 sectionIdx){
 
-                        // Seeking to strtab section entry, link member contains the
-                        // index of strtab.
-                        fseek(fp,elf32Ehdr.e_shoff + elf32Ehdr.e_shentsize*elf32Shdr.sh_link ,SEEK_SET);
-                        fread(&strtabSecHeader,1,sizeof(Elf32_Shdr),fp);
+    return tables && sectionIdx < tables->numOfSections ? tables->tables[sectionIdx] : NULL;
+}
 
-                        // Reading symbols names into a buffer
-                        u8 * symbolsNames = malloc(strtabSecHeader.sh_size);
-                        fseek(fp,strtabSecHeader.sh_offset,SEEK_SET);
-                        fread(symbolsNames,1,strtabSecHeader.sh_size,fp);
 
+/* Demangle caches of the threads formatting a listing. A cache is used by one thread at a time,
+the caller's one first, and the threads which find them all busy get one of their own */
+typedef struct symbol_demanglers{
+    pthread_mutex_t lock;
+    demangle_cache_t * caches[POOL_MAX_THREADS];
+    u8 busy[POOL_MAX_THREADS];
+    u32 numOfCaches;
+}symbol_demanglers_t;
 
-                        // Seeking to the symbol table of the found section
-                        fseek(fp,elf32Shdr.sh_offset,SEEK_SET);
 
-                        // Symbol entry
-                        Elf32_Sym elf32Sym;
+/* Take an idle cache of a listing, or a new one if they are all busy */
+static demangle_cache_t * acquire_demangler(symbol_demanglers_t * demanglers){
 
-                        // Buffer for the headers
-                        u8 headerBuffers[110];
-                        sprintf(headerBuffers,"%-11s%-10s%-10s%-11s%-10s%-10s%-15s\n","   Value", "Size","Type","Binding","Index","Vis","Name");
-                        display(headerBuffers,DISPLAY_COLOR_ORANGE);
+    pthread_mutex_lock(&demanglers->lock);
+    u32 i = 0;
+    while (i < demanglers->numOfCaches && demanglers->busy[i])
+        i++;
+    if (i == demanglers->numOfCaches)
+        demanglers->caches[demanglers->numOfCaches++] = demangle_cache_create();
+    demanglers->busy[i] = 1;
+    pthread_mutex_unlock(&demanglers->lock);
 
+    return demanglers->caches[i];
+}
 
-                        // Number of symbols is total size divided by entry size
-                        for ( u32 i=0; i< elf32Shdr.sh_size / elf32Shdr.sh_entsize ;i++){
 
-                            fread(&elf32Sym,1,sizeof(Elf32_Sym),fp);
-                            printf("0x%-10.08x0x%-6.x%-12s%-10s%-8d%-10s%-25s\n",elf32Sym.st_value,elf32Sym.st_size,get_elf_symbol_type(elf32Sym.st_info&0xf),get_elf_symbol_binding(elf32Sym.st_info >> 4),elf32Sym.st_shndx,get_elf_symbol_visibility(elf32Sym.st_other),symbolsNames + elf32Sym.st_name);
+/* Give a cache back to the listing */
+static void release_demangler(symbol_demanglers_t * demanglers, demangle_cache_t * demangleCache){
 
-                        }
+    pthread_mutex_lock(&demanglers->lock);
+    for (u32 i = 0; i < demanglers->numOfCaches; i++)
+        if (demanglers->caches[i] == demangleCache)
+            demanglers->busy[i] = 0;
+    pthread_mutex_unlock(&demanglers->lock);
+}
 
-                        // Freeing allocated memory
-                        free(symbolsNames);
+
+/* Name a symbol is listed with, demangled names are memoized by their offset in the file */
+static u8 * symbol_display_name(demangle_cache_t * demangleCache, u64 strtabOffset, u8 * symbolsNames, u64 nameIdx){
+
+    if (!demangleCache)
+        return symbolsNames + nameIdx;
+    return demangle_symbol_name(demangleCache,strtabOffset + nameIdx,symbolsNames + nameIdx);
+}
+
+
+/* Symbol table being listed, its rows are formatted in chunks */
+typedef struct symbol_rows{
+    table_layout_t * layout;
+    u8 elfClass;
+    void * symbols;             /* Elf32_Sym or Elf64_Sym, in the host's order */
+    u32 * shndxTable;           /* Extended section indexes, NULL if the table has none */
+    u64 numOfShndx;
+    symbol_demanglers_t * demanglers;   /* NULL if the names are listed as they are */
+    u64 strtabOffset;
+    u8 * symbolsNames;
+}symbol_rows_t;
+
+
+/* Format the rows of the symbols [firstSymbol,endSymbol) */
+static void format_symbol_rows(void * context, u64 firstSymbol, u64 endSymbol, layout_buffer_t * buffer){
+
+    symbol_rows_t * rows = context;
+
+    // The chunk's names are demangled by one cache, the threads formatting the other chunks use their own
+    demangle_cache_t * demangleCache = rows->demanglers ? acquire_demangler(rows->demanglers) : NULL;
+
+    for (u64 j = firstSymbol; j < endSymbol; j++){
+        u64 value, size;
+        u32 nameIdx, symbolSectionIdx;
+        u8 info, other;
+
+        if (rows->elfClass == ELFCLASS32){
+            Elf32_Sym * elf32Sym = &((Elf32_Sym *)rows->symbols)[j];
+            value = elf32Sym->st_value, size = elf32Sym->st_size, nameIdx = elf32Sym->st_name;
+            info = elf32Sym->st_info, other = elf32Sym->st_other, symbolSectionIdx = elf32Sym->st_shndx;
+        } else {
+            Elf64_Sym * elf64Sym = &((Elf64_Sym *)rows->symbols)[j];
+            value = elf64Sym->st_value, size = elf64Sym->st_size, nameIdx = elf64Sym->st_name;
+            info = elf64Sym->st_info, other = elf64Sym->st_other, symbolSectionIdx = elf64Sym->st_shndx;
+        }
+
+        // Section indexes which do not fit in st_shndx are in the SYMTAB_SHNDX table
+        if (symbolSectionIdx == SHN_XINDEX && rows->shndxTable && j < rows->numOfShndx)
+            symbolSectionIdx = rows->shndxTable[j];
+
+        layout_field_t fields[] = {{value}, {size}, {.string=get_elf_symbol_type(info&0xf)},
+                                   {.string=get_elf_symbol_binding(info >> 4)}, {symbolSectionIdx}, {.string=get_elf_symbol_visibility(other)},
+                                   {.string=symbol_display_name(demangleCache,rows->strtabOffset,rows->symbolsNames,nameIdx)}};
+        layout_render_row(rows->layout,fields,buffer);
+    }
+
+    if (demangleCache)
+        release_demangler(rows->demanglers,demangleCache);
+}
+
+
+/* Parse ELF symbols, demangling their names through the cache unless it is NULL. The tables are
+the prebuilt ones unless tables is NULL, and the rows are formatted on the pool's threads unless it is NULL */
+void parse_elf_symbols(FILE * fp , listing_tables_t * tables , u8 elfClass, demangle_cache_t * demangleCache, thread_pool_t * pool){
+
+    // The demangler keeps its state in the cache, the threads which find it busy demangle
+    // through caches of their own, freed with the listing
+    symbol_demanglers_t demanglers = {.lock = PTHREAD_MUTEX_INITIALIZER, .caches = {demangleCache}, .numOfCaches = 1};
+
+
+    // Setting the file pointer pointing to the first of the file
+    fseek(fp,0,SEEK_SET);
+
+    if (elfClass == ELFCLASS32){
+
+        // Reading ELF header
+        Elf32_Ehdr elf32Ehdr;
+        fread(&elf32Ehdr,1,sizeof(Elf32_Ehdr),fp);
+
+        // Fields of the files in the foreign byte order are swapped right after reading
+        u8 needsSwap = ELF_NEEDS_SWAP(elf32Ehdr.e_ident[EI_DATA]);
+        if (needsSwap)
+            elf_swap_ehdr32(&elf32Ehdr);
+
+        u32 numOfSections = elf32Ehdr.e_shnum, sectionNamesIdx = elf32Ehdr.e_shstrndx, numOfSegments = elf32Ehdr.e_phnum;
+        resolve_elf_extended_numbering(fp,ELFCLASS32,needsSwap,elf32Ehdr.e_shoff,&numOfSections,&sectionNamesIdx,&numOfSegments);
+
+        // Check if section headers table exist
+        if (! numOfSections)
+            fprintf(display_output(),"[INFO] No sections exist in this file\n");
+        else {
+
+            // Reading the whole sections' table at once
+            Elf32_Shdr * elf32Shdrs = read_elf_section_headers32(fp,elf32Ehdr.e_shoff,numOfSections,needsSwap);
+
+            // Reading the section header string table
+            u8 *shStrings = (elf32Shdrs && sectionNamesIdx < numOfSections) ? read_elf_table(fp, elf32Shdrs[sectionNamesIdx].sh_offset, elf32Shdrs[sectionNamesIdx].sh_size) : NULL;
+
+            // Extended section indexes of the symbols are held by SYMTAB_SHNDX sections,
+            // every symbol table is mapped to its own in a single pass
+            u32 * symtabShndxIdx = calloc(numOfSections, sizeof(u32));
+            if (elf32Shdrs && symtabShndxIdx)
+                for (u32 i = 0; i < numOfSections; i++)
+                    if (elf32Shdrs[i].sh_type == SHT_SYMTAB_SHNDX && elf32Shdrs[i].sh_link < numOfSections)
+                        symtabShndxIdx[elf32Shdrs[i].sh_link] = i;
+
+            if (!shStrings || !symtabShndxIdx)
+                fprintf(display_output(),"[ERR] Cannot read the section headers and their names\n");
+            else {
+
+                // Looking for sections that are type of symbol table
+                for (u32 i = 0; i < numOfSections; i++) {
+
+                    Elf32_Shdr * elf32Shdr = &elf32Shdrs[i];
+
+                    if ((elf32Shdr->sh_type != SHT_SYMTAB && elf32Shdr->sh_type != SHT_DYNSYM) || elf32Shdr->sh_link >= numOfSections)
+                        continue;
+
+                    fprintf(display_output(),"\nSymbols of section '%s' are: \n",shStrings+elf32Shdr->sh_name);
+                    fprintf(display_output(),"-------------------------------\n");
+
+                    // Names of symbols are in the string table section the link member points to
+                    Elf32_Shdr * strtabSecHeader = &elf32Shdrs[elf32Shdr->sh_link];
+                    u8 * symbolsNames = prebuilt_table(tables,elf32Shdr->sh_link);
+                    u8 * prebuiltSyms = prebuilt_table(tables,i);
+                    if (!symbolsNames)
+                        symbolsNames = read_elf_table(fp,strtabSecHeader->sh_offset,strtabSecHeader->sh_size);
+
+                    // Reading the whole symbol table at once, so that foreign order
+                    // tables are swapped in bulk
+                    u64 numOfSymbols = elf32Shdr->sh_size / sizeof(Elf32_Sym);
+                    Elf32_Sym * elf32Syms = prebuiltSyms ? (Elf32_Sym *)prebuiltSyms : (Elf32_Sym *)read_elf_table(fp,elf32Shdr->sh_offset,numOfSymbols * sizeof(Elf32_Sym));
+
+                    // Reading the extended section indexes of the symbols, if any
+                    u32 * shndxTable = NULL, * prebuiltShndx = NULL;
+                    u64 numOfShndx = 0;
+                    if (symtabShndxIdx[i]){
+                        numOfShndx = elf32Shdrs[symtabShndxIdx[i]].sh_size / sizeof(u32);
+                        prebuiltShndx = (u32 *)prebuilt_table(tables,symtabShndxIdx[i]);
+                        shndxTable = prebuiltShndx ? prebuiltShndx : (u32 *)read_elf_table(fp,elf32Shdrs[symtabShndxIdx[i]].sh_offset,numOfShndx * sizeof(u32));
+                        if (shndxTable && needsSwap && !prebuiltShndx)
+                            elf_swap_words32(shndxTable,numOfShndx);
+                    }
+
+                    if (!elf32Syms || !symbolsNames)
+                        debug("Cannot read the symbol table\n",DEBUG_STATUS_ERROR);
+                    else {
+
+                        if (needsSwap && !prebuiltSyms)
+                            elf_swap_syms32(elf32Syms,numOfSymbols);
+
+                        table_layout_t layout;
+                        layout_compile(&layout,symbols32Layout,LAYOUT_COUNT(symbols32Layout));
+                        layout_print_header(&layout);
+
+                        symbol_rows_t rows = {&layout, ELFCLASS32, elf32Syms, shndxTable, numOfShndx, demangleCache ? &demanglers : NULL, strtabSecHeader->sh_offset, symbolsNames};
+                        layout_print_entries(pool,numOfSymbols,format_symbol_rows,&rows);
                     }
+
+                    // Freeing allocated memory, the prebuilt tables are kept for the next listings
+                    if (!prebuiltShndx)
+                        free(shndxTable);
+                    if (!prebuiltSyms)
+                        free(elf32Syms);
+                    if (!prebuilt_table(tables,elf32Shdr->sh_link))
+                        free(symbolsNames);
                 }
             }
+            free(symtabShndxIdx);
+            free(shStrings);
+            free(elf32Shdrs);
         }
 
     }
@@ -518,219 +925,424 @@ void parse_elf_symbols(FILE * fp , u32 symbolTableOffset , u8 elfClass){
         Elf64_Ehdr elf64Ehdr;
         fread(&elf64Ehdr,1,sizeof(Elf64_Ehdr),fp);
 
+        // Fields of the files in the foreign byte order are swapped right after reading
+        u8 needsSwap = ELF_NEEDS_SWAP(elf64Ehdr.e_ident[EI_DATA]);
+        if (needsSwap)
+            elf_swap_ehdr64(&elf64Ehdr);
+
+        u32 numOfSections = elf64Ehdr.e_shnum, sectionNamesIdx = elf64Ehdr.e_shstrndx, numOfSegments = elf64Ehdr.e_phnum;
+        resolve_elf_extended_numbering(fp,ELFCLASS64,needsSwap,elf64Ehdr.e_shoff,&numOfSections,&sectionNamesIdx,&numOfSegments);
+
         // Check if section headers table exist
-        if (! elf64Ehdr.e_shnum)
-            printf("[INFO] No sections exist in this file\n");
+        if (! numOfSections)
+            fprintf(display_output(),"[INFO] No sections exist in this file\n");
         else {
 
-            /*
-            * Seeking to the start of the section names.
-            */
-            fseek(fp, elf64Ehdr.e_shoff + elf64Ehdr.e_shentsize * elf64Ehdr.e_shstrndx, SEEK_SET);
+            // Reading the whole sections' table at once
+            Elf64_Shdr * elf64Shdrs = read_elf_section_headers64(fp,elf64Ehdr.e_shoff,numOfSections,needsSwap);
 
+            // Reading the section header string table
+            u8 *shStrings = (elf64Shdrs && sectionNamesIdx < numOfSections) ? read_elf_table(fp, elf64Shdrs[sectionNamesIdx].sh_offset, elf64Shdrs[sectionNamesIdx].sh_size) : NULL;
 
-            // Reading the section header string table entry
-            Elf64_Shdr elf64Shdr;
-            fread(&elf64Shdr, 1, sizeof(elf64Shdr), fp);
+            // Extended section indexes of the symbols are held by SYMTAB_SHNDX sections,
+            // every symbol table is mapped to its own in a single pass
+            u32 * symtabShndxIdx = calloc(numOfSections, sizeof(u32));
+            if (elf64Shdrs && symtabShndxIdx)
+                for (u32 i = 0; i < numOfSections; i++)
+                    if (elf64Shdrs[i].sh_type == SHT_SYMTAB_SHNDX && elf64Shdrs[i].sh_link < numOfSections)
+                        symtabShndxIdx[elf64Shdrs[i].sh_link] = i;
 
-            /*
-             * Allocating dynamic memory for the section header strings table
-             * based on the total size of the section
-             */
-            u8 *shStrings = malloc(elf64Shdr.sh_size);
-
-            if (!shStrings)
-                printf("[ERR] Cannot allocate memory for header names\n");
+            if (!shStrings || !symtabShndxIdx)
+                fprintf(display_output(),"[ERR] Cannot read the section headers and their names\n");
             else {
 
-                // Seek to the section header strings by using the offset of the entry
-                fseek(fp, elf64Shdr.sh_offset, SEEK_SET);
+                // Looking for sections that are type of symbol table
+                for (u32 i = 0; i < numOfSections; i++) {
+
+                    Elf64_Shdr * elf64Shdr = &elf64Shdrs[i];
+
+                    if ((elf64Shdr->sh_type != SHT_SYMTAB && elf64Shdr->sh_type != SHT_DYNSYM) || elf64Shdr->sh_link >= numOfSections)
+                        continue;
+
+                    fprintf(display_output(),"\nSymbols of section '%s' are: \n",shStrings+elf64Shdr->sh_name);
+                    fprintf(display_output(),"-------------------------------\n");
+
+                    // Names of symbols are in the string table section the link member points to
+                    Elf64_Shdr * strtabSecHeader = &elf64Shdrs[elf64Shdr->sh_link];
+                    u8 * symbolsNames = prebuilt_table(tables,elf64Shdr->sh_link);
+                    u8 * prebuiltSyms = prebuilt_table(tables,i);
+                    if (!symbolsNames)
+                        symbolsNames = read_elf_table(fp,strtabSecHeader->sh_offset,strtabSecHeader->sh_size);
+
+                    // Reading the whole symbol table at once, so that foreign order
+                    // tables are swapped in bulk
+                    u64 numOfSymbols = elf64Shdr->sh_size / sizeof(Elf64_Sym);
+                    Elf64_Sym * elf64Syms = prebuiltSyms ? (Elf64_Sym *)prebuiltSyms : (Elf64_Sym *)read_elf_table(fp,elf64Shdr->sh_offset,numOfSymbols * sizeof(Elf64_Sym));
+
+                    // Reading the extended section indexes of the symbols, if any
+                    u32 * shndxTable = NULL, * prebuiltShndx = NULL;
+                    u64 numOfShndx = 0;
+                    if (symtabShndxIdx[i]){
+                        numOfShndx = elf64Shdrs[symtabShndxIdx[i]].sh_size / sizeof(u32);
+                        prebuiltShndx = (u32 *)prebuilt_table(tables,symtabShndxIdx[i]);
+                        shndxTable = prebuiltShndx ? prebuiltShndx : (u32 *)read_elf_table(fp,elf64Shdrs[symtabShndxIdx[i]].sh_offset,numOfShndx * sizeof(u32));
+                        if (shndxTable && needsSwap && !prebuiltShndx)
+                            elf_swap_words32(shndxTable,numOfShndx);
+                    }
 
+                    if (!elf64Syms || !symbolsNames)
+                        debug("Cannot read the symbol table\n",DEBUG_STATUS_ERROR);
+                    else {
 
-                // Reading the strings into the buffer allocated for the names
-                fread(shStrings, 1, elf64Shdr.sh_size, fp);
+                        if (needsSwap && !prebuiltSyms)
+                            elf_swap_syms64(elf64Syms,numOfSymbols);
 
+                        table_layout_t layout;
+                        layout_compile(&layout,symbols64Layout,LAYOUT_COUNT(symbols64Layout));
+                        layout_print_header(&layout);
 
-                // Looking for sections that are type of symbol table
+                        symbol_rows_t rows = {&layout, ELFCLASS64, elf64Syms, shndxTable, numOfShndx, demangleCache ? &demanglers : NULL, strtabSecHeader->sh_offset, symbolsNames};
+                        layout_print_entries(pool,numOfSymbols,format_symbol_rows,&rows);
+                    }
 
-                // Seeking to the start of the sections table
-                fseek(fp, elf64Ehdr.e_shoff, SEEK_SET);
+                    // Freeing allocated memory, the prebuilt tables are kept for the next listings
+                    if (!prebuiltShndx)
+                        free(shndxTable);
+                    if (!prebuiltSyms)
+                        free(elf64Syms);
+                    if (!prebuilt_table(tables,elf64Shdr->sh_link))
+                        free(symbolsNames);
+                }
+            }
+            free(symtabShndxIdx);
+            free(shStrings);
+            free(elf64Shdrs);
+        }
+    }
+
+    else
+        fprintf(display_output(),"[ERR] Invalid ELF class 0x%x\n",elfClass);
+
+    for (u32 i = 1; i < demanglers.numOfCaches; i++)
+        demangle_cache_free(demanglers.caches[i]);
+}
 
 
-                for (u32 i = 0; i < elf64Ehdr.e_shnum; i++) {
+/* Read a whole relocation table, unless it is prebuilt. All the fields of REL, RELA and RELR entries
+have the word size of the class, so foreign order tables are swapped in bulk as plain words. */
+static u8 * read_relocation_table(FILE * fp, u8 * prebuiltEntries, u8 elfClass, u8 needsSwap, u64 relocationEntriesOffset, u64 sectionSize){
 
-                    fread(&elf64Shdr, 1, sizeof(Elf64_Shdr), fp);
+    if(prebuiltEntries)
+        return prebuiltEntries;
 
-                    // Storing the current offset
-                    u32 currOff=ftell(fp);
+    u8 * relocEntries = malloc(sectionSize);
 
-                    if ((elf64Shdr.sh_type == SHT_SYMTAB) || (elf64Shdr.sh_type==SHT_DYNSYM)) {
+    if(!relocEntries){
+        debug("Cannot allocate memory for the relocation entries\n",DEBUG_STATUS_ERROR);
+        return NULL;
+    }
 
-                        // //TODO, index of symbols
-                        printf("\nSymbols of section '%s' are: \n",shStrings+elf64Shdr.sh_name);
-                        printf("-------------------------------\n");
+    // Seeking to the given offset
+    fseek(fp,relocationEntriesOffset,SEEK_SET);
 
+    if(fread(relocEntries,1,sectionSize,fp)!=sectionSize){
+        debug("Cannot read the relocation entries\n",DEBUG_STATUS_ERROR);
+        free(relocEntries);
+        return NULL;
+    }
 
-                        /* Names of symbols are in string table section */
+    if(needsSwap){
+        if(elfClass == ELFCLASS32)
+            elf_swap_words32((u32 *)relocEntries, sectionSize / sizeof(u32));
+        else if(elfClass == ELFCLASS64)
+            elf_swap_words64((u64 *)relocEntries, sectionSize / sizeof(u64));
+    }
 
-                        // First reading strtab section
-                        Elf64_Shdr strtabSecHeader;
+    return relocEntries;
+}
 
-                        // Seeking to strtab section entry, link member contains the
-                        // index of strtab.
-                        fseek(fp,elf64Ehdr.e_shoff + elf64Ehdr.e_shentsize*elf64Shdr.sh_link ,SEEK_SET);
-                        fread(&strtabSecHeader,1,sizeof(Elf64_Shdr),fp);
 
-                        // Reading symbols names into a buffer
-                        u8 * symbolsNames = malloc(strtabSecHeader.sh_size);
-                        fseek(fp,strtabSecHeader.sh_offset,SEEK_SET);
-                        fread(symbolsNames,1,strtabSecHeader.sh_size,fp);
+/* Count the relocations packed in a RELR table without expanding them */
+static u64 count_relr_relocations(u8 * relrEntries, u64 sectionSize, u8 elfClass){
 
+    relr_cursor_t cursor;
+    relr_cursor_init(&cursor,relrEntries,sectionSize,elfClass == ELFCLASS32 ? sizeof(u32) : sizeof(u64),0,0);
 
-                        // Seeking to the symbol table of the found section
-                        fseek(fp,elf64Shdr.sh_offset,SEEK_SET);
+    u64 numOfRelocs = 0;
+    while(relr_cursor_next_entry(&cursor))
+        numOfRelocs += __builtin_popcountll(cursor.bitmap);
 
-                        // Symbol entry
-                        Elf64_Sym elf64Sym;
-                        u8 headerBuffers[110];
-                        sprintf(headerBuffers,"%-11s%-10s%-10s%-11s%-10s%-10s%-15s\n","   Value", "Size","Type","Binding","Index","Vis","Name");
-                        display(headerBuffers,DISPLAY_COLOR_ORANGE);
+    return numOfRelocs;
+}
 
-                        u8 symbolOther[10];
 
-                        // Number of symbols is total size divided by entry size
-                        for ( u32 i=0; i< elf64Shdr.sh_size / elf64Shdr.sh_entsize ;i++){
-                            fread(&elf64Sym,1,sizeof(Elf64_Sym),fp);
-                            printf("0x%-10.08lx0x%-6.lx%-12s%-10s%-8d%-10s%-25s\n",elf64Sym.st_value,elf64Sym.st_size,get_elf_symbol_type(elf64Sym.st_info&0xf),get_elf_symbol_binding(elf64Sym.st_info >> 4),elf64Sym.st_shndx,get_elf_symbol_visibility(elf64Sym.st_other),symbolsNames + elf64Sym.st_name);
-                        }
+/* RELR table being listed, its entries are expanded in chunks */
+typedef struct relr_rows{
+    table_layout_t * layout;
+    u8 elfClass;
+    u8 * relrEntries;           /* Entries in the host's order */
+    u8 * typeName;              /* Relative relocation type of the machine */
+}relr_rows_t;
 
-                        // Freeing allocated memory
-                        free(symbolsNames);
 
-                        // Restoring the previous offset
-                        fseek(fp,currOff,SEEK_SET);
-                    }
-                }
-            }
-        }
-    }
+/* Print a relocated address of a RELR table */
+static void print_relr_entry(table_layout_t * layout, u64 address, u8 * typeName, layout_buffer_t * buffer){
 
-    else
-        printf("[ERR] Invalid ELF class 0x%x\n",elfClass);
+    layout_field_t fields[] = {{address}, {.string=typeName}};
+    layout_render_row(layout,fields,buffer);
 }
 
 
-/* Extract entries of each relocation table */
-static void extract_relocation_entries(FILE * fp , u8 elfClass ,u64 relocationEntriesOffset, u64 sectionSize , u8 relocationType , u32 targetSymboTable, u32 targetSection ){
+/* Expand the RELR entries [firstEntry,endEntry), the cursor finds the address the chunk's first
+bitmap starts at from the entries before it */
+static void format_relr_rows(void * context, u64 firstEntry, u64 endEntry, layout_buffer_t * buffer){
+
+    relr_rows_t * rows = context;
+    u8 wordSize = rows->elfClass == ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+
+    relr_cursor_t cursor;
+    relr_cursor_init(&cursor,rows->relrEntries,endEntry * wordSize,wordSize,0,firstEntry);
+
+    u64 address;
+    while(relr_cursor_next(&cursor,&address))
+        print_relr_entry(rows->layout,address,rows->typeName,buffer);
+}
+
+
+/* Names of the relocation types of the file's machine, looked up once for all its tables */
+typedef struct reloc_type_names{
+    u8 ** names;                /* Names indexed by the type */
+    u32 numOfNames;
+    u8 * relativeName;          /* Relative relocation type, the type of every RELR relocation */
+}reloc_type_names_t;
+
+
+/* Look the relocation types' names of a machine up */
+static void get_reloc_type_names(u16 elfMachine, reloc_type_names_t * typeNames){
+
+    typeNames->names = get_elf_reloc_table(elfMachine, &typeNames->numOfNames);
+    typeNames->relativeName = get_elf_reloc_type(typeNames->names, typeNames->numOfNames, get_elf_relative_reloc_type(elfMachine));
+}
+
+
+/* Expand and list the relocations packed in a RELR table */
+static void extract_relr_entries(FILE * fp , u8 * prebuiltEntries , u8 elfClass , reloc_type_names_t * typeNames , u8 needsSwap ,u64 relrEntriesOffset, u64 sectionSize, thread_pool_t * pool){
 
     // Saving the current offset of the file pointer
     u64 currOff = ftell(fp);
 
-    // Number of relocation entries
-    u64 numEntries;
+    u8 * relrEntries = read_relocation_table(fp,prebuiltEntries,elfClass,needsSwap,relrEntriesOffset,sectionSize);
 
+    if(!relrEntries){
+        fseek(fp,currOff,SEEK_SET);
+        return;
+    }
 
+    table_layout_t layout;
+    layout_compile(&layout,relrLayout,LAYOUT_COUNT(relrLayout));
 
-    // Seeking to the given offset
-    fseek(fp,relocationEntriesOffset,SEEK_SET);
+    fprintf(display_output(),"Relocations of type 'RELR': \n");
+    layout_print_header(&layout);
 
-    u8 headerBuffers[120];
+    if(elfClass == ELFCLASS32 || elfClass == ELFCLASS64){
+        relr_rows_t rows = {&layout, elfClass, relrEntries, typeNames->relativeName};
+        layout_print_entries(pool,sectionSize / (elfClass == ELFCLASS32 ? sizeof(u32) : sizeof(u64)),format_relr_rows,&rows);
+    }
+    fprintf(display_output(),"\n");
 
+    if(relrEntries != prebuiltEntries)
+        free(relrEntries);
 
-    if (relocationType == SHT_REL ){
+    // Recovering back the offset
+    fseek(fp,currOff,SEEK_SET);
+}
 
-        printf("Relocations of type 'REL': \n");
-        sprintf(headerBuffers,"%-28s%-17s%-11s%-20s%s\n", "       Offset", "Info","Type","SymIdx in Sec","Target Section");
-        display(headerBuffers,DISPLAY_COLOR_ORANGE);
 
-        if ( elfClass == ELFCLASS32){
+/* Print the number of entries and relocations of a relocation table */
+static void count_relocation_entries(FILE * fp , u8 * prebuiltEntries , u8 elfClass , u8 needsSwap , u32 sectionIdx , u32 relocationType , u64 relocationEntriesOffset, u64 sectionSize){
 
-            Elf32_Rel elf32Rel;
-            numEntries = sectionSize / sizeof(Elf32_Rel);
+    u64 numEntries = 0, numOfRelocs = 0;
 
-            for( u32 i=0 ;i < numEntries; i++){
-                fread(&elf32Rel , 1 , sizeof(Elf32_Rel) , fp);
-                printf("0x%-18.016x0x%-18.016x%-19s%-8d%-15d%-15d\n", elf32Rel.r_offset, elf32Rel.r_info,get_elf_reloc_type(ELF32_R_TYPE(elf32Rel.r_info)),ELF32_R_SYM(elf32Rel.r_info),targetSymboTable,targetSection);
-            }
+    if(relocationType == SHT_REL)
+        numEntries = numOfRelocs = sectionSize / (elfClass == ELFCLASS32 ? sizeof(Elf32_Rel) : sizeof(Elf64_Rel));
+    else if(relocationType == SHT_RELA)
+        numEntries = numOfRelocs = sectionSize / (elfClass == ELFCLASS32 ? sizeof(Elf32_Rela) : sizeof(Elf64_Rela));
+    else if(relocationType == SHT_RELR){
+
+        // Packed relocations are only counted, never expanded
+        u64 currOff = ftell(fp);
+        u8 * relrEntries = read_relocation_table(fp,prebuiltEntries,elfClass,needsSwap,relocationEntriesOffset,sectionSize);
+
+        if(relrEntries){
+            numEntries = sectionSize / (elfClass == ELFCLASS32 ? sizeof(u32) : sizeof(u64));
+            numOfRelocs = count_relr_relocations(relrEntries,sectionSize,elfClass);
+            if(relrEntries != prebuiltEntries)
+                free(relrEntries);
         }
-        else if ( elfClass == ELFCLASS64){
+        fseek(fp,currOff,SEEK_SET);
+    }
 
-            Elf64_Rel elf64Rel;
-            numEntries = sectionSize / sizeof(Elf64_Rel);
+    table_layout_t layout;
+    layout_compile(&layout,relocationStatsLayout,LAYOUT_COUNT(relocationStatsLayout));
 
-            for( u32 i=0 ;i < numEntries; i++){
-                fread(&elf64Rel , 1 , sizeof(Elf64_Rel) , fp);
-                printf("0x%-18.016lx0x%-18.016lx%-19s%-8ld%-15d%-15d0x%x\n", elf64Rel.r_offset, elf64Rel.r_info,get_elf_reloc_type(ELF32_R_TYPE(elf64Rel.r_info)),ELF64_R_SYM(elf64Rel.r_info),targetSymboTable,targetSection);
-            }
+    layout_field_t fields[] = {{sectionIdx}, {.string=get_elf_section_type(relocationType)}, {numEntries}, {numOfRelocs}};
+    layout_print_row(&layout,fields);
+}
+
+
+/* REL or RELA table being listed, its rows are formatted in chunks */
+typedef struct relocation_rows{
+    table_layout_t * layout;
+    u8 elfClass;
+    u8 relocationType;          /* SHT_REL or SHT_RELA */
+    u8 * relocEntries;          /* Entries in the host's order */
+    u8 ** relocTable;           /* Relocation types' names of the machine */
+    u32 relocTableSize;
+    u32 targetSymboTable;
+    u32 targetSection;
+}relocation_rows_t;
+
+
+/* Format the rows of the relocations [firstEntry,endEntry) */
+static void format_relocation_rows(void * context, u64 firstEntry, u64 endEntry, layout_buffer_t * buffer){
+
+    relocation_rows_t * rows = context;
+
+    for( u64 i=firstEntry ;i < endEntry; i++){
+        u64 offset, info, addend = 0;
+        u32 type, symbolIdx;
+
+        // The REL entries are the RELA entries without their addend
+        if ( rows->elfClass == ELFCLASS32){
+            Elf32_Rela * elf32Rela = (Elf32_Rela *)(rows->relocEntries + i * (rows->relocationType == SHT_RELA ? sizeof(Elf32_Rela) : sizeof(Elf32_Rel)));
+            offset = elf32Rela->r_offset, info = elf32Rela->r_info;
+            type = ELF32_R_TYPE(elf32Rela->r_info), symbolIdx = ELF32_R_SYM(elf32Rela->r_info);
+            if (rows->relocationType == SHT_RELA)
+                addend = (u32)elf32Rela->r_addend;
+        }else{
+            Elf64_Rela * elf64Rela = (Elf64_Rela *)(rows->relocEntries + i * (rows->relocationType == SHT_RELA ? sizeof(Elf64_Rela) : sizeof(Elf64_Rel)));
+            offset = elf64Rela->r_offset, info = elf64Rela->r_info;
+            type = ELF64_R_TYPE(elf64Rela->r_info), symbolIdx = ELF64_R_SYM(elf64Rela->r_info);
+            if (rows->relocationType == SHT_RELA)
+                addend = elf64Rela->r_addend;
         }
-        printf("\n");
+
+        layout_field_t fields[] = {{offset}, {info}, {.string=get_elf_reloc_type(rows->relocTable,rows->relocTableSize,type)},
+                                   {symbolIdx}, {rows->targetSymboTable}, {rows->targetSection}, {addend}};
+        layout_render_row(rows->layout,fields,buffer);
     }
-    else if (relocationType == SHT_RELA ){
+}
 
-        printf("Relocations of type 'RELA': \n");
-        sprintf(headerBuffers,"%-28s%-17s%-11s%-20s%-20s%s\n", "       Offset", "Info","Type","SymIdx in Sec","Target Section","Addend");
-        display(headerBuffers,DISPLAY_COLOR_ORANGE);
-        
-        if ( elfClass == ELFCLASS32){
 
-            Elf32_Rela elf32Rela;
-            numEntries = sectionSize / sizeof(Elf32_Rela);
+/* Extract entries of each relocation table */
+static void extract_relocation_entries(FILE * fp , u8 * prebuiltEntries , u8 elfClass , reloc_type_names_t * typeNames , u8 needsSwap ,u64 relocationEntriesOffset, u64 sectionSize , u8 relocationType , u32 targetSymboTable, u32 targetSection, thread_pool_t * pool ){
 
+    // Saving the current offset of the file pointer
+    u64 currOff = ftell(fp);
 
-            for( u32 i=0 ;i < numEntries; i++){
-                fread(&elf32Rela , 1 , sizeof(Elf32_Rel) , fp);
-                printf("0x%-18.016x0x%-18.016x%-19s%-8d%-15d%-15d0x%x\n", elf32Rela.r_offset, elf32Rela.r_info,get_elf_reloc_type(elf32Rela.r_info&0xff),ELF32_R_SYM(elf32Rela.r_info),targetSymboTable,targetSection,elf32Rela.r_addend);
-            }
+    // Number of relocation entries
+    u64 numEntries;
+
+    // Reading the whole relocation table at once
+    u8 * relocEntries = read_relocation_table(fp,prebuiltEntries,elfClass,needsSwap,relocationEntriesOffset,sectionSize);
+
+    if(!relocEntries){
+        fseek(fp,currOff,SEEK_SET);
+        return;
+    }
+
+    table_layout_t layout;
+    relocation_rows_t rows = {&layout, elfClass, relocationType, relocEntries, typeNames->names, typeNames->numOfNames, targetSymboTable, targetSection};
+
+
+    if (relocationType == SHT_REL ){
+
+        fprintf(display_output(),"Relocations of type 'REL': \n");
+        layout_compile(&layout,relocationsLayout,LAYOUT_COUNT(relocationsLayout));
+        layout_print_header(&layout);
+
+        if ( elfClass == ELFCLASS32 || elfClass == ELFCLASS64){
+            numEntries = sectionSize / (elfClass == ELFCLASS32 ? sizeof(Elf32_Rel) : sizeof(Elf64_Rel));
+            layout_print_entries(pool,numEntries,format_relocation_rows,&rows);
         }
-        else if ( elfClass == ELFCLASS64){
+        fprintf(display_output(),"\n");
+    }
+    else if (relocationType == SHT_RELA ){
 
-            Elf64_Rela elf64Rela;
-            numEntries = sectionSize / sizeof(Elf64_Rela);
+        fprintf(display_output(),"Relocations of type 'RELA': \n");
+        layout_compile(&layout,relocationsAddendLayout,LAYOUT_COUNT(relocationsAddendLayout));
+        layout_print_header(&layout);
 
-            for( u32 i=0 ;i < numEntries; i++){
-                fread(&elf64Rela , 1 , sizeof(Elf64_Rela) , fp);
-                printf("0x%-18.016lx0x%-18.016lx%-19s%-8ld%-15d%-15d0x%lx\n", elf64Rela.r_offset, elf64Rela.r_info,get_elf_reloc_type(elf64Rela.r_info&0xff),ELF64_R_SYM(elf64Rela.r_info),targetSymboTable,targetSection,elf64Rela.r_addend);
-            }
+        if ( elfClass == ELFCLASS32 || elfClass == ELFCLASS64){
+            numEntries = sectionSize / (elfClass == ELFCLASS32 ? sizeof(Elf32_Rela) : sizeof(Elf64_Rela));
+            layout_print_entries(pool,numEntries,format_relocation_rows,&rows);
         }
-        printf("\n");
+        fprintf(display_output(),"\n");
     }
 
+    if(relocEntries != prebuiltEntries)
+        free(relocEntries);
+
     // Recovering back the offset
     fseek(fp,currOff,SEEK_SET);
 }
 
-/* Parse ELF relocations */
-void parse_elf_relocs(FILE * fp, u8 elfClass){
+/* Parse ELF relocations from the prebuilt tables unless tables is NULL, formatting their rows on the
+pool's threads unless it is NULL */
+void parse_elf_relocs(FILE * fp, listing_tables_t * tables, u8 elfClass, u8 statsOnly, thread_pool_t * pool){
 
     // Setting the file pointer pointing to the first of the file
     fseek(fp,0,SEEK_SET);
 
+    if (statsOnly){
+        table_layout_t layout;
+        layout_compile(&layout,relocationStatsLayout,LAYOUT_COUNT(relocationStatsLayout));
+        layout_print_header(&layout);
+    }
+
     if (elfClass == ELFCLASS32) {
 
         // Reading ELF header
         Elf32_Ehdr elf32Ehdr;
         fread(&elf32Ehdr,1,sizeof(Elf32_Ehdr),fp);
 
+        // Fields of the files in the foreign byte order are swapped right after reading
+        u8 needsSwap = ELF_NEEDS_SWAP(elf32Ehdr.e_ident[EI_DATA]);
+        if (needsSwap)
+            elf_swap_ehdr32(&elf32Ehdr);
+
+        u32 numOfSections = elf32Ehdr.e_shnum, sectionNamesIdx = elf32Ehdr.e_shstrndx, numOfSegments = elf32Ehdr.e_phnum;
+        resolve_elf_extended_numbering(fp,ELFCLASS32,needsSwap,elf32Ehdr.e_shoff,&numOfSections,&sectionNamesIdx,&numOfSegments);
+
+        // Reading the whole sections' table at once
+        Elf32_Shdr * elf32Shdrs = numOfSections ? read_elf_section_headers32(fp,elf32Ehdr.e_shoff,numOfSections,needsSwap) : NULL;
+
+        // The names of the machine's relocation types serve all the tables
+        reloc_type_names_t typeNames;
+        get_reloc_type_names(elf32Ehdr.e_machine,&typeNames);
+
         // Check if section headers table exist
-        if (! elf32Ehdr.e_shnum)
-            printf("[INFO] No sections exist in this file\n");
+        if (! elf32Shdrs)
+            fprintf(display_output(),"[INFO] No sections exist in this file\n");
         else {
 
-            // Seeking to the start of the sections' table
-            fseek(fp,elf32Ehdr.e_shoff,SEEK_SET);
-
 
-            // Looping through the sections and find those sections that are REL or RELA
-            Elf32_Shdr elf32Shdr;
+            // Looping through the sections and find those sections that are REL, RELA or RELR
+            for ( u32 i=0; i< numOfSections ; i++){
+                Elf32_Shdr elf32Shdr = elf32Shdrs[i];
 
+                if (elf32Shdr.sh_type!=SHT_REL && elf32Shdr.sh_type!=SHT_RELA && elf32Shdr.sh_type!=SHT_RELR)
+                    continue;
 
-            for ( u32 i=0; i< elf32Ehdr.e_shnum ; i++){
-                fread(&elf32Shdr,1,sizeof(Elf32_Shdr),fp);
-                
-                if (elf32Shdr.sh_type==SHT_REL || elf32Shdr.sh_type==SHT_RELA)
-                    extract_relocation_entries(fp,ELFCLASS32,elf32Shdr.sh_offset, elf32Shdr.sh_size ,elf32Shdr.sh_type,elf32Shdr.sh_link,elf32Shdr.sh_info);
+                if (statsOnly)
+                    count_relocation_entries(fp,prebuilt_table(tables,i),ELFCLASS32,needsSwap,i,elf32Shdr.sh_type,elf32Shdr.sh_offset,elf32Shdr.sh_size);
+                else if (elf32Shdr.sh_type==SHT_RELR)
+                    extract_relr_entries(fp,prebuilt_table(tables,i),ELFCLASS32,&typeNames,needsSwap,elf32Shdr.sh_offset,elf32Shdr.sh_size,pool);
+                else
+                    extract_relocation_entries(fp,prebuilt_table(tables,i),ELFCLASS32,&typeNames,needsSwap,elf32Shdr.sh_offset, elf32Shdr.sh_size ,elf32Shdr.sh_type,elf32Shdr.sh_link,elf32Shdr.sh_info,pool);
             }
 
+            free(elf32Shdrs);
         }
 
     } else  if (elfClass == ELFCLASS64) {
@@ -739,83 +1351,141 @@ void parse_elf_relocs(FILE * fp, u8 elfClass){
         Elf64_Ehdr elf64Ehdr;
         fread(&elf64Ehdr,1,sizeof(Elf64_Ehdr),fp);
 
+        // Fields of the files in the foreign byte order are swapped right after reading
+        u8 needsSwap = ELF_NEEDS_SWAP(elf64Ehdr.e_ident[EI_DATA]);
+        if (needsSwap)
+            elf_swap_ehdr64(&elf64Ehdr);
+
+        u32 numOfSections = elf64Ehdr.e_shnum, sectionNamesIdx = elf64Ehdr.e_shstrndx, numOfSegments = elf64Ehdr.e_phnum;
+        resolve_elf_extended_numbering(fp,ELFCLASS64,needsSwap,elf64Ehdr.e_shoff,&numOfSections,&sectionNamesIdx,&numOfSegments);
+
+        // Reading the whole sections' table at once
+        Elf64_Shdr * elf64Shdrs = numOfSections ? read_elf_section_headers64(fp,elf64Ehdr.e_shoff,numOfSections,needsSwap) : NULL;
+
+        // The names of the machine's relocation types serve all the tables
+        reloc_type_names_t typeNames;
+        get_reloc_type_names(elf64Ehdr.e_machine,&typeNames);
+
         // Check if section headers table exist
-        if (! elf64Ehdr.e_shnum)
-            printf("[INFO] No sections exist in this file\n");
+        if (! elf64Shdrs)
+            fprintf(display_output(),"[INFO] No sections exist in this file\n");
         else {
 
-            // Seeking to the start of the sections' table
-            fseek(fp,elf64Ehdr.e_shoff,SEEK_SET);
+            // Looping through the sections and find those sections that are REL, RELA or RELR
+            for ( u32 i=0; i< numOfSections ; i++){
+                Elf64_Shdr elf64Shdr = elf64Shdrs[i];
 
-            // Looping through the sections and find those sections that are REL or RELA
-            Elf64_Shdr elf64Shdr;
+                if (elf64Shdr.sh_type!=SHT_REL && elf64Shdr.sh_type!=SHT_RELA && elf64Shdr.sh_type!=SHT_RELR)
+                    continue;
 
-            for ( u32 i=0; i< elf64Ehdr.e_shnum ; i++){
-                fread(&elf64Shdr,1,sizeof(Elf64_Shdr),fp);
-
-                if (elf64Shdr.sh_type==SHT_REL || elf64Shdr.sh_type==SHT_RELA)
-                    extract_relocation_entries(fp,ELFCLASS64,elf64Shdr.sh_offset, elf64Shdr.sh_size ,elf64Shdr.sh_type,elf64Shdr.sh_link,elf64Shdr.sh_info);
+                if (statsOnly)
+                    count_relocation_entries(fp,prebuilt_table(tables,i),ELFCLASS64,needsSwap,i,elf64Shdr.sh_type,elf64Shdr.sh_offset,elf64Shdr.sh_size);
+                else if (elf64Shdr.sh_type==SHT_RELR)
+                    extract_relr_entries(fp,prebuilt_table(tables,i),ELFCLASS64,&typeNames,needsSwap,elf64Shdr.sh_offset,elf64Shdr.sh_size,pool);
+                else
+                    extract_relocation_entries(fp,prebuilt_table(tables,i),ELFCLASS64,&typeNames,needsSwap,elf64Shdr.sh_offset, elf64Shdr.sh_size ,elf64Shdr.sh_type,elf64Shdr.sh_link,elf64Shdr.sh_info,pool);
             }
+
+            free(elf64Shdrs);
         }
 
     } else
-        printf("[ERR] Invalid ELF class 0x%x\n",elfClass);
+        fprintf(display_output(),"[ERR] Invalid ELF class 0x%x\n",elfClass);
 
 }
 
+/* Digits of every byte value, two characters per byte, filled on the first dump */
+static u8 rawBytesHexPairs[256][2];
+static pthread_once_t rawBytesHexPairsOnce = PTHREAD_ONCE_INIT;
 
-/* This function simply dumps the given number of raw bytes */
-void pe_parse_raw_bytes(FILE *fp, u64 rawBytesOffset, u32 nofRawBytes){
 
-    fseek(fp,rawBytesOffset,SEEK_SET);
+static void fill_raw_bytes_hex_pairs(void){
+
+    static const u8 hexDigits[16] = "0123456789abcdef";
 
-    // Allocate buffer for reading the raw bytes
-    u8 * rawBytesBuff = malloc(nofRawBytes);
+    for(u32 i=0;i<256;i++){
+        rawBytesHexPairs[i][0] = hexDigits[i>>4];
+        rawBytesHexPairs[i][1] = hexDigits[i&0xf];
+    }
+}
 
 
-    if(!rawBytesBuff){
+/* Render a line of the dump, a short last line is padded so that its ASCII column lines up */
+static u8 * render_raw_bytes_line(u8 * out, u64 offset, u8 * bytes, u32 count){
+
+    for(s32 shift=56;shift>=0;shift-=8){
+        memcpy(out,rawBytesHexPairs[(offset>>shift)&0xff],2);
+        out += 2;
+    }
+    *out++ = ':';
+    *out++ = ' ';
+
+    for(u32 i=0;i<count;i++){
+        memcpy(out,rawBytesHexPairs[bytes[i]],2);
+        out[2] = ' ';
+        out += 3;
+    }
+    memset(out,' ',(RAW_BYTES_PER_LINE-count)*3);
+    out += (RAW_BYTES_PER_LINE-count)*3;
+    *out++ = '\t';
+
+    // Unprintable bytes keep their column as a dot
+    for(u32 i=0;i<count;i++)
+        *out++ = (bytes[i]>=32 && bytes[i]<=126) ? bytes[i] : '.';
+    *out++ = '\n';
+
+    return out;
+}
+
+
+/* This function simply dumps the given number of raw bytes, streamed through fixed buffers
+so that any range of the file can be dumped */
+void pe_parse_raw_bytes(FILE *fp, u64 rawBytesOffset, u64 nofRawBytes){
+
+    // The server's threads may dump at the same time
+    pthread_once(&rawBytesHexPairsOnce,fill_raw_bytes_hex_pairs);
+
+    // The lines rendered from a read fill the output buffer, which is written whenever it is full
+    u8 * readBuffer = malloc(RAW_BYTES_READ_SIZE + RAW_BYTES_OUTPUT_SIZE);
+    if(!readBuffer){
         debug("Cannot dump raw bytes (MemoryAllocError!)\n",DEBUG_STATUS_ERROR);
-    }else{
+        return;
+    }
+    u8 * outputBuffer = readBuffer + RAW_BYTES_READ_SIZE;
+    u8 * out = outputBuffer;
 
-        if(fread(rawBytesBuff , 1, nofRawBytes ,fp) != nofRawBytes ){
-            debug("Cannot read raw bytes from the file\n",DEBUG_STATUS_ERROR);
-        }else{
-            printf("\t\t    -------\t\t\t\t\t\t    -------\n");
-            printf("\t\t    |Bytes|\t\t\t\t\t\t    |ASCII|\n");
-            printf("\t\t    -------\t\t\t\t\t\t    -------\n");
+    fseek(fp,rawBytesOffset,SEEK_SET);
 
+    fprintf(display_output(),"\t\t    -------\t\t\t\t\t\t    -------\n");
+    fprintf(display_output(),"\t\t    |Bytes|\t\t\t\t\t\t    |ASCII|\n");
+    fprintf(display_output(),"\t\t    -------\t\t\t\t\t\t    -------\n");
 
-            // TODO bug of ASCII print if bytes are less than 16
-            for(u32 i=0;i<nofRawBytes;i++){
-                if(i%16==0)
-                    printf("%016llx: ",rawBytesOffset);        
-                printf("%02x ",rawBytesBuff[i]);
-                
-                if((i+1)%16==0){
-                    printf("\t");
-                    for(u32 j=-15;i+j<=i;j++){
-                        // Print only printable characters
-                        if(rawBytesBuff[i+j]>=32 && rawBytesBuff[i+j]<=126)
-                            printf("%c ",rawBytesBuff[i+j]);
-                    }
-                    printf("\n");
-                    rawBytesOffset+=16;
-                }
-            }
-            if(nofRawBytes<16){
-                printf("\t\t\t\t\t\t\t");
-                for(u32 i=0;i<nofRawBytes;i++){
-                    // Print only printable characters
-                    if(rawBytesBuff[i]>=32 && rawBytesBuff[i]<=126)
-                        printf("%c ",rawBytesBuff[i]);
-                    
-                }
-                printf("\n");
+    u64 remaining = nofRawBytes;
+    while(remaining){
+        u64 wanted = remaining<RAW_BYTES_READ_SIZE ? remaining : RAW_BYTES_READ_SIZE;
+        u64 read = fread(readBuffer,1,wanted,fp);
+
+        for(u64 i=0;i<read;i+=RAW_BYTES_PER_LINE){
+            if(out-outputBuffer>RAW_BYTES_OUTPUT_SIZE-RAW_BYTES_LINE_LENGTH){
+                fwrite(outputBuffer,1,out-outputBuffer,display_output());
+                out = outputBuffer;
             }
-            printf("\n");
+            out = render_raw_bytes_line(out,rawBytesOffset+i,readBuffer+i,read-i<RAW_BYTES_PER_LINE ? read-i : RAW_BYTES_PER_LINE);
         }
-        free(rawBytesBuff);
+
+        rawBytesOffset += read;
+        remaining -= read;
+        if(read<wanted)
+            break;
     }
+
+    fwrite(outputBuffer,1,out-outputBuffer,display_output());
+    fprintf(display_output(),"\n");
+
+    if(remaining)
+        debug("The file ends before the last bytes of the range\n",DEBUG_STATUS_WARNING);
+
+    free(readBuffer);
 }
 
 
@@ -1,27 +1,87 @@
 #ifndef PARSE_H
 #define PARSE_H
 
+#include <stdio.h>
 #include "types.h"
+#include "./elf.h"
+#include "./demangle.h"
+#include "./layout.h"
+#include "./pool.h"
+#include "./kvelf.h"
+
+
+/* Bytes of a line of the raw bytes' dump, and the longest line with its offset, its bytes and their ASCII */
+#define RAW_BYTES_PER_LINE 16
+#define RAW_BYTES_LINE_LENGTH (16+2+RAW_BYTES_PER_LINE*3+1+RAW_BYTES_PER_LINE+1)
+
+/* Bytes read at once by the dump, a multiple of the line, and bytes of the lines written at once */
+#define RAW_BYTES_READ_SIZE 65536
+#define RAW_BYTES_OUTPUT_SIZE 65536
+
+
+/* Columns of the symbols' and the relocations' listings */
+extern const layout_column_t symbols32Layout[7];
+extern const layout_column_t symbols64Layout[7];
+extern const layout_column_t relocationsLayout[6];
+extern const layout_column_t relocationsAddendLayout[7];
+extern const layout_column_t relrLayout[2];
+
+
+/* Symbol, string and relocation tables of the listings in the host's order, by section index */
+typedef struct listing_tables{
+	u8 ** tables;		/* Contents of the sections, NULL for the other sections and those which cannot be read */
+	u8 * owned;			/* Whether a table is a swapped copy, the others are in the mapped file */
+	u32 numOfSections;
+}listing_tables_t;
+
+
+/* Get the tables lsym and lr list in the host's order, building them on the first call. Returns NULL
+if the file is not mapped, the listings then read their tables from the file */
+listing_tables_t * get_listing_tables(kvelf_basic_params_t * kvelfp);
+
+/* Free the tables of the listings, the ones pointing into the mapped file are left to it */
+void listing_tables_free(listing_tables_t * listingTables);
 
 /* Parse ELF header */
 void parse_elf_header(FILE *fp, u32 elfHeaderOffset);
 
 /* Parse ELF sections */
-void parse_elf_sections(FILE * fp ,u32 sectionOffset, u32 numOfSections, u8 sectionNamesIdx, u8 elfClass);
+void parse_elf_sections(FILE * fp ,u32 sectionOffset, u32 numOfSections, u32 sectionNamesIdx, u8 elfClass, u8 elfEncoding);
 
 /* Parse ELF segments */
-void parse_elf_segments(FILE * fp ,u32 segmentOffset, u32 numOfSegments, u8 elfClass);
+void parse_elf_segments(FILE * fp ,u32 segmentOffset, u32 numOfSegments, u8 elfClass, u8 elfEncoding);
 
-/* Parse ELF symbols */
-void parse_elf_symbols(FILE * fp , u32 symbolTableOffset , u8 elfClass);
+/* Parse ELF symbols, demangling their names through the cache unless it is NULL. The tables are
+the prebuilt ones unless tables is NULL, and the rows are formatted on the pool's threads unless it is NULL */
+void parse_elf_symbols(FILE * fp , listing_tables_t * tables , u8 elfClass, demangle_cache_t * demangleCache, thread_pool_t * pool);
 
-/* Parse ELF relocations */
-void parse_elf_relocs(FILE * fp, u8 elfClass);
+/* Parse ELF relocations, or only count them per relocation table if statsOnly is set. The tables are
+the prebuilt ones unless tables is NULL, and the rows are formatted on the pool's threads unless it is NULL */
+void parse_elf_relocs(FILE * fp, listing_tables_t * tables, u8 elfClass, u8 statsOnly, thread_pool_t * pool);
 
-/* This function simply dumps the given number of raw bytes */
-void pe_parse_raw_bytes(FILE *fp, u64 rawBytesOffset, u32 nofRawBytes);
+/* This function simply dumps the given number of raw bytes, streamed through fixed buffers
+so that any range of the file can be dumped */
+void pe_parse_raw_bytes(FILE *fp, u64 rawBytesOffset, u64 nofRawBytes);
 
 /* Parse an ELF section */
-void parse_elf_section(FILE *fp, u32 sectionsOffset, u32 sectionIdx, u8 elfClass);
+void parse_elf_section(FILE *fp, u32 sectionsOffset, u32 sectionIdx, u8 elfClass, u8 elfEncoding);
+
+/* Read a table of the given size at the given offset of the file */
+u8 * read_elf_table(FILE * fp, u64 tableOffset, u64 tableSize);
+
+/* Read the whole 32-bit section headers' table at once */
+Elf32_Shdr * read_elf_section_headers32(FILE * fp, u64 sectionsOffset, u32 numOfSections, u8 needsSwap);
+
+/* Read the whole 64-bit section headers' table at once */
+Elf64_Shdr * read_elf_section_headers64(FILE * fp, u64 sectionsOffset, u32 numOfSections, u8 needsSwap);
+
+/* Read the whole 32-bit segment headers' table at once */
+Elf32_Phdr * read_elf_segment_headers32(FILE * fp, u64 segmentsOffset, u32 numOfSegments, u8 needsSwap);
+
+/* Read the whole 64-bit segment headers' table at once */
+Elf64_Phdr * read_elf_segment_headers64(FILE * fp, u64 segmentsOffset, u32 numOfSegments, u8 needsSwap);
+
+/* Resolve the extended section numbering of the counts read from the ELF header */
+void resolve_elf_extended_numbering(FILE * fp, u8 elfClass, u8 needsSwap, u64 sectionsOffset, u32 * numOfSections, u32 * sectionNamesIdx, u32 * numOfSegments);
 
 #endif
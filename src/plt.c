@@ -0,0 +1,419 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./disasm.h"
+#include "./layout.h"
+#include "./preparse.h"
+#include "./plt.h"
+
+
+
+/* AArch64 stubs load their slot with "adrp x16, PAGE" then "ldr x17, [x16, #OFFSET]" */
+#define AARCH64_ADRP_X16_MASK 0x9f00001f
+#define AARCH64_ADRP_X16 0x90000010
+#define AARCH64_LDR_X17_X16_MASK 0xffc003ff
+#define AARCH64_LDR_X17_X16 0xf9400211
+#define AARCH64_BTI_C 0xd503245f
+
+
+/* Names of the symbols of a table, indexed by the symbols' numbers */
+typedef struct symbol_names{
+    u8 ** names;
+    u64 numOfNames;
+}symbol_names_t;
+
+
+static s32 compare_got_slots(const void * a, const void * b){
+
+    const got_slot_t * slotA = a;
+    const got_slot_t * slotB = b;
+
+    return (slotA->address>slotB->address) - (slotA->address<slotB->address);
+}
+
+
+/* Read the names of all the symbols of a table once, so the relocations index them directly */
+static void read_symbol_names(kvelf_basic_params_t * kvelfp, u32 tableIdx, symbol_names_t * symbolNames){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+
+    u64 tableSize, stringsSize;
+    u8 * table = get_section_contents(kvelfp,tableIdx,&tableSize);
+    u8 * strings = get_section_contents(kvelfp,kvelfp->elfSectionsMetadata[tableIdx].sLink,&stringsSize);
+    if(!table || !strings)
+        return;
+
+    symbolNames->numOfNames = tableSize/symbolSize;
+    symbolNames->names = malloc((symbolNames->numOfNames ? symbolNames->numOfNames : 1)*sizeof(u8 *));
+    if(!symbolNames->names){
+        debug("Cannot allocate the symbols' names\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    // The name is the first field of the symbols of both classes
+    data_reader_t reader;
+    for(u64 symbolIdx=0;symbolIdx<symbolNames->numOfNames;symbolIdx++){
+        reader_init(&reader,table+symbolIdx*symbolSize,sizeof(u32),needsSwap);
+        u32 nameOffset = reader_u32(&reader);
+
+        if(nameOffset<stringsSize && memchr(strings+nameOffset,0,stringsSize-nameOffset))
+            symbolNames->names[symbolIdx] = strings+nameOffset;
+        else
+            symbolNames->names[symbolIdx] = "";
+    }
+}
+
+
+/* Collect the JUMP_SLOT, GLOB_DAT and IRELATIVE relocations of a REL or RELA table */
+static void read_got_relocations(kvelf_basic_params_t * kvelfp, u32 tableIdx, symbol_names_t * symbolNames, got_slot_t ** slots, u64 * numOfSlots, u64 * capacity){
+
+    section_metadata_t * section = &kvelfp->elfSectionsMetadata[tableIdx];
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u8 hasAddend = section->sType==SHT_RELA;
+    u32 jumpSlotType = get_elf_jump_slot_reloc_type(kvelfp->elfMachine);
+    u32 globDatType = get_elf_glob_dat_reloc_type(kvelfp->elfMachine);
+    u32 irelativeType = get_elf_irelative_reloc_type(kvelfp->elfMachine);
+
+    u64 tableSize;
+    u8 * table = get_section_contents(kvelfp,tableIdx,&tableSize);
+    if(!table)
+        return;
+
+    data_reader_t reader;
+    reader_init(&reader,table,tableSize,needsSwap);
+
+    u8 wordSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(u32) : sizeof(u64);
+    u64 entrySize = wordSize*(hasAddend ? 3 : 2);
+
+    for(u64 entryIdx=0;entryIdx<tableSize/entrySize;entryIdx++){
+        u64 offset = reader_uint(&reader,wordSize);
+        u64 info = reader_uint(&reader,wordSize);
+        s64 addend = 0;
+        if(hasAddend)
+            addend = kvelfp->elfClass==ELFCLASS32 ? (s32)reader_u32(&reader) : (s64)reader_u64(&reader);
+
+        u32 type = kvelfp->elfClass==ELFCLASS32 ? ELF32_R_TYPE(info) : ELF64_R_TYPE(info);
+        u64 symbolIdx = kvelfp->elfClass==ELFCLASS32 ? ELF32_R_SYM(info) : ELF64_R_SYM(info);
+
+        if(reader.error || (type!=jumpSlotType && type!=globDatType && type!=irelativeType))
+            continue;
+
+        if(*numOfSlots==*capacity){
+            *capacity*=2;
+            *slots = realloc(*slots,*capacity*sizeof(got_slot_t));
+            if(!*slots){
+                debug("Cannot allocate the GOT slots\n",DEBUG_STATUS_ERROR);
+                exit(1);
+            }
+        }
+
+        got_slot_t * slot = &(*slots)[(*numOfSlots)++];
+        slot->address = offset;
+        slot->addend = addend;
+        slot->name = symbolIdx && symbolIdx<symbolNames->numOfNames ? symbolNames->names[symbolIdx] : (u8 *)"";
+        slot->type = type;
+        slot->isJumpSlot = type==jumpSlotType;
+    }
+}
+
+
+
+/* Get the GOT slots of the file, built on the first call */
+got_index_t * got_get_index(kvelf_basic_params_t * kvelfp){
+
+    preparse_wait(kvelfp,PREPARSE_GOT_INDEX);
+    if(kvelfp->gotIndex)
+        return kvelfp->gotIndex;
+
+    u64 numOfSlots=0, capacity=64;
+    got_slot_t * slots = malloc(capacity*sizeof(got_slot_t));
+    got_index_t * gotIndex = calloc(1,sizeof(got_index_t));
+
+    // Names of the symbol tables the relocation tables link to, read at most once each
+    symbol_names_t * symbolNames = calloc(kvelfp->elfNumOfSections ? kvelfp->elfNumOfSections : 1,sizeof(symbol_names_t));
+    if(!slots || !gotIndex || !symbolNames){
+        debug("Cannot allocate the GOT slots\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+        if(section->sType!=SHT_REL && section->sType!=SHT_RELA)
+            continue;
+
+        u32 tableIdx = section->sLink;
+        if(tableIdx>=kvelfp->elfNumOfSections)
+            continue;
+        if(!symbolNames[tableIdx].names)
+            read_symbol_names(kvelfp,tableIdx,&symbolNames[tableIdx]);
+
+        read_got_relocations(kvelfp,i,&symbolNames[tableIdx],&slots,&numOfSlots,&capacity);
+    }
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++)
+        free(symbolNames[i].names);
+    free(symbolNames);
+
+    qsort(slots,numOfSlots,sizeof(got_slot_t),compare_got_slots);
+
+    gotIndex->slots = slots;
+    gotIndex->numOfSlots = numOfSlots;
+    kvelfp->gotIndex = gotIndex;
+
+    return gotIndex;
+}
+
+
+/* Free the GOT slots, the names are the mapped file's */
+void got_index_free(got_index_t * gotIndex){
+
+    if(!gotIndex)
+        return;
+
+    free(gotIndex->slots);
+    free(gotIndex);
+}
+
+
+/* Find the slot at an address, returns -1 if no relocation fills it */
+s64 got_index_find(got_index_t * gotIndex, u64 address){
+
+    u64 base=0, count=gotIndex->numOfSlots;
+    while(count){
+        u64 half = count/2;
+        if(gotIndex->slots[base+half].address<address){
+            base += half+1;
+            count -= half+1;
+        }else
+            count = half;
+    }
+
+    if(base<gotIndex->numOfSlots && gotIndex->slots[base].address==address)
+        return base;
+    return -1;
+}
+
+
+/* Name of the allocated section holding an address, the previous section is tried first */
+static u8 * section_name_of_address(kvelf_basic_params_t * kvelfp, u64 address, u32 * sectionIdx){
+
+    section_metadata_t * sections = kvelfp->elfSectionsMetadata;
+
+    if(*sectionIdx>=kvelfp->elfNumOfSections || address<sections[*sectionIdx].sVAddr || address-sections[*sectionIdx].sVAddr>=sections[*sectionIdx].sSize){
+        for(*sectionIdx=0;*sectionIdx<kvelfp->elfNumOfSections;(*sectionIdx)++)
+            if((sections[*sectionIdx].sFlags & SHF_ALLOC) && address>=sections[*sectionIdx].sVAddr && address-sections[*sectionIdx].sVAddr<sections[*sectionIdx].sSize)
+                break;
+        if(*sectionIdx==kvelfp->elfNumOfSections)
+            return "";
+    }
+
+    return get_section_name(kvelfp,*sectionIdx);
+}
+
+
+/* Columns of the listings, the rows end with the symbols printed by print_slot_symbol */
+static const layout_column_t gotLayout[] = {
+    {"Address",LAYOUT_HEX,20,16}, {"Section",LAYOUT_STRING,14}, {"Type",LAYOUT_STRING,22}, {"Symbol",LAYOUT_STRING},
+};
+static const layout_column_t pltLayout[] = {
+    {"Address",LAYOUT_HEX,20,16}, {"Section",LAYOUT_STRING,14}, {"GOT slot",LAYOUT_HEX,20,16}, {"Symbol",LAYOUT_STRING},
+};
+
+
+/* Print the symbol of a slot, an absolute slot has only its addend */
+static void print_slot_symbol(got_slot_t * slot){
+
+    if(!slot->name[0])
+        fprintf(display_output(),"*ABS*+0x%llx\n",slot->addend);
+    else if(slot->addend)
+        fprintf(display_output(),"%s%c0x%llx\n",slot->name,slot->addend<0 ? '-' : '+',slot->addend<0 ? -slot->addend : slot->addend);
+    else
+        fprintf(display_output(),"%s\n",slot->name);
+}
+
+
+/* List the GOT slots with the symbols they are bound to */
+void got_list_slots(kvelf_basic_params_t * kvelfp){
+
+    if(!kvelfp->elfImage){
+        display_error("The file is not mapped, its relocations cannot be read\n");
+        return;
+    }
+
+    got_index_t * gotIndex = got_get_index(kvelfp);
+    if(!gotIndex->numOfSlots){
+        fprintf(display_output(),"[INFO] No JUMP_SLOT, GLOB_DAT or IRELATIVE relocations in this file\n");
+        return;
+    }
+
+    u32 relocTableSize;
+    u8 ** relocTable = get_elf_reloc_table(kvelfp->elfMachine,&relocTableSize);
+
+    table_layout_t layout;
+    layout_compile(&layout,gotLayout,LAYOUT_COUNT(gotLayout));
+    layout_print_header(&layout);
+
+    u32 sectionIdx = kvelfp->elfNumOfSections;
+    u64 numOfJumpSlots = 0;
+    for(u64 i=0;i<gotIndex->numOfSlots;i++){
+        got_slot_t * slot = &gotIndex->slots[i];
+        fprintf(display_output(),"0x%016llx  %-14s%-22s",slot->address,section_name_of_address(kvelfp,slot->address,&sectionIdx),get_elf_reloc_type(relocTable,relocTableSize,slot->type));
+        print_slot_symbol(slot);
+        numOfJumpSlots += slot->isJumpSlot;
+    }
+
+    fprintf(display_output(),"\n%llu GOT slots, %llu of them PLT slots\n",gotIndex->numOfSlots,numOfJumpSlots);
+}
+
+
+
+/* Print a stub whose slot is filled by a relocation, returns 1 if it was printed */
+static u8 print_plt_stub(got_index_t * gotIndex, u64 stubAddress, u8 * sectionName, u64 slotAddress){
+
+    s64 slotIdx = got_index_find(gotIndex,slotAddress);
+    if(slotIdx<0)
+        return 0;
+
+    fprintf(display_output(),"0x%016llx  %-14s0x%016llx  ",stubAddress,sectionName,slotAddress);
+    print_slot_symbol(&gotIndex->slots[slotIdx]);
+    return 1;
+}
+
+
+/* Resolve the x86 stubs of a section from their indirect jumps. The 32-bit stubs are encoded the
+same in both modes, "jmp [disp32]" reading as RIP relative and "jmp [ebx+disp32]" being relative to the GOT */
+static u64 list_x86_stubs(kvelf_basic_params_t * kvelfp, u32 sectionIdx, got_index_t * gotIndex, u64 gotBase){
+
+    section_metadata_t * section = &kvelfp->elfSectionsMetadata[sectionIdx];
+    u8 * sectionName = get_section_name(kvelfp,sectionIdx);
+    u64 numOfStubs = 0;
+
+    u64 codeSize;
+    u8 * code = get_section_contents(kvelfp,sectionIdx,&codeSize);
+    if(!code)
+        return 0;
+
+    u8 afterEndbr = 0;
+    x86_instruction_t insn;
+    for(u64 offset=0;offset<codeSize;offset+=insn.length){
+        u64 address = section->sVAddr+offset;
+        x86_decode(code+offset,codeSize-offset,address,&insn);
+
+        if(!insn.invalid && insn.numOfOperands==1 && insn.operands[0].kind==X86_OPERAND_MEMORY && !strcmp(insn.mnemonic,"jmp")){
+            x86_operand_t * operand = &insn.operands[0];
+            u64 slotAddress;
+
+            if(kvelfp->elfClass==ELFCLASS64){
+                if(!insn.hasRipTarget){
+                    afterEndbr = 0;
+                    continue;
+                }
+                slotAddress = insn.ripTarget;
+            }else if(insn.hasRipTarget || operand->base==X86_NO_REGISTER)
+                slotAddress = (u32)operand->displacement;
+            else
+                slotAddress = (u32)(gotBase+operand->displacement);
+
+            // The stubs of the IBT enabled PLTs start with an endbr
+            numOfStubs += print_plt_stub(gotIndex,afterEndbr ? address-4 : address,sectionName,slotAddress);
+        }
+
+        afterEndbr = !insn.invalid && insn.length==4 && (!strcmp(insn.mnemonic,"endbr64") || !strcmp(insn.mnemonic,"endbr32"));
+    }
+
+    return numOfStubs;
+}
+
+
+/* Resolve the AArch64 stubs of a section from their adrp and ldr pair, the instructions are always little endian */
+static u64 list_aarch64_stubs(kvelf_basic_params_t * kvelfp, u32 sectionIdx, got_index_t * gotIndex){
+
+    section_metadata_t * section = &kvelfp->elfSectionsMetadata[sectionIdx];
+    u8 * sectionName = get_section_name(kvelfp,sectionIdx);
+    u64 numOfStubs = 0;
+
+    u64 codeSize;
+    u8 * code = get_section_contents(kvelfp,sectionIdx,&codeSize);
+    if(!code)
+        return 0;
+
+    data_reader_t reader;
+    for(u64 offset=0;offset+8<=codeSize;offset+=4){
+        reader_init(&reader,code+offset,8,ELF_NEEDS_SWAP(ELFDATA2LSB));
+        u32 adrp = reader_u32(&reader);
+        u32 ldr = reader_u32(&reader);
+
+        if((adrp & AARCH64_ADRP_X16_MASK)!=AARCH64_ADRP_X16 || (ldr & AARCH64_LDR_X17_X16_MASK)!=AARCH64_LDR_X17_X16)
+            continue;
+
+        // The page offset is a signed 21 bits immhi:immlo, the load's offset is scaled by the word size
+        s64 pageOffset = (s64)((u64)((((adrp>>5) & 0x7ffff)<<2) | ((adrp>>29) & 3))<<43)>>31;
+        u64 address = section->sVAddr+offset;
+        u64 slotAddress = (address & ~0xfffULL)+pageOffset+((ldr>>10) & 0xfff)*8;
+
+        // The stubs of the BTI enabled PLTs start with a "bti c"
+        u8 afterBti = 0;
+        if(offset>=4){
+            reader_init(&reader,code+offset-4,4,ELF_NEEDS_SWAP(ELFDATA2LSB));
+            afterBti = reader_u32(&reader)==AARCH64_BTI_C;
+        }
+
+        numOfStubs += print_plt_stub(gotIndex,afterBti ? address-4 : address,sectionName,slotAddress);
+    }
+
+    return numOfStubs;
+}
+
+
+/* List the PLT stubs with the GOT slots they jump through and their symbols */
+void plt_list_stubs(kvelf_basic_params_t * kvelfp){
+
+    u16 machine = kvelfp->elfMachine;
+    if(machine!=EM_X86_64 && machine!=EM_386 && machine!=EM_IAMCU && machine!=EM_AARCH64){
+        display_error("PLT stubs are decoded for x86 and AArch64 only, \"got\" lists the PLT slots\n");
+        return;
+    }
+
+    if(!kvelfp->elfImage){
+        display_error("The file is not mapped, its PLT cannot be read\n");
+        return;
+    }
+
+    got_index_t * gotIndex = got_get_index(kvelfp);
+
+    // ebx points to the start of .got.plt in the 32-bit position independent stubs
+    u64 gotBase = 0;
+    s64 gotIdx = find_section_by_name(kvelfp,".got.plt");
+    if(gotIdx<0)
+        gotIdx = find_section_by_name(kvelfp,".got");
+    if(gotIdx>=0)
+        gotBase = kvelfp->elfSectionsMetadata[gotIdx].sVAddr;
+
+    table_layout_t layout;
+    layout_compile(&layout,pltLayout,LAYOUT_COUNT(pltLayout));
+    layout_print_header(&layout);
+
+    // .plt, .plt.sec, .plt.got and the .iplt of the static files
+    u64 numOfStubs = 0;
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+        u8 * sectionName = get_section_name(kvelfp,i);
+
+        if(section->sType!=SHT_PROGBITS || !(section->sFlags & SHF_EXECINSTR) || (strncmp(sectionName,".plt",4) && strcmp(sectionName,".iplt")))
+            continue;
+
+        if(machine==EM_AARCH64)
+            numOfStubs += list_aarch64_stubs(kvelfp,i,gotIndex);
+        else
+            numOfStubs += list_x86_stubs(kvelfp,i,gotIndex,gotBase);
+    }
+
+    fprintf(display_output(),"\n%llu PLT stubs\n",numOfStubs);
+}
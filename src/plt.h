@@ -0,0 +1,43 @@
+#ifndef PLT_H
+#define PLT_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* GOT slot filled by a JUMP_SLOT, a GLOB_DAT or an IRELATIVE relocation */
+typedef struct got_slot{
+	u64 address;		/* Virtual address of the slot */
+	s64 addend;			/* Addend of a RELA relocation, 0 for REL */
+	u8 * name;			/* Name of the symbol in the mapped string table, "" for none */
+	u32 type;			/* Relocation type */
+	u8 isJumpSlot;		/* Whether the slot is the one of a PLT stub */
+}got_slot_t;
+
+
+/* Relocated GOT slots sorted by address */
+typedef struct got_index{
+	got_slot_t * slots;
+	u64 numOfSlots;
+}got_index_t;
+
+
+
+/* Get the GOT slots of the file, built on the first call */
+got_index_t * got_get_index(kvelf_basic_params_t * kvelfp);
+
+/* Free the GOT slots, the names are the mapped file's */
+void got_index_free(got_index_t * gotIndex);
+
+/* Find the slot at an address, returns -1 if no relocation fills it */
+s64 got_index_find(got_index_t * gotIndex, u64 address);
+
+/* List the GOT slots with the symbols they are bound to */
+void got_list_slots(kvelf_basic_params_t * kvelfp);
+
+/* List the PLT stubs with the GOT slots they jump through and their symbols */
+void plt_list_stubs(kvelf_basic_params_t * kvelfp);
+
+
+#endif
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./pool.h"
+
+
+
+/* Run the tasks of the current loop until there are none left, the lock is held on entry and on exit */
+static void run_tasks(thread_pool_t * pool){
+
+    while(pool->nextTask<pool->numOfTasks){
+        u64 taskIdx = pool->nextTask++;
+        pool_task_fn task = pool->task;
+        void * context = pool->context;
+
+        pthread_mutex_unlock(&pool->lock);
+        task(context,taskIdx);
+        pthread_mutex_lock(&pool->lock);
+
+        if(++pool->numOfDoneTasks==pool->numOfTasks)
+            pthread_cond_broadcast(&pool->workDone);
+    }
+}
+
+
+static void * worker_main(void * arg){
+
+    thread_pool_t * pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    while(1){
+        run_tasks(pool);
+        pthread_cond_wait(&pool->workReady,&pool->lock);
+    }
+
+    return NULL;
+}
+
+
+
+/* Start a pool of numOfThreads threads (the caller included), 0 for one per online CPU */
+thread_pool_t * pool_create(u32 numOfThreads){
+
+    if(!numOfThreads){
+        long onlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numOfThreads = onlineCpus>0 ? onlineCpus : 1;
+    }
+    if(numOfThreads>POOL_MAX_THREADS)
+        numOfThreads=POOL_MAX_THREADS;
+
+    thread_pool_t * pool = calloc(1,sizeof(thread_pool_t));
+    if(!pool || !(pool->workers=calloc(numOfThreads,sizeof(pthread_t)))){
+        debug("Cannot allocate the thread pool\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    pthread_mutex_init(&pool->lock,NULL);
+    pthread_cond_init(&pool->workReady,NULL);
+    pthread_cond_init(&pool->workDone,NULL);
+
+    // The caller is one of the threads, a pool of one thread runs everything in the caller
+    for(u32 i=0;i<numOfThreads-1;i++){
+        if(pthread_create(&pool->workers[pool->numOfWorkers],NULL,worker_main,pool)!=0){
+            debug("Cannot start all the worker threads\n",DEBUG_STATUS_WARNING);
+            break;
+        }
+        pool->numOfWorkers++;
+    }
+
+    return pool;
+}
+
+
+/* Run task(context,i) for every i in [0,numOfTasks) on the pool's threads and the caller,
+returns when they are all done. The tasks are handed out in order, one at a time, and the
+loops of several threads run one after the other */
+void pool_parallel_for(thread_pool_t * pool, u64 numOfTasks, pool_task_fn task, void * context){
+
+    if(!numOfTasks)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+
+    // The loop of another thread is not taken over, its caller is still waiting for it
+    while(pool->running)
+        pthread_cond_wait(&pool->workDone,&pool->lock);
+    pool->running = 1;
+
+    pool->task = task;
+    pool->context = context;
+    pool->numOfTasks = numOfTasks;
+    pool->nextTask = 0;
+    pool->numOfDoneTasks = 0;
+    pthread_cond_broadcast(&pool->workReady);
+
+    run_tasks(pool);
+    while(pool->numOfDoneTasks<pool->numOfTasks)
+        pthread_cond_wait(&pool->workDone,&pool->lock);
+
+    pool->running = 0;
+    pthread_cond_broadcast(&pool->workDone);
+    pthread_mutex_unlock(&pool->lock);
+}
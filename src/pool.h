@@ -0,0 +1,44 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <pthread.h>
+#include "./types.h"
+
+
+
+/* Most threads a pool starts, the calling thread included */
+#define POOL_MAX_THREADS 64
+
+
+
+/* Task of a parallel loop, called once for every index */
+typedef void (*pool_task_fn)(void * context, u64 taskIdx);
+
+
+/* Worker threads running the tasks of one parallel loop at a time */
+typedef struct thread_pool{
+	pthread_t * workers;	/* Worker threads, the calling thread works too */
+	u32 numOfWorkers;
+	pthread_mutex_t lock;	/* Protects the fields below */
+	pthread_cond_t workReady;	/* Signaled when tasks are added or the pool stops */
+	pthread_cond_t workDone;	/* Signaled when the last task is done, and when a loop ends */
+	u8 running;				/* Whether a loop is running, the loops of the other threads wait for it */
+	pool_task_fn task;		/* Task of the current loop */
+	void * context;			/* Context of the current loop */
+	u64 numOfTasks;			/* Number of tasks of the current loop */
+	u64 nextTask;			/* Next task to hand out */
+	u64 numOfDoneTasks;		/* Number of tasks finished */
+}thread_pool_t;
+
+
+
+/* Start a pool of numOfThreads threads (the caller included), 0 for one per online CPU */
+thread_pool_t * pool_create(u32 numOfThreads);
+
+/* Run task(context,i) for every i in [0,numOfTasks) on the pool's threads and the caller,
+returns when they are all done. The tasks are handed out in order, one at a time, and the
+loops of several threads run one after the other */
+void pool_parallel_for(thread_pool_t * pool, u64 numOfTasks, pool_task_fn task, void * context);
+
+
+#endif
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./kvelf.h"
+#include "./symindex.h"
+#include "./plt.h"
+#include "./parse.h"
+#include "./preparse.h"
+
+
+
+/* Ask the kernel to read ahead the tables the listings go through, so lsym and lr find them
+in the page cache. Their pages are read asynchronously, nothing waits for them */
+static void read_ahead_tables(kvelf_basic_params_t * kvelfp){
+
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if(pageSize<=0)
+        return;
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        u32 type = kvelfp->elfSectionsMetadata[i].sType;
+        if(type!=SHT_SYMTAB && type!=SHT_DYNSYM && type!=SHT_STRTAB && type!=SHT_REL && type!=SHT_RELA && type!=SHT_RELR)
+            continue;
+
+        u64 contentsSize;
+        u8 * contents = get_section_contents(kvelfp,i,&contentsSize);
+        if(!contents || !contentsSize)
+            continue;
+
+        u64 start = (u64)(contents-kvelfp->elfImage) & ~(u64)(pageSize-1);
+        madvise(kvelfp->elfImage+start,(contents-kvelfp->elfImage)+contentsSize-start,MADV_WILLNEED);
+    }
+}
+
+
+/* Claim an index which no command took over yet, returns 0 if a command builds it */
+static u8 claim_index(preparser_t * preparser, u8 indexIdx){
+
+    pthread_mutex_lock(&preparser->lock);
+    u8 claimed = preparser->states[indexIdx]==PREPARSE_PENDING;
+    if(claimed)
+        preparser->states[indexIdx] = PREPARSE_BUILDING;
+    pthread_mutex_unlock(&preparser->lock);
+
+    return claimed;
+}
+
+
+static void index_built(preparser_t * preparser, u8 indexIdx){
+
+    pthread_mutex_lock(&preparser->lock);
+    preparser->states[indexIdx] = PREPARSE_READY;
+    pthread_cond_broadcast(&preparser->indexReady);
+    pthread_mutex_unlock(&preparser->lock);
+}
+
+
+static void * preparse_main(void * arg){
+
+    kvelf_basic_params_t * kvelfp = arg;
+    preparser_t * preparser = kvelfp->preparser;
+
+    read_ahead_tables(kvelfp);
+
+    // The builders see the worker's thread and do not wait for it
+    if(claim_index(preparser,PREPARSE_LISTING_TABLES)){
+        get_listing_tables(kvelfp);
+        index_built(preparser,PREPARSE_LISTING_TABLES);
+    }
+
+    if(claim_index(preparser,PREPARSE_SYMBOL_INDEX)){
+        symbol_get_index(kvelfp);
+        index_built(preparser,PREPARSE_SYMBOL_INDEX);
+    }
+
+    if(claim_index(preparser,PREPARSE_GOT_INDEX)){
+        got_get_index(kvelfp);
+        index_built(preparser,PREPARSE_GOT_INDEX);
+    }
+
+    return NULL;
+}
+
+
+
+/* Start building the indexes of an analyzed file in the background */
+void preparse_start(kvelf_basic_params_t * kvelfp){
+
+    // The indexes are read from the mapped file, there is nothing to build without it
+    if(!kvelfp->elfImage || kvelfp->preparser)
+        return;
+
+    preparser_t * preparser = calloc(1,sizeof(preparser_t));
+    if(!preparser){
+        debug("Cannot allocate the background parser\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    pthread_mutex_init(&preparser->lock,NULL);
+    pthread_cond_init(&preparser->indexReady,NULL);
+    kvelfp->preparser = preparser;
+
+    // Set before the worker runs, the worker reads it to recognize itself
+    pthread_mutex_lock(&preparser->lock);
+    if(pthread_create(&preparser->worker,NULL,preparse_main,kvelfp)!=0){
+        pthread_mutex_unlock(&preparser->lock);
+        debug("Cannot start the background parser, the indexes are built by the commands\n",DEBUG_STATUS_WARNING);
+        kvelfp->preparser = NULL;
+        free(preparser);
+        return;
+    }
+    pthread_detach(preparser->worker);
+    pthread_mutex_unlock(&preparser->lock);
+}
+
+
+/* Wait until the worker has built an index, or take it over if the worker has not started it.
+The caller then finds the index built or builds it itself */
+void preparse_wait(kvelf_basic_params_t * kvelfp, u8 indexIdx){
+
+    preparser_t * preparser = kvelfp->preparser;
+    if(!preparser)
+        return;
+
+    pthread_mutex_lock(&preparser->lock);
+    if(!pthread_equal(pthread_self(),preparser->worker)){
+        if(preparser->states[indexIdx]==PREPARSE_PENDING)
+            preparser->states[indexIdx] = PREPARSE_READY;
+        while(preparser->states[indexIdx]==PREPARSE_BUILDING)
+            pthread_cond_wait(&preparser->indexReady,&preparser->lock);
+    }
+    pthread_mutex_unlock(&preparser->lock);
+}
@@ -0,0 +1,41 @@
+#ifndef PREPARSE_H
+#define PREPARSE_H
+
+#include <pthread.h>
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Indexes the worker builds, in this order */
+#define PREPARSE_LISTING_TABLES 0	/* Tables of lsym and lr in the host's order */
+#define PREPARSE_SYMBOL_INDEX 1		/* Symbols sorted by address */
+#define PREPARSE_GOT_INDEX 2		/* Relocated GOT slots */
+#define PREPARSE_NUM_OF_INDEXES 3
+
+/* States of an index */
+#define PREPARSE_PENDING 0		/* Neither the worker nor a command started it */
+#define PREPARSE_BUILDING 1		/* The worker is building it */
+#define PREPARSE_READY 2		/* Built by the worker, or left to the command needing it first */
+
+
+
+/* Worker building the indexes in the background while the prompt waits for a command */
+typedef struct preparser{
+	pthread_t worker;
+	pthread_mutex_t lock;	/* Protects the states */
+	pthread_cond_t indexReady;	/* Signaled when the worker finishes an index */
+	u8 states[PREPARSE_NUM_OF_INDEXES];
+}preparser_t;
+
+
+
+/* Start building the indexes of an analyzed file in the background */
+void preparse_start(kvelf_basic_params_t * kvelfp);
+
+/* Wait until the worker has built an index, or take it over if the worker has not started it.
+The caller then finds the index built or builds it itself */
+void preparse_wait(kvelf_basic_params_t * kvelfp, u8 indexIdx);
+
+
+#endif
@@ -0,0 +1,265 @@
+#include <string.h>
+#include "./types.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+
+
+
+/* Initialize a reader over the given region */
+void reader_init(data_reader_t * reader, u8 * data, u64 dataSize, u8 needsSwap){
+    reader->start = data;
+    reader->pos = data;
+    reader->end = data + dataSize;
+    reader->needsSwap = needsSwap;
+    reader->error = 0;
+}
+
+
+/* Number of bytes left in the region */
+u64 reader_left(data_reader_t * reader){
+    return reader->end - reader->pos;
+}
+
+
+/* Skip the given number of bytes */
+void reader_skip(data_reader_t * reader, u64 count){
+
+    if (count > reader_left(reader)){
+        reader->pos = reader->end;
+        reader->error = 1;
+    }else
+        reader->pos += count;
+}
+
+
+/* Read an unsigned byte */
+u8 reader_u8(data_reader_t * reader){
+
+    if (reader->pos >= reader->end){
+        reader->error = 1;
+        return 0;
+    }
+    return *reader->pos++;
+}
+
+
+/* Read an unsigned 16-bit value */
+u16 reader_u16(data_reader_t * reader){
+
+    u16 value = 0;
+
+    if (reader_left(reader) < sizeof(u16)){
+        reader->pos = reader->end;
+        reader->error = 1;
+        return 0;
+    }
+    memcpy(&value, reader->pos, sizeof(u16));
+    reader->pos += sizeof(u16);
+
+    return reader->needsSwap ? __builtin_bswap16(value) : value;
+}
+
+
+/* Read an unsigned 32-bit value */
+u32 reader_u32(data_reader_t * reader){
+
+    u32 value = 0;
+
+    if (reader_left(reader) < sizeof(u32)){
+        reader->pos = reader->end;
+        reader->error = 1;
+        return 0;
+    }
+    memcpy(&value, reader->pos, sizeof(u32));
+    reader->pos += sizeof(u32);
+
+    return reader->needsSwap ? __builtin_bswap32(value) : value;
+}
+
+
+/* Read an unsigned 64-bit value */
+u64 reader_u64(data_reader_t * reader){
+
+    u64 value = 0;
+
+    if (reader_left(reader) < sizeof(u64)){
+        reader->pos = reader->end;
+        reader->error = 1;
+        return 0;
+    }
+    memcpy(&value, reader->pos, sizeof(u64));
+    reader->pos += sizeof(u64);
+
+    return reader->needsSwap ? __builtin_bswap64(value) : value;
+}
+
+
+/* Read an unsigned value of up to 8 bytes */
+u64 reader_uint(data_reader_t * reader, u8 size){
+
+    switch (size){
+        case 1:
+            return reader_u8(reader);
+        case 2:
+            return reader_u16(reader);
+        case 4:
+            return reader_u32(reader);
+        case 8:
+            return reader_u64(reader);
+    }
+
+    // Odd sizes (the 3-byte index forms of DWARF 5) are put together byte by byte
+    if (size > sizeof(u64) || size > reader_left(reader)){
+        reader_skip(reader, size);
+        return 0;
+    }
+
+    u64 value = 0;
+    u8 littleEndian = (ELF_HOST_ENCODING == ELFDATA2LSB) != reader->needsSwap;
+    for (u8 i = 0; i < size; i++){
+        u8 byte = reader->pos[littleEndian ? size - 1 - i : i];
+        value = (value << 8) | byte;
+    }
+    reader->pos += size;
+
+    return value;
+}
+
+
+/* Read an unsigned LEB128 value */
+u64 reader_uleb128(data_reader_t * reader){
+
+    u64 value = 0;
+    u32 shift = 0;
+
+    while (reader->pos < reader->end){
+        u8 byte = *reader->pos++;
+        if (shift < 64)
+            value |= (u64)(byte & 0x7f) << shift;
+        shift += 7;
+        if (!(byte & 0x80))
+            return value;
+    }
+
+    reader->error = 1;
+    return value;
+}
+
+
+/* Read a signed LEB128 value */
+s64 reader_sleb128(data_reader_t * reader){
+
+    u64 value = 0;
+    u32 shift = 0;
+
+    while (reader->pos < reader->end){
+        u8 byte = *reader->pos++;
+        if (shift < 64)
+            value |= (u64)(byte & 0x7f) << shift;
+        shift += 7;
+        if (!(byte & 0x80)){
+            // Extending the sign bit of the last byte
+            if (shift < 64 && (byte & 0x40))
+                value |= ~0ULL << shift;
+            return (s64)value;
+        }
+    }
+
+    reader->error = 1;
+    return (s64)value;
+}
+
+
+/* Read a NUL terminated string, returns NULL if it is not terminated inside the region */
+u8 * reader_string(data_reader_t * reader){
+
+    u8 * string = reader->pos;
+    u8 * terminator = memchr(reader->pos, 0, reader_left(reader));
+
+    if (!terminator){
+        reader->pos = reader->end;
+        reader->error = 1;
+        return NULL;
+    }
+
+    reader->pos = terminator + 1;
+    return string;
+}
+
+
+/* Name at an offset of a string table, "" if it is out of the table */
+u8 * string_at(u8 * strings, u64 stringsSize, u64 offset){
+
+    if (!strings || offset >= stringsSize || !memchr(strings + offset, 0, stringsSize - offset))
+        return "";
+    return strings + offset;
+}
+
+
+/* Start expanding the entries [firstEntry,entriesSize/wordSize) of a RELR table, the address the first
+bitmap starts at is found from the entries before it */
+void relr_cursor_init(relr_cursor_t * cursor, u8 * entries, u64 entriesSize, u8 wordSize, u8 needsSwap, u64 firstEntry){
+
+    u64 endEntry = entriesSize / wordSize;
+    if (firstEntry > endEntry)
+        firstEntry = endEntry;
+
+    cursor->wordSize = wordSize;
+    cursor->base = 0;
+    cursor->bitmap = 0;
+
+    // Back to the last address entry, every bitmap in between moves past its words
+    data_reader_t reader;
+    u64 addressIdx = firstEntry;
+    while (addressIdx){
+        reader_init(&reader, entries + (addressIdx - 1) * wordSize, wordSize, needsSwap);
+        u64 entry = reader_uint(&reader, wordSize);
+        if (!(entry & 1)){
+            cursor->where = entry + wordSize;
+            break;
+        }
+        addressIdx--;
+    }
+    if (!addressIdx)
+        cursor->where = 0;
+    cursor->where += (firstEntry - addressIdx) * (wordSize * 8 - 1) * wordSize;
+
+    reader_init(&cursor->reader, entries + firstEntry * wordSize, (endEntry - firstEntry) * wordSize, needsSwap);
+}
+
+
+/* Read the next entry, setting base and bitmap to its relocations. Returns 0 after the last one */
+u8 relr_cursor_next_entry(relr_cursor_t * cursor){
+
+    if (reader_left(&cursor->reader) < cursor->wordSize)
+        return 0;
+
+    u64 entry = reader_uint(&cursor->reader, cursor->wordSize);
+    if (!(entry & 1)){
+        cursor->base = entry;
+        cursor->bitmap = 1;
+        cursor->where = entry + cursor->wordSize;
+    }else{
+        cursor->base = cursor->where;
+        cursor->bitmap = entry >> 1;
+        cursor->where += (cursor->wordSize * 8 - 1) * cursor->wordSize;
+    }
+    return 1;
+}
+
+
+/* Get the next relocated address, returns 0 after the last one */
+u8 relr_cursor_next(relr_cursor_t * cursor, u64 * address){
+
+    while (!cursor->bitmap)
+        if (!relr_cursor_next_entry(cursor))
+            return 0;
+
+    // Visiting only the set bits of the bitmap, the addresses of 32-bit files wrap as theirs do
+    *address = cursor->base + __builtin_ctzll(cursor->bitmap) * cursor->wordSize;
+    if (cursor->wordSize == sizeof(u32))
+        *address = (u32)*address;
+    cursor->bitmap &= cursor->bitmap - 1;
+    return 1;
+}
@@ -0,0 +1,77 @@
+#ifndef READER_H
+#define READER_H
+
+#include "./types.h"
+
+
+/* Sequential reader over a region of the mapped file */
+typedef struct data_reader{
+	u8 * start;		/* Start of the region */
+	u8 * pos;		/* Current position */
+	u8 * end;		/* End of the region */
+	u8 needsSwap;	/* Whether the multi-byte values are in the foreign byte order */
+	u8 error;		/* Set once a read went past the end of the region */
+}data_reader_t;
+
+
+/* Cursor expanding the relocations packed in a RELR table. An even entry is the address of a
+relocation, the words after it are relative to the next word. An odd entry is a bitmap whose
+bits 1..N-1 mark which of the next N-1 words are relocated */
+typedef struct relr_cursor{
+	data_reader_t reader;	/* Entries not read yet */
+	u8 wordSize;	/* Size of the entries and of the relocated words */
+	u64 where;		/* Address the next bitmap starts at */
+	u64 base;		/* Address bit 0 of the current entry stands for, an address entry is a bitmap of bit 0 */
+	u64 bitmap;		/* Relocations of the current entry not visited yet */
+}relr_cursor_t;
+
+
+
+/* Initialize a reader over the given region */
+void reader_init(data_reader_t * reader, u8 * data, u64 dataSize, u8 needsSwap);
+
+/* Number of bytes left in the region */
+u64 reader_left(data_reader_t * reader);
+
+/* Skip the given number of bytes */
+void reader_skip(data_reader_t * reader, u64 count);
+
+/* Read an unsigned byte */
+u8 reader_u8(data_reader_t * reader);
+
+/* Read an unsigned 16-bit value */
+u16 reader_u16(data_reader_t * reader);
+
+/* Read an unsigned 32-bit value */
+u32 reader_u32(data_reader_t * reader);
+
+/* Read an unsigned 64-bit value */
+u64 reader_u64(data_reader_t * reader);
+
+/* Read an unsigned value of up to 8 bytes */
+u64 reader_uint(data_reader_t * reader, u8 size);
+
+/* Read an unsigned LEB128 value */
+u64 reader_uleb128(data_reader_t * reader);
+
+/* Read a signed LEB128 value */
+s64 reader_sleb128(data_reader_t * reader);
+
+/* Read a NUL terminated string, returns NULL if it is not terminated inside the region */
+u8 * reader_string(data_reader_t * reader);
+
+/* Name at an offset of a string table, "" if it is out of the table */
+u8 * string_at(u8 * strings, u64 stringsSize, u64 offset);
+
+/* Start expanding the entries [firstEntry,entriesSize/wordSize) of a RELR table, the address the first
+bitmap starts at is found from the entries before it */
+void relr_cursor_init(relr_cursor_t * cursor, u8 * entries, u64 entriesSize, u8 wordSize, u8 needsSwap, u64 firstEntry);
+
+/* Read the next entry, setting base and bitmap to its relocations. Returns 0 after the last one */
+u8 relr_cursor_next_entry(relr_cursor_t * cursor);
+
+/* Get the next relocated address, returns 0 after the last one */
+u8 relr_cursor_next(relr_cursor_t * cursor, u64 * address);
+
+
+#endif
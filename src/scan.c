@@ -0,0 +1,654 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <time.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./layout.h"
+#include "./scan.h"
+
+
+
+/* Paths of the files to scan, in the order they are listed */
+typedef struct scan_paths{
+    u8 ** paths;
+    u64 numOfPaths;
+    u64 capacity;
+    u64 numOfUnreadableDirectories;
+}scan_paths_t;
+
+
+/* Columns of the listing, a row per ELF file */
+static const layout_column_t scanLayout[] = {
+    {"Class",LAYOUT_STRING,7}, {"Type",LAYOUT_STRING,9}, {"Linking",LAYOUT_STRING,9}, {"Symbols",LAYOUT_STRING,10},
+    {"Segments",LAYOUT_DEC,10}, {"Sections",LAYOUT_DEC,10}, {"Machine",LAYOUT_STRING,32}, {"Path",LAYOUT_STRING},
+};
+
+
+
+static void add_path(scan_paths_t * list, u8 * path){
+
+    if(list->numOfPaths==list->capacity){
+        list->capacity = list->capacity ? list->capacity*2 : 256;
+        list->paths = realloc(list->paths,list->capacity*sizeof(u8 *));
+        if(!list->paths){
+            debug("Cannot allocate memory for the paths to scan\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+    }
+
+    if(!(list->paths[list->numOfPaths++] = strdup(path))){
+        debug("Cannot allocate memory for the paths to scan\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+}
+
+
+static s32 compare_names(const void * a, const void * b){
+    return strcmp(*(u8 * const *)a,*(u8 * const *)b);
+}
+
+
+/* Add the regular files under a directory by name, the symbolic links are not followed so that
+no file is listed twice and no loop is walked */
+static void walk_directory(scan_paths_t * list, u8 * directoryPath){
+
+    DIR * directory = opendir(directoryPath);
+    if(!directory){
+        list->numOfUnreadableDirectories++;
+        return;
+    }
+
+    u8 ** names = NULL;
+    u64 numOfNames = 0, capacity = 0;
+
+    struct dirent * entry;
+    while((entry = readdir(directory))){
+        if(strcmp(entry->d_name,".")==0 || strcmp(entry->d_name,"..")==0)
+            continue;
+
+        u8 path[PATH_MAX];
+        if((u64)snprintf(path,sizeof(path),"%s/%s",directoryPath,entry->d_name)>=sizeof(path))
+            continue;
+
+        // File systems which do not give the types have them looked up
+        u8 type = entry->d_type;
+        if(type==DT_UNKNOWN){
+            struct stat fileStat;
+            if(lstat(path,&fileStat)!=0)
+                continue;
+            type = S_ISDIR(fileStat.st_mode) ? DT_DIR : S_ISREG(fileStat.st_mode) ? DT_REG : DT_LNK;
+        }
+        if(type!=DT_DIR && type!=DT_REG)
+            continue;
+
+        if(numOfNames==capacity){
+            capacity = capacity ? capacity*2 : 64;
+            names = realloc(names,capacity*sizeof(u8 *));
+            if(!names){
+                debug("Cannot allocate memory for the paths to scan\n",DEBUG_STATUS_ERROR);
+                exit(1);
+            }
+        }
+        // Kept in front of the path, the type sorts the directories before the files
+        u64 nameLength = strlen(path);
+        if(!(names[numOfNames] = malloc(nameLength+2))){
+            debug("Cannot allocate memory for the paths to scan\n",DEBUG_STATUS_ERROR);
+            exit(1);
+        }
+        memcpy(names[numOfNames]+1,path,nameLength+1);
+        names[numOfNames][0] = type==DT_DIR ? 'd' : 'f';
+        numOfNames++;
+    }
+    closedir(directory);
+
+    // Listed by name whatever order the directory has them in
+    qsort(names,numOfNames,sizeof(u8 *),compare_names);
+
+    for(u64 i=0;i<numOfNames;i++){
+        if(names[i][0]=='d')
+            walk_directory(list,names[i]+1);
+        else
+            add_path(list,names[i]+1);
+        free(names[i]);
+    }
+    free(names);
+}
+
+
+static void finish_file(scan_file_t * file, u8 result){
+
+    for(u8 i=0;i<file->numOfReads;i++)
+        if(file->reads[i].buffer!=file->header && file->reads[i].buffer!=file->firstSection)
+            free(file->reads[i].buffer);
+
+    file->numOfReads = 0;
+    file->stage = SCAN_STAGE_DONE;
+    file->result = result;
+}
+
+
+/* Read of a header table, cut to SCAN_MAX_TABLE_SIZE. A table the file does not have is an empty
+read, a table going past the end of the file a short one */
+static void plan_table_read(scan_read_t * read, u64 offset, u64 size){
+
+    read->offset = offset;
+    read->size = 0;
+    read->buffer = NULL;
+    read->result = 0;
+
+    if(!offset)
+        return;
+
+    read->size = size<SCAN_MAX_TABLE_SIZE ? size : SCAN_MAX_TABLE_SIZE;
+
+    if(read->size && !(read->buffer = malloc(read->size))){
+        debug("Cannot allocate memory for the header tables\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+}
+
+
+static void plan_tables(scan_file_t * file){
+
+    u64 segmentSize = file->elfClass==ELFCLASS32 ? sizeof(Elf32_Phdr) : sizeof(Elf64_Phdr);
+    u64 sectionSize = file->elfClass==ELFCLASS32 ? sizeof(Elf32_Shdr) : sizeof(Elf64_Shdr);
+
+    file->stage = SCAN_STAGE_TABLES;
+    file->numOfReads = 2;
+    plan_table_read(&file->reads[0],file->segmentsOffset,(u64)file->numOfSegments*segmentSize);
+    plan_table_read(&file->reads[1],file->sectionsOffset,(u64)file->numOfSections*sectionSize);
+}
+
+
+/* Take the fields of the ELF header, returns 0 if it is not one */
+static u8 read_header(scan_file_t * file){
+
+    s64 headerSize = file->reads[0].result;
+    u8 * ident = file->header;
+
+    // Files shorter than a header give short reads
+    if(headerSize<EI_NIDENT || memcmp(ident,ELFMAG,SELFMAG)!=0)
+        return 0;
+
+    file->elfClass = ident[EI_CLASS];
+    file->elfEncoding = ident[EI_DATA];
+    u8 needsSwap = ELF_NEEDS_SWAP(file->elfEncoding);
+
+    // Tables with entries of another size than the structures of the class are not read
+    if(file->elfClass==ELFCLASS32 && headerSize>=(s64)sizeof(Elf32_Ehdr)){
+        Elf32_Ehdr elf32Header;
+        memcpy(&elf32Header,file->header,sizeof(elf32Header));
+        if(needsSwap)
+            elf_swap_ehdr32(&elf32Header);
+
+        file->elfFiletype = elf32Header.e_type;
+        file->elfMachine = elf32Header.e_machine;
+        file->segmentsOffset = elf32Header.e_phentsize==sizeof(Elf32_Phdr) ? elf32Header.e_phoff : 0;
+        file->sectionsOffset = elf32Header.e_shentsize==sizeof(Elf32_Shdr) ? elf32Header.e_shoff : 0;
+        file->numOfSegments = elf32Header.e_phnum;
+        file->numOfSections = elf32Header.e_shnum;
+        return 1;
+    }
+    if(file->elfClass==ELFCLASS64 && headerSize>=(s64)sizeof(Elf64_Ehdr)){
+        Elf64_Ehdr elf64Header;
+        memcpy(&elf64Header,file->header,sizeof(elf64Header));
+        if(needsSwap)
+            elf_swap_ehdr64(&elf64Header);
+
+        file->elfFiletype = elf64Header.e_type;
+        file->elfMachine = elf64Header.e_machine;
+        file->segmentsOffset = elf64Header.e_phentsize==sizeof(Elf64_Phdr) ? elf64Header.e_phoff : 0;
+        file->sectionsOffset = elf64Header.e_shentsize==sizeof(Elf64_Shdr) ? elf64Header.e_shoff : 0;
+        file->numOfSegments = elf64Header.e_phnum;
+        file->numOfSections = elf64Header.e_shnum;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/* Take the numbers of sections and segments which do not fit in the ELF header from the first section */
+static void read_first_section(scan_file_t * file){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(file->elfEncoding);
+    u64 sectionSize, numOfSegments;
+
+    if(file->elfClass==ELFCLASS32){
+        Elf32_Shdr elf32Shdr;
+        if(file->reads[0].result<(s64)sizeof(elf32Shdr))
+            return;
+        memcpy(&elf32Shdr,file->firstSection,sizeof(elf32Shdr));
+        if(needsSwap)
+            elf_swap_shdr32(&elf32Shdr);
+        sectionSize = elf32Shdr.sh_size;
+        numOfSegments = elf32Shdr.sh_info;
+    }else{
+        Elf64_Shdr elf64Shdr;
+        if(file->reads[0].result<(s64)sizeof(elf64Shdr))
+            return;
+        memcpy(&elf64Shdr,file->firstSection,sizeof(elf64Shdr));
+        if(needsSwap)
+            elf_swap_shdr64(&elf64Shdr);
+        sectionSize = elf64Shdr.sh_size;
+        numOfSegments = elf64Shdr.sh_info;
+    }
+
+    if(!file->numOfSections)
+        file->numOfSections = sectionSize;
+    if(file->numOfSegments==PN_XNUM)
+        file->numOfSegments = numOfSegments;
+}
+
+
+/* Look at the segments' and the sections' types */
+static void read_tables(scan_file_t * file){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(file->elfEncoding);
+    scan_read_t * segments = &file->reads[0];
+    scan_read_t * sections = &file->reads[1];
+    u64 segmentSize = file->elfClass==ELFCLASS32 ? sizeof(Elf32_Phdr) : sizeof(Elf64_Phdr);
+    u64 sectionSize = file->elfClass==ELFCLASS32 ? sizeof(Elf32_Shdr) : sizeof(Elf64_Shdr);
+
+    // Tables cut by SCAN_MAX_TABLE_SIZE or by the end of the file leave their answers unknown
+    file->segmentsRead = segments->result==(s64)(file->numOfSegments*segmentSize);
+    file->sectionsRead = sections->result==(s64)(file->numOfSections*sectionSize);
+
+    if(file->elfClass==ELFCLASS32){
+        for(u64 i=0;i<segments->result/sizeof(Elf32_Phdr);i++){
+            Elf32_Phdr elf32Phdr;
+            memcpy(&elf32Phdr,segments->buffer+i*sizeof(elf32Phdr),sizeof(elf32Phdr));
+            if(needsSwap)
+                elf_swap_phdr32(&elf32Phdr);
+            file->isDynamic |= elf32Phdr.p_type==PT_INTERP || elf32Phdr.p_type==PT_DYNAMIC;
+        }
+        for(u64 i=0;i<sections->result/sizeof(Elf32_Shdr);i++){
+            Elf32_Shdr elf32Shdr;
+            memcpy(&elf32Shdr,sections->buffer+i*sizeof(elf32Shdr),sizeof(elf32Shdr));
+            if(needsSwap)
+                elf_swap_shdr32(&elf32Shdr);
+            file->hasSymbols |= elf32Shdr.sh_type==SHT_SYMTAB;
+        }
+    }else{
+        for(u64 i=0;i<segments->result/sizeof(Elf64_Phdr);i++){
+            Elf64_Phdr elf64Phdr;
+            memcpy(&elf64Phdr,segments->buffer+i*sizeof(elf64Phdr),sizeof(elf64Phdr));
+            if(needsSwap)
+                elf_swap_phdr64(&elf64Phdr);
+            file->isDynamic |= elf64Phdr.p_type==PT_INTERP || elf64Phdr.p_type==PT_DYNAMIC;
+        }
+        for(u64 i=0;i<sections->result/sizeof(Elf64_Shdr);i++){
+            Elf64_Shdr elf64Shdr;
+            memcpy(&elf64Shdr,sections->buffer+i*sizeof(elf64Shdr),sizeof(elf64Shdr));
+            if(needsSwap)
+                elf_swap_shdr64(&elf64Shdr);
+            file->hasSymbols |= elf64Shdr.sh_type==SHT_SYMTAB;
+        }
+    }
+}
+
+
+/* Take the results of a file's reads and plan the reads of its next stage. Both ways of reading
+run the same stages, they only differ by how the reads are done */
+static void scan_step(scan_file_t * file){
+
+    if(file->stage==SCAN_STAGE_OPEN){
+        if(file->fd<0)
+            finish_file(file,SCAN_RESULT_ERROR);
+        else{
+            file->stage = SCAN_STAGE_HEADER;
+            file->numOfReads = 1;
+            file->reads[0].offset = 0;
+            file->reads[0].size = sizeof(file->header);
+            file->reads[0].buffer = file->header;
+        }
+        return;
+    }
+
+    for(u8 i=0;i<file->numOfReads;i++)
+        if(file->reads[i].result<0){
+            finish_file(file,SCAN_RESULT_ERROR);
+            return;
+        }
+
+    if(file->stage==SCAN_STAGE_HEADER){
+        if(!read_header(file))
+            finish_file(file,SCAN_RESULT_NOT_ELF);
+        else if(file->sectionsOffset && (!file->numOfSections || file->numOfSegments==PN_XNUM)){
+            file->stage = SCAN_STAGE_FIRST_SECTION;
+            file->numOfReads = 1;
+            file->reads[0].offset = file->sectionsOffset;
+            file->reads[0].size = file->elfClass==ELFCLASS32 ? sizeof(Elf32_Shdr) : sizeof(Elf64_Shdr);
+            file->reads[0].buffer = file->firstSection;
+        }else
+            plan_tables(file);
+    }
+    else if(file->stage==SCAN_STAGE_FIRST_SECTION){
+        read_first_section(file);
+        plan_tables(file);
+    }
+    else if(file->stage==SCAN_STAGE_TABLES){
+        read_tables(file);
+        finish_file(file,SCAN_RESULT_ELF);
+    }
+}
+
+
+
+/* Scan a file one system call at a time */
+static void scan_file_pread(scan_file_t * file){
+
+    file->fd = open(file->path,O_RDONLY|O_CLOEXEC);
+    scan_step(file);
+
+    while(file->stage!=SCAN_STAGE_DONE){
+        for(u8 i=0;i<file->numOfReads;i++){
+            scan_read_t * read = &file->reads[i];
+            read->result = read->size ? pread(file->fd,read->buffer,read->size,read->offset) : 0;
+            if(read->result<0)
+                read->result = -errno;
+        }
+        scan_step(file);
+    }
+
+    if(file->fd>=0)
+        close(file->fd);
+    file->fd = -1;
+}
+
+
+
+/* Whether the kernel has the operations of the scan, they came after io_uring itself */
+static u8 ring_supports_operations(s32 ringFd){
+
+    u64 probeSize = sizeof(struct io_uring_probe)+256*sizeof(struct io_uring_probe_op);
+    struct io_uring_probe * probe = calloc(1,probeSize);
+    if(!probe)
+        return 0;
+
+    u8 supported = syscall(__NR_io_uring_register,ringFd,IORING_REGISTER_PROBE,probe,256)==0;
+    u8 operations[] = {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE};
+    for(u32 i=0;i<sizeof(operations) && supported;i++)
+        supported = operations[i]<=probe->last_op && (probe->ops[operations[i]].flags & IO_URING_OP_SUPPORTED);
+
+    free(probe);
+    return supported;
+}
+
+
+/* Set up an io_uring instance and map its queues, returns 0 if the kernel cannot give one */
+static u8 ring_setup(scan_ring_t * ring){
+
+    struct io_uring_params params;
+    memset(&params,0,sizeof(params));
+    memset(ring,0,sizeof(scan_ring_t));
+
+    ring->fd = syscall(__NR_io_uring_setup,SCAN_RING_ENTRIES,&params);
+    if(ring->fd<0)
+        return 0;
+    if(!ring_supports_operations(ring->fd)){
+        close(ring->fd);
+        return 0;
+    }
+
+    u64 sqRingSize = params.sq_off.array+params.sq_entries*sizeof(u32);
+    u64 cqRingSize = params.cq_off.cqes+params.cq_entries*sizeof(struct io_uring_cqe);
+    u8 singleMap = (params.features & IORING_FEAT_SINGLE_MMAP)!=0;
+    if(singleMap && cqRingSize>sqRingSize)
+        sqRingSize = cqRingSize;
+
+    u8 * sqRing = mmap(NULL,sqRingSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,ring->fd,IORING_OFF_SQ_RING);
+    u8 * cqRing = singleMap ? sqRing : mmap(NULL,cqRingSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,ring->fd,IORING_OFF_CQ_RING);
+    void * sqes = mmap(NULL,params.sq_entries*sizeof(struct io_uring_sqe),PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,ring->fd,IORING_OFF_SQES);
+    if(sqRing==MAP_FAILED || cqRing==MAP_FAILED || sqes==MAP_FAILED){
+        close(ring->fd);
+        return 0;
+    }
+
+    ring->numOfEntries = params.sq_entries;
+    ring->sqHead = (u32 *)(sqRing+params.sq_off.head);
+    ring->sqTail = (u32 *)(sqRing+params.sq_off.tail);
+    ring->sqMask = *(u32 *)(sqRing+params.sq_off.ring_mask);
+    ring->sqArray = (u32 *)(sqRing+params.sq_off.array);
+    ring->sqes = sqes;
+    ring->cqHead = (u32 *)(cqRing+params.cq_off.head);
+    ring->cqTail = (u32 *)(cqRing+params.cq_off.tail);
+    ring->cqMask = *(u32 *)(cqRing+params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cqRing+params.cq_off.cqes);
+    return 1;
+}
+
+
+/* Queue an operation of a file, it is submitted by the next ring_run() */
+static struct io_uring_sqe * ring_queue(scan_ring_t * ring, u8 opcode, s32 fd, u32 fileIdx, u8 operation){
+
+    u32 idx = (*ring->sqTail+ring->numOfQueued++) & ring->sqMask;
+    struct io_uring_sqe * sqe = &ring->sqes[idx];
+
+    memset(sqe,0,sizeof(struct io_uring_sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->user_data = (u64)fileIdx*8+operation;
+    ring->sqArray[idx] = idx;
+    return sqe;
+}
+
+
+/* Submit the queued operations with one system call and wait for all of them to complete.
+Returns 0 if the kernel refuses them, the ring is not used anymore then */
+static u8 ring_run(scan_ring_t * ring, scan_file_t * files){
+
+    u32 numOfPending = ring->numOfQueued;
+    u32 numToSubmit = ring->numOfQueued;
+    ring->numOfQueued = 0;
+
+    // The entries are filled before the kernel sees the new tail
+    __atomic_store_n(ring->sqTail,*ring->sqTail+numToSubmit,__ATOMIC_RELEASE);
+
+    while(numOfPending){
+        s32 submitted = syscall(__NR_io_uring_enter,ring->fd,numToSubmit,numOfPending,IORING_ENTER_GETEVENTS,NULL,0);
+        if(submitted<0){
+            if(errno==EINTR)
+                continue;
+            display_error("io_uring cannot run the reads (%s), the files left are read with pread\n",strerror(errno));
+            return 0;
+        }
+        numToSubmit -= submitted;
+
+        u32 head = *ring->cqHead;
+        u32 tail = __atomic_load_n(ring->cqTail,__ATOMIC_ACQUIRE);
+        for(;head!=tail;head++,numOfPending--){
+            struct io_uring_cqe * cqe = &ring->cqes[head & ring->cqMask];
+            scan_file_t * file = &files[cqe->user_data/8];
+            u8 operation = cqe->user_data%8;
+
+            if(operation==SCAN_OP_OPEN)
+                file->fd = cqe->res>=0 ? cqe->res : -1;
+            else if(operation>=SCAN_OP_READ && operation<SCAN_OP_CLOSE)
+                file->reads[operation-SCAN_OP_READ].result = cqe->res;
+        }
+        __atomic_store_n(ring->cqHead,head,__ATOMIC_RELEASE);
+    }
+
+    return 1;
+}
+
+
+/* Close the files a failed batch opened, the closes the kernel was given are not done again */
+static void ring_abandon_batch(scan_file_t * files, u32 numOfFiles){
+
+    for(u32 i=0;i<numOfFiles;i++){
+        if(files[i].fd>=0)
+            close(files[i].fd);
+        files[i].fd = -1;
+    }
+}
+
+
+/* Scan a batch of files through the ring. Every round is one submission for the whole batch:
+the opens, then the reads of every stage, then the closes. Returns 0 if the ring failed, the
+results of the batch are not complete then */
+static u8 scan_batch_ring(scan_ring_t * ring, scan_file_t * files, u32 numOfFiles){
+
+    for(u32 i=0;i<numOfFiles;i++){
+        struct io_uring_sqe * sqe = ring_queue(ring,IORING_OP_OPENAT,AT_FDCWD,i,SCAN_OP_OPEN);
+        sqe->addr = (u64)files[i].path;
+        sqe->open_flags = O_RDONLY|O_CLOEXEC;
+    }
+    if(!ring_run(ring,files)){
+        ring_abandon_batch(files,numOfFiles);
+        return 0;
+    }
+
+    u32 numOfRunning = 0;
+    for(u32 i=0;i<numOfFiles;i++){
+        scan_step(&files[i]);
+        numOfRunning += files[i].stage!=SCAN_STAGE_DONE;
+    }
+
+    while(numOfRunning){
+        for(u32 i=0;i<numOfFiles;i++){
+            if(files[i].stage==SCAN_STAGE_DONE)
+                continue;
+            for(u8 j=0;j<files[i].numOfReads;j++){
+                scan_read_t * read = &files[i].reads[j];
+                read->result = 0;
+                if(!read->size)
+                    continue;
+                struct io_uring_sqe * sqe = ring_queue(ring,IORING_OP_READ,files[i].fd,i,SCAN_OP_READ+j);
+                sqe->addr = (u64)read->buffer;
+                sqe->len = read->size;
+                sqe->off = read->offset;
+            }
+        }
+        if(!ring_run(ring,files)){
+            ring_abandon_batch(files,numOfFiles);
+            return 0;
+        }
+
+        numOfRunning = 0;
+        for(u32 i=0;i<numOfFiles;i++){
+            if(files[i].stage==SCAN_STAGE_DONE)
+                continue;
+            scan_step(&files[i]);
+            numOfRunning += files[i].stage!=SCAN_STAGE_DONE;
+        }
+    }
+
+    for(u32 i=0;i<numOfFiles;i++)
+        if(files[i].fd>=0){
+            ring_queue(ring,IORING_OP_CLOSE,files[i].fd,i,SCAN_OP_CLOSE);
+            files[i].fd = -1;
+        }
+    return ring_run(ring,files);
+}
+
+
+
+/* Scan files and directories for ELF files and list one line per file. "--pread" reads them
+one system call at a time instead of batching the calls through io_uring */
+void scan_paths(u8 ** paths, u32 numOfPaths){
+
+    u8 usePread = numOfPaths && strcmp(paths[0],"--pread")==0;
+    if(usePread){
+        paths++;
+        numOfPaths--;
+    }
+
+    scan_paths_t list;
+    memset(&list,0,sizeof(list));
+    for(u32 i=0;i<numOfPaths;i++){
+        struct stat pathStat;
+        if(stat(paths[i],&pathStat)!=0)
+            display_error("Cannot find \"%s\"\n",paths[i]);
+        else if(S_ISDIR(pathStat.st_mode))
+            walk_directory(&list,paths[i]);
+        else if(S_ISREG(pathStat.st_mode))
+            add_path(&list,paths[i]);
+        else
+            display_error("\"%s\" is neither a file nor a directory\n",paths[i]);
+    }
+
+    scan_ring_t ring;
+    u8 useRing = !usePread && ring_setup(&ring);
+    u8 ringFailed = 0;
+    if(!usePread && !useRing)
+        debug("io_uring is not available, the files are read one system call at a time\n",DEBUG_STATUS_WARNING);
+
+    scan_file_t * files = malloc(SCAN_BATCH_FILES*sizeof(scan_file_t));
+    if(!files){
+        debug("Cannot allocate memory for the files to scan\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    table_layout_t layout;
+    layout_compile(&layout,scanLayout,LAYOUT_COUNT(scanLayout));
+    layout_print_header(&layout);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC,&start);
+
+    u64 numOfElfFiles = 0, numOfUnreadable = 0;
+    for(u64 first=0;first<list.numOfPaths;first+=SCAN_BATCH_FILES){
+        u32 numOfFiles = list.numOfPaths-first<SCAN_BATCH_FILES ? list.numOfPaths-first : SCAN_BATCH_FILES;
+
+        memset(files,0,numOfFiles*sizeof(scan_file_t));
+        for(u32 i=0;i<numOfFiles;i++){
+            files[i].path = list.paths[first+i];
+            files[i].fd = -1;
+        }
+
+        // A batch the ring fails is scanned again with pread, and so are the batches after it
+        if(useRing && !scan_batch_ring(&ring,files,numOfFiles)){
+            close(ring.fd);
+            useRing = 0;
+            ringFailed = 1;
+            memset(files,0,numOfFiles*sizeof(scan_file_t));
+            for(u32 i=0;i<numOfFiles;i++){
+                files[i].path = list.paths[first+i];
+                files[i].fd = -1;
+            }
+        }
+        if(!useRing)
+            for(u32 i=0;i<numOfFiles;i++)
+                scan_file_pread(&files[i]);
+
+        // Listed in the order of the paths whatever order the reads completed in
+        for(u32 i=0;i<numOfFiles;i++){
+            scan_file_t * file = &files[i];
+            numOfUnreadable += file->result==SCAN_RESULT_ERROR;
+            if(file->result!=SCAN_RESULT_ELF)
+                continue;
+
+            numOfElfFiles++;
+            layout_field_t fields[] = {{.string=get_elf_class_string(file->elfClass)}, {.string=get_elf_object_file_type(file->elfFiletype)},
+                                       {.string=file->isDynamic ? "dynamic" : !file->segmentsRead ? "?" : file->elfFiletype==ET_REL ? "-" : "static"},
+                                       {.string=file->hasSymbols ? "symtab" : !file->sectionsRead ? "?" : "stripped"}, {file->numOfSegments}, {file->numOfSections},
+                                       {.string=get_elf_machine(file->elfMachine)}, {.string=file->path}};
+            layout_print_row(&layout,fields);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC,&end);
+    double seconds = (end.tv_sec-start.tv_sec)+(end.tv_nsec-start.tv_nsec)/1e9;
+
+    fprintf(display_output(),"\n%llu ELF files among %llu files, %llu files and %llu directories could not be read\n",numOfElfFiles,list.numOfPaths,numOfUnreadable,list.numOfUnreadableDirectories);
+    fprintf(display_output(),"Read with %s in %.3f s, %.0f files/s\n",useRing ? "io_uring" : ringFailed ? "io_uring then pread" : "pread",seconds,seconds>0 ? list.numOfPaths/seconds : 0.0);
+
+    for(u64 i=0;i<list.numOfPaths;i++)
+        free(list.paths[i]);
+    free(list.paths);
+    free(files);
+}
@@ -0,0 +1,94 @@
+#ifndef SCAN_H
+#define SCAN_H
+
+#include "./types.h"
+#include "./elf.h"
+
+
+
+/* Files opened and read together, every round of a batch is one submission */
+#define SCAN_BATCH_FILES 128
+
+/* Entries of the submission queue, a file queues at most two reads per round */
+#define SCAN_RING_ENTRIES (SCAN_BATCH_FILES*2)
+
+/* Largest header table read of a file, the entries past it are not looked at */
+#define SCAN_MAX_TABLE_SIZE (1<<20)
+
+/* Stages of a file, the reads of a stage are done together */
+#define SCAN_STAGE_OPEN 0			/* Being opened */
+#define SCAN_STAGE_HEADER 1			/* Reading the ELF header */
+#define SCAN_STAGE_FIRST_SECTION 2	/* Reading the first section header, which holds the extended numbers */
+#define SCAN_STAGE_TABLES 3			/* Reading the program and section header tables */
+#define SCAN_STAGE_DONE 4
+
+/* Outcomes of a file */
+#define SCAN_RESULT_ELF 0
+#define SCAN_RESULT_NOT_ELF 1
+#define SCAN_RESULT_ERROR 2			/* Cannot be opened or read */
+
+/* Operations of a file in the ring, the user data of an entry is the file's index times 8 plus its operation */
+#define SCAN_OP_OPEN 0
+#define SCAN_OP_READ 1				/* SCAN_OP_READ+i for the i-th read of a stage */
+#define SCAN_OP_CLOSE 3
+
+
+
+/* Read of a stage, result is the bytes read or a negative errno */
+typedef struct scan_read{
+	u64 offset;
+	u64 size;
+	u8 * buffer;
+	s64 result;
+}scan_read_t;
+
+
+/* File being scanned */
+typedef struct scan_file{
+	u8 * path;
+	s32 fd;				/* -1 once closed or if it cannot be opened */
+	u8 stage;			/* SCAN_STAGE_* */
+	u8 result;			/* SCAN_RESULT_*, once its stage is SCAN_STAGE_DONE */
+	scan_read_t reads[2];	/* Reads of the current stage */
+	u8 numOfReads;
+	u8 header[sizeof(Elf64_Ehdr)];
+	u8 firstSection[sizeof(Elf64_Shdr)];
+	u8 elfClass;
+	u8 elfEncoding;
+	u16 elfFiletype;
+	u16 elfMachine;
+	u64 segmentsOffset;
+	u64 sectionsOffset;
+	u32 numOfSegments;
+	u32 numOfSections;
+	u8 isDynamic;		/* Has an interpreter or a dynamic segment */
+	u8 hasSymbols;		/* Has a SHT_SYMTAB section */
+	u8 segmentsRead;	/* Whether the whole program header table was read, isDynamic is unknown otherwise */
+	u8 sectionsRead;	/* Whether the whole section header table was read, hasSymbols is unknown otherwise */
+}scan_file_t;
+
+
+/* Submission and completion queues of an io_uring instance, mapped from the kernel */
+typedef struct scan_ring{
+	s32 fd;
+	u32 numOfEntries;
+	u32 * sqHead;
+	u32 * sqTail;
+	u32 sqMask;
+	u32 * sqArray;
+	struct io_uring_sqe * sqes;
+	u32 * cqHead;
+	u32 * cqTail;
+	u32 cqMask;
+	struct io_uring_cqe * cqes;
+	u32 numOfQueued;	/* Entries queued since the last submission */
+}scan_ring_t;
+
+
+
+/* Scan files and directories for ELF files and list one line per file. "--pread" reads them
+one system call at a time instead of batching the calls through io_uring */
+void scan_paths(u8 ** paths, u32 numOfPaths);
+
+
+#endif
@@ -0,0 +1,484 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./error.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./cli.h"
+#include "./kvelf.h"
+#include "./parse.h"
+#include "./pool.h"
+#include "./reader.h"
+#include "./symindex.h"
+#include "./plt.h"
+#include "./dwarf.h"
+#include "./ehframe.h"
+#include "./demangle.h"
+#include "./serve.h"
+
+
+
+/* Whether a file can be analyzed without stopping the server, basic_analysis() exits on the others */
+static u8 can_analyze(u8 * path, struct stat * fileStat){
+
+    if(stat(path,fileStat)!=0 || !S_ISREG(fileStat->st_mode))
+        return 0;
+
+    FILE * fp = fopen(path,"rb");
+    if(!fp)
+        return 0;
+
+    u8 ident[EI_NIDENT];
+    u8 valid = fread(ident,1,EI_NIDENT,fp)==EI_NIDENT && ident[0]==0x7f && ident[1]=='E' && ident[2]=='L' && ident[3]=='F';
+    fclose(fp);
+
+    if(valid && ident[EI_CLASS]==ELFCLASS32)
+        return fileStat->st_size>=(off_t)sizeof(Elf32_Ehdr);
+    if(valid && ident[EI_CLASS]==ELFCLASS64)
+        return fileStat->st_size>=(off_t)sizeof(Elf64_Ehdr);
+    return 0;
+}
+
+
+/* Create the entry of a file, its first request analyzes it */
+static served_file_t * new_served_file(u8 * path, struct stat * fileStat){
+
+    served_file_t * file = calloc(1,sizeof(served_file_t));
+    if(!file || !(file->path=strdup(path))){
+        debug("Cannot allocate memory for the served files\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    file->device = fileStat->st_dev;
+    file->inode = fileStat->st_ino;
+    file->size = fileStat->st_size;
+    file->mtime = fileStat->st_mtim;
+    file->state = SERVE_FILE_ANALYZING;
+    pthread_mutex_init(&file->lock,NULL);
+    pthread_cond_init(&file->changed,NULL);
+    pthread_rwlock_init(&file->tablesLock,NULL);
+    file->kvelfp.filePath = file->path;
+    return file;
+}
+
+
+/* Add a file to the list, a full list gives up the file requested least recently for it and
+returns it in evicted. The list's lock is held */
+static served_file_t * add_served_file(server_t * server, u8 * path, struct stat * fileStat, served_file_t ** evicted){
+
+    u32 slot = server->numOfFiles;
+    if(slot==SERVE_MAX_FILES){
+        slot = 0;
+        for(u32 i=1;i<SERVE_MAX_FILES;i++)
+            if(server->files[i]->lastUse<server->files[slot]->lastUse)
+                slot = i;
+        *evicted = server->files[slot];
+    }
+    else
+        server->numOfFiles++;
+
+    server->files[slot] = new_served_file(path,fileStat);
+    return server->files[slot];
+}
+
+
+/* Free a file out of the list, once the requests which got it before are done. It was replaced
+by its new version or evicted, no request can get it anymore */
+static void retire_served_file(served_file_t * file){
+
+    pthread_mutex_lock(&file->lock);
+    while(file->numOfUsers)
+        pthread_cond_wait(&file->changed,&file->lock);
+    pthread_mutex_unlock(&file->lock);
+
+    // The pool is the server's, the listings of the other files go on with it
+    kvelf_basic_params_t * kvelfp = &file->kvelfp;
+    dwarf_line_table_free(kvelfp->lineTable);
+    dwarf_cu_index_free(kvelfp->cuIndex);
+    eh_frame_index_free(kvelfp->ehFrameIndex);
+    symbol_index_free(kvelfp->symbolIndex);
+    got_index_free(kvelfp->gotIndex);
+    listing_tables_free(kvelfp->listingTables);
+    if(kvelfp->demangleCache)
+        demangle_cache_free(kvelfp->demangleCache);
+    free(kvelfp->elfSectionsMetadata);
+    free(kvelfp->elfSegmentsMetadata);
+
+    if(kvelfp->elfImage)
+        munmap(kvelfp->elfImage,kvelfp->elfImageSize);
+    fclose(kvelfp->fp);
+
+    pthread_mutex_destroy(&file->lock);
+    pthread_cond_destroy(&file->changed);
+    pthread_rwlock_destroy(&file->tablesLock);
+    free(file->path);
+    free(file);
+}
+
+
+/* Give back a file got by get_served_file(), once the request's command is done */
+static void release_served_file(served_file_t * file){
+
+    pthread_mutex_lock(&file->lock);
+    if(!--file->numOfUsers)
+        pthread_cond_broadcast(&file->changed);
+    pthread_mutex_unlock(&file->lock);
+}
+
+
+/* Analyze a file and build the indexes every command may use, then wake the requests waiting for it */
+static void analyze_served_file(server_t * server, served_file_t * file){
+
+    basic_analysis(&file->kvelfp);
+
+    // The commands find the indexes built and the pool started, they only read them
+    file->kvelfp.threadPool = server->listingPool;
+    symbol_get_index(&file->kvelfp);
+    got_get_index(&file->kvelfp);
+    get_listing_tables(&file->kvelfp);
+
+    pthread_mutex_lock(&file->lock);
+    file->state = SERVE_FILE_READY;
+    pthread_cond_broadcast(&file->changed);
+    pthread_mutex_unlock(&file->lock);
+}
+
+
+/* Get the analysis of a file, analyzing it and building its indexes on its first request and
+again once it changed on disk. Returns NULL if the file cannot be analyzed, the file got has
+to be given back with release_served_file() */
+static served_file_t * get_served_file(server_t * server, u8 * path){
+
+    struct stat fileStat;
+    if(!can_analyze(path,&fileStat))
+        return NULL;
+
+    // Only the lookup and the insertion hold the list's lock, the requests of the other files go on during an analysis
+    pthread_mutex_lock(&server->lock);
+    served_file_t * file = NULL, * retired = NULL;
+    for(u32 i=0;i<server->numOfFiles && !file;i++){
+        served_file_t * cached = server->files[i];
+        if(cached->device!=fileStat.st_dev || cached->inode!=fileStat.st_ino)
+            continue;
+
+        // A file rewritten in place keeps its inode, its size or modification time tell it changed
+        if(cached->size==fileStat.st_size && cached->mtime.tv_sec==fileStat.st_mtim.tv_sec && cached->mtime.tv_nsec==fileStat.st_mtim.tv_nsec)
+            file = cached;
+        else{
+            retired = cached;
+            file = server->files[i] = new_served_file(path,&fileStat);
+        }
+    }
+    u8 isNew = !file || retired;
+    if(!file)
+        file = add_served_file(server,path,&fileStat,&retired);
+
+    // The request is counted before the list's lock is given back, a file out of the list is not freed under it
+    pthread_mutex_lock(&file->lock);
+    file->numOfUsers++;
+    pthread_mutex_unlock(&file->lock);
+    file->lastUse = ++server->useClock;
+    pthread_mutex_unlock(&server->lock);
+
+    if(isNew)
+        analyze_served_file(server,file);
+    else{
+        pthread_mutex_lock(&file->lock);
+        while(file->state==SERVE_FILE_ANALYZING)
+            pthread_cond_wait(&file->changed,&file->lock);
+        pthread_mutex_unlock(&file->lock);
+    }
+
+    if(retired)
+        retire_served_file(retired);
+    return file;
+}
+
+
+/* Whether the file has a section its tables are decoded from, compressed sections cannot be decoded */
+static u8 has_section(kvelf_basic_params_t * kvelfp, u8 * sectionName){
+
+    s64 sectionIdx = find_section_by_name(kvelfp,sectionName);
+    return sectionIdx>=0 && !(kvelfp->elfSectionsMetadata[sectionIdx].sFlags & SHF_COMPRESSED);
+}
+
+
+/* Demangle the names of all the symbols, the requests listing them find every name memoized and
+only read the cache */
+static demangle_cache_t * demangle_symbol_names(kvelf_basic_params_t * kvelfp){
+
+    demangle_cache_t * demangleCache = demangle_cache_create();
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u8 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+        if((section->sType!=SHT_SYMTAB && section->sType!=SHT_DYNSYM) || section->sLink>=kvelfp->elfNumOfSections)
+            continue;
+
+        u64 symbolsSize, stringsSize;
+        u8 * symbols = get_section_contents(kvelfp,i,&symbolsSize);
+        u8 * strings = get_section_contents(kvelfp,section->sLink,&stringsSize);
+        if(!symbols || !strings)
+            continue;
+
+        // The names are memoized by their file offset, as the listings look them up
+        u64 stringsOffset = kvelfp->elfSectionsMetadata[section->sLink].sOffset;
+        for(u64 j=0;j<symbolsSize/symbolSize;j++){
+            data_reader_t reader;
+            reader_init(&reader,symbols+j*symbolSize,sizeof(u32),needsSwap);
+            u32 nameOffset = reader_u32(&reader);
+            u8 * name = string_at(strings,stringsSize,nameOffset);
+            if(*name)
+                demangle_symbol_name(demangleCache,stringsOffset+nameOffset,name);
+        }
+    }
+
+    return demangleCache;
+}
+
+
+/* Build the tables a command decodes from the file, so that the command only reads them. A table
+is built by the first request needing it. Returns whether the command changes a table anyway and
+has to run alone */
+static u8 prepare_tables(server_t * server, served_file_t * file, u8 * command){
+
+    regex_t * cliRegex = server->cliRegex;
+    kvelf_basic_params_t * kvelfp = &file->kvelfp;
+    u8 changesTables = 0;
+
+    pthread_rwlock_wrlock(&file->tablesLock);
+
+    // The files without the sections are left to the command, which reports it
+    if(regexec(&cliRegex[KVELF_CMD_REGEX_ADDR2LINE_IDX],command,0,NULL,0)==0){
+        if(!kvelfp->lineTable && has_section(kvelfp,".debug_line"))
+            dwarf_get_line_table(kvelfp);
+    }
+    else if(regexec(&cliRegex[KVELF_CMD_REGEX_FUNC_IDX],command,0,NULL,0)==0){
+        if(!kvelfp->cuIndex && has_section(kvelfp,".debug_info") && has_section(kvelfp,".debug_abbrev"))
+            dwarf_get_cu_index(kvelfp);
+
+        // The lookups decode the units into the index's cache
+        changesTables = 1;
+    }
+    else if(regexec(&cliRegex[KVELF_CMD_REGEX_FDE_IDX],command,0,NULL,0)==0){
+        if(!kvelfp->ehFrameIndex && (has_section(kvelfp,".eh_frame") || find_segment_by_type(kvelfp,PT_GNU_EH_FRAME)>=0))
+            eh_frame_get_index(kvelfp);
+        if(kvelfp->ehFrameIndex && !kvelfp->ehFrameIndex->entries)
+            eh_frame_build_entries(kvelfp->ehFrameIndex);
+    }
+    else if(regexec(&cliRegex[KVELF_CMD_REGEX_LIST_SYMBOLS_DEMANGLED_IDX],command,0,NULL,0)==0){
+        if(!kvelfp->demangleCache)
+            kvelfp->demangleCache = demangle_symbol_names(kvelfp);
+    }
+
+    pthread_rwlock_unlock(&file->tablesLock);
+    return changesTables;
+}
+
+
+/* Read the request line of a connection, returns 0 if the client sent none. The bytes after
+the line are left in the connection, they are the input of the command */
+static u8 read_request(s32 connection, u8 * request, u32 requestSize){
+
+    u32 length = 0;
+    while(length<requestSize-1){
+        ssize_t peeked = recv(connection,request+length,requestSize-1-length,MSG_PEEK);
+        if(peeked<0 && errno==EINTR)
+            continue;
+        if(peeked<=0)
+            break;
+
+        // Only the bytes up to the end of the line are taken out
+        u8 * end = memchr(request+length,'\n',peeked);
+        ssize_t received = recv(connection,request+length,end ? end-(request+length)+1 : peeked,0);
+        if(received<=0)
+            break;
+        length += received;
+        if(end)
+            break;
+    }
+
+    request[length] = 0;
+    u8 * end = strchr(request,'\n');
+    if(end)
+        *end = 0;
+    return length>0;
+}
+
+
+/* Open a stream on a duplicate of a descriptor, closing the stream leaves the descriptor open.
+Returns NULL if it cannot be opened */
+static FILE * open_duplicate(s32 fd, const char * mode){
+
+    s32 duplicate = dup(fd);
+    if(duplicate<0)
+        return NULL;
+
+    FILE * stream = fdopen(duplicate,mode);
+    if(!stream)
+        close(duplicate);
+    return stream;
+}
+
+
+/* Answer a request on the calling thread, the command reads its input from the connection and
+writes its output to it. It runs on the file's shared analysis, with its own stream on the file
+so that its reads do not move the offset the other requests read at. The file is given back once
+the command is done */
+static void answer_request(server_t * server, s32 connection, served_file_t * file, u8 * command){
+
+    kvelf_basic_params_t * kvelfp = &file->kvelfp;
+
+    // A mapped file is read from the image analyzed, the other ones through a duplicate of the
+    // descriptor analyzed, whose offset the requests share and which they read one at a time
+    FILE * fp = kvelfp->elfImage ? fmemopen(kvelfp->elfImage,kvelfp->elfImageSize,"rb") : open_duplicate(fileno(kvelfp->fp),"rb");
+    FILE * input = open_duplicate(connection,"rb");
+    FILE * output = open_duplicate(connection,"wb");
+    if(!fp || !input || !output){
+        if(fp)
+            fclose(fp);
+        if(input)
+            fclose(input);
+        if(output)
+            fclose(output);
+        release_served_file(file);
+        dprintf(connection,"[Error] Cannot run the command\n");
+        return;
+    }
+    setvbuf(output,NULL,_IOFBF,SERVE_OUTPUT_BUFFER_SIZE);
+
+    u8 runsAlone = prepare_tables(server,file,command) || !kvelfp->elfImage;
+    if(runsAlone)
+        pthread_rwlock_wrlock(&file->tablesLock);
+    else
+        pthread_rwlock_rdlock(&file->tablesLock);
+
+    // The command gets the tables prepared, only its stream on the file is its own
+    kvelf_basic_params_t requestParams = *kvelfp;
+    requestParams.fp = fp;
+
+    display_set_streams(input,output);
+    u64 fileOffset = 0;
+    run_command(&requestParams,server->cliRegex,command,&fileOffset);
+    display_set_streams(NULL,NULL);
+
+    pthread_rwlock_unlock(&file->tablesLock);
+    release_served_file(file);
+
+    fclose(output);
+    fclose(input);
+    fclose(fp);
+}
+
+
+/* Accept connections and answer their requests until the server stops */
+static void serve_connections(void * context, u64 workerIdx){
+
+    // Every worker runs the same loop, the index of the pool is not needed
+    (void)workerIdx;
+
+    server_t * server = context;
+    u8 request[KVELF_INPUT_CMD_MAX_LENGTH];
+
+    while(1){
+        s32 connection = accept(server->socketFd,NULL,NULL);
+        if(connection<0){
+            if(errno==EINTR || errno==ECONNABORTED)
+                continue;
+            return;
+        }
+
+        if(read_request(connection,request,sizeof(request))){
+
+            // "FILE COMMAND...", the path is the first word
+            u8 * path = request+strspn(request," \t");
+            u8 * command = path+strcspn(path," \t");
+            if(*command)
+                *command++ = 0;
+
+            served_file_t * file = NULL;
+            if(!*path || !*command)
+                dprintf(connection,"[Error] The request has to be \"FILE COMMAND\"\n");
+            else if(!(file=get_served_file(server,path)))
+                dprintf(connection,"[Error] Cannot analyze \"%s\", it is not a readable ELF file\n",path);
+            else
+                answer_request(server,connection,file,command);
+        }
+
+        close(connection);
+    }
+}
+
+
+
+/* Serve the commands of the prompt on a Unix socket, every request is a line "FILE COMMAND..."
+answered with the command's output before the connection is closed. What the client sends
+after the line is the command's input, as for "addr2line -". The given files are analyzed
+before the first request */
+void serve(u8 * socketPath, u8 ** filePaths, u32 numOfFiles){
+
+    server_t server;
+    memset(&server,0,sizeof(server));
+    pthread_mutex_init(&server.lock,NULL);
+
+    server.cliRegex = kvelf_compile_commandline();
+    if(!server.cliRegex){
+        debug("Cannot compile CLI commands",DEBUG_STATUS_ERROR);
+        exit(ERROR_CANNOT_SETUP_CMD);
+    }
+
+    struct sockaddr_un address;
+    memset(&address,0,sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(strlen(socketPath)>=sizeof(address.sun_path)){
+        display_error("The socket's path \"%s\" is too long\n",socketPath);
+        exit(ERROR_CANNOT_SETUP_CMD);
+    }
+    strcpy(address.sun_path,socketPath);
+
+    // A socket left by a previous server is replaced, any other file is not
+    struct stat socketStat;
+    if(stat(socketPath,&socketStat)==0 && S_ISSOCK(socketStat.st_mode))
+        unlink(socketPath);
+
+    server.socketFd = socket(AF_UNIX,SOCK_STREAM,0);
+    if(server.socketFd<0 || bind(server.socketFd,(struct sockaddr *)&address,sizeof(address))!=0 || listen(server.socketFd,SERVE_LISTEN_BACKLOG)!=0){
+        display_error("Cannot listen on \"%s\" (%s)\n",socketPath,strerror(errno));
+        exit(ERROR_CANNOT_SETUP_CMD);
+    }
+
+    // Clients leaving early must not stop the commands writing to them
+    signal(SIGPIPE,SIG_IGN);
+
+    // The listings of all the files are formatted by one pool, their loops take turns
+    server.listingPool = pool_create(0);
+
+    for(u32 i=0;i<numOfFiles;i++){
+        served_file_t * file = get_served_file(&server,filePaths[i]);
+        if(file)
+            release_served_file(file);
+        else
+            display_error("Cannot analyze \"%s\", it is not a readable ELF file\n",filePaths[i]);
+    }
+
+    printf("[Info] Serving on \"%s\", requests are \"FILE COMMAND\" lines\n",socketPath);
+    fflush(stdout);
+    debug_set_quiet(1);
+
+    // Every thread of the pool accepts and answers connections
+    long onlineCpus = sysconf(_SC_NPROCESSORS_ONLN);
+    thread_pool_t * pool = pool_create(onlineCpus>SERVE_MIN_THREADS ? onlineCpus : SERVE_MIN_THREADS);
+    pool_parallel_for(pool,pool->numOfWorkers+1,serve_connections,&server);
+
+    close(server.socketFd);
+}
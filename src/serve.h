@@ -0,0 +1,69 @@
+#ifndef SERVE_H
+#define SERVE_H
+
+#include <regex.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/types.h>
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Connections waiting to be accepted */
+#define SERVE_LISTEN_BACKLOG 64
+
+/* Fewest threads answering connections, a thread runs its client's command and waits on its client */
+#define SERVE_MIN_THREADS 8
+
+/* Most files kept analyzed, a new file takes the place of the one requested least recently */
+#define SERVE_MAX_FILES 64
+
+/* Bytes of the output a command buffers before writing them to its client */
+#define SERVE_OUTPUT_BUFFER_SIZE 65536
+
+/* States of a served file */
+#define SERVE_FILE_ANALYZING 0	/* Being analyzed by its first request, the others wait for it */
+#define SERVE_FILE_READY 1
+
+
+
+/* File opened by a request, analyzed once and kept for the following ones */
+typedef struct served_file{
+	u8 * path;		/* Path the file was first requested by */
+	dev_t device;	/* Device and inode of the file, so that other paths to it share the model */
+	ino_t inode;
+	off_t size;		/* Size and modification time it was analyzed at, a file rewritten in place is analyzed again */
+	struct timespec mtime;
+	u8 state;		/* SERVE_FILE_* */
+	u32 numOfUsers;	/* Requests which got the file and did not give it back, a file out of the list is freed after them */
+	u64 lastUse;	/* Clock of the server at the file's last request, protected by the list's lock */
+	pthread_mutex_t lock;	/* Protects the state and the users */
+	pthread_cond_t changed;	/* Signaled once the file is ready, and once its last user is done */
+	pthread_rwlock_t tablesLock;	/* Held for writing while a request builds a table or runs a command changing one,
+									for reading while it runs the other commands */
+	kvelf_basic_params_t kvelfp;	/* Analysis of the file with its indexes, shared by the requests */
+}served_file_t;
+
+
+/* State shared by the workers, only the files' list changes once they run */
+typedef struct server{
+	s32 socketFd;			/* Listening Unix socket */
+	regex_t * cliRegex;		/* Compiled commands, read-only */
+	pthread_mutex_t lock;	/* Protects the files' list, never held while a file is analyzed */
+	served_file_t * files[SERVE_MAX_FILES];	/* Files analyzed, a file changed on disk is replaced in its slot */
+	u32 numOfFiles;
+	u64 useClock;			/* Counts the requests, orders the files by their last use */
+	struct thread_pool * listingPool;	/* Formats the listings of all the files */
+}server_t;
+
+
+
+/* Serve the commands of the prompt on a Unix socket, every request is a line "FILE COMMAND..."
+answered with the command's output before the connection is closed. What the client sends
+after the line is the command's input, as for "addr2line -". The given files are analyzed
+before the first request */
+void serve(u8 * socketPath, u8 ** filePaths, u32 numOfFiles);
+
+
+#endif
@@ -0,0 +1,359 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./kvelf.h"
+#include "./layout.h"
+#include "./strscan.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KVELF_STRSCAN_SIMD 1
+#endif
+
+
+/* Number of 64-byte chunks classified by one call of a kernel */
+#define STRSCAN_BATCH_CHUNKS 64
+
+
+
+/* File range of a section, to annotate the strings with their owning section */
+typedef struct strscan_owner{
+    u64 start;      /* File offset of the section */
+    u64 end;        /* File offset right after the section */
+    u32 sectionIdx; /* Index of the section */
+}strscan_owner_t;
+
+
+/* State of a scan, runs may cross the chunks */
+typedef struct strscan_state{
+    kvelf_basic_params_t * kvelfp;
+    u64 minLength;      /* Shortest run reported */
+    u64 runStart;       /* File offset of the current run */
+    u8 inRun;           /* Whether the last byte classified was printable */
+    strscan_owner_t * owners;   /* Sections with contents sorted by offset */
+    u64 numOfOwners;
+    u64 ownerCursor;    /* First section which may own the next string, the strings come in order */
+    u64 numOfStrings;   /* Number of strings reported */
+}strscan_state_t;
+
+
+/* Bitmasks of the printable bytes of consecutive 64-byte chunks, bit i is byte i of a chunk */
+typedef void (*printable_masks_fn)(const u8 * data, u64 numOfChunks, u64 * masks);
+
+
+
+/* Printable ASCII and tab, like strings(1) */
+static inline u8 is_printable(u8 c){
+    return (u8)(c-0x20)<=0x5e || c=='\t';
+}
+
+
+static void printable_masks_scalar(const u8 * data, u64 numOfChunks, u64 * masks){
+
+    for(u64 i=0;i<numOfChunks;i++){
+        u64 mask=0;
+        for(u32 b=0;b<64;b++)
+            mask |= (u64)is_printable(data[i*64+b])<<b;
+        masks[i]=mask;
+    }
+}
+
+
+
+#ifdef KVELF_STRSCAN_SIMD
+
+/*
+ * The kernels classify 16 or 32 bytes per compare: a byte is printable if
+ * byte-0x20 stays at most 0x5e unsigned (min_epu8 leaves it unchanged), or if it is a tab.
+ */
+
+__attribute__((target("sse2")))
+static void printable_masks_sse2(const u8 * data, u64 numOfChunks, u64 * masks){
+
+    const __m128i base = _mm_set1_epi8(0x20);
+    const __m128i limit = _mm_set1_epi8(0x5e);
+    const __m128i tab = _mm_set1_epi8('\t');
+
+    for(u64 i=0;i<numOfChunks;i++){
+        u64 mask=0;
+        for(u32 j=0;j<4;j++){
+            __m128i v = _mm_loadu_si128((const __m128i *)(data+i*64+j*16));
+            __m128i shifted = _mm_sub_epi8(v,base);
+            __m128i printable = _mm_cmpeq_epi8(_mm_min_epu8(shifted,limit),shifted);
+            printable = _mm_or_si128(printable,_mm_cmpeq_epi8(v,tab));
+            mask |= (u64)(u16)_mm_movemask_epi8(printable)<<(j*16);
+        }
+        masks[i]=mask;
+    }
+}
+
+__attribute__((target("avx2")))
+static void printable_masks_avx2(const u8 * data, u64 numOfChunks, u64 * masks){
+
+    const __m256i base = _mm256_set1_epi8(0x20);
+    const __m256i limit = _mm256_set1_epi8(0x5e);
+    const __m256i tab = _mm256_set1_epi8('\t');
+
+    for(u64 i=0;i<numOfChunks;i++){
+        __m256i lo = _mm256_loadu_si256((const __m256i *)(data+i*64));
+        __m256i hi = _mm256_loadu_si256((const __m256i *)(data+i*64+32));
+        __m256i shiftedLo = _mm256_sub_epi8(lo,base);
+        __m256i shiftedHi = _mm256_sub_epi8(hi,base);
+        __m256i printableLo = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(shiftedLo,limit),shiftedLo),_mm256_cmpeq_epi8(lo,tab));
+        __m256i printableHi = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(shiftedHi,limit),shiftedHi),_mm256_cmpeq_epi8(hi,tab));
+        masks[i] = (u64)(u32)_mm256_movemask_epi8(printableLo) | (u64)(u32)_mm256_movemask_epi8(printableHi)<<32;
+    }
+}
+
+#endif
+
+
+
+/* Pick the widest kernel the CPU runs */
+static printable_masks_fn select_printable_masks(void){
+
+#ifdef KVELF_STRSCAN_SIMD
+    if(__builtin_cpu_supports("avx2"))
+        return printable_masks_avx2;
+    if(__builtin_cpu_supports("sse2"))
+        return printable_masks_sse2;
+#endif
+
+    return printable_masks_scalar;
+}
+
+
+
+static int compare_owners(const void * a, const void * b){
+
+    const strscan_owner_t * ownerA = a;
+    const strscan_owner_t * ownerB = b;
+
+    if(ownerA->start!=ownerB->start)
+        return ownerA->start<ownerB->start ? -1 : 1;
+    return 0;
+}
+
+
+/* Collect the file ranges of the sections which have contents */
+static void build_owners(strscan_state_t * state){
+
+    kvelf_basic_params_t * kvelfp = state->kvelfp;
+
+    state->owners = malloc(sizeof(strscan_owner_t)*(kvelfp->elfNumOfSections+1));
+    if(!state->owners){
+        debug("Cannot allocate the sections of the scan\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    state->numOfOwners=0;
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        u64 contentsSize;
+        u8 * contents = get_section_contents(kvelfp,i,&contentsSize);
+        if(!contents || !contentsSize)
+            continue;
+
+        strscan_owner_t * owner = &state->owners[state->numOfOwners++];
+        owner->start = contents-kvelfp->elfImage;
+        owner->end = owner->start+contentsSize;
+        owner->sectionIdx = i;
+    }
+
+    qsort(state->owners,state->numOfOwners,sizeof(strscan_owner_t),compare_owners);
+    state->ownerCursor=0;
+}
+
+
+/* Name of the section owning a file offset, "-" for the bytes outside the sections */
+static u8 * owner_name(strscan_state_t * state, u64 offset){
+
+    while(state->ownerCursor<state->numOfOwners && state->owners[state->ownerCursor].end<=offset)
+        state->ownerCursor++;
+
+    if(state->ownerCursor<state->numOfOwners && state->owners[state->ownerCursor].start<=offset)
+        return get_section_name(state->kvelfp,state->owners[state->ownerCursor].sectionIdx);
+
+    return "-";
+}
+
+
+/* Report a run if it is long enough */
+static void emit_run(strscan_state_t * state, u64 start, u64 end){
+
+    if(end-start<state->minLength)
+        return;
+
+    fprintf(display_output(),"0x%016llx  %-20s %.*s\n",start,owner_name(state,start),(s32)(end-start),state->kvelfp->elfImage+start);
+    state->numOfStrings++;
+}
+
+
+/* Clear the runs lying inside a chunk which are shorter than the given length (at most 64):
+the mask is eroded to the bits starting length printable bytes, then dilated back.
+The runs crossing the chunk's borders are kept as they are */
+static inline u64 drop_short_runs(u64 mask, u8 inRun, u32 length){
+
+    u64 eroded = mask;
+    u32 width = 1;
+    for(;width*2<=length;width*=2)
+        eroded &= eroded>>width;
+    eroded &= eroded>>(length-width);
+
+    u64 dilated = eroded;
+    for(width=1;width*2<=length;width*=2)
+        dilated |= dilated<<width;
+    dilated |= dilated<<(length-width);
+
+    // The run continuing from the previous chunk and the one going on in the next
+    u64 bottom = inRun ? (~mask & (mask+1))-1 : 0;
+    u64 top = (mask>>63 && ~mask) ? ~0ULL<<(64-__builtin_clzll(~mask)) : 0;
+
+    return mask & (dilated | bottom | top);
+}
+
+
+/* Follow the runs through the mask of the chunk at the given file offset, the bits
+where the previous byte's class differs are the starts and the ends of the runs */
+static inline void scan_mask(strscan_state_t * state, u64 mask, u64 chunkOffset){
+
+    if(state->minLength>1)
+        mask = drop_short_runs(mask,state->inRun,state->minLength<64 ? state->minLength : 64);
+
+    u64 previous = mask<<1 | state->inRun;
+    u64 starts = mask & ~previous;
+    u64 ends = ~mask & previous;
+    u64 events = starts | ends;
+
+    while(events){
+        u32 bit = __builtin_ctzll(events);
+        if(starts>>bit & 1)
+            state->runStart = chunkOffset+bit;
+        else
+            emit_run(state,state->runStart,chunkOffset+bit);
+        events &= events-1;
+    }
+
+    state->inRun = mask>>63;
+}
+
+
+/* Scan the file range [start,end) of the mapped image */
+static void scan_range(strscan_state_t * state, u64 start, u64 end){
+
+    u8 * image = state->kvelfp->elfImage;
+    printable_masks_fn printable_masks = select_printable_masks();
+    u64 masks[STRSCAN_BATCH_CHUNKS];
+    u64 offset = start;
+
+    state->inRun=0;
+
+    while(end-offset>=64){
+        u64 numOfChunks = (end-offset)/64;
+        if(numOfChunks>STRSCAN_BATCH_CHUNKS)
+            numOfChunks=STRSCAN_BATCH_CHUNKS;
+
+        printable_masks(image+offset,numOfChunks,masks);
+        for(u64 i=0;i<numOfChunks;i++){
+            // Neither starts nor ends in the chunk
+            if(masks[i]==(state->inRun ? ~0ULL : 0))
+                continue;
+            scan_mask(state,masks[i],offset+i*64);
+        }
+        offset += numOfChunks*64;
+    }
+
+    // The bytes after the end are left unprintable, which ends the last run
+    u64 mask=0;
+    for(u64 i=0;offset+i<end;i++)
+        mask |= (u64)is_printable(image[offset+i])<<i;
+    scan_mask(state,mask,offset);
+}
+
+
+
+/* Columns of the listing, the rows are printed as the runs are found */
+static const layout_column_t stringsLayout[] = {
+    {"Offset",LAYOUT_HEX,20,16}, {"Section",LAYOUT_STRING,21}, {"String",LAYOUT_STRING},
+};
+
+
+/* Print the printable runs of a section, a file range (START-END) or the whole file,
+with their file offsets and owning sections */
+void strings_scan(kvelf_basic_params_t * kvelfp, u8 * query){
+
+    if(!kvelfp->elfImage){
+        debug("strings needs the file mapped in memory\n",DEBUG_STATUS_ERROR);
+        return;
+    }
+
+    strscan_state_t state;
+    memset(&state,0,sizeof(state));
+    state.kvelfp = kvelfp;
+    state.minLength = STRSCAN_DEFAULT_MIN_LENGTH;
+
+    u64 start = 0;
+    u64 end = kvelfp->elfImageSize;
+    u8 hasTarget = 0;
+
+    u8 * savePtr;
+    for(u8 * token=strtok_r(query," \t\n",(char **)&savePtr);token;token=strtok_r(NULL," \t\n",(char **)&savePtr)){
+
+        if(strcmp(token,"--min")==0){
+            u8 * lengthStr = strtok_r(NULL," \t\n",(char **)&savePtr);
+            u8 * lengthEnd;
+            if(!lengthStr || !(state.minLength=strtoull(lengthStr,(char **)&lengthEnd,0)) || *lengthEnd){
+                debug("Usage: strings [SECTION|START-END] [--min N], N > 0\n",DEBUG_STATUS_ERROR);
+                return;
+            }
+            continue;
+        }
+
+        if(hasTarget){
+            debug("Usage: strings [SECTION|START-END] [--min N]\n",DEBUG_STATUS_ERROR);
+            return;
+        }
+        hasTarget=1;
+
+        s64 sectionIdx = find_section_by_name(kvelfp,token);
+        if(sectionIdx>=0){
+            u64 contentsSize;
+            u8 * contents = get_section_contents(kvelfp,sectionIdx,&contentsSize);
+            if(!contents){
+                display_error("Section \"%s\" has no contents in the file\n",token);
+                return;
+            }
+            start = contents-kvelfp->elfImage;
+            end = start+contentsSize;
+            continue;
+        }
+
+        // A range of file offsets
+        u8 * startEnd;
+        u8 * endEnd;
+        start = strtoull(token,(char **)&startEnd,0);
+        if(startEnd==token || *startEnd!='-' || (end=strtoull(startEnd+1,(char **)&endEnd,0),endEnd==startEnd+1) || *endEnd || start>=end){
+            display_error("\"%s\" is neither a section nor a range START-END\n",token);
+            return;
+        }
+        if(start>=kvelfp->elfImageSize){
+            display_error("Range starts after the end of the file (0x%llx)\n",kvelfp->elfImageSize);
+            return;
+        }
+        if(end>kvelfp->elfImageSize)
+            end=kvelfp->elfImageSize;
+    }
+
+    build_owners(&state);
+
+    table_layout_t layout;
+    layout_compile(&layout,stringsLayout,LAYOUT_COUNT(stringsLayout));
+    layout_print_header(&layout);
+
+    scan_range(&state,start,end);
+
+    fprintf(display_output(),"\n%llu strings\n",state.numOfStrings);
+    free(state.owners);
+}
@@ -0,0 +1,19 @@
+#ifndef STRSCAN_H
+#define STRSCAN_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Shortest run of printable characters reported when --min is not given */
+#define STRSCAN_DEFAULT_MIN_LENGTH 4
+
+
+
+/* Print the printable runs of a section, a file range (START-END) or the whole file,
+with their file offsets and owning sections */
+void strings_scan(kvelf_basic_params_t * kvelfp, u8 * query);
+
+
+#endif
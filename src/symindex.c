@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./byteorder.h"
+#include "./reader.h"
+#include "./kvelf.h"
+#include "./preparse.h"
+#include "./symindex.h"
+
+
+
+/* Symbol read from a table with how much it is preferred over the others at its address */
+typedef struct ranked_symbol{
+    symbol_index_entry_t entry;
+    u32 rank;       /* Lower ranks are preferred */
+}ranked_symbol_t;
+
+
+static s32 compare_ranked_symbols(const void * a, const void * b){
+
+    const ranked_symbol_t * symbolA = a;
+    const ranked_symbol_t * symbolB = b;
+
+    if(symbolA->entry.address!=symbolB->entry.address)
+        return symbolA->entry.address<symbolB->entry.address ? -1 : 1;
+    return (symbolA->rank>symbolB->rank) - (symbolA->rank<symbolB->rank);
+}
+
+
+/* Functions before objects before untyped symbols, then global before weak before local,
+then .symtab before .dynsym which mostly repeats it */
+static u32 symbol_rank(u8 type, u8 binding, u32 sectionType){
+
+    u32 rank = (type==STT_FUNC || type==STT_GNU_IFUNC) ? 0 : (type==STT_OBJECT ? 1 : 2);
+    rank = rank*3 + (binding==STB_GLOBAL ? 0 : (binding==STB_WEAK ? 1 : 2));
+    return rank*2 + (sectionType==SHT_DYNSYM);
+}
+
+
+/* Read the defined symbols of a symbol table */
+static void read_symbol_table(kvelf_basic_params_t * kvelfp, u32 tableIdx, ranked_symbol_t ** symbols, u64 * numOfSymbols, u64 * capacity){
+
+    u8 needsSwap = ELF_NEEDS_SWAP(kvelfp->elfEncoding);
+    u64 symbolSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Sym) : sizeof(Elf64_Sym);
+    u32 tableType = kvelfp->elfSectionsMetadata[tableIdx].sType;
+
+    u64 tableSize, stringsSize;
+    u8 * table = get_section_contents(kvelfp,tableIdx,&tableSize);
+    u8 * strings = get_section_contents(kvelfp,kvelfp->elfSectionsMetadata[tableIdx].sLink,&stringsSize);
+    if(!table || !strings)
+        return;
+
+    data_reader_t reader;
+    reader_init(&reader,table,tableSize,needsSwap);
+
+    for(u64 symbolIdx=0;symbolIdx<tableSize/symbolSize;symbolIdx++){
+        u32 nameOffset;
+        u8 info;
+        u16 sectionIdx;
+        u64 value, size;
+
+        if(kvelfp->elfClass==ELFCLASS32){
+            nameOffset = reader_u32(&reader);
+            value = reader_u32(&reader);
+            size = reader_u32(&reader);
+            info = reader_u8(&reader);
+            reader_skip(&reader,1);
+            sectionIdx = reader_u16(&reader);
+        }else{
+            nameOffset = reader_u32(&reader);
+            info = reader_u8(&reader);
+            reader_skip(&reader,1);
+            sectionIdx = reader_u16(&reader);
+            value = reader_u64(&reader);
+            size = reader_u64(&reader);
+        }
+
+        // Undefined symbols have no address, sections and files have no useful name, TLS values are offsets
+        u8 type = ELF64_ST_TYPE(info);
+        if(reader.error || sectionIdx==SHN_UNDEF || type==STT_SECTION || type==STT_FILE || type==STT_TLS ||
+           nameOffset>=stringsSize || !strings[nameOffset] || !memchr(strings+nameOffset,0,stringsSize-nameOffset))
+            continue;
+
+        if(*numOfSymbols==*capacity){
+            *capacity*=2;
+            *symbols = realloc(*symbols,*capacity*sizeof(ranked_symbol_t));
+            if(!*symbols){
+                debug("Cannot allocate the symbol index\n",DEBUG_STATUS_ERROR);
+                exit(1);
+            }
+        }
+
+        ranked_symbol_t * symbol = &(*symbols)[(*numOfSymbols)++];
+        symbol->entry.address = value;
+        symbol->entry.size = size;
+        symbol->entry.name = strings+nameOffset;
+        symbol->entry.type = type;
+        symbol->rank = symbol_rank(type,ELF64_ST_BIND(info),tableType);
+    }
+}
+
+
+
+/* Get the address index of the file's symbols, building it on the first call */
+symbol_index_t * symbol_get_index(kvelf_basic_params_t * kvelfp){
+
+    preparse_wait(kvelfp,PREPARSE_SYMBOL_INDEX);
+    if(kvelfp->symbolIndex)
+        return kvelfp->symbolIndex;
+
+    u64 numOfSymbols=0, capacity=256;
+    ranked_symbol_t * symbols = malloc(capacity*sizeof(ranked_symbol_t));
+    symbol_index_t * symIndex = calloc(1,sizeof(symbol_index_t));
+    if(!symbols || !symIndex){
+        debug("Cannot allocate the symbol index\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++)
+        if(kvelfp->elfSectionsMetadata[i].sType==SHT_SYMTAB || kvelfp->elfSectionsMetadata[i].sType==SHT_DYNSYM)
+            read_symbol_table(kvelfp,i,&symbols,&numOfSymbols,&capacity);
+
+    qsort(symbols,numOfSymbols,sizeof(ranked_symbol_t),compare_ranked_symbols);
+
+    // The preferred symbol of every address is the first one of its run
+    symIndex->entries = malloc((numOfSymbols ? numOfSymbols : 1)*sizeof(symbol_index_entry_t));
+    if(!symIndex->entries){
+        debug("Cannot allocate the symbol index\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+    for(u64 i=0;i<numOfSymbols;i++)
+        if(!i || symbols[i].entry.address!=symbols[i-1].entry.address)
+            symIndex->entries[symIndex->numOfEntries++] = symbols[i].entry;
+
+    free(symbols);
+    kvelfp->symbolIndex = symIndex;
+
+    return symIndex;
+}
+
+
+/* Free a symbol index, the names are the mapped file's */
+void symbol_index_free(symbol_index_t * symIndex){
+
+    if(!symIndex)
+        return;
+
+    free(symIndex->entries);
+    free(symIndex);
+}
+
+
+/* Find the symbol at or below an address, returns -1 if there is none */
+s64 symbol_index_lookup(symbol_index_t * symIndex, u64 address){
+
+    if(!symIndex->numOfEntries || address<symIndex->entries[0].address)
+        return -1;
+
+    u64 base=0, count=symIndex->numOfEntries;
+    while(count>1){
+        u64 half=count/2;
+        base = (symIndex->entries[base+half].address<=address) ? base+half : base;
+        count-=half;
+    }
+
+    return base;
+}
+
+
+/* Find a symbol by its name, returns -1 if there is none */
+s64 symbol_index_find_name(symbol_index_t * symIndex, u8 * name){
+
+    for(u64 i=0;i<symIndex->numOfEntries;i++)
+        if(!strcmp((char *)symIndex->entries[i].name,(char *)name))
+            return i;
+
+    return -1;
+}
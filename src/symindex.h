@@ -0,0 +1,39 @@
+#ifndef SYMINDEX_H
+#define SYMINDEX_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* A defined symbol with an address */
+typedef struct symbol_index_entry{
+	u64 address;		/* Value of the symbol */
+	u64 size;			/* Size of the symbol, 0 if it is unknown */
+	u8 * name;			/* Name in the mapped string table */
+	u8 type;			/* STT_* type of the symbol */
+}symbol_index_entry_t;
+
+
+/* Symbols of .symtab and .dynsym sorted by address */
+typedef struct symbol_index{
+	symbol_index_entry_t * entries;	/* One symbol per address, the functions of .symtab first */
+	u64 numOfEntries;
+}symbol_index_t;
+
+
+
+/* Get the address index of the file's symbols, building it on the first call */
+symbol_index_t * symbol_get_index(kvelf_basic_params_t * kvelfp);
+
+/* Free a symbol index, the names are the mapped file's */
+void symbol_index_free(symbol_index_t * symIndex);
+
+/* Find the symbol at or below an address, returns -1 if there is none */
+s64 symbol_index_lookup(symbol_index_t * symIndex, u64 address);
+
+/* Find a symbol by its name, returns -1 if there is none */
+s64 symbol_index_find_name(symbol_index_t * symIndex, u8 * name);
+
+
+#endif
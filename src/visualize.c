@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "./types.h"
+#include "./debug.h"
+#include "./elf.h"
+#include "./kvelf.h"
+#include "./visualize.h"
+
+
+
+/* Segment drawn as a lane next to the map */
+typedef struct map_lane{
+    u64 start;
+    u64 end;
+    u8 letter;
+}map_lane_t;
+
+
+
+/* Extents by offset, an extent enclosing the ones starting with it first */
+static s32 compare_extents(const void * a, const void * b){
+
+    const map_extent_t * extentA = a;
+    const map_extent_t * extentB = b;
+
+    if(extentA->start!=extentB->start)
+        return extentA->start<extentB->start ? -1 : 1;
+    return (extentA->end<extentB->end) - (extentA->end>extentB->end);
+}
+
+
+/* Size in the largest unit keeping it at least 1 */
+static void format_size(u64 size, u8 * buffer, u32 bufferSize){
+
+    static const u8 * units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value = size;
+    u32 unit = 0;
+
+    while(value>=1024 && unit<4){
+        value /= 1024;
+        unit++;
+    }
+
+    if(!unit)
+        snprintf(buffer,bufferSize,"%llu B",size);
+    else
+        snprintf(buffer,bufferSize,"%.1f %s",value,units[unit]);
+}
+
+
+/* Add the part of a region inside the file, returns 0 if none of it is */
+static u8 add_extent(map_extent_t * extents, u64 * numOfExtents, u64 fileSize, u64 start, u64 size, u8 * name, u32 sectionIdx, u8 kind){
+
+    if(!size || start>=fileSize)
+        return 0;
+
+    map_extent_t * extent = &extents[(*numOfExtents)++];
+    extent->start = start;
+    extent->end = size>fileSize-start ? fileSize : start+size;
+    extent->name = name;
+    extent->sectionIdx = sectionIdx;
+    extent->kind = kind;
+    return 1;
+}
+
+
+/* Name of an extent, a section without a name is named by its index */
+static u8 * extent_name(map_extent_t * extent, u8 * buffer, u32 bufferSize){
+
+    if(extent->kind==VISUALIZE_EXTENT_SECTION && !*extent->name){
+        snprintf(buffer,bufferSize,"[%u]",extent->sectionIdx);
+        return buffer;
+    }
+    return extent->name;
+}
+
+
+static u8 extent_color(u8 kind){
+
+    if(kind==VISUALIZE_EXTENT_HEADER)
+        return DISPLAY_COLOR_RED;
+    if(kind==VISUALIZE_EXTENT_TABLE)
+        return DISPLAY_COLOR_ORANGE;
+    if(kind==VISUALIZE_EXTENT_SECTION)
+        return DISPLAY_COLOR_GREEN_YELLOW;
+    return DISPLAY_COLOR_BLACK;
+}
+
+
+
+/* Draw a map of the file scaled to its size, with the header, the header tables, the sections
+and the holes between them, and the segments as lanes covering them */
+void visualize_elf_file(kvelf_basic_params_t * kvelfp){
+
+    u64 fileSize = kvelfp->elfImageSize;
+    if(!fileSize){
+        fseek(kvelfp->fp,0,SEEK_END);
+        fileSize = ftell(kvelfp->fp);
+    }
+    if(!fileSize){
+        debug("The file is empty\n",DEBUG_STATUS_INF);
+        return;
+    }
+
+    // Every region can be followed by a hole, and the file can end with one
+    u64 capacity = kvelfp->elfNumOfSections+3;
+    map_extent_t * regions = malloc(capacity*sizeof(map_extent_t));
+    map_extent_t * extents = malloc((capacity*2+1)*sizeof(map_extent_t));
+    if(!regions || !extents){
+        debug("Cannot allocate memory for the file map\n",DEBUG_STATUS_ERROR);
+        exit(1);
+    }
+
+    u64 numOfRegions = 0, numOfSections = 0;
+    u64 shdrSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Shdr) : sizeof(Elf64_Shdr);
+    u64 phdrSize = kvelfp->elfClass==ELFCLASS32 ? sizeof(Elf32_Phdr) : sizeof(Elf64_Phdr);
+
+    add_extent(regions,&numOfRegions,fileSize,kvelfp->elfOffsets.elfHeaderOffset,kvelfp->elfHeaderSize,"ELF header",0,VISUALIZE_EXTENT_HEADER);
+    if(kvelfp->elfOffsets.elfSegmentHeaderOffset)
+        add_extent(regions,&numOfRegions,fileSize,kvelfp->elfOffsets.elfSegmentHeaderOffset,kvelfp->elfNumOfSegments*phdrSize,"Program headers",0,VISUALIZE_EXTENT_TABLE);
+    if(kvelfp->elfOffsets.elfSectionHeaderOffset)
+        add_extent(regions,&numOfRegions,fileSize,kvelfp->elfOffsets.elfSectionHeaderOffset,kvelfp->elfNumOfSections*shdrSize,"Section headers",0,VISUALIZE_EXTENT_TABLE);
+
+    for(u32 i=0;i<kvelfp->elfNumOfSections;i++){
+        section_metadata_t * section = &kvelfp->elfSectionsMetadata[i];
+        // The size of the first section holds the extended number of sections
+        if(section->sType!=SHT_NOBITS && section->sType!=SHT_NULL)
+            numOfSections += add_extent(regions,&numOfRegions,fileSize,section->sOffset,section->sSize,get_section_name(kvelfp,i),i,VISUALIZE_EXTENT_SECTION);
+    }
+
+    // Sorted once, the holes are the gaps between the regions
+    qsort(regions,numOfRegions,sizeof(map_extent_t),compare_extents);
+
+    u64 numOfExtents = 0, numOfHoles = 0, holesSize = 0, numOfOverlaps = 0, cursor = 0;
+    for(u64 i=0;i<numOfRegions;i++){
+        if(regions[i].start>cursor){
+            add_extent(extents,&numOfExtents,fileSize,cursor,regions[i].start-cursor,"(hole)",0,VISUALIZE_EXTENT_HOLE);
+            numOfHoles++;
+            holesSize += regions[i].start-cursor;
+        }else if(regions[i].start<cursor)
+            numOfOverlaps++;
+
+        extents[numOfExtents++] = regions[i];
+        if(regions[i].end>cursor)
+            cursor = regions[i].end;
+    }
+    if(cursor<fileSize){
+        add_extent(extents,&numOfExtents,fileSize,cursor,fileSize-cursor,"(hole)",0,VISUALIZE_EXTENT_HOLE);
+        numOfHoles++;
+        holesSize += fileSize-cursor;
+    }
+    free(regions);
+
+    // Segments which have bytes in the file, one lane each
+    map_lane_t lanes[VISUALIZE_MAX_LANES];
+    u32 numOfLanes = 0, numOfSkippedSegments = 0;
+    for(u32 i=0;i<kvelfp->elfNumOfSegments;i++){
+        segment_metadata_t * segment = &kvelfp->elfSegmentsMetadata[i];
+        if(!segment->pFileSize || segment->pOffset>=fileSize)
+            continue;
+        if(numOfLanes==VISUALIZE_MAX_LANES){
+            numOfSkippedSegments++;
+            continue;
+        }
+        lanes[numOfLanes].start = segment->pOffset;
+        lanes[numOfLanes].end = segment->pFileSize>fileSize-segment->pOffset ? fileSize : segment->pOffset+segment->pFileSize;
+        lanes[numOfLanes].letter = 'A'+numOfLanes;
+        numOfLanes++;
+    }
+
+    // Rows cover a power of two number of bytes, the regions smaller than a row share it
+    u64 bytesPerRow = 1;
+    while(bytesPerRow*VISUALIZE_MAP_ROWS<fileSize)
+        bytesPerRow <<= 1;
+    u64 numOfRows = (fileSize+bytesPerRow-1)/bytesPerRow;
+
+    u8 fileSizeString[32], rowSizeString[32], holesSizeString[32];
+    format_size(fileSize,fileSizeString,sizeof(fileSizeString));
+    format_size(bytesPerRow,rowSizeString,sizeof(rowSizeString));
+    format_size(holesSize,holesSizeString,sizeof(holesSizeString));
+
+    fprintf(display_output(),"\nFile of %s, a row is %s\n",fileSizeString,rowSizeString);
+    u8 headerBuffer[128];
+    snprintf(headerBuffer,sizeof(headerBuffer),"%-20s%-*s  %s\n","Offset",VISUALIZE_LABEL_WIDTH,"Region","Segments");
+    display(headerBuffer,DISPLAY_COLOR_ORANGE);
+
+    u64 next = 0;
+    s64 covering = -1;
+    for(u64 row=0;row<numOfRows;row++){
+        u64 rowStart = row*bytesPerRow;
+        u64 rowEnd = rowStart+bytesPerRow<fileSize ? rowStart+bytesPerRow : fileSize;
+
+        // The largest of the extents starting in the row names it, an extent going on from
+        // the rows above names a row where none starts
+        s64 largest = -1;
+        u64 numOfStarting = 0;
+        for(;next<numOfExtents && extents[next].start<rowEnd;next++,numOfStarting++){
+            if(largest<0 || extents[next].end-extents[next].start>extents[largest].end-extents[largest].start)
+                largest = next;
+            if(covering<0 || extents[next].end>extents[covering].end)
+                covering = next;
+        }
+
+        // The label buffer holds the longest label, which is cut to the column's width when printed
+        u8 nameBuffer[16], sizeString[32];
+        u8 label[sizeof(nameBuffer)+sizeof(sizeString)+24];
+        u8 kind = VISUALIZE_EXTENT_HOLE;
+        if(largest>=0){
+            map_extent_t * extent = &extents[largest];
+            kind = extent->kind;
+            format_size(extent->end-extent->start,sizeString,sizeof(sizeString));
+            if(numOfStarting>1)
+                snprintf(label,sizeof(label),"%s %s +%llu",extent_name(extent,nameBuffer,sizeof(nameBuffer)),sizeString,numOfStarting-1);
+            else
+                snprintf(label,sizeof(label),"%s %s",extent_name(extent,nameBuffer,sizeof(nameBuffer)),sizeString);
+        }else if(covering>=0 && extents[covering].end>rowStart){
+            kind = extents[covering].kind;
+            snprintf(label,sizeof(label),"  | %s",extent_name(&extents[covering],nameBuffer,sizeof(nameBuffer)));
+        }else
+            label[0] = 0;
+
+        // A lane shows its letter on the row it starts in
+        u8 laneGlyphs[VISUALIZE_MAX_LANES+1];
+        for(u32 i=0;i<numOfLanes;i++){
+            if(lanes[i].start>=rowStart && lanes[i].start<rowEnd)
+                laneGlyphs[i] = lanes[i].letter;
+            else
+                laneGlyphs[i] = (lanes[i].start<rowEnd && lanes[i].end>rowStart) ? '|' : ' ';
+        }
+        laneGlyphs[numOfLanes] = 0;
+
+        fprintf(display_output(),"0x%016llx  %s%-*.*s%s  %s\n",rowStart,display_color_sequence(extent_color(kind)),VISUALIZE_LABEL_WIDTH,VISUALIZE_LABEL_WIDTH,label,display_reset_sequence(),laneGlyphs);
+    }
+
+    if(numOfLanes){
+        fprintf(display_output(),"\n");
+        display("Segments:\n",DISPLAY_COLOR_ORANGE);
+        for(u32 i=0,lane=0;i<kvelfp->elfNumOfSegments && lane<numOfLanes;i++){
+            segment_metadata_t * segment = &kvelfp->elfSegmentsMetadata[i];
+            if(!segment->pFileSize || segment->pOffset>=fileSize)
+                continue;
+
+            u8 flags[4];
+            get_elf_segment_flag(segment->pFlags,flags,sizeof(flags));
+            fprintf(display_output(),"  %c  %-16s%-4s0x%016llx-0x%016llx\n",lanes[lane].letter,get_elf_segment_type(segment->pType),flags,lanes[lane].start,lanes[lane].end);
+            lane++;
+        }
+        if(numOfSkippedSegments)
+            fprintf(display_output(),"  %u more segments are not drawn\n",numOfSkippedSegments);
+    }
+
+    fprintf(display_output(),"\n%llu sections in the file, %llu holes of %s in total, %llu extents overlapping the ones before them\n\n",numOfSections,numOfHoles,holesSizeString,numOfOverlaps);
+
+    free(extents);
+}
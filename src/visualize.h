@@ -0,0 +1,42 @@
+#ifndef VISUALIZE_H
+#define VISUALIZE_H
+
+#include "./types.h"
+#include "./kvelf.h"
+
+
+
+/* Most rows of the map, every row covers the same power of two number of bytes */
+#define VISUALIZE_MAP_ROWS 48
+
+/* Width of the labels of the rows */
+#define VISUALIZE_LABEL_WIDTH 44
+
+/* Most segments drawn as lanes next to the map, one letter each */
+#define VISUALIZE_MAX_LANES 26
+
+/* Kinds of the extents of the file */
+#define VISUALIZE_EXTENT_HEADER 0	/* ELF header */
+#define VISUALIZE_EXTENT_TABLE 1	/* Program or section header table */
+#define VISUALIZE_EXTENT_SECTION 2
+#define VISUALIZE_EXTENT_HOLE 3		/* Bytes no header, table or section covers */
+
+
+
+/* Region of the file */
+typedef struct map_extent{
+	u64 start;		/* File offset of its first byte */
+	u64 end;		/* File offset after its last byte */
+	u8 * name;
+	u32 sectionIdx;	/* Index of a section, named by it when it has no name */
+	u8 kind;		/* VISUALIZE_EXTENT_* */
+}map_extent_t;
+
+
+
+/* Draw a map of the file scaled to its size, with the header, the header tables, the sections
+and the holes between them, and the segments as lanes covering them */
+void visualize_elf_file(kvelf_basic_params_t * kvelfp);
+
+
+#endif